@@ -1,5 +1,444 @@
 #include "crcLib.h"
 
+/**
+ * 计算方式:
+ * 输入反转的模型在反转域中计算, 寄存器右对齐, 每字节右移8位;
+ * 其余模型计算时将寄存器左对齐到32位, 每字节左移8位.
+ * 两种方式都适用于任意位宽(1~32), 且与查表策略无关.
+ * 对外的寄存器值统一为右对齐的width位(反转模型为反转域的值).
+ */
+
+static const crc_backend_t* crc_backend = NULL;
+
+#if MOD_CFG_USE_OS_NONE
+#define CRC_LOCK() (1)
+#define CRC_UNLOCK() ((void)0)
+#else
+#if !MOD_CFG_ENABLE_ATOMIC  // 锁的创建和查找表的发布依赖原子操作
+#error "libcrc under an RTOS requires MOD_CFG_ENABLE_ATOMIC"
+#endif
+
+static mod_atomic_ptr_t crc_mutex = NULL;  // 查找表生成锁, 首次使用时创建
+
+/**
+ * @brief 获取查找表生成锁, 多个任务同时创建时只保留先发布的一个
+ * @retval uint8_t          是否成功(创建锁失败)
+ */
+static uint8_t crc_lock(void) {
+    void* mutex = MOD_ATOMIC_LOAD(crc_mutex, MOD_ATOMIC_ORDER_ACQUIRE);
+    if (mutex == NULL) {
+        void* created = (void*)MOD_MUTEX_CREATE("libcrc");
+        if (created == NULL)
+            return 0;
+        while (!MOD_ATOMIC_CAS(crc_mutex, mutex, created,
+                               MOD_ATOMIC_ORDER_SEQ_CST) &&
+               mutex == NULL) {
+        }
+        if (mutex != NULL) {  // 其它任务已发布
+            MOD_MUTEX_DELETE((MOD_MUTEX_HANDLE)created);
+            mutex = MOD_ATOMIC_LOAD(crc_mutex, MOD_ATOMIC_ORDER_ACQUIRE);
+        } else {
+            mutex = created;
+        }
+    }
+    MOD_MUTEX_ACQUIRE((MOD_MUTEX_HANDLE)mutex);
+    return 1;
+}
+
+static void crc_unlock(void) {
+    void* mutex = MOD_ATOMIC_LOAD(crc_mutex, MOD_ATOMIC_ORDER_RELAXED);
+    MOD_MUTEX_RELEASE((MOD_MUTEX_HANDLE)mutex);
+}
+
+#define CRC_LOCK() crc_lock()
+#define CRC_UNLOCK() crc_unlock()
+#endif  // MOD_CFG_USE_OS_NONE
+
+/**
+ * @brief 反转低width位
+ */
+static uint32_t reflect(uint32_t value, uint8_t width) {
+    uint32_t ret = 0;
+    for (uint8_t i = 0; i < width; i++) {
+        ret = (ret << 1) | (value & 1);
+        value >>= 1;
+    }
+    return ret;
+}
+
+/**
+ * @brief 按位计算单个表项, bits为一次处理的位数(8或4)
+ */
+static uint32_t table_entry(const crc_model_t* model, uint32_t index,
+                            uint8_t bits) {
+    uint32_t crc;
+    if (model->refin) {
+        uint32_t poly = reflect(model->poly, model->width);
+        crc = index;
+        for (uint8_t i = 0; i < bits; i++)
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+    } else {
+        uint32_t poly = model->poly << (32 - model->width);
+        crc = index << (32 - bits);
+        for (uint8_t i = 0; i < bits; i++)
+            crc = (crc & 0x80000000) ? (crc << 1) ^ poly : crc << 1;
+    }
+    return crc;
+}
+
+const crc_table_t* crc_table_init(crc_table_t* table,
+                                  const crc_model_t* model) {
+    uint32_t* t = table->table;
+#if CRC_CFG_USE_NIBBLE
+    for (uint32_t i = 0; i < 16; i++)
+        t[i] = table_entry(model, i, 4);
+#else
+    for (uint32_t i = 0; i < 256; i++)
+        t[i] = table_entry(model, i, 8);
+#if CRC_CFG_USE_SLICE
+    // 第k张表: 字节i之后再经过k个0字节的结果
+    for (uint32_t k = 1; k < CRC_CFG_SLICE_N; k++) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t prev = t[(k - 1) * 256 + i];
+            if (model->refin)
+                t[k * 256 + i] = (prev >> 8) ^ t[prev & 0xFF];
+            else
+                t[k * 256 + i] = (prev << 8) ^ t[prev >> 24];
+        }
+    }
+#endif  // CRC_CFG_USE_SLICE
+#endif  // CRC_CFG_USE_NIBBLE
+    table->refin = model->refin;
+    table->poly = model->poly;
+    table->width = model->width;
+    // 最后发布, 读到ready的任务一定能看到完整的表
+    MOD_ATOMIC_STORE(table->ready, 1, MOD_ATOMIC_ORDER_RELEASE);
+    return table;
+}
+
+#if CRC_CFG_USE_SLICE
+// 按小端/大端顺序拼接4字节, 不依赖地址对齐和CPU字节序
+#define LOAD_LE32(p)                                                     \
+    ((uint32_t)(p)[0] | (uint32_t)(p)[1] << 8 | (uint32_t)(p)[2] << 16 | \
+     (uint32_t)(p)[3] << 24)
+#define LOAD_BE32(p)                                   \
+    ((uint32_t)(p)[0] << 24 | (uint32_t)(p)[1] << 16 | \
+     (uint32_t)(p)[2] << 8 | (uint32_t)(p)[3])
+#define T(k, i) t[(k) * 256 + (i)]
+#endif
+
+/**
+ * @brief 反转域计算(输入反转的模型)
+ */
+static uint32_t update_ref(const uint32_t* t, uint32_t crc, const uint8_t* p,
+                           size_t length) {
+#if CRC_CFG_USE_NIBBLE
+    while (length--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ t[crc & 0x0F];
+        crc = (crc >> 4) ^ t[crc & 0x0F];
+    }
+#else
+#if CRC_CFG_USE_SLICE
+    while (length >= CRC_CFG_SLICE_N) {
+        uint32_t lo = crc ^ LOAD_LE32(p);
+#if CRC_CFG_SLICE_N == 8
+        uint32_t hi = LOAD_LE32(p + 4);
+        crc = T(7, lo & 0xFF) ^ T(6, (lo >> 8) & 0xFF) ^
+              T(5, (lo >> 16) & 0xFF) ^ T(4, lo >> 24) ^ T(3, hi & 0xFF) ^
+              T(2, (hi >> 8) & 0xFF) ^ T(1, (hi >> 16) & 0xFF) ^
+              T(0, hi >> 24);
+#else
+        crc = T(3, lo & 0xFF) ^ T(2, (lo >> 8) & 0xFF) ^
+              T(1, (lo >> 16) & 0xFF) ^ T(0, lo >> 24);
+#endif
+        p += CRC_CFG_SLICE_N;
+        length -= CRC_CFG_SLICE_N;
+    }
+#endif  // CRC_CFG_USE_SLICE
+    while (length--)
+        crc = (crc >> 8) ^ t[(crc ^ *p++) & 0xFF];
+#endif  // CRC_CFG_USE_NIBBLE
+    return crc;
+}
+
+/**
+ * @brief 左对齐计算(输入不反转的模型)
+ */
+static uint32_t update_norm(const uint32_t* t, uint32_t crc, const uint8_t* p,
+                            size_t length, uint8_t width) {
+    crc <<= 32 - width;
+#if CRC_CFG_USE_NIBBLE
+    while (length--) {
+        crc ^= (uint32_t)*p++ << 24;
+        crc = (crc << 4) ^ t[crc >> 28];
+        crc = (crc << 4) ^ t[crc >> 28];
+    }
+#else
+#if CRC_CFG_USE_SLICE
+    while (length >= CRC_CFG_SLICE_N) {
+        uint32_t lo = crc ^ LOAD_BE32(p);
+#if CRC_CFG_SLICE_N == 8
+        uint32_t hi = LOAD_BE32(p + 4);
+        crc = T(7, lo >> 24) ^ T(6, (lo >> 16) & 0xFF) ^
+              T(5, (lo >> 8) & 0xFF) ^ T(4, lo & 0xFF) ^ T(3, hi >> 24) ^
+              T(2, (hi >> 16) & 0xFF) ^ T(1, (hi >> 8) & 0xFF) ^
+              T(0, hi & 0xFF);
+#else
+        crc = T(3, lo >> 24) ^ T(2, (lo >> 16) & 0xFF) ^
+              T(1, (lo >> 8) & 0xFF) ^ T(0, lo & 0xFF);
+#endif
+        p += CRC_CFG_SLICE_N;
+        length -= CRC_CFG_SLICE_N;
+    }
+#endif  // CRC_CFG_USE_SLICE
+    while (length--)
+        crc = (crc << 8) ^ t[(crc >> 24) ^ *p++];
+#endif  // CRC_CFG_USE_NIBBLE
+    return crc >> (32 - width);
+}
+
+/**
+ * @brief 寄存器值与自然值(未反转)互相转换, 仅硬件后端使用
+ */
+static uint32_t reg_natural(const crc_model_t* model, uint32_t reg) {
+    return model->refin ? reflect(reg, model->width) : reg;
+}
+
+/**
+ * @brief 由后端计算, 失败时返回0
+ */
+static uint8_t backend_update(const crc_backend_t* backend,
+                              const crc_model_t* model, uint32_t* reg,
+                              const void* data, size_t length) {
+    uint32_t natural = reg_natural(model, *reg);
+    if (!backend->update(model, &natural, data, length))
+        return 0;
+    *reg = reg_natural(model, natural);
+    return 1;
+}
+
+/**
+ * @brief 首次使用时分配并生成模型的查找表, 参数相同的模型共用
+ * @retval crc_table_t*     查找表(NULL: 分配失败)
+ */
+static crc_table_t* alloc_table(const crc_model_t* model) {
+    mod_atomic_ptr_t* slot = model->heap_table;
+    crc_table_t* table = MOD_ATOMIC_LOAD(*slot, MOD_ATOMIC_ORDER_ACQUIRE);
+    if (table != NULL || !CRC_LOCK())
+        return table;
+    table = MOD_ATOMIC_LOAD(*slot, MOD_ATOMIC_ORDER_RELAXED);
+    if (table == NULL) {
+        table = m_alloc(sizeof(crc_table_t));
+        if (table != NULL) {
+            crc_table_init(table, model);
+            MOD_ATOMIC_STORE(*slot, table, MOD_ATOMIC_ORDER_RELEASE);
+        }
+    }
+    CRC_UNLOCK();
+    return table;
+}
+
+/**
+ * @brief 获取模型的查找表, 首次使用时加锁生成
+ * @retval const uint32_t*  查找表(NULL: 模型没有查找表)
+ */
+static const uint32_t* model_table(const crc_model_t* model) {
+    if (model->const_table != NULL)
+        return model->const_table;
+    crc_table_t* table = model->table;
+    if (table == NULL) {
+        if (model->heap_table == NULL)
+            return NULL;
+        table = alloc_table(model);
+        return table != NULL ? table->table : NULL;
+    }
+    if (!MOD_ATOMIC_LOAD(table->ready, MOD_ATOMIC_ORDER_ACQUIRE)) {
+        if (!CRC_LOCK())
+            return NULL;
+        if (!MOD_ATOMIC_LOAD(table->ready, MOD_ATOMIC_ORDER_RELAXED))
+            crc_table_init(table, model);
+        CRC_UNLOCK();
+    }
+    return table->table;
+}
+
+uint32_t crc_reg_init(const crc_model_t* model) {
+    return model->refin ? reflect(model->init, model->width) : model->init;
+}
+
+uint32_t crc_reg_update(const crc_model_t* model, uint32_t reg,
+                        const void* data, size_t length) {
+    const crc_backend_t* backend = crc_backend;
+    if (backend != NULL && length >= backend->min_length &&
+        backend_update(backend, model, &reg, data, length))
+        return reg;
+    const uint32_t* t = model_table(model);
+    if (t == NULL)
+        return reg;
+    if (model->refin)
+        return update_ref(t, reg, data, length);
+    return update_norm(t, reg, data, length, model->width);
+}
+
+uint32_t crc_reg_final(const crc_model_t* model, uint32_t reg) {
+    uint32_t crc = reg;
+    if (model->refin != model->refout)
+        crc = reflect(crc, model->width);
+    crc ^= model->xorout;
+    if (model->width < 32)
+        crc &= ((uint32_t)1 << model->width) - 1;
+    return crc;
+}
+
+uint8_t crc_init(crc_ctx_t* ctx, const crc_model_t* model) {
+    ctx->model = model;
+    ctx->reg = crc_reg_init(model);
+    return model_table(model) != NULL;
+}
+
+void crc_update(crc_ctx_t* ctx, const void* data, size_t length) {
+    ctx->reg = crc_reg_update(ctx->model, ctx->reg, data, length);
+}
+
+uint32_t crc_final(const crc_ctx_t* ctx) {
+    return crc_reg_final(ctx->model, ctx->reg);
+}
+
+uint32_t crc_calc(const crc_model_t* model, const void* data, size_t length) {
+    uint32_t reg = crc_reg_update(model, crc_reg_init(model), data, length);
+    return crc_reg_final(model, reg);
+}
+
+/**
+ * 常用模型的查找表, 按位宽/多项式/输入反转区分, 参数相同的模型共用
+ * 半字节表和字节表在编译期生成, 以常量存放于Flash:
+ * 表项对索引是线性的, 等于索引中各置位比特对应基值的异或,
+ * 基值由计算域的多项式按位移位得到(与table_entry的逐位计算等价).
+ * Slice-by-N的表较大, 只保存一个指针, 首次使用时由m_alloc分配并生成.
+ */
+#if !CRC_CFG_USE_SLICE
+// 反转域移位一位, 左对齐移位一位
+#define CRC_RS(x, p) (((uint32_t)(x) >> 1) ^ (((x) & 1u) ? (uint32_t)(p) : 0u))
+#define CRC_LS(x, p)                                                    \
+    (((uint32_t)(x) << 1) ^ (((x) & 0x80000000u) ? (uint32_t)(p) : 0u))
+#define CRC_R1(p) CRC_RS(p, p)
+#define CRC_R2(p) CRC_RS(CRC_R1(p), p)
+#define CRC_R3(p) CRC_RS(CRC_R2(p), p)
+#define CRC_R4(p) CRC_RS(CRC_R3(p), p)
+#define CRC_R5(p) CRC_RS(CRC_R4(p), p)
+#define CRC_R6(p) CRC_RS(CRC_R5(p), p)
+#define CRC_R7(p) CRC_RS(CRC_R6(p), p)
+#define CRC_L1(p) CRC_LS(p, p)
+#define CRC_L2(p) CRC_LS(CRC_L1(p), p)
+#define CRC_L3(p) CRC_LS(CRC_L2(p), p)
+#define CRC_L4(p) CRC_LS(CRC_L3(p), p)
+#define CRC_L5(p) CRC_LS(CRC_L4(p), p)
+#define CRC_L6(p) CRC_LS(CRC_L5(p), p)
+#define CRC_L7(p) CRC_LS(CRC_L6(p), p)
+#define CRC_BIT(i, b, v) (((i) & (b)) ? (v) : 0u)
+// 单个表项, p为计算域的多项式(反转后/左对齐到32位)
+#define CRC_REF4(p, i)                                              \
+    (CRC_BIT(i, 0x01, CRC_R3(p)) ^ CRC_BIT(i, 0x02, CRC_R2(p)) ^    \
+     CRC_BIT(i, 0x04, CRC_R1(p)) ^ CRC_BIT(i, 0x08, (uint32_t)(p)))
+#define CRC_NORM4(p, i)                                              \
+    (CRC_BIT(i, 0x01, (uint32_t)(p)) ^ CRC_BIT(i, 0x02, CRC_L1(p)) ^ \
+     CRC_BIT(i, 0x04, CRC_L2(p)) ^ CRC_BIT(i, 0x08, CRC_L3(p)))
+#define CRC_REF8(p, i)                                              \
+    (CRC_BIT(i, 0x01, CRC_R7(p)) ^ CRC_BIT(i, 0x02, CRC_R6(p)) ^    \
+     CRC_BIT(i, 0x04, CRC_R5(p)) ^ CRC_BIT(i, 0x08, CRC_R4(p)) ^    \
+     CRC_BIT(i, 0x10, CRC_R3(p)) ^ CRC_BIT(i, 0x20, CRC_R2(p)) ^    \
+     CRC_BIT(i, 0x40, CRC_R1(p)) ^ CRC_BIT(i, 0x80, (uint32_t)(p)))
+#define CRC_NORM8(p, i)                                              \
+    (CRC_BIT(i, 0x01, (uint32_t)(p)) ^ CRC_BIT(i, 0x02, CRC_L1(p)) ^ \
+     CRC_BIT(i, 0x04, CRC_L2(p)) ^ CRC_BIT(i, 0x08, CRC_L3(p)) ^     \
+     CRC_BIT(i, 0x10, CRC_L4(p)) ^ CRC_BIT(i, 0x20, CRC_L5(p)) ^     \
+     CRC_BIT(i, 0x40, CRC_L6(p)) ^ CRC_BIT(i, 0x80, CRC_L7(p)))
+// 展开索引从i开始的连续表项
+#define CRC_X4(e, p, i) e(p, (i)), e(p, (i) + 1), e(p, (i) + 2), e(p, (i) + 3)
+#define CRC_X16(e, p, i)                                           \
+    CRC_X4(e, p, i), CRC_X4(e, p, (i) + 4), CRC_X4(e, p, (i) + 8), \
+        CRC_X4(e, p, (i) + 12)
+#define CRC_X64(e, p, i)                                                \
+    CRC_X16(e, p, i), CRC_X16(e, p, (i) + 16), CRC_X16(e, p, (i) + 32), \
+        CRC_X16(e, p, (i) + 48)
+#define CRC_X256(e, p)                                       \
+    CRC_X64(e, p, 0), CRC_X64(e, p, 64), CRC_X64(e, p, 128), \
+        CRC_X64(e, p, 192)
+#if CRC_CFG_USE_NIBBLE
+#define CRC_TABLE_REF(name, p)                                 \
+    static const uint32_t name[16] = {CRC_X16(CRC_REF4, p, 0)}
+#define CRC_TABLE_NORM(name, p)                                 \
+    static const uint32_t name[16] = {CRC_X16(CRC_NORM4, p, 0)}
+#else
+#define CRC_TABLE_REF(name, p)                                \
+    static const uint32_t name[256] = {CRC_X256(CRC_REF8, p)}
+#define CRC_TABLE_NORM(name, p)                                \
+    static const uint32_t name[256] = {CRC_X256(CRC_NORM8, p)}
+#endif  // CRC_CFG_USE_NIBBLE
+#define CRC_MODEL_TABLE(name) NULL, name, NULL
+#else
+#define CRC_TABLE_REF(name, p) static mod_atomic_ptr_t name
+#define CRC_TABLE_NORM(name, p) static mod_atomic_ptr_t name
+#define CRC_MODEL_TABLE(name) NULL, NULL, &name
+#endif  // !CRC_CFG_USE_SLICE
+
+CRC_TABLE_REF(tbl_4_03_ref, 0x0C);
+CRC_TABLE_NORM(tbl_5_09, 0x48000000);
+CRC_TABLE_REF(tbl_5_15_ref, 0x15);
+CRC_TABLE_REF(tbl_5_05_ref, 0x14);
+CRC_TABLE_REF(tbl_6_03_ref, 0x30);
+CRC_TABLE_NORM(tbl_7_09, 0x12000000);
+CRC_TABLE_NORM(tbl_8_07, 0x07000000);
+CRC_TABLE_REF(tbl_8_07_ref, 0xE0);
+CRC_TABLE_REF(tbl_8_31_ref, 0x8C);
+CRC_TABLE_REF(tbl_16_8005_ref, 0xA001);
+CRC_TABLE_REF(tbl_16_1021_ref, 0x8408);
+CRC_TABLE_NORM(tbl_16_1021, 0x10210000);
+CRC_TABLE_REF(tbl_16_3d65_ref, 0xA6BC);
+CRC_TABLE_REF(tbl_32_04c11db7_ref, 0xEDB88320);
+CRC_TABLE_NORM(tbl_32_04c11db7, 0x04C11DB7);
+
+static const crc_model_t* const crc_models[] = {
+    &crc_model_crc4_itu,     &crc_model_crc5_epc,
+    &crc_model_crc5_itu,     &crc_model_crc5_usb,
+    &crc_model_crc6_itu,     &crc_model_crc7_mmc,
+    &crc_model_crc8,         &crc_model_crc8_itu,
+    &crc_model_crc8_rohc,    &crc_model_crc8_maxim,
+    &crc_model_crc16_ibm,    &crc_model_crc16_maxim,
+    &crc_model_crc16_usb,    &crc_model_crc16_modbus,
+    &crc_model_crc16_ccitt,  &crc_model_crc16_ccitt_false,
+    &crc_model_crc16_x25,    &crc_model_crc16_xmodem,
+    &crc_model_crc16_dnp,    &crc_model_crc32,
+    &crc_model_crc32_mpeg_2,
+};
+
+uint8_t crc_backend_verify(const crc_backend_t* backend) {
+    static const uint8_t check[] = "123456789";
+    for (size_t i = 0; i < sizeof(crc_models) / sizeof(crc_models[0]); i++) {
+        const crc_model_t* model = crc_models[i];
+        uint32_t reg = crc_reg_init(model);
+        if (!backend_update(backend, model, &reg, check, 9))
+            continue;  // 不支持的模型由软件计算
+        if (crc_reg_final(model, reg) != model->check)
+            return 0;
+        // 分段输入, 检查后端能否从寄存器值继续计算
+        reg = crc_reg_init(model);
+        if (!backend_update(backend, model, &reg, check, 4) ||
+            !backend_update(backend, model, &reg, check + 4, 5) ||
+            crc_reg_final(model, reg) != model->check)
+            return 0;
+    }
+    return 1;
+}
+
+uint8_t crc_set_backend(const crc_backend_t* backend) {
+    if (backend != NULL && !crc_backend_verify(backend))
+        return 0;
+    crc_backend = backend;
+    return 1;
+}
+
 /******************************************************************************
  * Name:    CRC-4/ITU           x4+x+1
  * Poly:    0x03
@@ -9,19 +448,11 @@
  * Xorout:  0x00
  * Note:
  *****************************************************************************/
-uint8_t crc4_itu(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x0C;  // 0x0C = (reverse 0x03)>>(8-4)
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc_model_crc4_itu = {
+    4, 1, 1, 0x03, 0x00, 0x00, 0x07, CRC_MODEL_TABLE(tbl_4_03_ref)};
+
+uint8_t crc4_itu(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc4_itu, data, length);
 }
 
 /******************************************************************************
@@ -33,19 +464,11 @@ uint8_t crc4_itu(uint8_t* data, uint16_t length) {
  * Xorout:  0x00
  * Note:
  *****************************************************************************/
-uint8_t crc5_epc(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0x48;  // Initial value: 0x48 = 0x09<<(8-5)
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; i++) {
-            if (crc & 0x80)
-                crc = (crc << 1) ^ 0x48;  // 0x48 = 0x09<<(8-5)
-            else
-                crc <<= 1;
-        }
-    }
-    return crc >> 3;
+const crc_model_t crc_model_crc5_epc = {
+    5, 0, 0, 0x09, 0x09, 0x00, 0x00, CRC_MODEL_TABLE(tbl_5_09)};
+
+uint8_t crc5_epc(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc5_epc, data, length);
 }
 
 /******************************************************************************
@@ -57,19 +480,11 @@ uint8_t crc5_epc(uint8_t* data, uint16_t length) {
  * Xorout:  0x00
  * Note:
  *****************************************************************************/
-uint8_t crc5_itu(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x15;  // 0x15 = (reverse 0x15)>>(8-5)
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc_model_crc5_itu = {
+    5, 1, 1, 0x15, 0x00, 0x00, 0x07, CRC_MODEL_TABLE(tbl_5_15_ref)};
+
+uint8_t crc5_itu(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc5_itu, data, length);
 }
 
 /******************************************************************************
@@ -81,19 +496,11 @@ uint8_t crc5_itu(uint8_t* data, uint16_t length) {
  * Xorout:  0x1F
  * Note:
  *****************************************************************************/
-uint8_t crc5_usb(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0x1F;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x14;  // 0x14 = (reverse 0x05)>>(8-5)
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc ^ 0x1F;
+const crc_model_t crc_model_crc5_usb = {
+    5, 1, 1, 0x05, 0x1F, 0x1F, 0x19, CRC_MODEL_TABLE(tbl_5_05_ref)};
+
+uint8_t crc5_usb(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc5_usb, data, length);
 }
 
 /******************************************************************************
@@ -105,19 +512,11 @@ uint8_t crc5_usb(uint8_t* data, uint16_t length) {
  * Xorout:  0x00
  * Note:
  *****************************************************************************/
-uint8_t crc6_itu(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x30;  // 0x30 = (reverse 0x03)>>(8-6)
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc_model_crc6_itu = {
+    6, 1, 1, 0x03, 0x00, 0x00, 0x06, CRC_MODEL_TABLE(tbl_6_03_ref)};
+
+uint8_t crc6_itu(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc6_itu, data, length);
 }
 
 /******************************************************************************
@@ -129,19 +528,11 @@ uint8_t crc6_itu(uint8_t* data, uint16_t length) {
  * Xorout:  0x00
  * Use:     MultiMediaCard,SD,ect.
  *****************************************************************************/
-uint8_t crc7_mmc(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; i++) {
-            if (crc & 0x80)
-                crc = (crc << 1) ^ 0x12;  // 0x12 = 0x09<<(8-7)
-            else
-                crc <<= 1;
-        }
-    }
-    return crc >> 1;
+const crc_model_t crc_model_crc7_mmc = {
+    7, 0, 0, 0x09, 0x00, 0x00, 0x75, CRC_MODEL_TABLE(tbl_7_09)};
+
+uint8_t crc7_mmc(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc7_mmc, data, length);
 }
 
 /******************************************************************************
@@ -153,19 +544,11 @@ uint8_t crc7_mmc(uint8_t* data, uint16_t length) {
  * Xorout:  0x00
  * Note:
  *****************************************************************************/
-uint8_t crc8(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; i++) {
-            if (crc & 0x80)
-                crc = (crc << 1) ^ 0x07;
-            else
-                crc <<= 1;
-        }
-    }
-    return crc;
+const crc_model_t crc_model_crc8 = {
+    8, 0, 0, 0x07, 0x00, 0x00, 0xF4, CRC_MODEL_TABLE(tbl_8_07)};
+
+uint8_t crc8(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc8, data, length);
 }
 
 /******************************************************************************
@@ -177,19 +560,11 @@ uint8_t crc8(uint8_t* data, uint16_t length) {
  * Xorout:  0x55
  * Alias:   CRC-8/ATM
  *****************************************************************************/
-uint8_t crc8_itu(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; i++) {
-            if (crc & 0x80)
-                crc = (crc << 1) ^ 0x07;
-            else
-                crc <<= 1;
-        }
-    }
-    return crc ^ 0x55;
+const crc_model_t crc_model_crc8_itu = {
+    8, 0, 0, 0x07, 0x00, 0x55, 0xA1, CRC_MODEL_TABLE(tbl_8_07)};
+
+uint8_t crc8_itu(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc8_itu, data, length);
 }
 
 /******************************************************************************
@@ -201,19 +576,11 @@ uint8_t crc8_itu(uint8_t* data, uint16_t length) {
  * Xorout:  0x00
  * Note:
  *****************************************************************************/
-uint8_t crc8_rohc(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0xFF;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xE0;  // 0xE0 = reverse 0x07
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc_model_crc8_rohc = {
+    8, 1, 1, 0x07, 0xFF, 0x00, 0xD0, CRC_MODEL_TABLE(tbl_8_07_ref)};
+
+uint8_t crc8_rohc(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc8_rohc, data, length);
 }
 
 /******************************************************************************
@@ -226,19 +593,11 @@ uint8_t crc8_rohc(uint8_t* data, uint16_t length) {
  * Alias:   DOW-CRC,CRC-8/IBUTTON
  * Use:     Maxim(Dallas)'s some devices,e.g. DS18B20
  *****************************************************************************/
-uint8_t crc8_maxim(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint8_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; i++) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x8C;  // 0x8C = reverse 0x31
-            else
-                crc >>= 1;
-        }
-    }
-    return crc;
+const crc_model_t crc_model_crc8_maxim = {
+    8, 1, 1, 0x31, 0x00, 0x00, 0xA1, CRC_MODEL_TABLE(tbl_8_31_ref)};
+
+uint8_t crc8_maxim(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc8_maxim, data, length);
 }
 
 /******************************************************************************
@@ -250,19 +609,11 @@ uint8_t crc8_maxim(uint8_t* data, uint16_t length) {
  * Xorout:  0x0000
  * Alias:   CRC-16,CRC-16/ARC,CRC-16/LHA
  *****************************************************************************/
-uint16_t crc16_ibm(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xA001;  // 0xA001 = reverse 0x8005
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc_model_crc16_ibm = {
+    16, 1, 1, 0x8005, 0x0000, 0x0000, 0xBB3D, CRC_MODEL_TABLE(tbl_16_8005_ref)};
+
+uint16_t crc16_ibm(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc16_ibm, data, length);
 }
 
 /******************************************************************************
@@ -274,19 +625,11 @@ uint16_t crc16_ibm(uint8_t* data, uint16_t length) {
  * Xorout:  0xFFFF
  * Note:
  *****************************************************************************/
-uint16_t crc16_maxim(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xA001;  // 0xA001 = reverse 0x8005
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return ~crc;  // crc^0xffff
+const crc_model_t crc_model_crc16_maxim = {
+    16, 1, 1, 0x8005, 0x0000, 0xFFFF, 0x44C2, CRC_MODEL_TABLE(tbl_16_8005_ref)};
+
+uint16_t crc16_maxim(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc16_maxim, data, length);
 }
 
 /******************************************************************************
@@ -298,19 +641,11 @@ uint16_t crc16_maxim(uint8_t* data, uint16_t length) {
  * Xorout:  0xFFFF
  * Note:
  *****************************************************************************/
-uint16_t crc16_usb(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0xffff;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xA001;  // 0xA001 = reverse 0x8005
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return ~crc;  // crc^0xffff
+const crc_model_t crc_model_crc16_usb = {
+    16, 1, 1, 0x8005, 0xFFFF, 0xFFFF, 0xB4C8, CRC_MODEL_TABLE(tbl_16_8005_ref)};
+
+uint16_t crc16_usb(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc16_usb, data, length);
 }
 
 /******************************************************************************
@@ -322,19 +657,11 @@ uint16_t crc16_usb(uint8_t* data, uint16_t length) {
  * Xorout:  0x0000
  * Note:
  *****************************************************************************/
-uint16_t crc16_modbus(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0xffff;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xA001;  // 0xA001 = reverse 0x8005
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc_model_crc16_modbus = {
+    16, 1, 1, 0x8005, 0xFFFF, 0x0000, 0x4B37, CRC_MODEL_TABLE(tbl_16_8005_ref)};
+
+uint16_t crc16_modbus(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc16_modbus, data, length);
 }
 
 /******************************************************************************
@@ -346,19 +673,11 @@ uint16_t crc16_modbus(uint8_t* data, uint16_t length) {
  * Xorout:  0x0000
  * Alias:   CRC-CCITT,CRC-16/CCITT-TRUE,CRC-16/KERMIT
  *****************************************************************************/
-uint16_t crc16_ccitt(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x8408;  // 0x8408 = reverse 0x1021
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return crc;
+const crc_model_t crc_model_crc16_ccitt = {
+    16, 1, 1, 0x1021, 0x0000, 0x0000, 0x2189, CRC_MODEL_TABLE(tbl_16_1021_ref)};
+
+uint16_t crc16_ccitt(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc16_ccitt, data, length);
 }
 
 /******************************************************************************
@@ -370,19 +689,11 @@ uint16_t crc16_ccitt(uint8_t* data, uint16_t length) {
  * Xorout:  0x0000
  * Note:
  *****************************************************************************/
-uint16_t crc16_ccitt_false(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0xffff;  //Initial value
-    while (length--) {
-        crc ^= (uint16_t)(*data++) << 8;  // crc ^= (uint6_t)(*data)<<8; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 0x8000)
-                crc = (crc << 1) ^ 0x1021;
-            else
-                crc <<= 1;
-        }
-    }
-    return crc;
+const crc_model_t crc_model_crc16_ccitt_false = {
+    16, 0, 0, 0x1021, 0xFFFF, 0x0000, 0x29B1, CRC_MODEL_TABLE(tbl_16_1021)};
+
+uint16_t crc16_ccitt_false(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc16_ccitt_false, data, length);
 }
 
 /******************************************************************************
@@ -394,19 +705,11 @@ uint16_t crc16_ccitt_false(uint8_t* data, uint16_t length) {
  * Xorout:  0XFFFF
  * Note:
  *****************************************************************************/
-uint16_t crc16_x25(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0xffff;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0x8408;  // 0x8408 = reverse 0x1021
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return ~crc;  // crc^Xorout
+const crc_model_t crc_model_crc16_x25 = {
+    16, 1, 1, 0x1021, 0xFFFF, 0xFFFF, 0x906E, CRC_MODEL_TABLE(tbl_16_1021_ref)};
+
+uint16_t crc16_x25(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc16_x25, data, length);
 }
 
 /******************************************************************************
@@ -418,20 +721,11 @@ uint16_t crc16_x25(uint8_t* data, uint16_t length) {
  * Xorout:  0x0000
  * Alias:   CRC-16/ZMODEM,CRC-16/ACORN
  *****************************************************************************/
-uint16_t crc16_xmodem(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= (uint16_t)(*data++)
-               << 8;  // crc ^= (uint16_t)(*data)<<8; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 0x8000)
-                crc = (crc << 1) ^ 0x1021;
-            else
-                crc <<= 1;
-        }
-    }
-    return crc;
+const crc_model_t crc_model_crc16_xmodem = {
+    16, 0, 0, 0x1021, 0x0000, 0x0000, 0x31C3, CRC_MODEL_TABLE(tbl_16_1021)};
+
+uint16_t crc16_xmodem(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc16_xmodem, data, length);
 }
 
 /******************************************************************************
@@ -443,19 +737,11 @@ uint16_t crc16_xmodem(uint8_t* data, uint16_t length) {
  * Xorout:  0xFFFF
  * Use:     M-Bus,ect.
  *****************************************************************************/
-uint16_t crc16_dnp(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint16_t crc = 0;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc = (crc >> 1) ^ 0xA6BC;  // 0xA6BC = reverse 0x3D65
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return ~crc;  // crc^Xorout
+const crc_model_t crc_model_crc16_dnp = {
+    16, 1, 1, 0x3D65, 0x0000, 0xFFFF, 0xEA82, CRC_MODEL_TABLE(tbl_16_3d65_ref)};
+
+uint16_t crc16_dnp(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc16_dnp, data, length);
 }
 
 /******************************************************************************
@@ -468,20 +754,12 @@ uint16_t crc16_dnp(uint8_t* data, uint16_t length) {
  * Alias:   CRC_32/ADCCP
  * Use:     WinRAR,ect.
  *****************************************************************************/
-uint32_t crc32(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint32_t crc = 0xffffffff;  // Initial value
-    while (length--) {
-        crc ^= *data++;  // crc ^= *data; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 1)
-                crc =
-                    (crc >> 1) ^ 0xEDB88320;  // 0xEDB88320= reverse 0x04C11DB7
-            else
-                crc = (crc >> 1);
-        }
-    }
-    return ~crc;
+const crc_model_t crc_model_crc32 = {
+    32, 1, 1, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, 0xCBF43926,
+    CRC_MODEL_TABLE(tbl_32_04c11db7_ref)};
+
+uint32_t crc32(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc32, data, length);
 }
 
 /******************************************************************************
@@ -493,18 +771,10 @@ uint32_t crc32(uint8_t* data, uint16_t length) {
  * Xorout:  0x0000000
  * Note:
  *****************************************************************************/
-uint32_t crc32_mpeg_2(uint8_t* data, uint16_t length) {
-    uint8_t i;
-    uint32_t crc = 0xffffffff;  // Initial value
-    while (length--) {
-        crc ^= (uint32_t)(*data++)
-               << 24;  // crc ^=(uint32_t)(*data)<<24; data++;
-        for (i = 0; i < 8; ++i) {
-            if (crc & 0x80000000)
-                crc = (crc << 1) ^ 0x04C11DB7;
-            else
-                crc <<= 1;
-        }
-    }
-    return crc;
+const crc_model_t crc_model_crc32_mpeg_2 = {
+    32, 0, 0, 0x04C11DB7, 0xFFFFFFFF, 0x00000000, 0x0376E6E7,
+    CRC_MODEL_TABLE(tbl_32_04c11db7)};
+
+uint32_t crc32_mpeg_2(const uint8_t* data, size_t length) {
+    return crc_calc(&crc_model_crc32_mpeg_2, data, length);
 }
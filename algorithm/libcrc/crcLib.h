@@ -1,28 +1,194 @@
 #ifndef __CRCLIB_H__
 #define __CRCLIB_H__
 
-#include "stdint.h"
-
-uint8_t crc4_itu(uint8_t* data, uint16_t length);
-uint8_t crc5_epc(uint8_t* data, uint16_t length);
-uint8_t crc5_itu(uint8_t* data, uint16_t length);
-uint8_t crc5_usb(uint8_t* data, uint16_t length);
-uint8_t crc6_itu(uint8_t* data, uint16_t length);
-uint8_t crc7_mmc(uint8_t* data, uint16_t length);
-uint8_t crc8(uint8_t* data, uint16_t length);
-uint8_t crc8_itu(uint8_t* data, uint16_t length);
-uint8_t crc8_rohc(uint8_t* data, uint16_t length);
-uint8_t crc8_maxim(uint8_t* data, uint16_t length);  //DS18B20
-uint16_t crc16_ibm(uint8_t* data, uint16_t length);
-uint16_t crc16_maxim(uint8_t* data, uint16_t length);
-uint16_t crc16_usb(uint8_t* data, uint16_t length);
-uint16_t crc16_modbus(uint8_t* data, uint16_t length);
-uint16_t crc16_ccitt(uint8_t* data, uint16_t length);
-uint16_t crc16_ccitt_false(uint8_t* data, uint16_t length);
-uint16_t crc16_x25(uint8_t* data, uint16_t length);
-uint16_t crc16_xmodem(uint8_t* data, uint16_t length);
-uint16_t crc16_dnp(uint8_t* data, uint16_t length);
-uint32_t crc32(uint8_t* data, uint16_t length);
-uint32_t crc32_mpeg_2(uint8_t* data, uint16_t length);
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "modules.h"
+
+/**
+ * 查表策略(Kconfig选择, 决定crc_table_t的大小)
+ * CRC_CFG_USE_NIBBLE: 16项半字节表, 64Byte, 适合小Flash
+ * CRC_CFG_USE_TABLE:  256项字节表, 1KB (默认)
+ * CRC_CFG_USE_SLICE:  Slice-by-N, 256*N项, 4KB/8KB, 每次处理N字节
+ * 内置模型的半字节表/字节表在编译期生成, 存放在Flash中;
+ * 内置模型的Slice-by-N表在首次使用时由m_alloc分配, 只为用到的表占用RAM;
+ * 自定义模型的表由调用者提供存储区, 首次使用时生成
+ */
+#if CRC_CFG_USE_SLICE
+#if CRC_CFG_SLICE_N != 4 && CRC_CFG_SLICE_N != 8
+#error "CRC_CFG_SLICE_N must be 4 or 8"
+#endif
+#define CRC_TABLE_SIZE (256 * CRC_CFG_SLICE_N)
+#elif CRC_CFG_USE_NIBBLE
+#define CRC_TABLE_SIZE 16
+#else
+#define CRC_TABLE_SIZE 256
+#endif
+
+typedef struct {              // CRC查找表, 仅与位宽/多项式/输入反转有关
+    mod_atomic_size_t ready;  // 已生成(最后以release写入)
+    uint8_t width;            // 位宽
+    uint8_t refin;            // 输入是否反转
+    uint32_t poly;            // 多项式
+    uint32_t table[CRC_TABLE_SIZE];
+} crc_table_t;
+
+typedef struct {         // CRC参数模型(Rocksoft模型)
+    uint8_t width;       // 位宽(1~32)
+    uint8_t refin;       // 输入是否反转
+    uint8_t refout;      // 输出是否反转
+    uint32_t poly;       // 多项式(不含最高位)
+    uint32_t init;       // 初始值
+    uint32_t xorout;     // 结果异或值
+    uint32_t check;      // "123456789"的校验值
+    crc_table_t* table;  // 查找表存储区, 首次使用时生成
+    const uint32_t* const_table;  // 编译期生成的查找表(NULL: 使用table)
+    mod_atomic_ptr_t* heap_table;  // 首次使用时分配的查找表(crc_table_t*)
+    // 三者不能同时为NULL, 否则crc_init失败, 数据不参与计算
+} crc_model_t;
+
+typedef struct {               // CRC流式计算上下文
+    const crc_model_t* model;  // 参数模型
+    uint32_t reg;              // 当前寄存器值
+} crc_ctx_t;
+
+typedef struct {  // CRC硬件后端
+    /**
+     * @brief 由硬件计算一段数据
+     * @param  model        参数模型
+     * @param  reg          当前寄存器值(未反转/未异或的自然值), 计算后写回
+     * @param  data         数据
+     * @param  length       数据长度
+     * @retval uint8_t      是否已处理(0: 不支持该模型, 由软件计算)
+     * @note 多个上下文可能交替调用, 每次都应以reg重新装载硬件初值
+     */
+    uint8_t (*update)(const crc_model_t* model, uint32_t* reg,
+                      const void* data, size_t length);
+    size_t min_length;  // 短于此长度的数据直接由软件计算
+} crc_backend_t;
+
+/**
+ * @brief 按参数模型生成查找表
+ * @param  table            查找表存储区
+ * @param  model            参数模型
+ * @retval const crc_table_t* 查找表(即table)
+ * @note 通常无需手动调用, 模型首次使用时会自动生成model->table
+ */
+extern const crc_table_t* crc_table_init(crc_table_t* table,
+                                         const crc_model_t* model);
+
+/**
+ * @brief 开始一次流式CRC计算
+ * @param  ctx              上下文
+ * @param  model            参数模型
+ * @retval uint8_t          是否成功(模型没有查找表或分配失败时失败)
+ * @note 模型的RAM查找表在首次使用时加锁生成, 可在多个任务中同时使用
+ */
+extern uint8_t crc_init(crc_ctx_t* ctx, const crc_model_t* model);
+
+/**
+ * @brief 输入数据, 可多次调用
+ * @param  ctx              上下文
+ * @param  data             数据
+ * @param  length           数据长度
+ */
+extern void crc_update(crc_ctx_t* ctx, const void* data, size_t length);
+
+/**
+ * @brief 结束计算并获取CRC值
+ * @param  ctx              上下文
+ * @retval uint32_t         CRC值(低width位有效)
+ * @note 不修改上下文, 可在之后继续crc_update
+ */
+extern uint32_t crc_final(const crc_ctx_t* ctx);
+
+/**
+ * @brief 一次性计算CRC值
+ * @param  model            参数模型
+ * @param  data             数据
+ * @param  length           数据长度
+ * @retval uint32_t         CRC值(低width位有效)
+ */
+extern uint32_t crc_calc(const crc_model_t* model, const void* data,
+                         size_t length);
+
+/**
+ * 寄存器接口, 供需要把校验状态保存为整数的协议栈逐字节使用
+ * 寄存器值为内部表示(不超过width位), 只应传回同一模型的crc_reg_*函数
+ */
+
+extern uint32_t crc_reg_init(const crc_model_t* model);
+extern uint32_t crc_reg_update(const crc_model_t* model, uint32_t reg,
+                               const void* data, size_t length);
+extern uint32_t crc_reg_final(const crc_model_t* model, uint32_t reg);
+
+/**
+ * @brief 设置CRC硬件后端
+ * @param  backend          后端(NULL: 仅使用软件计算)
+ * @retval uint8_t          是否成功(后端未通过crc_backend_verify时不启用)
+ */
+extern uint8_t crc_set_backend(const crc_backend_t* backend);
+
+/**
+ * @brief 用各常用模型的校验值检查后端
+ * @param  backend          后端
+ * @retval uint8_t          后端支持的模型是否全部正确(含分段输入)
+ */
+extern uint8_t crc_backend_verify(const crc_backend_t* backend);
+
+// 常用参数模型
+extern const crc_model_t crc_model_crc4_itu;
+extern const crc_model_t crc_model_crc5_epc;
+extern const crc_model_t crc_model_crc5_itu;
+extern const crc_model_t crc_model_crc5_usb;
+extern const crc_model_t crc_model_crc6_itu;
+extern const crc_model_t crc_model_crc7_mmc;
+extern const crc_model_t crc_model_crc8;
+extern const crc_model_t crc_model_crc8_itu;
+extern const crc_model_t crc_model_crc8_rohc;
+extern const crc_model_t crc_model_crc8_maxim;
+extern const crc_model_t crc_model_crc16_ibm;
+extern const crc_model_t crc_model_crc16_maxim;
+extern const crc_model_t crc_model_crc16_usb;
+extern const crc_model_t crc_model_crc16_modbus;
+extern const crc_model_t crc_model_crc16_ccitt;
+extern const crc_model_t crc_model_crc16_ccitt_false;
+extern const crc_model_t crc_model_crc16_x25;
+extern const crc_model_t crc_model_crc16_xmodem;
+extern const crc_model_t crc_model_crc16_dnp;
+extern const crc_model_t crc_model_crc32;
+extern const crc_model_t crc_model_crc32_mpeg_2;
+
+// 常用模型的快捷接口, 参数相同的模型共用查找表
+uint8_t crc4_itu(const uint8_t* data, size_t length);
+uint8_t crc5_epc(const uint8_t* data, size_t length);
+uint8_t crc5_itu(const uint8_t* data, size_t length);
+uint8_t crc5_usb(const uint8_t* data, size_t length);
+uint8_t crc6_itu(const uint8_t* data, size_t length);
+uint8_t crc7_mmc(const uint8_t* data, size_t length);
+uint8_t crc8(const uint8_t* data, size_t length);
+uint8_t crc8_itu(const uint8_t* data, size_t length);
+uint8_t crc8_rohc(const uint8_t* data, size_t length);
+uint8_t crc8_maxim(const uint8_t* data, size_t length);  // DS18B20
+uint16_t crc16_ibm(const uint8_t* data, size_t length);
+uint16_t crc16_maxim(const uint8_t* data, size_t length);
+uint16_t crc16_usb(const uint8_t* data, size_t length);
+uint16_t crc16_modbus(const uint8_t* data, size_t length);
+uint16_t crc16_ccitt(const uint8_t* data, size_t length);
+uint16_t crc16_ccitt_false(const uint8_t* data, size_t length);
+uint16_t crc16_x25(const uint8_t* data, size_t length);
+uint16_t crc16_xmodem(const uint8_t* data, size_t length);
+uint16_t crc16_dnp(const uint8_t* data, size_t length);
+uint32_t crc32(const uint8_t* data, size_t length);
+uint32_t crc32_mpeg_2(const uint8_t* data, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif  // __CRCLIB_H__
@@ -0,0 +1,75 @@
+// libcrc吞吐量基准测试, 与逐位计算比较
+// 在工程根目录构建并运行(查表策略通过-D选择, 见modules_config.h):
+//   gcc -O2 [-DCRC_CFG_USE_NIBBLE=1 | -DCRC_CFG_USE_SLICE=1
+//       -DCRC_CFG_SLICE_N=4] -Ialgorithm/libcrc/test -I. -Ialgorithm/libcrc
+//       algorithm/libcrc/crcLib.c algorithm/libcrc/test/crc_bench.c
+//       -o crc_bench
+//   ./crc_bench [总字节数]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "crcLib.h"
+
+#define BENCH_BYTES (64u << 20)
+#define BENCH_BUF 4096
+
+static uint8_t m_buf[BENCH_BUF];
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// 逐位计算的CRC-32, 作为无表实现的参照
+static uint32_t bitwise_crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    while (length--) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static void report(const char* name, uint64_t bytes, uint64_t ns,
+                   uint32_t sum) {
+    printf("%-14s %8.1f MB/s (%08lx)\n", name, bytes * 1000.0 / ns,
+           (unsigned long)sum);
+}
+
+static void bench_model(const char* name, const crc_model_t* model,
+                        uint64_t bytes) {
+    uint32_t sum = crc_calc(model, m_buf, BENCH_BUF);  // 预热(生成RAM表)
+    uint64_t start = host_ns();
+    for (uint64_t done = 0; done < bytes; done += BENCH_BUF)
+        sum += crc_calc(model, m_buf, BENCH_BUF);
+    report(name, bytes, host_ns() - start, sum);
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t bytes = BENCH_BYTES;
+    if (argc > 1)
+        bytes = strtoull(argv[1], NULL, 0);
+    for (size_t i = 0; i < BENCH_BUF; i++)
+        m_buf[i] = (uint8_t)(i * 131 + 7);
+#if CRC_CFG_USE_SLICE
+    printf("strategy: slice-by-%d (RAM table)\n", CRC_CFG_SLICE_N);
+#elif CRC_CFG_USE_NIBBLE
+    printf("strategy: nibble (const table)\n");
+#else
+    printf("strategy: byte (const table)\n");
+#endif
+    uint32_t sum = 0;
+    uint64_t start = host_ns();
+    for (uint64_t done = 0; done < bytes / 16; done += BENCH_BUF)
+        sum += bitwise_crc32(m_buf, BENCH_BUF);
+    report("crc32 bitwise", bytes / 16, host_ns() - start, sum);
+    bench_model("crc32", &crc_model_crc32, bytes);
+    bench_model("crc32_mpeg_2", &crc_model_crc32_mpeg_2, bytes);
+    bench_model("crc16_modbus", &crc_model_crc16_modbus, bytes);
+    bench_model("crc16_xmodem", &crc_model_crc16_xmodem, bytes);
+    bench_model("crc8", &crc_model_crc8, bytes);
+    return 0;
+}
@@ -0,0 +1,321 @@
+// libcrc回归测试, 与逐位计算的参考实现比较, 检查硬件后端的校验与回退,
+// 以及TinyFrame/lwpkt/modbus的校验值
+// 在工程根目录构建并运行(查表策略见modules_config.h):
+//   gcc -O2 -Ialgorithm/libcrc/test -I. -Ialgorithm/libcrc -Idebug/minctest
+//       algorithm/libcrc/crcLib.c algorithm/libcrc/test/crc_test.c -o crc_test
+//   ./crc_test
+// 全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crcLib.h"
+#include "host_check.h"
+
+static const struct {
+    const char* name;
+    const crc_model_t* model;
+} m_models[] = {
+    {"crc4_itu", &crc_model_crc4_itu},
+    {"crc5_epc", &crc_model_crc5_epc},
+    {"crc5_itu", &crc_model_crc5_itu},
+    {"crc5_usb", &crc_model_crc5_usb},
+    {"crc6_itu", &crc_model_crc6_itu},
+    {"crc7_mmc", &crc_model_crc7_mmc},
+    {"crc8", &crc_model_crc8},
+    {"crc8_itu", &crc_model_crc8_itu},
+    {"crc8_rohc", &crc_model_crc8_rohc},
+    {"crc8_maxim", &crc_model_crc8_maxim},
+    {"crc16_ibm", &crc_model_crc16_ibm},
+    {"crc16_maxim", &crc_model_crc16_maxim},
+    {"crc16_usb", &crc_model_crc16_usb},
+    {"crc16_modbus", &crc_model_crc16_modbus},
+    {"crc16_ccitt", &crc_model_crc16_ccitt},
+    {"crc16_ccitt_false", &crc_model_crc16_ccitt_false},
+    {"crc16_x25", &crc_model_crc16_x25},
+    {"crc16_xmodem", &crc_model_crc16_xmodem},
+    {"crc16_dnp", &crc_model_crc16_dnp},
+    {"crc32", &crc_model_crc32},
+    {"crc32_mpeg_2", &crc_model_crc32_mpeg_2},
+};
+
+static uint32_t reflect(uint32_t value, uint8_t width) {
+    uint32_t ret = 0;
+    for (uint8_t i = 0; i < width; i++) {
+        ret = (ret << 1) | (value & 1);
+        value >>= 1;
+    }
+    return ret;
+}
+
+// 逐位计算的参考实现, 直接按Rocksoft模型定义
+static uint32_t ref_crc(const crc_model_t* m, const uint8_t* data,
+                        size_t length) {
+    uint64_t top = 1ull << (m->width - 1);
+    uint64_t mask = (top << 1) - 1;
+    uint64_t crc = m->init;
+    while (length--) {
+        uint8_t byte = *data++;
+        if (m->refin)
+            byte = (uint8_t)reflect(byte, 8);
+        for (int i = 7; i >= 0; i--) {
+            uint64_t bit = (byte >> i) & 1;
+            bit ^= (crc & top) ? 1 : 0;
+            crc = (crc << 1) & mask;
+            if (bit)
+                crc ^= m->poly;
+        }
+    }
+    if (m->refout)
+        crc = reflect((uint32_t)crc, m->width);
+    return (uint32_t)((crc ^ m->xorout) & mask);
+}
+
+/* 编译期生成的常量表与运行时生成的表一致 */
+static void test_const_table(void) {
+    for (size_t i = 0; i < sizeof(m_models) / sizeof(m_models[0]); i++) {
+        const crc_model_t* m = m_models[i].model;
+        if (m->const_table == NULL)
+            continue;  // Slice-by-N使用运行时生成的表
+        static crc_table_t table;
+        crc_table_init(&table, m);
+        if (memcmp(table.table, m->const_table, sizeof(table.table)) != 0)
+            CHECK_FAIL("%s: const table mismatch", m_models[i].name);
+    }
+}
+
+#if CRC_CFG_USE_SLICE
+/* Slice-by-N: 只为用到的表分配RAM, 参数相同的模型共用一张表 */
+static void test_lazy_table(void) {
+    const crc_model_t* modbus = &crc_model_crc16_modbus;
+    CHECK(modbus->heap_table != NULL && modbus->table == NULL);
+    CHECK(*modbus->heap_table == NULL && *crc_model_crc32.heap_table == NULL);
+    CHECK(crc16_modbus((const uint8_t*)"123456789", 9) == 0x4B37);
+    const crc_table_t* table = *modbus->heap_table;
+    CHECK(table != NULL && table->ready && table->width == 16);
+    CHECK(crc_model_crc16_usb.heap_table == modbus->heap_table);
+    CHECK(crc16_usb((const uint8_t*)"123456789", 9) == 0xB4C8);
+    CHECK(*modbus->heap_table == table);
+    CHECK(*crc_model_crc32.heap_table == NULL);
+    CHECK(*crc_model_crc16_ccitt.heap_table == NULL);
+}
+#endif  // CRC_CFG_USE_SLICE
+
+/* 所有模型与参考实现一致, 包括check值和分段输入 */
+static void test_models(void) {
+    static uint8_t buf[4096 + 7];
+    srand(1);
+    for (size_t i = 0; i < sizeof(buf); i++)
+        buf[i] = (uint8_t)rand();
+    for (size_t i = 0; i < sizeof(m_models) / sizeof(m_models[0]); i++) {
+        const crc_model_t* m = m_models[i].model;
+        CHECK(crc_calc(m, "123456789", 9) == m->check);
+        CHECK(ref_crc(m, (const uint8_t*)"123456789", 9) == m->check);
+        for (int n = 0; n < 64; n++) {
+            size_t off = rand() % 8;
+            size_t len = rand() % (sizeof(buf) - off);
+            size_t cut = len ? rand() % len : 0;
+            uint32_t ref = ref_crc(m, buf + off, len);
+            crc_ctx_t ctx;
+            crc_init(&ctx, m);
+            crc_update(&ctx, buf + off, cut);
+            crc_update(&ctx, buf + off + cut, len - cut);
+            if (crc_calc(m, buf + off, len) != ref || crc_final(&ctx) != ref) {
+                CHECK_FAIL("%s: len %zu cut %zu mismatch", m_models[i].name,
+                           len, cut);
+                break;
+            }
+        }
+    }
+    CHECK(crc16_modbus((const uint8_t*)"123456789", 9) == 0x4B37);
+    CHECK(crc32((const uint8_t*)"123456789", 9) == 0xCBF43926);
+}
+
+/* 自定义模型使用调用者提供的RAM表 */
+static void test_custom_model(void) {
+    static crc_table_t my_table;
+    static const crc_model_t my_model = {
+        16, 0, 0, 0x1021, 0x1D0F, 0x0000, 0xE5CC, &my_table, NULL, NULL};
+    CHECK(my_model.const_table == NULL);
+    CHECK(crc_calc(&my_model, "123456789", 9) == 0xE5CC);
+    CHECK(my_table.ready && my_table.width == 16);
+    // 没有任何查找表的模型被拒绝, 而不是访问空指针
+    static const crc_model_t no_table = {
+        16, 0, 0, 0x1021, 0x1D0F, 0x0000, 0xE5CC, NULL, NULL, NULL};
+    crc_ctx_t ctx;
+    CHECK(!crc_init(&ctx, &no_table));
+    crc_update(&ctx, "123456789", 9);
+    CHECK(ctx.reg == crc_reg_init(&no_table));
+    CHECK(crc_init(&ctx, &my_model));
+}
+
+/* 模拟硬件后端: 在自然值(未反转)寄存器上逐位计算, 记录调用 */
+typedef struct {
+    crc_backend_t backend;
+    const crc_model_t* only;  // 只支持该模型(NULL: 全部支持)
+    int fault;                // 1: 结果翻转一位 2: 忽略传入的寄存器值
+    int calls;                // 被调用并处理的次数
+    size_t bytes;             // 处理的字节数
+} fake_backend_t;
+
+static fake_backend_t* m_fake;
+
+static uint8_t fake_update(const crc_model_t* model, uint32_t* reg,
+                           const void* data, size_t length) {
+    fake_backend_t* f = m_fake;
+    if (f->only != NULL && model != f->only)
+        return 0;
+    uint64_t top = 1ull << (model->width - 1);
+    uint64_t mask = (top << 1) - 1;
+    uint64_t crc = f->fault == 2 ? model->init : *reg;
+    const uint8_t* p = data;
+    for (size_t n = 0; n < length; n++) {
+        uint8_t byte = model->refin ? (uint8_t)reflect(p[n], 8) : p[n];
+        for (int i = 7; i >= 0; i--) {
+            uint64_t bit = ((byte >> i) & 1) ^ ((crc & top) ? 1 : 0);
+            crc = (crc << 1) & mask;
+            if (bit)
+                crc ^= model->poly;
+        }
+    }
+    if (f->fault == 1)
+        crc ^= 1;
+    *reg = (uint32_t)crc;
+    f->calls++;
+    f->bytes += length;
+    return 1;
+}
+
+static void fake_reset(fake_backend_t* f, const crc_model_t* only, int fault,
+                       size_t min_length) {
+    f->backend.update = fake_update;
+    f->backend.min_length = min_length;
+    f->only = only;
+    f->fault = fault;
+    f->calls = 0;
+    f->bytes = 0;
+    m_fake = f;
+}
+
+/* 后端的校验, 调用条件与回退到软件计算 */
+static void test_backend(void) {
+    static uint8_t buf[300];
+    for (size_t i = 0; i < sizeof(buf); i++)
+        buf[i] = (uint8_t)(i * 7 + 3);
+    fake_backend_t f;
+
+    // 支持全部模型的正确后端通过校验
+    fake_reset(&f, NULL, 0, 0);
+    CHECK(crc_backend_verify(&f.backend));
+    CHECK(f.calls == 3 * (int)(sizeof(m_models) / sizeof(m_models[0])));
+
+    // 结果错误或不能从寄存器值继续计算的后端不被启用
+    fake_reset(&f, &crc_model_crc16_modbus, 1, 0);
+    CHECK(!crc_backend_verify(&f.backend));
+    CHECK(!crc_set_backend(&f.backend));
+    fake_reset(&f, &crc_model_crc32, 2, 0);
+    CHECK(!crc_backend_verify(&f.backend));
+    CHECK(!crc_set_backend(&f.backend));
+    f.calls = 0;
+    CHECK(crc_calc(&crc_model_crc32, buf, sizeof(buf)) ==
+          ref_crc(&crc_model_crc32, buf, sizeof(buf)));
+    CHECK(f.calls == 0);
+
+    // 只支持crc32, 短于min_length的数据由软件计算
+    fake_reset(&f, &crc_model_crc32, 0, 64);
+    CHECK(crc_set_backend(&f.backend));
+    f.calls = 0;
+    f.bytes = 0;
+    CHECK(crc_calc(&crc_model_crc32, buf, sizeof(buf)) ==
+          ref_crc(&crc_model_crc32, buf, sizeof(buf)));
+    CHECK(f.calls == 1 && f.bytes == sizeof(buf));
+    CHECK(crc_calc(&crc_model_crc32, buf, 63) ==
+          ref_crc(&crc_model_crc32, buf, 63));
+    CHECK(f.calls == 1);
+    crc_ctx_t ctx;  // 长短分段混合, 寄存器在硬件与软件之间传递
+    crc_init(&ctx, &crc_model_crc32);
+    crc_update(&ctx, buf, 10);
+    crc_update(&ctx, buf + 10, 200);
+    crc_update(&ctx, buf + 210, sizeof(buf) - 210);
+    CHECK(crc_final(&ctx) == ref_crc(&crc_model_crc32, buf, sizeof(buf)));
+    CHECK(f.calls == 3 && f.bytes == 2 * sizeof(buf) - 10);  // 前10字节除外
+    // 不支持的模型由软件计算
+    for (size_t i = 0; i < sizeof(m_models) / sizeof(m_models[0]); i++) {
+        const crc_model_t* m = m_models[i].model;
+        CHECK(crc_calc(m, buf, sizeof(buf)) == ref_crc(m, buf, sizeof(buf)));
+    }
+    CHECK(f.calls == 4);
+
+    // 反转与非反转模型都由后端计算
+    fake_reset(&f, NULL, 0, 1);
+    CHECK(crc_set_backend(&f.backend));
+    f.calls = 0;
+    for (size_t i = 0; i < sizeof(m_models) / sizeof(m_models[0]); i++) {
+        const crc_model_t* m = m_models[i].model;
+        CHECK(crc_calc(m, buf, sizeof(buf)) == ref_crc(m, buf, sizeof(buf)));
+    }
+    CHECK(f.calls == (int)(sizeof(m_models) / sizeof(m_models[0])));
+
+    CHECK(crc_set_backend(NULL));
+    f.calls = 0;
+    CHECK(crc32(buf, sizeof(buf)) ==
+          ref_crc(&crc_model_crc32, buf, sizeof(buf)));
+    CHECK(f.calls == 0);
+}
+
+/**
+ * 协议栈的校验值与改用libcrc前的实现一致:
+ * TinyFrame逐字节累加寄存器(CRC8/CRC16/CRC32), lwpkt分段累加CRC-8/MAXIM,
+ * modbus RTU使用crc16_modbus. 期望值由原实现计算
+ */
+static uint32_t tf_cksum(const crc_model_t* m, const uint8_t* data,
+                         size_t len) {
+    uint32_t reg = crc_reg_init(m);
+    for (size_t i = 0; i < len; i++)
+        reg = crc_reg_update(m, reg, &data[i], 1);
+    return crc_reg_final(m, reg);
+}
+
+static void check_protocols(void) {
+    static const uint8_t tf_head[] = {0x01, 0x80, 0x00, 0x05, 0x22};
+    static const uint8_t tf_data[] = "Hello";
+    CHECK(tf_cksum(&crc_model_crc8_maxim, tf_head, 5) == 0x74);
+    CHECK(tf_cksum(&crc_model_crc8_maxim, tf_data, 5) == 0xEB);
+    CHECK(tf_cksum(&crc_model_crc16_ibm, tf_head, 5) == 0x4997);
+    CHECK(tf_cksum(&crc_model_crc16_ibm, tf_data, 5) == 0xF353);
+    CHECK(tf_cksum(&crc_model_crc32, tf_head, 5) == 0xBE0CDD37);
+    CHECK(tf_cksum(&crc_model_crc32, tf_data, 5) == 0xF7D18982);
+
+    static const uint8_t lw_head[] = {0x12, 0x34, 0x05};
+    uint32_t reg = 0;  // lwpkt的寄存器清零开始, 直接作为结果
+    reg = crc_reg_update(&crc_model_crc8_maxim, reg, lw_head, 3);
+    reg = crc_reg_update(&crc_model_crc8_maxim, reg, tf_data, 5);
+    CHECK(reg == 0x32);
+
+    static const uint8_t mb_read[] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x0A};
+    static const uint8_t mb_write[] = {0x11, 0x06, 0x00, 0x01, 0x00, 0x03};
+    CHECK(crc16_modbus(mb_read, 6) == 0xCDC5);
+    CHECK(crc16_modbus(mb_write, 6) == 0x9B9A);
+}
+
+static void test_protocols(void) {
+    check_protocols();
+    fake_backend_t f;  // 硬件后端不改变协议的校验值
+    fake_reset(&f, NULL, 0, 1);
+    CHECK(crc_set_backend(&f.backend));
+    check_protocols();
+    CHECK(f.calls > 0);
+    crc_set_backend(NULL);
+}
+
+int main(void) {
+#if CRC_CFG_USE_SLICE
+    test_lazy_table();
+#endif
+    test_const_table();
+    test_models();
+    test_custom_model();
+    test_backend();
+    test_protocols();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,17 @@
+// libcrc主机测试配置
+// 查表策略可在编译命令中用-DCRC_CFG_USE_NIBBLE=1等指定, 默认为字节表
+#define MOD_CFG_COMPILER_GCC 1
+#define MOD_CFG_USE_OS_NONE 1
+#define MOD_CFG_PLATFORM_HEADER <stddef.h>
+#define MOD_CFG_TIME_MATHOD_CUSTOM 1
+#define MOD_CFG_CUSTOM_TIME_TYPE_U64 1
+#define MOD_CFG_CUSTOM_TIME_BASE 1000000
+#define MOD_CFG_DELAY_MATHOD_CUSTOM 1
+#define MOD_CFG_HEAP_MATHOD_STDLIB 1
+#define MOD_ENABLE_LIBCRC 1
+#if !CRC_CFG_USE_NIBBLE && !CRC_CFG_USE_SLICE
+#define CRC_CFG_USE_TABLE 1
+#endif
+#if CRC_CFG_USE_SLICE && !defined(CRC_CFG_SLICE_N)
+#define CRC_CFG_SLICE_N 8
+#endif
@@ -37,6 +37,9 @@
 #include <string.h>
 
 #include "lwrb.h"
+#if LWPKT_CFG_USE_CRC
+#include "crcLib.h"
+#endif
 
 #define LWPKT_IS_VALID(p) ((p) != NULL)
 #define LWPKT_SET_STATE(p, s) \
@@ -54,15 +57,18 @@
 #define LWPKT_START_BYTE 0xAA
 #define LWPKT_STOP_BYTE 0x55
 
-#if LWPKT_CFG_USE_CRC
-#define WRITE_WITH_CRC(pkt, crc, tx_rb, b, len)                       \
-    do {                                                              \
-        lwrb_write((tx_rb), (b), (len));                              \
-        if (CHECK_FEATURE_CONFIG_MODE_ENABLED(pkt, LWPKT_CFG_USE_CRC, \
-                                              LWPKT_FLAG_USE_CRC)) {  \
-            prv_crc_in((crc), (b), (len));                            \
-        }                                                             \
+/* Max header length: start + 2 addresses + flags + cmd + length, var encoded */
+#define LWPKT_HDR_MAX_SIZE 32
+
+/* Header bytes are collected locally, packet goes out with one writev */
+#define WRITE_WITH_CRC(pkt, crc, hdr, hdr_len, b, len)   \
+    do {                                                 \
+        LWPKT_MEMCPY(&(hdr)[(hdr_len)], (b), (len));     \
+        ADD_IN_TO_CRC(pkt, crc, &(hdr)[(hdr_len)], len); \
+        (hdr_len) += (len);                              \
     } while (0)
+
+#if LWPKT_CFG_USE_CRC
 #define ADD_IN_TO_CRC(pkt, crc, val, len)                             \
     do {                                                              \
         if (CHECK_FEATURE_CONFIG_MODE_ENABLED(pkt, LWPKT_CFG_USE_CRC, \
@@ -72,10 +78,6 @@
     } while (0)
 #define INIT_CRC(pkt, crc) prv_crc_init((crc))
 #else /* LWPKT_CFG_USE_CRC */
-#define WRITE_WITH_CRC(pkt, crc, tx_rb, b, len) \
-    do {                                        \
-        lwrb_write((tx_rb), (b), (len));        \
-    } while (0)
 #define ADD_IN_TO_CRC(pkt, crc, val, len)
 #define INIT_CRC(pkt, crc)
 #endif /* !LWPKT_CFG_USE_CRC */
@@ -127,7 +129,7 @@
         do {                                                           \
             uint8_t byt =                                              \
                 (local_var & 0x7FU) | (local_var > 0x7FU ? 0x80U : 0); \
-            WRITE_WITH_CRC(pkt, &crc, (pkt)->tx_rb, &b, 1);            \
+            WRITE_WITH_CRC(pkt, &crc, hdr, hdr_len, &byt, 1);          \
             local_var >>= (uint8_t)7U;                                 \
         } while (local_var > 0);                                       \
     } while (0)
@@ -150,17 +152,9 @@ static uint8_t prv_crc_in(lwpkt_crc_t* crcobj, const void* inp,
         return 0;
     }
 
-    for (size_t i = 0; i < len; ++i, ++p_data) {
-        uint8_t inbyte = *p_data;
-        for (uint8_t j = 8U; j > 0; --j) {
-            uint8_t mix = (uint8_t)(crcobj->crc ^ inbyte) & 0x01U;
-            crcobj->crc >>= 1U;
-            if (mix > 0) {
-                crcobj->crc ^= 0x8CU;
-            }
-            inbyte >>= 0x01U;
-        }
-    }
+    /* CRC-8/MAXIM: init 0, no output xor, so the register is the CRC */
+    crcobj->crc = (uint8_t)crc_reg_update(&crc_model_crc8_maxim, crcobj->crc,
+                                          p_data, len);
     return crcobj->crc;
 }
 
@@ -537,6 +531,8 @@ lwpktr_t lwpkt_write(lwpkt_t* pkt,
 #endif /* LWPKT_CFG_ADDR_EXTENDED */
     size_t org_len = len;
     uint8_t b;
+    uint8_t hdr[LWPKT_HDR_MAX_SIZE], tail[2];
+    size_t hdr_len = 0, tail_len = 0;
 
     SEND_EVT(pkt, LWPKT_EVT_PRE_WRITE);
 
@@ -606,8 +602,7 @@ lwpktr_t lwpkt_write(lwpkt_t* pkt,
 #endif /* LWPKT_CFG_USE_CRC */
 
     /* Start byte */
-    b = LWPKT_START_BYTE;
-    lwrb_write(pkt->tx_rb, &b, 1U);
+    hdr[hdr_len++] = LWPKT_START_BYTE;
 
 #if LWPKT_CFG_USE_ADDR
     /* Add addresses */
@@ -627,7 +622,7 @@ lwpktr_t lwpkt_write(lwpkt_t* pkt,
             addr = pkt->addr;
             do {
                 b = (addr & 0x7FU) | (addr > 0x7FU ? 0x80U : 0);
-                WRITE_WITH_CRC(pkt, &crc, pkt->tx_rb, &b, 1);
+                WRITE_WITH_CRC(pkt, &crc, hdr, hdr_len, &b, 1);
                 addr >>= (uint8_t)7U;
             } while (addr > 0);
 
@@ -635,14 +630,14 @@ lwpktr_t lwpkt_write(lwpkt_t* pkt,
             addr = to;
             do {
                 b = (addr & 0x7FU) | (addr > 0x7FU ? 0x80U : 0);
-                WRITE_WITH_CRC(pkt, &crc, pkt->tx_rb, &b, 1);
+                WRITE_WITH_CRC(pkt, &crc, hdr, hdr_len, &b, 1);
                 addr >>= (uint8_t)7U;
             } while (addr > 0);
 #endif
         } else {
 #endif /* !LWPKT_CFG_ADDR_EXTENDED */
-            WRITE_WITH_CRC(pkt, &crc, pkt->tx_rb, &pkt->addr, 1);
-            WRITE_WITH_CRC(pkt, &crc, pkt->tx_rb, &to, 1);
+            WRITE_WITH_CRC(pkt, &crc, hdr, hdr_len, &pkt->addr, 1);
+            WRITE_WITH_CRC(pkt, &crc, hdr, hdr_len, &to, 1);
         }
     }
 #endif /* LWPKT_CFG_USE_ADDR */
@@ -653,7 +648,7 @@ lwpktr_t lwpkt_write(lwpkt_t* pkt,
                                           LWPKT_FLAG_USE_FLAGS)) {
         do {
             b = (flags & 0x7FU) | (flags > 0x7FU ? 0x80U : 0);
-            WRITE_WITH_CRC(pkt, &crc, pkt->tx_rb, &b, 1);
+            WRITE_WITH_CRC(pkt, &crc, hdr, hdr_len, &b, 1);
             flags >>= (uint8_t)7U;
         } while (flags > 0);
     }
@@ -663,33 +658,42 @@ lwpktr_t lwpkt_write(lwpkt_t* pkt,
     /* CMD byte */
     if (CHECK_FEATURE_CONFIG_MODE_ENABLED(pkt, LWPKT_CFG_USE_CMD,
                                           LWPKT_FLAG_USE_CMD)) {
-        WRITE_WITH_CRC(pkt, &crc, pkt->tx_rb, &cmd, 1);
+        WRITE_WITH_CRC(pkt, &crc, hdr, hdr_len, &cmd, 1);
     }
 #endif /* LWPKT_CFG_USE_CMD */
 
     /* Length bytes */
     do {
         b = (len & 0x7FU) | (len > 0x7FU ? 0x80U : 0);
-        WRITE_WITH_CRC(pkt, &crc, pkt->tx_rb, &b, 1);
+        WRITE_WITH_CRC(pkt, &crc, hdr, hdr_len, &b, 1);
         len >>= 7U;
     } while (len > 0);
 
     /* Data bytes, but only if length more than 0 */
     if (org_len > 0) {
-        WRITE_WITH_CRC(pkt, &crc, pkt->tx_rb, data, org_len);
+        ADD_IN_TO_CRC(pkt, &crc, data, org_len);
     }
 
 #if LWPKT_CFG_USE_CRC
     /* CRC byte */
     if (CHECK_FEATURE_CONFIG_MODE_ENABLED(pkt, LWPKT_CFG_USE_CRC,
                                           LWPKT_FLAG_USE_CRC)) {
-        lwrb_write(pkt->tx_rb, &crc.crc, 1);
+        tail[tail_len++] = crc.crc;
     }
 #endif /* LWPKT_CFG_USE_CRC */
 
     /* Stop byte */
-    b = LWPKT_STOP_BYTE;
-    lwrb_write(pkt->tx_rb, &b, 1U);
+    tail[tail_len++] = LWPKT_STOP_BYTE;
+
+    /* Whole packet with one write index update, never seen half-written */
+    {
+        const mod_iovec_t iov[] = {
+            {hdr, hdr_len},
+            {(void*)data, org_len},
+            {tail, tail_len},
+        };
+        lwrb_writev(pkt->tx_rb, iov, 3);
+    }
 
 fast_return:
     /* Final step to notify app */
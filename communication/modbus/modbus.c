@@ -2,6 +2,8 @@
 
 #include <string.h>
 
+#include "crcLib.h"
+
 #define LOG_MODULE "modbus"
 #include "log.h"
 
@@ -95,28 +97,10 @@ void ModBus_setTimeout(ModBus_parameter* ModBus_para, u32 receiveTimeout,
 // and place it to end.
 // return total length
 static size_t GenCRC16(uint8_t* buff, size_t len) {
-    uint16_t crc = 0xFFFF;
-    uint16_t pos = 0;
-    uint8_t i = 0;
-    uint8_t lo = 0;
-    uint8_t hi = 0;
-
-    for (pos = 0; pos < len; pos++) {
-        crc ^= buff[pos];
-
-        for (i = 8; i != 0; i--) {
-            if ((crc & 0x0001) != 0) {
-                crc >>= 1;
-                crc ^= 0xA001;
-            } else
-                crc >>= 1;
-        }
-    }
-    lo = crc & 0xFF;
-    hi = (crc >> 8) & 0xFF;
+    uint16_t crc = crc16_modbus(buff, len);
 
-    buff[len++] = lo;
-    buff[len++] = hi;
+    buff[len++] = crc & 0xFF;
+    buff[len++] = (crc >> 8) & 0xFF;
     return len;
 }
 
@@ -124,26 +108,10 @@ static size_t GenCRC16(uint8_t* buff, size_t len) {
 // Calculate CRC fro incoming buffer
 // Return 1 - if CRC is correct, overwise return 0
 static uint8_t CheckCRC16(uint8_t* buff, size_t len) {
-    uint16_t crc = 0xFFFF;
-    uint16_t pos = 0;
-    uint8_t i = 0;
-    uint8_t lo = 0;
-    uint8_t hi = 0;
-
-    for (pos = 0; pos < len - 2; pos++) {
-        crc ^= buff[pos];
-
-        for (i = 8; i != 0; i--) {
-            if ((crc & 0x0001) != 0) {
-                crc >>= 1;
-                crc ^= 0xA001;
-            } else
-                crc >>= 1;
-        }
-    }
-    lo = crc & 0xFF;
-    hi = (crc >> 8) & 0xFF;
-    if ((buff[len - 2] == lo) && (buff[len - 1] == hi)) {
+    uint16_t crc = crc16_modbus(buff, len - 2);
+
+    if ((buff[len - 2] == (crc & 0xFF)) &&
+        (buff[len - 1] == ((crc >> 8) & 0xFF))) {
         return 1;
     }
 #ifdef _UNIT_TEST
@@ -29,6 +29,22 @@ struct json_valid {
     size_t pos;
 };
 
+struct json_query_node {
+    const char* key;
+    size_t klen;
+    size_t index;
+    int child;
+    int next;
+    int result;
+    bool isindex;
+};
+
+struct json_query {
+    struct json_query_node* nodes;
+    int count;
+    size_t npaths;
+};
+
 #define JSON_EXTERN static
 #endif
 
@@ -195,13 +211,163 @@ static const uint8_t strtoksu[256] = {
 #endif
 };
 
+static const uint8_t strtoksa[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+};
+
+// Vectorized scanning of string bodies. The fast paths only skip over
+// uninteresting bytes and stop at the first candidate, the token handling
+// that follows is unchanged. Define JSON_NOSIMD to disable.
+#if defined(__GNUC__) || defined(__clang__)
+#define JSON_SCANINLINE static inline __attribute__((always_inline))
+#else
+#define JSON_SCANINLINE static inline
+#endif
+#ifndef JSON_NOSIMD
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JSON_AVX2
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define JSON_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define JSON_NEON
+#elif defined(__arm__) && defined(__ARM_FEATURE_UNALIGNED)
+#ifndef JSON_SWAR
+#define JSON_SWAR  // Cortex-M3 and up, word-at-a-time
+#endif
+#endif
+#endif
+// Define JSON_SWAR to use word-at-a-time scanning on other targets too.
+#if defined(JSON_NOSIMD) || defined(JSON_SSE2) || defined(JSON_NEON)
+#undef JSON_SWAR
+#endif
+
+enum jscan_class {
+    JSCAN_STR,  // '"', '\\', control and (when validating utf8) non-ascii
+    JSCAN_ESC,  // '"', '\\'
+};
+
+#ifdef JSON_AVX2
+#define jset32(c) _mm256_set1_epi8(c)
+JSON_SCANINLINE __m256i jscan_mask32(__m256i v, const int cls) {
+    __m256i m = _mm256_cmpeq_epi8(v, jset32('"'));
+    if (cls == JSCAN_STR) {
+#ifndef JSON_NOVALIDATEUTF8
+        // signed compare: < 0x20 or >= 0x80
+        m = _mm256_or_si256(m, _mm256_cmpgt_epi8(jset32(0x20), v));
+#else
+        m = _mm256_or_si256(
+            m, _mm256_cmpeq_epi8(_mm256_min_epu8(v, jset32(0x1F)), v));
+#endif
+    }
+    return _mm256_or_si256(m, _mm256_cmpeq_epi8(v, jset32('\\')));
+}
+#endif
+
+#ifdef JSON_SSE2
+#define jset16(c) _mm_set1_epi8(c)
+JSON_SCANINLINE __m128i jscan_mask16(__m128i v, const int cls) {
+    __m128i m = _mm_cmpeq_epi8(v, jset16('"'));
+    if (cls == JSCAN_STR) {
+#ifndef JSON_NOVALIDATEUTF8
+        m = _mm_or_si128(m, _mm_cmplt_epi8(v, jset16(0x20)));
+#else
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(v, jset16(0x1F)), v));
+#endif
+    }
+    return _mm_or_si128(m, _mm_cmpeq_epi8(v, jset16('\\')));
+}
+#endif
+
+#ifdef JSON_NEON
+JSON_SCANINLINE uint8x16_t jscan_mask16(uint8x16_t v, const int cls) {
+    uint8x16_t m = vceqq_u8(v, vdupq_n_u8('"'));
+    if (cls == JSCAN_STR) {
+#ifndef JSON_NOVALIDATEUTF8
+        m = vorrq_u8(m, vcltq_s8(vreinterpretq_s8_u8(v), vdupq_n_s8(0x20)));
+#else
+        m = vorrq_u8(m, vcltq_u8(v, vdupq_n_u8(0x20)));
+#endif
+    }
+    return vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('\\')));
+}
+#endif
+
+#ifdef JSON_SWAR
+typedef uintptr_t jword_t;
+#define JW_ONES ((jword_t)-1 / 0xFF)
+#define JW_HIGH (JW_ONES * 0x80)
+#define jw_haszero(w) (((w) - JW_ONES) & ~(w) & JW_HIGH)
+#define jw_hasbyte(w, c) jw_haszero((w) ^ (JW_ONES * (c)))
+
+// Nonzero when the word holds at least one byte of the class.
+JSON_SCANINLINE jword_t jscan_word(jword_t w, const int cls) {
+    jword_t m = jw_hasbyte(w, '"') | jw_hasbyte(w, '\\');
+    if (cls == JSCAN_STR) {
+#ifndef JSON_NOVALIDATEUTF8
+        m |= ((w - JW_ONES * 0x20) | w) & JW_HIGH;
+#else
+        m |= (w - JW_ONES * 0x20) & ~w & JW_HIGH;
+#endif
+    }
+    return m;
+}
+#endif
+
+// jscan returns the index of the first byte at or after i that belongs to
+// the class, or len if there is none.
+JSON_SCANINLINE int64_t jscan(const uint8_t* s, int64_t len, int64_t i,
+                              const int cls) {
+#ifdef JSON_AVX2
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(s + i));
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(jscan_mask32(v, cls));
+        if (m)
+            return i + __builtin_ctz(m);
+    }
+#endif
+#if defined(JSON_SSE2)
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        uint32_t m = (uint32_t)_mm_movemask_epi8(jscan_mask16(v, cls));
+        if (m)
+            return i + __builtin_ctz(m);
+    }
+#elif defined(JSON_NEON)
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t m = jscan_mask16(vld1q_u8(s + i), cls);
+        // narrow to 4 bits per byte
+        uint64_t bits = vget_lane_u64(
+            vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+        if (bits)
+            return i + (__builtin_ctzll(bits) >> 2);
+    }
+#elif defined(JSON_SWAR)
+    for (; i + (int64_t)sizeof(jword_t) <= len; i += sizeof(jword_t)) {
+        jword_t w;
+        memcpy(&w, s + i, sizeof(w));
+        if (jscan_word(w, cls))
+            break;  // located below
+    }
+#endif
+    const uint8_t* toks = cls == JSCAN_STR ? strtoksu : strtoksa;
+    for8(i, len, {
+        if (toks[s[i]])
+            return i;
+    });
+    return len;
+}
+
 static int64_t vstring(const uint8_t* json, int64_t jlen, int64_t i) {
     while (1) {
-        for8(i, jlen, {
-            if (strtoksu[json[i]])
-                goto tok;
-        }) break;
-    tok:
+        if ((i = jscan(json, jlen, i, JSCAN_STR)) == jlen)
+            break;
         if (json[i] == '"') {
             return i + 1;
 #ifndef JSON_NOVALIDATEUTF8
@@ -213,7 +379,7 @@ static int64_t vstring(const uint8_t* json, int64_t jlen, int64_t i) {
 #endif
         } else if (json[i] == '\\') {
             if ((i = vesc(json, jlen, i)) < 0)
-                break;
+                return i;  // already negated
         } else {
             break;
         }
@@ -371,11 +537,8 @@ static int64_t varray(const uint8_t* data, int64_t dlen, int64_t i, int depth) {
 }
 
 static int64_t vkey(const uint8_t* json, int64_t len, int64_t i) {
-    for16(i, len, {
-        if (strtoksu[json[i]])
-            goto tok;
-    }) return -(i + 1);
-tok:
+    if ((i = jscan(json, len, i, JSCAN_STR)) == len)
+        return -(i + 1);
     if (json[i] == '"')
         return i + 1;
     return vstring(json, len, i);
@@ -530,26 +693,17 @@ enum iflags { IESC = 1, IDOT = 2, ISCI = 4, ISIGN = 8 };
 #define jend(json) ((uint8_t*)(uintptr_t)((json).priv[2]))
 #define jlen(json) ((size_t)(uintptr_t)((json).priv[3]))
 
-static const uint8_t strtoksa[256] = {
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
-};
-
 static inline size_t count_string(uint8_t* raw, uint8_t* end, int* infoout) {
     size_t len = end - raw;
     size_t i = 1;
     int info = 0;
     bool e = false;
     while (1) {
-        for8(i, len, {
-            if (strtoksa[raw[i]])
-                goto tok;
+        size_t j = jscan(raw, len, i, JSCAN_ESC);
+        if (j != i)
             e = false;
-        });
-        break;
-    tok:
+        if ((i = j) == len)
+            break;
         if (raw[i] == '"') {
             i++;
             if (!e) {
@@ -626,11 +780,20 @@ static size_t count_nested(uint8_t* raw, uint8_t* end) {
             depth += kind - 3;
         } else {
             while (1) {
-                for16(i, len, {
-                    if (raw[i] == '"')
-                        goto tok1;
-                });
-                break;
+                // most strings are short, check the first bytes one by one
+                // before going wide
+                if (i + 16 <= len) {
+                    ludo16(i, {
+                        if (raw[i] == '"')
+                            goto tok1;
+                    });
+                }
+                if ((i = jscan(raw, len, i, JSCAN_ESC)) == len)
+                    break;
+                if (raw[i] == '\\') {
+                    i++;
+                    continue;
+                }
             tok1:
                 i++;
                 if (raw[i - 2] == '\\') {
@@ -925,9 +1088,10 @@ int json_string_comparen(struct json json, const char* str, size_t slen) {
         return strcmpn((char*)raw, rlen, str, slen);
     }
     int cmp = 0;
-    uint8_t* sp = (uint8_t*)(str ? str : "");
+    uint8_t* sp = (uint8_t*)str;
+    uint8_t* send = sp + (str ? slen : 0);
     for_each_utf8(raw, rlen, {
-        if (!*sp || ch > *sp) {
+        if (sp == send || ch > *sp) {
             cmp = 1;
             goto done;
         } else if (ch < *sp) {
@@ -937,7 +1101,7 @@ int json_string_comparen(struct json json, const char* str, size_t slen) {
         sp++;
     });
 done:
-    if (cmp == 0 && *sp)
+    if (cmp == 0 && sp < send)
         cmp = -1;
     return cmp;
 }
@@ -1305,3 +1469,158 @@ JSON_EXTERN struct json json_get(const char* json_str, const char* path) {
 JSON_EXTERN bool json_string_is_escaped(struct json json) {
     return (jinfo(json) & IESC) == IESC;
 }
+
+// One path component, as split by json_getn.
+static const char* qcomponent(const char* p, size_t* klen, bool* last) {
+    const char* key = p;
+    while (*p && *p != '.')
+        p++;
+    *klen = p - key;
+    *last = !*p;
+    return *last ? p : p + 1;
+}
+
+JSON_EXTERN size_t json_query_nodes(const char* const* paths, size_t npaths) {
+    size_t n = 1;
+    for (size_t i = 0; i < npaths; i++) {
+        const char* p = paths[i];
+        bool last = !p;
+        size_t klen;
+        while (!last) {
+            p = qcomponent(p, &klen, &last);
+            n++;
+        }
+    }
+    return n;
+}
+
+JSON_EXTERN bool json_query_compile(struct json_query* query,
+                                    struct json_query_node* nodes,
+                                    size_t nnodes, const char* const* paths,
+                                    size_t npaths) {
+    if (nnodes == 0)
+        return false;
+    nodes[0] = (struct json_query_node){.child = -1, .next = -1, .result = -1};
+    int count = 1;
+    for (size_t i = 0; i < npaths; i++) {
+        const char* p = paths[i];
+        if (!p)
+            return false;
+        int node = 0;
+        bool last = false;
+        while (!last) {
+            const char* key = p;
+            size_t klen;
+            p = qcomponent(p, &klen, &last);
+            // reuse a sibling with the same key, unless it already holds the
+            // result of an identical path
+            int* link = &nodes[node].child;
+            int fanout = 0;
+            while (*link >= 0) {
+                struct json_query_node* n = &nodes[*link];
+                if (n->klen == klen && memcmp(n->key, key, klen) == 0 &&
+                    (!last || n->result < 0))
+                    break;
+                link = &n->next;
+                fanout++;
+            }
+            if (*link < 0) {
+                if ((size_t)count == nnodes || fanout == 64)
+                    return false;
+                char* end;
+                size_t index = strtol(key, &end, 10);
+                nodes[count] = (struct json_query_node){
+                    .key = key,
+                    .klen = klen,
+                    .index = index,
+                    .child = -1,
+                    .next = -1,
+                    .result = -1,
+                    .isindex = klen > 0 && !(*end && *end != '.'),
+                };
+                *link = count++;
+            }
+            node = *link;
+        }
+        nodes[node].result = (int)i;
+    }
+    query->nodes = nodes;
+    query->count = count;
+    query->npaths = npaths;
+    return true;
+}
+
+struct qstate {
+    const struct json_query_node* nodes;
+    struct json* results;
+    size_t left;
+};
+
+static bool qkeyeq(struct json key, const struct json_query_node* n) {
+    if (json_type(key) == JSON_STRING && !(jinfo(key) & IESC)) {
+        // plain string, the quotes are the only difference
+        return jlen(key) == n->klen + 2 &&
+               memcmp(jraw(key) + 1, n->key, n->klen) == 0;
+    }
+    return json_string_comparen(key, n->key, n->klen) == 0;
+}
+
+// qwalk matches the members of the object or array at raw against the
+// children of node, descending only where a path continues. Returns the
+// position just past the value, or NULL once every path has been found.
+static uint8_t* qwalk(struct qstate* st, int node, uint8_t* raw,
+                      uint8_t* end) {
+    const struct json_query_node* nodes = st->nodes;
+    bool obj = *raw == '{';
+    uint64_t seen = 0;  // json_getn only follows the first matching key
+    size_t index = 0;
+    raw++;
+    while (1) {
+        struct json key = {0};
+        struct json val = peek_any(raw, end);
+        if (obj && json_exists(val)) {
+            key = val;
+            val = json_next(key);
+        }
+        if (!json_exists(val))
+            break;
+        uint8_t* next = NULL;
+        uint64_t bit = 1;
+        for (int c = nodes[node].child; c >= 0; c = nodes[c].next, bit <<= 1) {
+            const struct json_query_node* n = &nodes[c];
+            if ((seen & bit) ||
+                (obj ? !qkeyeq(key, n) : !n->isindex || n->index != index))
+                continue;
+            seen |= bit;
+            if (n->result >= 0) {
+                st->results[n->result] = val;
+                if (--st->left == 0)
+                    return NULL;
+            }
+            if (n->child >= 0 && (*jraw(val) == '{' || *jraw(val) == '[')) {
+                // aliased indexes like "1" and "01" walk the value again
+                uint8_t* after = qwalk(st, c, jraw(val), end);
+                if (!after)
+                    return NULL;
+                next = after;
+            }
+        }
+        raw = next ? next : jraw(val) + json_raw_length(val);
+        index++;
+    }
+    while (raw < end && *raw != '}' && *raw != ']')
+        raw++;
+    return raw < end ? raw + 1 : end;
+}
+
+JSON_EXTERN size_t json_query_exec(const struct json_query* query,
+                                   const char* json_str, size_t len,
+                                   struct json* results) {
+    struct qstate st = {query->nodes, results, query->npaths};
+    memset(results, 0, query->npaths * sizeof(struct json));
+    struct json json = json_parsen(json_str, len);
+    if (st.left && json_exists(json) &&
+        (*jraw(json) == '{' || *jraw(json) == '['))
+        qwalk(&st, 0, jraw(json), jend(json));
+    return query->npaths - st.left;
+}
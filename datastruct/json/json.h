@@ -176,6 +176,59 @@ struct json json_object_getn(struct json json, const char* key, size_t len);
 struct json json_get(const char* json_str, const char* path);
 struct json json_getn(const char* json_str, size_t len, const char* path);
 
+// json_query is a set of paths compiled once with json_query_compile and then
+// extracted from a document in a single pass with json_query_exec.
+//
+// The query and its nodes live in memory provided by the caller. The nodes
+// reference the path strings, so the paths must outlive the query.
+//
+//    static const char *paths[] = { "id", "user.name", "tags.0" };
+//    struct json_query_node nodes[8];
+//    struct json_query query;
+//    json_query_compile(&query, nodes, 8, paths, 3);
+//    ...
+//    struct json res[3];
+//    json_query_exec(&query, json_str, len, res);
+//
+// The fields of both structures are private.
+struct json_query_node {
+    const char* key;
+    size_t klen;
+    size_t index;
+    int child;
+    int next;
+    int result;
+    bool isindex;
+};
+
+struct json_query {
+    struct json_query_node* nodes;
+    int count;
+    size_t npaths;
+};
+
+// json_query_nodes returns the number of nodes needed to compile the paths.
+size_t json_query_nodes(const char* const* paths, size_t npaths);
+
+// json_query_compile compiles the paths into nodes.
+//
+// Paths use the same syntax as json_get. Paths that share a prefix share
+// nodes, and the document is only descended into where a path leads.
+// Returns false if nnodes is too small, a path is NULL, or more than 64
+// different keys follow the same prefix.
+bool json_query_compile(struct json_query* query, struct json_query_node* nodes,
+                        size_t nnodes, const char* const* paths,
+                        size_t npaths);
+
+// json_query_exec finds all paths of the query in one pass over the json.
+//
+// results[i] receives the value at paths[i], or a non-existent json value
+// if there is none. For valid json this is the same value that json_getn
+// would return. Scanning stops as soon as every path has been found.
+// Returns the number of paths found.
+size_t json_query_exec(const struct json_query* query, const char* json_str,
+                       size_t len, struct json* results);
+
 // json_double returns a json's double value.
 double json_double(struct json json);
 
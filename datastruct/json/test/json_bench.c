@@ -0,0 +1,151 @@
+// json吞吐量基准测试, 比较向量化扫描与标量参考实现(json_ref.c)
+// 在工程根目录构建并运行(-mavx2/-DJSON_SWAR等选择扫描方式):
+//   gcc -O2 -Idatastruct/json datastruct/json/json.c
+//       datastruct/json/test/json_ref.c datastruct/json/test/json_bench.c
+//       -o json_bench
+//   ./json_bench [JSON文件...]
+// 不指定文件时使用生成的遥测数据(紧凑/缩进), 配置文件和长字符串数据.
+// validn为完整校验, skip为json_parsen后取原始长度(跳过整个文档)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "json.h"
+
+#define BENCH_BYTES (30u << 20)  // 每项测试处理的总字节数
+#define BENCH_ROUNDS 5           // 取最好的一轮
+#define GEN_MAX (512u << 10)
+
+bool ref_json_validn(const char* json_str, size_t len);
+struct json ref_json_parsen(const char* json_str, size_t len);
+size_t ref_json_raw_length(struct json json);
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static const char* const m_words[] = {"温度", "湿度", "电压", "a",  "b",
+                                      "c",    "d",    "e",    "f", " "};
+
+static size_t gen_text(char* p, int len) {
+    size_t n = 0;
+    for (int i = 0; i < len; i++) {
+        const char* w = m_words[rand() % 10];
+        memcpy(p + n, w, strlen(w));
+        n += strlen(w);
+    }
+    return n;
+}
+
+// 遥测数据: 传感器记录数组, 每条带一段中英文混合的备注
+static size_t gen_telemetry(char* buf, bool pretty) {
+    static const char* const city[] = {"成都", "上海", "Berlin", "Austin"};
+    const char* sep = pretty ? "\n    " : "";
+    const char* sp = pretty ? " " : "";
+    size_t n = 0;
+    n += sprintf(buf + n, "[");
+    for (int i = 0; i < 400; i++) {
+        n += sprintf(buf + n,
+                     "%s%s{%s\"id\":%s%d,%s\"device\":%s\"sensor-%04d\",%s"
+                     "\"location\":%s\"%s\",%s\"ts\":%s%d,%s\"readings\":%s"
+                     "{\"temp\":%s%d.%02d,%s\"hum\":%s%d.%d},%s"
+                     "\"tags\":%s[\"zone-%d\",%s\"rack\\t%d\"],%s\"note\":%s\"",
+                     i ? "," : "", pretty ? "\n  " : "", sep, sp, i, sep, sp, i,
+                     sep, sp, city[i % 4], sep, sp, 1700000000 + i * 17, sep,
+                     sp, sp, rand() % 50, rand() % 100, sp, sp, rand() % 100,
+                     rand() % 10, sep, sp, rand() % 10, sp, i % 32, sep, sp);
+        n += gen_text(buf + n, 40 + rand() % 60);
+        n += sprintf(buf + n, "\"%s}", pretty ? "\n  " : "");
+    }
+    n += sprintf(buf + n, "%s]", pretty ? "\n" : "");
+    return n;
+}
+
+// 配置文件: 短键值为主, 字符串短而结构字符密集
+static size_t gen_config(char* buf) {
+    size_t n = 0;
+    n += sprintf(buf + n, "{\"version\":\"2.4.1\",\"channels\":[");
+    for (int i = 0; i < 300; i++)
+        n += sprintf(buf + n, "%s{\"id\":%d,\"name\":\"ch%d\",\"gain\":%d.%d,"
+                     "\"enable\":%s,\"topic\":\"dev/%d/up\"}",
+                     i ? "," : "", i, i, rand() % 8, rand() % 10,
+                     i % 3 ? "true" : "false", i);
+    n += sprintf(buf + n, "]}");
+    return n;
+}
+
+// 长字符串: 少量结构, 每个字符串数百字节
+static size_t gen_long_strings(char* buf) {
+    size_t n = 0;
+    n += sprintf(buf + n, "[");
+    for (int i = 0; i < 400; i++) {
+        n += sprintf(buf + n, "%s{\"id\": %d, \"text\": \"", i ? ", " : "", i);
+        n += gen_text(buf + n, 200 + rand() % 200);
+        n += sprintf(buf + n, "\"}");
+    }
+    n += sprintf(buf + n, "]");
+    return n;
+}
+
+static double mbps(size_t len, int reps, uint64_t ns) {
+    return (double)len * reps * 1000.0 / ns;
+}
+
+static void bench(const char* name, const char* data, size_t len) {
+    int reps = (int)(BENCH_BYTES / len) + 1;
+    double v_ref = 0, v_new = 0, s_ref = 0, s_new = 0;
+    volatile size_t acc = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        uint64_t start = host_ns();
+        for (int i = 0; i < reps; i++) acc += ref_json_validn(data, len);
+        double v = mbps(len, reps, host_ns() - start);
+        if (v > v_ref) v_ref = v;
+        start = host_ns();
+        for (int i = 0; i < reps; i++) acc += json_validn(data, len);
+        v = mbps(len, reps, host_ns() - start);
+        if (v > v_new) v_new = v;
+        start = host_ns();
+        for (int i = 0; i < reps; i++)
+            acc += ref_json_raw_length(ref_json_parsen(data, len));
+        v = mbps(len, reps, host_ns() - start);
+        if (v > s_ref) s_ref = v;
+        start = host_ns();
+        for (int i = 0; i < reps; i++)
+            acc += json_raw_length(json_parsen(data, len));
+        v = mbps(len, reps, host_ns() - start);
+        if (v > s_new) s_new = v;
+    }
+    printf("%-16s %7zu B  validn %6.0f -> %6.0f MB/s  "
+           "skip %6.0f -> %6.0f MB/s\n",
+           name, len, v_ref, v_new, s_ref, s_new);
+}
+
+int main(int argc, char* argv[]) {
+    char* buf = malloc(GEN_MAX);
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            FILE* f = fopen(argv[i], "rb");
+            if (f == NULL) {
+                printf("cannot read %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            size_t len = fread(buf, 1, GEN_MAX, f);
+            fclose(f);
+            if (len == 0) continue;
+            const char* name = strrchr(argv[i], '/');
+            bench(name ? name + 1 : argv[i], buf, len);
+        }
+        free(buf);
+        return 0;
+    }
+    srand(1);
+    bench("telemetry min", buf, gen_telemetry(buf, false));
+    bench("telemetry pretty", buf, gen_telemetry(buf, true));
+    bench("config min", buf, gen_config(buf));
+    bench("long strings", buf, gen_long_strings(buf));
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,49 @@
+// 标量参考实现: 以JSON_NOSIMD编译json.c(内部链接), 导出ref_前缀的接口,
+// 供json_test/json_bench与向量化扫描的结果和速度比较
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef JSON_NOSIMD
+#define JSON_NOSIMD
+#endif
+#define JSON_STATIC
+#pragma GCC diagnostic ignored "-Wunused-function"  // 未导出的接口
+#include "json.c"
+
+struct json_valid ref_json_validn_ex(const char* json_str, size_t len,
+                                     int opts) {
+    return json_validn_ex(json_str, len, opts);
+}
+
+bool ref_json_validn(const char* json_str, size_t len) {
+    return json_validn(json_str, len);
+}
+
+struct json ref_json_parsen(const char* json_str, size_t len) {
+    return json_parsen(json_str, len);
+}
+
+struct json ref_json_getn(const char* json_str, size_t len, const char* path) {
+    return json_getn(json_str, len, path);
+}
+
+struct json ref_json_first(struct json json) {
+    return json_first(json);
+}
+
+struct json ref_json_next(struct json json) {
+    return json_next(json);
+}
+
+size_t ref_json_raw_length(struct json json) {
+    return json_raw_length(json);
+}
+
+size_t ref_json_string_length(struct json json) {
+    return json_string_length(json);
+}
+
+size_t ref_json_string_copy(struct json json, char* str, size_t nbytes) {
+    return json_string_copy(json, str, nbytes);
+}
@@ -0,0 +1,289 @@
+// json差分测试: 向量化扫描与标量参考实现(json_ref.c)的结果逐项比较
+// 在工程根目录构建并运行(-DJSON_NOSIMD/-DJSON_SWAR/-mavx2等选择扫描方式):
+//   gcc -O1 -g -fsanitize=address,undefined -Idatastruct/json -Idebug/minctest
+//       datastruct/json/json.c datastruct/json/test/json_ref.c
+//       datastruct/json/test/json_test.c -o json_test
+//   ./json_test [变异次数] [额外的JSON文件...]
+// 全部通过时返回0. 文档由随机生成(含转义/中文/控制字符, 字符串长度跨越
+// 16/32字节边界), 再随机修改/截断/偏移, 比较validn_ex的结果与位置,
+// 每个可访问路径的getn结果, 原始长度和字符串复制结果.
+// 合法文档还把这些路径(及不存在的键/下标, 畸形路径)编译为一个查询,
+// 比较json_query_exec与逐个json_getn的结果
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_check.h"
+#include "json.h"
+
+#define TEST_DOCS 300
+#define TEST_MUTATIONS 20000
+#define DOC_MAX 8192
+#define PATH_MAX_LEN 256
+#define QUERY_MAX_PATHS 64
+
+struct json_valid ref_json_validn_ex(const char* json_str, size_t len,
+                                     int opts);
+struct json ref_json_parsen(const char* json_str, size_t len);
+struct json ref_json_getn(const char* json_str, size_t len, const char* path);
+struct json ref_json_first(struct json json);
+struct json ref_json_next(struct json json);
+size_t ref_json_raw_length(struct json json);
+size_t ref_json_string_length(struct json json);
+size_t ref_json_string_copy(struct json json, char* str, size_t nbytes);
+
+static char m_paths[QUERY_MAX_PATHS][PATH_MAX_LEN];  // walk经过的路径
+static int m_npaths;
+
+typedef struct {  // 生成中的文档
+    char* buf;
+    size_t len;
+} doc_t;
+
+static void put(doc_t* d, const char* s, size_t n) {
+    if (d->len + n < DOC_MAX) {
+        memcpy(d->buf + d->len, s, n);
+        d->len += n;
+    }
+}
+
+static void puts_(doc_t* d, const char* s) {
+    put(d, s, strlen(s));
+}
+
+// 字符串内容: 普通字符为主, 混入转义, 中文, 以及少量非法的控制字符/UTF-8
+static void gen_string(doc_t* d) {
+    static const char* const pieces[] = {
+        "a", "b", "x", " ", "-", "0", "\\n", "\\\"", "\\\\", "\\u00e9",
+        "\\/", "温", "度", "传感器", "\t", "\x01", "\xff", "\xc3",
+    };
+    int len = rand() % 4 ? rand() % 24 : rand() % 80;
+    int bad = rand() % 8 == 0;  // 约1/8的字符串可能含非法字节
+    put(d, "\"", 1);
+    for (int i = 0; i < len; i++) {
+        int n = sizeof(pieces) / sizeof(pieces[0]) - (bad ? 0 : 4);
+        int k = rand() % 10 < 7 ? rand() % 4 : rand() % n;
+        puts_(d, pieces[k]);
+    }
+    put(d, "\"", 1);
+}
+
+static void gen_value(doc_t* d, int depth) {
+    int kind = depth > 4 ? rand() % 4 : rand() % 6;
+    char num[32];
+    switch (kind) {
+        case 0:
+            gen_string(d);
+            break;
+        case 1:
+            snprintf(num, sizeof(num), "%d.%02d", rand() % 2000 - 1000,
+                     rand() % 100);
+            puts_(d, num);
+            break;
+        case 2:
+            puts_(d, rand() % 2 ? "true" : "null");
+            break;
+        case 3:
+            snprintf(num, sizeof(num), "%d", rand());
+            puts_(d, num);
+            break;
+        case 4: {
+            int n = rand() % 6;
+            put(d, "[", 1);
+            for (int i = 0; i < n; i++) {
+                if (i) puts_(d, rand() % 4 ? "," : ", ");
+                gen_value(d, depth + 1);
+            }
+            put(d, "]", 1);
+            break;
+        }
+        default: {
+            int n = rand() % 6;
+            put(d, "{", 1);
+            for (int i = 0; i < n; i++) {
+                if (i) puts_(d, rand() % 4 ? "," : ",\n  ");
+                gen_string(d);
+                puts_(d, rand() % 4 ? ":" : ": ");
+                gen_value(d, depth + 1);
+            }
+            put(d, "}", 1);
+            break;
+        }
+    }
+}
+
+/* 逐层比较子节点, 并以拼出的路径比较getn */
+static void walk(const char* buf, size_t n, struct json a, struct json b,
+                 int depth, char* path, size_t plen) {
+    CHECK(json_raw(a) == json_raw(b) &&
+          json_raw_length(a) == ref_json_raw_length(b));
+    if (json_type(a) == JSON_STRING) {
+        char x[128], y[128];
+        CHECK(json_string_length(a) == ref_json_string_length(b));
+        json_string_copy(a, x, sizeof(x));
+        ref_json_string_copy(b, y, sizeof(y));
+        CHECK(strcmp(x, y) == 0);
+    }
+    if (depth > 5) return;
+    bool object = json_type(a) == JSON_OBJECT;
+    struct json ca = json_first(a), cb = ref_json_first(b);
+    for (int k = 0; json_exists(ca) || json_exists(cb); k++) {
+        CHECK(json_raw(ca) == json_raw(cb));
+        if (json_raw(ca) != json_raw(cb)) return;
+        size_t next = plen;
+        if (object) {  // 只把不含路径语法字符的键拼入路径
+            char key[64];
+            size_t klen = json_string_copy(ca, key, sizeof(key));
+            ca = json_next(ca);
+            cb = ref_json_next(cb);
+            if (klen < 40 && !strpbrk(key, ".*?\\|#@!=<>%") &&
+                plen + klen + 2 < PATH_MAX_LEN) {
+                if (plen) path[next++] = '.';
+                memcpy(path + next, key, klen);
+                next += klen;
+            } else {
+                next = 0;
+            }
+        } else if (plen + 12 < PATH_MAX_LEN) {
+            next += sprintf(path + next, "%s%d", plen ? "." : "", k);
+        } else {
+            next = 0;
+        }
+        if (next) {
+            path[next] = '\0';
+            if (m_npaths < QUERY_MAX_PATHS) strcpy(m_paths[m_npaths++], path);
+            struct json ga = json_getn(buf, n, path);
+            struct json gb = ref_json_getn(buf, n, path);
+            CHECK(json_raw(ga) == json_raw(gb) &&
+                  json_raw_length(ga) == ref_json_raw_length(gb));
+            walk(buf, n, ca, cb, depth + 1, path, next);
+        }
+        path[plen] = '\0';
+        ca = json_next(ca);
+        cb = ref_json_next(cb);
+    }
+}
+
+/* 一次查询全部路径, 与逐个getn的结果比较 */
+static void check_query(const char* buf, size_t n) {
+    static const char* const extra[] = {
+        "",   ".",   "..", "0.", ".0",  "a..b", "0..0",      "missing",
+        "99", "-1",  "1x", " 1", "01",  "0.99", "0.missing", "0.0.0.0",
+    };
+    enum { NEXTRA = sizeof(extra) / sizeof(extra[0]) };
+    const char* paths[QUERY_MAX_PATHS * 3 + NEXTRA];
+    char miss[QUERY_MAX_PATHS][2][PATH_MAX_LEN + 16];
+    size_t np = 0;
+    for (int i = 0; i < m_npaths; i++) {  // 存在的路径, 及其下不存在的键/下标
+        paths[np++] = m_paths[i];
+        snprintf(miss[i][0], sizeof(miss[i][0]), "%s.missing", m_paths[i]);
+        snprintf(miss[i][1], sizeof(miss[i][1]), "%s.99", m_paths[i]);
+        paths[np++] = miss[i][0];
+        paths[np++] = miss[i][1];
+    }
+    for (int i = 0; i < NEXTRA; i++) paths[np++] = extra[i];
+    size_t nn = json_query_nodes(paths, np);
+    struct json_query_node* nodes = malloc(nn * sizeof(*nodes));
+    struct json_query q;
+    struct json res[QUERY_MAX_PATHS * 3 + NEXTRA];
+    CHECK(json_query_compile(&q, nodes, nn, paths, np));
+    size_t found = json_query_exec(&q, buf, n, res), exist = 0;
+    for (size_t i = 0; i < np; i++) {
+        struct json g = json_getn(buf, n, paths[i]);
+        exist += json_exists(g);
+        if (json_raw(res[i]) != json_raw(g) ||
+            json_raw_length(res[i]) != json_raw_length(g))
+            CHECK_FAIL("query \"%s\": %.*s != %.*s", paths[i],
+                       (int)json_raw_length(res[i]), json_raw(res[i]),
+                       (int)json_raw_length(g), json_raw(g));
+    }
+    CHECK(found == exist);
+    free(nodes);
+}
+
+/* 在大小正好的堆副本上比较, 使AddressSanitizer能发现越界读取 */
+static void check_doc(const char* s, size_t n, bool deep) {
+    char* b = malloc(n ? n : 1);
+    memcpy(b, s, n);
+    for (int opts = 0; opts < 2; opts++) {
+        struct json_valid x = json_validn_ex(b, n, opts);
+        struct json_valid y = ref_json_validn_ex(b, n, opts);
+        CHECK(x.valid == y.valid && x.pos == y.pos);
+    }
+    struct json a = json_parsen(b, n), c = ref_json_parsen(b, n);
+    if (deep) {
+        char path[PATH_MAX_LEN] = "";
+        m_npaths = 0;
+        walk(b, n, a, c, 0, path, 0);
+        if (json_validn(b, n)) check_query(b, n);
+    } else {
+        CHECK(json_raw_length(a) == ref_json_raw_length(c));
+    }
+    free(b);
+}
+
+static char* read_file(const char* name, size_t* len) {
+    FILE* f = fopen(name, "rb");
+    if (f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* buf = malloc(size > 0 ? size : 1);
+    *len = fread(buf, 1, size > 0 ? size : 0, f);
+    fclose(f);
+    return buf;
+}
+
+int main(int argc, char* argv[]) {
+    static const char pool[] = "\"\\{}[]:,\x01\x1f \x7f\x80\xc3\xa9\xe4\xff"
+                               "0nt-e";  // 变异时写入的字节
+    long mutations = argc > 1 ? atol(argv[1]) : TEST_MUTATIONS;
+    int ndocs = TEST_DOCS + (argc > 2 ? argc - 2 : 0), nvalid = 0;
+    char** docs = calloc(ndocs, sizeof(char*));
+    size_t* lens = calloc(ndocs, sizeof(size_t));
+    static const char* const fixed[] = {
+        // 重复键(只取第一个), 转义的键, 嵌套数组
+        "{\"a\":{\"b\":[1,{\"c\":\"x\"}],\"b\":2},\"d\":[[2,[3]],{}],"
+        "\"e\\u0041\":1,\"a\":null}",
+        "[[],{\"0\":[0,1,2]},[[[\"deep\"]]],\"s\"]",
+        "{\"\":{\"\":1},\"1\":[true]}",
+    };
+    for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++)
+        check_doc(fixed[i], strlen(fixed[i]), true);
+    srand(1);
+    for (int i = 0; i < ndocs; i++) {
+        if (i >= TEST_DOCS) {
+            docs[i] = read_file(argv[i - TEST_DOCS + 2], &lens[i]);
+            if (docs[i] == NULL) {
+                printf("cannot read %s\n", argv[i - TEST_DOCS + 2]);
+                return EXIT_FAILURE;
+            }
+        } else {
+            doc_t d = {malloc(DOC_MAX), 0};
+            gen_value(&d, 0);
+            docs[i] = d.buf;
+            lens[i] = d.len;
+        }
+        check_doc(docs[i], lens[i], true);
+        nvalid += json_validn(docs[i], lens[i]);
+    }
+    for (long it = 0; it < mutations; it++) {
+        int i = rand() % ndocs;
+        size_t n = lens[i];
+        char* m = malloc(n ? n : 1);
+        memcpy(m, docs[i], n);
+        for (int k = rand() % 4; k >= 0 && n; k--)
+            m[rand() % n] = pool[rand() % (sizeof(pool) - 1)];
+        size_t cut = rand() % 3 == 0 ? rand() % (n + 1) : n;
+        check_doc(m, cut, rand() % 4 == 0);
+        size_t start = n ? rand() % n : 0;
+        check_doc(m + start, n - start, false);
+        free(m);
+    }
+    for (int i = 0; i < ndocs; i++) free(docs[i]);
+    free(docs);
+    free(lens);
+    printf("%s (%d docs, %d valid, %ld mutations)\n", m_fails ? "FAIL" : "PASS",
+           ndocs, nvalid, mutations);
+    return m_fails ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -41,6 +41,8 @@
 
 #include "lfbb.h"
 
+#include <string.h>
+
 // #include <assert.h>
 #define assert(x) ((void)0)
 
@@ -53,6 +55,8 @@
 /******************** FUNCTION PROTOTYPES *********************/
 
 static size_t CalcFree(size_t w, size_t r, size_t size);
+static size_t Gather(LFBB_Inst_Type* inst, size_t skip, const mod_iovec_t* iov,
+                     size_t cnt, size_t* r_out);
 
 /******************** EXPORTED FUNCTIONS **********************/
 
@@ -229,8 +233,107 @@ void LFBB_ReadRelease(LFBB_Inst_Type* inst, const size_t read) {
     MOD_ATOMIC_STORE(inst->r, r, MOD_ATOMIC_ORDER_RELEASE);
 }
 
+size_t LFBB_WriteV(LFBB_Inst_Type* inst, const mod_iovec_t* iov,
+                   const size_t cnt) {
+    assert(inst != NULL);
+    assert(iov != NULL);
+
+    size_t total = 0U;
+    for (size_t k = 0U; k < cnt; k++) {
+        total += iov[k].len;
+    }
+    if (total == 0U) {
+        return 0U;
+    }
+
+    uint8_t* dst = LFBB_WriteAcquire(inst, total);
+    if (dst == NULL) {
+        return 0U;
+    }
+    for (size_t k = 0U; k < cnt; k++) {
+        memcpy(dst, iov[k].base, iov[k].len);
+        dst += iov[k].len;
+    }
+    LFBB_WriteRelease(inst, total);
+    return total;
+}
+
+size_t LFBB_ReadV(LFBB_Inst_Type* inst, const mod_iovec_t* iov,
+                  const size_t cnt) {
+    assert(inst != NULL);
+    assert(iov != NULL);
+
+    size_t r;
+    const size_t read = Gather(inst, 0U, iov, cnt, &r);
+    if (read != 0U) {
+        MOD_ATOMIC_STORE(inst->r, r, MOD_ATOMIC_ORDER_RELEASE);
+    }
+    return read;
+}
+
+size_t LFBB_PeekV(LFBB_Inst_Type* inst, const size_t skip,
+                  const mod_iovec_t* iov, const size_t cnt) {
+    assert(inst != NULL);
+    assert(iov != NULL);
+
+    size_t r;
+    return Gather(inst, skip, iov, cnt, &r);
+}
+
 /********************* PRIVATE FUNCTIONS **********************/
 
+/* Skips `skip` bytes, then copies up to two linear regions (until the
+ * invalidate index, then from the start of the buffer) into the segments.
+ * Returns the bytes copied and the new read index
+ */
+static size_t Gather(LFBB_Inst_Type* inst, size_t skip, const mod_iovec_t* iov,
+                     const size_t cnt, size_t* r_out) {
+    assert(inst->data != NULL);
+
+    /* Preload variables with adequate memory ordering */
+    size_t r = MOD_ATOMIC_LOAD(inst->r, MOD_ATOMIC_ORDER_RELAXED);
+    const size_t w = MOD_ATOMIC_LOAD(inst->w, MOD_ATOMIC_ORDER_ACQUIRE);
+    const size_t i = MOD_ATOMIC_LOAD(inst->i, MOD_ATOMIC_ORDER_RELAXED);
+
+    size_t end = (r <= w) ? w : i; /* End of the current linear region */
+    size_t read = 0U;
+    size_t k = 0U;
+    size_t off = 0U; /* Offset inside the current segment */
+
+    while (k < cnt) {
+        if (r == end) {
+            /* Wrap only once, when the first region ended at invalidate */
+            if (end == w) {
+                break;
+            }
+            r = 0U;
+            end = w;
+            continue;
+        }
+        if (skip != 0U) {
+            const size_t n = MIN(skip, end - r);
+            r += n;
+            skip -= n;
+            continue;
+        }
+        size_t n = MIN(iov[k].len - off, end - r);
+        memcpy((uint8_t*)iov[k].base + off, &inst->data[r], n);
+        r += n;
+        off += n;
+        read += n;
+        if (off == iov[k].len) {
+            k++;
+            off = 0U;
+        }
+    }
+
+    if (r == inst->size) {
+        r = 0U;
+    }
+    *r_out = r;
+    return read;
+}
+
 static size_t CalcFree(const size_t w, const size_t r, const size_t size) {
     if (r > w) {
         return (r - w) - 1U;
@@ -116,6 +116,38 @@ uint8_t* LFBB_ReadAcquire(LFBB_Inst_Type* inst, size_t* available);
  */
 void LFBB_ReadRelease(LFBB_Inst_Type* inst, size_t read);
 
+/**
+ * @brief Writes several segments as one contiguous block
+ * @param[in] Instance pointer
+ * @param[in] Segment array
+ * @param[in] Number of segments
+ * @retval Bytes written, 0 if there is no linear space for all of them
+ * @note The block is acquired and released once, so the reader never sees
+ * a partially written frame
+ */
+size_t LFBB_WriteV(LFBB_Inst_Type* inst, const mod_iovec_t* iov, size_t cnt);
+
+/**
+ * @brief Reads data into several segments, crossing the wrap point if needed
+ * @param[in] Instance pointer
+ * @param[in] Segment array
+ * @param[in] Number of segments
+ * @retval Bytes read
+ * @note The read index is stored once per call
+ */
+size_t LFBB_ReadV(LFBB_Inst_Type* inst, const mod_iovec_t* iov, size_t cnt);
+
+/**
+ * @brief Copies data into several segments without consuming it
+ * @param[in] Instance pointer
+ * @param[in] Bytes to skip before copying
+ * @param[in] Segment array
+ * @param[in] Number of segments
+ * @retval Bytes copied
+ */
+size_t LFBB_PeekV(LFBB_Inst_Type* inst, size_t skip, const mod_iovec_t* iov,
+                  size_t cnt);
+
 /**
  * @brief Checks if the bipartite buffer is empty
  * @param[in] Instance pointer
@@ -0,0 +1,110 @@
+// lfbb向量读写回归测试: WriteV整块写入, ReadV/PeekV跨越无效区回绕读取,
+// 零长度数据段, 以及没有足够连续空间时WriteV整体拒绝
+// 在工程根目录构建并运行:
+//   gcc -O1 -g -fsanitize=address,undefined -Idatastruct/lfbb/test -I.
+//       -Idatastruct/lfbb -Idebug/minctest datastruct/lfbb/lfbb.c
+//       datastruct/lfbb/test/lfbb_test.c -o lfbb_test
+//   ./lfbb_test
+// 全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_check.h"
+#include "lfbb.h"
+
+#define SIZE 32
+
+static uint8_t m_data[SIZE];
+
+// 帧: 头3字节 + 空段 + 数据7字节 + 尾2字节, 第二帧的内容加1
+static uint8_t hdr[3] = {0xA5, 0x01, 0x02};
+static uint8_t body[7] = {0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16};
+static uint8_t tail[2] = {0xEE, 0xFF};
+static const mod_iovec_t frame[4] = {
+    {hdr, 3}, {hdr, 0}, {body, 7}, {tail, 2}};
+#define FRAME_LEN 12
+
+static void frame_bytes(uint8_t* out) {
+    memcpy(out, hdr, 3);
+    memcpy(out + 3, body, 7);
+    memcpy(out + 10, tail, 2);
+}
+
+static void frame_next(void) {
+    for (int k = 0; k < 3; k++) hdr[k]++;
+    for (int k = 0; k < 7; k++) body[k]++;
+    for (int k = 0; k < 2; k++) tail[k]++;
+}
+
+/* 从每个起点写入两帧, 第二帧放不下时回到缓冲区开头, 读取时跨越无效区 */
+static void test_wrap(void) {
+    LFBB_Inst_Type b;
+    uint8_t expect[2 * FRAME_LEN], out[2 * FRAME_LEN + 8];
+    int wrapped = 0;
+    for (size_t start = 0; start < SIZE; start++) {
+        LFBB_Init(&b, m_data, SIZE);
+        size_t avail;
+        if (start) {
+            CHECK(LFBB_WriteAcquire(&b, start) != NULL);
+            LFBB_WriteRelease(&b, start);
+            CHECK(LFBB_ReadAcquire(&b, &avail) != NULL && avail == start);
+            LFBB_ReadRelease(&b, start);
+        }
+        frame_bytes(expect);
+        CHECK(LFBB_WriteV(&b, frame, 4) == FRAME_LEN);
+        frame_next();
+        frame_bytes(expect + FRAME_LEN);
+        size_t second = LFBB_WriteV(&b, frame, 4);
+        size_t total = FRAME_LEN + second;
+        CHECK(second == 0 || second == FRAME_LEN);
+        if (second && MOD_ATOMIC_LOAD(b.w, MOD_ATOMIC_ORDER_RELAXED) < start)
+            wrapped++;
+
+        memset(out, 0, sizeof(out));
+        mod_iovec_t peek[3] = {{out, 4}, {out, 0}, {out + 4, 2 * FRAME_LEN}};
+        CHECK(LFBB_PeekV(&b, 2, peek, 3) == total - 2);
+        CHECK(memcmp(out, expect + 2, total - 2) == 0);
+
+        memset(out, 0, sizeof(out));
+        mod_iovec_t rd[4] = {{out, 5}, {out, 0}, {out + 5, 10}, {out + 15, 17}};
+        CHECK(LFBB_ReadV(&b, rd, 4) == total);
+        CHECK(memcmp(out, expect, total) == 0);
+        CHECK(LFBB_IsEmpty(&b));
+        // 读完后仍可正常写入和读取
+        CHECK(LFBB_WriteV(&b, frame, 4) == FRAME_LEN);
+        CHECK(LFBB_ReadV(&b, rd, 4) == FRAME_LEN);
+        CHECK(memcmp(out, expect + FRAME_LEN, FRAME_LEN) == 0);
+    }
+    CHECK(wrapped > 0);  // 至少有一次第二帧回绕
+}
+
+/* 空间不足: WriteV不写入任何数据 */
+static void test_full(void) {
+    LFBB_Inst_Type b;
+    uint8_t pad[SIZE] = {0}, out[SIZE];
+    LFBB_Init(&b, m_data, SIZE);
+    mod_iovec_t fill = {pad, SIZE - 1};
+    CHECK(LFBB_WriteV(&b, &fill, 1) == SIZE - 1);
+    CHECK(LFBB_WriteV(&b, frame + 3, 1) == 0);
+
+    mod_iovec_t empty[2] = {{out, 0}, {out, 0}};
+    CHECK(LFBB_WriteV(&b, empty, 2) == 0);  // 全部为空段
+    CHECK(LFBB_ReadV(&b, empty, 2) == 0);
+
+    mod_iovec_t rd = {out, 20};
+    CHECK(LFBB_ReadV(&b, &rd, 1) == 20);
+    // 空闲20字节, 但尾部只剩1字节, 开头19字节: 整帧放在开头
+    CHECK(LFBB_WriteV(&b, frame, 4) == FRAME_LEN);
+    fill.len = 8;
+    CHECK(LFBB_WriteV(&b, &fill, 1) == 0);  // 只剩7字节
+    rd.len = SIZE;
+    CHECK(LFBB_ReadV(&b, &rd, 1) == SIZE - 1 - 20 + FRAME_LEN);
+    CHECK(LFBB_IsEmpty(&b));
+}
+
+int main(void) {
+    test_wrap();
+    test_full();
+    return CHECK_RESULT();
+}
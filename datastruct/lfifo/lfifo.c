@@ -13,14 +13,61 @@
 
 #define _INLINE __attribute__((always_inline)) inline
 
+#define MP_COUNT_BITS 8
+#define MP_COUNT_MASK ((1u << MP_COUNT_BITS) - 1)
+#define MP_HEAD(v) ((mod_size_t)(v) >> MP_COUNT_BITS)
+#define MP_COUNT(v) ((mod_size_t)(v) & MP_COUNT_MASK)
+
+/**
+ * @brief 将缓冲区头部[lo, hi)的数据复制到镜像区
+ */
+static _INLINE void lfifo_mirror_out(lfifo_t* fifo, mod_size_t lo,
+                                     mod_size_t hi) {
+    if (hi > fifo->mirror)
+        hi = fifo->mirror;
+    if (lo < hi)
+        memcpy(&fifo->buf[fifo->size + lo], &fifo->buf[lo], hi - lo);
+}
+
+/**
+ * @brief 同步一次从start开始的连续写入(可能越过末尾写入了镜像区)
+ */
+static _INLINE void lfifo_mirror_in(lfifo_t* fifo, mod_size_t start,
+                                    mod_size_t len) {
+    if (!fifo->mirror)
+        return;
+    mod_size_t end = start + len;
+    if (end > fifo->size) {  // 越过末尾的部分折回缓冲区头部
+        memcpy(fifo->buf, &fifo->buf[fifo->size], end - fifo->size);
+        end = fifo->size;
+    }
+    lfifo_mirror_out(fifo, start, end);
+}
+
+/**
+ * @brief 多生产者模式下由消费者同步写指针
+ * @note 没有未提交的预留时, 预留位置之前的数据均已提交
+ */
+static _INLINE void lfifo_sync(lfifo_t* fifo) {
+    if (!fifo->multi)
+        return;
+    mod_size_t v = MOD_ATOMIC_LOAD(fifo->mp, MOD_ATOMIC_ORDER_ACQUIRE);
+    if (MP_COUNT(v) == 0)
+        MOD_ATOMIC_STORE(fifo->wr, MP_HEAD(v), MOD_ATOMIC_ORDER_RELAXED);
+}
+
 int LFifo_Init(lfifo_t* fifo, mod_size_t size) {
-    fifo->buf = m_alloc(size + 1);
-    if (fifo->buf == NULL) {
+    return LFifo_InitMirror(fifo, size, 0);
+}
+
+int LFifo_InitMirror(lfifo_t* fifo, mod_size_t size, mod_size_t mirror) {
+    if (mirror > size)
+        mirror = size;
+    uint8_t* buf = m_alloc(size + 1 + mirror);
+    if (buf == NULL) {
         return -1;
     }
-    fifo->size = size + 1;
-    MOD_ATOMIC_INIT(fifo->wr, 0);
-    MOD_ATOMIC_INIT(fifo->rd, 0);
+    LFifo_AssignBufMirror(fifo, buf, size + 1, mirror);
     return 0;
 }
 
@@ -28,15 +75,39 @@ void LFifo_Destory(lfifo_t* fifo) {
     m_free(fifo->buf);
     fifo->buf = NULL;
     fifo->size = 0;
+    fifo->mirror = 0;
+    fifo->multi = false;
     MOD_ATOMIC_INIT(fifo->wr, 0);
     MOD_ATOMIC_INIT(fifo->rd, 0);
+    MOD_ATOMIC_INIT(fifo->mp, 0);
 }
 
 void LFifo_AssignBuf(lfifo_t* fifo, uint8_t* buffer, mod_size_t size) {
+    LFifo_AssignBufMirror(fifo, buffer, size, 0);
+}
+
+void LFifo_AssignBufMirror(lfifo_t* fifo, uint8_t* buffer, mod_size_t size,
+                           mod_size_t mirror) {
     fifo->buf = buffer;
     fifo->size = size;
+    fifo->mirror = mirror < size ? mirror : (size ? size - 1 : 0);
+    fifo->multi = false;
     MOD_ATOMIC_INIT(fifo->wr, 0);
     MOD_ATOMIC_INIT(fifo->rd, 0);
+    MOD_ATOMIC_INIT(fifo->mp, 0);
+}
+
+int LFifo_EnableMultiProducer(lfifo_t* fifo) {
+#if !MOD_CFG_ENABLE_ATOMIC
+    (void)fifo;
+    return -1;  // CAS退化为普通读写, 多个生产者会预留到同一区域
+#endif
+    if (!fifo->mirror || fifo->size > (mod_size_t)1 << (32 - MP_COUNT_BITS))
+        return -1;
+    mod_size_t wr_t = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_RELAXED);
+    MOD_ATOMIC_STORE(fifo->mp, wr_t << MP_COUNT_BITS, MOD_ATOMIC_ORDER_RELAXED);
+    fifo->multi = true;
+    return 0;
 }
 
 _INLINE mod_size_t LFifo_GetSize(lfifo_t* fifo) {
@@ -48,6 +119,7 @@ _INLINE mod_size_t LFifo_GetSize(lfifo_t* fifo) {
 _INLINE mod_size_t LFifo_GetUsed(lfifo_t* fifo) {
     if (fifo->size == 0)
         return 0;
+    lfifo_sync(fifo);
     if (fifo->wr >= fifo->rd) {
         return fifo->wr - fifo->rd;
     } else {
@@ -58,29 +130,41 @@ _INLINE mod_size_t LFifo_GetUsed(lfifo_t* fifo) {
 _INLINE mod_size_t LFifo_GetFree(lfifo_t* fifo) {
     if (fifo->size == 0)
         return 0;
+    if (fifo->multi) {  // 以预留位置计算, 不同步写指针
+        mod_size_t head =
+            MP_HEAD(MOD_ATOMIC_LOAD(fifo->mp, MOD_ATOMIC_ORDER_RELAXED));
+        mod_size_t rd_t = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_ACQUIRE);
+        return fifo->size - 1 - (head + fifo->size - rd_t) % fifo->size;
+    }
     return fifo->size - LFifo_GetUsed(fifo) - 1;
 }
 
 _INLINE bool LFifo_IsEmpty(lfifo_t* fifo) {
+    lfifo_sync(fifo);
     return (fifo->wr == fifo->rd);
 }
 
 _INLINE bool LFifo_IsFull(lfifo_t* fifo) {
+    if (fifo->multi)
+        return LFifo_GetFree(fifo) == 0;
     return ((fifo->wr + 1) % fifo->size == fifo->rd);
 }
 
 void LFifo_ClearFill(lfifo_t* fifo, const uint8_t fill_data) {
-    memset(fifo->buf, fill_data, fifo->size);
-    fifo->wr = 0;
-    fifo->rd = 0;
+    memset(fifo->buf, fill_data, fifo->size + fifo->mirror);
+    LFifo_Clear(fifo);
 }
 
 void LFifo_Clear(lfifo_t* fifo) {
     fifo->wr = 0;
     fifo->rd = 0;
+    if (fifo->multi)
+        MOD_ATOMIC_STORE(fifo->mp, 0, MOD_ATOMIC_ORDER_RELAXED);
 }
 
 mod_size_t LFifo_Write(lfifo_t* fifo, uint8_t* data, mod_size_t len) {
+    if (fifo->multi)  // 多生产者模式只能通过Reserve/Commit写入
+        return 0;
     mod_size_t free_size = LFifo_GetFree(fifo);
     if (!free_size)
         return 0;
@@ -90,14 +174,18 @@ mod_size_t LFifo_Write(lfifo_t* fifo, uint8_t* data, mod_size_t len) {
     mod_size_t tocpy = len;
     if (len > fifo->size - wr_t)
         tocpy = fifo->size - wr_t;
-    if (data != NULL)
+    if (data != NULL) {
         memcpy(&fifo->buf[wr_t], data, tocpy);
+        lfifo_mirror_out(fifo, wr_t, wr_t + tocpy);
+    }
     wr_t += tocpy;
     data += tocpy;
     tocpy = len - tocpy;
     if (tocpy) {
-        if (data != NULL)
+        if (data != NULL) {
             memcpy(fifo->buf, data, tocpy);
+            lfifo_mirror_out(fifo, 0, tocpy);
+        }
         wr_t = tocpy;
     }
     wr_t %= fifo->size;
@@ -153,17 +241,128 @@ mod_size_t LFifo_Peek(lfifo_t* fifo, mod_size_t offset, uint8_t* data,
     return len;
 }
 
+/**
+ * @brief 计算分段总长度
+ */
+static _INLINE mod_size_t lfifo_iov_len(const mod_iovec_t* iov,
+                                        mod_size_t cnt) {
+    mod_size_t total = 0;
+    for (mod_size_t i = 0; i < cnt; i++) total += iov[i].len;
+    return total;
+}
+
+/**
+ * @brief 从pos开始读出len字节到各分段, 返回结束位置
+ */
+static mod_size_t lfifo_gather(lfifo_t* fifo, mod_size_t pos, mod_size_t len,
+                               const mod_iovec_t* iov, mod_size_t cnt) {
+    for (mod_size_t i = 0; i < cnt && len; i++) {
+        uint8_t* dst = iov[i].base;
+        mod_size_t n = iov[i].len < len ? iov[i].len : len;
+        mod_size_t tocpy = n;
+        len -= n;
+        if (tocpy > fifo->size - pos)
+            tocpy = fifo->size - pos;
+        memcpy(dst, &fifo->buf[pos], tocpy);
+        pos += tocpy;
+        if (n > tocpy) {
+            memcpy(dst + tocpy, fifo->buf, n - tocpy);
+            pos = n - tocpy;
+        }
+        if (pos >= fifo->size)
+            pos = 0;
+    }
+    return pos;
+}
+
+mod_size_t LFifo_WriteV(lfifo_t* fifo, const mod_iovec_t* iov,
+                        mod_size_t cnt) {
+    mod_size_t len = lfifo_iov_len(iov, cnt);
+    if (len == 0 || len > LFifo_GetFree(fifo))
+        return 0;
+    if (fifo->multi) {  // 整体预留, 帧内数据不会与其他生产者交错
+        uint8_t* p = LFifo_Reserve(fifo, len);
+        if (p == NULL)
+            return 0;
+        uint8_t* q = p;
+        for (mod_size_t i = 0; i < cnt; i++) {
+            memcpy(q, iov[i].base, iov[i].len);
+            q += iov[i].len;
+        }
+        LFifo_Commit(fifo, p, len);
+        return len;
+    }
+    mod_size_t wr_t = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_ACQUIRE);
+    mod_size_t start = wr_t;
+    for (mod_size_t i = 0; i < cnt; i++) {
+        const uint8_t* src = iov[i].base;
+        mod_size_t n = iov[i].len;
+        mod_size_t tocpy = n;
+        if (tocpy > fifo->size - wr_t)
+            tocpy = fifo->size - wr_t;
+        memcpy(&fifo->buf[wr_t], src, tocpy);
+        wr_t += tocpy;
+        if (n > tocpy) {
+            memcpy(fifo->buf, src + tocpy, n - tocpy);
+            wr_t = n - tocpy;
+        }
+        if (wr_t >= fifo->size)
+            wr_t = 0;
+    }
+    if (fifo->mirror) {  // 镜像区只需按整段范围同步一次
+        if (start + len > fifo->size) {
+            lfifo_mirror_out(fifo, start, fifo->size);
+            lfifo_mirror_out(fifo, 0, start + len - fifo->size);
+        } else {
+            lfifo_mirror_out(fifo, start, start + len);
+        }
+    }
+    MOD_ATOMIC_STORE(fifo->wr, wr_t, MOD_ATOMIC_ORDER_RELEASE);
+    return len;
+}
+
+mod_size_t LFifo_ReadV(lfifo_t* fifo, const mod_iovec_t* iov,
+                       mod_size_t cnt) {
+    mod_size_t used = LFifo_GetUsed(fifo);
+    mod_size_t len = lfifo_iov_len(iov, cnt);
+    if (len > used)
+        len = used;
+    if (len == 0)
+        return 0;
+    mod_size_t rd_t = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_ACQUIRE);
+    rd_t = lfifo_gather(fifo, rd_t, len, iov, cnt);
+    MOD_ATOMIC_STORE(fifo->rd, rd_t, MOD_ATOMIC_ORDER_RELEASE);
+    return len;
+}
+
+mod_size_t LFifo_PeekV(lfifo_t* fifo, mod_size_t offset,
+                       const mod_iovec_t* iov, mod_size_t cnt) {
+    mod_size_t used = LFifo_GetUsed(fifo);
+    if (offset >= used)
+        return 0;
+    mod_size_t len = lfifo_iov_len(iov, cnt);
+    if (len > used - offset)
+        len = used - offset;
+    lfifo_gather(fifo, (fifo->rd + offset) % fifo->size, len, iov, cnt);
+    return len;
+}
+
 _INLINE int LFifo_WriteByte(lfifo_t* fifo, uint8_t data) {
+    if (fifo->multi)
+        return -1;
     if (fifo->wr == (fifo->rd + fifo->size - 1) % fifo->size)
         return -1;
     mod_size_t wr_t = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_ACQUIRE);
     fifo->buf[wr_t] = data;
+    if (wr_t < fifo->mirror)
+        fifo->buf[fifo->size + wr_t] = data;
     wr_t = (wr_t + 1) % fifo->size;
     MOD_ATOMIC_STORE(fifo->wr, wr_t, MOD_ATOMIC_ORDER_RELEASE);
     return 0;
 }
 
 _INLINE int LFifo_ReadByte(lfifo_t* fifo) {
+    lfifo_sync(fifo);
     if (fifo->wr == fifo->rd)
         return -1;
     mod_size_t rd_t = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_ACQUIRE);
@@ -228,24 +427,22 @@ mod_offset_t LFifo_Find(lfifo_t* fifo, uint8_t* data, mod_size_t len,
 }
 
 uint8_t* LFifo_AcquireLinearWrite(lfifo_t* fifo, mod_size_t* len) {
-    if (LFifo_GetFree(fifo) == 0) {
+    mod_size_t free_size = fifo->multi ? 0 : LFifo_GetFree(fifo);
+    if (free_size == 0) {
         *len = 0;
         return NULL;
     }
     mod_size_t wr_t = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_RELAXED);
-    mod_size_t rd_t = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_RELAXED);
-    if (wr_t >= rd_t) {
-        *len = fifo->size - wr_t;
-    } else {
-        *len = rd_t - wr_t - 1;
-    }
+    mod_size_t linear = fifo->size - wr_t + fifo->mirror;
+    *len = free_size < linear ? free_size : linear;
     return &fifo->buf[wr_t];
 }
 
 void LFifo_ReleaseLinearWrite(lfifo_t* fifo, mod_size_t len) {
-    if (len == 0)
+    if (fifo->multi || len == 0)
         return;
     mod_size_t wr_t = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_ACQUIRE);
+    lfifo_mirror_in(fifo, wr_t, len);
     wr_t += len;
     wr_t %= fifo->size;
     MOD_ATOMIC_STORE(fifo->wr, wr_t, MOD_ATOMIC_ORDER_RELEASE);
@@ -257,13 +454,9 @@ uint8_t* LFifo_AcquireLinearRead(lfifo_t* fifo, mod_size_t* len) {
         *len = 0;
         return NULL;
     }
-    mod_size_t wr_t = MOD_ATOMIC_LOAD(fifo->wr, MOD_ATOMIC_ORDER_RELAXED);
     mod_size_t rd_t = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_RELAXED);
-    if (wr_t >= rd_t) {
-        *len = wr_t - rd_t;
-    } else {
-        *len = fifo->size - rd_t;
-    }
+    mod_size_t linear = fifo->size - rd_t + fifo->mirror;
+    *len = used < linear ? used : linear;
     return &fifo->buf[rd_t];
 }
 
@@ -275,3 +468,34 @@ void LFifo_ReleaseLinearRead(lfifo_t* fifo, mod_size_t len) {
     rd_t %= fifo->size;
     MOD_ATOMIC_STORE(fifo->rd, rd_t, MOD_ATOMIC_ORDER_RELEASE);
 }
+
+uint8_t* LFifo_Reserve(lfifo_t* fifo, mod_size_t len) {
+    // 预留位置head < size, len不超过镜像区时head+len总在镜像区之内,
+    // 任意位置的预留都是连续的, 不会因等待回绕而失败
+    if (!fifo->multi || len == 0 || len > fifo->mirror)
+        return NULL;
+    mod_size_t v = MOD_ATOMIC_LOAD(fifo->mp, MOD_ATOMIC_ORDER_RELAXED);
+    mod_size_t head;
+    do {
+        head = MP_HEAD(v);
+        if (MP_COUNT(v) == MP_COUNT_MASK)  // 未提交的预留过多
+            return NULL;
+        mod_size_t rd_t = MOD_ATOMIC_LOAD(fifo->rd, MOD_ATOMIC_ORDER_ACQUIRE);
+        mod_size_t used = (head + fifo->size - rd_t) % fifo->size;
+        if (len > fifo->size - 1 - used)
+            return NULL;
+    } while (!MOD_ATOMIC_CAS(
+        fifo->mp, v,
+        ((head + len) % fifo->size) << MP_COUNT_BITS | (MP_COUNT(v) + 1),
+        MOD_ATOMIC_ORDER_ACQUIRE));
+    return &fifo->buf[head];
+}
+
+void LFifo_Commit(lfifo_t* fifo, uint8_t* ptr, mod_size_t len) {
+    if (!fifo->multi || ptr == NULL || len == 0)
+        return;
+    lfifo_mirror_in(fifo, (mod_size_t)(ptr - fifo->buf), len);
+    mod_size_t v = MOD_ATOMIC_LOAD(fifo->mp, MOD_ATOMIC_ORDER_RELAXED);
+    while (!MOD_ATOMIC_CAS(fifo->mp, v, v - 1, MOD_ATOMIC_ORDER_RELEASE)) {
+    }
+}
@@ -25,6 +25,9 @@ typedef struct {           // FIFO对象
     mod_atomic_size_t rd;  // 读指针
     mod_size_t size;       // 缓冲区大小
     uint8_t* buf;          // 缓冲区指针
+    mod_size_t mirror;     // 镜像区大小(位于buf[size]之后, 复制缓冲区头部)
+    mod_atomic_size_t mp;  // 多生产者状态: 预留位置<<8 | 未提交的预留数
+    bool multi;            // 是否为多生产者模式
 } lfifo_t;
 
 /**
@@ -52,6 +55,43 @@ extern void LFifo_Destory(lfifo_t* fifo);
  */
 extern void LFifo_AssignBuf(lfifo_t* fifo, uint8_t* buffer, mod_size_t size);
 
+/**
+ * @brief 初始化带镜像区的FIFO, 使用动态缓冲区
+ * @param  fifo             FIFO对象
+ * @param  size             请求的FIFO大小
+ * @param  mirror           镜像区大小(小于size)
+ * @retval 0                成功
+ * @note  实际申请的空间为size+1+mirror
+ * @note  镜像区在缓冲区末尾复制缓冲区头部的数据, 跨越末尾的连续读写
+ *        (LinearWrite/LinearRead/Reserve)可一次获得最长size-rd+mirror的连续空间
+ */
+extern int LFifo_InitMirror(lfifo_t* fifo, mod_size_t size, mod_size_t mirror);
+
+/**
+ * @brief 使用静态缓冲区初始化带镜像区的FIFO
+ * @param  fifo             FIFO对象
+ * @param  buffer           静态缓冲区指针, 长度为size+mirror
+ * @param  size             环形部分大小
+ * @param  mirror           镜像区大小(小于size)
+ * @note  实际可用空间为size-1
+ */
+extern void LFifo_AssignBufMirror(lfifo_t* fifo, uint8_t* buffer,
+                                  mod_size_t size, mod_size_t mirror);
+
+/**
+ * @brief 开启多生产者模式
+ * @param  fifo             FIFO对象
+ * @retval 0                成功
+ * @retval -1               未开启MOD_CFG_ENABLE_ATOMIC,
+ *                          未配置镜像区或缓冲区超过16MB
+ * @note 开启后生产者只能使用LFifo_Reserve/LFifo_Commit(或LFifo_WriteV)写入,
+ *       LFifo_Write/LFifo_WriteByte/LFifo_AcquireLinearWrite不再写入数据,
+ *       GetUsed/IsEmpty等查询函数只能由消费者调用
+ * @note 单次预留的长度不能超过镜像区大小
+ * @note 应在FIFO为空且没有生产者时调用
+ */
+extern int LFifo_EnableMultiProducer(lfifo_t* fifo);
+
 /**
  * @brief 获取FIFO的大小
  * @param  fifo             FIFO对象
@@ -106,6 +146,7 @@ extern void LFifo_Clear(lfifo_t* fifo);
  * @param  len              期望写入的数据长度
  * @retval mod_size_t         实际写入的数据长度
  * @note 传入NULL指针可只更新FIFO状态(配合LFifo_GetWritePtr自行管理写指针)
+ * @note 多生产者模式下不写入, 返回0
  */
 extern mod_size_t LFifo_Write(lfifo_t* fifo, uint8_t* data, mod_size_t len);
 
@@ -130,11 +171,46 @@ extern mod_size_t LFifo_Read(lfifo_t* fifo, uint8_t* data, mod_size_t len);
 extern mod_size_t LFifo_Peek(lfifo_t* fifo, mod_size_t offset, uint8_t* data,
                              mod_size_t len);
 
+/**
+ * @brief 将多段数据作为一个整体写入FIFO
+ * @param  fifo             FIFO对象
+ * @param  iov              数据段数组
+ * @param  cnt              数据段个数
+ * @retval mod_size_t       写入的总长度, 空间不足时不写入并返回0
+ * @note 写指针只更新一次, 消费者不会看到写了一半的帧
+ * @note 多生产者模式下通过LFifo_Reserve/LFifo_Commit整体写入,
+ *       总长度不能超过镜像区大小
+ */
+extern mod_size_t LFifo_WriteV(lfifo_t* fifo, const mod_iovec_t* iov,
+                               mod_size_t cnt);
+
+/**
+ * @brief 从FIFO中读取数据, 依次填入多个数据段
+ * @param  fifo             FIFO对象
+ * @param  iov              数据段数组
+ * @param  cnt              数据段个数
+ * @retval mod_size_t       实际读取的总长度
+ */
+extern mod_size_t LFifo_ReadV(lfifo_t* fifo, const mod_iovec_t* iov,
+                              mod_size_t cnt);
+
+/**
+ * @brief 查看FIFO中的数据并依次填入多个数据段, 不改变FIFO的状态
+ * @param  fifo             FIFO对象
+ * @param  offset           期望查看的数据偏移
+ * @param  iov              数据段数组
+ * @param  cnt              数据段个数
+ * @retval mod_size_t       实际查看的总长度
+ */
+extern mod_size_t LFifo_PeekV(lfifo_t* fifo, mod_size_t offset,
+                              const mod_iovec_t* iov, mod_size_t cnt);
+
 /**
  * @brief 向FIFO中写入一字节数据
  * @param  fifo             FIFO对象
  * @param  data             写入数据
  * @retval 0                成功
+ * @retval -1               FIFO已满或处于多生产者模式
  */
 extern int LFifo_WriteByte(lfifo_t* fifo, uint8_t data);
 
@@ -187,7 +263,8 @@ extern mod_offset_t LFifo_Find(lfifo_t* fifo, uint8_t* data, mod_size_t len,
  * @param  fifo             FIFO对象
  * @param  len              返回可用空间的长度
  * @retval uint8_t*         可用空间的指针
- * @note 需严格确保同时只有一个生产者
+ * @note 需严格确保同时只有一个生产者, 多生产者模式下返回NULL
+ * @note 带镜像区时可越过缓冲区末尾, 释放时自动同步
  */
 extern uint8_t* LFifo_AcquireLinearWrite(lfifo_t* fifo, mod_size_t* len);
 
@@ -205,6 +282,7 @@ extern void LFifo_ReleaseLinearWrite(lfifo_t* fifo, mod_size_t len);
  * @param  len              返回可用空间的长度
  * @retval uint8_t*         可用空间的指针
  * @note 需严格确保同时只有一个消费者
+ * @note 带镜像区时可越过缓冲区末尾
  */
 extern uint8_t* LFifo_AcquireLinearRead(lfifo_t* fifo, mod_size_t* len);
 
@@ -216,6 +294,25 @@ extern uint8_t* LFifo_AcquireLinearRead(lfifo_t* fifo, mod_size_t* len);
  */
 extern void LFifo_ReleaseLinearRead(lfifo_t* fifo, mod_size_t len);
 
+/**
+ * @brief 预留一段连续的写入空间(多生产者)
+ * @param  fifo             FIFO对象
+ * @param  len              预留长度
+ * @retval uint8_t*         预留空间的指针, 空间不足时返回NULL
+ * @note 可在多个任务/中断中并发调用, 预留后可由DMA直接写入
+ * @note 跨越缓冲区末尾时使用镜像区, len超过镜像区大小时总是返回NULL
+ */
+extern uint8_t* LFifo_Reserve(lfifo_t* fifo, mod_size_t len);
+
+/**
+ * @brief 提交预留的写入空间(多生产者)
+ * @param  fifo             FIFO对象
+ * @param  ptr              LFifo_Reserve返回的指针
+ * @param  len              预留长度(必须与预留时一致)
+ * @note 预留按顺序生效: 所有未提交的预留都提交后, 数据才对消费者可见
+ */
+extern void LFifo_Commit(lfifo_t* fifo, uint8_t* ptr, mod_size_t len);
+
 #ifdef __cplusplus
 }
 #endif
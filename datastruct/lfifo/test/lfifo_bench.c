@@ -0,0 +1,109 @@
+// lfifo吞吐量基准测试, 与lwrb/lfbb比较(单线程写入后立即读出)
+// 在工程根目录构建并运行:
+//   gcc -O2 -Idatastruct/lfifo/test -I. -Idatastruct/lfifo -Idatastruct/lwrb
+//       -Idatastruct/lfbb datastruct/lfifo/lfifo.c datastruct/lwrb/lwrb.c
+//       datastruct/lfbb/lfbb.c datastruct/lfifo/test/lfifo_bench.c
+//       -o lfifo_bench
+//   ./lfifo_bench [每次读写的字节数]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lfbb.h"
+#include "lfifo.h"
+#include "lwrb.h"
+
+#define BENCH_SIZE 4096
+#define BENCH_MIRROR 64
+#define BENCH_ITERS 2000000
+
+static uint8_t m_buf[BENCH_SIZE + BENCH_MIRROR];
+static uint8_t m_src[BENCH_MIRROR], m_dst[BENCH_MIRROR];
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void report(const char* name, uint64_t ns) {
+    printf("%-18s %6.1f ns/op\n", name, (double)ns / BENCH_ITERS);
+}
+
+int main(int argc, char* argv[]) {
+    mod_size_t chunk = 48;
+    if (argc > 1)
+        chunk = (mod_size_t)atoi(argv[1]);
+    if (chunk == 0 || chunk > BENCH_MIRROR) {
+        printf("chunk must be 1~%d\n", BENCH_MIRROR);
+        return EXIT_FAILURE;
+    }
+    volatile uint32_t sink = 0;
+    mod_size_t l;
+    uint8_t* p;
+    lfifo_t f;
+
+    LFifo_AssignBuf(&f, m_buf, BENCH_SIZE);
+    uint64_t start = host_ns();
+    for (int i = 0; i < BENCH_ITERS; i++) {
+        LFifo_Write(&f, m_src, chunk);
+        LFifo_Read(&f, m_dst, chunk);
+        sink += m_dst[0];
+    }
+    report("lfifo copy", host_ns() - start);
+
+    LFifo_AssignBufMirror(&f, m_buf, BENCH_SIZE, BENCH_MIRROR);
+    start = host_ns();
+    for (int i = 0; i < BENCH_ITERS; i++) {
+        p = LFifo_AcquireLinearWrite(&f, &l);
+        memcpy(p, m_src, chunk);
+        LFifo_ReleaseLinearWrite(&f, chunk);
+        p = LFifo_AcquireLinearRead(&f, &l);
+        memcpy(m_dst, p, chunk);
+        LFifo_ReleaseLinearRead(&f, chunk);
+        sink += m_dst[0];
+    }
+    report("lfifo mirror", host_ns() - start);
+
+    LFifo_AssignBufMirror(&f, m_buf, BENCH_SIZE, BENCH_MIRROR);
+    LFifo_EnableMultiProducer(&f);
+    start = host_ns();
+    for (int i = 0; i < BENCH_ITERS; i++) {
+        p = LFifo_Reserve(&f, chunk);
+        memcpy(p, m_src, chunk);
+        LFifo_Commit(&f, p, chunk);
+        p = LFifo_AcquireLinearRead(&f, &l);
+        memcpy(m_dst, p, chunk);
+        LFifo_ReleaseLinearRead(&f, chunk);
+        sink += m_dst[0];
+    }
+    report("lfifo reserve", host_ns() - start);
+
+    lwrb_t rb;
+    lwrb_init(&rb, m_buf, BENCH_SIZE);
+    start = host_ns();
+    for (int i = 0; i < BENCH_ITERS; i++) {
+        lwrb_write(&rb, m_src, chunk);
+        lwrb_read(&rb, m_dst, chunk);
+        sink += m_dst[0];
+    }
+    report("lwrb copy", host_ns() - start);
+
+    LFBB_Inst_Type bb;
+    size_t avail;
+    LFBB_Init(&bb, m_buf, BENCH_SIZE);
+    start = host_ns();
+    for (int i = 0; i < BENCH_ITERS; i++) {
+        p = LFBB_WriteAcquire(&bb, chunk);
+        memcpy(p, m_src, chunk);
+        LFBB_WriteRelease(&bb, chunk);
+        p = LFBB_ReadAcquire(&bb, &avail);
+        memcpy(m_dst, p, chunk);
+        LFBB_ReadRelease(&bb, chunk);
+        sink += m_dst[0];
+    }
+    report("lfbb", host_ns() - start);
+    printf("(sink=%u)\n", sink);
+    return 0;
+}
@@ -0,0 +1,222 @@
+// lfifo回归测试: 单生产者随机读写, 多生产者预留在回绕处的行为,
+// 跨越末尾的分段写入, 以及多线程多生产者压力测试(建议配合ThreadSanitizer)
+// 在工程根目录构建并运行(-DMOD_CFG_ENABLE_ATOMIC=0测试拒绝多生产者):
+//   gcc -O1 -g -fsanitize=thread -pthread -Idatastruct/lfifo/test -I.
+//       -Idatastruct/lfifo -Idebug/minctest datastruct/lfifo/lfifo.c
+//       datastruct/lfifo/test/lfifo_test.c -o lfifo_test
+//   ./lfifo_test
+// 全部通过时返回0
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_check.h"
+#include "lfifo.h"
+
+#define MP_PRODUCERS 3
+#define MP_RECORDS 200000
+#define MP_MAX_LEN 64
+
+/* 单生产者: Write/LinearWrite/WriteV与Read/LinearRead随机交替 */
+static void test_spsc_random(void) {
+    lfifo_t f;
+    uint8_t in[64], out[64];
+    uint32_t wv = 0, rv = 0;  // 已写入/已读出的字节数
+    unsigned seed = 5;
+    CHECK(LFifo_InitMirror(&f, 100, 40) == 0);
+    for (int it = 0; it < 200000 && !m_fails; it++) {
+        mod_size_t n = 1 + rand_r(&seed) % 50, l;
+        uint8_t* p;
+        switch (rand_r(&seed) % 5) {
+            case 0:
+                for (mod_size_t k = 0; k < n; k++) in[k] = wv + k;
+                wv += LFifo_Write(&f, in, n);
+                break;
+            case 1:
+                p = LFifo_AcquireLinearWrite(&f, &l);
+                if (l > n) l = n;
+                for (mod_size_t k = 0; k < l; k++) p[k] = wv + k;
+                LFifo_ReleaseLinearWrite(&f, l);
+                wv += l;
+                break;
+            case 2: {
+                mod_size_t cut = n / 3;
+                for (mod_size_t k = 0; k < n; k++) in[k] = wv + k;
+                mod_iovec_t iov[2] = {{in, cut}, {in + cut, n - cut}};
+                l = LFifo_WriteV(&f, iov, 2);
+                CHECK(l == n || (l == 0 && LFifo_GetFree(&f) < n));
+                wv += l;
+                break;
+            }
+            case 3:
+                l = LFifo_Read(&f, out, n);
+                for (mod_size_t k = 0; k < l; k++)
+                    CHECK(out[k] == (uint8_t)(rv + k));
+                rv += l;
+                break;
+            default:
+                p = LFifo_AcquireLinearRead(&f, &l);
+                if (l > n) l = n;
+                for (mod_size_t k = 0; k < l; k++)
+                    CHECK(p[k] == (uint8_t)(rv + k));
+                LFifo_ReleaseLinearRead(&f, l);
+                rv += l;
+                break;
+        }
+        CHECK(wv - rv == LFifo_GetUsed(&f));
+    }
+    LFifo_Destory(&f);
+}
+
+/* 跨越缓冲区末尾的分段写入, 镜像区与缓冲区头部保持一致 */
+static void test_writev_wrap(void) {
+    static const uint8_t hdr[3] = {0xA5, 0x5A, 7};
+    uint8_t body[16], tail[2] = {0xEE, 0xFF}, out[21], expect[21];
+    lfifo_t f;
+    for (int k = 0; k < 16; k++) body[k] = (uint8_t)(k + 1);
+    memcpy(expect, hdr, 3);
+    memcpy(expect + 3, body, 16);
+    memcpy(expect + 19, tail, 2);
+    mod_iovec_t iov[3] = {{(void*)hdr, 3}, {body, 16}, {tail, 2}};
+    for (int multi = 0; multi <= MOD_CFG_ENABLE_ATOMIC; multi++) {
+        // 每个起点各写一次, 覆盖在各分段内部及分段边界处回绕的情况
+        for (mod_size_t start = 0; start < 33; start++) {
+            CHECK(LFifo_InitMirror(&f, 32, 24) == 0);
+            LFifo_ClearFill(&f, 0);
+            LFifo_Write(&f, NULL, start);
+            LFifo_Read(&f, NULL, start);
+            if (multi) CHECK(LFifo_EnableMultiProducer(&f) == 0);
+            CHECK(LFifo_WriteV(&f, iov, 3) == 21);
+            CHECK(LFifo_GetUsed(&f) == 21);
+            CHECK(memcmp(f.buf, f.buf + f.size, f.mirror) == 0);
+            mod_size_t l;
+            uint8_t* p = LFifo_AcquireLinearRead(&f, &l);
+            CHECK(l == 21 && memcmp(p, expect, 21) == 0);
+            CHECK(LFifo_Read(&f, out, sizeof(out)) == 21);
+            CHECK(memcmp(out, expect, 21) == 0);
+            CHECK(LFifo_WriteV(&f, iov, 3) == 21);  // 空间足够时总能整体写入
+            LFifo_Destory(&f);
+        }
+    }
+#if MOD_CFG_ENABLE_ATOMIC
+    CHECK(LFifo_InitMirror(&f, 32, 16) == 0);
+    CHECK(LFifo_EnableMultiProducer(&f) == 0);
+    CHECK(LFifo_WriteV(&f, iov, 3) == 0);  // 超过镜像区, 多生产者模式下拒绝
+    LFifo_Destory(&f);
+#endif
+}
+
+/* 未开启原子操作时不能进入多生产者模式 */
+static void test_enable_multi(void) {
+    lfifo_t f;
+    CHECK(LFifo_InitMirror(&f, 64, 8) == 0);
+    CHECK(LFifo_EnableMultiProducer(&f) == (MOD_CFG_ENABLE_ATOMIC ? 0 : -1));
+    CHECK(f.multi == MOD_CFG_ENABLE_ATOMIC);
+    LFifo_Destory(&f);
+}
+
+/* 多生产者模式: 预留在任意位置都能完成, 不会在回绕处永久失败 */
+static void test_reserve_wrap(void) {
+    lfifo_t f;
+    uint8_t byte = 0;
+    CHECK(LFifo_InitMirror(&f, 64, 8) == 0);
+    CHECK(LFifo_EnableMultiProducer(&f) == 0);
+    CHECK(LFifo_Write(&f, &byte, 1) == 0);  // 生产者只能预留
+    CHECK(LFifo_WriteByte(&f, 0) == -1);
+    mod_size_t l;
+    CHECK(LFifo_AcquireLinearWrite(&f, &l) == NULL && l == 0);
+    CHECK(LFifo_Reserve(&f, 16) == NULL);  // 超过镜像区
+    for (int i = 0; i < 200; i++) {
+        mod_size_t len = 1 + i % 8;
+        uint8_t* p = LFifo_Reserve(&f, len);
+        CHECK(p != NULL);
+        if (p == NULL) break;
+        memset(p, byte, len);
+        LFifo_Commit(&f, p, len);
+        p = LFifo_AcquireLinearRead(&f, &l);
+        CHECK(l == len && p[0] == byte && p[len - 1] == byte);
+        LFifo_ReleaseLinearRead(&f, l);
+        CHECK(LFifo_GetUsed(&f) == 0 && LFifo_GetFree(&f) == 64);
+        byte++;
+    }
+    LFifo_Destory(&f);
+}
+
+/* 多线程多生产者: 记录不交错, 每个生产者的记录按顺序到达 */
+static lfifo_t m_mp;
+static int m_mp_done;
+
+static void* mp_producer(void* arg) {
+    int id = (int)(long)arg;
+    unsigned seed = id * 7 + 1;
+    for (int i = 0; i < MP_RECORDS; i++) {
+        int len = 4 + rand_r(&seed) % (MP_MAX_LEN - 4);
+        uint8_t* p;
+        while ((p = LFifo_Reserve(&m_mp, len)) == NULL) sched_yield();
+        p[0] = (uint8_t)id;
+        p[1] = (uint8_t)len;
+        p[2] = (uint8_t)i;
+        p[3] = (uint8_t)(i >> 8);
+        for (int k = 4; k < len; k++) p[k] = (uint8_t)(id + i + k);
+        LFifo_Commit(&m_mp, p, len);
+    }
+    __atomic_fetch_add(&m_mp_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void test_mpsc_threads(void) {
+    pthread_t th[MP_PRODUCERS];
+    int next[MP_PRODUCERS] = {0};
+    long recs = 0;
+    uint8_t rec[MP_MAX_LEN];
+    CHECK(LFifo_InitMirror(&m_mp, 1000, MP_MAX_LEN) == 0);
+    CHECK(LFifo_EnableMultiProducer(&m_mp) == 0);
+    for (long i = 0; i < MP_PRODUCERS; i++)
+        pthread_create(&th[i], NULL, mp_producer, (void*)i);
+    int fails = m_fails;
+    while (1) {
+        int done = __atomic_load_n(&m_mp_done, __ATOMIC_ACQUIRE);
+        while (LFifo_GetUsed(&m_mp) >= 2) {
+            if (m_fails != fails) {  // 出错后只丢弃数据, 使生产者能够结束
+                LFifo_Read(&m_mp, NULL, LFifo_GetUsed(&m_mp));
+                continue;
+            }
+            LFifo_Peek(&m_mp, 0, rec, 2);
+            mod_size_t len = rec[1], l;
+            CHECK(LFifo_GetUsed(&m_mp) >= len);  // 记录整体可见
+            if (recs & 1) {  // 交替使用连续读取和复制读取
+                uint8_t* p = LFifo_AcquireLinearRead(&m_mp, &l);
+                CHECK(l >= len);
+                memcpy(rec, p, len);
+                LFifo_ReleaseLinearRead(&m_mp, len);
+            } else {
+                LFifo_Read(&m_mp, rec, len);
+            }
+            int id = rec[0], i = rec[2] | rec[3] << 8;
+            CHECK(id < MP_PRODUCERS && i == (next[id % MP_PRODUCERS] & 0xFFFF));
+            if (m_fails != fails) continue;
+            for (mod_size_t k = 4; k < len; k++)
+                CHECK(rec[k] == (uint8_t)(id + next[id] + k));
+            next[id]++;
+            recs++;
+        }
+        if (done == MP_PRODUCERS && LFifo_IsEmpty(&m_mp)) break;
+        sched_yield();
+    }
+    for (int i = 0; i < MP_PRODUCERS; i++) pthread_join(th[i], NULL);
+    CHECK(m_fails != fails || recs == (long)MP_PRODUCERS * MP_RECORDS);
+    LFifo_Destory(&m_mp);
+}
+
+int main(void) {
+    test_spsc_random();
+    test_writev_wrap();
+    test_enable_multi();
+    if (MOD_CFG_ENABLE_ATOMIC) {
+        test_reserve_wrap();
+        test_mpsc_threads();
+    }
+    return CHECK_RESULT();
+}
@@ -267,6 +267,151 @@ size_t lwrb_peek(const lwrb_t* buff, size_t skip_count, void* data,
     return tocopy + btp;
 }
 
+/**
+ * \brief           Copy segments into buffer starting at `w`, wrapping at the end
+ * \return          New write pointer
+ */
+static size_t prv_put_iov(lwrb_t* buff, size_t w, const mod_iovec_t* iov,
+                          size_t iovcnt) {
+    for (size_t i = 0; i < iovcnt; ++i) {
+        const uint8_t* d = iov[i].base;
+        size_t btw = iov[i].len, tocopy;
+
+        tocopy = BUF_MIN(buff->size - w, btw);
+        BUF_MEMCPY(&buff->buff[w], d, tocopy);
+        w += tocopy;
+        if (btw > tocopy) {
+            BUF_MEMCPY(buff->buff, &d[tocopy], btw - tocopy);
+            w = btw - tocopy;
+        }
+        if (w >= buff->size) {
+            w = 0;
+        }
+    }
+    return w;
+}
+
+/**
+ * \brief           Copy up to `btr` bytes from buffer starting at `r` into segments
+ * \return          New read pointer
+ */
+static size_t prv_get_iov(const lwrb_t* buff, size_t r, size_t btr,
+                          const mod_iovec_t* iov, size_t iovcnt) {
+    for (size_t i = 0; i < iovcnt && btr > 0; ++i) {
+        uint8_t* d = iov[i].base;
+        size_t len = BUF_MIN(iov[i].len, btr), tocopy;
+
+        btr -= len;
+        tocopy = BUF_MIN(buff->size - r, len);
+        BUF_MEMCPY(d, &buff->buff[r], tocopy);
+        r += tocopy;
+        if (len > tocopy) {
+            BUF_MEMCPY(&d[tocopy], buff->buff, len - tocopy);
+            r = len - tocopy;
+        }
+        if (r >= buff->size) {
+            r = 0;
+        }
+    }
+    return r;
+}
+
+/**
+ * \brief           Sum of segment lengths
+ */
+static size_t prv_iov_len(const mod_iovec_t* iov, size_t iovcnt) {
+    size_t total = 0;
+    for (size_t i = 0; i < iovcnt; ++i) {
+        total += iov[i].len;
+    }
+    return total;
+}
+
+/**
+ * \brief           Write several data segments to buffer as one block.
+ * All segments are written, or none when there is not enough free memory,
+ * so a frame assembled from header/payload/trailer is never split.
+ * Write pointer is updated (and write event sent) once per call.
+ *
+ * \param[in]       buff: Buffer handle
+ * \param[in]       iov: Array of segments to write
+ * \param[in]       iovcnt: Number of segments
+ * \return          Number of bytes written, `0` if not enough memory
+ */
+size_t lwrb_writev(lwrb_t* buff, const mod_iovec_t* iov, size_t iovcnt) {
+    size_t total, w;
+
+    if (!BUF_IS_VALID(buff) || iov == NULL || iovcnt == 0) {
+        return 0;
+    }
+    total = prv_iov_len(iov, iovcnt);
+    if (total == 0 || total > lwrb_get_free(buff)) {
+        return 0;
+    }
+    w = LWRB_LOAD(buff->w, memory_order_acquire);
+    w = prv_put_iov(buff, w, iov, iovcnt);
+    LWRB_STORE(buff->w, w, memory_order_release);
+
+    BUF_SEND_EVT(buff, LWRB_EVT_WRITE, total);
+    return total;
+}
+
+/**
+ * \brief           Read data from buffer into several segments.
+ * Segments are filled in order until buffer is empty.
+ * Read pointer is updated (and read event sent) once per call.
+ *
+ * \param[in]       buff: Buffer handle
+ * \param[in]       iov: Array of output segments
+ * \param[in]       iovcnt: Number of segments
+ * \return          Number of bytes read
+ */
+size_t lwrb_readv(lwrb_t* buff, const mod_iovec_t* iov, size_t iovcnt) {
+    size_t btr, r;
+
+    if (!BUF_IS_VALID(buff) || iov == NULL || iovcnt == 0) {
+        return 0;
+    }
+    btr = BUF_MIN(prv_iov_len(iov, iovcnt), lwrb_get_full(buff));
+    if (btr == 0) {
+        return 0;
+    }
+    r = LWRB_LOAD(buff->r, memory_order_acquire);
+    r = prv_get_iov(buff, r, btr, iov, iovcnt);
+    LWRB_STORE(buff->r, r, memory_order_release);
+
+    BUF_SEND_EVT(buff, LWRB_EVT_READ, btr);
+    return btr;
+}
+
+/**
+ * \brief           Peek data into several segments without changing read pointer
+ * \param[in]       buff: Buffer handle
+ * \param[in]       skip_count: Number of bytes to skip before reading data
+ * \param[in]       iov: Array of output segments
+ * \param[in]       iovcnt: Number of segments
+ * \return          Number of bytes peeked
+ */
+size_t lwrb_peekv(const lwrb_t* buff, size_t skip_count,
+                  const mod_iovec_t* iov, size_t iovcnt) {
+    size_t full, btp, r;
+
+    if (!BUF_IS_VALID(buff) || iov == NULL || iovcnt == 0) {
+        return 0;
+    }
+    full = lwrb_get_full(buff);
+    if (skip_count >= full) {
+        return 0;
+    }
+    btp = BUF_MIN(prv_iov_len(iov, iovcnt), full - skip_count);
+    r = LWRB_LOAD(buff->r, memory_order_relaxed) + skip_count;
+    if (r >= buff->size) {
+        r -= buff->size;
+    }
+    prv_get_iov(buff, r, btp, iov, iovcnt);
+    return btp;
+}
+
 /**
  * \brief           Get available size in buffer for write operation
  * \param[in]       buff: Buffer handle
@@ -37,6 +37,8 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "modules.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -102,6 +104,12 @@ size_t lwrb_write(lwrb_t* buff, const void* data, size_t btw);
 size_t lwrb_read(lwrb_t* buff, void* data, size_t btr);
 size_t lwrb_peek(const lwrb_t* buff, size_t skip_count, void* data, size_t btp);
 
+/* Vectored (scatter/gather) functions, single index update per call */
+size_t lwrb_writev(lwrb_t* buff, const mod_iovec_t* iov, size_t iovcnt);
+size_t lwrb_readv(lwrb_t* buff, const mod_iovec_t* iov, size_t iovcnt);
+size_t lwrb_peekv(const lwrb_t* buff, size_t skip_count,
+                  const mod_iovec_t* iov, size_t iovcnt);
+
 /* Buffer size information */
 size_t lwrb_get_free(const lwrb_t* buff);
 size_t lwrb_get_full(const lwrb_t* buff);
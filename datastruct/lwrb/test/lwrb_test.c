@@ -0,0 +1,101 @@
+// lwrb向量读写回归测试: 帧在任意位置回绕时的writev/readv/peekv,
+// 零长度数据段, 以及空间不足时writev整体拒绝而write部分写入
+// 在工程根目录构建并运行:
+//   gcc -O1 -g -fsanitize=address,undefined -Idatastruct/lwrb/test -I.
+//       -Idatastruct/lwrb -Idebug/minctest datastruct/lwrb/lwrb.c
+//       datastruct/lwrb/test/lwrb_test.c -o lwrb_test
+//   ./lwrb_test
+// 全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_check.h"
+#include "lwrb.h"
+
+#define SIZE 16  // 可用15字节
+
+static uint8_t m_data[SIZE];
+static int m_writes, m_reads;  // 读写事件次数
+
+static void count_evt(lwrb_t* b, lwrb_evt_type_t type, size_t bp) {
+    (void)b;
+    (void)bp;
+    if (type == LWRB_EVT_WRITE) m_writes++;
+    if (type == LWRB_EVT_READ) m_reads++;
+}
+
+// 帧: 头3字节 + 空段 + 数据7字节 + 尾2字节
+static const uint8_t hdr[3] = {0xA5, 0x01, 0x02};
+static const uint8_t body[7] = {0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16};
+static const uint8_t tail[2] = {0xEE, 0xFF};
+static const mod_iovec_t frame[4] = {
+    {(void*)hdr, 3}, {(void*)hdr, 0}, {(void*)body, 7}, {(void*)tail, 2}};
+#define FRAME_LEN 12
+
+static void frame_bytes(uint8_t* out) {
+    memcpy(out, hdr, 3);
+    memcpy(out + 3, body, 7);
+    memcpy(out + 10, tail, 2);
+}
+
+/* 从每个起点写入一帧, 覆盖在各数据段内部及段边界处回绕的情况 */
+static void test_wrap(void) {
+    lwrb_t b;
+    uint8_t expect[FRAME_LEN], out[FRAME_LEN + 8], pad[SIZE] = {0};
+    frame_bytes(expect);
+    for (size_t start = 0; start < SIZE; start++) {
+        CHECK(lwrb_init(&b, m_data, SIZE));
+        lwrb_write(&b, pad, start);
+        lwrb_skip(&b, start);
+        lwrb_set_evt_fn(&b, count_evt);
+        m_writes = m_reads = 0;
+        CHECK(lwrb_writev(&b, frame, 4) == FRAME_LEN);
+        CHECK(m_writes == 1);  // 整帧只更新一次写指针
+        CHECK(lwrb_get_full(&b) == FRAME_LEN);
+
+        memset(out, 0, sizeof(out));
+        mod_iovec_t peek[3] = {{out, 4}, {out, 0}, {out + 4, 10}};
+        CHECK(lwrb_peekv(&b, 2, peek, 3) == FRAME_LEN - 2);
+        CHECK(memcmp(out, expect + 2, FRAME_LEN - 2) == 0);
+        CHECK(lwrb_get_full(&b) == FRAME_LEN);
+
+        memset(out, 0, sizeof(out));
+        mod_iovec_t rd[4] = {{out, 5}, {out, 0}, {out + 5, 5}, {out + 10, 8}};
+        CHECK(lwrb_readv(&b, rd, 4) == FRAME_LEN);  // 最后一段只填入2字节
+        CHECK(m_reads == 1);
+        CHECK(memcmp(out, expect, FRAME_LEN) == 0);
+        CHECK(lwrb_get_full(&b) == 0);
+    }
+}
+
+/* 空间不足: writev不写入任何数据, write写满剩余空间 */
+static void test_full(void) {
+    lwrb_t b;
+    uint8_t pad[SIZE] = {0}, out[SIZE];
+    CHECK(lwrb_init(&b, m_data, SIZE));
+    lwrb_set_evt_fn(&b, count_evt);
+    CHECK(lwrb_write(&b, pad, 10) == 10);
+    m_writes = m_reads = 0;
+    CHECK(lwrb_writev(&b, frame, 4) == 0);
+    CHECK(m_writes == 0 && lwrb_get_full(&b) == 10);
+    CHECK(lwrb_write(&b, pad, FRAME_LEN) == 5);
+    CHECK(lwrb_get_free(&b) == 0);
+    CHECK(lwrb_writev(&b, frame + 3, 1) == 0);
+
+    mod_iovec_t empty[2] = {{out, 0}, {out, 0}};
+    CHECK(lwrb_writev(&b, empty, 2) == 0);  // 全部为空段
+    CHECK(lwrb_readv(&b, empty, 2) == 0);
+    CHECK(lwrb_get_full(&b) == SIZE - 1);
+
+    mod_iovec_t rd[2] = {{out, 8}, {out + 8, 8}};
+    CHECK(lwrb_readv(&b, rd, 2) == SIZE - 1);  // 数据不足时读出全部
+    CHECK(lwrb_readv(&b, rd, 2) == 0);
+    CHECK(lwrb_peekv(&b, 0, rd, 2) == 0);
+}
+
+int main(void) {
+    test_wrap();
+    test_full();
+    return CHECK_RESULT();
+}
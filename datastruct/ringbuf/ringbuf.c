@@ -0,0 +1,175 @@
+/**
+ * @file ringbuf.c
+ * @brief 通用环形缓冲区接口, 统一lwrb/lfbb/lfifo的读写操作
+ * @author EmbeddedModules contributors
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#include "ringbuf.h"
+
+// Private Functions ------------------------
+
+#if MOD_ENABLE_LWRB
+#include "lwrb.h"
+
+static size_t rb_lwrb_write(void* obj, const void* data, size_t len) {
+    return lwrb_write(obj, data, len);
+}
+
+static size_t rb_lwrb_read(void* obj, void* data, size_t len) {
+    return lwrb_read(obj, data, len);
+}
+
+static size_t rb_lwrb_peek(void* obj, size_t offset, void* data, size_t len) {
+    return lwrb_peek(obj, offset, data, len);
+}
+
+static size_t rb_lwrb_writev(void* obj, const mod_iovec_t* iov, size_t cnt) {
+    return lwrb_writev(obj, iov, cnt);
+}
+
+static size_t rb_lwrb_readv(void* obj, const mod_iovec_t* iov, size_t cnt) {
+    return lwrb_readv(obj, iov, cnt);
+}
+
+static size_t rb_lwrb_peekv(void* obj, size_t offset, const mod_iovec_t* iov,
+                            size_t cnt) {
+    return lwrb_peekv(obj, offset, iov, cnt);
+}
+
+static size_t rb_lwrb_get_free(void* obj) {
+    return lwrb_get_free(obj);
+}
+
+static size_t rb_lwrb_get_used(void* obj) {
+    return lwrb_get_full(obj);
+}
+
+const ringbuf_ops_t ringbuf_ops_lwrb = {
+    .write = rb_lwrb_write,
+    .read = rb_lwrb_read,
+    .peek = rb_lwrb_peek,
+    .writev = rb_lwrb_writev,
+    .readv = rb_lwrb_readv,
+    .peekv = rb_lwrb_peekv,
+    .get_free = rb_lwrb_get_free,
+    .get_used = rb_lwrb_get_used,
+};
+#endif  // MOD_ENABLE_LWRB
+
+#if MOD_ENABLE_LFBB
+#include "lfbb.h"
+
+static size_t rb_lfbb_writev(void* obj, const mod_iovec_t* iov, size_t cnt) {
+    return LFBB_WriteV(obj, iov, cnt);
+}
+
+static size_t rb_lfbb_readv(void* obj, const mod_iovec_t* iov, size_t cnt) {
+    return LFBB_ReadV(obj, iov, cnt);
+}
+
+static size_t rb_lfbb_peekv(void* obj, size_t offset, const mod_iovec_t* iov,
+                            size_t cnt) {
+    return LFBB_PeekV(obj, offset, iov, cnt);
+}
+
+static size_t rb_lfbb_write(void* obj, const void* data, size_t len) {
+    mod_iovec_t iov = {(void*)data, len};
+    return LFBB_WriteV(obj, &iov, 1);
+}
+
+static size_t rb_lfbb_read(void* obj, void* data, size_t len) {
+    mod_iovec_t iov = {data, len};
+    return LFBB_ReadV(obj, &iov, 1);
+}
+
+static size_t rb_lfbb_peek(void* obj, size_t offset, void* data, size_t len) {
+    mod_iovec_t iov = {data, len};
+    return LFBB_PeekV(obj, offset, &iov, 1);
+}
+
+static size_t rb_lfbb_get_free(void* obj) {  // 最大的连续空闲区
+    LFBB_Inst_Type* inst = obj;
+    size_t w = MOD_ATOMIC_LOAD(inst->w, MOD_ATOMIC_ORDER_RELAXED);
+    size_t r = MOD_ATOMIC_LOAD(inst->r, MOD_ATOMIC_ORDER_ACQUIRE);
+    if (r > w)
+        return r - w - 1;
+    size_t tail = inst->size - w - (r == 0);  // 不能追上读指针
+    size_t head = r ? r - 1 : 0;
+    return tail > head ? tail : head;
+}
+
+static size_t rb_lfbb_get_used(void* obj) {
+    LFBB_Inst_Type* inst = obj;
+    size_t r = MOD_ATOMIC_LOAD(inst->r, MOD_ATOMIC_ORDER_RELAXED);
+    size_t w = MOD_ATOMIC_LOAD(inst->w, MOD_ATOMIC_ORDER_ACQUIRE);
+    if (r <= w)
+        return w - r;
+    return MOD_ATOMIC_LOAD(inst->i, MOD_ATOMIC_ORDER_RELAXED) - r + w;
+}
+
+const ringbuf_ops_t ringbuf_ops_lfbb = {
+    .write = rb_lfbb_write,
+    .read = rb_lfbb_read,
+    .peek = rb_lfbb_peek,
+    .writev = rb_lfbb_writev,
+    .readv = rb_lfbb_readv,
+    .peekv = rb_lfbb_peekv,
+    .get_free = rb_lfbb_get_free,
+    .get_used = rb_lfbb_get_used,
+};
+#endif  // MOD_ENABLE_LFBB
+
+#if MOD_ENABLE_LFIFO
+#include "lfifo.h"
+
+static size_t rb_lfifo_write(void* obj, const void* data, size_t len) {
+    return LFifo_Write(obj, (uint8_t*)data, len);
+}
+
+static size_t rb_lfifo_read(void* obj, void* data, size_t len) {
+    return LFifo_Read(obj, data, len);
+}
+
+static size_t rb_lfifo_peek(void* obj, size_t offset, void* data,
+                            size_t len) {
+    return LFifo_Peek(obj, offset, data, len);
+}
+
+static size_t rb_lfifo_writev(void* obj, const mod_iovec_t* iov, size_t cnt) {
+    return LFifo_WriteV(obj, iov, cnt);
+}
+
+static size_t rb_lfifo_readv(void* obj, const mod_iovec_t* iov, size_t cnt) {
+    return LFifo_ReadV(obj, iov, cnt);
+}
+
+static size_t rb_lfifo_peekv(void* obj, size_t offset, const mod_iovec_t* iov,
+                             size_t cnt) {
+    return LFifo_PeekV(obj, offset, iov, cnt);
+}
+
+static size_t rb_lfifo_get_free(void* obj) {
+    return LFifo_GetFree(obj);
+}
+
+static size_t rb_lfifo_get_used(void* obj) {
+    return LFifo_GetUsed(obj);
+}
+
+const ringbuf_ops_t ringbuf_ops_lfifo = {
+    .write = rb_lfifo_write,
+    .read = rb_lfifo_read,
+    .peek = rb_lfifo_peek,
+    .writev = rb_lfifo_writev,
+    .readv = rb_lfifo_readv,
+    .peekv = rb_lfifo_peekv,
+    .get_free = rb_lfifo_get_free,
+    .get_used = rb_lfifo_get_used,
+};
+#endif  // MOD_ENABLE_LFIFO
+
+// Source Code End --------------------------
@@ -0,0 +1,119 @@
+/**
+ * @file ringbuf.h
+ * @brief 通用环形缓冲区接口, 统一lwrb/lfbb/lfifo的读写操作
+ * @author EmbeddedModules contributors
+ * @date 2026-10-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#ifndef __RINGBUF_H__
+#define __RINGBUF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "modules.h"
+
+// Public Typedefs --------------------------
+
+typedef struct {  // 缓冲区后端操作
+    size_t (*write)(void* obj, const void* data, size_t len);
+    size_t (*read)(void* obj, void* data, size_t len);
+    size_t (*peek)(void* obj, size_t offset, void* data, size_t len);
+    size_t (*writev)(void* obj, const mod_iovec_t* iov, size_t cnt);
+    size_t (*readv)(void* obj, const mod_iovec_t* iov, size_t cnt);
+    size_t (*peekv)(void* obj, size_t offset, const mod_iovec_t* iov,
+                    size_t cnt);
+    size_t (*get_free)(void* obj);
+    size_t (*get_used)(void* obj);
+} ringbuf_ops_t;
+
+typedef struct {               // 通用环形缓冲区
+    const ringbuf_ops_t* ops;  // 后端操作
+    void* obj;                 // 后端对象(lwrb_t/LFBB_Inst_Type/lfifo_t)
+} ringbuf_t;
+
+// Exported Variables -----------------------
+
+/**
+ * 各后端的写入语义:
+ * lwrb/lfifo: write写入尽可能多的数据, writev全部写入或不写入
+ * lfbb: write与writev均为全部写入或不写入(需要连续空间),
+ *       get_free返回单次可写入的最大长度
+ */
+#if MOD_ENABLE_LWRB
+extern const ringbuf_ops_t ringbuf_ops_lwrb;
+#endif
+#if MOD_ENABLE_LFBB
+extern const ringbuf_ops_t ringbuf_ops_lfbb;
+#endif
+#if MOD_ENABLE_LFIFO
+extern const ringbuf_ops_t ringbuf_ops_lfifo;
+#endif
+
+// Exported Functions -----------------------
+
+/**
+ * @brief 绑定后端对象
+ * @param  rb               通用缓冲区
+ * @param  ops              后端操作(ringbuf_ops_xxx)
+ * @param  obj              已初始化的后端对象
+ */
+static inline void ringbuf_init(ringbuf_t* rb, const ringbuf_ops_t* ops,
+                                void* obj) {
+    rb->ops = ops;
+    rb->obj = obj;
+}
+
+static inline size_t ringbuf_write(ringbuf_t* rb, const void* data,
+                                   size_t len) {
+    return rb->ops->write(rb->obj, data, len);
+}
+
+static inline size_t ringbuf_read(ringbuf_t* rb, void* data, size_t len) {
+    return rb->ops->read(rb->obj, data, len);
+}
+
+static inline size_t ringbuf_peek(ringbuf_t* rb, size_t offset, void* data,
+                                  size_t len) {
+    return rb->ops->peek(rb->obj, offset, data, len);
+}
+
+/**
+ * @brief 将多段数据作为一个整体写入, 只更新一次写指针
+ * @retval size_t           写入的总长度, 空间不足时返回0
+ */
+static inline size_t ringbuf_writev(ringbuf_t* rb, const mod_iovec_t* iov,
+                                    size_t cnt) {
+    return rb->ops->writev(rb->obj, iov, cnt);
+}
+
+/**
+ * @brief 读取数据并依次填入多个数据段, 只更新一次读指针
+ * @retval size_t           实际读取的总长度
+ */
+static inline size_t ringbuf_readv(ringbuf_t* rb, const mod_iovec_t* iov,
+                                   size_t cnt) {
+    return rb->ops->readv(rb->obj, iov, cnt);
+}
+
+static inline size_t ringbuf_peekv(ringbuf_t* rb, size_t offset,
+                                   const mod_iovec_t* iov, size_t cnt) {
+    return rb->ops->peekv(rb->obj, offset, iov, cnt);
+}
+
+static inline size_t ringbuf_get_free(ringbuf_t* rb) {
+    return rb->ops->get_free(rb->obj);
+}
+
+static inline size_t ringbuf_get_used(ringbuf_t* rb) {
+    return rb->ops->get_used(rb->obj);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RINGBUF_H__ */
@@ -0,0 +1,129 @@
+// ringbuf回归测试: 经通用接口对lwrb/lfbb/lfifo三个后端执行相同的操作,
+// 检查帧在任意位置回绕时的writev/readv/peekv, 零长度数据段,
+// 以及空间不足时writev整体拒绝, write按各后端的语义部分写入或拒绝
+// 在工程根目录构建并运行:
+//   gcc -O1 -g -fsanitize=address,undefined -Idatastruct/ringbuf/test -I.
+//       -Idatastruct/ringbuf -Idatastruct/lwrb -Idatastruct/lfbb
+//       -Idatastruct/lfifo -Idebug/minctest datastruct/ringbuf/ringbuf.c
+//       datastruct/lwrb/lwrb.c datastruct/lfbb/lfbb.c datastruct/lfifo/lfifo.c
+//       datastruct/ringbuf/test/ringbuf_test.c -o ringbuf_test
+//   ./ringbuf_test
+// 全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_check.h"
+#include "lfbb.h"
+#include "lfifo.h"
+#include "lwrb.h"
+#include "ringbuf.h"
+
+#define CAP 32  // 各后端的可用容量
+
+static lwrb_t m_lwrb;
+static uint8_t m_lwrb_data[CAP + 1];
+static LFBB_Inst_Type m_lfbb;
+static uint8_t m_lfbb_data[CAP + 1];
+static lfifo_t m_lfifo;
+
+typedef struct {
+    const char* name;
+    ringbuf_t rb;
+    void (*reset)(void);
+    bool partial;  // write在空间不足时写入部分数据
+} backend_t;
+
+static void reset_lwrb(void) {
+    lwrb_init(&m_lwrb, m_lwrb_data, sizeof(m_lwrb_data));
+}
+
+static void reset_lfbb(void) {
+    LFBB_Init(&m_lfbb, m_lfbb_data, sizeof(m_lfbb_data));
+}
+
+static void reset_lfifo(void) {
+    LFifo_Destory(&m_lfifo);
+    LFifo_Init(&m_lfifo, CAP);
+}
+
+static backend_t m_backends[] = {
+    {"lwrb", {&ringbuf_ops_lwrb, &m_lwrb}, reset_lwrb, true},
+    {"lfbb", {&ringbuf_ops_lfbb, &m_lfbb}, reset_lfbb, false},
+    {"lfifo", {&ringbuf_ops_lfifo, &m_lfifo}, reset_lfifo, true},
+};
+
+// 帧: 头3字节 + 空段 + 数据7字节 + 尾2字节
+static const uint8_t hdr[3] = {0xA5, 0x01, 0x02};
+static const uint8_t body[7] = {0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16};
+static const uint8_t tail[2] = {0xEE, 0xFF};
+static const mod_iovec_t frame[4] = {
+    {(void*)hdr, 3}, {(void*)hdr, 0}, {(void*)body, 7}, {(void*)tail, 2}};
+#define FRAME_LEN 12
+
+// 失败时附带后端名称
+#define CHECK_BE(cond)                                                  \
+    do {                                                                \
+        if (!(cond))                                                    \
+            CHECK_FAIL("%s:%d: [%s] CHECK(%s)", __FILE__, __LINE__,     \
+                       be->name, #cond);                                \
+    } while (0)
+
+/* 从每个起点写入一帧并读出 */
+static void test_wrap(backend_t* be) {
+    ringbuf_t* rb = &be->rb;
+    uint8_t expect[FRAME_LEN], out[FRAME_LEN + 8], pad[CAP] = {0};
+    memcpy(expect, hdr, 3);
+    memcpy(expect + 3, body, 7);
+    memcpy(expect + 10, tail, 2);
+    for (size_t start = 0; start < CAP; start++) {
+        be->reset();
+        CHECK_BE(ringbuf_get_free(rb) == CAP);
+        CHECK_BE(ringbuf_write(rb, pad, start) == start);
+        CHECK_BE(ringbuf_read(rb, pad, start) == start);
+        CHECK_BE(ringbuf_writev(rb, frame, 4) == FRAME_LEN);
+        CHECK_BE(ringbuf_get_used(rb) == FRAME_LEN);
+
+        memset(out, 0, sizeof(out));
+        mod_iovec_t peek[3] = {{out, 4}, {out, 0}, {out + 4, 10}};
+        CHECK_BE(ringbuf_peekv(rb, 2, peek, 3) == FRAME_LEN - 2);
+        CHECK_BE(memcmp(out, expect + 2, FRAME_LEN - 2) == 0);
+
+        memset(out, 0, sizeof(out));
+        mod_iovec_t rd[4] = {{out, 5}, {out, 0}, {out + 5, 5}, {out + 10, 8}};
+        CHECK_BE(ringbuf_readv(rb, rd, 4) == FRAME_LEN);
+        CHECK_BE(memcmp(out, expect, FRAME_LEN) == 0);
+        CHECK_BE(ringbuf_get_used(rb) == 0);
+    }
+}
+
+/* 空间不足时writev不写入; write部分写入(lwrb/lfifo)或拒绝(lfbb) */
+static void test_full(backend_t* be) {
+    ringbuf_t* rb = &be->rb;
+    uint8_t pad[CAP] = {0}, out[CAP];
+    be->reset();
+    CHECK_BE(ringbuf_write(rb, pad, CAP - 5) == CAP - 5);
+    CHECK_BE(ringbuf_writev(rb, frame, 4) == 0);
+    CHECK_BE(ringbuf_get_used(rb) == CAP - 5);
+    size_t n = ringbuf_write(rb, pad, FRAME_LEN);
+    CHECK_BE(n == (be->partial ? 5 : 0));
+    CHECK_BE(ringbuf_get_used(rb) == CAP - 5 + n);
+
+    mod_iovec_t empty[2] = {{out, 0}, {out, 0}};
+    CHECK_BE(ringbuf_writev(rb, empty, 2) == 0);
+    CHECK_BE(ringbuf_readv(rb, empty, 2) == 0);
+
+    mod_iovec_t rd[2] = {{out, 20}, {out + 20, CAP - 20}};
+    CHECK_BE(ringbuf_readv(rb, rd, 2) == CAP - 5 + n);
+    CHECK_BE(ringbuf_get_used(rb) == 0);
+    CHECK_BE(ringbuf_readv(rb, rd, 2) == 0);
+}
+
+int main(void) {
+    for (size_t i = 0; i < sizeof(m_backends) / sizeof(m_backends[0]); i++) {
+        test_wrap(&m_backends[i]);
+        test_full(&m_backends[i]);
+    }
+    LFifo_Destory(&m_lfifo);
+    return CHECK_RESULT();
+}
@@ -0,0 +1,228 @@
+/**
+ * @file s2jcodec.h
+ * @brief 基于结构体描述表的JSON编解码, 不经过cJSON, 不申请内存
+ * @author EmbeddedModules contributors
+ * @date 2026-10-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#ifndef __S2JCODEC_H__
+#define __S2JCODEC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "modules.h"
+#if MOD_ENABLE_RINGBUF
+#include "ringbuf.h"
+#endif
+
+// Public Typedefs --------------------------
+
+typedef enum {
+    S2J_KIND_I8,
+    S2J_KIND_I16,
+    S2J_KIND_I32,
+    S2J_KIND_I64,
+    S2J_KIND_U8,
+    S2J_KIND_U16,
+    S2J_KIND_U32,
+    S2J_KIND_U64,
+    S2J_KIND_FLOAT,
+    S2J_KIND_DOUBLE,
+    S2J_KIND_BOOL,
+    S2J_KIND_STRING,  // char[N], 以'\0'结尾或占满N字节
+    S2J_KIND_STRUCT,  // 子结构体, 由sub描述
+} s2j_kind_t;
+
+typedef struct s2j_desc s2j_desc_t;
+
+typedef struct {            // 成员描述
+    const char* key;        // 序列化时的键, 形如"\"name\":"
+    uint8_t klen;           // key的长度
+    uint8_t kind;           // 成员类型(s2j_kind_t)
+    mod_size_t count;       // 数组长度, 0表示单个值
+    mod_size_t offset;      // 成员在结构体中的偏移
+    mod_size_t size;        // 单个元素的大小
+    const s2j_desc_t* sub;  // 子结构体的描述表(S2J_KIND_STRUCT)
+} s2j_field_t;
+
+struct s2j_desc {               // 结构体描述表
+    const s2j_field_t* fields;  // 成员描述(按序列化顺序)
+    mod_size_t nfield;          // 成员个数
+};
+
+/**
+ * @brief 序列化输出回调
+ * @param  ctx              用户上下文
+ * @param  data             数据
+ * @param  len              数据长度
+ * @retval size_t           实际写入的长度, 小于len时中止序列化
+ */
+typedef size_t (*s2j_write_t)(void* ctx, const char* data, size_t len);
+
+// Public Macros ----------------------------
+
+#define __S2J_SIZE_I8 sizeof(int8_t)
+#define __S2J_SIZE_I16 sizeof(int16_t)
+#define __S2J_SIZE_I32 sizeof(int32_t)
+#define __S2J_SIZE_I64 sizeof(int64_t)
+#define __S2J_SIZE_U8 sizeof(uint8_t)
+#define __S2J_SIZE_U16 sizeof(uint16_t)
+#define __S2J_SIZE_U32 sizeof(uint32_t)
+#define __S2J_SIZE_U64 sizeof(uint64_t)
+#define __S2J_SIZE_FLOAT sizeof(float)
+#define __S2J_SIZE_DOUBLE sizeof(double)
+#define __S2J_SIZE_BOOL sizeof(bool)
+#define __S2J_SIZE_STRING 0
+
+#define __S2J_MEMBER(type, member) (((type*)0)->member)
+#define __S2J_KEY(member) "\"" #member "\":"
+// 编译期检查成员大小与声明的类型是否一致, 不一致时数组长度为负而报错
+#define __S2J_CHECKED_SIZE(kind, msize)                                   \
+    ((msize) + 0 * sizeof(char[(__S2J_SIZE_##kind == 0 ||                 \
+                                (msize) == __S2J_SIZE_##kind)             \
+                                   ? 1                                    \
+                                   : -1]))
+#define __S2J_ENTRY(type, member, kind_, count_, size_, sub_)   \
+    {                                                           \
+        .key = __S2J_KEY(member),                               \
+        .klen = sizeof(__S2J_KEY(member)) - 1,                  \
+        .kind = S2J_KIND_##kind_,                               \
+        .count = (count_),                                      \
+        .offset = offsetof(type, member),                       \
+        .size = (size_),                                        \
+        .sub = (sub_),                                          \
+    }
+
+/**
+ * @brief 描述一个基本类型或字符串成员
+ * @param  type             结构体类型
+ * @param  member           成员名, 同时作为JSON的键
+ * @param  kind             成员类型(s2j_kind_t去掉S2J_KIND_前缀)
+ */
+#define S2J_FIELD(type, member, kind)                                        \
+    __S2J_ENTRY(type, member, kind, 0,                                       \
+                __S2J_CHECKED_SIZE(kind, sizeof(__S2J_MEMBER(type, member))), \
+                NULL)
+
+/**
+ * @brief 描述一个定长数组成员(字符串数组为char[M][N])
+ */
+#define S2J_ARRAY(type, member, kind)                                   \
+    __S2J_ENTRY(type, member, kind,                                     \
+                sizeof(__S2J_MEMBER(type, member)) /                    \
+                    sizeof(__S2J_MEMBER(type, member)[0]),              \
+                __S2J_CHECKED_SIZE(                                     \
+                    kind, sizeof(__S2J_MEMBER(type, member)[0])),       \
+                NULL)
+
+/**
+ * @brief 描述一个子结构体成员
+ * @param  desc             子结构体的描述表(需先声明)
+ */
+#define S2J_STRUCT(type, member, desc)                                       \
+    __S2J_ENTRY(type, member, STRUCT, 0, sizeof(__S2J_MEMBER(type, member)), \
+                &(desc))
+
+/**
+ * @brief 描述一个子结构体数组成员
+ */
+#define S2J_STRUCT_ARRAY(type, member, desc)                 \
+    __S2J_ENTRY(type, member, STRUCT,                        \
+                sizeof(__S2J_MEMBER(type, member)) /         \
+                    sizeof(__S2J_MEMBER(type, member)[0]),   \
+                sizeof(__S2J_MEMBER(type, member)[0]), &(desc))
+
+/**
+ * @brief 定义结构体描述表, 成员使用S2J_FIELD等宏描述
+ * @note 描述表在编译期生成, 存放在只读区
+ * @code
+ * S2J_DESC_DEFINE(student_desc,
+ *                 S2J_FIELD(Student, id, U8),
+ *                 S2J_ARRAY(Student, score, U8),
+ *                 S2J_FIELD(Student, name, STRING),
+ *                 S2J_STRUCT(Student, hometown, hometown_desc));
+ * @endcode
+ */
+#define S2J_DESC_DEFINE(name, ...)                                      \
+    static const s2j_field_t __s2j_fields_##name[] = {__VA_ARGS__};     \
+    const s2j_desc_t name = {                                           \
+        __s2j_fields_##name,                                            \
+        sizeof(__s2j_fields_##name) / sizeof(__s2j_fields_##name[0]), \
+    }
+
+/**
+ * @brief 声明在其他文件中定义的描述表
+ */
+#define S2J_DESC_DECLARE(name) extern const s2j_desc_t name
+
+// Exported Functions -----------------------
+
+/**
+ * @brief 将结构体序列化为紧凑的JSON字符串
+ * @param  desc             结构体描述表
+ * @param  obj              结构体指针
+ * @param  buf              输出缓冲区(可为NULL, 仅计算长度)
+ * @param  size             缓冲区大小
+ * @retval size_t           完整结果的长度(不含'\0')
+ * @note 与snprintf相同, 返回值不小于size时结果被截断, 结果总以'\0'结尾
+ * @note 非有限的浮点数输出为null
+ */
+extern size_t s2j_dump(const s2j_desc_t* desc, const void* obj, char* buf,
+                       size_t size);
+
+/**
+ * @brief 将结构体序列化并分段交给回调输出
+ * @param  desc             结构体描述表
+ * @param  obj              结构体指针
+ * @param  write            输出回调
+ * @param  ctx              回调的上下文
+ * @retval size_t           输出的总长度, 回调写入不完整时返回0
+ * @note 使用栈上的小缓冲区分段输出, 不需要容纳整个结果的缓冲区
+ */
+extern size_t s2j_dump_to(const s2j_desc_t* desc, const void* obj,
+                          s2j_write_t write, void* ctx);
+
+#if MOD_ENABLE_RINGBUF
+/**
+ * @brief 将结构体序列化后写入环形缓冲区
+ * @param  desc             结构体描述表
+ * @param  obj              结构体指针
+ * @param  rb               通用环形缓冲区
+ * @retval size_t           写入的长度, 空间不足时返回0且不写入任何数据
+ * @note 先计算长度再写入, 因此会格式化两次
+ * @note 消息分多次ringbuf_write写入(每次至多64字节), 不是原子操作:
+ *       同一缓冲区只能有一个生产者, 消费者可能先读到消息的前一部分,
+ *       需要按完整消息定界(长度前缀/分隔符)后再处理.
+ *       多个生产者时应先用s2j_dump写入局部缓冲区, 再以一次ringbuf_writev
+ *       写入(lfifo多生产者模式下writev全部写入或不写入)
+ */
+extern size_t s2j_dump_ringbuf(const s2j_desc_t* desc, const void* obj,
+                               ringbuf_t* rb);
+#endif
+
+/**
+ * @brief 将JSON对象直接解析到结构体中
+ * @param  desc             结构体描述表
+ * @param  obj              结构体指针
+ * @param  json             JSON字符串
+ * @param  len              JSON字符串长度
+ * @retval bool             顶层是否为JSON对象
+ * @note JSON中缺少的成员和类型不符的值保持原值不变, 多余的键被忽略
+ * @note 整数超出成员范围时取边界值, 字符串超长时截断并以'\0'结尾,
+ *       数组元素多于成员长度时忽略多余的部分
+ * @note 不校验输入, 不可信的输入请先使用json_validn
+ */
+extern bool s2j_load(const s2j_desc_t* desc, void* obj, const char* json,
+                     size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __S2JCODEC_H__ */
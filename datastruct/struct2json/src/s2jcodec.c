@@ -0,0 +1,544 @@
+/**
+ * @file s2jcodec.c
+ * @brief 基于结构体描述表的JSON编解码, 不经过cJSON, 不申请内存
+ * @author EmbeddedModules contributors
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#include "s2jcodec.h"
+
+#if S2J_CFG_ENABLE_CODEC
+
+#include <string.h>
+
+#include "json.h"
+
+// Private Defines --------------------------
+
+#define S2J_STAGE_SIZE 64  // s2j_dump_to使用的栈上缓冲区大小
+
+// Private Typedefs -------------------------
+
+typedef struct {
+    char* buf;          // 输出缓冲区
+    size_t cap;         // 缓冲区可用长度
+    size_t pos;         // 缓冲区中待输出的长度
+    size_t total;       // 序列化结果的总长度
+    s2j_write_t write;  // 输出回调, NULL时写满后只计算长度
+    void* ctx;          // 回调的上下文
+    bool fail;          // 回调写入不完整
+} s2j_out_t;
+
+// Private Variables ------------------------
+
+static const double p10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                             1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                             1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Private Functions ------------------------
+
+static void out_put_slow(s2j_out_t* out, const char* s, size_t n) {
+    out->total += n;
+    while (n) {
+        if (out->pos == out->cap) {
+            if (out->write == NULL)
+                return;
+            if (!out->fail && out->write(out->ctx, out->buf, out->pos) !=
+                                  out->pos)
+                out->fail = true;
+            out->pos = 0;
+        }
+        size_t k = out->cap - out->pos;
+        if (k > n)
+            k = n;
+        memcpy(out->buf + out->pos, s, k);
+        out->pos += k;
+        s += k;
+        n -= k;
+    }
+}
+
+static inline void out_put(s2j_out_t* out, const char* s, size_t n) {
+    if (out->pos + n <= out->cap) {
+        memcpy(out->buf + out->pos, s, n);
+        out->pos += n;
+        out->total += n;
+    } else {
+        out_put_slow(out, s, n);
+    }
+}
+
+static inline void out_char(s2j_out_t* out, char c) {
+    if (out->pos < out->cap) {
+        out->buf[out->pos++] = c;
+        out->total++;
+    } else {
+        out_put_slow(out, &c, 1);
+    }
+}
+
+static void out_uint(s2j_out_t* out, uint64_t v, bool neg) {
+    char tmp[21];
+    char* p = tmp + sizeof(tmp);
+    do {
+        *--p = '0' + v % 10;
+        v /= 10;
+    } while (v);
+    if (neg)
+        *--p = '-';
+    out_put(out, p, tmp + sizeof(tmp) - p);
+}
+
+static inline void out_int(s2j_out_t* out, int64_t v) {
+    if (v < 0)
+        out_uint(out, -(uint64_t)v, true);
+    else
+        out_uint(out, v, false);
+}
+
+/**
+ * @brief 以最少的小数位输出定点小数, 要求解析后能还原为同一个值
+ * @note m与10^k都能精确表示, m/10^k经过一次舍入, 结果与strtod解析
+ *       对应十进制数的结果相同, 因此比较相等即可确认能还原
+ * @retval bool             失败时(数值过大/过小)需改用printf
+ */
+static bool out_fixed(s2j_out_t* out, double v, bool single) {
+    for (int k = 1; k <= 15; k++) {
+        double x = v * p10[k];
+        if (x <= -1e15 || x >= 1e15)
+            return false;
+        int64_t m = (int64_t)(x < 0 ? x - 0.5 : x + 0.5);
+        double y = (double)m / p10[k];
+        if (single ? (float)y != (float)v : y != v)
+            continue;
+        char tmp[24];
+        char* p = tmp + sizeof(tmp);
+        uint64_t u = m < 0 ? -(uint64_t)m : (uint64_t)m;
+        for (int i = 0; i < k; i++, u /= 10)
+            *--p = '0' + u % 10;
+        *--p = '.';
+        do {
+            *--p = '0' + u % 10;
+            u /= 10;
+        } while (u);
+        if (m < 0)
+            *--p = '-';
+        out_put(out, p, tmp + sizeof(tmp) - p);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 输出浮点数, 常见的整数和短小数不经过printf,
+ *        其余与cJSON相同先尝试较短的精度, 无法还原时使用完整精度
+ */
+static void out_real(s2j_out_t* out, double v, bool single) {
+    char tmp[32];
+    int n;
+    if (v != v || v - v != 0) {  // NaN/Inf在JSON中没有表示
+        out_put(out, "null", 4);
+        return;
+    }
+    if (v > -1e15 && v < 1e15 && v == (double)(int64_t)v && v != 0) {
+        out_int(out, (int64_t)v);
+        return;
+    }
+    if (out_fixed(out, v, single))
+        return;
+    if (single) {
+        n = snprintf(tmp, sizeof(tmp), "%.7g", v);
+        if ((float)strtod(tmp, NULL) != (float)v)
+            n = snprintf(tmp, sizeof(tmp), "%.9g", v);
+    } else {
+        n = snprintf(tmp, sizeof(tmp), "%.15g", v);
+        if (strtod(tmp, NULL) != v)
+            n = snprintf(tmp, sizeof(tmp), "%.17g", v);
+    }
+    out_put(out, tmp, n);
+}
+
+static void out_string(s2j_out_t* out, const char* s, size_t cap) {
+    static const char hex[] = "0123456789abcdef";
+    size_t len = strnlen(s, cap);
+    size_t run = 0;  // 尚未输出的无需转义的字符起点
+    out_char(out, '"');
+    for (size_t i = 0; i < len; i++) {
+        uint8_t c = (uint8_t)s[i];
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        out_put(out, s + run, i - run);
+        run = i + 1;
+        char esc[6] = {'\\', (char)c};
+        switch (c) {
+            case '"':
+            case '\\':
+                break;
+            case '\b':
+                esc[1] = 'b';
+                break;
+            case '\f':
+                esc[1] = 'f';
+                break;
+            case '\n':
+                esc[1] = 'n';
+                break;
+            case '\r':
+                esc[1] = 'r';
+                break;
+            case '\t':
+                esc[1] = 't';
+                break;
+            default:
+                memcpy(esc + 1, "u00", 3);
+                esc[4] = hex[c >> 4];
+                esc[5] = hex[c & 0xf];
+                out_put(out, esc, 6);
+                continue;
+        }
+        out_put(out, esc, 2);
+    }
+    out_put(out, s + run, len - run);
+    out_char(out, '"');
+}
+
+static void dump_object(s2j_out_t* out, const s2j_desc_t* desc,
+                        const uint8_t* base);
+
+static void dump_value(s2j_out_t* out, const s2j_field_t* f,
+                       const uint8_t* p) {
+    switch (f->kind) {
+        case S2J_KIND_I8:
+            out_int(out, *(const int8_t*)p);
+            break;
+        case S2J_KIND_I16:
+            out_int(out, *(const int16_t*)p);
+            break;
+        case S2J_KIND_I32:
+            out_int(out, *(const int32_t*)p);
+            break;
+        case S2J_KIND_I64:
+            out_int(out, *(const int64_t*)p);
+            break;
+        case S2J_KIND_U8:
+            out_uint(out, *(const uint8_t*)p, false);
+            break;
+        case S2J_KIND_U16:
+            out_uint(out, *(const uint16_t*)p, false);
+            break;
+        case S2J_KIND_U32:
+            out_uint(out, *(const uint32_t*)p, false);
+            break;
+        case S2J_KIND_U64:
+            out_uint(out, *(const uint64_t*)p, false);
+            break;
+        case S2J_KIND_FLOAT:
+            out_real(out, *(const float*)p, true);
+            break;
+        case S2J_KIND_DOUBLE:
+            out_real(out, *(const double*)p, false);
+            break;
+        case S2J_KIND_BOOL:
+            if (*(const bool*)p)
+                out_put(out, "true", 4);
+            else
+                out_put(out, "false", 5);
+            break;
+        case S2J_KIND_STRING:
+            out_string(out, (const char*)p, f->size);
+            break;
+        case S2J_KIND_STRUCT:
+            dump_object(out, f->sub, p);
+            break;
+    }
+}
+
+static void dump_object(s2j_out_t* out, const s2j_desc_t* desc,
+                        const uint8_t* base) {
+    out_char(out, '{');
+    for (mod_size_t i = 0; i < desc->nfield; i++) {
+        const s2j_field_t* f = &desc->fields[i];
+        const uint8_t* p = base + f->offset;
+        if (i)
+            out_char(out, ',');
+        out_put(out, f->key, f->klen);
+        if (f->count == 0) {
+            dump_value(out, f, p);
+            continue;
+        }
+        out_char(out, '[');
+        for (mod_size_t j = 0; j < f->count; j++, p += f->size) {
+            if (j)
+                out_char(out, ',');
+            dump_value(out, f, p);
+        }
+        out_char(out, ']');
+    }
+    out_char(out, '}');
+}
+
+/**
+ * @brief 按键名查找成员, 从上一次匹配的下一个成员开始,
+ *        因此按描述表顺序排列的JSON每个键只需比较一次
+ */
+static const s2j_field_t* find_field(const s2j_desc_t* desc, struct json key,
+                                     mod_size_t* hint) {
+    const char* raw = json_raw(key) + 1;
+    size_t rlen = json_raw_length(key);
+    bool esc = json_string_is_escaped(key);
+    rlen = rlen < 2 ? 0 : rlen - 2;
+    mod_size_t i = *hint;
+    for (mod_size_t n = 0; n < desc->nfield; n++, i++) {
+        if (i == desc->nfield)
+            i = 0;
+        const s2j_field_t* f = &desc->fields[i];
+        const char* name = f->key + 1;  // 跳过'"', 末尾的'":'不参与比较
+        size_t nlen = f->klen - 3;
+        if (esc ? json_string_comparen(key, name, nlen) == 0
+                : (rlen == nlen && memcmp(raw, name, nlen) == 0)) {
+            *hint = i + 1 == desc->nfield ? 0 : i + 1;
+            return f;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 将JSON数字拆分为m*10^e, 有效数字超过19位或格式不符时返回false
+ */
+static bool scan_number(struct json val, uint64_t* m, int* e, bool* neg) {
+    const char* s = json_raw(val);
+    size_t len = json_raw_length(val);
+    size_t i = 0;
+    uint64_t x = 0;
+    int digits = 0, exp = 0;
+    *neg = len && s[0] == '-';
+    if (*neg)
+        i++;
+    for (bool frac = false; i < len; i++) {
+        if (s[i] == '.' && !frac) {
+            frac = true;
+            continue;
+        }
+        if (s[i] < '0' || s[i] > '9')
+            break;
+        if (digits == 19)
+            return false;
+        x = x * 10 + (s[i] - '0');
+        if (x)
+            digits++;
+        if (frac)
+            exp--;
+    }
+    if (i < len && (s[i] | 0x20) == 'e') {
+        bool eneg = ++i < len && s[i] == '-';
+        int ev = 0;
+        if (i < len && (s[i] == '-' || s[i] == '+'))
+            i++;
+        for (; i < len && s[i] >= '0' && s[i] <= '9'; i++) {
+            if (ev < 10000)
+                ev = ev * 10 + (s[i] - '0');
+        }
+        exp += eneg ? -ev : ev;
+    }
+    *m = x;
+    *e = exp;
+    return i == len && len;
+}
+
+/**
+ * @brief 读取JSON数字, 常见的短数字直接计算, 其余交给json库
+ */
+static int64_t load_int(struct json val) {
+    uint64_t m;
+    int e;
+    bool neg;
+    if (scan_number(val, &m, &e, &neg) && e == 0 && m <= INT64_MAX)
+        return neg ? -(int64_t)m : (int64_t)m;
+    return json_int64(val);
+}
+
+static uint64_t load_uint(struct json val) {
+    uint64_t m;
+    int e;
+    bool neg;
+    if (scan_number(val, &m, &e, &neg) && e == 0 && !neg)
+        return m;
+    return json_uint64(val);
+}
+
+static double load_real(struct json val) {
+    uint64_t m;
+    int e;
+    bool neg;
+    // m与10^|e|都能精确表示时, 一次乘除即得到正确舍入的结果
+    if (scan_number(val, &m, &e, &neg) && m < (1ull << 53) && e >= -22 &&
+        e <= 22) {
+        double d = e < 0 ? (double)m / p10[-e] : (double)m * p10[e];
+        return neg ? -d : d;
+    }
+    return json_double(val);
+}
+
+static void load_object(const s2j_desc_t* desc, uint8_t* base,
+                        struct json obj);
+
+static void load_value(const s2j_field_t* f, uint8_t* p, struct json val) {
+    enum json_type type = json_type(val);
+    if (f->kind <= S2J_KIND_I64) {
+        if (type != JSON_NUMBER)
+            return;
+        int64_t x = load_int(val);
+        int64_t max = (int64_t)(UINT64_MAX >> (65 - f->size * 8));
+        if (x > max)
+            x = max;
+        else if (x < -max - 1)
+            x = -max - 1;
+        switch (f->kind) {
+            case S2J_KIND_I8:
+                *(int8_t*)p = x;
+                break;
+            case S2J_KIND_I16:
+                *(int16_t*)p = x;
+                break;
+            case S2J_KIND_I32:
+                *(int32_t*)p = x;
+                break;
+            default:
+                *(int64_t*)p = x;
+                break;
+        }
+        return;
+    }
+    if (f->kind <= S2J_KIND_U64) {
+        if (type != JSON_NUMBER)
+            return;
+        uint64_t x = load_uint(val);
+        uint64_t max = UINT64_MAX >> (64 - f->size * 8);
+        if (x > max)
+            x = max;
+        switch (f->kind) {
+            case S2J_KIND_U8:
+                *(uint8_t*)p = x;
+                break;
+            case S2J_KIND_U16:
+                *(uint16_t*)p = x;
+                break;
+            case S2J_KIND_U32:
+                *(uint32_t*)p = x;
+                break;
+            default:
+                *(uint64_t*)p = x;
+                break;
+        }
+        return;
+    }
+    switch (f->kind) {
+        case S2J_KIND_FLOAT:
+            if (type == JSON_NUMBER)
+                *(float*)p = load_real(val);
+            break;
+        case S2J_KIND_DOUBLE:
+            if (type == JSON_NUMBER)
+                *(double*)p = load_real(val);
+            break;
+        case S2J_KIND_BOOL:
+            if (type == JSON_TRUE || type == JSON_FALSE)
+                *(bool*)p = type == JSON_TRUE;
+            break;
+        case S2J_KIND_STRING:
+            if (type == JSON_STRING)
+                json_string_copy(val, (char*)p, f->size);
+            break;
+        case S2J_KIND_STRUCT:
+            if (type == JSON_OBJECT)
+                load_object(f->sub, p, val);
+            break;
+    }
+}
+
+static void load_object(const s2j_desc_t* desc, uint8_t* base,
+                        struct json obj) {
+    mod_size_t hint = 0;
+    struct json key = json_first(obj);
+    while (json_exists(key)) {
+        struct json val = json_next(key);
+        const s2j_field_t* f = find_field(desc, key, &hint);
+        key = json_next(val);
+        if (f == NULL)
+            continue;
+        uint8_t* p = base + f->offset;
+        if (f->count == 0) {
+            load_value(f, p, val);
+            continue;
+        }
+        if (json_type(val) != JSON_ARRAY)
+            continue;
+        struct json item = json_first(val);
+        for (mod_size_t j = 0; j < f->count && json_exists(item);
+             j++, p += f->size) {
+            load_value(f, p, item);
+            item = json_next(item);
+        }
+    }
+}
+
+// Public Functions -------------------------
+
+size_t s2j_dump(const s2j_desc_t* desc, const void* obj, char* buf,
+                size_t size) {
+    char dummy;
+    s2j_out_t out = {.buf = &dummy};  // 只计算长度
+    if (buf != NULL && size) {
+        out.buf = buf;
+        out.cap = size - 1;
+    }
+    dump_object(&out, desc, obj);
+    out.buf[out.pos] = '\0';
+    return out.total;
+}
+
+size_t s2j_dump_to(const s2j_desc_t* desc, const void* obj,
+                   s2j_write_t write, void* ctx) {
+    char stage[S2J_STAGE_SIZE];
+    s2j_out_t out = {
+        .buf = stage,
+        .cap = sizeof(stage),
+        .write = write,
+        .ctx = ctx,
+    };
+    dump_object(&out, desc, obj);
+    if (out.pos && !out.fail && write(ctx, stage, out.pos) != out.pos)
+        out.fail = true;
+    return out.fail ? 0 : out.total;
+}
+
+#if MOD_ENABLE_RINGBUF
+static size_t ringbuf_write_cb(void* ctx, const char* data, size_t len) {
+    return ringbuf_write((ringbuf_t*)ctx, data, len);
+}
+
+// 分段写入, 只适用于单生产者, 见头文件说明
+size_t s2j_dump_ringbuf(const s2j_desc_t* desc, const void* obj,
+                        ringbuf_t* rb) {
+    if (ringbuf_get_free(rb) < s2j_dump(desc, obj, NULL, 0))
+        return 0;
+    return s2j_dump_to(desc, obj, ringbuf_write_cb, rb);
+}
+#endif
+
+bool s2j_load(const s2j_desc_t* desc, void* obj, const char* json,
+              size_t len) {
+    struct json root = json_parsen(json, len);
+    if (json_type(root) != JSON_OBJECT)
+        return false;
+    load_object(desc, obj, root);
+    return true;
+}
+
+#endif  // S2J_CFG_ENABLE_CODEC
+
+// Source Code End --------------------------
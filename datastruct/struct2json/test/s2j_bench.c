@@ -0,0 +1,207 @@
+// struct2json基准测试, 比较经过cJSON的宏接口(s2j.h)与描述表编解码
+// (s2jcodec.h)序列化/反序列化一条遥测消息的耗时与内存申请次数
+// 在工程根目录构建并运行:
+//   gcc -O2 -Idatastruct/struct2json/test -I. -Idatastruct/struct2json/inc
+//       -Idatastruct/json -Idatastruct/ringbuf datastruct/struct2json/src/s2j.c
+//       datastruct/struct2json/src/s2jcodec.c
+//       datastruct/struct2json/src/cJSON.c datastruct/json/json.c
+//       datastruct/struct2json/test/s2j_bench.c -lm -o s2j_bench
+//   ./s2j_bench [每轮消息数]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "s2j.h"
+#include "s2jcodec.h"
+
+#define BENCH_MSGS 200000
+#define BENCH_ROUNDS 3  // 取最好的一轮
+
+typedef struct {
+    double lat, lon;
+    float alt, speed;
+    uint8_t sats;
+    bool fix;
+} Gps;
+
+typedef struct {
+    float v, i, temp;
+    uint8_t soc;
+} Batt;
+
+typedef struct {
+    uint32_t seq;
+    uint32_t uptime;
+    char dev[16];
+    char fw[12];
+    Gps gps;
+    Batt batt;
+    int16_t rssi;
+    float imu[6];
+    uint16_t adc[8];
+    int err;
+} Tele;
+
+S2J_DESC_DEFINE(gps_desc, S2J_FIELD(Gps, lat, DOUBLE),
+                S2J_FIELD(Gps, lon, DOUBLE), S2J_FIELD(Gps, alt, FLOAT),
+                S2J_FIELD(Gps, speed, FLOAT), S2J_FIELD(Gps, sats, U8),
+                S2J_FIELD(Gps, fix, BOOL));
+S2J_DESC_DEFINE(batt_desc, S2J_FIELD(Batt, v, FLOAT),
+                S2J_FIELD(Batt, i, FLOAT), S2J_FIELD(Batt, temp, FLOAT),
+                S2J_FIELD(Batt, soc, U8));
+S2J_DESC_DEFINE(tele_desc, S2J_FIELD(Tele, seq, U32),
+                S2J_FIELD(Tele, uptime, U32), S2J_FIELD(Tele, dev, STRING),
+                S2J_FIELD(Tele, fw, STRING), S2J_STRUCT(Tele, gps, gps_desc),
+                S2J_STRUCT(Tele, batt, batt_desc), S2J_FIELD(Tele, rssi, I16),
+                S2J_ARRAY(Tele, imu, FLOAT), S2J_ARRAY(Tele, adc, U16),
+                S2J_FIELD(Tele, err, I32));
+
+static size_t m_allocs;
+
+static void* count_malloc(size_t size) {
+    m_allocs++;
+    return malloc(size);
+}
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static cJSON* cjson_from(Tele* t) {
+    s2j_create_json_obj(j);
+    s2j_json_set_basic_element(j, t, int, seq);
+    s2j_json_set_basic_element(j, t, int, uptime);
+    s2j_json_set_basic_element(j, t, string, dev);
+    s2j_json_set_basic_element(j, t, string, fw);
+    s2j_json_set_struct_element(jg, j, g, t, Gps, gps);
+    s2j_json_set_basic_element(jg, g, double, lat);
+    s2j_json_set_basic_element(jg, g, double, lon);
+    s2j_json_set_basic_element(jg, g, double, alt);
+    s2j_json_set_basic_element(jg, g, double, speed);
+    s2j_json_set_basic_element(jg, g, int, sats);
+    s2j_json_set_basic_element(jg, g, int, fix);
+    s2j_json_set_struct_element(jb, j, b, t, Batt, batt);
+    s2j_json_set_basic_element(jb, b, double, v);
+    s2j_json_set_basic_element(jb, b, double, i);
+    s2j_json_set_basic_element(jb, b, double, temp);
+    s2j_json_set_basic_element(jb, b, int, soc);
+    s2j_json_set_basic_element(j, t, int, rssi);
+    s2j_json_set_array_element(j, t, double, imu, 6);
+    s2j_json_set_array_element(j, t, int, adc, 8);
+    s2j_json_set_basic_element(j, t, int, err);
+    return j;
+}
+
+static Tele* cjson_to(cJSON* j) {
+    s2j_create_struct_obj(t, Tele);
+    s2j_struct_get_basic_element(t, j, int, seq);
+    s2j_struct_get_basic_element(t, j, int, uptime);
+    s2j_struct_get_basic_element(t, j, string, dev);
+    s2j_struct_get_basic_element(t, j, string, fw);
+    s2j_struct_get_struct_element(g, t, jg, j, Gps, gps);
+    s2j_struct_get_basic_element(g, jg, double, lat);
+    s2j_struct_get_basic_element(g, jg, double, lon);
+    s2j_struct_get_basic_element(g, jg, double, alt);
+    s2j_struct_get_basic_element(g, jg, double, speed);
+    s2j_struct_get_basic_element(g, jg, int, sats);
+    s2j_struct_get_basic_element(g, jg, int, fix);
+    s2j_struct_get_struct_element(b, t, jb, j, Batt, batt);
+    s2j_struct_get_basic_element(b, jb, double, v);
+    s2j_struct_get_basic_element(b, jb, double, i);
+    s2j_struct_get_basic_element(b, jb, double, temp);
+    s2j_struct_get_basic_element(b, jb, int, soc);
+    s2j_struct_get_basic_element(t, j, int, rssi);
+    s2j_struct_get_array_element(t, j, double, imu);
+    s2j_struct_get_array_element(t, j, int, adc);
+    s2j_struct_get_basic_element(t, j, int, err);
+    return t;
+}
+
+static void min_ns(uint64_t* best, uint64_t start) {
+    uint64_t ns = host_ns() - start;
+    if (*best == 0 || ns < *best)
+        *best = ns;
+}
+
+int main(int argc, char* argv[]) {
+    S2jHook hook = {count_malloc, free};
+    Tele t = {
+        .seq = 123456,
+        .uptime = 987654,
+        .dev = "node-07",
+        .fw = "1.4.2",
+        .gps = {31.2304, 121.4737, 12.5f, 3.25f, 9, true},
+        .batt = {3.92f, -0.125f, 36.5f, 87},
+        .rssi = -71,
+        .imu = {0.01f, -0.02f, 9.81f, 0.5f, -0.25f, 0.125f},
+        .adc = {1023, 2048, 4095, 0, 17, 333, 1200, 3999},
+        .err = 0,
+    };
+    int msgs = argc > 1 ? atoi(argv[1]) : BENCH_MSGS;
+    if (msgs <= 0)
+        msgs = BENCH_MSGS;
+    char buf[512], out[512];
+    volatile size_t acc = 0;
+    s2j_init(&hook);
+
+    cJSON* j = cjson_from(&t);
+    char* s = cJSON_PrintUnformatted(j);
+    printf("cjson:  %s\n", s);
+    free(s);
+    cJSON_Delete(j);
+    size_t allocs_dump = m_allocs;
+    size_t len = s2j_dump(&tele_desc, &t, buf, sizeof(buf));
+    printf("codec:  %s\n", buf);
+    m_allocs = 0;
+    j = cJSON_Parse(buf);
+    free(cjson_to(j));
+    cJSON_Delete(j);
+    printf("allocations per message: cjson dump %zu, load %zu, codec 0\n",
+           allocs_dump, m_allocs);
+
+    uint64_t dump_cj = 0, dump_codec = 0, load_cj = 0, load_codec = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        uint64_t start = host_ns();
+        for (int i = 0; i < msgs; i++) {
+            t.seq = i;
+            j = cjson_from(&t);
+            s = cJSON_PrintUnformatted(j);
+            acc += strlen(s);
+            free(s);
+            cJSON_Delete(j);
+        }
+        min_ns(&dump_cj, start);
+        start = host_ns();
+        for (int i = 0; i < msgs; i++) {
+            t.seq = i;
+            acc += s2j_dump(&tele_desc, &t, out, sizeof(out));
+        }
+        min_ns(&dump_codec, start);
+        start = host_ns();
+        for (int i = 0; i < msgs; i++) {
+            j = cJSON_Parse(buf);
+            Tele* p = cjson_to(j);
+            acc += p->seq;
+            free(p);
+            cJSON_Delete(j);
+        }
+        min_ns(&load_cj, start);
+        start = host_ns();
+        for (int i = 0; i < msgs; i++) {
+            Tele l = {0};
+            s2j_load(&tele_desc, &l, buf, len);
+            acc += l.seq;
+        }
+        min_ns(&load_codec, start);
+    }
+    printf("dump  cjson %7.3f us  codec %7.3f us (x%.1f)\n",
+           dump_cj / 1000.0 / msgs, dump_codec / 1000.0 / msgs,
+           (double)dump_cj / dump_codec);
+    printf("load  cjson %7.3f us  codec %7.3f us (x%.1f)\n",
+           load_cj / 1000.0 / msgs, load_codec / 1000.0 / msgs,
+           (double)load_cj / load_codec);
+    return 0;
+}
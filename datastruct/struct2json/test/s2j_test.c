@@ -0,0 +1,365 @@
+// s2jcodec回归测试: 随机结构体序列化后与cJSON/json模块交叉检查并还原,
+// 截断/回调/环形缓冲区输出, 解析时的容错与数值扫描(与strtod比较)
+// 在工程根目录构建并运行:
+//   gcc -O1 -g -fsanitize=address,undefined -Idatastruct/struct2json/test -I.
+//       -Idatastruct/struct2json/inc -Idatastruct/json -Idatastruct/ringbuf
+//       -Idatastruct/lwrb -Idebug/minctest
+//       datastruct/struct2json/src/s2jcodec.c
+//       datastruct/struct2json/src/cJSON.c datastruct/json/json.c
+//       datastruct/ringbuf/ringbuf.c datastruct/lwrb/lwrb.c
+//       datastruct/struct2json/test/s2j_test.c -lm -o s2j_test
+//   ./s2j_test
+// 全部通过时返回0
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "host_check.h"
+#include "json.h"
+#include "lwrb.h"
+#include "ringbuf.h"
+#include "s2jcodec.h"
+
+#define TEST_ROUNDS 20000
+#define TEST_NUMBERS 300000
+
+typedef struct {
+    char name[16];
+    int16_t code;
+} Hometown;
+
+typedef struct {
+    double x, y;
+    float acc;
+    bool fix;
+} Pos;
+
+typedef struct {
+    uint8_t id;
+    uint8_t score[8];
+    char name[10];
+    double weight;
+    Hometown hometown;
+    int8_t i8;
+    int32_t i32;
+    int64_t i64;
+    uint16_t u16;
+    uint32_t u32;
+    uint64_t u64;
+    float f;
+    bool ok;
+    char tags[3][6];
+    Pos track[3];
+    int32_t vals[4];
+} Student;
+
+S2J_DESC_DEFINE(hometown_desc, S2J_FIELD(Hometown, name, STRING),
+                S2J_FIELD(Hometown, code, I16));
+S2J_DESC_DEFINE(pos_desc, S2J_FIELD(Pos, x, DOUBLE), S2J_FIELD(Pos, y, DOUBLE),
+                S2J_FIELD(Pos, acc, FLOAT), S2J_FIELD(Pos, fix, BOOL));
+S2J_DESC_DEFINE(student_desc, S2J_FIELD(Student, id, U8),
+                S2J_ARRAY(Student, score, U8), S2J_FIELD(Student, name, STRING),
+                S2J_FIELD(Student, weight, DOUBLE),
+                S2J_STRUCT(Student, hometown, hometown_desc),
+                S2J_FIELD(Student, i8, I8), S2J_FIELD(Student, i32, I32),
+                S2J_FIELD(Student, i64, I64), S2J_FIELD(Student, u16, U16),
+                S2J_FIELD(Student, u32, U32), S2J_FIELD(Student, u64, U64),
+                S2J_FIELD(Student, f, FLOAT), S2J_FIELD(Student, ok, BOOL),
+                S2J_ARRAY(Student, tags, STRING),
+                S2J_STRUCT_ARRAY(Student, track, pos_desc),
+                S2J_ARRAY(Student, vals, I32));
+
+static uint64_t m_rnd = 88172645463325252ull;
+
+static uint64_t rnd(void) {
+    m_rnd ^= m_rnd << 13;
+    m_rnd ^= m_rnd >> 7;
+    m_rnd ^= m_rnd << 17;
+    return m_rnd;
+}
+
+// 随机字符串, 混入需要转义的引号/反斜杠/控制字符
+static void rand_str(char* s, size_t cap) {
+    size_t n = rnd() % cap;
+    for (size_t i = 0; i < n; i++) {
+        int k = rnd() % 10;
+        if (k == 0)
+            s[i] = (char)(1 + rnd() % 31);
+        else if (k == 1)
+            s[i] = '"';
+        else if (k == 2)
+            s[i] = '\\';
+        else
+            s[i] = (char)('a' + rnd() % 26);
+    }
+    s[n] = '\0';
+}
+
+// 随机浮点数: 整数, 任意位模式, 短小数和不能精确表示的小数
+static double rand_double(void) {
+    switch (rnd() % 5) {
+        case 0:
+            return (double)(int64_t)(rnd() % 2000000) - 1000000;
+        case 1: {
+            uint64_t b = rnd();
+            double d;
+            memcpy(&d, &b, sizeof(d));
+            return isfinite(d) ? d : 0.5;
+        }
+        case 2:
+            return (double)(rnd() % 100000) / 1000.0;
+        case 3:
+            return 0.1;
+        default:
+            return -(double)(rnd() % 1000) / 7.0;
+    }
+}
+
+static float rand_float(void) {
+    float f = (float)rand_double();
+    return isfinite(f) ? f : 1.25f;
+}
+
+static void fill(Student* s) {
+    memset(s, 0, sizeof(*s));
+    s->id = rnd();
+    for (int i = 0; i < 8; i++)
+        s->score[i] = rnd();
+    rand_str(s->name, sizeof(s->name));
+    s->weight = rand_double();
+    rand_str(s->hometown.name, sizeof(s->hometown.name));
+    s->hometown.code = rnd();
+    s->i8 = rnd();
+    s->i32 = rnd();
+    s->i64 = rnd() % 4 ? (int64_t)rnd() : INT64_MIN;
+    s->u16 = rnd();
+    s->u32 = rnd();
+    s->u64 = rnd() % 4 ? rnd() : UINT64_MAX;
+    s->f = rand_float();
+    s->ok = rnd() & 1;
+    for (int i = 0; i < 3; i++) {
+        rand_str(s->tags[i], sizeof(s->tags[i]));
+        s->track[i].x = rand_double();
+        s->track[i].y = rand_double();
+        s->track[i].acc = rand_float();
+        s->track[i].fix = rnd() & 1;
+    }
+    for (int i = 0; i < 4; i++)
+        s->vals[i] = rnd();
+}
+
+/* exact为false时不比较浮点数和64位整数(cJSON以double保存数值) */
+static bool same(const Student* a, const Student* b, bool exact) {
+    bool eq = a->id == b->id && !memcmp(a->score, b->score, 8) &&
+              !strcmp(a->name, b->name) &&
+              !strcmp(a->hometown.name, b->hometown.name) &&
+              a->hometown.code == b->hometown.code && a->i8 == b->i8 &&
+              a->i32 == b->i32 && a->u16 == b->u16 && a->u32 == b->u32 &&
+              a->ok == b->ok && !memcmp(a->vals, b->vals, sizeof(a->vals));
+    for (int i = 0; i < 3; i++)
+        eq = eq && !strcmp(a->tags[i], b->tags[i]) &&
+             a->track[i].fix == b->track[i].fix;
+    if (!exact)
+        return eq;
+    eq = eq && a->weight == b->weight && a->i64 == b->i64 &&
+         a->u64 == b->u64 && a->f == b->f;
+    for (int i = 0; i < 3; i++)
+        eq = eq && a->track[i].x == b->track[i].x &&
+             a->track[i].y == b->track[i].y &&
+             a->track[i].acc == b->track[i].acc;
+    return eq;
+}
+
+/* 以cJSON解析序列化结果, 检查字符串转义与数值 */
+static void check_cjson(const Student* s, const char* js) {
+    cJSON* r = cJSON_Parse(js);
+    CHECK(r != NULL);
+    if (r == NULL)
+        return;
+    CHECK(cJSON_GetObjectItem(r, "id")->valuedouble == s->id);
+    CHECK(!strcmp(cJSON_GetObjectItem(r, "name")->valuestring, s->name));
+    CHECK(cJSON_GetObjectItem(r, "i32")->valuedouble == s->i32);
+    double w = cJSON_GetObjectItem(r, "weight")->valuedouble;
+    CHECK(w == s->weight || fabs(s->weight) < 1e-290 ||  // cJSON解析不精确
+          fabs(w - s->weight) <= fabs(s->weight) * 1e-6);
+    cJSON* h = cJSON_GetObjectItem(r, "hometown");
+    CHECK(!strcmp(cJSON_GetObjectItem(h, "name")->valuestring,
+                  s->hometown.name));
+    cJSON* t = cJSON_GetObjectItem(r, "tags");
+    for (int i = 0; i < 3; i++)
+        CHECK(!strcmp(cJSON_GetArrayItem(t, i)->valuestring, s->tags[i]));
+    // cJSON的缩进输出也能解析回来
+    char* p = cJSON_Print(r);
+    Student l = {0};
+    CHECK(s2j_load(&student_desc, &l, p, strlen(p)));
+    CHECK(same(s, &l, false));
+    free(p);
+    cJSON_Delete(r);
+}
+
+static char m_sink[4096];
+static size_t m_sink_len, m_sink_lim;
+
+static size_t sink_write(void* ctx, const char* data, size_t len) {
+    (void)ctx;
+    if (m_sink_len + len > m_sink_lim)
+        len = m_sink_lim - m_sink_len;
+    memcpy(m_sink + m_sink_len, data, len);
+    m_sink_len += len;
+    return len;
+}
+
+static void test_round_trip(void) {
+    static uint8_t mem[2048];
+    char buf[4096], buf2[4096];
+    for (int it = 0; it < TEST_ROUNDS; it++) {
+        Student s, l = {0};
+        fill(&s);
+        size_t n = s2j_dump(&student_desc, &s, buf, sizeof(buf));
+        CHECK(n == strlen(buf) && n < sizeof(buf));
+        CHECK(s2j_dump(&student_desc, &s, NULL, 0) == n);
+        CHECK(json_validn(buf, n));
+        check_cjson(&s, buf);
+        CHECK(s2j_load(&student_desc, &l, buf, n));
+        CHECK(same(&s, &l, true));
+
+        // 截断: 与snprintf相同
+        size_t cut = rnd() % (n + 2);
+        CHECK(s2j_dump(&student_desc, &s, buf2, cut) == n);
+        if (cut)
+            CHECK(strlen(buf2) == cut - 1 && !memcmp(buf, buf2, cut - 1));
+
+        // 回调输出, 写入不完整时返回0
+        m_sink_len = 0;
+        m_sink_lim = sizeof(m_sink);
+        CHECK(s2j_dump_to(&student_desc, &s, sink_write, NULL) == n);
+        CHECK(m_sink_len == n && !memcmp(m_sink, buf, n));
+        m_sink_len = 0;
+        m_sink_lim = rnd() % n;
+        CHECK(s2j_dump_to(&student_desc, &s, sink_write, NULL) == 0);
+
+        // 环形缓冲区, 先移动读写指针使消息跨越末尾
+        lwrb_t lw;
+        ringbuf_t rb;
+        size_t cap = 100 + rnd() % 1500;
+        lwrb_init(&lw, mem, cap);
+        ringbuf_init(&rb, &ringbuf_ops_lwrb, &lw);
+        size_t skip = rnd() % cap;
+        lwrb_advance(&lw, skip);
+        lwrb_skip(&lw, skip);
+        size_t w = s2j_dump_ringbuf(&student_desc, &s, &rb);
+        if (cap - 1 >= n) {
+            CHECK(w == n);
+            CHECK(lwrb_read(&lw, buf2, sizeof(buf2)) == n &&
+                  !memcmp(buf2, buf, n));
+        } else {
+            CHECK(w == 0 && lwrb_get_full(&lw) == 0);
+        }
+    }
+}
+
+/* 键乱序, 未知键, 键中的转义, 整数越界, 字符串超长和类型不符 */
+static void test_load_lenient(void) {
+    static const char js[] =
+        "{\"zzz\":{\"id\":3},\"vals\":[1,2,3,4,5,6],\"i8\":1000,\"u16\":-5,"
+        "\"hometown\":{\"code\":-40000,"
+        "\"n\\u0061me\":\"abcdefghijklmnopqrstuvwxyz\"},"
+        "\"id\":7,\"u32\":\"12\",\"ok\":true,\"score\":[9],"
+        "\"name\":\"a\\nb\\u00e9\",\"i64\":1e30,"
+        "\"u64\":18446744073709551615,\"track\":[{\"fix\":true,\"x\":1.5}],"
+        "\"tags\":[\"abcdefgh\",1,\"q\"]}";
+    Student l = {0};
+    l.u32 = 77;
+    CHECK(s2j_load(&student_desc, &l, js, strlen(js)));
+    CHECK(l.vals[0] == 1 && l.vals[3] == 4);
+    CHECK(l.i8 == 127 && l.u16 == 0 && l.hometown.code == -32768);
+    CHECK(!strcmp(l.hometown.name, "abcdefghijklmno"));
+    CHECK(l.id == 7 && l.u32 == 77 && l.ok);
+    CHECK(l.score[0] == 9 && l.score[1] == 0);
+    CHECK(!strcmp(l.name, "a\nb\xc3\xa9"));
+    CHECK(l.i64 == INT64_MAX && l.u64 == UINT64_MAX);
+    CHECK(l.track[0].fix && l.track[0].x == 1.5 && !l.track[1].fix);
+    CHECK(!strcmp(l.tags[0], "abcde") && l.tags[1][0] == '\0');
+    CHECK(!strcmp(l.tags[2], "q"));
+    CHECK(!s2j_load(&student_desc, &l, "[1]", 3));
+    CHECK(!s2j_load(&student_desc, &l, "", 0));
+}
+
+/* 占满数组不含'\0'的字符串, NaN/Inf输出为null, 负零与极大值 */
+static void test_dump_special(void) {
+    char buf[1024];
+    Student s = {0};
+    memcpy(s.name, "0123456789", 10);
+    s.weight = NAN;
+    s.f = INFINITY;
+    s.track[0].x = -0.0;
+    s.track[1].x = 1e300;
+    s.track[2].acc = 0.1f;
+    s2j_dump(&student_desc, &s, buf, sizeof(buf));
+    CHECK(strstr(buf, "\"name\":\"0123456789\"") != NULL);
+    CHECK(strstr(buf, "\"weight\":null") && strstr(buf, "\"f\":null"));
+    CHECK(json_valid(buf));
+    Student l = {0};
+    CHECK(s2j_load(&student_desc, &l, buf, strlen(buf)));
+    CHECK(l.track[1].x == 1e300 && l.track[2].acc == 0.1f);
+}
+
+/* 随机数值字符串, 浮点与strtod逐位比较, 整数与json_int64/uint64比较 */
+static void test_numbers(void) {
+    for (int it = 0; it < TEST_NUMBERS; it++) {
+        char num[64], js[512];
+        int p = 0;
+        if (rnd() & 1)
+            num[p++] = '-';
+        if (rnd() % 3 == 0) {
+            num[p++] = '0';
+        } else {
+            int nd = 1 + rnd() % 22;
+            for (int i = 0; i < nd; i++)
+                num[p++] = i ? '0' + rnd() % 10 : '1' + rnd() % 9;
+        }
+        if (rnd() & 1) {
+            int fd = 1 + rnd() % 20;
+            num[p++] = '.';
+            for (int i = 0; i < fd; i++)
+                num[p++] = rnd() % 3 ? '0' + rnd() % 10 : '0';
+        }
+        if (rnd() % 4 == 0) {
+            int sign = rnd() % 3;
+            num[p++] = rnd() & 1 ? 'e' : 'E';
+            if (sign)
+                num[p++] = sign == 1 ? '-' : '+';
+            p += sprintf(num + p, "%d", (int)(rnd() % 40));
+        }
+        num[p] = '\0';
+        int n = sprintf(js,
+                        "{\"weight\":%s,\"f\":%s,\"i64\":%s,\"u64\":%s,"
+                        "\"i32\":%s}",
+                        num, num, num, num, num);
+        Student l = {0};
+        CHECK(s2j_load(&student_desc, &l, js, n));
+        double d = strtod(num, NULL);
+        struct json jv = json_get(js, "i64");
+        int64_t ei = json_int64(jv);
+        uint64_t eu = json_uint64(jv);
+        int64_t e32 = ei > INT32_MAX   ? INT32_MAX
+                      : ei < INT32_MIN ? INT32_MIN
+                                       : ei;
+        bool ok = !memcmp(&l.weight, &d, sizeof(d)) && l.f == (float)d &&
+                  (double)l.i64 == (double)ei &&
+                  (double)l.u64 == (double)eu && l.i32 == e32;
+        CHECK(ok);
+        if (!ok)
+            printf("  number %s\n", num);
+    }
+}
+
+int main(void) {
+    test_round_trip();
+    test_load_lenient();
+    test_dump_special();
+    test_numbers();
+    return CHECK_RESULT();
+}
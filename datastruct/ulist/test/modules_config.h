@@ -0,0 +1,18 @@
+// ulist主机测试配置
+// 相当于在主机上由Kconfig生成的modules_config.h, 默认开启原子操作
+#define MOD_CFG_COMPILER_GCC 1
+#define MOD_CFG_USE_OS_NONE 1
+#define MOD_CFG_PLATFORM_HEADER <stddef.h>
+#define MOD_CFG_TIME_MATHOD_CUSTOM 1
+#define MOD_CFG_CUSTOM_TIME_TYPE_U64 1
+#define MOD_CFG_CUSTOM_TIME_BASE 1000000
+#define MOD_CFG_DELAY_MATHOD_CUSTOM 1
+#define MOD_CFG_HEAP_MATHOD_STDLIB 1
+#ifndef MOD_CFG_ENABLE_ATOMIC
+#define MOD_CFG_ENABLE_ATOMIC 1
+#endif
+#define LOG_CFG_ENABLE 0
+// 平台头文件中的编译器宏
+#define __weak __attribute__((weak))
+#define __IO volatile
+#define __STATIC_INLINE static inline
@@ -0,0 +1,164 @@
+// ulist读多写少模式的多线程竞争基准测试
+// 一个写者以固定周期整体更新32个元素, 读者反复读取全部元素,
+// 比较加锁读取(ulist_write_begin/end)与快照读取(ulist_read_lock/unlock)
+// 的读吞吐量和写者的加锁到发布完成的耗时, 同时检查读者看到的内容是否一致
+// 在工程根目录构建并运行(-DMOD_CFG_ENABLE_ATOMIC=0时读多写少模式初始化失败):
+//   gcc -O2 -pthread -Idatastruct/ulist/test -I. -Idatastruct/ulist
+//       -Idebug/log -Iutility/macro datastruct/ulist/test/ulist_bench.c
+//       -o ulist_bench
+//   ./ulist_bench [每组持续时间ms] [写周期us]
+// 互斥锁映射到pthread递归锁(写者在write_begin/end内会再次加锁),
+// 因此本文件直接包含ulist.c
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "modules.h"
+
+#undef MOD_MUTEX_HANDLE
+#undef MOD_MUTEX_CREATE
+#undef MOD_MUTEX_ACQUIRE
+#undef MOD_MUTEX_RELEASE
+#define MOD_MUTEX_HANDLE pthread_mutex_t*
+#define MOD_MUTEX_CREATE(name) bench_mutex_create()
+#define MOD_MUTEX_ACQUIRE(mutex) pthread_mutex_lock(mutex)
+#define MOD_MUTEX_RELEASE(mutex) pthread_mutex_unlock(mutex)
+
+static pthread_mutex_t* bench_mutex_create(void) {
+    pthread_mutexattr_t attr;
+    pthread_mutex_t* m = malloc(sizeof(pthread_mutex_t));
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(m, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return m;
+}
+
+#include "ulist.c"
+
+#define BENCH_ENTRIES 32
+#define BENCH_MAX_READERS 4
+
+static ulist_t m_list;
+static volatile int m_stop;
+static int m_snapshot;  // 读者使用快照读取
+static uint64_t m_reads[BENCH_MAX_READERS];
+static uint64_t m_torn;  // 读到不一致内容的次数
+static uint64_t m_writes, m_write_ns, m_write_max_ns;
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// 写者每次把全部元素更新为同一个值, 读者看到的值应全部相同
+static void* writer(void* arg) {
+    long period_us = (long)arg;
+    uint32_t v = 0;
+    while (!m_stop) {
+        uint64_t t0 = host_ns();
+        ulist_write_begin(&m_list);
+        v++;
+        ulist_foreach(&m_list, uint32_t, item) {
+            *item = v;
+        }
+        ulist_write_end(&m_list);
+        uint64_t dt = host_ns() - t0;
+        m_writes++;
+        m_write_ns += dt;
+        if (dt > m_write_max_ns) m_write_max_ns = dt;
+        struct timespec ts = {0, period_us * 1000};
+        nanosleep(&ts, NULL);
+    }
+    return NULL;
+}
+
+static void* reader(void* arg) {
+    long id = (long)arg;
+    uint64_t reads = 0, torn = 0;
+    while (!m_stop) {
+        uint32_t first, bad = 0;
+        if (m_snapshot) {
+            ulist_snapshot_t snap;
+            ulist_read_lock(&m_list, &snap);
+            first = ((const uint32_t*)snap.data)[0];
+            ulist_snapshot_foreach(&snap, uint32_t, item) {
+                bad |= *item != first;
+            }
+            ulist_read_unlock(&m_list, &snap);
+        } else {
+            ulist_write_begin(&m_list);  // 未启用快照时只加锁
+            first = *(uint32_t*)ulist_get(&m_list, 0);
+            ulist_foreach(&m_list, uint32_t, item) {
+                bad |= *item != first;
+            }
+            ulist_write_end(&m_list);
+        }
+        torn += bad;
+        reads++;
+    }
+    m_reads[id] = reads;
+    __atomic_fetch_add(&m_torn, torn, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+static int run(int snapshot, int nreaders, long ms, long period_us) {
+    pthread_t wt, rt[BENCH_MAX_READERS];
+    uint8_t opt = snapshot ? ULIST_OPT_READ_MOSTLY : 0;
+    if (!ulist_init(&m_list, sizeof(uint32_t), BENCH_ENTRIES, opt, NULL)) {
+        printf("ulist_init failed (READ_MOSTLY requires "
+               "MOD_CFG_ENABLE_ATOMIC)\n");
+        return -1;
+    }
+    ulist_foreach(&m_list, uint32_t, item) {
+        *item = 0;
+    }
+    if (snapshot) {  // 发布初始内容
+        ulist_write_begin(&m_list);
+        ulist_write_end(&m_list);
+    }
+    m_snapshot = snapshot;
+    m_stop = 0;
+    m_writes = m_write_ns = m_write_max_ns = 0;
+    for (long i = 0; i < nreaders; i++)
+        pthread_create(&rt[i], NULL, reader, (void*)i);
+    pthread_create(&wt, NULL, writer, (void*)period_us);
+    struct timespec ts = {ms / 1000, ms % 1000 * 1000000};
+    nanosleep(&ts, NULL);
+    m_stop = 1;
+    pthread_join(wt, NULL);
+    uint64_t reads = 0;
+    for (int i = 0; i < nreaders; i++) {
+        pthread_join(rt[i], NULL);
+        reads += m_reads[i];
+    }
+    printf("%-9s %7d %12.2f %8llu %12.2f %12.2f\n",
+           snapshot ? "snapshot" : "lock", nreaders, reads / (ms * 1e3),
+           (unsigned long long)m_writes,
+           m_writes ? m_write_ns / (double)m_writes / 1e3 : 0.0,
+           m_write_max_ns / 1e3);
+    ulist_reclaim(&m_list);
+    ulist_clear(&m_list);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    long ms = argc > 1 ? atol(argv[1]) : 1000;
+    long period_us = argc > 2 ? atol(argv[2]) : 1000;
+    printf("%d entries, writer period %ld us, %ld ms per row\n",
+           BENCH_ENTRIES, period_us, ms);
+    printf("%-9s %7s %12s %8s %12s %12s\n", "mode", "readers", "Mreads/s",
+           "writes", "write avg us", "write max us");
+    for (int snapshot = 0; snapshot < 2; snapshot++) {
+        for (int n = 1; n <= BENCH_MAX_READERS; n *= 2) {
+            if (run(snapshot, n, ms, period_us)) return EXIT_FAILURE;
+        }
+    }
+    if (m_torn) {
+        printf("FAIL: %llu inconsistent reads\n", (unsigned long long)m_torn);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
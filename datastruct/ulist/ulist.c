@@ -40,12 +40,22 @@
                 list->mutex = MOD_MUTEX_CREATE("ulist"); \
             MOD_MUTEX_ACQUIRE(list->mutex);              \
         }                                                \
-    }
-#define ULIST_UNLOCK()                           \
-    {                                            \
-        if (!(list->opt & ULIST_OPT_NO_MUTEX)) { \
-            MOD_MUTEX_RELEASE(list->mutex);      \
-        }                                        \
+        if (list->rcu)                                   \
+            list->rcu->nest++;                           \
+    }
+#define ULIST_UNLOCK()                                           \
+    {                                                            \
+        if (list->rcu && !--list->rcu->nest && list->rcu->dirty) \
+            ulist_rcu_publish(list);                             \
+        if (!(list->opt & ULIST_OPT_NO_MUTEX)) {                 \
+            MOD_MUTEX_RELEASE(list->mutex);                      \
+        }                                                        \
+    }
+// 标记列表内容已修改, 最外层解锁时发布新快照
+#define ULIST_MODIFIED()          \
+    {                             \
+        if (list->rcu)            \
+            list->rcu->dirty = 1; \
     }
 #define ULIST_UNLOCK_RET(x) \
     {                       \
@@ -56,6 +66,145 @@
 #define ULIST_BSIZE(num) ((num) * list->isize)
 #define ULIST_PTR(offset) (((uint8_t*)list->data) + ULIST_BSIZE(offset))
 
+/**
+ * 读多写少模式:
+ * 读者进入时在当前纪元奇偶对应的槽位计数, 写者每次发布快照后翻转纪元,
+ * 使旧槽位不再有新读者进入; 被替换的快照记录两个槽位, 每观察到一个槽位
+ * 计数为0就清除对应的标记(此时发布前进入的读者都已退出), 全部清除后释放
+ */
+typedef struct ulist_snap {
+    struct ulist_snap* next;  // 待回收链表
+    mod_size_t num;           // 元素个数
+    uint8_t pending;          // 尚未观察到计数为0的槽位(位掩码)
+    uint64_t data[];          // 元素数据
+} ulist_snap_t;
+
+struct ulist_rcu {
+    mod_atomic_ptr_t cur;          // 当前快照(ulist_snap_t*, NULL: 空列表)
+    mod_atomic_size_t epoch;       // 纪元, 最低位选择读者计数槽位
+    mod_atomic_size_t readers[2];  // 读者计数
+    ulist_snap_t* retired;         // 等待回收的快照
+    uint8_t nest;                  // 写者加锁嵌套深度
+    uint8_t dirty;                 // 是否有未发布的修改
+};
+
+static const uint64_t ulist_empty_snap = 0;  // 空快照的数据地址
+
+/**
+ * @brief 数据区内存操作, 经由列表的分配器, 未设置时使用m_alloc
+ */
+static inline void* ulist_data_malloc(ULIST list, size_t size) {
+    if (list->allocator)
+        return list->allocator->alloc(list->allocator->ctx, size);
+    return _ulist_malloc(size);
+}
+
+static inline void* ulist_data_realloc(ULIST list, void* ptr, size_t size) {
+    if (list->allocator)
+        return list->allocator->realloc(list->allocator->ctx, ptr, size);
+    return _ulist_realloc(ptr, size);
+}
+
+static inline void ulist_data_free(ULIST list, void* ptr) {
+    if (list->allocator)
+        list->allocator->free(list->allocator->ctx, ptr);
+    else
+        _ulist_free(ptr);
+}
+
+/**
+ * @brief 释放读者计数已清零的旧快照(需持有写锁)
+ * @retval 仍在等待回收的快照个数
+ */
+static mod_size_t ulist_rcu_reclaim(ULIST list) {
+    struct ulist_rcu* rcu = list->rcu;
+    uint8_t zero = 0;
+    for (uint8_t i = 0; i < 2; i++) {
+        if (!MOD_ATOMIC_LOAD(rcu->readers[i], MOD_ATOMIC_ORDER_SEQ_CST))
+            zero |= 1 << i;
+    }
+    mod_size_t left = 0;
+    ulist_snap_t** pp = &rcu->retired;
+    while (*pp != NULL) {
+        ulist_snap_t* snap = *pp;
+        snap->pending &= ~zero;
+        if (snap->pending) {
+            pp = &snap->next;
+            left++;
+            continue;
+        }
+        *pp = snap->next;
+        ulist_data_free(list, snap);
+    }
+    return left;
+}
+
+/**
+ * @brief 把数据区复制为新快照并发布, 旧快照进入待回收链表(需持有写锁)
+ * @note 申请内存失败时保留修改标记, 下次解锁时重试
+ */
+static void ulist_rcu_publish(ULIST list) {
+    struct ulist_rcu* rcu = list->rcu;
+    ulist_snap_t* snap = NULL;
+    if (list->num > 0) {
+        snap = ulist_data_malloc(list,
+                                 sizeof(ulist_snap_t) + ULIST_BSIZE(list->num));
+        if (snap == NULL) {
+            LIST_LOG("snapshot malloc failed");
+            return;
+        }
+        snap->num = list->num;
+        _ulist_memcpy(snap->data, list->data, ULIST_BSIZE(list->num));
+    }
+    ulist_snap_t* old = MOD_ATOMIC_LOAD(rcu->cur, MOD_ATOMIC_ORDER_RELAXED);
+    MOD_ATOMIC_STORE(rcu->cur, snap, MOD_ATOMIC_ORDER_SEQ_CST);
+    MOD_ATOMIC_FETCH_ADD(rcu->epoch, 1, MOD_ATOMIC_ORDER_SEQ_CST);
+    rcu->dirty = 0;
+    if (old != NULL) {
+        old->pending = 0x03;
+        old->next = rcu->retired;
+        rcu->retired = old;
+    }
+    ulist_rcu_reclaim(list);
+}
+
+/**
+ * @brief 启用读多写少模式
+ */
+static bool ulist_rcu_init(ULIST list) {
+    struct ulist_rcu* rcu = _ulist_malloc(sizeof(struct ulist_rcu));
+    if (rcu == NULL)
+        return false;
+    MOD_ATOMIC_INIT(rcu->cur, NULL);
+    MOD_ATOMIC_INIT(rcu->epoch, 0);
+    MOD_ATOMIC_INIT(rcu->readers[0], 0);
+    MOD_ATOMIC_INIT(rcu->readers[1], 0);
+    rcu->retired = NULL;
+    rcu->nest = 0;
+    rcu->dirty = list->num > 0;
+    list->rcu = rcu;
+    if (rcu->dirty)
+        ulist_rcu_publish(list);
+    return true;
+}
+
+/**
+ * @brief 释放读多写少模式的全部快照(调用者保证已没有读者)
+ */
+static void ulist_rcu_free(ULIST list) {
+    struct ulist_rcu* rcu = list->rcu;
+    ulist_snap_t* snap = MOD_ATOMIC_LOAD(rcu->cur, MOD_ATOMIC_ORDER_RELAXED);
+    if (snap != NULL)
+        ulist_data_free(list, snap);
+    while (rcu->retired != NULL) {
+        snap = rcu->retired;
+        rcu->retired = snap->next;
+        ulist_data_free(list, snap);
+    }
+    _ulist_free(rcu);
+    list->rcu = NULL;
+}
+
 /**
  * @brief 将Python风格的负索引转换为C风格的正索引
  * @note  如果索引越界, 返回-1
@@ -113,7 +262,7 @@ static bool ulist_expend(ULIST list, mod_size_t req_num) {
         if (!(list->opt & ULIST_OPT_NO_ALLOC_EXTEND)) {
             req_num = calc_req_size(req_num);
         }
-        list->data = _ulist_malloc(ULIST_BSIZE(req_num));
+        list->data = ulist_data_malloc(list, ULIST_BSIZE(req_num));
         if (list->data == NULL) {
             LIST_LOG("malloc failed");
             return false;
@@ -127,7 +276,8 @@ static bool ulist_expend(ULIST list, mod_size_t req_num) {
         if (!(list->opt & ULIST_OPT_NO_ALLOC_EXTEND)) {
             req_num = calc_req_size(req_num);
         }
-        void* new_data = _ulist_realloc(list->data, ULIST_BSIZE(req_num));
+        void* new_data =
+            ulist_data_realloc(list, list->data, ULIST_BSIZE(req_num));
         if (new_data == NULL) {
             LIST_LOG("realloc failed");
             return false;
@@ -151,7 +301,7 @@ static void ulist_shrink(ULIST list, mod_size_t req_num) {
         if (list->opt & ULIST_OPT_NO_AUTO_FREE) {
             goto check_dirty_region;
         }
-        _ulist_free(list->data);
+        ulist_data_free(list, list->data);
         list->num = 0;
         list->data = NULL;
         list->cap = 0;
@@ -164,7 +314,8 @@ static void ulist_shrink(ULIST list, mod_size_t req_num) {
         req_num = calc_req_size(req_num);
     }
     if (req_num < list->cap) {  // shrink
-        void* new_data = _ulist_realloc(list->data, ULIST_BSIZE(req_num));
+        void* new_data =
+            ulist_data_realloc(list, list->data, ULIST_BSIZE(req_num));
         if (new_data != NULL) {
             list->data = new_data;
             list->cap = req_num;
@@ -186,6 +337,14 @@ bool ulist_init(ULIST list, mod_size_t isize, mod_size_t init_size, uint8_t opt,
     list->opt = opt;
     list->elfree = elfree;
     list->dyn = false;
+    list->allocator = NULL;
+    list->rcu = NULL;
+#if !MOD_CFG_ENABLE_ATOMIC
+    if (opt & ULIST_OPT_READ_MOSTLY) {  // 读者计数和快照发布依赖原子操作
+        LIST_LOG("ULIST_OPT_READ_MOSTLY requires MOD_CFG_ENABLE_ATOMIC");
+        return false;
+    }
+#endif
     if (init_size > 0) {
         if (!ulist_expend(list, init_size)) {
             list->data = NULL;
@@ -194,6 +353,14 @@ bool ulist_init(ULIST list, mod_size_t isize, mod_size_t init_size, uint8_t opt,
         }
         list->num = init_size;
     }
+    if ((opt & ULIST_OPT_READ_MOSTLY) && !ulist_rcu_init(list)) {
+        if (list->data != NULL)
+            ulist_data_free(list, list->data);
+        list->data = NULL;
+        list->cap = 0;
+        list->num = 0;
+        return false;
+    }
     if (!(list->opt & ULIST_OPT_NO_MUTEX))
         list->mutex = MOD_MUTEX_CREATE("ulist");
     else
@@ -221,8 +388,10 @@ void ulist_free(ULIST list) {
             list->elfree(ULIST_PTR(i));
         }
     }
+    if (list->rcu != NULL)
+        ulist_rcu_free(list);
     if (list->data != NULL) {
-        _ulist_free(list->data);
+        ulist_data_free(list, list->data);
     }
     if (list->mutex)
         MOD_MUTEX_DELETE(list->mutex);
@@ -230,15 +399,78 @@ void ulist_free(ULIST list) {
         _ulist_free(list);
 }
 
+bool ulist_set_allocator(ULIST list, const mod_allocator_t* allocator) {
+    if (list->data != NULL)
+        return false;
+    list->allocator = allocator;
+    return true;
+}
+
+void ulist_read_lock(ULIST list, ulist_snapshot_t* snap) {
+    struct ulist_rcu* rcu = list->rcu;
+    if (rcu == NULL) {  // 未启用读多写少模式
+        snap->data = list->data;
+        snap->num = list->num;
+        snap->slot = 0;
+        return;
+    }
+    mod_size_t epoch;
+    while (1) {  // 计数后纪元未变, 说明写者翻转纪元前已看到本读者
+        epoch = MOD_ATOMIC_LOAD(rcu->epoch, MOD_ATOMIC_ORDER_SEQ_CST);
+        MOD_ATOMIC_FETCH_ADD(rcu->readers[epoch & 1], 1,
+                             MOD_ATOMIC_ORDER_SEQ_CST);
+        if (MOD_ATOMIC_LOAD(rcu->epoch, MOD_ATOMIC_ORDER_SEQ_CST) == epoch)
+            break;
+        MOD_ATOMIC_FETCH_ADD(rcu->readers[epoch & 1], (mod_size_t)-1,
+                             MOD_ATOMIC_ORDER_RELEASE);
+    }
+    snap->slot = epoch & 1;
+    ulist_snap_t* cur = MOD_ATOMIC_LOAD(rcu->cur, MOD_ATOMIC_ORDER_SEQ_CST);
+    if (cur != NULL) {
+        snap->data = cur->data;
+        snap->num = cur->num;
+    } else {
+        snap->data = &ulist_empty_snap;
+        snap->num = 0;
+    }
+}
+
+void ulist_read_unlock(ULIST list, ulist_snapshot_t* snap) {
+    if (list->rcu == NULL)
+        return;
+    MOD_ATOMIC_FETCH_ADD(list->rcu->readers[snap->slot], (mod_size_t)-1,
+                         MOD_ATOMIC_ORDER_RELEASE);
+    snap->data = NULL;
+    snap->num = 0;
+}
+
+void ulist_write_begin(ULIST list) {
+    ULIST_LOCK();
+    ULIST_MODIFIED();
+}
+
+void ulist_write_end(ULIST list) {
+    ULIST_UNLOCK();
+}
+
+mod_size_t ulist_reclaim(ULIST list) {
+    if (list->rcu == NULL)
+        return 0;
+    ULIST_LOCK();
+    mod_size_t left = ulist_rcu_reclaim(list);
+    ULIST_UNLOCK_RET(left);
+}
+
 void* ulist_append_multi(ULIST list, mod_size_t num) {
     if (num == 0)
         return NULL;
 
     ULIST_LOCK();
     if (!ulist_expend(list, list->num + num))
-        return NULL;
+        ULIST_UNLOCK_RET(NULL);
     uint8_t* ptr = ULIST_PTR(list->num);
     list->num += num;
+    ULIST_MODIFIED();
     ULIST_UNLOCK_RET((void*)ptr);
 }
 
@@ -278,6 +510,7 @@ void* ulist_insert_multi(ULIST list, mod_offset_t index, mod_size_t num) {
         _ulist_memset(src, ULIST_DIRTY_REGION_FILL_DATA, ULIST_BSIZE(num));
     }
     list->num += num;
+    ULIST_MODIFIED();
     ULIST_UNLOCK_RET((void*)src);
 }
 
@@ -309,6 +542,7 @@ bool ulist_extend(ULIST list, ULIST other) {
     uint8_t* ptr = ULIST_PTR(list->num);
     _ulist_memcpy(ptr, other->data, ULIST_BSIZE(other->num));
     list->num += other->num;
+    ULIST_MODIFIED();
     ULIST_UNLOCK_RET(true);
 }
 
@@ -351,6 +585,7 @@ bool ulist_delete_multi(ULIST list, mod_offset_t index, mod_size_t num) {
         list->num -= num;
     }
     ulist_shrink(list, list->num);
+    ULIST_MODIFIED();
     ULIST_UNLOCK_RET(true);
 }
 
@@ -436,6 +671,7 @@ bool ulist_update(ULIST list, mod_offset_t index, const void* src) {
         list->elfree(ULIST_PTR(i));
     }
     _ulist_memcpy(ULIST_PTR(i), src, list->isize);
+    ULIST_MODIFIED();
     ULIST_UNLOCK_RET(true);
 }
 
@@ -494,6 +730,7 @@ bool ulist_swap(ULIST list, mod_offset_t index1, mod_offset_t index2) {
         ptr1[i] = ptr2[i];
         ptr2[i] = tmp;
     }
+    ULIST_MODIFIED();
     ULIST_UNLOCK_RET(true);
 }
 
@@ -505,6 +742,7 @@ bool ulist_sort(ULIST list, int (*cmp)(const void*, const void*),
     if (i == -1 || j == -1)
         ULIST_UNLOCK_RET(false);
     qsort(ULIST_PTR(i), j - i, list->isize, cmp);
+    ULIST_MODIFIED();
     ULIST_UNLOCK_RET(true);
 }
 
@@ -561,6 +799,7 @@ void ulist_clear(ULIST list) {
     }
     ulist_shrink(list, 0);
     list->num = 0;
+    ULIST_MODIFIED();
     ULIST_UNLOCK();
 }
 
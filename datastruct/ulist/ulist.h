@@ -20,19 +20,29 @@ extern "C" {
 #define SLICE_START (INT32_MAX)    // like list[:index] in Python
 #define SLICE_END (INT32_MAX - 1)  // like list[index:] in Python
 
+struct ulist_rcu;
+
 typedef struct {
-    void* data;              // 数据缓冲区
-    mod_size_t num;          // 列表内元素个数
-    mod_size_t cap;          // 缓冲区容量(元素个数)
-    mod_size_t isize;        // 元素大小(字节)
-    mod_size_t opt : 15;     // 配置
-    mod_size_t dyn : 1;      // 是否动态分配
-    void (*elfree)(void*);   // 元素释放函数
-    MOD_MUTEX_HANDLE mutex;  // 互斥锁
+    void* data;                        // 数据缓冲区
+    mod_size_t num;                    // 列表内元素个数
+    mod_size_t cap;                    // 缓冲区容量(元素个数)
+    mod_size_t isize;                  // 元素大小(字节)
+    mod_size_t opt : 15;               // 配置
+    mod_size_t dyn : 1;                // 是否动态分配
+    void (*elfree)(void*);             // 元素释放函数
+    MOD_MUTEX_HANDLE mutex;            // 互斥锁
+    const mod_allocator_t* allocator;  // 数据区分配器(NULL: 使用m_alloc)
+    struct ulist_rcu* rcu;             // 读多写少模式状态(NULL: 未启用)
 } ulist_t;
 
 typedef ulist_t* ULIST;
 
+typedef struct {       // 读多写少模式下的只读快照
+    const void* data;  // 元素数组(只读)
+    mod_size_t num;    // 元素个数
+    uint8_t slot;      // 读者计数槽位(内部使用)
+} ulist_snapshot_t;
+
 typedef struct {
     ULIST target;
     mod_offset_t step;
@@ -54,6 +64,7 @@ typedef ulist_iter_t* ULIST_ITER;
 #define ULIST_OPT_IGNORE_SLICE_ERROR 0x10  // 忽略切片越界错误
 #define ULIST_OPT_NO_ERROR_LOG 0x20        // 出错时不打印日志
 #define ULIST_OPT_NO_MUTEX 0x40            // 不使用互斥锁
+#define ULIST_OPT_READ_MOSTLY 0x80  // 读多写少模式(读者无锁访问快照)
 
 /**
  * @brief 初始化一个已创建的列表
@@ -83,6 +94,66 @@ extern bool ulist_init(ULIST list, mod_size_t isize, mod_size_t init_size,
 extern ULIST ulist_new(mod_size_t isize, mod_size_t init_size, uint8_t opt,
                        void (*elfree)(void* item));
 
+/**
+ * @brief 设置列表数据区使用的内存分配器
+ * @param  list         列表结构体
+ * @param  allocator    分配器(NULL: 恢复使用m_alloc)
+ * @retval              是否设置成功
+ * @note 只能在数据区未分配时设置(刚初始化且init_size为0, 或已ulist_clear)
+ * @note 静态定义的ulist_t也可直接初始化.allocator成员
+ */
+extern bool ulist_set_allocator(ULIST list, const mod_allocator_t* allocator);
+
+/**
+ * 读多写少模式(ULIST_OPT_READ_MOSTLY, 需在ulist_init/ulist_new时指定):
+ * 写者照常使用本头文件中的接口修改列表, 每次修改完成(最外层解锁)时
+ * 把数据区复制为新快照并原子地发布, 旧快照在所有可能持有它的读者
+ * 退出后由写者回收; 读者通过ulist_read_lock/unlock访问快照, 不加锁
+ * @note 写者仍使用互斥锁互相排斥, 单写者时可同时指定ULIST_OPT_NO_MUTEX
+ * @note 需启用MOD_CFG_ENABLE_ATOMIC, 否则ulist_init/ulist_new失败
+ * @note 快照是元素的浅拷贝, elfree在修改时立即调用, 元素含指针时需自行延后释放
+ * @note ulist_append等返回元素指针再由调用者填充的接口, 应放在
+ *       ulist_write_begin/end之间, 否则发布的快照中为未填充的元素
+ */
+
+/**
+ * @brief 开始访问列表的当前快照(读者, 不加锁)
+ * @param  list         列表结构体
+ * @param  snap         快照, 在ulist_read_unlock前data保持有效且内容不变
+ * @note 持有快照期间不应阻塞过久, 否则写者无法回收旧快照
+ * @note 未启用读多写少模式时直接返回数据区, 不提供任何保护
+ */
+extern void ulist_read_lock(ULIST list, ulist_snapshot_t* snap);
+
+/**
+ * @brief 结束访问快照
+ * @param  list         列表结构体
+ * @param  snap         由ulist_read_lock获取的快照
+ */
+extern void ulist_read_unlock(ULIST list, ulist_snapshot_t* snap);
+
+/**
+ * @brief 开始一次批量修改, 期间的修改在ulist_write_end时一次性发布
+ * @param  list         列表结构体
+ * @note 期间可通过ulist_get/ulist_foreach等返回的指针直接修改元素
+ * @note 非读多写少模式下只加锁, 可用于使一组操作成为整体
+ */
+extern void ulist_write_begin(ULIST list);
+
+/**
+ * @brief 结束批量修改并发布快照
+ * @param  list         列表结构体
+ */
+extern void ulist_write_end(ULIST list);
+
+/**
+ * @brief 回收已确认没有读者持有的旧快照
+ * @param  list         列表结构体
+ * @retval mod_size_t   仍在等待回收的快照个数
+ * @note 每次发布时都会自动回收, 写入停止后可周期性调用以释放剩余的旧快照
+ */
+extern mod_size_t ulist_reclaim(ULIST list);
+
 /**
  * @brief 将num个空元素追加到列表末尾
  * @param  list    列表结构体
@@ -510,6 +581,17 @@ extern void* __ulist_foreach_init_ptr(ULIST list, mod_offset_t index,
 #define ulist_foreach_to(list, type, var, to_index) \
     ulist_foreach_from_to(list, type, var, 0, to_index)
 
+/**
+ * @brief 循环遍历快照, 就像 `for var in snap` 一样
+ * @param  snap       快照(ulist_snapshot_t*)
+ * @param  type       元素类型
+ * @param  var        循环变量名(const type*)
+ */
+#define ulist_snapshot_foreach(snap, type, var)                           \
+    for (const type *var = (const type*)(snap)->data,                     \
+                    *var##_end = (const type*)(snap)->data + (snap)->num; \
+         var < var##_end; var++)
+
 #ifdef __cplusplus
 }
 #endif
@@ -89,62 +89,265 @@ extern void log_hook(const char* fmt, ...);
 #define __LOG_HOOK(msg, args...) ((void)0)
 #endif
 
-#if LOG_CFG_ENABLE
+#if LOG_CFG_ENABLE && LOG_CFG_ENABLE_DEFER && !defined(__cplusplus)
+#define __LOG_DEFER_ENABLED 1
+#else
+#define __LOG_DEFER_ENABLED 0
+#endif
+
+#if __LOG_DEFER_ENABLED
+#if !MOD_CFG_ENABLE_ATOMIC
+#error "LOG_CFG_ENABLE_DEFER requires MOD_CFG_ENABLE_ATOMIC"
+#endif
+#ifndef LOG_CFG_DEFER_STR_SIZE
+#define LOG_CFG_DEFER_STR_SIZE 32
+#endif
+
+typedef union {  // 延迟日志参数(整数/浮点数/指针统一存为8字节)
+    int64_t i;
+    uint64_t u;
+    double f;
+} log_arg_t;
+
+typedef struct {       // 延迟日志记录
+    const char* fmt;   // 完整格式化字符串(含前缀/颜色/时间戳等格式)
+    uint8_t nargs;     // 参数个数
+    uint8_t str_len;   // str中已使用的长度
+    uint16_t strs;     // 字符串参数(按位), 内容按顺序复制到str中
+    log_arg_t args[LOG_CFG_DEFER_MAX_ARGS];  // 参数
+#if LOG_CFG_DEFER_STR_SIZE
+    char str[LOG_CFG_DEFER_STR_SIZE];  // 字符串参数的副本, 各以'\0'结尾
+#endif
+} log_defer_rec_t;
+
+/**
+ * @brief 将一条日志记录写入延迟队列(由LOG_*宏调用)
+ * @param  fmt              格式化字符串, 须为常量
+ * @param  nargs            参数个数
+ * @param  args             参数
+ * @param  strs             字符串参数(按位), 其内容被复制到记录中
+ * @note 队列满时丢弃该记录并计数, 不会阻塞
+ * @note 字符串总长超过LOG_CFG_DEFER_STR_SIZE时截断
+ */
+extern void log_defer_push(const char* fmt, uint8_t nargs,
+                           const log_arg_t* args, uint16_t strs);
+
+/**
+ * @brief 从延迟队列取出一条记录
+ * @param  rec              记录
+ * @retval bool             是否取出(false: 队列为空)
+ * @note 只允许一个消费者
+ */
+extern bool log_defer_pop(log_defer_rec_t* rec);
+
+/**
+ * @brief 格式化输出延迟队列中的日志(经LOG_CFG_PRINTF)
+ * @param  max              最多输出的条数(0: 直到队列为空)
+ * @retval mod_size_t       输出的条数
+ * @note 应在低优先级任务/主循环中调用
+ * @note 已有其他调用在输出时直接返回0, 不访问队列
+ */
+extern mod_size_t log_defer_drain(mod_size_t max);
+
+/**
+ * @brief 以二进制记录输出延迟队列中的日志, 由主机端工具解码
+ * @param  write            输出函数
+ * @param  max              最多输出的条数(0: 直到队列为空)
+ * @retval mod_size_t       输出的条数
+ * @note 记录格式见tools/log_decode.py, 格式化字符串仅以地址传输
+ * @note 与log_defer_drain互斥, 已有其他调用在输出时直接返回0
+ */
+extern mod_size_t log_defer_drain_bin(void (*write)(const void* data,
+                                                    size_t len),
+                                      mod_size_t max);
+
+/**
+ * @brief 获取并清零因队列满而丢弃的记录数
+ */
+extern mod_size_t log_defer_dropped(void);
+
+static inline log_arg_t __log_arg_i(int64_t v) {
+    log_arg_t a;
+    a.i = v;
+    return a;
+}
+static inline log_arg_t __log_arg_u(uint64_t v) {
+    log_arg_t a;
+    a.u = v;
+    return a;
+}
+static inline log_arg_t __log_arg_f(double v) {
+    log_arg_t a;
+    a.f = v;
+    return a;
+}
+static inline log_arg_t __log_arg_p(const volatile void* v) {
+    log_arg_t a;
+    a.u = (uintptr_t)v;
+    return a;
+}
+
+// 按参数类型在编译期选择存储方式, 指针只记录地址
+#define __LOG_ARG(x)                     \
+    _Generic((x),                        \
+        _Bool: __log_arg_u,              \
+        char: __log_arg_i,               \
+        signed char: __log_arg_i,        \
+        unsigned char: __log_arg_u,      \
+        short: __log_arg_i,              \
+        unsigned short: __log_arg_u,     \
+        int: __log_arg_i,                \
+        unsigned int: __log_arg_u,       \
+        long: __log_arg_i,               \
+        unsigned long: __log_arg_u,      \
+        long long: __log_arg_i,          \
+        unsigned long long: __log_arg_u, \
+        float: __log_arg_f,              \
+        double: __log_arg_f,             \
+        long double: __log_arg_f,        \
+        default: __log_arg_p)(x)
+
+// 字符串参数(char*)的内容在写入队列时复制, 输出时不再访问原缓冲区
+#define __LOG_IS_STR(x) _Generic((x), char*: 1u, const char*: 1u, default: 0u)
+
+#define __LOG_ARGS_0()
+#define __LOG_ARGS_1(a) __LOG_ARG(a)
+#define __LOG_ARGS_2(a, ...) __LOG_ARG(a), __LOG_ARGS_1(__VA_ARGS__)
+#define __LOG_ARGS_3(a, ...) __LOG_ARG(a), __LOG_ARGS_2(__VA_ARGS__)
+#define __LOG_ARGS_4(a, ...) __LOG_ARG(a), __LOG_ARGS_3(__VA_ARGS__)
+#define __LOG_ARGS_5(a, ...) __LOG_ARG(a), __LOG_ARGS_4(__VA_ARGS__)
+#define __LOG_ARGS_6(a, ...) __LOG_ARG(a), __LOG_ARGS_5(__VA_ARGS__)
+#define __LOG_ARGS_7(a, ...) __LOG_ARG(a), __LOG_ARGS_6(__VA_ARGS__)
+#define __LOG_ARGS_8(a, ...) __LOG_ARG(a), __LOG_ARGS_7(__VA_ARGS__)
+#define __LOG_ARGS_9(a, ...) __LOG_ARG(a), __LOG_ARGS_8(__VA_ARGS__)
+#define __LOG_ARGS_10(a, ...) __LOG_ARG(a), __LOG_ARGS_9(__VA_ARGS__)
+#define __LOG_ARGS_11(a, ...) __LOG_ARG(a), __LOG_ARGS_10(__VA_ARGS__)
+#define __LOG_ARGS_12(a, ...) __LOG_ARG(a), __LOG_ARGS_11(__VA_ARGS__)
+#define __LOG_ARGS_13(a, ...) __LOG_ARG(a), __LOG_ARGS_12(__VA_ARGS__)
+#define __LOG_ARGS_14(a, ...) __LOG_ARG(a), __LOG_ARGS_13(__VA_ARGS__)
+#define __LOG_ARGS_15(a, ...) __LOG_ARG(a), __LOG_ARGS_14(__VA_ARGS__)
+#define __LOG_ARGS_16(a, ...) __LOG_ARG(a), __LOG_ARGS_15(__VA_ARGS__)
+
+#define __LOG_STRS_0() 0u
+#define __LOG_STRS_1(a) __LOG_IS_STR(a)
+#define __LOG_STRS_2(a, ...) (__LOG_IS_STR(a) | __LOG_STRS_1(__VA_ARGS__) << 1)
+#define __LOG_STRS_3(a, ...) (__LOG_IS_STR(a) | __LOG_STRS_2(__VA_ARGS__) << 1)
+#define __LOG_STRS_4(a, ...) (__LOG_IS_STR(a) | __LOG_STRS_3(__VA_ARGS__) << 1)
+#define __LOG_STRS_5(a, ...) (__LOG_IS_STR(a) | __LOG_STRS_4(__VA_ARGS__) << 1)
+#define __LOG_STRS_6(a, ...) (__LOG_IS_STR(a) | __LOG_STRS_5(__VA_ARGS__) << 1)
+#define __LOG_STRS_7(a, ...) (__LOG_IS_STR(a) | __LOG_STRS_6(__VA_ARGS__) << 1)
+#define __LOG_STRS_8(a, ...) (__LOG_IS_STR(a) | __LOG_STRS_7(__VA_ARGS__) << 1)
+#define __LOG_STRS_9(a, ...) (__LOG_IS_STR(a) | __LOG_STRS_8(__VA_ARGS__) << 1)
+#define __LOG_STRS_10(a, ...) (__LOG_IS_STR(a) | __LOG_STRS_9(__VA_ARGS__) << 1)
+#define __LOG_STRS_11(a, ...) \
+    (__LOG_IS_STR(a) | __LOG_STRS_10(__VA_ARGS__) << 1)
+#define __LOG_STRS_12(a, ...) \
+    (__LOG_IS_STR(a) | __LOG_STRS_11(__VA_ARGS__) << 1)
+#define __LOG_STRS_13(a, ...) \
+    (__LOG_IS_STR(a) | __LOG_STRS_12(__VA_ARGS__) << 1)
+#define __LOG_STRS_14(a, ...) \
+    (__LOG_IS_STR(a) | __LOG_STRS_13(__VA_ARGS__) << 1)
+#define __LOG_STRS_15(a, ...) \
+    (__LOG_IS_STR(a) | __LOG_STRS_14(__VA_ARGS__) << 1)
+#define __LOG_STRS_16(a, ...) \
+    (__LOG_IS_STR(a) | __LOG_STRS_15(__VA_ARGS__) << 1)
+
+#define __LOG_DEFER(fmt, args...)                                       \
+    do {                                                                \
+        _Static_assert(VA_NUM_ARGS(args) <= LOG_CFG_DEFER_MAX_ARGS,     \
+                       "too many log arguments for deferred mode");     \
+        _Static_assert(LOG_CFG_DEFER_STR_SIZE ||                        \
+                           !(EVAL(__LOG_STRS_, ##args)(args)),          \
+                       "string arguments need LOG_CFG_DEFER_STR_SIZE"); \
+        log_defer_push(fmt, VA_NUM_ARGS(args),                          \
+                       (const log_arg_t[VA_NUM_ARGS(args) + 1]){        \
+                           EVAL(__LOG_ARGS_, ##args)(args)},            \
+                       EVAL(__LOG_STRS_, ##args)(args));                \
+    } while (0)
+
 #define __LOG_OUTPUT(color, pre, lvl, ts, mod, fl, add, suf, fmt, args...) \
     do {                                                                   \
-        LOG_CFG_PRINTF(                                                    \
+        __LOG_DEFER(                                                       \
             pre T_FMT(color)                                               \
                 lvl T_RST ts mod fl add LOG_CFG_MSG_SEPERATOR fmt suf,     \
             ##args);                                                       \
         __LOG_HOOK(lvl ts mod fl LOG_CFG_MSG_SEPERATOR fmt, ##args);       \
     } while (0)
+
+/**
+ * @brief 立即输出延迟队列中的全部日志(断言失败时自动调用)
+ * @note 其他上下文正在输出队列时不做任何操作
+ */
+#define LOG_FLUSH() ((void)log_defer_drain(0))
 #else
-#define __LOG_OUTPUT(color, pre, lvl, ts, mod, fl, add, suf, fmt, args...) \
+#define LOG_FLUSH() ((void)0)
+#endif  // __LOG_DEFER_ENABLED
+
+#if LOG_CFG_ENABLE
+// 不经过延迟队列, 直接输出(断言使用)
+#define __LOG_PRINT(color, pre, lvl, ts, mod, fl, add, suf, fmt, args...) \
+    do {                                                                  \
+        LOG_CFG_PRINTF(                                                   \
+            pre T_FMT(color)                                              \
+                lvl T_RST ts mod fl add LOG_CFG_MSG_SEPERATOR fmt suf,    \
+            ##args);                                                      \
+        __LOG_HOOK(lvl ts mod fl LOG_CFG_MSG_SEPERATOR fmt, ##args);      \
+    } while (0)
+#if !__LOG_DEFER_ENABLED
+#define __LOG_OUTPUT __LOG_PRINT
+#endif
+#else
+#define __LOG_PRINT(color, pre, lvl, ts, mod, fl, add, suf, fmt, args...) \
     ((void)0)
+#define __LOG_OUTPUT __LOG_PRINT
 #endif  // LOG_CFG_ENABLE
 
-#define __LOG_LEVEL(color, pre, lvl, ts, mod, fl, add, suf, fmt, args...)     \
-    __LOG_OUTPUT(color, pre, LOG_CFG_INFO_PREFIX lvl LOG_CFG_INFO_SUFFIX, ts, \
-                 mod, fl, add, suf, fmt, ##args)
+// out: 输出方式(__LOG_OUTPUT/__LOG_PRINT)
+#define __LOG_LEVEL(out, color, pre, lvl, ts, mod, fl, add, suf, fmt,      \
+                    args...)                                               \
+    out(color, pre, LOG_CFG_INFO_PREFIX lvl LOG_CFG_INFO_SUFFIX, ts, mod, fl, \
+        add, suf, fmt, ##args)
 
 #if defined(LOG_MODULE) && LOG_CFG_ENABLE_MODULE_NAME
-#define __LOG_MOD(color, pre, lvl, ts, fl, add, suf, fmt, args...)    \
-    __LOG_LEVEL(color, pre, lvl, ts,                                  \
-                LOG_CFG_INFO_SEPERATOR LOG_CFG_INFO_PREFIX LOG_MODULE \
-                    LOG_CFG_INFO_SUFFIX,                              \
+#define __LOG_MOD(out, color, pre, lvl, ts, fl, add, suf, fmt, args...) \
+    __LOG_LEVEL(out, color, pre, lvl, ts,                              \
+                LOG_CFG_INFO_SEPERATOR LOG_CFG_INFO_PREFIX LOG_MODULE  \
+                    LOG_CFG_INFO_SUFFIX,                               \
                 fl, add, suf, fmt, ##args)
 #else
-#define __LOG_MOD(color, pre, lvl, ts, fl, add, suf, fmt, args...) \
-    __LOG_LEVEL(color, pre, lvl, ts, "", fl, add, suf, fmt, ##args)
+#define __LOG_MOD(out, color, pre, lvl, ts, fl, add, suf, fmt, args...) \
+    __LOG_LEVEL(out, color, pre, lvl, ts, "", fl, add, suf, fmt, ##args)
 #endif
 
 #if LOG_CFG_ENABLE_TIMESTAMP
-#define __LOG_TS(color, pre, lvl, fl, add, suf, fmt, args...)                  \
-    __LOG_MOD(color, pre, lvl,                                                 \
+#define __LOG_TS(out, color, pre, lvl, fl, add, suf, fmt, args...)             \
+    __LOG_MOD(out, color, pre, lvl,                                            \
               LOG_CFG_INFO_SEPERATOR LOG_CFG_INFO_PREFIX LOG_CFG_TIMESTAMP_FMT \
                   LOG_CFG_INFO_SUFFIX,                                         \
               fl, add, suf, fmt, LOG_CFG_TIMESTAMP_FUNC, ##args)
 #elif !_LOG_ENABLE_TIMESTAMP
-#define __LOG_TS(color, pre, lvl, fl, add, suf, fmt, args...) \
-    __LOG_MOD(color, pre, lvl, "", fl, add, suf, fmt, ##args)
+#define __LOG_TS(out, color, pre, lvl, fl, add, suf, fmt, args...) \
+    __LOG_MOD(out, color, pre, lvl, "", fl, add, suf, fmt, ##args)
 #endif  // LOG_CFG_ENABLE_TIMESTAMP
 
 #if LOG_CFG_ENABLE_FUNC_LINE
 #ifndef __FUNCTION__
 #define __FUNCTION__ __func__
 #endif
-#define __LOG_FL(color, pre, lvl, add, suf, fmt, args...) \
-    __LOG_TS(color, pre, lvl,                             \
-             LOG_CFG_INFO_SEPERATOR LOG_CFG_INFO_PREFIX   \
-             "%s:%d" LOG_CFG_INFO_SUFFIX,                 \
+#define __LOG_FL(out, color, pre, lvl, add, suf, fmt, args...) \
+    __LOG_TS(out, color, pre, lvl,                             \
+             LOG_CFG_INFO_SEPERATOR LOG_CFG_INFO_PREFIX        \
+             "%s:%d" LOG_CFG_INFO_SUFFIX,                      \
              add, suf, fmt, __FUNCTION__, __LINE__, ##args)
 #else
-#define __LOG_FL(color, pre, lvl, add, suf, fmt, args...) \
-    __LOG_TS(color, pre, lvl, "", add, suf, fmt, ##args)
+#define __LOG_FL(out, color, pre, lvl, add, suf, fmt, args...) \
+    __LOG_TS(out, color, pre, lvl, "", add, suf, fmt, ##args)
 #endif  // LOG_CFG_ENABLE_FUNC_LINE
 
 #define __LOG(pre, lvl, color, add, suf, fmt, args...) \
-    __LOG_FL(color, pre, lvl, add, suf, fmt, ##args)
+    __LOG_FL(__LOG_OUTPUT, color, pre, lvl, add, suf, fmt, ##args)
+#define __LOG_NOW(pre, lvl, color, add, suf, fmt, args...) \
+    __LOG_FL(__LOG_PRINT, color, pre, lvl, add, suf, fmt, ##args)
 
 #if LOG_CFG_ENABLE
 #define __LOG_LIMIT(_STR, _CLR, limit_ms, fmt, args...)          \
@@ -320,9 +523,16 @@ extern void log_hook(const char* fmt, ...);
     __LOG(LOG_CFG_PREFIX, level, color, "", LOG_CFG_SUFFIX LOG_CFG_NEWLINE, \
           fmt, ##args)
 
-#define __ASSERT_PRINT(text, args...)                         \
-    __LOG(LOG_CFG_PREFIX, LOG_CFG_A_STR, LOG_CFG_A_COLOR, "", \
-          LOG_CFG_SUFFIX LOG_CFG_NEWLINE, text, ##args)
+/**
+ * 断言可能在中断或高优先级任务中失败, 此时输出任务可能正在读队列或不再运行:
+ * 先尝试输出队列中较早的日志(已有消费者时跳过), 断言信息本身直接输出
+ */
+#define __ASSERT_PRINT(text, args...)                                 \
+    do {                                                              \
+        LOG_FLUSH();                                                  \
+        __LOG_NOW(LOG_CFG_PREFIX, LOG_CFG_A_STR, LOG_CFG_A_COLOR, "", \
+                  LOG_CFG_SUFFIX LOG_CFG_NEWLINE, text, ##args);      \
+    } while (0)
 
 #if LOG_CFG_ENABLE_FUNC_LINE
 #define __ASSERT_COMMON(expr) __ASSERT_PRINT("'" #expr "' failed")
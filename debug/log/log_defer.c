@@ -0,0 +1,350 @@
+/**
+ * @file log_defer.c
+ * @brief 延迟日志: 调用方只记录格式化字符串地址和原始参数, 由低优先级任务输出
+ * @author EmbeddedModules contributors
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#include "log.h"
+
+#if __LOG_DEFER_ENABLED
+#include <string.h>
+
+#if LOG_CFG_DEFER_SLOTS & (LOG_CFG_DEFER_SLOTS - 1)
+#error "LOG_CFG_DEFER_SLOTS must be a power of 2"
+#endif
+#if LOG_CFG_DEFER_MAX_ARGS > 16
+#error "LOG_CFG_DEFER_MAX_ARGS must not exceed 16"
+#endif
+#if LOG_CFG_DEFER_STR_SIZE > 255
+#error "LOG_CFG_DEFER_STR_SIZE must not exceed 255"
+#endif
+
+#define SLOT_MASK (LOG_CFG_DEFER_SLOTS - 1)
+#define BIN_SYNC 0xA5     // 二进制记录同步字节
+#define BIN_DROPPED 0xFF  // 丢弃计数记录(nargs位置)
+#define BIN_STRS 0x40     // 记录附带字符串副本(nargs位置的标志位)
+
+/**
+ * 有界多生产者队列(每个槽位带序号):
+ * 槽位序号 = 期望的写入位置 - 槽位下标, 初值全为0, 无需初始化
+ * 生产者用CAS抢占写入位置, 写完后发布序号; 消费者读完后把序号推进一圈
+ */
+typedef struct {
+    mod_atomic_size_t seq;  // 槽位序号
+    log_defer_rec_t rec;    // 记录
+} log_slot_t;
+
+static log_slot_t slots[LOG_CFG_DEFER_SLOTS];
+static mod_atomic_size_t enq_pos;  // 写入位置(生产者共享)
+static mod_size_t deq_pos;         // 读取位置(仅消费者)
+static mod_atomic_size_t dropped;  // 队列满而丢弃的记录数
+static mod_atomic_size_t busy;     // 已有消费者在输出(断言可在任意上下文输出)
+
+/**
+ * @brief 占用消费者, 已被占用时返回false
+ */
+static bool log_defer_claim(void) {
+    mod_size_t idle = 0;
+    while (!MOD_ATOMIC_CAS(busy, idle, 1, MOD_ATOMIC_ORDER_ACQUIRE)) {
+        if (idle) return false;  // CAS失败时idle为当前值, 为0则是伪失败
+    }
+    return true;
+}
+
+static void log_defer_release(void) {
+    MOD_ATOMIC_STORE(busy, 0, MOD_ATOMIC_ORDER_RELEASE);
+}
+
+#if LOG_CFG_DEFER_STR_SIZE
+/**
+ * @brief 把字符串参数的内容依次复制到记录中, 空间不足时截断
+ * @note 空指针不复制, 清除对应位, 输出时与立即模式相同
+ */
+static void log_defer_copy_strs(log_defer_rec_t* rec, uint16_t strs) {
+    size_t len = 0;
+    for (uint8_t i = 0; i < rec->nargs; i++) {
+        if (!(strs >> i & 1)) continue;
+        const char* str = (const char*)(uintptr_t)rec->args[i].u;
+        if (str == NULL) {
+            strs &= ~(1u << i);
+            continue;
+        }
+        if (len >= sizeof(rec->str)) continue;  // 已满, 输出为空字符串
+        size_t n = strnlen(str, sizeof(rec->str) - len - 1);
+        memcpy(rec->str + len, str, n);
+        rec->str[len + n] = '\0';
+        len += n + 1;
+    }
+    rec->strs = strs;
+    rec->str_len = (uint8_t)len;
+}
+#endif
+
+void log_defer_push(const char* fmt, uint8_t nargs, const log_arg_t* args,
+                    uint16_t strs) {
+    mod_size_t pos = MOD_ATOMIC_LOAD(enq_pos, MOD_ATOMIC_ORDER_RELAXED);
+    log_slot_t* slot;
+    while (1) {
+        slot = &slots[pos & SLOT_MASK];
+        mod_size_t seq = MOD_ATOMIC_LOAD(slot->seq, MOD_ATOMIC_ORDER_ACQUIRE);
+        mod_offset_t dif = (mod_offset_t)(seq + (pos & SLOT_MASK) - pos);
+        if (dif == 0) {
+            if (MOD_ATOMIC_CAS(enq_pos, pos, pos + 1, MOD_ATOMIC_ORDER_RELAXED))
+                break;  // 失败时pos已更新为最新值
+        } else if (dif < 0) {  // 消费者尚未读走该槽位, 队列满
+            MOD_ATOMIC_FETCH_ADD(dropped, 1, MOD_ATOMIC_ORDER_RELAXED);
+            return;
+        } else {
+            pos = MOD_ATOMIC_LOAD(enq_pos, MOD_ATOMIC_ORDER_RELAXED);
+        }
+    }
+    slot->rec.fmt = fmt;
+    slot->rec.nargs = nargs;
+    if (nargs) memcpy(slot->rec.args, args, nargs * sizeof(log_arg_t));
+#if LOG_CFG_DEFER_STR_SIZE
+    log_defer_copy_strs(&slot->rec, strs);
+#else
+    (void)strs;  // 编译期已拒绝字符串参数
+    slot->rec.strs = 0;
+    slot->rec.str_len = 0;
+#endif
+    MOD_ATOMIC_STORE(slot->seq, pos + 1 - (pos & SLOT_MASK),
+                     MOD_ATOMIC_ORDER_RELEASE);
+}
+
+bool log_defer_pop(log_defer_rec_t* rec) {
+    mod_size_t pos = deq_pos;
+    log_slot_t* slot = &slots[pos & SLOT_MASK];
+    mod_size_t seq = MOD_ATOMIC_LOAD(slot->seq, MOD_ATOMIC_ORDER_ACQUIRE);
+    if ((mod_offset_t)(seq + (pos & SLOT_MASK) - pos - 1)) return false;
+    rec->fmt = slot->rec.fmt;
+    rec->nargs = slot->rec.nargs;
+    rec->strs = slot->rec.strs;
+    rec->str_len = slot->rec.str_len;
+    memcpy(rec->args, slot->rec.args, rec->nargs * sizeof(log_arg_t));
+#if LOG_CFG_DEFER_STR_SIZE
+    memcpy(rec->str, slot->rec.str, rec->str_len);
+#endif
+    MOD_ATOMIC_STORE(slot->seq, pos + LOG_CFG_DEFER_SLOTS - (pos & SLOT_MASK),
+                     MOD_ATOMIC_ORDER_RELEASE);
+    deq_pos = pos + 1;
+    return true;
+}
+
+mod_size_t log_defer_dropped(void) {
+    mod_size_t n = MOD_ATOMIC_LOAD(dropped, MOD_ATOMIC_ORDER_RELAXED);
+    if (n) MOD_ATOMIC_FETCH_ADD(dropped, (mod_size_t)0 - n,
+                                MOD_ATOMIC_ORDER_RELAXED);
+    return n;
+}
+
+#define SPEC_MAX 24  // 单个转换说明的最大长度
+
+// 按带*宽度/精度的个数调用LOG_CFG_PRINTF
+#define PRINT_SPEC(spec, nstar, star, val)                \
+    do {                                                  \
+        if (nstar == 0)                                   \
+            LOG_CFG_PRINTF(spec, val);                    \
+        else if (nstar == 1)                              \
+            LOG_CFG_PRINTF(spec, star[0], val);           \
+        else                                              \
+            LOG_CFG_PRINTF(spec, star[0], star[1], val);  \
+    } while (0)
+
+/**
+ * @brief 按格式化字符串逐个转换说明输出一条记录
+ * @note 参数类型由转换说明及长度修饰符决定, 与printf的可变参数规则一致
+ * @note 字符串参数的%s输出记录中的副本, %p仍输出原地址
+ */
+static void log_defer_print(const log_defer_rec_t* rec) {
+    const char* p = rec->fmt;
+    const char* lit = p;  // 尚未输出的普通文本起点
+    uint8_t ai = 0;
+    char spec[SPEC_MAX];
+#if LOG_CFG_DEFER_STR_SIZE
+    const char* strp[LOG_CFG_DEFER_MAX_ARGS];  // 各字符串参数的副本
+    size_t off = 0;
+    for (uint8_t i = 0; i < rec->nargs; i++) {
+        if (!(rec->strs >> i & 1)) continue;
+        strp[i] = off < rec->str_len ? rec->str + off : "";
+        off += strlen(strp[i]) + 1;
+    }
+#endif
+    while (*p) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+        if (p > lit) LOG_CFG_PRINTF("%.*s", (int)(p - lit), lit);
+        const char* s = p++;
+        if (*p == '%') {
+            LOG_CFG_PRINTF("%%");
+            lit = ++p;
+            continue;
+        }
+        int star[2];
+        uint8_t nstar = 0;
+        while (*p && strchr("-+ #0", *p)) p++;
+        for (uint8_t field = 0; field < 2; field++) {  // 宽度, 精度
+            if (field == 1) {
+                if (*p != '.') break;
+                p++;
+            }
+            if (*p == '*') {
+                star[nstar++] = ai < rec->nargs ? (int)rec->args[ai++].i : 0;
+                p++;
+            } else {
+                while (*p >= '0' && *p <= '9') p++;
+            }
+        }
+        char len = 0;  // 长度修饰符: h/H(hh)/l/q(ll)/j/z/t/L
+        if (*p == 'h') {
+            len = (*++p == 'h') ? (p++, 'H') : 'h';
+        } else if (*p == 'l') {
+            len = (*++p == 'l') ? (p++, 'q') : 'l';
+        } else if (*p && strchr("jztL", *p)) {
+            len = *p++;
+        }
+        char conv = *p;
+        if (conv) p++;
+        lit = p;
+        size_t n = (size_t)(p - s);
+        if (!conv || n >= SPEC_MAX || ai >= rec->nargs) {
+            LOG_CFG_PRINTF("%.*s", (int)n, s);  // 无法解析或缺少参数
+            continue;
+        }
+        memcpy(spec, s, n);
+        spec[n] = '\0';
+        log_arg_t a = rec->args[ai++];
+        switch (conv) {
+            case 'd':
+            case 'i':
+                if (len == 'l')
+                    PRINT_SPEC(spec, nstar, star, (long)a.i);
+                else if (len == 'q')
+                    PRINT_SPEC(spec, nstar, star, (long long)a.i);
+                else if (len == 'j')
+                    PRINT_SPEC(spec, nstar, star, (intmax_t)a.i);
+                else if (len == 'z' || len == 't')
+                    PRINT_SPEC(spec, nstar, star, (ptrdiff_t)a.i);
+                else
+                    PRINT_SPEC(spec, nstar, star, (int)a.i);
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            case 'c':
+                if (len == 'l')
+                    PRINT_SPEC(spec, nstar, star, (unsigned long)a.u);
+                else if (len == 'q')
+                    PRINT_SPEC(spec, nstar, star, (unsigned long long)a.u);
+                else if (len == 'j')
+                    PRINT_SPEC(spec, nstar, star, (uintmax_t)a.u);
+                else if (len == 'z' || len == 't')
+                    PRINT_SPEC(spec, nstar, star, (size_t)a.u);
+                else
+                    PRINT_SPEC(spec, nstar, star, (unsigned int)a.u);
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if (len == 'L')
+                    PRINT_SPEC(spec, nstar, star, (long double)a.f);
+                else
+                    PRINT_SPEC(spec, nstar, star, a.f);
+                break;
+            case 's':
+#if LOG_CFG_DEFER_STR_SIZE
+                if (rec->strs >> (ai - 1) & 1) {
+                    PRINT_SPEC(spec, nstar, star, strp[ai - 1]);
+                    break;
+                }
+#endif
+                PRINT_SPEC(spec, nstar, star, (const char*)(uintptr_t)a.u);
+                break;
+            case 'p':
+                PRINT_SPEC(spec, nstar, star, (void*)(uintptr_t)a.u);
+                break;
+            default:  // %n等不支持的转换, 原样输出
+                LOG_CFG_PRINTF("%s", spec);
+                break;
+        }
+    }
+    if (p > lit) LOG_CFG_PRINTF("%s", lit);
+}
+
+mod_size_t log_defer_drain(mod_size_t max) {
+    log_defer_rec_t rec;
+    mod_size_t cnt = 0;
+    if (!log_defer_claim()) return 0;
+    mod_size_t lost = log_defer_dropped();
+    if (lost) {
+        LOG_CFG_PRINTF(LOG_CFG_PREFIX T_FMT(LOG_CFG_W_COLOR) LOG_CFG_INFO_PREFIX
+                       "LOG" LOG_CFG_INFO_SUFFIX T_RST LOG_CFG_MSG_SEPERATOR
+                       "%u records dropped" LOG_CFG_SUFFIX LOG_CFG_NEWLINE,
+                       (unsigned int)lost);
+    }
+    while ((!max || cnt < max) && log_defer_pop(&rec)) {
+        log_defer_print(&rec);
+        cnt++;
+    }
+    log_defer_release();
+    return cnt;
+}
+
+/**
+ * 二进制记录(本机字节序):
+ * [0xA5][nargs:1][fmt:sizeof(void*)][args:8*nargs]
+ * 附带字符串副本时nargs置位0x40, 其后追加[strs:2][len:1][str:len]
+ * 丢弃计数记录: [0xA5][0xFF][count:4]
+ */
+mod_size_t log_defer_drain_bin(void (*write)(const void* data, size_t len),
+                               mod_size_t max) {
+    uint8_t buf[2 + sizeof(const char*) +
+                sizeof(log_arg_t) * LOG_CFG_DEFER_MAX_ARGS + 3 +
+                LOG_CFG_DEFER_STR_SIZE];
+    log_defer_rec_t rec;
+    mod_size_t cnt = 0;
+    if (!log_defer_claim()) return 0;
+    uint32_t lost = log_defer_dropped();
+    buf[0] = BIN_SYNC;
+    if (lost) {
+        buf[1] = BIN_DROPPED;
+        memcpy(buf + 2, &lost, sizeof(lost));
+        write(buf, 2 + sizeof(lost));
+    }
+    while ((!max || cnt < max) && log_defer_pop(&rec)) {
+        size_t n = 2;
+        buf[1] = rec.nargs;
+        memcpy(buf + n, &rec.fmt, sizeof(rec.fmt));
+        n += sizeof(rec.fmt);
+        memcpy(buf + n, rec.args, rec.nargs * sizeof(log_arg_t));
+        n += rec.nargs * sizeof(log_arg_t);
+#if LOG_CFG_DEFER_STR_SIZE
+        if (rec.strs) {
+            buf[1] |= BIN_STRS;
+            memcpy(buf + n, &rec.strs, sizeof(rec.strs));
+            n += sizeof(rec.strs);
+            buf[n++] = rec.str_len;
+            memcpy(buf + n, rec.str, rec.str_len);
+            n += rec.str_len;
+        }
+#endif
+        write(buf, n);
+        cnt++;
+    }
+    log_defer_release();
+    return cnt;
+}
+
+#endif  // __LOG_DEFER_ENABLED
@@ -0,0 +1,129 @@
+// 延迟日志回归测试, 检查字符串参数在输出前被修改时仍输出写入时的内容,
+// 以及断言在输出过程中失败时不读队列
+// 在工程根目录构建并运行(-DLOG_CFG_DEFER_STR_SIZE=8测试截断):
+//   gcc -O1 -g -fsanitize=address -Idebug/log/test -I. -Idebug/log
+//       -Iutility/macro -Idebug/minctest debug/log/log_defer.c
+//       debug/log/test/log_defer_test.c -o log_defer_test
+//   ./log_defer_test
+// 全部通过时返回0
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_check.h"
+#include "log.h"
+
+static char m_out[1024];  // LOG_CFG_PRINTF的输出
+static size_t m_len;
+static bool m_irq_assert;  // 下一次输出前模拟中断中的断言失败
+int test_printf(const char* fmt, ...) {
+    if (m_irq_assert) {
+        m_irq_assert = false;
+        LOG_ASSERT(0, "irq");
+    }
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(m_out + m_len, sizeof(m_out) - m_len, fmt, ap);
+    va_end(ap);
+    if (n > 0) m_len += (size_t)n;
+    if (m_len >= sizeof(m_out)) m_len = sizeof(m_out) - 1;
+    return n;
+}
+
+// 输出队列中的全部记录并与期望文本比较
+#define CHECK_DRAIN(expect)                                             \
+    do {                                                                \
+        m_len = 0;                                                      \
+        m_out[0] = '\0';                                                \
+        log_defer_drain(0);                                             \
+        if (strcmp(m_out, expect) != 0)                                 \
+            CHECK_FAIL("%s:%d: got \"%s\"", __FILE__, __LINE__, m_out); \
+    } while (0)
+
+/* 栈上缓冲区在输出前被覆盖 */
+static void test_stack_string(void) {
+    char name[16];
+    strcpy(name, "motor");
+    LOG_INFO("%s=%d", name, 1);
+    char* p = name;  // 非const指针同样复制
+    LOG_INFO("[%-6s]", p);
+    strcpy(name, "XXXXX");
+    CHECK_DRAIN("[INFO] motor=1\n[INFO] [motor ]\n");
+}
+
+/* 多个字符串参数与非字符串参数混合, %p输出原地址 */
+static void test_mixed_args(void) {
+    char a[8] = "ab", b[8] = "cd";
+    char expect[128];
+    snprintf(expect, sizeof(expect), "[INFO] ab %d cd %.1f %p\n", -5, 2.5,
+             (void*)a);
+    LOG_INFO("%s %d %s %.1f %p", a, -5, b, 2.5, a);
+    a[0] = b[0] = 'z';
+    CHECK_DRAIN(expect);
+    const char* none = NULL;
+    LOG_INFO("%s|%s", none, "");
+    CHECK_DRAIN("[INFO] (null)|\n");
+}
+
+/* 字符串总长超过LOG_CFG_DEFER_STR_SIZE时截断, 之后的字符串为空 */
+static void test_truncate(void) {
+    char big[LOG_CFG_DEFER_STR_SIZE * 2];
+    memset(big, 'a', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    char expect[sizeof(big) + 32];
+    snprintf(expect, sizeof(expect), "[INFO] %.*s|\n",
+             LOG_CFG_DEFER_STR_SIZE - 1, big);
+    LOG_INFO("%s|%s", big, "tail");
+    CHECK_DRAIN(expect);
+}
+
+static uint8_t m_bin[256];
+static size_t m_bin_len;
+
+static void bin_write(const void* data, size_t len) {
+    memcpy(m_bin + m_bin_len, data, len);
+    m_bin_len += len;
+}
+
+/* 二进制记录附带字符串副本 */
+static void test_binary(void) {
+    char name[8] = "pump";
+    LOG_INFO("%d %s", 7, name);
+    name[0] = 'X';
+    CHECK(log_defer_drain_bin(bin_write, 0) == 1);
+    size_t off = 2 + sizeof(void*) + 2 * sizeof(log_arg_t);
+    CHECK(m_bin[0] == 0xA5 && m_bin[1] == (0x40 | 2));
+    CHECK(m_bin_len == off + 3 + 5);
+    uint16_t strs;
+    memcpy(&strs, m_bin + off, sizeof(strs));
+    CHECK(strs == 2 && m_bin[off + 2] == 5);
+    CHECK(memcmp(m_bin + off + 3, "pump", 5) == 0);
+}
+
+/* 断言信息直接输出, 队列中较早的记录先输出 */
+static void test_assert(void) {
+    LOG_INFO("before");
+    m_len = 0;
+    LOG_ASSERT(1 + 1 == 3, "x=%d", 3);
+    CHECK(strcmp(m_out, "[INFO] before\n[ASSERT] x=3\n") == 0);
+    CHECK_DRAIN("");
+}
+
+/* 输出队列时断言失败(如在中断中): 不读队列, 原输出不受影响 */
+static void test_assert_in_drain(void) {
+    LOG_INFO("a");
+    LOG_INFO("b");
+    m_irq_assert = true;
+    CHECK_DRAIN("[ASSERT] irq\n[INFO] a\n[INFO] b\n");
+}
+
+int main(void) {
+    test_stack_string();
+    test_mixed_args();
+    test_truncate();
+    test_binary();
+    test_assert();
+    test_assert_in_drain();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,37 @@
+// log主机测试配置
+// 相当于在主机上由Kconfig生成的modules_config.h, 开启延迟输出,
+// 输出重定向到测试程序的缓冲区. 字符串缓冲区大小可用-D指定
+#define MOD_CFG_COMPILER_GCC 1
+#define MOD_CFG_USE_OS_NONE 1
+#define MOD_CFG_PLATFORM_HEADER <stddef.h>
+#define MOD_CFG_TIME_MATHOD_CUSTOM 1
+#define MOD_CFG_CUSTOM_TIME_TYPE_U64 1
+#define MOD_CFG_CUSTOM_TIME_BASE 1000000
+#define MOD_CFG_DELAY_MATHOD_CUSTOM 1
+#define MOD_CFG_HEAP_MATHOD_STDLIB 1
+#define MOD_CFG_ENABLE_ATOMIC 1
+#define LOG_CFG_ENABLE 1
+#define LOG_CFG_LEVEL_USE_TRACE 1
+#define LOG_CFG_ENABLE_COLOR 0
+#define LOG_CFG_I_STR "INFO"
+#define LOG_CFG_A_STR "ASSERT"
+#define LOG_CFG_PRINTF test_printf
+#define LOG_CFG_PREFIX ""
+#define LOG_CFG_SUFFIX ""
+#define LOG_CFG_NEWLINE "\n"
+#define LOG_CFG_INFO_PREFIX "["
+#define LOG_CFG_INFO_SUFFIX "]"
+#define LOG_CFG_INFO_SEPERATOR " "
+#define LOG_CFG_MSG_SEPERATOR " "
+#define LOG_CFG_ENABLE_DEFER 1
+#define LOG_CFG_DEFER_SLOTS 8
+#define LOG_CFG_DEFER_MAX_ARGS 8
+#ifndef LOG_CFG_DEFER_STR_SIZE
+#define LOG_CFG_DEFER_STR_SIZE 32
+#endif
+// 平台头文件中的编译器宏
+#define __weak __attribute__((weak))
+#define __IO volatile
+#define __STATIC_INLINE static inline
+
+extern int test_printf(const char* fmt, ...);
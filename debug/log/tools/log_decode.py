@@ -0,0 +1,242 @@
+"""
+将log_defer_drain_bin()输出的二进制日志还原为文本
+
+记录格式(目标机字节序, 与ELF一致):
+    [0xA5][nargs:1][fmt:指针宽度][args:8*nargs]
+    nargs置位0x40时其后追加[strs:2][len:1][str:len], 为字符串参数的副本
+    [0xA5][0xFF][count:4]  丢弃计数
+
+格式化字符串只以地址传输, 从固件ELF的只读段中取回
+
+用法:
+    python log_decode.py firmware.elf log.bin
+    cat /dev/ttyUSB0 | python log_decode.py firmware.elf -
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+from typing import Dict, List, Optional, Tuple
+
+SYNC = 0xA5
+DROPPED = 0xFF
+STRS = 0x40
+MAX_ARGS = 16
+
+SPEC_RE = re.compile(
+    rb"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|j|z|t|L)?([diouxXcfFeEgGaAspn%])"
+)
+ANSI_RE = re.compile(r"\033\[[0-9;]*[A-Za-z]")
+
+
+class Elf:
+    """只读取已分配且有文件内容的节, 用于按地址取字符串"""
+
+    def __init__(self, path: str):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF":
+            raise ValueError(f"{path} is not an ELF file")
+        self.is64 = data[4] == 2
+        self.endian = "<" if data[5] == 1 else ">"
+        e = self.endian
+        if self.is64:
+            shoff, = struct.unpack_from(e + "Q", data, 0x28)
+            shentsize, shnum = struct.unpack_from(e + "HH", data, 0x3A)
+        else:
+            shoff, = struct.unpack_from(e + "I", data, 0x20)
+            shentsize, shnum = struct.unpack_from(e + "HH", data, 0x2E)
+        self.sections: List[Tuple[int, bytes]] = []
+        for i in range(shnum):
+            off = shoff + i * shentsize
+            if self.is64:
+                _, sh_type, flags, addr, offset, size = struct.unpack_from(
+                    e + "IIQQQQ", data, off
+                )
+            else:
+                _, sh_type, flags, addr, offset, size = struct.unpack_from(
+                    e + "IIIIII", data, off
+                )
+            if flags & 0x2 and sh_type != 8 and size:  # SHF_ALLOC, !NOBITS
+                self.sections.append((addr, data[offset : offset + size]))
+        self.ptr_size = 8 if self.is64 else 4
+        self.long_size = self.ptr_size
+        self.cache: Dict[int, Optional[bytes]] = {}
+
+    def string(self, addr: int) -> Optional[bytes]:
+        if addr in self.cache:
+            return self.cache[addr]
+        s = None
+        for base, blob in self.sections:
+            if base <= addr < base + len(blob):
+                end = blob.find(b"\0", addr - base)
+                if end >= 0:
+                    s = blob[addr - base : end]
+                break
+        self.cache[addr] = s
+        return s
+
+
+def int_bits(elf: Elf, length: bytes) -> int:
+    if length == b"hh":
+        return 8
+    if length == b"h":
+        return 16
+    if length == b"l":
+        return elf.long_size * 8
+    if length in (b"ll", b"j"):
+        return 64
+    if length in (b"z", b"t"):
+        return elf.ptr_size * 8
+    return 32
+
+
+def format_record(
+    elf: Elf, fmt: bytes, raw: List[bytes], strs: Dict[int, bytes]
+) -> str:
+    e = elf.endian
+    args = list(raw)
+    index = 0
+
+    def take() -> Optional[bytes]:
+        nonlocal index
+        if not args:
+            return None
+        index += 1
+        return args.pop(0)
+
+    def as_int(a: bytes, bits: int, signed: bool) -> int:
+        v = struct.unpack(e + "Q", a)[0] & ((1 << bits) - 1)
+        if signed and v >> (bits - 1):
+            v -= 1 << bits
+        return v
+
+    def repl(m: "re.Match[bytes]") -> bytes:
+        flags, width, prec, length, conv = m.groups()
+        if conv == b"%":
+            return b"%"
+        length = length or b""
+        stars = [x for x in (width, prec) if x == b"*"]
+        star_vals = []
+        for _ in stars:
+            a = take()
+            if a is None:
+                return m.group(0)
+            star_vals.append(as_int(a, 32, True))
+        if width == b"*":
+            w = star_vals.pop(0)
+            if w < 0:
+                flags += b"-"
+            width = str(abs(w)).encode()
+        if prec == b"*":
+            prec = str(max(star_vals.pop(0), 0)).encode()
+        a = take()
+        if a is None:
+            return m.group(0)
+        i = index - 1
+        spec = "%" + (flags + (width or b"")).decode()
+        if prec is not None:
+            spec += "." + (prec.decode() or "0")
+        c = conv.decode()
+        if c in "di":
+            return (spec + "d").encode() % as_int(a, int_bits(elf, length), True)
+        if c in "uoxX":
+            v = as_int(a, int_bits(elf, length), False)
+            return (spec + ("d" if c == "u" else c)).encode() % v
+        if c == "c":
+            return (spec + "c").encode() % (as_int(a, 8, False),)
+        if c in "fFeEgGaA":
+            v = struct.unpack(e + "d", a)[0]
+            if c in "aA":
+                return v.hex().encode()
+            return (spec + c).encode() % v
+        addr = as_int(a, elf.ptr_size * 8, False)
+        if c == "p":
+            return (spec + "s").encode() % hex(addr).encode()
+        if c == "s":
+            s = strs[i] if i in strs else elf.string(addr)
+            if s is None:
+                s = f"<{addr:#x}>".encode()
+            return (spec + "s").encode() % s
+        return b""  # %n
+
+    return SPEC_RE.sub(repl, fmt).decode("utf-8", "replace")
+
+
+def decode(elf: Elf, buf: bytearray, out, color: bool) -> None:
+    """解码buf中的完整记录并从buf中移除, 不完整的记录留待下次"""
+    ps = elf.ptr_size
+    while True:
+        start = buf.find(bytes([SYNC]))
+        if start < 0:
+            buf.clear()
+            return
+        del buf[:start]
+        if len(buf) < 2:
+            return
+        nargs = buf[1]
+        if nargs == DROPPED:
+            if len(buf) < 6:
+                return
+            count = struct.unpack_from(elf.endian + "I", buf, 2)[0]
+            text = f"[LOG] {count} records dropped\r\n"
+            del buf[:6]
+        else:
+            has_strs = nargs & STRS
+            nargs &= ~STRS
+            size = 2 + ps + 8 * nargs
+            if nargs > MAX_ARGS:
+                del buf[:1]
+                continue
+            if len(buf) < size + (3 if has_strs else 0):
+                return
+            strs: Dict[int, bytes] = {}
+            if has_strs:
+                mask = struct.unpack_from(elf.endian + "H", buf, size)[0]
+                blob = bytes(buf[size + 3 : size + 3 + buf[size + 2]])
+                size += 3 + buf[size + 2]
+                if len(buf) < size:
+                    return
+                parts = blob.split(b"\0")
+                for i in range(nargs):
+                    if mask >> i & 1:
+                        strs[i] = parts.pop(0) if parts else b""
+            addr = int.from_bytes(buf[2 : 2 + ps], "little" if elf.endian == "<" else "big")
+            fmt = elf.string(addr)
+            if fmt is None:  # 不是有效的格式化字符串地址, 重新同步
+                del buf[:1]
+                continue
+            raw = [bytes(buf[2 + ps + 8 * i : 2 + ps + 8 * (i + 1)]) for i in range(nargs)]
+            text = format_record(elf, fmt, raw, strs)
+            del buf[:size]
+        if not color:
+            text = ANSI_RE.sub("", text)
+        out.write(text)
+        out.flush()
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Decode binary deferred logs")
+    parser.add_argument("elf", help="firmware ELF with symbols/rodata")
+    parser.add_argument("input", help="binary log file, serial device or - for stdin")
+    parser.add_argument("--no-color", action="store_true", help="strip ANSI colors")
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    fd = sys.stdin.fileno() if args.input == "-" else os.open(args.input, os.O_RDONLY)
+    buf = bytearray()
+    try:
+        while True:
+            chunk = os.read(fd, 4096)
+            if not chunk:
+                break
+            buf += chunk
+            decode(elf, buf, sys.stdout, not args.no_color)
+    except (KeyboardInterrupt, BrokenPipeError):
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,49 @@
+/**
+ * @file host_check.h
+ * @brief 主机回归测试共用的检查宏
+ *
+ * 供各模块test目录下的主机测试使用, 构建时加入-Idebug/minctest.
+ * 与minctest.h不同, 不依赖log.h/modules.h, 测试可以自带主机配置.
+ * 失败的检查只计数并打印前CHECK_MAX_REPORTS条, 测试继续执行;
+ * main最后返回CHECK_RESULT()
+ */
+#ifndef __HOST_CHECK_H__
+#define __HOST_CHECK_H__
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef CHECK_MAX_REPORTS
+#define CHECK_MAX_REPORTS 20
+#endif
+
+// 多线程测试可在包含前定义, 使打印不被打断
+#ifndef CHECK_LOCK
+#define CHECK_LOCK()
+#define CHECK_UNLOCK()
+#endif
+
+static int m_fails;
+
+// 记录一次失败, 前CHECK_MAX_REPORTS次按格式打印
+#define CHECK_FAIL(...)                      \
+    do {                                     \
+        CHECK_LOCK();                        \
+        if (m_fails++ < CHECK_MAX_REPORTS) { \
+            printf("  " __VA_ARGS__);        \
+            printf("\n");                    \
+        }                                    \
+        CHECK_UNLOCK();                      \
+    } while (0)
+
+#define CHECK(cond)                                                    \
+    do {                                                               \
+        if (!(cond))                                                   \
+            CHECK_FAIL("%s:%d: CHECK(%s)", __FILE__, __LINE__, #cond); \
+    } while (0)
+
+// 打印总结果, 返回main的退出码
+#define CHECK_RESULT()                          \
+    (printf("%s\n", m_fails ? "FAIL" : "PASS"), \
+     m_fails ? EXIT_FAILURE : EXIT_SUCCESS)
+
+#endif /* __HOST_CHECK_H__ */
@@ -191,6 +191,12 @@ extern void mod_custom_delay_s(m_time_t s);
 #define m_alloc(size) lwmem_malloc(size)
 #define m_free(ptr) lwmem_free(ptr)
 #define m_realloc(ptr, size) lwmem_realloc(ptr, size)
+#elif MOD_CFG_HEAP_MATHOD_TLSF  // tlsf
+#include "tlsf.h"
+#define init_module_heap(ptr, size) tlsf_add_region(NULL, ptr, size)
+#define m_alloc(size) tlsf_malloc(size)
+#define m_free(ptr) tlsf_free(ptr)
+#define m_realloc(ptr, size) tlsf_realloc(ptr, size)
 #elif MOD_CFG_HEAP_MATHOD_KLITE  // klite
 #include "klite.h"
 // You should init klite instead of using this!
@@ -301,29 +307,63 @@ extern void* mod_custom_heap_realloc(void* ptr, size_t size);
 typedef uint32_t mod_size_t;
 typedef int32_t mod_offset_t;
 
+typedef struct {  // 分散/聚集读写的数据段
+    void* base;   // 数据段地址(写入时只读)
+    size_t len;   // 数据段长度
+} mod_iovec_t;
+
+typedef struct {  // 通用内存分配器接口, ctx为分配器自身的上下文
+    void* (*alloc)(void* ctx, size_t size);
+    void* (*realloc)(void* ctx, void* ptr, size_t size);
+    void (*free)(void* ctx, void* ptr);
+    void* ctx;
+} mod_allocator_t;
+
 #if MOD_CFG_ENABLE_ATOMIC
 #include <stdalign.h>
 #include <stdatomic.h>
-typedef atomic_uint_fast32_t mod_atomic_size_t;
-typedef atomic_int_fast32_t mod_atomic_offset_t;
+typedef _Atomic(mod_size_t) mod_atomic_size_t;
+typedef _Atomic(mod_offset_t) mod_atomic_offset_t;
+typedef _Atomic(void*) mod_atomic_ptr_t;
 #define MOD_ATOMIC_INIT(var, val) atomic_init(&(var), (val))
 #define MOD_ATOMIC_LOAD(var, type) atomic_load_explicit(&(var), (type))
 #define MOD_ATOMIC_STORE(var, val, type) \
     atomic_store_explicit(&(var), (val), (type))
+#define MOD_ATOMIC_FETCH_ADD(var, val, type) \
+    atomic_fetch_add_explicit(&(var), (val), (type))
+#define MOD_ATOMIC_CAS(var, expected, desired, type)                    \
+    atomic_compare_exchange_weak_explicit(&(var), &(expected), (desired), \
+                                          (type), __ATOMIC_RELAXED)
 #define MOD_ATOMIC_ORDER_ACQUIRE __ATOMIC_ACQUIRE
 #define MOD_ATOMIC_ORDER_RELEASE __ATOMIC_RELEASE
 #define MOD_ATOMIC_ORDER_RELAXED __ATOMIC_RELAXED
+#define MOD_ATOMIC_ORDER_SEQ_CST __ATOMIC_SEQ_CST
 #else
 typedef uint32_t mod_atomic_size_t;
 typedef int32_t mod_atomic_offset_t;
+typedef void* mod_atomic_ptr_t;
 #define MOD_ATOMIC_INIT(var, val) (var) = (val)
 #define MOD_ATOMIC_LOAD(var, type) (var)
 #define MOD_ATOMIC_STORE(var, val, type) (var) = (val)
+#define MOD_ATOMIC_FETCH_ADD(var, val, type) (((var) += (val)) - (val))
+#define MOD_ATOMIC_CAS(var, expected, desired, type) \
+    ((var) == (expected) ? ((var) = (desired), 1) : ((expected) = (var), 0))
 #define MOD_ATOMIC_ORDER_ACQUIRE 0
 #define MOD_ATOMIC_ORDER_RELEASE 0
 #define MOD_ATOMIC_ORDER_RELAXED 0
+#define MOD_ATOMIC_ORDER_SEQ_CST 0
 #endif
 
+#if MOD_CFG_HEAP_TCACHE && !defined(__TCACHE_BACKEND__)  // 分线程缓存前端
+#include "tcache.h"
+#undef m_alloc
+#undef m_free
+#undef m_realloc
+#define m_alloc(size) tcache_alloc(size)
+#define m_free(ptr) tcache_free(ptr)
+#define m_realloc(ptr, size) tcache_realloc(ptr, size)
+#endif  // MOD_CFG_HEAP_TCACHE
+
 #ifdef __cplusplus
 }
 #endif
@@ -90,13 +90,24 @@ bool EE_Write(uint8_t PageOffset, uint8_t* Data, uint32_t Size, bool Erase) {
     if (Size > EE_SIZE) {
         return false;
     }
-    bool answer = true;
     if (Erase) {
         if (EE_Erase(PageOffset) == false) {
             return false;
         }
     }
-    uint32_t Address = EE_ADDRESS(PageOffset);
+    return EE_WriteAt(PageOffset, 0, Data, Size);
+}
+
+bool EE_WriteAt(uint8_t PageOffset, uint32_t Offset, uint8_t* Data,
+                uint32_t Size) {
+    if (PageOffset >= EE_PAGE_NUMBER) {
+        return false;
+    }
+    if (Offset > EE_SIZE || Size > EE_SIZE - Offset) {
+        return false;
+    }
+    bool answer = true;
+    uint32_t Address = EE_ADDRESS(PageOffset) + Offset;
     do {
 #if EE_CACHE_ENABLE
         SCB_InvalidateICache();
@@ -153,14 +164,13 @@ bool EE_Write(uint8_t PageOffset, uint8_t* Data, uint32_t Size, bool Erase) {
             Data += 16;
         }
 #elif (defined FLASH_TYPEPROGRAM_FLASHWORD)
-        for (uint32_t i = 0; i < Size;
-             i += FLASH_NB_32BITWORD_IN_FLASHWORD * 4) {
+        for (uint32_t i = 0; i < Size; i += EE_PROGRAM_UNIT) {
             if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_FLASHWORD, Address + i,
                                   (uint64_t)(uint32_t)Data) != HAL_OK) {
                 answer = false;
                 break;
             }
-            Data += FLASH_NB_32BITWORD_IN_FLASHWORD * 4;
+            Data += EE_PROGRAM_UNIT;
         }
 #endif
 
@@ -76,6 +76,18 @@ bool EE_Read(uint8_t PageOffset, uint8_t* Data, uint32_t Size);
  */
 bool EE_Write(uint8_t PageOffset, uint8_t* Data, uint32_t Size, bool Erase);
 
+/**
+ * @brief Write data into an erased area of a page
+ * @param PageOffset Page offset (reverse order, 0 is Last page)
+ * @param Offset Byte offset in the page (aligned to the program unit)
+ * @param Data Data buffer
+ * @param Size Data size (multiple of the program unit)
+ * @return true if successful
+ * @note The area must have been erased and not written since
+ */
+bool EE_WriteAt(uint8_t PageOffset, uint32_t Offset, uint8_t* Data,
+                uint32_t Size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -120,6 +120,21 @@
 
 #define EE_FLASH_SIZE ((uint32_t)(FLASH_SIZE))
 
+/* Minimum program unit in bytes, matches the branches of EE_WriteAt() */
+#ifndef EE_PROGRAM_UNIT
+#if (defined FLASH_TYPEPROGRAM_HALFWORD)
+#define EE_PROGRAM_UNIT 2
+#elif (defined FLASH_TYPEPROGRAM_WORD)
+#define EE_PROGRAM_UNIT 4
+#elif (defined FLASH_TYPEPROGRAM_DOUBLEWORD)
+#define EE_PROGRAM_UNIT 8
+#elif (defined FLASH_TYPEPROGRAM_QUADWORD)
+#define EE_PROGRAM_UNIT 16
+#elif (defined FLASH_TYPEPROGRAM_FLASHWORD)
+#define EE_PROGRAM_UNIT (FLASH_NB_32BITWORD_IN_FLASHWORD * 4)
+#endif
+#endif
+
 #ifndef EE_PAGE_NUMBER
 #if (EE_BANK_SELECT == FLASH_BANK_2)
 #define EE_PAGE_NUMBER (EE_FLASH_SIZE / EE_SIZE / 2)
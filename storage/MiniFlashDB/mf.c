@@ -20,12 +20,30 @@ typedef struct {
     mf_key_t key;
 } mf_flash_t;
 
+#ifndef MF_KEY_INDEX_SIZE
+#define MF_KEY_INDEX_SIZE 0
+#endif
+
 static uint8_t mf_temp[MF_FLASH_BLOCK_SIZE];
 static mf_flash_t* mf_data = (mf_flash_t*)mf_temp;
+
+#if MF_KEY_INDEX_SIZE
+static void hidx_clear(void);
+#ifndef MF_FLASH_LOG_BLOCKS  // 日志模式在重放记录时逐个插入
+static void hidx_rebuild(void);
+#endif
+#else
+#define hidx_clear()
+#define hidx_rebuild()
+#define hidx_insert(key)
+#define hidx_remove(key)
+#endif
+#ifndef MF_FLASH_LOG_BLOCKS
 static mf_flash_t* info_main = NULL;
 #ifdef MF_FLASH_BACKUP_ADDR
 static mf_flash_t* info_backup = NULL;
 #endif
+#endif
 
 static void block_calc_sumcheck(mf_flash_t* block) {
     uint8_t sumcheck = 0;
@@ -42,16 +60,27 @@ static void init_temp(void) {
     memcpy(mf_temp, &info, sizeof(info));
     mf_temp[MF_FLASH_BLOCK_SIZE - 1] = MF_FLASH_TAIL;
     block_calc_sumcheck(mf_data);
-}
-
-static bool init_block(mf_flash_t* block) {
-    return mf_erase((uint32_t)block) && mf_write((uint32_t)block, mf_temp);
+    hidx_clear();
 }
 
 static bool block_empty(mf_flash_t* block) {
     return block->key.name_size == 0;
 }
 
+mf_status_t mf_init(void) {
+    mf_status_t status = mf_try_init();
+    if (status == MF_ERR_BLOCK) {
+        return mf_fix();
+    }
+    return status;
+}
+
+#ifndef MF_FLASH_LOG_BLOCKS
+
+static bool init_block(mf_flash_t* block) {
+    return mf_erase((uint32_t)block) && mf_write((uint32_t)block, mf_temp);
+}
+
 static bool block_err(mf_flash_t* block) {
     uint8_t sumcheck = 0;
     for (int i = 0; i < MF_FLASH_BLOCK_SIZE; i++) {
@@ -114,6 +143,7 @@ mf_status_t mf_fix(void) {
 #endif
     }
     memcpy(mf_temp, info_main, MF_FLASH_BLOCK_SIZE);
+    hidx_rebuild();
     return MF_OK;
 }
 
@@ -129,17 +159,10 @@ mf_status_t mf_try_init(void) {
         return MF_ERR_BLOCK;
 
     memcpy(mf_temp, info_main, MF_FLASH_BLOCK_SIZE);
+    hidx_rebuild();
     return MF_OK;
 }
 
-mf_status_t mf_init(void) {
-    mf_status_t status = mf_try_init();
-    if (status == MF_ERR_BLOCK) {
-        return mf_fix();
-    }
-    return status;
-}
-
 mf_status_t mf_save(void) {
 #ifdef MF_FLASH_BACKUP_ADDR
     if (!mf_erase((uint32_t)(info_backup)))
@@ -159,6 +182,7 @@ mf_status_t mf_load(void) {
     if (block_err(info_main))
         return MF_ERR_BLOCK;
     memcpy(mf_temp, info_main, MF_FLASH_BLOCK_SIZE);
+    hidx_rebuild();
     return MF_OK;
 }
 
@@ -173,6 +197,8 @@ mf_status_t mf_purge(void) {
     return MF_OK;
 }
 
+#endif  // !MF_FLASH_LOG_BLOCKS
+
 static const char* get_key_name(mf_key_t* key) {
     return (char*)((uint8_t*)key + sizeof(mf_key_t));
 }
@@ -212,10 +238,129 @@ static mf_key_t* find_last_key(void) {
     return ans;
 }
 
+#if MF_KEY_INDEX_SIZE  // 键值哈希索引
+
+#if (MF_KEY_INDEX_SIZE & (MF_KEY_INDEX_SIZE - 1)) != 0
+#error "MF_KEY_INDEX_SIZE must be a power of 2"
+#endif
+
+#define HIDX_MASK (MF_KEY_INDEX_SIZE - 1)
+
+typedef struct {
+    uint32_t hash;    // 名称哈希(FNV-1a)
+    uint32_t offset;  // 键值在mf_temp中的偏移+1, 0为空槽
+} mf_hidx_t;
+
+static mf_hidx_t hidx[MF_KEY_INDEX_SIZE];  // 开放寻址, 线性探测
+static size_t hidx_count;
+static bool hidx_valid;  // 键值数超出索引容量时回退到顺序查找
+
+static uint32_t name_hash(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+    return hash;
+}
+
+static mf_key_t* hidx_key(const mf_hidx_t* slot) {
+    return (mf_key_t*)(mf_temp + slot->offset - 1);
+}
+
+static void hidx_clear(void) {
+    memset(hidx, 0, sizeof(hidx));
+    hidx_count = 0;
+    hidx_valid = true;
+}
+
+static void hidx_insert(mf_key_t* key) {
+    if (!hidx_valid) {
+        return;
+    }
+    if (hidx_count + 1 >= MF_KEY_INDEX_SIZE) {  // 至少保留一个空槽
+        LOG_WARN("Key index full, increase MF_KEY_INDEX_SIZE");
+        hidx_valid = false;
+        return;
+    }
+    uint32_t hash = name_hash(get_key_name(key));
+    size_t i = hash & HIDX_MASK;
+    while (hidx[i].offset) {
+        i = (i + 1) & HIDX_MASK;
+    }
+    hidx[i].hash = hash;
+    hidx[i].offset = (uint8_t*)key - mf_temp + 1;
+    hidx_count++;
+}
+
+static mf_hidx_t* hidx_find(const char* name) {
+    uint32_t hash = name_hash(name);
+    size_t i = hash & HIDX_MASK;
+    while (hidx[i].offset) {
+        if (hidx[i].hash == hash &&
+            strcmp(name, get_key_name(hidx_key(&hidx[i]))) == 0) {
+            return &hidx[i];
+        }
+        i = (i + 1) & HIDX_MASK;
+    }
+    return NULL;
+}
+
+/**
+ * @brief 删除键值的索引, 并修正其后键值(将被前移)的偏移
+ */
+static void hidx_remove(mf_key_t* key) {
+    if (!hidx_valid) {
+        return;
+    }
+    uint32_t offset = (uint8_t*)key - mf_temp + 1;
+    uint32_t size = get_key_size(key);
+    mf_hidx_t* slot = hidx_find(get_key_name(key));
+    if (slot == NULL) {
+        return;
+    }
+    // 向后移位删除, 保持探测链连续
+    size_t i = slot - hidx;
+    for (size_t j = (i + 1) & HIDX_MASK; hidx[j].offset;
+         j = (j + 1) & HIDX_MASK) {
+        size_t home = hidx[j].hash & HIDX_MASK;
+        if (((j - home) & HIDX_MASK) >= ((j - i) & HIDX_MASK)) {
+            hidx[i] = hidx[j];
+            i = j;
+        }
+    }
+    hidx[i].offset = 0;
+    hidx_count--;
+    for (i = 0; i < MF_KEY_INDEX_SIZE; i++) {
+        if (hidx[i].offset > offset) {
+            hidx[i].offset -= size;
+        }
+    }
+}
+
+#ifndef MF_FLASH_LOG_BLOCKS
+static void hidx_rebuild(void) {
+    hidx_clear();
+    if (block_empty(mf_data)) {
+        return;
+    }
+    for (mf_key_t* key = &mf_data->key; key != NULL; key = get_next_key(key)) {
+        hidx_insert(key);
+    }
+}
+#endif  // !MF_FLASH_LOG_BLOCKS
+
+#endif  // MF_KEY_INDEX_SIZE
+
 static mf_key_t* find_key(const char* name) {
     if (block_empty(mf_data)) {
         return NULL;
     }
+#if MF_KEY_INDEX_SIZE
+    if (hidx_valid) {
+        mf_hidx_t* slot = hidx_find(name);
+        return slot != NULL ? hidx_key(slot) : NULL;
+    }
+#endif
     mf_key_t* ans = &mf_data->key;
     while (ans->next_key) {
         if (strcmp(name, get_key_name(ans)) == 0) {
@@ -277,6 +422,7 @@ mf_status_t mf_add_key(const char* name, const void* data, size_t size) {
     if (last_key != NULL) {
         last_key->next_key = true;
     }
+    hidx_insert(key);
 
     return MF_OK;
 }
@@ -289,6 +435,7 @@ mf_status_t mf_del_key(const char* name) {
     if (key == NULL) {
         return MF_ERR_NULL;
     }
+    hidx_remove(key);
     mf_key_t* last_key = find_last_key();
     size_t key_size = get_key_size(key);
     if (last_key == key) {
@@ -423,3 +570,467 @@ bool mf_iter(mf_keyinfo_t* key) {
                           ._iter_key = (void*)temp};
     return true;
 }
+
+#ifdef MF_FLASH_LOG_BLOCKS  // 日志模式
+
+/**
+ * 日志模式: 键值修改以记录形式追加到MF_FLASH_LOG_BLOCKS个块组成的环中,
+ * mf_save只写入与FLASH中最新记录不同的键值和删除记录, 不擦除整块.
+ * 当前块写满时擦除下一块继续写入, 并把再下一块(最旧的块)中仍有效的记录
+ * 搬到当前块后擦除, 保证始终有一块空闲.
+ * 启动时按块序号重放所有记录, 在RAM中重建各键值最新记录的索引和mf_temp.
+ */
+
+#if MF_FLASH_LOG_BLOCKS < 2
+#error "MF_FLASH_LOG_BLOCKS must be at least 2"
+#endif
+#ifndef MF_FLASH_WRITE_ALIGN
+#define MF_FLASH_WRITE_ALIGN 8
+#endif
+#if (MF_FLASH_WRITE_ALIGN & (MF_FLASH_WRITE_ALIGN - 1)) != 0
+#error "MF_FLASH_WRITE_ALIGN must be a power of 2"
+#endif
+#ifndef MF_FLASH_LOG_KEYS
+#define MF_FLASH_LOG_KEYS 64
+#endif
+
+#define MF_LOG_ALIGN(x)                  \
+    (((x) + MF_FLASH_WRITE_ALIGN - 1) & \
+     ~(size_t)(MF_FLASH_WRITE_ALIGN - 1))
+#define MF_LOG_BUF_SIZE MF_LOG_ALIGN(32)
+#define MF_LOG_HEAD_SIZE MF_LOG_ALIGN(sizeof(mf_log_head_t))
+#define MF_LOG_KEY 0x5A  // 键值记录
+#define MF_LOG_DEL 0xA5  // 删除记录
+
+typedef struct {
+    uint32_t header : 24;  // MF_FLASH_HEADER
+    uint32_t sumcheck : 8;
+    uint32_t seq;  // 块序号, 每次换块递增
+} mf_log_head_t;
+
+typedef struct {
+    uint8_t tag;        // MF_LOG_KEY/MF_LOG_DEL, MF_FLASH_FILL为未写入
+    uint8_t sumcheck;   // 整条记录(含对齐填充)的字节和为0xFF
+    uint8_t name_size;  // 名称长度(含'\0')
+    uint8_t reserved;
+    uint32_t data_size;
+    // char name[name_size]; uint8_t data[data_size]; 填充至对齐
+} mf_rec_t;
+
+static uint8_t log_active;  // 当前写入块
+static uint32_t log_seq;    // 当前写入块序号
+static size_t log_pos;      // 当前写入块内的写入偏移
+static const mf_rec_t* log_index[MF_FLASH_LOG_KEYS];  // 各键值的最新记录
+static size_t log_keys;
+
+static uint8_t log_buf[MF_LOG_BUF_SIZE];  // 写入缓冲, 凑满对齐单位再写入
+static size_t log_buf_len;
+static uint32_t log_buf_addr;
+
+static uint8_t* log_block(uint8_t i) {
+    return (uint8_t*)(uintptr_t)(MF_FLASH_LOG_ADDR(i));
+}
+
+static uint8_t byte_sum(const void* data, size_t size) {
+    const uint8_t* p = data;
+    uint8_t sum = 0;
+    while (size--) {
+        sum += *p++;
+    }
+    return sum;
+}
+
+static bool log_head_valid(uint8_t i) {
+    const mf_log_head_t* head = (const mf_log_head_t*)log_block(i);
+    // 块头写入中断时seq可能仍为擦除值, 而字节和恰好正确
+    return head->header == MF_FLASH_HEADER && head->seq != UINT32_MAX &&
+           byte_sum(head, sizeof(mf_log_head_t)) == 0xFF;
+}
+
+static uint32_t log_head_seq(uint8_t i) {
+    return ((const mf_log_head_t*)log_block(i))->seq;
+}
+
+static const char* rec_name(const mf_rec_t* rec) {
+    return (const char*)rec + sizeof(mf_rec_t);
+}
+
+static const void* rec_data(const mf_rec_t* rec) {
+    return rec_name(rec) + rec->name_size;
+}
+
+static size_t rec_size(const mf_rec_t* rec) {
+    return MF_LOG_ALIGN(sizeof(mf_rec_t) + rec->name_size + rec->data_size);
+}
+
+static bool log_put(const void* data, size_t size) {
+    const uint8_t* p = data;
+    while (size) {
+        size_t n = MF_LOG_BUF_SIZE - log_buf_len;
+        if (n > size) {
+            n = size;
+        }
+        memcpy(log_buf + log_buf_len, p, n);
+        log_buf_len += n;
+        p += n;
+        size -= n;
+        if (log_buf_len == MF_LOG_BUF_SIZE) {
+            if (!mf_program(log_buf_addr, log_buf, MF_LOG_BUF_SIZE)) {
+                return false;
+            }
+            log_buf_addr += MF_LOG_BUF_SIZE;
+            log_buf_len = 0;
+        }
+    }
+    return true;
+}
+
+static bool log_flush(void) {
+    if (log_buf_len == 0) {
+        return true;
+    }
+    size_t size = MF_LOG_ALIGN(log_buf_len);
+    memset(log_buf + log_buf_len, MF_FLASH_FILL, size - log_buf_len);
+    log_buf_len = 0;
+    return mf_program(log_buf_addr, log_buf, size);
+}
+
+static void log_put_begin(void) {
+    log_buf_addr = (uint32_t)(uintptr_t)(log_block(log_active) + log_pos);
+    log_buf_len = 0;
+}
+
+static int index_find(const char* name) {
+    for (size_t i = 0; i < log_keys; i++) {
+        if (strcmp(name, rec_name(log_index[i])) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static bool index_set(const mf_rec_t* rec) {
+    int i = index_find(rec_name(rec));
+    if (i >= 0) {
+        log_index[i] = rec;
+        return true;
+    }
+    if (log_keys >= MF_FLASH_LOG_KEYS) {
+        return false;
+    }
+    log_index[log_keys++] = rec;
+    return true;
+}
+
+static void index_del(size_t i) {
+    log_index[i] = log_index[--log_keys];
+}
+
+/**
+ * @brief 当前块写入失败, 剩余区域的状态未知, 不再写入, 下次追加时换块
+ */
+static mf_status_t log_write_failed(void) {
+    log_pos = MF_FLASH_BLOCK_SIZE;
+    return MF_ERR_IO;
+}
+
+/**
+ * @brief 块i中仍被索引引用的记录的总大小
+ */
+static size_t log_live(uint8_t i) {
+    const uint8_t* begin = log_block(i);
+    const uint8_t* end = begin + MF_FLASH_BLOCK_SIZE;
+    size_t size = 0;
+    for (size_t k = 0; k < log_keys; k++) {
+        const uint8_t* rec = (const uint8_t*)log_index[k];
+        if (rec >= begin && rec < end) {
+            size += rec_size(log_index[k]);
+        }
+    }
+    return size;
+}
+
+/**
+ * @brief 擦除块i并作为新的当前写入块
+ * @note  块i中还有被索引引用的记录(回收未完成)时不擦除, 返回MF_ERR_FULL
+ */
+static mf_status_t log_open(uint8_t i, uint32_t seq) {
+    mf_log_head_t head = {.header = MF_FLASH_HEADER, .sumcheck = 0, .seq = seq};
+    head.sumcheck = 0xFF - byte_sum(&head, sizeof(head));
+    if (log_live(i) != 0) {
+        LOG_ERROR("Log block %d still in use", i);
+        return MF_ERR_FULL;
+    }
+    if (!mf_erase((uint32_t)(uintptr_t)log_block(i))) {
+        return MF_ERR_IO;
+    }
+    log_active = i;
+    log_seq = seq;
+    log_pos = 0;
+    log_put_begin();
+    if (!log_put(&head, sizeof(head)) || !log_flush()) {
+        return log_write_failed();
+    }
+    log_pos = MF_LOG_HEAD_SIZE;
+    return MF_OK;
+}
+
+/**
+ * @brief 把块i中仍有效的记录搬到当前块, 然后擦除块i
+ * @note  删除记录不搬运: 同名的更旧记录只可能在块i中, 会一起被擦除
+ * @note  先检查剩余空间, 放不下时不搬运任何记录, 块i保持不变
+ */
+static mf_status_t log_reclaim(uint8_t i) {
+    const uint8_t* begin = log_block(i);
+    const uint8_t* end = begin + MF_FLASH_BLOCK_SIZE;
+    if (log_pos + log_live(i) > MF_FLASH_BLOCK_SIZE) {
+        return MF_ERR_FULL;
+    }
+    for (size_t k = 0; k < log_keys; k++) {
+        const uint8_t* rec = (const uint8_t*)log_index[k];
+        if (rec < begin || rec >= end) {
+            continue;
+        }
+        size_t size = rec_size(log_index[k]);
+        log_put_begin();
+        if (!log_put(rec, size) || !log_flush()) {
+            return log_write_failed();
+        }
+        log_index[k] = (const mf_rec_t*)(log_block(log_active) + log_pos);
+        log_pos += size;
+    }
+    LOG_DEBUG("Log block %d reclaimed", i);
+    return mf_erase((uint32_t)(uintptr_t)begin) ? MF_OK : MF_ERR_IO;
+}
+
+/**
+ * @brief 切换到下一块写入, 并回收其后的最旧块
+ * @note  新块为空, 最旧块的有效记录一定放得下; 搬运失败时最旧块仍被引用,
+ *        不会被擦除, 新块不再追加记录, 重启后由mf_try_init重新回收
+ */
+static mf_status_t log_rotate(void) {
+    uint8_t next = (log_active + 1) % MF_FLASH_LOG_BLOCKS;
+    mf_status_t status = log_open(next, log_seq + 1);
+    if (status != MF_OK) {
+        return status;
+    }
+    uint8_t oldest = (next + 1) % MF_FLASH_LOG_BLOCKS;
+    if (oldest != next && log_head_valid(oldest)) {
+        return log_reclaim(oldest);
+    }
+    return MF_OK;
+}
+
+/**
+ * @brief 确保当前块剩余size字节, 不足时换块
+ * @note  换块会搬运记录, 之前取得的FLASH中记录的指针需要重新获取
+ */
+static mf_status_t log_reserve(size_t size) {
+    if (size > MF_FLASH_BLOCK_SIZE - MF_LOG_HEAD_SIZE) {
+        return MF_ERR_FULL;
+    }
+    for (uint8_t tries = 0; log_pos + size > MF_FLASH_BLOCK_SIZE; tries++) {
+        if (tries >= MF_FLASH_LOG_BLOCKS) {
+            return MF_ERR_FULL;  // 有效数据已占满所有块
+        }
+        mf_status_t status = log_rotate();
+        if (status != MF_OK) {
+            return status;
+        }
+    }
+    return MF_OK;
+}
+
+/**
+ * @brief 追加一条记录, 当前块空间不足时换块
+ * @retval 操作结果, 成功时*out指向写入的记录
+ */
+static mf_status_t log_append(uint8_t tag, const char* name,
+                              const void* data, size_t data_size,
+                              const mf_rec_t** out) {
+    mf_rec_t rec = {.tag = tag,
+                    .sumcheck = 0,
+                    .name_size = (uint8_t)(strlen(name) + 1),
+                    .reserved = MF_FLASH_FILL,
+                    .data_size = (uint32_t)data_size};
+    size_t size = rec_size(&rec);
+    mf_status_t status = log_reserve(size);
+    if (status != MF_OK) {
+        return status;
+    }
+    size_t pad = size - sizeof(rec) - rec.name_size - data_size;
+    rec.sumcheck = 0xFF - byte_sum(&rec, sizeof(rec)) -
+                   byte_sum(name, rec.name_size) - byte_sum(data, data_size) -
+                   (uint8_t)(pad * MF_FLASH_FILL);
+    log_put_begin();
+    if (!log_put(&rec, sizeof(rec)) || !log_put(name, rec.name_size) ||
+        !log_put(data, data_size) || !log_flush()) {
+        return log_write_failed();
+    }
+    *out = (const mf_rec_t*)(log_block(log_active) + log_pos);
+    log_pos += size;
+    return MF_OK;
+}
+
+/**
+ * @brief 重放块i中的记录
+ * @retval 写入偏移(记录区损坏时返回块大小, 不再向该块追加)
+ */
+static size_t log_replay(uint8_t i) {
+    const uint8_t* block = log_block(i);
+    size_t pos = MF_LOG_HEAD_SIZE;
+    while (pos + sizeof(mf_rec_t) <= MF_FLASH_BLOCK_SIZE) {
+        const mf_rec_t* rec = (const mf_rec_t*)(block + pos);
+        if (rec->tag == MF_FLASH_FILL) {
+            return pos;
+        }
+        size_t size = rec_size(rec);
+        if ((rec->tag != MF_LOG_KEY && rec->tag != MF_LOG_DEL) ||
+            rec->name_size == 0 || rec->data_size > MF_FLASH_BLOCK_SIZE ||
+            pos + size > MF_FLASH_BLOCK_SIZE) {
+            LOG_WARN("Log block %d broken at %d", i, (int)pos);
+            return MF_FLASH_BLOCK_SIZE;
+        }
+        pos += size;
+        if (byte_sum(rec, size) != 0xFF ||
+            rec_name(rec)[rec->name_size - 1] != '\0') {
+            LOG_WARN("Log record at %d:%d dropped", i, (int)(pos - size));
+            continue;  // 写入中断的记录
+        }
+        if (rec->tag == MF_LOG_KEY) {
+            if (!index_set(rec)) {
+                LOG_ERROR("Too many keys, increase MF_FLASH_LOG_KEYS");
+            }
+        } else {
+            int k = index_find(rec_name(rec));
+            if (k >= 0) {
+                index_del(k);
+            }
+        }
+    }
+    return MF_FLASH_BLOCK_SIZE;
+}
+
+mf_status_t mf_load(void) {
+    init_temp();
+    for (size_t i = 0; i < log_keys; i++) {
+        const mf_rec_t* rec = log_index[i];
+        if (mf_add_key(rec_name(rec), rec_data(rec), rec->data_size) !=
+            MF_OK) {
+            return MF_ERR_BLOCK;
+        }
+    }
+    return MF_OK;
+}
+
+mf_status_t mf_try_init(void) {
+    bool found = false;
+    uint32_t last = 0;
+
+    init_temp();
+    log_keys = 0;
+
+    // 按块序号从旧到新重放
+    for (;;) {
+        int pick = -1;
+        for (uint8_t i = 0; i < MF_FLASH_LOG_BLOCKS; i++) {
+            if (!log_head_valid(i) || (found && log_head_seq(i) <= last)) {
+                continue;
+            }
+            if (pick < 0 || log_head_seq(i) < log_head_seq(pick)) {
+                pick = i;
+            }
+        }
+        if (pick < 0) {
+            break;
+        }
+        found = true;
+        last = log_head_seq(pick);
+        log_active = pick;
+        log_seq = last;
+        log_pos = log_replay(pick);
+    }
+    if (!found) {
+        return MF_ERR_BLOCK;
+    }
+
+    // 换块后未完成回收时断电, 此时当前块中只有搬运来的记录
+    uint8_t oldest = (log_active + 1) % MF_FLASH_LOG_BLOCKS;
+    if (oldest != log_active && log_head_valid(oldest)) {
+        // 搬运中断或剩余空间不足, 放弃当前块, 由上一块重新换块回收
+        if (log_pos + log_live(oldest) > MF_FLASH_BLOCK_SIZE) {
+            LOG_WARN("Log block %d dropped", log_active);
+            if (!mf_erase((uint32_t)(uintptr_t)log_block(log_active))) {
+                return MF_ERR_IO;
+            }
+            return mf_try_init();
+        }
+        mf_status_t status = log_reclaim(oldest);
+        if (status != MF_OK) {
+            return status;
+        }
+    }
+    return mf_load();
+}
+
+mf_status_t mf_purge(void) {
+    init_temp();
+    log_keys = 0;
+    for (uint8_t i = 1; i < MF_FLASH_LOG_BLOCKS; i++) {
+        if (!mf_erase((uint32_t)(uintptr_t)log_block(i))) {
+            return MF_ERR_IO;
+        }
+    }
+    return log_open(0, 1);
+}
+
+mf_status_t mf_fix(void) {
+    if (mf_try_init() == MF_OK) {
+        return MF_OK;
+    }
+    LOG_WARN("No valid log block, formatting");
+    return mf_purge();
+}
+
+mf_status_t mf_save(void) {
+    mf_status_t status;
+    const mf_rec_t* rec;
+    mf_keyinfo_t key = {0};
+
+    while (mf_iter(&key)) {
+        int i = index_find(key.name);
+        if (i >= 0 && log_index[i]->data_size == key.data_size &&
+            memcmp(rec_data(log_index[i]), key.data, key.data_size) == 0) {
+            continue;  // 未修改
+        }
+        if (i < 0 && log_keys >= MF_FLASH_LOG_KEYS) {
+            return MF_ERR_FULL;
+        }
+        status = log_append(MF_LOG_KEY, key.name, key.data, key.data_size,
+                            &rec);
+        if (status != MF_OK) {
+            return status;
+        }
+        index_set(rec);
+    }
+
+    for (size_t i = log_keys; i-- > 0;) {
+        if (find_key(rec_name(log_index[i])) != NULL) {
+            continue;
+        }
+        // 先换块, 名称取自FLASH中的记录, 换块时可能被搬运
+        status = log_reserve(
+            MF_LOG_ALIGN(sizeof(mf_rec_t) + log_index[i]->name_size));
+        if (status != MF_OK) {
+            return status;
+        }
+        status = log_append(MF_LOG_DEL, rec_name(log_index[i]), NULL, 0, &rec);
+        if (status != MF_OK) {
+            return status;
+        }
+        index_del(i);
+    }
+    return MF_OK;
+}
+
+#endif  // MF_FLASH_LOG_BLOCKS
@@ -47,7 +47,8 @@ mf_status_t mf_try_init(void);
 
 /**
  * @brief  执行数据库保存
- * @retval 操作结果 (MF_OK/MF_ERR_IO)
+ * @retval 操作结果 (MF_OK/MF_ERR_IO/MF_ERR_FULL)
+ * @note   日志模式下只追加有修改的键值记录, 不擦除整块
  */
 mf_status_t mf_save(void);
 
@@ -68,6 +69,7 @@ mf_status_t mf_purge(void);
  * @brief   尝试修复数据库
  * @retval  操作结果 (MF_OK/MF_ERR_IO)
  * @note    错误时, 如存在有效BACKUP区则恢复, 否则清空数据库
+ * @note    日志模式下, 无任何有效日志块时清空数据库
  * @warning 会丢弃所有未保存的更改
  */
 mf_status_t mf_fix(void);
@@ -17,6 +17,29 @@
 /* 备份FLASH地址，注释则不使用 */
 #define MF_FLASH_BACKUP_ADDR EE_ADDRESS(1)  // 倒数第二个page
 
+/* 日志模式: 由MF_FLASH_LOG_BLOCKS(>=2)个块组成环形日志, 注释则使用单块模式 */
+// #define MF_FLASH_LOG_BLOCKS 4
+// #define MF_FLASH_LOG_ADDR(i) EE_ADDRESS(i)  // 第i个日志块的地址
+
+/* 日志模式: FLASH最小写入单位(字节, 2的幂), 记录按此对齐
+ * 注释时取EE_WriteAt的编程单位(H5/U5为16字节, H7为32字节), 至少为8字节 */
+// #define MF_FLASH_WRITE_ALIGN 16
+#if defined(MF_FLASH_LOG_BLOCKS) && !defined(MF_FLASH_WRITE_ALIGN)
+#ifndef EE_PROGRAM_UNIT
+#error "EE_PROGRAM_UNIT unknown, define MF_FLASH_WRITE_ALIGN manually"
+#elif EE_PROGRAM_UNIT > 8
+#define MF_FLASH_WRITE_ALIGN EE_PROGRAM_UNIT
+#else
+#define MF_FLASH_WRITE_ALIGN 8
+#endif
+#endif
+
+/* 日志模式: 最大键值数量 */
+#define MF_FLASH_LOG_KEYS 64
+
+/* 键值哈希索引槽数(2的幂, 需大于键值数量), 注释则顺序查找键值 */
+// #define MF_KEY_INDEX_SIZE 64
+
 /* FLASH空数据填充值 */
 #define MF_FLASH_FILL 0xFF
 
@@ -31,6 +54,7 @@
  * @param addr 起始地址
  * @retval 操作结果 true: 成功, false: 失败
  * @note   实际入参只可能是MF_FLASH_MAIN_ADDR或MF_FLASH_BACKUP_ADDR，可以考虑简化
+ *         (日志模式下为MF_FLASH_LOG_ADDR(i))
  */
 __attribute__((unused)) static bool mf_erase(uint32_t addr) {
     uint8_t offset;
@@ -76,3 +100,33 @@ __attribute__((unused)) static bool mf_write(uint32_t addr, void* buf) {
     }
     return true;
 }
+
+/**
+ * @brief 从addr开始，写入size字节数据(日志模式使用)
+ * @param addr 起始地址(按MF_FLASH_WRITE_ALIGN对齐)
+ * @param buf 数据指针
+ * @param size 数据大小(MF_FLASH_WRITE_ALIGN的整数倍)
+ * @retval 操作结果 true: 成功, false: 失败
+ * @note   写入区域擦除后未被写过, 不会跨越块边界
+ */
+__attribute__((unused)) static bool mf_program(uint32_t addr, const void* buf,
+                                               size_t size) {
+    uint8_t offset;
+    for (offset = 0;; offset++) {
+        if (offset >= EE_PAGE_NUMBER) {
+            LOG_ERROR("failed find page %p", addr);
+            return false;
+        }
+        uint32_t page = (uint32_t)EE_PageAddress(offset);
+        if (addr >= page && addr - page < EE_SIZE) {
+            break;
+        }
+    }
+    uint32_t page_offset = addr - (uint32_t)EE_PageAddress(offset);
+    LOG_TRACE("programming offset %d+%d, size=%d", offset, page_offset, size);
+    if (!EE_WriteAt(offset, page_offset, (uint8_t*)buf, size)) {
+        LOG_ERROR("program failed at offset %d (%p)", offset, addr);
+        return false;
+    }
+    return true;
+}
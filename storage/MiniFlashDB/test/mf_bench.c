@@ -0,0 +1,101 @@
+// MiniFlashDB键值查找基准测试, 比较顺序查找与哈希索引
+// 在工程根目录构建并运行(-DMF_KEY_INDEX_SIZE=512开启哈希索引):
+//   gcc -O2 -fno-pie -no-pie -DMF_SIM_BLOCK_SIZE=16384 -DMF_FLASH_LOG_KEYS=256
+//       [-DMF_KEY_INDEX_SIZE=512] -Istorage/MiniFlashDB/test
+//       -Istorage/MiniFlashDB storage/MiniFlashDB/mf.c
+//       storage/MiniFlashDB/test/mf_bench.c -o mf_bench
+//   ./mf_bench [键值数量]
+// 键值名形如"config.key_N", 数据4~12字节, 查找顺序随机
+#include <time.h>
+
+#include "mf.h"
+#include "mf_hal.h"
+
+#define BENCH_KEYS 200
+#define BENCH_ROUNDS 2000
+
+#ifndef MF_KEY_INDEX_SIZE
+#define MF_KEY_INDEX_SIZE 0  // 顺序查找
+#endif
+
+uint8_t mf_sim_flash[MF_FLASH_BLOCK_SIZE * MF_SIM_BLOCKS];
+bool mf_sim_verbose;
+long mf_sim_programs, mf_sim_erases, mf_sim_crash_at, mf_sim_fail_at;
+jmp_buf mf_sim_crash;
+
+static char m_names[MF_FLASH_LOG_KEYS][32];
+static int m_order[MF_FLASH_LOG_KEYS];
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char* argv[]) {
+    int keys = BENCH_KEYS;
+    if (argc > 1)
+        keys = atoi(argv[1]);
+    if (keys <= 0 || keys > MF_FLASH_LOG_KEYS) {
+        printf("key count must be 1~%d\n", MF_FLASH_LOG_KEYS);
+        return EXIT_FAILURE;
+    }
+    if (mf_init() != MF_OK)
+        return EXIT_FAILURE;
+    for (int k = 0; k < keys; k++) {
+        uint32_t val[3] = {(uint32_t)k, 0, 0};
+        sprintf(m_names[k], "config.key_%d", k);
+        if (mf_add_key(m_names[k], val, 4 + (k % 3) * 4) != MF_OK) {
+            printf("add key %d failed\n", k);
+            return EXIT_FAILURE;
+        }
+        m_order[k] = k;
+    }
+    srand(1);
+    for (int k = keys - 1; k > 0; k--) {
+        int j = rand() % (k + 1);
+        int t = m_order[k];
+        m_order[k] = m_order[j];
+        m_order[j] = t;
+    }
+
+    uint64_t start = host_ns();
+    if (mf_save() != MF_OK || mf_init() != MF_OK)
+        return EXIT_FAILURE;
+    uint64_t init_ns = host_ns() - start;
+
+    volatile uint32_t acc = 0;
+    start = host_ns();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int k = 0; k < keys; k++) {
+            uint32_t val[3];
+            mf_get_key(m_names[m_order[k]], val, sizeof(val));
+            acc += val[0];
+        }
+    }
+    uint64_t get_ns = host_ns() - start;
+
+    start = host_ns();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int k = 0; k < keys; k++)
+            acc += mf_has_key(m_names[m_order[k]]);
+    }
+    uint64_t has_ns = host_ns() - start;
+
+    start = host_ns();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        int k = m_order[r % keys];
+        uint32_t val[3] = {(uint32_t)r, 0, 0};
+        mf_set_key(m_names[k], val, 4 + (k % 3) * 4);
+    }
+    uint64_t set_ns = host_ns() - start;
+
+    uint64_t lookups = (uint64_t)BENCH_ROUNDS * keys;
+    printf("%d keys, index slots %d\n", keys, MF_KEY_INDEX_SIZE);
+    printf("  save+init   %10.1f us\n", init_ns / 1000.0);
+    printf("  mf_get_key  %10.1f ns\n", (double)get_ns / lookups);
+    printf("  mf_has_key  %10.1f ns\n", (double)has_ns / lookups);
+    printf("  mf_set_key  %10.1f ns\n", (double)set_ns / BENCH_ROUNDS);
+    printf("  (acc=%u)\n", acc);
+    return 0;
+}
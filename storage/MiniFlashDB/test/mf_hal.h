@@ -0,0 +1,101 @@
+/**
+ * MiniFlashDB主机测试的HAL: 以RAM数组模拟FLASH, 默认使用日志模式
+ * 可注入写入失败(mf_program返回false)和断电(写入一半后longjmp)
+ */
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TRACE(...)
+#define LOG_DEBUG(...)
+#define LOG_INFO(...)
+#define LOG_WARN(fmt, ...)                         \
+    do {                                           \
+        if (mf_sim_verbose)                        \
+            printf("W: " fmt "\n", ##__VA_ARGS__); \
+    } while (0)
+#define LOG_ERROR(fmt, ...) LOG_WARN(fmt, ##__VA_ARGS__)
+
+#ifndef MF_SIM_BLOCK_SIZE
+#define MF_SIM_BLOCK_SIZE 512
+#endif
+#ifndef MF_SIM_BLOCKS
+#define MF_SIM_BLOCKS 3
+#endif
+
+#define MF_FLASH_BLOCK_SIZE MF_SIM_BLOCK_SIZE
+#define MF_FLASH_MAIN_ADDR ((uint32_t)(uintptr_t)mf_sim_flash)
+#define MF_FLASH_LOG_BLOCKS MF_SIM_BLOCKS
+#define MF_FLASH_LOG_ADDR(i) \
+    ((uint32_t)(uintptr_t)(mf_sim_flash + (i) * MF_FLASH_BLOCK_SIZE))
+#ifndef MF_FLASH_WRITE_ALIGN
+#define MF_FLASH_WRITE_ALIGN 8
+#endif
+#ifndef MF_FLASH_LOG_KEYS
+#define MF_FLASH_LOG_KEYS 32
+#endif
+#define MF_FLASH_FILL 0xFF
+#define MF_FLASH_HEADER 0xCAFEBA
+#define MF_FLASH_TAIL 0xBE
+
+extern uint8_t mf_sim_flash[MF_FLASH_BLOCK_SIZE * MF_SIM_BLOCKS];
+extern bool mf_sim_verbose;
+extern long mf_sim_programs;  // 累计写入字节数
+extern long mf_sim_erases;    // 累计擦除次数
+extern long mf_sim_crash_at;  // 第n次写入单位/擦除时断电(0: 不断电)
+extern long mf_sim_fail_at;   // 第n次mf_program返回失败(0: 不失败)
+extern jmp_buf mf_sim_crash;
+
+static inline bool mf_sim_tick(long* counter) {
+    return *counter > 0 && --*counter == 0;
+}
+
+static inline bool mf_erase(uint32_t addr) {
+    uint8_t* p = (uint8_t*)(uintptr_t)addr;
+    if ((p - mf_sim_flash) % MF_FLASH_BLOCK_SIZE != 0)
+        abort();
+    mf_sim_erases++;
+    if (mf_sim_tick(&mf_sim_crash_at)) {
+        memset(p, 0x00, MF_FLASH_BLOCK_SIZE / 4);  // 擦除到一半
+        longjmp(mf_sim_crash, 1);
+    }
+    memset(p, 0xFF, MF_FLASH_BLOCK_SIZE);
+    return true;
+}
+
+static inline bool mf_write(uint32_t addr, void* buf) {
+    (void)addr;
+    (void)buf;
+    abort();  // 日志模式不使用
+}
+
+static inline bool mf_program(uint32_t addr, const void* buf, size_t size) {
+    uint8_t* p = (uint8_t*)(uintptr_t)addr;
+    size_t offset = p - mf_sim_flash;
+    if (offset % MF_FLASH_WRITE_ALIGN || size % MF_FLASH_WRITE_ALIGN ||
+        offset / MF_FLASH_BLOCK_SIZE !=
+            (offset + size - 1) / MF_FLASH_BLOCK_SIZE) {
+        printf("bad program at %zu size %zu\n", offset, size);
+        abort();
+    }
+    for (size_t i = 0; i < size; i++) {
+        if (p[i] != 0xFF) {
+            printf("program over written data at %zu\n", offset + i);
+            abort();
+        }
+    }
+    if (mf_sim_tick(&mf_sim_fail_at))
+        return false;
+    for (size_t i = 0; i < size; i += MF_FLASH_WRITE_ALIGN) {
+        if (mf_sim_tick(&mf_sim_crash_at)) {
+            memcpy(p + i, (const uint8_t*)buf + i, MF_FLASH_WRITE_ALIGN / 2);
+            longjmp(mf_sim_crash, 1);
+        }
+        memcpy(p + i, (const uint8_t*)buf + i, MF_FLASH_WRITE_ALIGN);
+    }
+    mf_sim_programs += size;
+    return true;
+}
@@ -0,0 +1,165 @@
+// MiniFlashDB日志模式回归测试, 使用本目录mf_hal.h模拟的FLASH
+// 在工程根目录构建并运行(FLASH地址为uint32_t, 64位主机上需非PIE链接,
+// 使模拟FLASH的数组位于低4GB):
+//   gcc -O2 -fno-pie -no-pie -Istorage/MiniFlashDB/test -Istorage/MiniFlashDB
+//       -Idebug/minctest storage/MiniFlashDB/mf.c
+//       storage/MiniFlashDB/test/mf_test.c -o mf_test
+//   ./mf_test
+// 全部通过时返回0. 每次保存后模拟重启, 检查FLASH中的数据与最后一次
+// 成功保存的内容一致; 保存中途断电或写入失败时, 每个键值只能是旧值或新值
+#include "host_check.h"
+#include "mf.h"
+#include "mf_hal.h"
+
+#define TEST_KEYS 10
+#define TEST_ROUNDS 20000
+
+uint8_t mf_sim_flash[MF_FLASH_BLOCK_SIZE * MF_SIM_BLOCKS];
+bool mf_sim_verbose;
+long mf_sim_programs, mf_sim_erases, mf_sim_crash_at, mf_sim_fail_at;
+jmp_buf mf_sim_crash;
+
+typedef struct {  // 键值模型
+    bool have;
+    uint32_t val;
+} model_t;
+
+static model_t m_ram[TEST_KEYS];    // RAM中的最新修改
+static model_t m_saved[TEST_KEYS];  // 最后一次成功保存的内容
+
+static void key_name(int k, char* name) {
+    sprintf(name, "key_%d", k);
+}
+
+static size_t key_size(int k) {
+    return 4 + (k % 5) * 8;
+}
+
+static void key_set(int k, uint32_t val) {
+    char name[16];
+    uint8_t buf[64] = {0};
+    key_name(k, name);
+    memcpy(buf, &val, sizeof(val));
+    CHECK(mf_set_key(name, buf, key_size(k)) == MF_OK);
+    m_ram[k] = (model_t){true, val};
+}
+
+static void key_del(int k) {
+    char name[16];
+    key_name(k, name);
+    mf_del_key(name);
+    m_ram[k].have = false;
+}
+
+static bool key_read(int k, model_t* out) {
+    char name[16];
+    uint8_t buf[64];
+    key_name(k, name);
+    out->have = mf_has_key(name);
+    out->val = 0;
+    if (!out->have)
+        return true;
+    if (mf_get_key_size(name) != key_size(k) ||
+        mf_get_key(name, buf, sizeof(buf)) != MF_OK)
+        return false;
+    memcpy(&out->val, buf, sizeof(out->val));
+    return true;
+}
+
+static bool model_eq(const model_t* a, const model_t* b) {
+    return a->have == b->have && (!a->have || a->val == b->val);
+}
+
+/* 模拟重启, strict时要求与m_saved一致, 否则每个键值是旧值或新值之一 */
+static bool reboot(bool strict) {
+    mf_sim_crash_at = 0;
+    mf_sim_fail_at = 0;
+    if (mf_init() != MF_OK)
+        return false;
+    for (int k = 0; k < TEST_KEYS; k++) {
+        model_t got;
+        if (!key_read(k, &got))
+            return false;
+        if (!model_eq(&got, &m_saved[k]) &&
+            (strict || !model_eq(&got, &m_ram[k]))) {
+            printf("  key %d: have %d val %u\n", k, got.have, got.val);
+            return false;
+        }
+        m_saved[k] = m_ram[k] = got;
+    }
+    return true;
+}
+
+/* 回收最旧块时写入失败, 之后继续保存也不能擦除仍有有效记录的块 */
+static void test_reclaim_io_error(void) {
+    const int last = TEST_KEYS - 1;  // 最后遍历的键值, 换块后不再比较其他键值
+    memset(mf_sim_flash, 0x5A, sizeof(mf_sim_flash));
+    memset(m_ram, 0, sizeof(m_ram));
+    memset(m_saved, 0, sizeof(m_saved));
+    CHECK(mf_init() == MF_OK);
+    for (int k = 0; k < TEST_KEYS; k++)
+        key_set(k, k);
+    CHECK(mf_save() == MF_OK);
+    memcpy(m_saved, m_ram, sizeof(m_ram));
+    for (int fail = 1; fail < 32; fail++) {
+        // 修改所有键值, FLASH中较旧的记录与最新值不同
+        for (int k = 0; k < TEST_KEYS; k++)
+            key_set(k, m_ram[k].val + 1);
+        if (mf_save() == MF_OK)
+            memcpy(m_saved, m_ram, sizeof(m_ram));
+        // 第fail次写入失败, 之后不重启继续保存, 直到再换块两次
+        mf_sim_fail_at = fail;
+        long erases = -1;
+        for (int i = 0; i < 200; i++) {
+            key_set(last, m_ram[last].val + 1);
+            if (mf_save() == MF_OK)
+                memcpy(m_saved, m_ram, sizeof(m_ram));
+            if (mf_sim_fail_at == 0 && erases < 0)
+                erases = mf_sim_erases;
+            if (erases >= 0 && mf_sim_erases > erases + 1)
+                break;
+        }
+        if (!reboot(false)) {
+            CHECK_FAIL("fail at program %d", fail);
+            return;
+        }
+    }
+}
+
+/* 随机修改/删除/保存, 保存时随机断电或写入失败 */
+static void test_random_power_loss(void) {
+    memset(mf_sim_flash, 0x5A, sizeof(mf_sim_flash));
+    memset(m_ram, 0, sizeof(m_ram));
+    memset(m_saved, 0, sizeof(m_saved));
+    CHECK(mf_init() == MF_OK);
+    srand(1);
+    for (int it = 0; it < TEST_ROUNDS && !m_fails; it++) {
+        int k = rand() % TEST_KEYS;
+        if (rand() % 10 < 8)
+            key_set(k, (uint32_t)rand());
+        else
+            key_del(k);
+        if (rand() % 3 != 0)
+            continue;
+        int fault = rand() % 8;
+        if (fault == 0)
+            mf_sim_crash_at = 1 + rand() % 20;
+        else if (fault == 1)
+            mf_sim_fail_at = 1 + rand() % 20;
+        volatile bool ok = false;  // setjmp返回后仍需读取
+        if (setjmp(mf_sim_crash) == 0)
+            ok = mf_save() == MF_OK;
+        if (ok)
+            memcpy(m_saved, m_ram, sizeof(m_ram));
+        if (!reboot(ok))
+            CHECK_FAIL("round %d fault %d save %d", it, fault, ok);
+    }
+}
+
+int main(void) {
+    test_reclaim_io_error();
+    test_random_power_loss();
+    printf("%s (programmed %ld bytes, %ld erases)\n", m_fails ? "FAIL" : "PASS",
+           mf_sim_programs, mf_sim_erases);
+    return m_fails ? EXIT_FAILURE : EXIT_SUCCESS;
+}
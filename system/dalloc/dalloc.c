@@ -26,12 +26,22 @@
 #endif
 
 #define FREEFLAG_GET(arr) ((arr.alloc_info) >> _OFFSET & 0x01)
-#define FREEFLAG_SET(arr) ((arr.alloc_info) |= (1 << _OFFSET))
-#define FREEFLAG_CLR(arr) ((arr.alloc_info) &= ~(1 << _OFFSET))
+#define FREEFLAG_SET(arr) ((arr.alloc_info) |= (1UL << _OFFSET))
+#define FREEFLAG_CLR(arr) ((arr.alloc_info) &= ~(1UL << _OFFSET))
 
-#define ALLOCSIZE_GET(arr) ((arr.alloc_info) & ~(1 << _OFFSET))
+#define ALLOCSIZE_GET(arr) ((arr.alloc_info) & ~(1UL << _OFFSET))
 #define ALLOCSIZE_SET(arr, size) \
-    (arr.alloc_info) = ((size) | ((arr.alloc_info) & (1 << _OFFSET)))
+    (arr.alloc_info) = ((size) | ((arr.alloc_info) & (1UL << _OFFSET)))
+
+#if DALLOC_SCALABLE_MODE
+/* Freed entries and dead slots stay in the index until compaction */
+#define ENTRY_LIVE(heap, i)                                 \
+    (!FREEFLAG_GET((heap)->alloc_info.ptr_info_arr[i]) &&   \
+     ((i) < (heap)->alloc_info.compact_keep ||              \
+      (i) >= (heap)->alloc_info.compact_scan))
+#else
+#define ENTRY_LIVE(heap, i) 1
+#endif
 
 #if USE_SINGLE_HEAP_MEMORY
 /* define single_heap array somewhere in your code, like on the example below:
@@ -48,6 +58,8 @@ uint8_t single_heap[SINGLE_HEAP_SIZE] _HEAP_SET_ADDR(HEAP_LOCATION) = {0};
 bool memory_init_flag = false;
 #endif
 
+#if !DALLOC_SCALABLE_MODE
+
 void heap_init(dl_heap_t* heap_struct_ptr, void* mem_ptr,
                uint32_t mem_size) {  // Init here mem structures
     heap_struct_ptr->offset = 0;
@@ -316,6 +328,419 @@ bool drealloc(dl_heap_t* heap_struct_ptr, uint32_t size, void** ptr) {
     return true;
 }
 
+#else /* DALLOC_SCALABLE_MODE */
+
+/*
+ * Scalable mode keeps the same bump-pointer layout, but:
+ * - the index is sorted by offset and grows with m_realloc, so lookups are
+ *   binary searches and the allocation count is only limited by memory;
+ * - dfree() only marks the entry, blocks are slid down with memmove() by
+ *   dalloc_compact_step() in bounded slices, one pass over the index
+ *   reclaims every hole, and the index is compacted in the same pass;
+ * - an allocation that does not fit runs the pending compaction first.
+ * During a pass, entries [0, keep) are compacted below compact_dst,
+ * entries [keep, scan) are dead slots and [scan, num) are untouched.
+ */
+
+static inline uint32_t block_size(uint32_t size) {
+#if USE_ALIGNMENT
+    return (size + ALLOCATION_ALIGNMENT_BYTES - 1) /
+           ALLOCATION_ALIGNMENT_BYTES * ALLOCATION_ALIGNMENT_BYTES;
+#else
+    return size;
+#endif
+}
+
+static inline uint32_t live_allocations(alloc_info_t* info) {
+    return info->allocations_num - info->free_num -
+           (info->compact_scan - info->compact_keep);
+}
+
+bool is_ptr_address_in_heap_area(dl_heap_t* heap_struct_ptr, void** ptr) {
+    size_t heap_start_area = (size_t)(heap_struct_ptr->mem);
+    size_t heap_stop_area =
+        (size_t)(heap_struct_ptr->mem) + heap_struct_ptr->total_size;
+    if (((size_t)ptr >= heap_start_area) && ((size_t)ptr < heap_stop_area)) {
+        return true;
+    }
+    return false;
+}
+
+void heap_init(dl_heap_t* heap_struct_ptr, void* mem_ptr, uint32_t mem_size) {
+    memset(&heap_struct_ptr->alloc_info, 0, sizeof(alloc_info_t));
+    heap_struct_ptr->offset = 0;
+    heap_struct_ptr->mem = (uint8_t*)mem_ptr;
+    heap_struct_ptr->total_size = mem_size;
+    memset(heap_struct_ptr->mem, 0, mem_size);
+}
+
+void heap_deinit(dl_heap_t* heap_struct_ptr) {
+    m_free(heap_struct_ptr->alloc_info.ptr_info_arr);
+    memset(&heap_struct_ptr->alloc_info, 0, sizeof(alloc_info_t));
+    heap_struct_ptr->offset = 0;
+}
+
+/* Slide one block down to dst and update every pointer that refers to it */
+static void move_block(dl_heap_t* heap_struct_ptr, ptr_info_t* entry,
+                       uint32_t dst, void*** track) {
+    alloc_info_t* info = &heap_struct_ptr->alloc_info;
+    uint32_t size = block_size(ALLOCSIZE_GET((*entry)));
+    uint8_t* from = heap_struct_ptr->mem + entry->offset;
+    uint8_t* to = heap_struct_ptr->mem + dst;
+    memmove(to, from, size);
+    entry->offset = dst;
+
+    /* Registered pointers stored inside the block moved along with it */
+    if (info->heap_ptr_num) {
+        for (uint32_t k = 0; k < info->allocations_num; k++) {
+            if (k == info->compact_keep) {
+                k = info->compact_scan;
+                if (k == info->allocations_num)
+                    break;
+            }
+            uint8_t* loc = (uint8_t*)info->ptr_info_arr[k].ptr;
+            if (loc >= from && loc < from + size) {
+                info->ptr_info_arr[k].ptr = (uint8_t**)(loc - (from - to));
+            }
+        }
+    }
+    if (track && (uint8_t*)*track >= from && (uint8_t*)*track < from + size) {
+        *track = (void**)((uint8_t*)*track - (from - to));
+    }
+    *(entry->ptr) = to;
+}
+
+static bool compact_slice(dl_heap_t* heap_struct_ptr, uint32_t max_bytes,
+                          void*** track) {
+    alloc_info_t* info = &heap_struct_ptr->alloc_info;
+    if (info->compact_keep == info->compact_scan) {
+        if (info->free_num == 0) {
+            return false;
+        }
+        /* Start a pass at the first hole */
+        uint32_t first = 0;
+        while (!FREEFLAG_GET(info->ptr_info_arr[first])) {
+            first++;
+        }
+        info->compact_keep = info->compact_scan = first;
+        info->compact_dst = info->ptr_info_arr[first].offset;
+    }
+
+    uint32_t moved = 0;
+    while (info->compact_scan < info->allocations_num) {
+        ptr_info_t* entry = &info->ptr_info_arr[info->compact_scan];
+        uint32_t size = block_size(ALLOCSIZE_GET((*entry)));
+        if (FREEFLAG_GET((*entry))) {
+            info->free_num--;
+            info->compact_scan++;
+            continue;
+        }
+        if (entry->offset != info->compact_dst) {
+            if (moved && moved + size > max_bytes) {
+                break;
+            }
+            move_block(heap_struct_ptr, entry, info->compact_dst, track);
+            moved += size;
+        }
+        info->ptr_info_arr[info->compact_keep++] = *entry;
+        info->compact_dst += size;
+        info->compact_scan++;
+    }
+
+    if (info->compact_scan == info->allocations_num) {
+        /* Pass done, drop the dead slots and release the tail */
+        uint32_t old_offset = heap_struct_ptr->offset;
+        info->allocations_num = info->compact_keep;
+        heap_struct_ptr->offset = info->compact_dst;
+        info->compact_keep = info->compact_scan = 0;
+#if FILL_FREED_MEMORY_BY_NULLS
+        memset(heap_struct_ptr->mem + heap_struct_ptr->offset, 0,
+               old_offset - heap_struct_ptr->offset);
+#else
+        (void)old_offset;
+#endif
+    }
+    return info->free_num || info->compact_keep != info->compact_scan;
+}
+
+static void compact_all(dl_heap_t* heap_struct_ptr, void*** track) {
+    while (compact_slice(heap_struct_ptr, UINT32_MAX, track)) {
+    }
+}
+
+bool dalloc_compact_step(dl_heap_t* heap_struct_ptr, uint32_t max_bytes) {
+    if (heap_struct_ptr == NULL) {
+        return false;
+    }
+    return compact_slice(heap_struct_ptr, max_bytes, NULL);
+}
+
+void dalloc_compact(dl_heap_t* heap_struct_ptr) {
+    if (heap_struct_ptr != NULL) {
+        compact_all(heap_struct_ptr, NULL);
+    }
+}
+
+static bool index_reserve(alloc_info_t* info) {
+    if (info->allocations_num < info->capacity) {
+        return true;
+    }
+    uint32_t capacity =
+        info->capacity ? info->capacity * 2 : DALLOC_INDEX_INIT_CAPACITY;
+    ptr_info_t* arr =
+        m_realloc(info->ptr_info_arr, capacity * sizeof(ptr_info_t));
+    if (arr == NULL) {
+        return false;
+    }
+    info->ptr_info_arr = arr;
+    info->capacity = capacity;
+    return true;
+}
+
+void dalloc(dl_heap_t* heap_struct_ptr, uint32_t size, void** ptr) {
+#if USE_SINGLE_HEAP_MEMORY
+    if (memory_init_flag == false) {
+        heap_init(&default_heap, single_heap, SINGLE_HEAP_SIZE);
+        memory_init_flag = true;
+    }
+#endif
+
+    *ptr = NULL;
+    if (!heap_struct_ptr || !size || size >= (1UL << _OFFSET)) {
+        return;
+    }
+    alloc_info_t* info = &heap_struct_ptr->alloc_info;
+    uint32_t need = block_size(size);
+    if (need > heap_struct_ptr->total_size - heap_struct_ptr->offset) {
+        compact_all(heap_struct_ptr, &ptr);
+    }
+    if (need > heap_struct_ptr->total_size - heap_struct_ptr->offset) {
+        LOG_ERROR("dalloc: Heap size exceeded");
+        return;
+    }
+    if (!index_reserve(info)) {
+        LOG_ERROR("dalloc: Can't grow allocation index");
+        return;
+    }
+
+    /* Appending at the end keeps the index sorted by offset */
+    ptr_info_t* entry = &info->ptr_info_arr[info->allocations_num++];
+    entry->ptr = (uint8_t**)ptr;
+    entry->offset = heap_struct_ptr->offset;
+    entry->alloc_info = size;
+    if (is_ptr_address_in_heap_area(heap_struct_ptr, ptr)) {
+        info->heap_ptr_num++;
+    }
+    *ptr = heap_struct_ptr->mem + heap_struct_ptr->offset;
+    heap_struct_ptr->offset += need;
+
+    if (heap_struct_ptr->offset > info->max_memory_amount) {
+        info->max_memory_amount = heap_struct_ptr->offset;
+    }
+    if (live_allocations(info) > info->max_allocations_amount) {
+        info->max_allocations_amount = live_allocations(info);
+    }
+}
+
+/* Binary search of a live entry by the block address */
+static bool find_entry(dl_heap_t* heap_struct_ptr, uint8_t* mem,
+                       uint32_t* ptr_index) {
+    alloc_info_t* info = &heap_struct_ptr->alloc_info;
+    if (mem < heap_struct_ptr->mem ||
+        mem >= heap_struct_ptr->mem + heap_struct_ptr->offset) {
+        return false;
+    }
+    uint32_t offset = (uint32_t)(mem - heap_struct_ptr->mem);
+    uint32_t lo = 0;
+    uint32_t hi = info->allocations_num;
+    if (info->compact_keep != info->compact_scan) {
+        if (offset < info->compact_dst) {
+            hi = info->compact_keep;
+        } else {
+            lo = info->compact_scan;
+        }
+    }
+    uint32_t end = hi;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (info->ptr_info_arr[mid].offset < offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == end || info->ptr_info_arr[lo].offset != offset ||
+        FREEFLAG_GET(info->ptr_info_arr[lo])) {
+        return false;
+    }
+    *ptr_index = lo;
+    return true;
+}
+
+bool validate_ptr(dl_heap_t* heap_struct_ptr, void** ptr,
+                  validate_ptr_condition_t condition, uint32_t* ptr_index) {
+    alloc_info_t* info = &heap_struct_ptr->alloc_info;
+    uint32_t index;
+    if (find_entry(heap_struct_ptr, (uint8_t*)*ptr, &index) &&
+        (condition == USING_PTR_VALUE ||
+         info->ptr_info_arr[index].ptr == (uint8_t**)ptr)) {
+        if (ptr_index != NULL) {
+            *ptr_index = index;
+        }
+        return true;
+    }
+    if (condition == USING_PTR_VALUE) {
+        return false;
+    }
+    /* The registered pointer no longer points to its block start */
+    for (uint32_t i = 0; i < info->allocations_num; i++) {
+        if (i == info->compact_keep) {
+            i = info->compact_scan;
+            if (i == info->allocations_num) {
+                break;
+            }
+        }
+        if (info->ptr_info_arr[i].ptr == (uint8_t**)ptr &&
+            !FREEFLAG_GET(info->ptr_info_arr[i])) {
+            if (ptr_index != NULL) {
+                *ptr_index = i;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Mark an entry freed, blocks at the end are released right away */
+static void free_entry(dl_heap_t* heap_struct_ptr, uint32_t index) {
+    alloc_info_t* info = &heap_struct_ptr->alloc_info;
+    ptr_info_t* entry = &info->ptr_info_arr[index];
+    FREEFLAG_SET((*entry));
+    info->free_num++;
+    if (is_ptr_address_in_heap_area(heap_struct_ptr, (void**)entry->ptr)) {
+        info->heap_ptr_num--;
+    }
+#if FILL_FREED_MEMORY_BY_NULLS
+    memset(heap_struct_ptr->mem + entry->offset, 0,
+           block_size(ALLOCSIZE_GET((*entry))));
+#endif
+    while (info->allocations_num > info->compact_scan &&
+           FREEFLAG_GET(info->ptr_info_arr[info->allocations_num - 1])) {
+        info->allocations_num--;
+        info->free_num--;
+        heap_struct_ptr->offset =
+            info->ptr_info_arr[info->allocations_num].offset;
+    }
+    if (info->compact_keep != info->compact_scan &&
+        info->allocations_num == info->compact_scan) {
+        compact_slice(heap_struct_ptr, 0, NULL); /* Only closes the pass */
+    }
+}
+
+void dfree(dl_heap_t* heap_struct_ptr, void** ptr,
+           validate_ptr_condition_t condition) {
+    /* Check if heap_ptr is not assigned */
+    if (heap_struct_ptr == NULL) {
+        LOG_ERROR("Heap pointer is not assigned");
+        return;
+    }
+
+    uint32_t ptr_index = 0;
+
+    /* Try to find given ptr in ptr_info array */
+    if (validate_ptr(heap_struct_ptr, ptr, condition, &ptr_index) != true) {
+        LOG_ERROR("Try to free unexisting pointer");
+        return;
+    }
+
+    *(heap_struct_ptr->alloc_info.ptr_info_arr[ptr_index].ptr) = NULL;
+    free_entry(heap_struct_ptr, ptr_index);
+#if DALLOC_EAGER_COMPACTION
+    compact_all(heap_struct_ptr, NULL);
+#endif
+}
+
+void replace_pointers(dl_heap_t* heap_struct_ptr, void** ptr_to_replace,
+                      void** ptr_new) {
+    uint32_t ptr_ind = 0;
+    if (validate_ptr(heap_struct_ptr, ptr_to_replace, USING_PTR_ADDRESS,
+                     &ptr_ind) != true) {
+        LOG_ERROR("Can't replace pointers. No pointer found in buffer");
+        return;
+    }
+    alloc_info_t* info = &heap_struct_ptr->alloc_info;
+    info->heap_ptr_num +=
+        is_ptr_address_in_heap_area(heap_struct_ptr, ptr_new) -
+        is_ptr_address_in_heap_area(heap_struct_ptr, ptr_to_replace);
+    *ptr_new = *ptr_to_replace;
+    info->ptr_info_arr[ptr_ind].ptr = (uint8_t**)ptr_new;
+    *ptr_to_replace = NULL;
+}
+
+bool drealloc(dl_heap_t* heap_struct_ptr, uint32_t size, void** ptr) {
+    alloc_info_t* info = &heap_struct_ptr->alloc_info;
+    uint32_t index = 0;
+    if (validate_ptr(heap_struct_ptr, ptr, USING_PTR_ADDRESS, &index) !=
+            true ||
+        !size || size >= (1UL << _OFFSET)) {
+        return false;
+    }
+    ptr_info_t* entry = &info->ptr_info_arr[index];
+    uint32_t old_size = ALLOCSIZE_GET((*entry));
+    uint32_t old_block = block_size(old_size);
+    uint32_t new_block = block_size(size);
+
+    /* Same block size, or the last block: resize in place */
+    bool is_last = entry->offset + old_block == heap_struct_ptr->offset;
+    if (new_block == old_block ||
+        (is_last &&
+         new_block <= heap_struct_ptr->total_size - entry->offset)) {
+#if FILL_FREED_MEMORY_BY_NULLS
+        if (new_block < old_block) {
+            memset(heap_struct_ptr->mem + entry->offset + new_block, 0,
+                   old_block - new_block);
+        }
+#endif
+        ALLOCSIZE_SET((*entry), size);
+        if (is_last) {
+            heap_struct_ptr->offset = entry->offset + new_block;
+            if (heap_struct_ptr->offset > info->max_memory_amount) {
+                info->max_memory_amount = heap_struct_ptr->offset;
+            }
+        }
+        return true;
+    }
+
+    /* Compact first so that dalloc() below moves nothing, ptr may itself
+     * live inside a block */
+    if (new_block > heap_struct_ptr->total_size - heap_struct_ptr->offset) {
+        compact_all(heap_struct_ptr, &ptr);
+        validate_ptr(heap_struct_ptr, ptr, USING_PTR_ADDRESS, &index);
+    }
+    uint8_t* new_ptr = NULL;
+    dalloc(heap_struct_ptr, size, (void**)&new_ptr);
+    if (new_ptr == NULL) {
+        LOG_ERROR("drealloc failed due to dalloc failed");
+        return false;
+    }
+    memcpy(new_ptr, *ptr, old_size < size ? old_size : size);
+
+    /* Hand the new block over to ptr, then release the old one */
+    uint32_t new_index = info->allocations_num - 1;
+    info->ptr_info_arr[new_index].ptr = (uint8_t**)ptr;
+    if (is_ptr_address_in_heap_area(heap_struct_ptr, ptr)) {
+        info->heap_ptr_num++;
+    }
+    *ptr = new_ptr;
+    free_entry(heap_struct_ptr, index);
+#if DALLOC_EAGER_COMPACTION
+    compact_all(heap_struct_ptr, NULL);
+#endif
+    return true;
+}
+
+#endif /* DALLOC_SCALABLE_MODE */
+
 void print_dalloc_info(dl_heap_t* heap_struct_ptr) {
     PRINTLN("************ Mem Info ************PRINTLN$1");
     PRINTLN("Total memory, bytes: %luPRINTLN$1",
@@ -329,6 +754,10 @@ void print_dalloc_info(dl_heap_t* heap_struct_ptr) {
     PRINTLN(
         "Max allocations number: %luPRINTLN$1",
         (long unsigned int)heap_struct_ptr->alloc_info.max_allocations_amount);
+#if DALLOC_SCALABLE_MODE
+    PRINTLN("Freed, waiting for compaction: %lu",
+            (long unsigned int)heap_struct_ptr->alloc_info.free_num);
+#endif
     PRINTLN("**********************************PRINTLN$1");
 }
 
@@ -343,6 +772,9 @@ void dump_heap(dl_heap_t* heap_struct_ptr) {
 void dump_dalloc_ptr_info(dl_heap_t* heap_struct_ptr) {
     PRINTLN("************ Ptr Info ************PRINTLN$1");
     for (uint32_t i = 0; i < heap_struct_ptr->alloc_info.allocations_num; i++) {
+        if (!ENTRY_LIVE(heap_struct_ptr, i)) {
+            continue;
+        }
         PRINTLN(
             "Ptr address: 0x%08X, ptr first val: 0x%02X, alloc size: "
             "%luPRINTLN$1",
@@ -357,6 +789,9 @@ void dump_dalloc_ptr_info(dl_heap_t* heap_struct_ptr) {
 float get_heap_usage(dl_heap_t* heap_struct_ptr) {
     uint32_t alloc_size = 0;
     for (uint32_t i = 0; i < heap_struct_ptr->alloc_info.allocations_num; i++) {
+        if (!ENTRY_LIVE(heap_struct_ptr, i)) {
+            continue;
+        }
         alloc_size +=
             ALLOCSIZE_GET(heap_struct_ptr->alloc_info.ptr_info_arr[i]);
     }
@@ -28,6 +28,23 @@ extern "C" {
 
 #define MAX_NUM_OF_ALLOCATIONS 32UL
 
+/* Scalable mode: growable sorted index, memmove sliding, deferred compaction */
+#ifndef DALLOC_SCALABLE_MODE
+#define DALLOC_SCALABLE_MODE 0
+#endif
+
+#if DALLOC_SCALABLE_MODE
+/* Initial number of index entries, the index doubles with m_realloc */
+#ifndef DALLOC_INDEX_INIT_CAPACITY
+#define DALLOC_INDEX_INIT_CAPACITY 16UL
+#endif
+/* Compact inside dfree() like the classic mode. By default freed blocks
+ * stay until dalloc_compact_step() or until an allocation does not fit */
+#ifndef DALLOC_EAGER_COMPACTION
+#define DALLOC_EAGER_COMPACTION 0
+#endif
+#endif
+
 #define USE_ALIGNMENT 1
 
 #if USE_ALIGNMENT
@@ -38,7 +55,7 @@ extern "C" {
 
 #define HEAP_LOCATION 0
 
-#define ALLOC_INFO_U16 1
+#define ALLOC_INFO_U16 (!DALLOC_SCALABLE_MODE)
 
 #if USE_SINGLE_HEAP_MEMORY
 #define SINGLE_HEAP_SIZE (1UL * 1024UL)
@@ -60,6 +77,9 @@ typedef enum {
 
 typedef struct {
     uint8_t** ptr;
+#if DALLOC_SCALABLE_MODE
+    uint32_t offset; /* Block offset from the heap start */
+#endif
 #if ALLOC_INFO_U16
     uint16_t alloc_info;
 #else
@@ -68,7 +88,17 @@ typedef struct {
 } ptr_info_t;
 
 typedef struct {
+#if DALLOC_SCALABLE_MODE
+    ptr_info_t* ptr_info_arr; /* Index sorted by offset, grown by m_realloc */
+    uint32_t capacity;        /* Number of entries the index can hold */
+    uint32_t free_num;        /* Freed entries waiting for compaction */
+    uint32_t heap_ptr_num;    /* Entries whose pointer lives inside the heap */
+    uint32_t compact_keep;    /* Entries [0, keep) are already compacted */
+    uint32_t compact_scan;    /* Entries [keep, scan) are dead index slots */
+    uint32_t compact_dst;     /* End offset of the compacted blocks */
+#else
     ptr_info_t ptr_info_arr[MAX_NUM_OF_ALLOCATIONS];
+#endif
     uint32_t allocations_num;
     uint32_t max_memory_amount;
     uint32_t max_allocations_amount;
@@ -145,6 +175,16 @@ extern uint8_t single_heap[];
  */
 #define get_def_heap_usage() get_heap_usage(&default_heap)
 
+#if DALLOC_SCALABLE_MODE
+/**
+ * @brief Run one bounded compaction slice on the default heap
+ * @param  max_bytes - soft limit of bytes moved by this call
+ * @return true if more compaction work is pending
+ */
+#define def_dalloc_compact_step(max_bytes) \
+    dalloc_compact_step(&default_heap, max_bytes)
+#endif
+
 #define _dalloc(ptr, size) def_dalloc(size, (void**)&(ptr))
 // #define _dfree(ptr) def_dfree((void **)&(ptr))
 #define _dfree(ptr) def_dfree_value((void*)(ptr))
@@ -223,6 +263,31 @@ void dump_heap(dl_heap_t* heap_struct_ptr);
  */
 float get_heap_usage(dl_heap_t* heap_struct_ptr);
 
+#if DALLOC_SCALABLE_MODE
+/**
+ * @brief Release the allocation index of a heap
+ * @param  heap_struct_ptr - pointer to heap structure
+ */
+void heap_deinit(dl_heap_t* heap_struct_ptr);
+
+/**
+ * @brief Slide live blocks over freed ones, moving at most about max_bytes
+ * @note Call it from the idle hook. A block is always moved as a whole, so
+ *       a single slice may exceed max_bytes by up to one block. Threads that
+ *       access this heap must not preempt the call
+ * @param  heap_struct_ptr - pointer to heap structure
+ * @param  max_bytes - soft limit of bytes moved by this call
+ * @return true if more compaction work is pending
+ */
+bool dalloc_compact_step(dl_heap_t* heap_struct_ptr, uint32_t max_bytes);
+
+/**
+ * @brief Run compaction until every freed block is reclaimed
+ * @param  heap_struct_ptr - pointer to heap structure
+ */
+void dalloc_compact(dl_heap_t* heap_struct_ptr);
+#endif
+
 /**
  * @brief Replace a pointer in a heap with a new pointer
  * @param  heap_struct_ptr - pointer to heap structure
@@ -0,0 +1,296 @@
+// dalloc可扩展模式的压缩回归测试: 延迟释放与末尾块立即回收,
+// 按字节数分片的增量压缩, 压缩进行中的分配/查找/释放, 分配放不下时先完成
+// 压缩, 存放在堆内的指针随所在块移动, drealloc的原地/搬移规则,
+// 以及与参考模型对比的随机操作
+// 在工程根目录构建并运行(加-DDALLOC_EAGER_COMPACTION=1检查dfree内压缩):
+//   gcc -O1 -g -fsanitize=address,undefined -Isystem/dalloc/test -I.
+//       -Isystem/dalloc -Idebug/log -Iutility/macro -Idebug/minctest
+//       system/dalloc/dalloc.c system/dalloc/test/dalloc_test.c -o dalloc_test
+//   ./dalloc_test
+// 全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dalloc.h"
+#include "host_check.h"
+
+#define HEAP_SIZE 4096
+#define SLOTS 64
+
+static uint8_t m_mem[HEAP_SIZE];
+static dl_heap_t m_heap;
+static uint8_t* m_ptr[SLOTS];
+static uint32_t m_size[SLOTS];
+
+static uint32_t block(uint32_t size) { return (size + 3) / 4 * 4; }
+
+static void fill(int k) {
+    for (uint32_t i = 0; i < m_size[k]; i++) m_ptr[k][i] = (uint8_t)(k * 7 + i);
+}
+
+static bool alloc(int k, uint32_t size) {
+    dalloc(&m_heap, size, (void**)&m_ptr[k]);
+    if (m_ptr[k] == NULL)
+        return false;
+    m_size[k] = size;
+    fill(k);
+    return true;
+}
+
+static void release(int k, bool by_value) {
+    void* copy = m_ptr[k];  // 按值查找时传入另一个指向该块的指针
+    if (by_value)
+        dfree(&m_heap, &copy, USING_PTR_VALUE);
+    else
+        dfree(&m_heap, (void**)&m_ptr[k], USING_PTR_ADDRESS);
+    CHECK(m_ptr[k] == NULL);
+}
+
+/* 内容未被改写, 索引按偏移有序, 登记的指针指向各自的块, 堆尾已清零 */
+static void verify(const char* where) {
+    alloc_info_t* info = &m_heap.alloc_info;
+    uint32_t live = 0, prev = 0;
+    for (int k = 0; k < SLOTS; k++) {
+        if (m_ptr[k] == NULL)
+            continue;
+        live++;
+        for (uint32_t i = 0; i < m_size[k]; i++) {
+            if (m_ptr[k][i] != (uint8_t)(k * 7 + i)) {
+                CHECK_FAIL("%s: slot %d corrupted at %u", where, k, i);
+                return;
+            }
+        }
+        uint32_t index;
+        if (!validate_ptr(&m_heap, (void**)&m_ptr[k], USING_PTR_ADDRESS,
+                          &index))
+            CHECK_FAIL("%s: slot %d not registered", where, k);
+    }
+    for (uint32_t i = 0; i < info->allocations_num; i++) {
+        if (i == info->compact_keep && info->compact_keep != info->compact_scan)
+            i = info->compact_scan;  // 跳过本轮压缩已处理的空槽
+        if (i == info->allocations_num)
+            break;
+        ptr_info_t* e = &info->ptr_info_arr[i];
+        if (i && e->offset < prev)
+            CHECK_FAIL("%s: index not sorted at %u", where, i);
+        prev = e->offset;
+        if (e->alloc_info >> 31)
+            continue;  // 已释放, 等待压缩
+        live--;
+        if (*e->ptr != m_heap.mem + e->offset)
+            CHECK_FAIL("%s: entry %u points elsewhere", where, i);
+    }
+    if (live != 0)
+        CHECK_FAIL("%s: %u slots missing from the index", where, live);
+    for (uint32_t i = m_heap.offset; i < HEAP_SIZE; i++) {
+        if (m_mem[i] != 0) {
+            CHECK_FAIL("%s: tail not cleared at %u", where, i);
+            break;
+        }
+    }
+}
+
+static void reset(void) {
+    heap_deinit(&m_heap);
+    heap_init(&m_heap, m_mem, HEAP_SIZE);
+    memset(m_ptr, 0, sizeof(m_ptr));
+}
+
+/* 释放只做标记, 末尾的块立即回收; 分片压缩每次移动的字节数有上限 */
+static void test_step(void) {
+    reset();
+    uint32_t used = 0;
+    for (int k = 0; k < 40; k++) {  // 超过索引初始容量
+        CHECK(alloc(k, 10 + k));
+        used += block(10 + k);
+    }
+    CHECK(m_heap.offset == used && m_heap.alloc_info.capacity >= 40);
+    for (int k = 0; k < 40; k += 2) {
+        release(k, k % 4 == 0);
+        used -= block(10 + k);
+    }
+    verify("after free");
+    uint8_t* end = m_ptr[37] + block(47);
+    release(39, false);  // 末尾块及其前面已释放的块立即回收
+    used -= block(49);
+    if (!DALLOC_EAGER_COMPACTION) {
+        CHECK(m_heap.alloc_info.free_num == 19);
+        CHECK(m_heap.mem + m_heap.offset == end);
+    }
+
+    int steps = 0;
+    while (dalloc_compact_step(&m_heap, 64)) {
+        steps++;
+        verify("step");
+    }
+    verify("compacted");
+    CHECK(DALLOC_EAGER_COMPACTION ? steps == 0 : steps > 5);
+    CHECK(m_heap.offset == used && m_heap.alloc_info.free_num == 0);
+    CHECK(m_heap.alloc_info.allocations_num == 19);
+    CHECK(!dalloc_compact_step(&m_heap, 64));
+}
+
+/* 压缩进行中: 新分配追加在末尾, 查找/释放/重新分配跨越未压缩的部分 */
+static void test_pending(void) {
+    reset();
+    for (int k = 0; k < 32; k++) CHECK(alloc(k, 24));
+    for (int k = 0; k < 32; k += 3) release(k, false);
+    dalloc_compact_step(&m_heap, 48);  // 只移动两个块
+    verify("partial");
+    CHECK(alloc(40, 100));
+    release(1, true);   // 已压缩的部分
+    release(31, true);  // 未压缩的部分
+    CHECK(drealloc(&m_heap, 60, (void**)&m_ptr[2]));
+    m_size[2] = 60;
+    fill(2);
+    CHECK(drealloc(&m_heap, 8, (void**)&m_ptr[29]));
+    m_size[29] = 8;
+    verify("pending ops");
+    dalloc_compact(&m_heap);
+    verify("pending compacted");
+    CHECK(m_heap.alloc_info.free_num == 0);
+}
+
+/* 末尾放不下时先完成压缩; 完成后仍放不下则失败 */
+static void test_full(void) {
+    reset();
+    for (int k = 0; k < 16; k++) CHECK(alloc(k, 256));
+    CHECK(m_heap.offset == HEAP_SIZE);
+    CHECK(!alloc(20, 4));
+    release(3, false);
+    release(7, true);
+    CHECK(alloc(20, 300));  // 合并两个空洞
+    CHECK(m_heap.alloc_info.free_num == 0);
+    verify("full");
+    CHECK(!alloc(21, 300));
+}
+
+/* 登记的指针位于堆内的块中, 该块移动时指针记录随之更新 */
+static void test_heap_ptrs(void) {
+    reset();
+    CHECK(alloc(0, 16));
+    uint8_t** table;
+    dalloc(&m_heap, 8 * sizeof(uint8_t*), (void**)&table);
+    CHECK(table != NULL);
+    for (int i = 0; i < 8; i++) {
+        dalloc(&m_heap, 12 + i, (void**)&table[i]);
+        memset(table[i], 0xA0 + i, 12 + i);
+    }
+    CHECK(m_heap.alloc_info.heap_ptr_num == 8);
+    uint8_t** old = table;
+    release(0, false);
+    dfree(&m_heap, (void**)&table[2], USING_PTR_ADDRESS);
+    CHECK(table[2] == NULL);
+    CHECK(m_heap.alloc_info.heap_ptr_num == 7);
+    dalloc_compact(&m_heap);
+    CHECK(table != old && table == (uint8_t**)m_heap.mem);
+    for (int i = 0; i < 8; i++) {
+        if (i == 2)
+            continue;
+        CHECK(table[i][0] == 0xA0 + i && table[i][11 + i] == 0xA0 + i);
+        dfree(&m_heap, (void**)&table[i], USING_PTR_ADDRESS);
+    }
+    CHECK(m_heap.alloc_info.heap_ptr_num == 0);
+    dfree(&m_heap, (void**)&table, USING_PTR_ADDRESS);
+    dalloc_compact(&m_heap);
+    CHECK(m_heap.offset == 0 && m_heap.alloc_info.allocations_num == 0);
+}
+
+/* drealloc: 同一块大小或末尾块原地调整, 否则搬移并拷贝较小的长度 */
+static void test_realloc(void) {
+    reset();
+    CHECK(alloc(0, 10));
+    CHECK(alloc(1, 10));
+    uint8_t* p = m_ptr[0];
+    CHECK(drealloc(&m_heap, 12, (void**)&m_ptr[0]) && m_ptr[0] == p);
+    m_size[0] = 10;  // 新增的两个字节未写入
+    p = m_ptr[1];
+    CHECK(drealloc(&m_heap, 500, (void**)&m_ptr[1]) && m_ptr[1] == p);
+    CHECK(m_heap.offset == 12 + 500);
+    CHECK(drealloc(&m_heap, 40, (void**)&m_ptr[0]));
+    // 原位置释放后, 立即压缩时块1移到开头
+    CHECK(m_ptr[0] == m_heap.mem + (DALLOC_EAGER_COMPACTION ? 500 : 512));
+    verify("realloc move");
+    m_size[1] = 5;
+    CHECK(drealloc(&m_heap, 5, (void**)&m_ptr[1]));  // 不是末尾, 搬移
+    verify("realloc shrink");
+    CHECK(!drealloc(&m_heap, 0, (void**)&m_ptr[1]));
+    CHECK(!drealloc(&m_heap, 8, (void**)&m_ptr[5]));  // 未分配
+
+    // 放不下时先压缩, 被搬移的指针本身位于随之移动的块内
+    reset();
+    CHECK(alloc(0, 1000));
+    uint8_t** holder;
+    dalloc(&m_heap, 64, (void**)&holder);
+    dalloc(&m_heap, 100, (void**)&holder[0]);
+    memset(holder[0], 0x3C, 100);
+    CHECK(alloc(1, 2500));
+    release(0, false);
+    CHECK(drealloc(&m_heap, 1400, (void**)&holder[0]));
+    CHECK(holder == (uint8_t**)m_heap.mem);
+    uint32_t hole = DALLOC_EAGER_COMPACTION ? 0 : 100;  // 旧块是否已回收
+    CHECK(holder[0] == m_heap.mem + 64 + hole + 2500);
+    CHECK(holder[0][0] == 0x3C && holder[0][99] == 0x3C);
+    CHECK(m_ptr[1][0] == (uint8_t)7 && m_ptr[1] == m_heap.mem + 64 + hole);
+    CHECK(!drealloc(&m_heap, 2000, (void**)&holder[0]));
+    dfree(&m_heap, (void**)&holder[0], USING_PTR_ADDRESS);
+    dfree(&m_heap, (void**)&holder, USING_PTR_ADDRESS);
+    dalloc_compact(&m_heap);
+    verify("realloc compact");
+    CHECK(m_heap.offset == 2500 && m_heap.alloc_info.heap_ptr_num == 0);
+}
+
+/* 随机操作, 与记录在m_ptr/m_size中的参考内容对比 */
+static void test_random(void) {
+    reset();
+    unsigned seed = 12345;
+    for (int r = 0; r < 20000; r++) {
+        seed = seed * 1103515245u + 12345u;
+        int k = (seed >> 8) % SLOTS;
+        uint32_t size = 1 + (seed >> 16) % 200;
+        switch ((seed >> 28) % 4) {
+            case 0:
+            case 1:
+                if (m_ptr[k] == NULL)
+                    alloc(k, size);
+                else
+                    release(k, seed & 1);
+                break;
+            case 2:
+                if (m_ptr[k] != NULL &&
+                    drealloc(&m_heap, size, (void**)&m_ptr[k])) {
+                    if (size > m_size[k]) {
+                        uint32_t old = m_size[k];
+                        m_size[k] = size;
+                        for (uint32_t i = old; i < size; i++)
+                            m_ptr[k][i] = (uint8_t)(k * 7 + i);
+                    }
+                    m_size[k] = size;
+                }
+                break;
+            default:
+                dalloc_compact_step(&m_heap, 1 + (seed & 0x1FF));
+                break;
+        }
+        if (r % 97 == 0)
+            verify("random");
+    }
+    verify("random end");
+    for (int k = 0; k < SLOTS; k++)
+        if (m_ptr[k] != NULL)
+            release(k, false);
+    dalloc_compact(&m_heap);
+    CHECK(m_heap.offset == 0 && m_heap.alloc_info.allocations_num == 0);
+}
+
+int main(void) {
+    test_step();
+    test_pending();
+    test_full();
+    test_heap_ptrs();
+    test_realloc();
+    test_random();
+    heap_deinit(&m_heap);
+    return CHECK_RESULT();
+}
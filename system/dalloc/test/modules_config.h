@@ -0,0 +1,23 @@
+// dalloc主机测试配置
+// 相当于在主机上由Kconfig生成的modules_config.h, 使用可扩展模式,
+// 索引初始容量较小以覆盖索引扩容
+#define MOD_CFG_COMPILER_GCC 1
+#define MOD_CFG_USE_OS_NONE 1
+#define MOD_CFG_PLATFORM_HEADER <stddef.h>
+#define MOD_CFG_TIME_MATHOD_CUSTOM 1
+#define MOD_CFG_CUSTOM_TIME_TYPE_U64 1
+#define MOD_CFG_CUSTOM_TIME_BASE 1000000
+#define MOD_CFG_DELAY_MATHOD_CUSTOM 1
+#define MOD_CFG_HEAP_MATHOD_STDLIB 1
+#define LOG_CFG_ENABLE 0
+#define LOG_CFG_PRINTF printf  // print_dalloc_info等使用PRINTLN
+#define LOG_CFG_NEWLINE "\n"
+#define DALLOC_SCALABLE_MODE 1
+#define DALLOC_INDEX_INIT_CAPACITY 4
+#ifndef DALLOC_EAGER_COMPACTION
+#define DALLOC_EAGER_COMPACTION 0
+#endif
+// 平台头文件中的编译器宏
+#define __weak __attribute__((weak))
+#define __IO volatile
+#define __STATIC_INLINE static inline
@@ -0,0 +1,68 @@
+#include "kl_priv.h"
+
+#if KLITE_CFG_HEAP_USE_TLSF
+#include <string.h>
+
+#include "tlsf.h"
+
+__KL_HEAP_MUTEX_IMPL__
+
+static tlsf_t heap;
+
+void kl_heap_init(void* addr, kl_size_t size) {
+    tlsf_add_region(&heap, addr, size);
+}
+
+void kl_heap_add_region(void* addr, kl_size_t size) {
+    heap_mutex_lock();
+    tlsf_add_region(&heap, addr, size);
+    heap_mutex_unlock();
+}
+
+void* kl_heap_alloc(kl_size_t size) {
+    heap_mutex_lock();
+    void* mem = tlsf_malloc_ex(&heap, size);
+    if (!mem)
+        mem = kl_heap_alloc_fault_hook(size);
+    heap_mutex_unlock();
+    return mem;
+}
+
+void kl_heap_free(void* mem) {
+    heap_mutex_lock();
+    tlsf_free_ex(&heap, mem);
+    heap_mutex_unlock();
+}
+
+void* kl_heap_realloc(void* mem, kl_size_t size) {
+    heap_mutex_lock();
+    void* new_mem = tlsf_realloc_ex(&heap, mem, size);
+    if (!new_mem && size) {
+        new_mem = kl_heap_alloc_fault_hook(size);
+        if (new_mem && mem) {
+            size_t old_size = tlsf_get_size_ex(&heap, mem);
+            memcpy(new_mem, mem, old_size < size ? old_size : size);
+            tlsf_free_ex(&heap, mem);
+        }
+    }
+    heap_mutex_unlock();
+    return new_mem;
+}
+
+void kl_heap_stats(kl_heap_stats_t stats) {
+    tlsf_stats_t tlsf_stats;
+    heap_mutex_lock();
+    tlsf_get_stats_ex(&heap, &tlsf_stats);
+    heap_mutex_unlock();
+    stats->total_size = tlsf_stats.total_size;
+    stats->avail_size = tlsf_stats.avail_size;
+    stats->largest_free = tlsf_stats.largest_free;
+    stats->second_largest_free = 0;  // not supported
+    stats->smallest_free = tlsf_stats.smallest_free;
+    stats->free_blocks = tlsf_stats.free_blocks;
+    stats->minimum_ever_avail = tlsf_stats.min_ever_avail;
+    stats->alloc_count = tlsf_stats.alloc_count;
+    stats->free_count = tlsf_stats.free_count;
+}
+
+#endif
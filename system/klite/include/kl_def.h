@@ -32,8 +32,13 @@ typedef enum {
     KL_ENFOUND,   // 未找到
 } kl_err_t;
 
+#if UINTPTR_MAX > UINT32_MAX  // 64位主机(POSIX模拟端口)
+typedef uint64_t kl_size_t;
+typedef int64_t kl_ssize_t;
+#else
 typedef uint32_t kl_size_t;
 typedef int32_t kl_ssize_t;
+#endif
 
 #define KL_THREAD_FLAGS_READY (1U << 0)
 #define KL_THREAD_FLAGS_SLEEP (1U << 1)
@@ -35,7 +35,10 @@ void kl_port_sys_init(void);
 void kl_port_sys_start(void);
 
 // 平台实现: 系统空闲回调
-// @param time: 系统空闲时间, 单位tick
+// @param time: 距下一个线程唤醒的时间, 单位tick, KL_WAIT_FOREVER表示无定时唤醒
+// @note: 开启KLITE_CFG_TICKLESS时, 平台可停止周期时钟,
+//        将时钟源重设为time后触发, 唤醒后调用kl_kernel_tick_advance
+//        补上期间经过的tick数
 void kl_port_sys_idle(kl_tick_t time);
 
 // 平台实现: 触发PendSV, 进行上下文切换
@@ -64,6 +67,10 @@ void kl_heap_init(void* addr, kl_size_t size);
 // 内核时钟递增
 void kl_kernel_tick_source(void);
 
+// 内核时钟前进多个tick (低功耗空闲期间停止时钟后补偿)
+// @param ticks: 经过的tick数
+void kl_kernel_tick_advance(kl_tick_t ticks);
+
 // 内核空闲线程
 void kl_kernel_idle_entry(void* args);
 
@@ -80,7 +87,8 @@ void kl_sched_idle(void);
 
 // 线程调度器时钟处理
 // 如果有线程超时, 则唤醒线程
-void kl_sched_timing(void);
+// @param ticks: 经过的tick数
+void kl_sched_timing(kl_tick_t ticks);
 
 // 线程调度器挂起
 void kl_sched_suspend(void);
@@ -122,6 +130,11 @@ void kl_sched_tcb_resume(kl_thread_t tcb);
 // @param timeout: 睡眠时间
 void kl_sched_tcb_sleep(kl_thread_t tcb, kl_tick_t timeout);
 
+// 获取线程的剩余超时时间
+// @param tcb: 线程控制块
+// @return: 睡眠中的线程返回距唤醒的tick数, 否则返回上一次等待剩余的时间
+kl_tick_t kl_sched_tcb_timeout(kl_thread_t tcb);
+
 // 将线程加入等待队列
 // @param tcb: 线程控制块
 // @param list: 等待队列
@@ -172,13 +185,13 @@ kl_thread_t kl_sched_tcb_wake_from(struct kl_thread_list* list);
     } while (0)
 
 // 检查是否超时并返回true/false
-#define KL_RET_CHECK_TIMEOUT()               \
-    do {                                     \
-        if (kl_sched_tcb_now->timeout > 0) { \
-            KL_SET_ERRNO(KL_ETIMEOUT);       \
-            return false;                    \
-        }                                    \
-        return true;                         \
+#define KL_RET_CHECK_TIMEOUT()                \
+    do {                                      \
+        if (kl_sched_tcb_now->timeout == 0) { \
+            KL_SET_ERRNO(KL_ETIMEOUT);        \
+            return false;                     \
+        }                                     \
+        return true;                          \
     } while (0)
 
 #endif /* __KL_PRIV_H__ */
@@ -189,6 +189,15 @@ static inline void* kl_heap_calloc(kl_size_t nmemb, kl_size_t size) {
  */
 void kl_heap_stats(kl_heap_stats_t stats);
 
+#if KLITE_CFG_HEAP_USE_TLSF
+/**
+ * @brief 向堆追加一段不相邻的内存区域(仅TLSF堆支持)
+ * @param addr 区域起始地址
+ * @param size 区域大小
+ */
+void kl_heap_add_region(void* addr, kl_size_t size);
+#endif
+
 /******************************************************************************
  * thread
  ******************************************************************************/
@@ -48,10 +48,12 @@ bool kl_barrier_wait(kl_barrier_t barrier, kl_tick_t timeout) {
         return false;
     }
     barrier->value++;
-    if (!kl_barrier_check(barrier)) {
-        kl_sched_tcb_timed_wait(kl_sched_tcb_now, &barrier->list, timeout);
-        kl_sched_switch();
+    if (kl_barrier_check(barrier)) { /* 最后一个到达的线程不等待 */
+        kl_port_leave_critical();
+        return true;
     }
+    kl_sched_tcb_timed_wait(kl_sched_tcb_now, &barrier->list, timeout);
+    kl_sched_switch();
     kl_port_leave_critical();
     KL_RET_CHECK_TIMEOUT();
 }
@@ -114,6 +114,8 @@ bool kl_thread_pool_join(kl_thread_pool_t pool, kl_tick_t timeout) {
 }
 
 void kl_thread_pool_shutdown(kl_thread_pool_t pool) {
+    /* hold the queue lock, so no worker is deleted while owning it */
+    kl_mutex_lock(&pool->task_queue->mutex, KL_WAIT_FOREVER);
     /* exit all thread */
     for (uint8_t i = 0; i < pool->worker_num; i++) {
         kl_thread_delete(pool->thread_list[i]);
@@ -124,6 +126,7 @@ void kl_thread_pool_shutdown(kl_thread_pool_t pool) {
             kl_heap_free(temp.arg);
         }
     }
+    kl_mutex_unlock(&pool->task_queue->mutex);
     /* release memory */
     kl_mqueue_delete(pool->task_queue);
     kl_heap_free(pool->thread_list);
@@ -9,7 +9,9 @@ __weak void* kl_heap_alloc_fault_hook(kl_size_t size) {
 }
 
 __weak void kl_stack_overflow_hook(kl_thread_t thread, bool is_bottom) {
+#if UIO_CFG_PRINTF_REDIRECT  // 切回阻塞发送, 保证日志输出完整
     uart_fifo_tx_deinit(NULL);
+#endif
     LOG_FATAL("stack overflow at %s of thread 0x%p (ID:%d Entry:%p)",
               is_bottom ? "bottom" : "top", thread, kl_thread_id(thread),
               thread->entry);
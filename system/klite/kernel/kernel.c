@@ -24,9 +24,13 @@ void kl_kernel_boot(void) {
 }
 
 void kl_kernel_tick_source(void) {
-    m_tick_count++;
+    kl_kernel_tick_advance(1);
+}
+
+void kl_kernel_tick_advance(kl_tick_t ticks) {
+    m_tick_count += ticks;
     kl_port_enter_critical();
-    kl_sched_timing();
+    kl_sched_timing(ticks);
 #if KLITE_CFG_ROUND_ROBIN
     kl_sched_preempt(true);
 #else
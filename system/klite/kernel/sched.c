@@ -4,9 +4,8 @@
 kl_thread_t kl_sched_tcb_now;
 kl_thread_t kl_sched_tcb_next;
 static struct kl_thread_list m_list_ready[KLITE_CFG_MAX_PRIO + 1];
-static struct kl_thread_list m_list_sleep;
-static kl_tick_t m_idle_elapse;
-static kl_tick_t m_idle_timeout;
+static struct kl_thread_list m_list_sleep; /* ordered by wake-up tick */
+static kl_tick_t m_sched_tick;
 #if KLITE_CFG_MLFQ
 static kl_tick_t m_mlfq_reset_tick;
 #endif
@@ -19,6 +18,9 @@ static uint8_t m_susp_pending_flags;
 #define SUSPEND_PREEMPT_PENDING 0x02
 #define SUSPEND_PREEMPT_ROUND_ROBIN 0x04
 
+/* in sleep list, tcb->timeout holds the absolute wake-up tick */
+#define SLEEP_LEFT(tcb) ((kl_tick_t)((tcb)->timeout - m_sched_tick))
+
 static inline void waitlist_insert(struct kl_thread_list* list,
                                    struct kl_thread_node* node) {
 #if KLITE_CFG_WAIT_LIST_ORDER_BY_PRIO
@@ -61,11 +63,29 @@ static inline void remove_list_sched(kl_thread_t tcb) {
         }
         KL_CLR_FLAG(tcb->flags, KL_THREAD_FLAGS_READY);
     } else {
+        tcb->timeout = SLEEP_LEFT(tcb); /* back to remain sleep time */
         KL_CLR_FLAG(tcb->flags, KL_THREAD_FLAGS_SLEEP);
     }
     tcb->list_sched = NULL;
 }
 
+static inline void add_list_sleep(kl_thread_t tcb, kl_tick_t timeout) {
+    struct kl_thread_node* find;
+    if (!timeout) {
+        timeout = 1; /* wake up at next tick */
+    }
+    /* search from tail, same deadline keeps FIFO order */
+    for (find = m_list_sleep.tail; find != NULL; find = find->prev) {
+        if (SLEEP_LEFT(find->tcb) <= timeout) {
+            break;
+        }
+    }
+    tcb->timeout = m_sched_tick + timeout;
+    tcb->list_sched = &m_list_sleep;
+    kl_blist_insert_after(&m_list_sleep, find, &tcb->node_sched);
+    KL_SET_FLAG(tcb->flags, KL_THREAD_FLAGS_SLEEP);
+}
+
 static inline void add_list_ready(kl_thread_t tcb, const bool head,
                                   uint32_t prio) {
     tcb->list_sched = &m_list_ready[prio];
@@ -113,11 +133,8 @@ void kl_sched_tcb_suspend(kl_thread_t tcb) {
     }
     if (tcb->list_sched) { /* remove sched */
         list = tcb->list_sched;
-        remove_list_sched(tcb);
+        remove_list_sched(tcb); /* timeout is remain sleep time now */
         tcb->list_sched = list;
-        if (tcb->list_sched == &m_list_sleep && tcb->timeout > m_idle_elapse) {
-            tcb->timeout -= m_idle_elapse; /* remain sleep time */
-        }
     }
     KL_SET_FLAG(tcb->flags, KL_THREAD_FLAGS_SUSPEND);
 }
@@ -130,12 +147,7 @@ void kl_sched_tcb_resume(kl_thread_t tcb) {
             KL_SET_FLAG(tcb->flags, KL_THREAD_FLAGS_WAIT);
         }
         if (tcb->list_sched == &m_list_sleep) { /* set sleep */
-            tcb->timeout += m_idle_elapse;
-            kl_blist_append(tcb->list_sched, &tcb->node_sched);
-            if (tcb->timeout < m_idle_timeout) {
-                m_idle_timeout = tcb->timeout;
-            }
-            KL_SET_FLAG(tcb->flags, KL_THREAD_FLAGS_SLEEP);
+            add_list_sleep(tcb, tcb->timeout);
         } else if (tcb->list_sched) { /* set ready */
             tcb->list_sched = NULL;
             kl_sched_tcb_ready(tcb, false);
@@ -179,13 +191,15 @@ void kl_sched_tcb_sleep(kl_thread_t tcb, kl_tick_t timeout) {
     if (tcb->list_sched) {
         remove_list_sched(tcb);
     }
-    tcb->timeout = timeout + m_idle_elapse;
-    tcb->list_sched = &m_list_sleep;
-    kl_blist_append(tcb->list_sched, &tcb->node_sched);
-    if (tcb->timeout < m_idle_timeout) {
-        m_idle_timeout = tcb->timeout;
+    add_list_sleep(tcb, timeout);
+}
+
+kl_tick_t kl_sched_tcb_timeout(kl_thread_t tcb) {
+    if (tcb->list_sched == &m_list_sleep &&
+        !KL_GET_FLAG(tcb->flags, KL_THREAD_FLAGS_SUSPEND)) {
+        return SLEEP_LEFT(tcb);
     }
-    KL_SET_FLAG(tcb->flags, KL_THREAD_FLAGS_SLEEP);
+    return tcb->timeout;
 }
 
 void kl_sched_tcb_wait(kl_thread_t tcb, struct kl_thread_list* list) {
@@ -304,6 +318,10 @@ void kl_sched_preempt(const bool round_robin) {
         /* ready list empty or last switch was not completed */
         return;
     }
+    if (kl_sched_tcb_now->list_wait || kl_sched_tcb_now->list_sched) {
+        /* current thread is blocking, the caller will switch */
+        return;
+    }
     if (m_susp_nesting) { /* in critical section */
         KL_SET_FLAG(m_susp_pending_flags, SUSPEND_PREEMPT_PENDING);
         if (round_robin) {
@@ -332,40 +350,38 @@ void kl_sched_preempt(const bool round_robin) {
     }
 }
 
-static inline void kl_sched_timeout(void) {
+static inline void kl_sched_timeout(kl_tick_t ticks) {
     kl_thread_t tcb;
     struct kl_thread_node* node;
     struct kl_thread_node* next;
-    m_idle_timeout = KL_WAIT_FOREVER;
+    /* sleep list is ordered, only the expired head part is visited */
     for (node = m_list_sleep.head; node != NULL; node = next) {
         next = node->next;
         tcb = node->tcb;
-        if (tcb->timeout > m_idle_elapse) {
-            tcb->timeout -= m_idle_elapse;
-            if (tcb->timeout < m_idle_timeout) {
-                m_idle_timeout = tcb->timeout;
-            }
-        } else {
-            tcb->timeout = 0;
-            kl_sched_tcb_wake_up(tcb);
+        if (SLEEP_LEFT(tcb) > ticks) {
+            break;
         }
+        kl_sched_tcb_wake_up(tcb);
+        tcb->timeout = 0;
     }
+    m_sched_tick += ticks;
 }
 
-void kl_sched_timing(void) {
-    m_idle_elapse++;
-    kl_sched_tcb_now->time++;
+void kl_sched_timing(kl_tick_t ticks) {
+    kl_sched_tcb_now->time += ticks;
 #if KLITE_CFG_STACKOF_DETECT_ON_TICK_INC
     kl_sched_stack_overflow_check();
 #endif
 #if KLITE_CFG_ROUND_ROBIN_SLICE
-    if (kl_sched_tcb_now->slice_tick) {
-        kl_sched_tcb_now->slice_tick--;
+    if (kl_sched_tcb_now->slice_tick > ticks) {
+        kl_sched_tcb_now->slice_tick -= ticks;
+    } else {
+        kl_sched_tcb_now->slice_tick = 0;
     }
 #endif
     // MLFQ scheduling check
 #if KLITE_CFG_MLFQ
-    m_mlfq_reset_tick++;
+    m_mlfq_reset_tick += ticks;
     if (m_mlfq_reset_tick >= KLITE_CFG_MLFQ_RESET_TICK) {
         m_mlfq_reset_tick = 0;
         // clear mlfq tick
@@ -393,7 +409,8 @@ void kl_sched_timing(void) {
     }
     if (kl_sched_tcb_now->prio > 1) {
         // Lowest priority does not need to be scheduled
-        if (++kl_sched_tcb_now->mlfq_tick >= kl_sched_tcb_now->mlfq_quota) {
+        kl_sched_tcb_now->mlfq_tick += ticks;
+        if (kl_sched_tcb_now->mlfq_tick >= kl_sched_tcb_now->mlfq_quota) {
             // Quota used up, move to lower priority
             kl_sched_tcb_now->prio = kl_sched_tcb_now->prio - 1;
             kl_sched_tcb_now->mlfq_tick = 0;
@@ -404,24 +421,22 @@ void kl_sched_timing(void) {
     }
 #endif
     //
-    if (m_idle_elapse >= m_idle_timeout) {
-        kl_sched_timeout();
-        m_idle_elapse = 0;
-    }
+    kl_sched_timeout(ticks);
 }
 
 void kl_sched_idle(void) {
     if (m_prio_bitmap) {
         kl_sched_tcb_ready(kl_sched_tcb_now, false);
         kl_sched_switch();
+    } else if (m_list_sleep.head != NULL) {
+        kl_port_sys_idle(SLEEP_LEFT(m_list_sleep.head->tcb));
     } else {
-        kl_port_sys_idle(m_idle_timeout);
+        kl_port_sys_idle(KL_WAIT_FOREVER);
     }
 }
 
 void kl_sched_init(void) {
-    m_idle_elapse = 0;
-    m_idle_timeout = KL_WAIT_FOREVER;
+    m_sched_tick = 0;
     m_prio_highest = 0;
     m_prio_bitmap = 0;
     m_susp_nesting = 0;
@@ -161,6 +161,14 @@ bool kl_thread_join(kl_thread_t thread, kl_tick_t timeout) {
         return true;  // 可能是已结束的线程
     }
     kl_port_enter_critical();
+    if (KL_GET_FLAG(thread->flags, KL_THREAD_FLAGS_EXITED)) {
+        kl_port_leave_critical();
+        return true;  // 已退出, 尚未被idle线程回收
+    }
+    if (timeout == 0) {
+        kl_port_leave_critical();
+        return false;
+    }
     kl_sched_tcb_timed_wait(kl_sched_tcb_now, &thread->list_join, timeout);
     kl_sched_switch();
     kl_port_leave_critical();
@@ -278,7 +286,10 @@ kl_tick_t kl_thread_timeout(kl_thread_t thread) {
         KL_SET_ERRNO(KL_EINVAL);
         return KL_INVALID;
     }
-    return thread->timeout;
+    kl_port_enter_critical();
+    kl_tick_t timeout = kl_sched_tcb_timeout(thread);
+    kl_port_leave_critical();
+    return timeout;
 }
 
 kl_thread_t kl_thread_find(uint32_t id) {
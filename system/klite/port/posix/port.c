@@ -0,0 +1,209 @@
+// POSIX主机模拟端口
+// 所有线程以ucontext运行在同一个宿主线程上, 以SIGALRM作为时钟中断.
+// 临界区只是一个嵌套计数, 不调用sigprocmask: 临界区内到达的时钟只计数,
+// 在退出最外层临界区时补上, 这样内核路径的开销与硬件接近, 可用于性能测量.
+// 注意:
+// 1. 时钟信号帧压在线程栈上, 线程栈不应小于PORT_MIN_STACK
+// 2. 线程可能在任意位置被切换, 调用非可重入的libc函数(printf/malloc等)
+//    时需处于临界区内(kl_kernel_enter_critical)
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include "kl_priv.h"
+
+#define PORT_TICK_SIGNAL SIGALRM
+#define PORT_TICK_NS (1000000000ULL / KLITE_CFG_FREQ)
+#define PORT_MIN_STACK 16384
+
+typedef struct {
+    ucontext_t ctx;        // 线程上下文
+    void (*entry)(void*);  // 线程入口
+    void* arg;             // 线程参数
+    void (*exit)(void);    // 线程结束回调
+} port_frame_t;
+
+static sigset_t m_tick_sigset;
+static timer_t m_tick_timer;
+static uint64_t m_tick_next;  // 下一个tick的宿主时刻(ns)
+static volatile uint32_t m_critical_nesting;
+static volatile uint32_t m_tick_pending;  // 临界区内到达的时钟数
+static volatile bool m_switch_pending;
+
+static uint64_t host_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// 设置时钟在宿主时刻at触发, interval为0时只触发一次
+static void timer_arm(uint64_t at, uint64_t interval) {
+    struct itimerspec its;
+    its.it_value.tv_sec = at / 1000000000ULL;
+    its.it_value.tv_nsec = at % 1000000000ULL;
+    its.it_interval.tv_sec = interval / 1000000000ULL;
+    its.it_interval.tv_nsec = interval % 1000000000ULL;
+    timer_settime(m_tick_timer, TIMER_ABSTIME, &its, NULL);
+}
+
+static void tick_handler(int sig) {
+    (void)sig;
+    m_tick_next += PORT_TICK_NS;
+    if (m_critical_nesting)
+        m_tick_pending++;  // 推迟到退出临界区时处理
+    else
+        kl_kernel_tick_source();
+}
+
+static void thread_start(void) {
+    port_frame_t* frame = (port_frame_t*)kl_sched_tcb_now->stack;
+    kl_port_leave_critical();  // 切换总是在临界区内发生
+    frame->entry(frame->arg);
+    frame->exit();
+}
+
+// 执行挂起的切换, 相当于PendSV, 只在最外层临界区退出时调用
+static void port_switch(void) {
+    kl_thread_t prev;
+    while (m_switch_pending) {
+        m_switch_pending = false;
+        prev = kl_sched_tcb_now;
+        kl_sched_tcb_now = kl_sched_tcb_next;
+        if (prev != kl_sched_tcb_now) {
+            swapcontext(&((port_frame_t*)prev->stack)->ctx,
+                        &((port_frame_t*)kl_sched_tcb_now->stack)->ctx);
+        }
+    }
+}
+
+void kl_port_context_switch(void) {
+    m_switch_pending = true;
+}
+
+void* kl_port_stack_init(void* stack_base, void* stack_top, void* entry,
+                         void* arg, void* exit) {
+    uintptr_t top = ((uintptr_t)stack_top - sizeof(port_frame_t)) & ~15UL;
+    port_frame_t* frame = (port_frame_t*)top;
+    if (top < (uintptr_t)stack_base + PORT_MIN_STACK) {
+        fprintf(stderr, "klite: stack too small for posix port (%lu)\n",
+                (unsigned long)((uintptr_t)stack_top - (uintptr_t)stack_base));
+        abort();
+    }
+    getcontext(&frame->ctx);
+    frame->ctx.uc_stack.ss_sp = stack_base;
+    frame->ctx.uc_stack.ss_size = top - (uintptr_t)stack_base;
+    frame->ctx.uc_link = NULL;
+    sigdelset(&frame->ctx.uc_sigmask, PORT_TICK_SIGNAL);
+    frame->entry = (void (*)(void*))entry;
+    frame->arg = arg;
+    frame->exit = (void (*)(void))exit;
+    makecontext(&frame->ctx, thread_start, 0);
+    return frame;
+}
+
+void kl_port_enter_critical(void) {
+    m_critical_nesting++;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+}
+
+void kl_port_leave_critical(void) {
+    uint32_t ticks;
+    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    if (m_critical_nesting == 0)
+        return;
+    if (m_critical_nesting > 1) {
+        m_critical_nesting--;
+        return;
+    }
+    while (1) {
+        ticks = __atomic_exchange_n(&m_tick_pending, 0, __ATOMIC_RELAXED);
+        if (ticks)
+            kl_kernel_tick_advance(ticks);
+        port_switch();
+        m_critical_nesting = 0;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        if (!m_tick_pending)
+            break;
+        m_critical_nesting = 1;  // 清零前又到达了时钟
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    }
+}
+
+void kl_port_sys_init(void) {
+    struct sigaction sa = {0};
+    struct sigevent sev = {0};
+    sigemptyset(&m_tick_sigset);
+    sigaddset(&m_tick_sigset, PORT_TICK_SIGNAL);
+    kl_port_enter_critical();  // 直到第一个线程启动
+    sa.sa_handler = tick_handler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(PORT_TICK_SIGNAL, &sa, NULL);
+    sev.sigev_notify = SIGEV_SIGNAL;
+    sev.sigev_signo = PORT_TICK_SIGNAL;
+    timer_create(CLOCK_MONOTONIC, &sev, &m_tick_timer);
+}
+
+void kl_port_sys_start(void) {
+    m_tick_next = host_now() + PORT_TICK_NS;
+    timer_arm(m_tick_next, PORT_TICK_NS);
+    m_switch_pending = false;
+    kl_sched_tcb_now = kl_sched_tcb_next;
+    setcontext(&((port_frame_t*)kl_sched_tcb_now->stack)->ctx);
+}
+
+#if KLITE_CFG_TICKLESS
+// 停止周期时钟, 只在唤醒时刻触发一次, 唤醒后补偿经过的tick
+// 调用时时钟信号已被屏蔽
+static void tickless_sleep(kl_tick_t time) {
+    static const struct timespec no_wait = {0, 0};
+    sigset_t pending;
+    uint64_t now;
+    kl_tick_t elapsed;
+    if (time > KLITE_CFG_FREQ)
+        time = KLITE_CFG_FREQ;  // 无定时唤醒时每秒醒来一次
+    // 先换成单次触发再检查挂起, 之后周期时钟不会再到期
+    timer_arm(m_tick_next + (time - 1) * PORT_TICK_NS, 0);
+    sigpending(&pending);
+    if (sigismember(&pending, PORT_TICK_SIGNAL)) {
+        // 换时钟前已到期, 不再睡眠. 宿主可能在重设定时器后丢弃该信号
+        sigtimedwait(&m_tick_sigset, NULL, &no_wait);
+    } else {
+        // 模拟环境中没有其他唤醒源, 时钟只会在设定的时刻触发
+        while (sigwaitinfo(&m_tick_sigset, NULL) < 0) {}
+    }
+    // 按宿主时间计算经过的tick, 不依赖收到的是哪一次定时的信号
+    now = host_now();
+    elapsed = now < m_tick_next ? 1 : (now - m_tick_next) / PORT_TICK_NS + 1;
+    if (elapsed > time)
+        elapsed = time;
+    m_tick_next += elapsed * PORT_TICK_NS;
+    if (m_tick_next <= now)  // 宿主调度延迟时不追赶, 与周期时钟一致
+        m_tick_next = now + PORT_TICK_NS;
+    timer_arm(m_tick_next, PORT_TICK_NS);
+    kl_kernel_tick_advance(elapsed);
+}
+#endif
+
+void kl_port_sys_idle(kl_tick_t time) {
+    sigset_t mask, wait;
+    // 在临界区内调用, 先真正屏蔽时钟信号, 避免检查与等待之间丢失唤醒
+    sigprocmask(SIG_BLOCK, &m_tick_sigset, &mask);
+    wait = mask;
+    sigdelset(&wait, PORT_TICK_SIGNAL);
+    if (!m_tick_pending) {  // 已有推迟的时钟时直接返回
+#if KLITE_CFG_TICKLESS
+        if (time >= 2)
+            tickless_sleep(time);
+        else
+            sigsuspend(&wait);  // 等待下一个时钟中断, 相当于WFI
+#else
+        (void)time;
+        sigsuspend(&wait);
+#endif
+    }
+    sigprocmask(SIG_SETMASK, &mask, NULL);
+}
@@ -0,0 +1,329 @@
+// klite内核基准测试, 运行于POSIX模拟端口
+// 在工程根目录构建并运行:
+//   gcc -O2 -Isystem/klite/test -I. -Idebug/log -Iutility/macro
+//       -Isystem/klite/include -Idebug/minctest system/klite/kernel/*.c
+//       system/klite/ipc/*.c system/klite/heap/builtin.c
+//       system/klite/port/posix/port.c system/klite/test/kl_bench.c
+//       -o kl_bench -lrt
+//   ./kl_bench [迭代次数]
+// 每项测试输出每次操作的宿主耗时(ns), 用于在上板前比较内核改动前后的性能.
+// 最后几项测量睡眠唤醒延迟和时钟开销, 加-DKLITE_CFG_TICKLESS=1构建可与
+// 周期时钟比较. 全部完成且结果校验通过时返回0
+// 注意: 结果包含模拟时钟(SIGALRM)的开销, 只适合同一主机上的相对比较
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "kl_priv.h"  // kl_kernel_tick_source
+
+// 工作线程也可能报告失败, 打印时不被抢占
+#define CHECK_LOCK() kl_kernel_enter_critical()
+#define CHECK_UNLOCK() kl_kernel_exit_critical()
+#include "host_check.h"
+
+#define BENCH_HEAP_SIZE (8 << 20)
+#define BENCH_STACK 65536
+#define BENCH_ITERATIONS 100000
+#define BENCH_MSG_SIZE 16
+#define BENCH_QUEUE_DEPTH 16
+#define BENCH_POOL_WORKERS 4
+#define BENCH_HEAP_SLOTS 64
+#define BENCH_TICK_NS (1000000000ULL / KLITE_CFG_FREQ)
+#define BENCH_IDLE_TICKS 500
+#define BENCH_TICK_SLEEPERS 16
+#define BENCH_TICK_CALLS 100000
+#define BENCH_TICK_TIMEOUT (BENCH_TICK_CALLS * 10)
+
+#if KLITE_CFG_TICKLESS
+#define BENCH_TICK_MODE "tickless"
+#else
+#define BENCH_TICK_MODE "periodic"
+#endif
+
+#if KLITE_CFG_MLFQ  // 优先级由调度器管理
+#define BENCH_PRIO_MAIN 0
+#define BENCH_PRIO_WORKER 0
+#else  // 主线程优先级最高, 阻塞等待时工作线程才开始运行
+#define BENCH_PRIO_MAIN KLITE_CFG_MAX_PRIO
+#define BENCH_PRIO_WORKER 1
+#endif
+
+static uint8_t m_heap[BENCH_HEAP_SIZE];
+static uint32_t m_iterations = BENCH_ITERATIONS;
+static uint64_t m_start;
+
+static uint64_t host_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_begin(void) {
+    m_start = host_now();
+}
+
+// 输出结果, ops为操作次数, ok为结果校验
+static void bench_end(const char* name, uint64_t ops, bool ok) {
+    uint64_t ns = host_now() - m_start;
+    kl_kernel_enter_critical();  // printf不可重入
+    printf("%-18s %10llu ops %10.1f ns/op\n", name, (unsigned long long)ops,
+           (double)ns / (double)ops);
+    if (!ok)
+        CHECK_FAIL("%s: FAILED", name);
+    fflush(stdout);
+    kl_kernel_exit_critical();
+}
+
+// 创建两个同优先级的线程并等待结束
+static bool run_pair(void (*a)(void*), void (*b)(void*), void* arg) {
+    kl_thread_t ta = kl_thread_create(a, arg, BENCH_STACK, BENCH_PRIO_WORKER);
+    kl_thread_t tb = kl_thread_create(b, arg, BENCH_STACK, BENCH_PRIO_WORKER);
+    if (ta == NULL || tb == NULL)
+        return false;
+    kl_thread_join(ta, KL_WAIT_FOREVER);
+    kl_thread_join(tb, KL_WAIT_FOREVER);
+    return true;
+}
+
+/* 上下文切换: 两个线程交替yield */
+
+static void yield_entry(void* arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < m_iterations; i++)
+        kl_thread_yield();
+}
+
+static void bench_switch(void) {
+    bench_begin();
+    bool ok = run_pair(yield_entry, yield_entry, NULL);
+    bench_end("context switch", 2ULL * m_iterations, ok);
+}
+
+/* 互斥锁: 两个线程争用同一把锁, 每次解锁都把锁交给对方 */
+
+static void mutex_entry(void* arg) {
+    kl_mutex_t mutex = (kl_mutex_t)arg;
+    for (uint32_t i = 0; i < m_iterations; i++) {
+        kl_mutex_lock(mutex, KL_WAIT_FOREVER);
+        if (i == 0)
+            kl_thread_yield();  // 让另一个线程进入等待, 此后每次加锁都阻塞
+        kl_mutex_unlock(mutex);
+    }
+}
+
+static void bench_mutex(void) {
+    kl_mutex_t mutex = kl_mutex_create();
+    if (mutex == NULL) {
+        CHECK_FAIL("kl_mutex_create failed");
+        return;
+    }
+    bench_begin();
+    bool ok = run_pair(mutex_entry, mutex_entry, mutex);
+    bench_end("mutex ping-pong", 2ULL * m_iterations, ok);
+    kl_mutex_delete(mutex);
+}
+
+/* 消息队列: 一个生产者, 一个消费者 */
+
+static uint32_t m_mq_sum;
+
+static void mq_producer(void* arg) {
+    uint32_t msg[BENCH_MSG_SIZE / sizeof(uint32_t)] = {0};
+    for (uint32_t i = 0; i < m_iterations; i++) {
+        msg[0] = i;
+        kl_mqueue_send((kl_mqueue_t)arg, msg, KL_WAIT_FOREVER);
+    }
+}
+
+static void mq_consumer(void* arg) {
+    uint32_t msg[BENCH_MSG_SIZE / sizeof(uint32_t)];
+    for (uint32_t i = 0; i < m_iterations; i++) {
+        kl_mqueue_recv((kl_mqueue_t)arg, msg, KL_WAIT_FOREVER);
+        m_mq_sum += msg[0] == i;
+    }
+}
+
+static void bench_mqueue(void) {
+    kl_mqueue_t queue = kl_mqueue_create(BENCH_MSG_SIZE, BENCH_QUEUE_DEPTH);
+    if (queue == NULL) {
+        CHECK_FAIL("kl_mqueue_create failed");
+        return;
+    }
+    m_mq_sum = 0;
+    bench_begin();
+    bool ok = run_pair(mq_producer, mq_consumer, queue);
+    bench_end("mqueue send/recv", m_iterations, ok && m_mq_sum == m_iterations);
+    kl_mqueue_delete(queue);
+}
+
+/* 线程池: 主线程提交空任务, 多个工作线程执行 */
+
+static uint32_t m_pool_done;
+
+static void pool_task(void* arg) {
+    (void)arg;
+    __atomic_fetch_add(&m_pool_done, 1, __ATOMIC_RELAXED);
+}
+
+static void bench_pool(void) {
+    kl_thread_pool_t pool =
+        kl_thread_pool_create(BENCH_POOL_WORKERS, BENCH_STACK,
+                              BENCH_PRIO_WORKER, BENCH_QUEUE_DEPTH);
+    if (pool == NULL) {
+        CHECK_FAIL("kl_thread_pool_create failed");
+        return;
+    }
+    bool ok = true;
+    m_pool_done = 0;
+    bench_begin();
+    for (uint32_t i = 0; i < m_iterations && ok; i++)
+        ok = kl_thread_pool_submit(pool, pool_task, NULL, KL_WAIT_FOREVER);
+    ok = ok && kl_thread_pool_join(pool, KL_WAIT_FOREVER);
+    bench_end("thread pool task", m_iterations,
+              ok && m_pool_done == m_iterations);
+    kl_thread_pool_shutdown(pool);
+}
+
+/* 内核堆: 随机大小的分配与释放, 保持一定数量的存活块 */
+
+static void bench_heap(void) {
+    void* slots[BENCH_HEAP_SLOTS] = {0};
+    uint32_t seed = 1;
+    bool ok = true;
+    bench_begin();
+    for (uint32_t i = 0; i < m_iterations; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t idx = (seed >> 16) % BENCH_HEAP_SLOTS;
+        kl_heap_free(slots[idx]);
+        slots[idx] = kl_heap_alloc(16 + (seed >> 8) % 241);
+        ok = ok && slots[idx] != NULL;
+    }
+    bench_end("heap alloc/free", m_iterations, ok);
+    for (uint32_t i = 0; i < BENCH_HEAP_SLOTS; i++)
+        kl_heap_free(slots[i]);
+}
+
+/* 睡眠唤醒延迟: 对齐到tick后睡眠n个tick, 实际耗时超出n个tick的部分.
+   KLITE_CFG_TICKLESS时n >= 2由单次定时唤醒, n = 1等待周期时钟 */
+
+static void bench_wakeup(kl_tick_t n) {
+    uint32_t reps = 200 / n + 5;
+    uint64_t sum = 0, max = 0;
+    for (uint32_t i = 0; i < reps; i++) {
+        kl_thread_sleep(1);
+        uint64_t t0 = host_now();
+        kl_thread_sleep(n);
+        uint64_t dt = host_now() - t0;
+        uint64_t late = dt > n * BENCH_TICK_NS ? dt - n * BENCH_TICK_NS : 0;
+        sum += late;
+        if (late > max)
+            max = late;
+    }
+    kl_kernel_enter_critical();
+    printf("wakeup %4u ticks %10u ops %8.1f us avg %8.1f us max\n",
+           (unsigned)n, (unsigned)reps, sum / 1000.0 / reps, max / 1000.0);
+    fflush(stdout);
+    kl_kernel_exit_critical();
+}
+
+/* 时钟开销: 全部线程睡眠时idle线程的唤醒次数和进程CPU时间,
+   以及有线程在睡眠队列中时内核处理一个tick的耗时 */
+
+static volatile uint32_t m_idle_wakeups;
+
+void kl_kernel_idle_hook(void) {
+    m_idle_wakeups++;
+}
+
+static uint64_t host_cpu(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void tick_sleeper(void* arg) {
+    kl_sem_take((kl_sem_t)arg, BENCH_TICK_TIMEOUT);
+}
+
+static void bench_tick(void) {
+    kl_thread_sleep(1);
+    uint32_t wakeups = m_idle_wakeups;
+    uint64_t cpu = host_cpu();
+    kl_tick_t tick = kl_kernel_tick();
+    kl_thread_sleep(BENCH_IDLE_TICKS);
+    cpu = host_cpu() - cpu;
+    tick = kl_kernel_tick() - tick;
+    wakeups = m_idle_wakeups - wakeups;
+    kl_kernel_enter_critical();
+    printf("idle %6u ticks %10u wakeups %8.1f ns cpu/tick\n", (unsigned)tick,
+           (unsigned)wakeups, (double)cpu / (double)tick);
+    fflush(stdout);
+    kl_kernel_exit_critical();
+
+    // 睡眠线程的超时远大于调用次数, 期间不会有线程到期. 临界区内
+    // 宿主时钟只计数, 测得的只有kl_kernel_tick_source本身
+    kl_thread_t sleepers[BENCH_TICK_SLEEPERS];
+    kl_sem_t sem = kl_sem_create(0);
+    bool ok = sem != NULL;
+    for (uint32_t i = 0; i < BENCH_TICK_SLEEPERS; i++) {
+        sleepers[i] = ok ? kl_thread_create(tick_sleeper, sem, BENCH_STACK,
+                                            BENCH_PRIO_WORKER)
+                         : NULL;
+        ok = ok && sleepers[i] != NULL;
+    }
+    kl_thread_sleep(1);  // 等待全部进入睡眠队列
+    kl_kernel_enter_critical();
+    bench_begin();
+    for (uint32_t i = 0; i < BENCH_TICK_CALLS; i++)
+        kl_kernel_tick_source();
+    uint64_t ns = host_now() - m_start;
+    kl_kernel_exit_critical();
+    for (uint32_t i = 0; i < BENCH_TICK_SLEEPERS && ok; i++)
+        ok = kl_thread_timeout(sleepers[i]) != 0;  // 不应有线程提前到期
+    kl_kernel_enter_critical();
+    printf("tick %6u calls %9u sleepers %7.1f ns/tick\n",
+           (unsigned)BENCH_TICK_CALLS, (unsigned)BENCH_TICK_SLEEPERS,
+           (double)ns / BENCH_TICK_CALLS);
+    if (!ok)
+        CHECK_FAIL("tick: FAILED");
+    fflush(stdout);
+    kl_kernel_exit_critical();
+    for (uint32_t i = 0; i < BENCH_TICK_SLEEPERS; i++)
+        kl_sem_give(sem);
+    for (uint32_t i = 0; i < BENCH_TICK_SLEEPERS && sleepers[i]; i++)
+        kl_thread_join(sleepers[i], KL_WAIT_FOREVER);
+    kl_sem_delete(sem);
+}
+
+static void bench_main(void* arg) {
+    (void)arg;
+    kl_kernel_enter_critical();
+    printf("klite bench: %d Hz %s tick, %u iterations\n", KLITE_CFG_FREQ,
+           BENCH_TICK_MODE,
+           (unsigned)m_iterations);
+    fflush(stdout);
+    kl_kernel_exit_critical();
+    bench_switch();
+    bench_mutex();
+    bench_mqueue();
+    bench_pool();
+    bench_heap();
+    bench_wakeup(1);
+    bench_wakeup(2);
+    bench_wakeup(10);
+    bench_wakeup(100);
+    bench_tick();
+    kl_kernel_enter_critical();
+    exit(CHECK_RESULT());
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && atoi(argv[1]) > 0)
+        m_iterations = (uint32_t)atoi(argv[1]);
+    kl_kernel_init(m_heap, sizeof(m_heap));
+    if (kl_thread_create(bench_main, NULL, BENCH_STACK, BENCH_PRIO_MAIN) ==
+        NULL)
+        return EXIT_FAILURE;
+    kl_kernel_boot();
+    return EXIT_SUCCESS;
+}
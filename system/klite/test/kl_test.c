@@ -0,0 +1,184 @@
+// klite内核回归测试, 运行于POSIX模拟端口
+// 在工程根目录构建并运行:
+//   gcc -O2 -Isystem/klite/test -I. -Idebug/log -Iutility/macro
+//       -Isystem/klite/include -Idebug/minctest system/klite/kernel/*.c
+//       system/klite/ipc/*.c system/klite/heap/builtin.c
+//       system/klite/port/posix/port.c system/klite/test/kl_test.c -o kl_test
+//       -lrt
+//   ./kl_test
+// 全部通过时返回0. 每项测试由最高优先级的主线程驱动, 被测线程优先级更低,
+// 主线程只做带超时的等待, 内核状态损坏时报告失败而不是卡死
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "kl_priv.h"
+#include "klite.h"
+
+// 被测线程也会检查, 打印时不被抢占
+#define CHECK_LOCK() kl_kernel_enter_critical()
+#define CHECK_UNLOCK() kl_kernel_exit_critical()
+#include "host_check.h"
+
+#define TEST_HEAP_SIZE (8 << 20)
+#define TEST_STACK 65536
+#define TEST_PRIO_MAIN KLITE_CFG_MAX_PRIO
+
+static uint8_t m_heap[TEST_HEAP_SIZE];
+
+static kl_thread_t spawn(void (*entry)(void*), void* arg, uint32_t prio) {
+    kl_thread_t thread = kl_thread_create(entry, arg, TEST_STACK, prio);
+    CHECK(thread != NULL);
+    return thread;
+}
+
+/* 等待结果: 被唤醒返回true, 超时返回false */
+
+static kl_event_t m_event;
+
+static void event_setter(void* arg) {
+    (void)arg;
+    kl_event_set(m_event);
+}
+
+static void test_wait_result(void) {
+    m_event = kl_event_create(true);
+    CHECK(m_event != NULL);
+    spawn(event_setter, NULL, 1);
+    CHECK(kl_event_wait(m_event, 100));  // 被唤醒
+    CHECK(!kl_event_wait(m_event, 2));   // 超时
+    CHECK(kl_thread_errno(kl_thread_self()) == KL_ETIMEOUT);
+    kl_event_delete(m_event);
+}
+
+/* 屏障: 最后到达的线程不阻塞, 不受上次等待遗留的超时状态影响 */
+
+static kl_barrier_t m_barrier;
+static bool m_barrier_ret;
+
+static void barrier_waiter(void* arg) {
+    (void)arg;
+    m_barrier_ret = kl_barrier_wait(m_barrier, 100);
+}
+
+static void test_barrier(void) {
+    m_barrier = kl_barrier_create(2);
+    CHECK(m_barrier != NULL);
+    kl_thread_t waiter = spawn(barrier_waiter, NULL, 1);
+    kl_thread_sleep(2);  // 等待线程先到达, 睡眠结束后timeout为0
+    CHECK(kl_barrier_wait(m_barrier, 100));
+    CHECK(kl_thread_join(waiter, 100));
+    CHECK(m_barrier_ret);
+    kl_barrier_delete(m_barrier);
+}
+
+/* 抢占: 线程在阻塞过程中释放互斥锁, 不能把被唤醒的高优先级线程丢失 */
+
+static kl_mutex_t m_mutex;
+static kl_cond_t m_cond;
+
+static void preempt_low(void* arg) {
+    (void)arg;
+    kl_mutex_lock(m_mutex, KL_WAIT_FOREVER);
+    kl_thread_sleep(2);  // 让高优先级线程阻塞在互斥锁上
+    // 阻塞时释放互斥锁, 唤醒高优先级线程
+    if (kl_cond_wait(m_cond, m_mutex, 100))
+        kl_mutex_unlock(m_mutex);
+}
+
+static void preempt_high(void* arg) {
+    (void)arg;
+    kl_mutex_lock(m_mutex, KL_WAIT_FOREVER);
+    kl_mutex_unlock(m_mutex);
+}
+
+static void test_preempt(void) {
+    m_mutex = kl_mutex_create();
+    m_cond = kl_cond_create();
+    CHECK(m_mutex != NULL && m_cond != NULL);
+    kl_thread_t low = spawn(preempt_low, NULL, 2);
+    kl_thread_sleep(1);  // 低优先级线程先持有互斥锁
+    kl_thread_t high = spawn(preempt_high, NULL, 5);
+    CHECK(kl_thread_join(high, 100));
+    kl_cond_signal(m_cond);
+    CHECK(kl_thread_join(low, 100));
+    kl_cond_delete(m_cond);
+    kl_mutex_delete(m_mutex);
+}
+
+/* 等待线程结束: timeout为0时不阻塞 */
+
+static void join_sleeper(void* arg) {
+    (void)arg;
+    kl_thread_sleep(20);
+}
+
+static void join_exiter(void* arg) {
+    (void)arg;
+}
+
+static void test_join(void) {
+    kl_thread_t sleeper = spawn(join_sleeper, NULL, 1);
+    kl_tick_t tick = kl_kernel_tick();
+    CHECK(!kl_thread_join(sleeper, 0));
+    CHECK(kl_kernel_tick() == tick);
+    CHECK(kl_thread_join(sleeper, 100));
+    kl_thread_t exiter = spawn(join_exiter, NULL, 6);
+    kl_thread_sleep(1);
+    CHECK(kl_thread_join(exiter, 0));  // 已退出的线程
+}
+
+/* 线程池: 关闭时工作线程正持有任务队列的互斥锁 */
+
+static void tpool_owner(void* arg) {
+    (void)arg;
+    kl_thread_pool_t pool = kl_thread_pool_create(1, TEST_STACK, 3, 4);
+    CHECK(pool != NULL);
+    if (pool == NULL)
+        return;
+    kl_mutex_lock(&pool->task_queue->mutex, KL_WAIT_FOREVER);
+    kl_thread_sleep(1);  // 工作线程阻塞在任务队列的互斥锁上
+    kl_mutex_unlock(&pool->task_queue->mutex);  // 所有权移交给工作线程
+    kl_thread_pool_shutdown(pool);
+}
+
+static void test_tpool_shutdown(void) {
+    kl_thread_t owner = spawn(tpool_owner, NULL, 6);
+    CHECK(kl_thread_join(owner, 200));
+}
+
+/* 测试列表 */
+
+static const struct {
+    const char* name;
+    void (*func)(void);
+} m_cases[] = {
+    {"wait result", test_wait_result},
+    {"barrier", test_barrier},
+    {"preempt", test_preempt},
+    {"join", test_join},
+    {"thread pool shutdown", test_tpool_shutdown},
+};
+
+static void test_main(void* arg) {
+    (void)arg;
+    for (size_t i = 0; i < sizeof(m_cases) / sizeof(m_cases[0]); i++) {
+        int fails = m_fails;
+        m_cases[i].func();
+        kl_thread_sleep(2);  // 让idle线程回收退出的线程
+        kl_kernel_enter_critical();
+        printf("%s %s\n", m_fails != fails ? "FAIL" : "PASS",
+               m_cases[i].name);
+        fflush(stdout);
+        kl_kernel_exit_critical();
+    }
+    kl_kernel_enter_critical();
+    exit(CHECK_RESULT());
+}
+
+int main(void) {
+    kl_kernel_init(m_heap, sizeof(m_heap));
+    if (kl_thread_create(test_main, NULL, TEST_STACK, TEST_PRIO_MAIN) == NULL)
+        return EXIT_FAILURE;
+    kl_kernel_boot();
+    return EXIT_SUCCESS;
+}
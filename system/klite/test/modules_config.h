@@ -0,0 +1,34 @@
+// klite主机测试配置
+// 相当于选择MOD_CFG_CPU_POSIX后由Kconfig生成的modules_config.h
+#define MOD_CFG_COMPILER_GCC 1
+#define MOD_CFG_CPU_POSIX 1
+#define MOD_CFG_USE_OS_KLITE 1
+#define MOD_CFG_PLATFORM_HEADER <stddef.h>
+#define MOD_CFG_TIME_MATHOD_CUSTOM 1
+#define MOD_CFG_CUSTOM_TIME_TYPE_U64 1
+#define MOD_CFG_CUSTOM_TIME_BASE 1000
+#define MOD_CFG_DELAY_MATHOD_CUSTOM 1
+#define MOD_CFG_HEAP_MATHOD_STDLIB 1
+#define MOD_CFG_ENABLE_ATOMIC 1
+#define MOD_ENABLE_KLITE 1
+#define KLITE_CFG_FREQ 1000
+#define KLITE_CFG_MAX_PRIO 7
+#define KLITE_CFG_DEFAULT_PRIO 4
+#define KLITE_CFG_HEAP_USE_BUILTIN 1
+#define KLITE_CFG_HEAP_USE_BESTFIT 1
+#define KLITE_CFG_HEAP_STORAGE_PREV_NODE 1
+#define KLITE_CFG_HEAP_ALIGN_BYTE 16
+#define KLITE_CFG_ROUND_ROBIN 1
+#define KLITE_CFG_DEFAULT_STACK_SIZE 65536
+#define KLITE_CFG_IDLE_THREAD_STACK_SIZE 65536
+#define KLITE_CFG_WAIT_LIST_ORDER_BY_FIFO 1
+#define KLITE_CFG_64BIT_TICK 1
+#define KLITE_CFG_IPC_ENABLE 1
+#define KLITE_CFG_IPC_MUTEX 1
+#define KLITE_CFG_IPC_SEM 1
+#define KLITE_CFG_IPC_COND 1
+#define KLITE_CFG_IPC_BARRIER 1
+#define KLITE_CFG_IPC_EVENT 1
+#define KLITE_CFG_IPC_MQUEUE 1
+#define KLITE_CFG_IPC_THREAD_POOL 1
+#define LOG_CFG_ENABLE 0
@@ -0,0 +1,197 @@
+/**
+ * @file mpool.c
+ * @brief 定长内存池与按大小分级的slab分配器
+ * @author EmbeddedModules contributors
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#include "mpool.h"
+
+#include <string.h>
+
+// Private Macros ---------------------------
+
+#define MSLAB_LOCK()                                     \
+    {                                                    \
+        if (slab->opt & MSLAB_OPT_MUTEX) {               \
+            if (!slab->mutex)                            \
+                slab->mutex = MOD_MUTEX_CREATE("mslab"); \
+            MOD_MUTEX_ACQUIRE(slab->mutex);              \
+        }                                                \
+    }
+#define MSLAB_UNLOCK()                      \
+    {                                       \
+        if (slab->opt & MSLAB_OPT_MUTEX)    \
+            MOD_MUTEX_RELEASE(slab->mutex); \
+    }
+
+// Private Functions ------------------------
+
+/**
+ * @brief 查找ptr所在的内存池, 不在任何池中时返回NULL
+ */
+static mpool_t* slab_owner(mslab_t* slab, const void* ptr) {
+    for (uint8_t i = 0; i < slab->npool; i++) {
+        if (mpool_contains(&slab->pools[i], ptr))
+            return &slab->pools[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief 从能容纳size的池中分配(需已加锁)
+ */
+static void* slab_alloc_locked(mslab_t* slab, size_t size) {
+    for (uint8_t i = 0; i < slab->npool; i++) {
+        if (slab->pools[i].bsize < size)
+            continue;
+        void* ptr = mpool_alloc(&slab->pools[i]);
+        if (ptr != NULL)
+            return ptr;
+    }
+    if (!(slab->opt & MSLAB_OPT_HEAP_FALLBACK))
+        return NULL;
+    void* ptr = m_alloc(size);
+    if (ptr != NULL)
+        slab->fallback++;
+    return ptr;
+}
+
+// Public Functions -------------------------
+
+bool mpool_init(mpool_t* pool, void* buf, mod_size_t bsize, mod_size_t count) {
+    if (buf == NULL || bsize == 0 || count == 0)
+        return false;
+    pool->buf = buf;
+    pool->bsize = MPOOL_BLOCK_SIZE(bsize);
+    pool->total = count;
+    pool->used = 0;
+    pool->peak = 0;
+    pool->carve = 0;
+    pool->free_list = NULL;
+    pool->dyn = false;
+    return true;
+}
+
+bool mpool_new(mpool_t* pool, mod_size_t bsize, mod_size_t count) {
+    void* buf = m_alloc(MPOOL_BLOCK_SIZE(bsize) * count);
+    if (!mpool_init(pool, buf, bsize, count)) {
+        if (buf != NULL)
+            m_free(buf);
+        return false;
+    }
+    pool->dyn = true;
+    return true;
+}
+
+void mpool_deinit(mpool_t* pool) {
+    if (pool->dyn && pool->buf != NULL)
+        m_free(pool->buf);
+    memset(pool, 0, sizeof(mpool_t));
+}
+
+void* mpool_alloc(mpool_t* pool) {
+    void* ptr = pool->free_list;
+    if (ptr != NULL) {
+        pool->free_list = *(void**)ptr;
+    } else if (pool->carve < pool->total) {  // 取用从未分配过的块
+        ptr = pool->buf + pool->bsize * pool->carve++;
+    } else {
+        return NULL;
+    }
+    if (++pool->used > pool->peak)
+        pool->peak = pool->used;
+    return ptr;
+}
+
+void mpool_free(mpool_t* pool, void* ptr) {
+    if (ptr == NULL)
+        return;
+    *(void**)ptr = pool->free_list;
+    pool->free_list = ptr;
+    pool->used--;
+}
+
+void mslab_init(mslab_t* slab, mpool_t* pools, uint8_t npool, uint8_t opt) {
+    slab->pools = pools;
+    slab->npool = npool;
+    slab->opt = opt;
+    slab->fallback = 0;
+    slab->mutex = 0;
+    slab->allocator.alloc = __mslab_alloc;
+    slab->allocator.realloc = __mslab_realloc;
+    slab->allocator.free = __mslab_free;
+    slab->allocator.ctx = slab;
+}
+
+void* mslab_alloc(mslab_t* slab, size_t size) {
+    if (size == 0)
+        return NULL;
+    MSLAB_LOCK();
+    void* ptr = slab_alloc_locked(slab, size);
+    MSLAB_UNLOCK();
+    return ptr;
+}
+
+void* mslab_realloc(mslab_t* slab, void* ptr, size_t size) {
+    if (ptr == NULL)
+        return mslab_alloc(slab, size);
+    if (size == 0) {
+        mslab_free(slab, ptr);
+        return NULL;
+    }
+    MSLAB_LOCK();
+    mpool_t* pool = slab_owner(slab, ptr);
+    void* new_ptr;
+    if (pool == NULL) {  // 堆上的内存继续留在堆上
+        new_ptr = m_realloc(ptr, size);
+    } else if (size <= pool->bsize) {  // 缩小: 更小一级的池有空闲块时才搬移
+        new_ptr = ptr;
+        for (mpool_t* p = slab->pools; p < pool; p++) {
+            void* blk;
+            if (p->bsize < size || (blk = mpool_alloc(p)) == NULL)
+                continue;
+            memcpy(blk, ptr, size);
+            mpool_free(pool, ptr);
+            new_ptr = blk;
+            break;
+        }
+    } else {
+        new_ptr = slab_alloc_locked(slab, size);
+        if (new_ptr != NULL) {
+            memcpy(new_ptr, ptr, size < pool->bsize ? size : pool->bsize);
+            mpool_free(pool, ptr);
+        }
+    }
+    MSLAB_UNLOCK();
+    return new_ptr;
+}
+
+void mslab_free(mslab_t* slab, void* ptr) {
+    if (ptr == NULL)
+        return;
+    MSLAB_LOCK();
+    mpool_t* pool = slab_owner(slab, ptr);
+    if (pool != NULL)
+        mpool_free(pool, ptr);
+    else
+        m_free(ptr);
+    MSLAB_UNLOCK();
+}
+
+void* __mslab_alloc(void* ctx, size_t size) {
+    return mslab_alloc((mslab_t*)ctx, size);
+}
+
+void* __mslab_realloc(void* ctx, void* ptr, size_t size) {
+    return mslab_realloc((mslab_t*)ctx, ptr, size);
+}
+
+void __mslab_free(void* ctx, void* ptr) {
+    mslab_free((mslab_t*)ctx, ptr);
+}
+
+// Source Code End --------------------------
@@ -0,0 +1,202 @@
+/**
+ * @file mpool.h
+ * @brief 定长内存池与按大小分级的slab分配器
+ * @author EmbeddedModules contributors
+ * @date 2026-10-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#ifndef __MPOOL_H__
+#define __MPOOL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "modules.h"
+
+// Public Defines ---------------------------
+
+#define MPOOL_ALIGN 8  // 块对齐(字节), 保证可存放uint64_t/double
+
+#define MSLAB_OPT_HEAP_FALLBACK 0x01  // 没有合适的池或池已满时使用m_alloc
+#define MSLAB_OPT_MUTEX 0x02          // 使用互斥锁保护(多个任务共享时)
+
+// Public Typedefs --------------------------
+
+typedef struct {         // 定长内存池
+    uint8_t* buf;        // 块存储区
+    void* free_list;     // 空闲块链表(链表指针存放在空闲块内部)
+    mod_size_t bsize;    // 块大小(已对齐)
+    mod_size_t total;    // 块总数
+    mod_size_t used;     // 已分配的块数
+    mod_size_t peak;     // 已分配块数的历史峰值
+    mod_size_t carve;    // 尚未进入过空闲链表的块起点
+    uint8_t dyn;         // 存储区是否由mpool_new动态分配
+} mpool_t;
+
+typedef struct {                // 按块大小分级的slab分配器
+    mpool_t* pools;             // 内存池数组(块大小升序)
+    uint8_t npool;              // 内存池个数
+    uint8_t opt;                // 配置(MSLAB_OPT_*)
+    mod_size_t fallback;        // 回退到堆上的分配次数
+    MOD_MUTEX_HANDLE mutex;     // 互斥锁
+    mod_allocator_t allocator;  // 通用分配器接口(ctx指向本对象)
+} mslab_t;
+
+// Public Macros ----------------------------
+
+/**
+ * @brief 计算块对齐后的大小
+ */
+#define MPOOL_BLOCK_SIZE(bsize)                                           \
+    ((((bsize) < sizeof(void*) ? sizeof(void*) : (bsize)) + MPOOL_ALIGN - \
+      1) /                                                                \
+     MPOOL_ALIGN * MPOOL_ALIGN)
+
+/**
+ * @brief 定义一个可容纳count个bsize字节块的静态存储区
+ */
+#define MPOOL_DEFINE_BUF(name, bsize, count) \
+    static uint64_t name[(MPOOL_BLOCK_SIZE(bsize) * (count) + 7) / 8]
+
+/**
+ * @brief 内存池的静态初始化值, 效果同mpool_init
+ */
+#define MPOOL_STATIC_INIT(buf_, bsize_, count_) \
+    {                                           \
+        .buf = (uint8_t*)(buf_),                \
+        .free_list = NULL,                      \
+        .bsize = MPOOL_BLOCK_SIZE(bsize_),      \
+        .total = (count_),                      \
+    }
+
+/**
+ * @brief slab分配器的静态初始化值, 效果同mslab_init
+ * @param  self             slab分配器变量名
+ * @param  pools_           内存池数组(非指针)
+ * @param  opt_             配置(MSLAB_OPT_*)
+ */
+#define MSLAB_STATIC_INIT(self, pools_, opt_)                       \
+    {                                                               \
+        .pools = (pools_),                                          \
+        .npool = sizeof(pools_) / sizeof((pools_)[0]),              \
+        .opt = (opt_),                                              \
+        .allocator = {__mslab_alloc, __mslab_realloc, __mslab_free, \
+                      &(self)},                                     \
+    }
+
+// Exported Functions -----------------------
+
+extern void* __mslab_alloc(void* ctx, size_t size);
+extern void* __mslab_realloc(void* ctx, void* ptr, size_t size);
+extern void __mslab_free(void* ctx, void* ptr);
+
+/**
+ * @brief 使用外部存储区初始化内存池
+ * @param  pool             内存池
+ * @param  buf              存储区(按MPOOL_ALIGN对齐, 可用MPOOL_DEFINE_BUF定义)
+ * @param  bsize            块大小
+ * @param  count            块个数
+ * @retval bool             是否成功
+ * @note 初始化是O(1)的, 空闲链表在分配时按需延伸
+ */
+extern bool mpool_init(mpool_t* pool, void* buf, mod_size_t bsize,
+                       mod_size_t count);
+
+/**
+ * @brief 从堆上申请存储区并初始化内存池
+ * @param  pool             内存池
+ * @param  bsize            块大小
+ * @param  count            块个数
+ * @retval bool             是否成功
+ * @note 需调用mpool_deinit释放存储区
+ */
+extern bool mpool_new(mpool_t* pool, mod_size_t bsize, mod_size_t count);
+
+/**
+ * @brief 释放mpool_new申请的存储区
+ * @param  pool             内存池
+ * @note 池中已分配的块全部失效
+ */
+extern void mpool_deinit(mpool_t* pool);
+
+/**
+ * @brief 分配一个块
+ * @param  pool             内存池
+ * @retval void*            块指针, 池已满时返回NULL
+ */
+extern void* mpool_alloc(mpool_t* pool);
+
+/**
+ * @brief 归还一个块
+ * @param  pool             内存池
+ * @param  ptr              块指针(必须来自该池)
+ */
+extern void mpool_free(mpool_t* pool, void* ptr);
+
+/**
+ * @brief 判断指针是否位于内存池的存储区中
+ */
+static inline bool mpool_contains(const mpool_t* pool, const void* ptr) {
+    return (const uint8_t*)ptr >= pool->buf &&
+           (const uint8_t*)ptr < pool->buf + pool->bsize * pool->total;
+}
+
+/**
+ * @brief 获取内存池剩余块数
+ */
+static inline mod_size_t mpool_free_count(const mpool_t* pool) {
+    return pool->total - pool->used;
+}
+
+/**
+ * @brief 初始化slab分配器
+ * @param  slab             slab分配器
+ * @param  pools            已初始化的内存池数组, 按块大小升序排列
+ * @param  npool            内存池个数
+ * @param  opt              配置(MSLAB_OPT_*)
+ */
+extern void mslab_init(mslab_t* slab, mpool_t* pools, uint8_t npool,
+                       uint8_t opt);
+
+/**
+ * @brief 从能容纳size的最小块池中分配
+ * @param  slab             slab分配器
+ * @param  size             请求大小
+ * @retval void*            内存指针, 失败返回NULL
+ * @note 所有合适的池都已满时, 继续尝试更大的池, 最后按配置回退到m_alloc
+ */
+extern void* mslab_alloc(mslab_t* slab, size_t size);
+
+/**
+ * @brief 调整内存大小
+ * @param  slab             slab分配器
+ * @param  ptr              原内存指针(可为NULL)
+ * @param  size             新的大小
+ * @retval void*            新的内存指针, 失败返回NULL(原内存不变)
+ * @note 新大小仍能放入原块时原地返回, 仅当更小一级的池有空闲块时才搬移
+ * @note 回退到堆上的内存始终使用m_realloc调整
+ */
+extern void* mslab_realloc(mslab_t* slab, void* ptr, size_t size);
+
+/**
+ * @brief 释放内存
+ * @param  slab             slab分配器
+ * @param  ptr              内存指针(可为NULL)
+ */
+extern void mslab_free(mslab_t* slab, void* ptr);
+
+/**
+ * @brief 获取slab分配器的通用分配器接口, 可用于ulist等模块
+ */
+static inline const mod_allocator_t* mslab_allocator(mslab_t* slab) {
+    return &slab->allocator;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MPOOL_H__ */
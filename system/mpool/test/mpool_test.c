@@ -0,0 +1,173 @@
+// mpool回归测试: 定长池的分配/归还/峰值统计, 静态与动态存储区,
+// slab分配器的分级分配, 溢出到更大的池及堆回退, realloc的搬移规则
+// 在工程根目录构建并运行:
+//   gcc -O1 -g -fsanitize=address,undefined -Isystem/mpool/test -I.
+//       -Isystem/mpool -Idebug/minctest system/mpool/mpool.c
+//       system/mpool/test/mpool_test.c -o mpool_test
+//   ./mpool_test
+// 全部通过时返回0
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_check.h"
+#include "mpool.h"
+
+#define BLOCKS 8
+
+MPOOL_DEFINE_BUF(m_buf, 20, BLOCKS);
+
+/* 定长池: 块对齐且互不重叠, 池满返回NULL, 归还的块被重新使用 */
+static void test_pool(void) {
+    mpool_t pool;
+    void* blk[BLOCKS];
+    CHECK(!mpool_init(&pool, NULL, 20, BLOCKS));
+    CHECK(!mpool_init(&pool, m_buf, 0, BLOCKS));
+    CHECK(mpool_init(&pool, m_buf, 20, BLOCKS));
+    CHECK(pool.bsize == 24);
+    for (int i = 0; i < BLOCKS; i++) {
+        blk[i] = mpool_alloc(&pool);
+        CHECK(blk[i] != NULL && mpool_contains(&pool, blk[i]));
+        CHECK((uintptr_t)blk[i] % MPOOL_ALIGN == 0);
+        memset(blk[i], i, 20);
+    }
+    CHECK(mpool_alloc(&pool) == NULL);
+    CHECK(mpool_free_count(&pool) == 0 && pool.peak == BLOCKS);
+    for (int i = 0; i < BLOCKS; i++) {
+        uint8_t* p = blk[i];
+        CHECK(p[0] == i && p[19] == i);  // 相邻块写入时没有覆盖
+    }
+    mpool_free(&pool, blk[2]);
+    mpool_free(&pool, blk[5]);
+    mpool_free(&pool, NULL);
+    CHECK(mpool_free_count(&pool) == 2);
+    CHECK(mpool_alloc(&pool) == blk[5]);  // 后归还的先分配
+    CHECK(mpool_alloc(&pool) == blk[2]);
+    CHECK(mpool_alloc(&pool) == NULL);
+    CHECK(pool.used == BLOCKS && pool.peak == BLOCKS);
+    CHECK(!mpool_contains(&pool, (uint8_t*)m_buf + 24 * BLOCKS));
+
+    mpool_t st = MPOOL_STATIC_INIT(m_buf, 20, BLOCKS);
+    CHECK(st.bsize == pool.bsize && mpool_free_count(&st) == BLOCKS);
+    CHECK(mpool_alloc(&st) == m_buf);
+}
+
+/* 动态存储区 */
+static void test_pool_new(void) {
+    mpool_t pool;
+    CHECK(!mpool_new(&pool, 16, 0));
+    CHECK(mpool_new(&pool, 3, 4));
+    CHECK(pool.bsize == MPOOL_BLOCK_SIZE(3) && pool.bsize >= sizeof(void*));
+    for (int i = 0; i < 4; i++) CHECK(mpool_alloc(&pool) != NULL);
+    CHECK(mpool_alloc(&pool) == NULL);
+    mpool_deinit(&pool);
+    CHECK(pool.buf == NULL && pool.total == 0);
+}
+
+MPOOL_DEFINE_BUF(m_small, 16, 4);
+MPOOL_DEFINE_BUF(m_large, 64, 2);
+
+static void slab_setup(mslab_t* slab, mpool_t* pools, uint8_t opt) {
+    CHECK(mpool_init(&pools[0], m_small, 16, 4));
+    CHECK(mpool_init(&pools[1], m_large, 64, 2));
+    mslab_init(slab, pools, 2, opt);
+}
+
+/* 按大小选池, 池满时使用更大的池, 最后按配置回退到堆 */
+static void test_slab_alloc(void) {
+    mpool_t pools[2];
+    mslab_t slab;
+    void* p[8];
+    slab_setup(&slab, pools, 0);
+    CHECK(mslab_alloc(&slab, 0) == NULL);
+    for (int i = 0; i < 4; i++) {
+        p[i] = mslab_alloc(&slab, 10);
+        CHECK(mpool_contains(&pools[0], p[i]));
+    }
+    p[4] = mslab_alloc(&slab, 10);  // 小池已满
+    CHECK(mpool_contains(&pools[1], p[4]));
+    p[5] = mslab_alloc(&slab, 64);
+    CHECK(mpool_contains(&pools[1], p[5]));
+    CHECK(mslab_alloc(&slab, 1) == NULL);    // 全部已满且不回退
+    CHECK(mslab_alloc(&slab, 65) == NULL);   // 超过最大块
+    mslab_free(&slab, p[0]);
+    CHECK(mslab_alloc(&slab, 1) == p[0]);
+    for (int i = 0; i < 6; i++) mslab_free(&slab, p[i]);
+    CHECK(pools[0].used == 0 && pools[1].used == 0);
+
+    slab_setup(&slab, pools, MSLAB_OPT_HEAP_FALLBACK | MSLAB_OPT_MUTEX);
+    p[0] = mslab_alloc(&slab, 100);
+    CHECK(p[0] != NULL && slab.fallback == 1);
+    CHECK(!mpool_contains(&pools[0], p[0]) && !mpool_contains(&pools[1], p[0]));
+    memset(p[0], 0xAB, 100);
+    mslab_free(&slab, p[0]);  // 交还给堆
+    CHECK(pools[0].used == 0 && pools[1].used == 0);
+}
+
+/* realloc: 放得下时原地返回, 变大时搬到更大的块, 变小时仅在小池有空闲时搬移 */
+static void test_slab_realloc(void) {
+    mpool_t pools[2];
+    mslab_t slab;
+    slab_setup(&slab, pools, MSLAB_OPT_HEAP_FALLBACK);
+    uint8_t* p = mslab_realloc(&slab, NULL, 12);
+    CHECK(mpool_contains(&pools[0], p));
+    for (int i = 0; i < 12; i++) p[i] = (uint8_t)i;
+    CHECK(mslab_realloc(&slab, p, 16) == p);
+    uint8_t* q = mslab_realloc(&slab, p, 40);  // 搬到大池, 数据保留
+    CHECK(mpool_contains(&pools[1], q) && pools[0].used == 0);
+    for (int i = 0; i < 12; i++) CHECK(q[i] == i);
+    p = mslab_realloc(&slab, q, 8);  // 小池有空闲, 搬回
+    CHECK(mpool_contains(&pools[0], p) && pools[1].used == 0);
+    for (int i = 0; i < 8; i++) CHECK(p[i] == i);
+
+    void* fill[4];
+    for (int i = 0; i < 3; i++) fill[i] = mslab_alloc(&slab, 16);
+    q = mslab_realloc(&slab, p, 40);
+    CHECK(mpool_contains(&pools[1], q));
+    fill[3] = mslab_alloc(&slab, 16);  // 小池已满
+    CHECK(mslab_realloc(&slab, q, 8) == q);  // 没有空闲的小块, 原地返回
+
+    uint8_t* h = mslab_realloc(&slab, q, 200);  // 回退到堆
+    CHECK(h != NULL && slab.fallback == 1 && pools[1].used == 0);
+    for (int i = 0; i < 8; i++) CHECK(h[i] == i);
+    h = mslab_realloc(&slab, h, 8);  // 堆上的内存留在堆上
+    CHECK(h != NULL && !mpool_contains(&pools[1], h));
+    CHECK(pools[1].used == 0);
+    CHECK(mslab_realloc(&slab, h, 0) == NULL);
+    for (int i = 0; i < 4; i++) mslab_free(&slab, fill[i]);
+    CHECK(pools[0].used == 0);
+}
+
+/* 通用分配器接口 */
+static void test_allocator(void) {
+    mpool_t pools[2];
+    mslab_t slab;
+    slab_setup(&slab, pools, 0);
+    const mod_allocator_t* a = mslab_allocator(&slab);
+    void* p = a->alloc(a->ctx, 30);
+    CHECK(mpool_contains(&pools[1], p));
+    p = a->realloc(a->ctx, p, 4);
+    CHECK(mpool_contains(&pools[0], p));
+    a->free(a->ctx, p);
+    CHECK(pools[0].used == 0 && pools[1].used == 0);
+
+    static mpool_t st_pools[2];
+    static mslab_t st = MSLAB_STATIC_INIT(st, st_pools, 0);
+    CHECK(mpool_init(&st_pools[0], m_small, 16, 4));
+    CHECK(mpool_init(&st_pools[1], m_large, 64, 2));
+    a = mslab_allocator(&st);
+    CHECK(st.npool == 2 && a->ctx == &st);
+    p = a->alloc(a->ctx, 16);
+    CHECK(mpool_contains(&st_pools[0], p));
+    a->free(a->ctx, p);
+}
+
+int main(void) {
+    test_pool();
+    test_pool_new();
+    test_slab_alloc();
+    test_slab_realloc();
+    test_allocator();
+    return CHECK_RESULT();
+}
@@ -1,5 +1,21 @@
 #include "scheduler_internal.h"
 
+#if SCH_CFG_USE_MPOOL
+// 控制块与列表数据区的分级内存池, 超出容量时回退到m_alloc
+MPOOL_DEFINE_BUF(sch_pool_32, 32, SCH_CFG_MPOOL_BLOCKS);
+MPOOL_DEFINE_BUF(sch_pool_64, 64, SCH_CFG_MPOOL_BLOCKS);
+MPOOL_DEFINE_BUF(sch_pool_128, 128, SCH_CFG_MPOOL_BLOCKS);
+MPOOL_DEFINE_BUF(sch_pool_256, 256, SCH_CFG_MPOOL_BLOCKS);
+static mpool_t sch_pools[] = {
+    MPOOL_STATIC_INIT(sch_pool_32, 32, SCH_CFG_MPOOL_BLOCKS),
+    MPOOL_STATIC_INIT(sch_pool_64, 64, SCH_CFG_MPOOL_BLOCKS),
+    MPOOL_STATIC_INIT(sch_pool_128, 128, SCH_CFG_MPOOL_BLOCKS),
+    MPOOL_STATIC_INIT(sch_pool_256, 256, SCH_CFG_MPOOL_BLOCKS),
+};
+mslab_t sch_slab = MSLAB_STATIC_INIT(
+    sch_slab, sch_pools, MSLAB_OPT_HEAP_FALLBACK | MSLAB_OPT_MUTEX);
+#endif
+
 #if MOD_CFG_WFI_WHEN_SYSTEM_IDLE && !MOD_CFG_OS_AVAILABLE
 static void SysTick_Sleep(uint32_t us) {
     SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
@@ -57,7 +73,10 @@ uint64_t _INLINE scheduler_run(const uint8_t block) {
             mslp = rslp;
 #endif
 #if SCH_CFG_ENABLE_EVENT
-        event_runner();
+        rslp = event_runner();
+        CHECK(rslp, event);
+        if (rslp < mslp)
+            mslp = rslp;
 #endif
         if (mslp == UINT64_MAX)
             mslp = 1000;  // 没有任何任务
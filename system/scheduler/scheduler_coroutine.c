@@ -3,11 +3,14 @@
 #if SCH_CFG_ENABLE_COROUTINE
 #include "scheduler_internal.h"
 
-typedef struct {          // 协程任务结构
+struct scheduler_cortn {  // 协程任务结构
     ID_NAME_VAR(name);    // 协程名
     cortn_func_t task;    // 任务函数指针
     void* args;           // 协程主函数参数
     __cortn_handle_t hd;  // 协程句柄
+    uint8_t set;          // 所在调度集合(CORTN_SET_*)
+    mod_size_t heapIdx;   // 在睡眠堆中的位置
+    ID_INDEX_HANDLE;      // 名称索引
 #if SCH_CFG_DEBUG_REPORT
     uint64_t max_cost;    // 协程最大执行时间(Tick)
     uint64_t total_cost;  // 协程总执行时间(Tick)
@@ -15,20 +18,26 @@ typedef struct {          // 协程任务结构
     size_t stack_size;    // 协程动态栈大小
     size_t last_stack;    // 协程上一个获取的栈大小
 #endif
-} scheduler_cortn_t;
+};
+
+typedef struct scheduler_cortn scheduler_cortn_t;
 
 typedef struct {        // 协程互斥锁结构
     ID_NAME_VAR(name);  // 锁名
     uint8_t locked;     // 锁状态
-    ulist_t waitlist;   // 等待的协程列表
+    ulist_t waitlist;   // 等待的协程列表(scheduler_cortn_t*)
 } sch_cortneduler_mutex_t;
 
+// 协程指针列表, 协程结构体独立分配, 地址在生命周期内不变
 static ulist_t cortnlist = {.data = NULL,
                             .cap = 0,
                             .num = 0,
                             .elfree = NULL,
-                            .isize = sizeof(scheduler_cortn_t),
-                            .opt = ULIST_OPT_CLEAR_DIRTY_REGION};
+                            .isize = sizeof(scheduler_cortn_t*),
+                            .opt = ULIST_OPT_CLEAR_DIRTY_REGION,
+                            .allocator = SCH_LIST_ALLOCATOR};
+
+static scheduler_cortn_t* cortnindex = NULL;  // 协程名索引
 
 static ulist_t mutexlist = {
     .data = NULL,
@@ -36,124 +45,299 @@ static ulist_t mutexlist = {
     .num = 0,
     .elfree = NULL,
     .isize = sizeof(sch_cortneduler_mutex_t),
-    .opt = ULIST_OPT_CLEAR_DIRTY_REGION | ULIST_OPT_NO_ALLOC_EXTEND};
+    .opt = ULIST_OPT_CLEAR_DIRTY_REGION | ULIST_OPT_NO_ALLOC_EXTEND,
+    .allocator = SCH_LIST_ALLOCATOR};
 
 static __cortn_handle_t* cortn_handle_now = NULL;
 
+#define CORTN_SET_NONE 0   // 正在运行或已结束, 不在任何集合中
+#define CORTN_SET_READY 1  // 就绪列表
+#define CORTN_SET_SLEEP 2  // 睡眠堆
+#define CORTN_SET_AWAIT 3  // 等待集合(由消息/互斥锁直接唤醒)
+
+#define CORTN_SET_OPT \
+    (ULIST_OPT_NO_SHRINK | ULIST_OPT_NO_AUTO_FREE | ULIST_OPT_NO_MUTEX)
+
+// 就绪列表(双缓冲), 一轮调度中新就绪的协程进入另一个列表, 下一轮再执行
+static ulist_t readylist[2] = {
+    {.data = NULL,
+     .cap = 0,
+     .num = 0,
+     .elfree = NULL,
+     .isize = sizeof(scheduler_cortn_t*),
+     .opt = CORTN_SET_OPT,
+     .allocator = SCH_LIST_ALLOCATOR},
+    {.data = NULL,
+     .cap = 0,
+     .num = 0,
+     .elfree = NULL,
+     .isize = sizeof(scheduler_cortn_t*),
+     .opt = CORTN_SET_OPT,
+     .allocator = SCH_LIST_ALLOCATOR},
+};
+static uint8_t ready_sel = 0;      // 当前接收新就绪协程的列表
+static ulist_t* run_list = NULL;  // 正在被遍历执行的就绪列表
+
+// 睡眠堆, 按sleepUntil排列的小顶堆
+static ulist_t sleepheap = {.data = NULL,
+                            .cap = 0,
+                            .num = 0,
+                            .elfree = NULL,
+                            .isize = sizeof(scheduler_cortn_t*),
+                            .opt = CORTN_SET_OPT,
+                            .allocator = SCH_LIST_ALLOCATOR};
+
+#define SLEEP_ARR() ((scheduler_cortn_t**)sleepheap.data)
+#define SLEEP_TOP() (SLEEP_ARR()[0])
+
+_STATIC_INLINE void sleep_place(mod_size_t idx, scheduler_cortn_t* cortn) {
+    SLEEP_ARR()[idx] = cortn;
+    cortn->heapIdx = idx;
+}
+
+static void sleep_sift_up(mod_size_t idx) {
+    scheduler_cortn_t** arr = SLEEP_ARR();
+    scheduler_cortn_t* cortn = arr[idx];
+    while (idx) {
+        mod_size_t parent = (idx - 1) / 2;
+        if (arr[parent]->hd.sleepUntil <= cortn->hd.sleepUntil)
+            break;
+        sleep_place(idx, arr[parent]);
+        idx = parent;
+    }
+    sleep_place(idx, cortn);
+}
+
+static void sleep_sift_down(mod_size_t idx) {
+    scheduler_cortn_t** arr = SLEEP_ARR();
+    mod_size_t num = sleepheap.num;
+    scheduler_cortn_t* cortn = arr[idx];
+    while (1) {
+        mod_size_t child = idx * 2 + 1;
+        if (child >= num)
+            break;
+        if (child + 1 < num &&
+            arr[child + 1]->hd.sleepUntil < arr[child]->hd.sleepUntil)
+            child++;
+        if (cortn->hd.sleepUntil <= arr[child]->hd.sleepUntil)
+            break;
+        sleep_place(idx, arr[child]);
+        idx = child;
+    }
+    sleep_place(idx, cortn);
+}
+
+static void sleep_remove(scheduler_cortn_t* cortn) {
+    mod_size_t idx = cortn->heapIdx;
+    scheduler_cortn_t* last = SLEEP_ARR()[sleepheap.num - 1];
+    ulist_delete(&sleepheap, -1);
+    if (last == cortn)
+        return;
+    sleep_place(idx, last);
+    sleep_sift_up(idx);
+    sleep_sift_down(last->heapIdx);
+}
+
+/**
+ * @brief 确保各调度集合容量足以容纳所有协程, 使调度过程不再申请内存
+ */
+static uint8_t cortn_reserve(mod_size_t num) {
+    ulist_t* lists[] = {&readylist[0], &readylist[1], &sleepheap};
+    for (uint8_t i = 0; i < sizeof(lists) / sizeof(lists[0]); i++) {
+        if (lists[i]->cap >= num)
+            continue;
+        mod_size_t old = lists[i]->num;
+        if (ulist_append_multi(lists[i], num - old) == NULL)
+            return 0;
+        ulist_delete_multi(lists[i], old, num - old);
+    }
+    return 1;
+}
+
+/**
+ * @brief 将协程移出其所在的调度集合
+ */
+static void cortn_unlink(scheduler_cortn_t* cortn) {
+    if (cortn->set == CORTN_SET_SLEEP) {
+        sleep_remove(cortn);
+    } else if (cortn->set == CORTN_SET_READY) {
+        for (uint8_t sel = 0; sel < 2; sel++) {
+            ulist_t* list = &readylist[sel];
+            ulist_foreach(list, scheduler_cortn_t*, cortn_p) {
+                if (*cortn_p != cortn)
+                    continue;
+                if (list == run_list)  // 正在遍历的列表只置空不删除
+                    *cortn_p = NULL;
+                else
+                    ulist_remove(list, cortn_p);
+                break;
+            }
+        }
+    }
+    cortn->set = CORTN_SET_NONE;
+}
+
+/**
+ * @brief 按协程状态放入对应的调度集合
+ * @note 容量已由cortn_reserve预留, 不会失败
+ */
+static void cortn_schedule(scheduler_cortn_t* cortn) {
+    uint8_t set;
+    if (cortn->hd.state == _CR_STATE_SLEEPING)
+        set = CORTN_SET_SLEEP;
+    else if (cortn->hd.state == _CR_STATE_AWAITING)
+        set = CORTN_SET_AWAIT;
+    else
+        set = CORTN_SET_READY;
+    if (cortn->set == set) {
+        if (set == CORTN_SET_SLEEP) {  // 睡眠时间变更
+            sleep_sift_up(cortn->heapIdx);
+            sleep_sift_down(cortn->heapIdx);
+        }
+        return;
+    }
+    cortn_unlink(cortn);
+    cortn->set = set;
+    if (set == CORTN_SET_READY) {
+        ulist_append_copy(&readylist[ready_sel], &cortn);
+    } else if (set == CORTN_SET_SLEEP) {
+        ulist_append_copy(&sleepheap, &cortn);
+        sleep_sift_up(sleepheap.num - 1);
+    }
+}
+
+/**
+ * @brief 唤醒协程(消息/互斥锁), 正在运行的协程在返回后统一调度
+ */
+static void cortn_wakeup(scheduler_cortn_t* cortn) {
+    cortn->hd.state = _CR_STATE_READY;
+    if (cortn_handle_now != &cortn->hd)
+        cortn_schedule(cortn);
+}
+
 _INLINE uint64_t cortn_runner(void) {
     if (!cortnlist.num)
         return UINT64_MAX;
-    uint64_t sleep_us = UINT64_MAX;
     uint64_t now = get_sys_us();
-    ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
-        if (cortn->hd.state == _CR_STATE_STOPPED) {
-            sch_cortn_stop(cortn->name);
-            return 0;  // 指针已被释放
-        } else if (cortn->hd.state == _CR_STATE_READY) {
-            cortn->hd.state = _CR_STATE_RUNNING;  // 就绪态转运行态
-            cortn->hd.sleepUntil = 0;
-        } else if (cortn->hd.state == _CR_STATE_AWAITING) {
-            continue;  // 跳过等待态协程
-        }
+    // 到期的睡眠协程移入就绪列表
+    while (sleepheap.num && now >= SLEEP_TOP()->hd.sleepUntil) {
+        scheduler_cortn_t* cortn = SLEEP_TOP();
+        cortn->hd.state = _CR_STATE_READY;
+        cortn_schedule(cortn);
+    }
+    // 只执行本轮开始时已就绪的协程
+    run_list = &readylist[ready_sel];
+    ready_sel ^= 1;
+    // 按下标遍历, 协程内创建新协程导致列表扩容时仍然安全
+    for (mod_size_t i = 0; i < run_list->num; i++) {
+        scheduler_cortn_t* cortn = ((scheduler_cortn_t**)run_list->data)[i];
+        if (cortn == NULL)  // 已被唤醒到其它集合或已停止
+            continue;
+        cortn->set = CORTN_SET_NONE;
         cortn_handle_now = &cortn->hd;
-        // 检查睡眠态协程或者运行态协程
-        if (cortn_handle_now->state == _CR_STATE_RUNNING ||
-            (cortn_handle_now->state == _CR_STATE_SLEEPING &&
-             now >= cortn_handle_now->sleepUntil)) {
-            cortn_handle_now->runDepth = 0;
-            cortn_handle_now->sleepUntil = 0;
+        cortn_handle_now->state = _CR_STATE_RUNNING;  // 就绪态转运行态
+        cortn_handle_now->runDepth = 0;
+        cortn_handle_now->sleepUntil = 0;
 #if SCH_CFG_DEBUG_REPORT
-            uint64_t _sch_debug_task_tick = get_sys_tick();
-            cortn->task(cortn_handle_now, cortn->args);
-            _sch_debug_task_tick = get_sys_tick() - _sch_debug_task_tick;
-            if (cortn->max_cost < _sch_debug_task_tick)
-                cortn->max_cost = _sch_debug_task_tick;
-            cortn->total_cost += _sch_debug_task_tick;
+        uint64_t _sch_debug_task_tick = get_sys_tick();
+        cortn->task(cortn_handle_now, cortn->args);
+        _sch_debug_task_tick = get_sys_tick() - _sch_debug_task_tick;
+        if (cortn->max_cost < _sch_debug_task_tick)
+            cortn->max_cost = _sch_debug_task_tick;
+        cortn->total_cost += _sch_debug_task_tick;
 #else
-            cortn->task(cortn_handle_now, cortn->args);
+        cortn->task(cortn_handle_now, cortn->args);
 #endif
-            if (cortn_handle_now->data[0].ptr == NULL) {
-                cortn_handle_now->state = _CR_STATE_STOPPED;
-                cortn_handle_now = NULL;
-                sleep_us = 0;
-                continue;  // 协程已结束
-            }
-        }
-        // 计算等待时间
-        if (cortn_handle_now->sleepUntil < now) {
-            sleep_us = 0;  // 直接yield的协程，不休眠
-        } else if (cortn_handle_now->sleepUntil - now < sleep_us) {
-            sleep_us = cortn_handle_now->sleepUntil - now;
-        }
         cortn_handle_now = NULL;
+        if (cortn->hd.data[0].ptr == NULL) {  // 协程已结束
+            cortn->hd.state = _CR_STATE_STOPPED;
+            sch_cortn_stop_h(cortn);
+        } else {
+            cortn_schedule(cortn);
+        }
     }
-    return sleep_us;
-}
-
-uint8_t sch_cortn_run(const char* name, cortn_func_t func, void* args) {
-    scheduler_cortn_t cortn = {
-        .task = func,
-        .args = args,
-        .hd =
-            {
-                .state = _CR_STATE_READY,
-                .runDepth = 0,
-                .actDepth = 0,
-                .sleepUntil = 0,
-                .msg = NULL,
-                .name = name,
-            },
-    };
-    ID_NAME_SET(cortn.name, name);
-    if (!ulist_init(&cortn.hd.dataList, sizeof(__cortn_data_t), 1,
+    ulist_clear(run_list);
+    run_list = NULL;
+    if (readylist[ready_sel].num)
+        return 0;
+    if (!sleepheap.num)
+        return UINT64_MAX;
+    now = get_sys_us();
+    if (SLEEP_TOP()->hd.sleepUntil <= now)
+        return 0;
+    return SLEEP_TOP()->hd.sleepUntil - now;
+}
+
+static scheduler_cortn_t* find_cortn(const char* name) {
+    scheduler_cortn_t* cortn = NULL;
+    if (name != NULL)
+        ID_INDEX_FIND(cortnindex, name, cortn);
+    return cortn;
+}
+
+sch_cortn_handle_t sch_cortn_run(const char* name, cortn_func_t func,
+                                 void* args) {
+    if (!name || !func || find_cortn(name) != NULL)
+        return NULL;
+    scheduler_cortn_t* cortn = sch_alloc(sizeof(scheduler_cortn_t));
+    if (cortn == NULL)
+        return NULL;
+    memset(cortn, 0, sizeof(scheduler_cortn_t));
+    cortn->task = func;
+    cortn->args = args;
+    ID_NAME_SET(cortn->name, name);
+    cortn->hd.state = _CR_STATE_READY;
+    cortn->hd.runDepth = 0;
+    cortn->hd.actDepth = 0;
+    cortn->hd.sleepUntil = 0;
+    cortn->hd.msg = NULL;
+    cortn->hd.name = cortn->name;
+    if (!ulist_init(&cortn->hd.dataList, sizeof(__cortn_data_t), 0,
                     ULIST_OPT_CLEAR_DIRTY_REGION | ULIST_OPT_NO_ALLOC_EXTEND |
                         ULIST_OPT_NO_SHRINK,
                     NULL)) {
-        return 0;
+        sch_free(cortn);
+        return NULL;
     }
-    cortn.hd.data = (__cortn_data_t*)cortn.hd.dataList.data;
-    cortn.hd.data[0].local = NULL;
-    cortn.hd.data[0].ptr = NULL;
-    uint16_t __chd_idx;
-    if (cortn_handle_now != NULL) {  // 列表添加可能会导致旧指针失效
-        __chd_idx =
-            cortn_handle_now - &(((scheduler_cortn_t*)cortnlist.data)->hd);
+    ulist_set_allocator(&cortn->hd.dataList, SCH_LIST_ALLOCATOR);
+    if (ulist_append(&cortn->hd.dataList) == NULL) {
+        ulist_free(&cortn->hd.dataList);
+        sch_free(cortn);
+        return NULL;
     }
-    if (!ulist_append_copy(&cortnlist, &cortn)) {
-        ulist_free(&cortn.hd.dataList);
-        return 0;
+    cortn->hd.data = (__cortn_data_t*)cortn->hd.dataList.data;
+    cortn->hd.data[0].local = NULL;
+    cortn->hd.data[0].ptr = NULL;
+    ID_INDEX_ADD(cortnindex, cortn);
+    if (!ID_INDEX_ADDED(cortn)) {
+        ulist_free(&cortn->hd.dataList);
+        sch_free(cortn);
+        return NULL;
     }
-    if (cortn_handle_now != NULL) {
-        cortn_handle_now =
-            &ulist_get_ptr(&cortnlist, scheduler_cortn_t, __chd_idx)->hd;
+    if (!cortn_reserve(cortnlist.num + 1) ||
+        !ulist_append_copy(&cortnlist, &cortn)) {
+        ID_INDEX_DEL(cortnindex, cortn);
+        ulist_free(&cortn->hd.dataList);
+        sch_free(cortn);
+        return NULL;
     }
-    return 1;
+    cortn_schedule(cortn);
+    return cortn;
 }
 
-static scheduler_cortn_t* find_cortn(const char* name) {
-    if (cortnlist.num == 0)
+_STATIC_INLINE scheduler_cortn_t* find_cortn_by_handle(
+    __cortn_handle_t* handle) {
+    if (handle == NULL)
         return NULL;
-    ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
-        if (fast_strcmp(cortn->name, name)) {
-            return cortn;
-        }
-    }
-    return NULL;
+    return (scheduler_cortn_t*)((uint8_t*)handle -
+                                offsetof(scheduler_cortn_t, hd));
 }
 
-static scheduler_cortn_t* find_cortn_by_handle(__cortn_handle_t* handle) {
-    if (cortnlist.num == 0)
-        return NULL;
-    ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
-        if (&cortn->hd == handle) {
-            return cortn;
-        }
-    }
-    return NULL;
+sch_cortn_handle_t sch_cortn_find(const char* name) {
+    return find_cortn(name);
 }
 
-uint8_t sch_cortn_stop(const char* name) {
-    scheduler_cortn_t* cortn = find_cortn(name);
+uint8_t sch_cortn_stop_h(sch_cortn_handle_t cortn) {
     if (cortn == NULL)
         return 0;
     // 不允许在协程中删除自身
@@ -161,13 +345,32 @@ uint8_t sch_cortn_stop(const char* name) {
         return 0;
     ulist_foreach(&cortn->hd.dataList, __cortn_data_t, data) {
         if (data->local != NULL)
-            m_free(data->local);
+            sch_free(data->local);
     }
     ulist_free(&cortn->hd.dataList);
-    ulist_remove(&cortnlist, cortn);
+    cortn_unlink(cortn);
+    if (cortn->hd.state == _CR_STATE_AWAITING) {  // 从互斥锁等待队列中移除
+        ulist_foreach(&mutexlist, sch_cortneduler_mutex_t, mutex) {
+            mod_offset_t idx = ulist_find(&mutex->waitlist, &cortn);
+            if (idx >= 0)
+                ulist_delete(&mutex->waitlist, idx);
+        }
+    }
+    ulist_foreach(&cortnlist, scheduler_cortn_t*, cortn_p) {
+        if (*cortn_p == cortn) {
+            ulist_remove(&cortnlist, cortn_p);
+            break;
+        }
+    }
+    ID_INDEX_DEL(cortnindex, cortn);
+    sch_free(cortn);
     return 1;
 }
 
+uint8_t sch_cortn_stop(const char* name) {
+    return sch_cortn_stop_h(find_cortn(name));
+}
+
 uint16_t sch_cortn_get_num(void) {
     return cortnlist.num;
 }
@@ -176,8 +379,7 @@ uint8_t sch_cortn_get_running(const char* name) {
     return find_cortn(name) != NULL;
 }
 
-uint8_t sch_cortn_get_waiting_msg(const char* name) {
-    scheduler_cortn_t* cortn = find_cortn(name);
+uint8_t sch_cortn_get_waiting_msg_h(sch_cortn_handle_t cortn) {
     if (cortn == NULL)
         return 0;
     if (cortn->hd.state == _CR_STATE_STOPPED)
@@ -185,18 +387,25 @@ uint8_t sch_cortn_get_waiting_msg(const char* name) {
     return cortn->hd.state == _CR_STATE_AWAITING;
 }
 
-uint8_t sch_cortn_send_msg(const char* name, void* msg) {
-    scheduler_cortn_t* cortn = find_cortn(name);
+uint8_t sch_cortn_get_waiting_msg(const char* name) {
+    return sch_cortn_get_waiting_msg_h(find_cortn(name));
+}
+
+uint8_t sch_cortn_send_msg_h(sch_cortn_handle_t cortn, void* msg) {
     if (cortn == NULL)
         return 0;
     if (cortn->hd.state == _CR_STATE_STOPPED)
         return 0;
     if (msg != NULL)
         cortn->hd.msg = msg;
-    cortn->hd.state = _CR_STATE_READY;
+    cortn_wakeup(cortn);
     return 1;
 }
 
+uint8_t sch_cortn_send_msg(const char* name, void* msg) {
+    return sch_cortn_send_msg_h(find_cortn(name), msg);
+}
+
 /**
  * @brief (内部函数)获取当前协程名
  * @return 协程名
@@ -218,7 +427,7 @@ _INLINE void* __cortn_internal_init_local(size_t size) {
     if (cortn_handle_now->data[cortn_handle_now->runDepth].local == NULL) {
         // 初始化局部变量存储区
         cortn_handle_now->data[cortn_handle_now->runDepth].local =
-            m_alloc(size);
+            sch_alloc(size);
         if (cortn_handle_now->data[cortn_handle_now->runDepth].local == NULL)
             return NULL;
         memset(cortn_handle_now->data[cortn_handle_now->runDepth].local, 0,
@@ -267,7 +476,7 @@ _INLINE uint8_t __cortn_internal_await_return(void) {
     }
     if (cortn_handle_now->data[cortn_handle_now->runDepth + 1].local != NULL) {
         // 释放局部变量存储区
-        m_free(cortn_handle_now->data[cortn_handle_now->runDepth + 1].local);
+        sch_free(cortn_handle_now->data[cortn_handle_now->runDepth + 1].local);
         cortn_handle_now->data[cortn_handle_now->runDepth + 1].local = NULL;
 #if SCH_CFG_DEBUG_REPORT
         scheduler_cortn_t* cortn = find_cortn_by_handle(cortn_handle_now);
@@ -320,7 +529,8 @@ _STATIC_INLINE sch_cortneduler_mutex_t* get_mutex(const char* name) {
         return NULL;
     ID_NAME_SET(ret->name, name);
     ret->locked = 0;
-    ulist_init(&ret->waitlist, sizeof(char*), 0, NULL, NULL);
+    ulist_init(&ret->waitlist, sizeof(scheduler_cortn_t*), 0, NULL, NULL);
+    ulist_set_allocator(&ret->waitlist, SCH_LIST_ALLOCATOR);
     return ret;
 }
 
@@ -334,10 +544,8 @@ _INLINE uint8_t __cortn_internal_acq_mutex(const char* name) {
     if (mutex == NULL)
         return 0;
     if (mutex->locked) {  // 锁已被占用, 添加到等待队列
-        const char** ptr = ulist_append(&mutex->waitlist);
-        if (ptr == NULL)
-            return 0;
-        *ptr = cortn_handle_now->name;
+        scheduler_cortn_t* cortn = find_cortn_by_handle(cortn_handle_now);
+        ulist_append_copy(&mutex->waitlist, &cortn);
         return 0;
     } else {  // 锁未被占用, 直接占用
         mutex->locked = 1;
@@ -350,22 +558,17 @@ _INLINE uint8_t __cortn_internal_acq_mutex(const char* name) {
  * @param  name 锁名
  */
 _INLINE void __cortn_internal_rel_mutex(const char* name) {
-    scheduler_cortn_t* cortn = NULL;
     sch_cortneduler_mutex_t* mutex = get_mutex(name);
     if (mutex == NULL)
         return;
-    do {
-        if (mutex->waitlist.num) {  // 等待队列不为空, 唤醒第一个协程
-            const char** ptr = ulist_get(&mutex->waitlist, 0);
-            cortn = find_cortn(*ptr);
-            if (cortn != NULL)
-                cortn->hd.state = _CR_STATE_READY;
-            ulist_delete(&mutex->waitlist, 0);
-        } else {  // 等待队列为空, 释放锁
-            mutex->locked = 0;
-            cortn = (scheduler_cortn_t*)0x01;
-        }
-    } while (cortn == NULL);
+    if (mutex->waitlist.num) {  // 等待队列不为空, 锁直接交给第一个协程
+        scheduler_cortn_t* cortn =
+            *ulist_get_ptr(&mutex->waitlist, scheduler_cortn_t*, 0);
+        ulist_delete(&mutex->waitlist, 0);
+        cortn_wakeup(cortn);
+    } else {  // 等待队列为空, 释放锁
+        mutex->locked = 0;
+    }
 }
 
 static const char* get_cortn_state_str(uint8_t state) {
@@ -403,7 +606,8 @@ void sch_cortn_add_debug(TT tt, uint64_t period, uint64_t* other) {
         for (int i = 0; i < sizeof(head3) / sizeof(char*); i++)
             TT_GridLine_AddItem(line, TT_Str(al, f1, f2, head3[i]));
         int i = 0;
-        ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
+        ulist_foreach(&cortnlist, scheduler_cortn_t*, cortn_p) {
+            scheduler_cortn_t* cortn = *cortn_p;
             if (i >= SCH_CFG_DEBUG_MAXLINE) {
                 TT_AddString(
                     tt,
@@ -448,7 +652,8 @@ void sch_cortn_add_debug(TT tt, uint64_t period, uint64_t* other) {
 }
 
 void sch_cortn_finish_debug(uint8_t first_print, uint64_t offset) {
-    ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
+    ulist_foreach(&cortnlist, scheduler_cortn_t*, cortn_p) {
+        scheduler_cortn_t* cortn = *cortn_p;
         cortn->max_cost = 0;
         cortn->total_cost = 0;
     }
@@ -467,12 +672,14 @@ void cortn_cmd_func(EmbeddedCli* cli, char* args, void* context) {
             T_FMT(T_BOLD, T_GREEN) "Coroutines list:" T_FMT(T_RESET, T_GREEN));
         uint16_t max_len = 0;
         uint16_t temp;
-        ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
+        ulist_foreach(&cortnlist, scheduler_cortn_t*, cortn_p) {
+            scheduler_cortn_t* cortn = *cortn_p;
             temp = strlen(cortn->name);
             if (temp > max_len)
                 max_len = temp;
         }
-        ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
+        ulist_foreach(&cortnlist, scheduler_cortn_t*, cortn_p) {
+            scheduler_cortn_t* cortn = *cortn_p;
             PRINTLN("  %-*s | entry:%p depth:%d state:%s", max_len, cortn->name,
                     cortn->task, cortn->hd.actDepth,
                     get_cortn_state_str(cortn->hd.state));
@@ -486,13 +693,7 @@ void cortn_cmd_func(EmbeddedCli* cli, char* args, void* context) {
         return;
     }
     const char* name = embeddedCliGetToken(args, 2);
-    scheduler_cortn_t* p = NULL;
-    ulist_foreach(&cortnlist, scheduler_cortn_t, cortn) {
-        if (fast_strcmp(cortn->name, name)) {
-            p = cortn;
-            break;
-        }
-    }
+    scheduler_cortn_t* p = find_cortn(name);
     if (p == NULL) {
         PRINTLN(T_FMT(T_BOLD, T_RED) "Coroutine: %s not found" T_RST, name);
         return;
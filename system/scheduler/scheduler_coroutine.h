@@ -9,6 +9,9 @@ extern "C" {
 
 typedef void (*cortn_func_t)(__async__, void* args);  // 协程函数指针类型
 
+// 协程句柄类型, 在协程结束前一直有效
+typedef struct scheduler_cortn* sch_cortn_handle_t;
+
 /**
  * @brief 初始化协程
  */
@@ -88,7 +91,8 @@ typedef void (*cortn_func_t)(__async__, void* args);  // 协程函数指针类
 /**
  * @brief 等待消息并将消息指针赋值给指定变量
  */
-#define CR_RECV_MSG(to_ptr) __CR(__Internal_AwaitMsg, (void**)&(to_ptr))
+#define CR_RECV_MSG(to_ptr) \
+    __CR_AWAIT(__cortn_internal_await_msg, (void**)&(to_ptr))
 
 /**
  * @brief 发送消息给指定协程, 立即返回
@@ -110,9 +114,17 @@ typedef void (*cortn_func_t)(__async__, void* args);  // 协程函数指针类
  * @param  name             协程名
  * @param  func             任务函数指针
  * @param  args             任务参数
- * @retval uint8_t          是否成功
+ * @retval sch_cortn_handle_t 协程句柄(NULL: 失败)
+ */
+extern sch_cortn_handle_t sch_cortn_run(const char* name, cortn_func_t func,
+                                        void* args);
+
+/**
+ * @brief 根据协程名获取协程句柄
+ * @param  name             协程名
+ * @retval sch_cortn_handle_t 协程句柄(NULL: 协程不存在)
  */
-extern uint8_t sch_cortn_run(const char* name, cortn_func_t func, void* args);
+extern sch_cortn_handle_t sch_cortn_find(const char* name);
 
 /**
  * @brief 停止一个协程
@@ -148,6 +160,15 @@ extern uint8_t sch_cortn_get_waiting_msg(const char* name);
  */
 extern uint8_t sch_cortn_send_msg(const char* name, void* msg);
 
+/**
+ * 以下为基于句柄的接口, 与同名接口功能相同, 省去按名称查找的开销
+ * @warning 协程结束(或被停止)后句柄失效, 不可继续使用
+ */
+
+extern uint8_t sch_cortn_stop_h(sch_cortn_handle_t cortn);
+extern uint8_t sch_cortn_get_waiting_msg_h(sch_cortn_handle_t cortn);
+extern uint8_t sch_cortn_send_msg_h(sch_cortn_handle_t cortn, void* msg);
+
 #endif  // SCH_CFG_ENABLE_COROUTINE
 #ifdef __cplusplus
 }
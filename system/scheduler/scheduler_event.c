@@ -2,10 +2,11 @@
 
 #include "scheduler_internal.h"
 #if SCH_CFG_ENABLE_EVENT
-typedef struct {            // 事件结构
+struct scheduler_event {    // 事件结构
     ID_NAME_VAR(name);      // 事件名
     sch_event_func_t task;  // 事件回调函数指针
     uint8_t enable;         // 是否使能
+    ID_INDEX_HANDLE;        // 名称索引
 #if SCH_CFG_DEBUG_REPORT
     uint64_t max_cost;     // 事件最大执行时间(Tick)
     uint64_t total_cost;   // 事件总执行时间(Tick)
@@ -15,24 +16,29 @@ typedef struct {            // 事件结构
     uint32_t trigger_cnt;  // 触发次数
     float last_usage;      // 事件上次执行占用率
 #endif
-} scheduler_event_t;
+};
 
-typedef struct {            // 事件触发结构
-    sch_event_func_t task;  // 事件回调函数指针
-    sch_event_arg_t arg;    // 事件参数
-    uint8_t allocated;      // 动态分配的参数内存
+typedef struct scheduler_event scheduler_event_t;
+
+typedef struct {               // 事件触发结构
+    scheduler_event_t* event;  // 源事件指针(NULL: 事件已删除)
+    sch_event_arg_t arg;       // 事件参数
+    uint8_t allocated;         // 动态分配的参数内存
 #if SCH_CFG_DEBUG_REPORT
-    uint64_t trigger_time;     // 触发时间(Tick)
-    scheduler_event_t* event;  // 源事件指针
+    uint64_t trigger_time;  // 触发时间(Tick)
 #endif
 } scheduler_triggered_event_t;
 
+// 事件指针列表, 事件结构体独立分配, 地址在生命周期内不变
 static ulist_t eventlist = {.data = NULL,
                             .cap = 0,
                             .num = 0,
                             .elfree = NULL,
-                            .isize = sizeof(scheduler_event_t),
-                            .opt = ULIST_OPT_CLEAR_DIRTY_REGION};
+                            .isize = sizeof(scheduler_event_t*),
+                            .opt = ULIST_OPT_CLEAR_DIRTY_REGION,
+                            .allocator = SCH_LIST_ALLOCATOR};
+
+static scheduler_event_t* eventindex = NULL;  // 事件名索引
 
 static ulist_t triggered_eventlist = {
     .data = NULL,
@@ -40,29 +46,62 @@ static ulist_t triggered_eventlist = {
     .num = 0,
     .elfree = NULL,
     .isize = sizeof(scheduler_triggered_event_t),
-    .opt = ULIST_OPT_NO_SHRINK};
+    .opt = ULIST_OPT_NO_SHRINK,
+    .allocator = SCH_LIST_ALLOCATOR};
 
-_INLINE void event_runner(void) {
-    static uint64_t last_event_us = 0;
-    if (!triggered_eventlist.num) {
-        if (triggered_eventlist.cap &&
-            get_sys_us() - last_event_us >
-                10000000) {  // 10s无事件触发，释放内存
-            ulist_mem_shrink(&triggered_eventlist, 1);
-        }
-        return;
-    }
-    uint16_t cnt = 0;
-    ulist_foreach(&triggered_eventlist, scheduler_triggered_event_t,
-                  triggered) {
+#if SCH_CFG_EVENT_ISR_QUEUE
+#if SCH_CFG_EVENT_ISR_QUEUE & (SCH_CFG_EVENT_ISR_QUEUE - 1)
+#error "SCH_CFG_EVENT_ISR_QUEUE must be a power of 2"
+#endif
+#if !MOD_CFG_ENABLE_ATOMIC  // 读写索引依赖acquire/release顺序
+#error "SCH_CFG_EVENT_ISR_QUEUE requires MOD_CFG_ENABLE_ATOMIC"
+#endif
+
+typedef struct {               // 中断触发结构
+    scheduler_event_t* event;  // 源事件指针(NULL: 事件已删除)
+    union {
+        uint8_t data[SCH_CFG_EVENT_ISR_ARG_SIZE];  // 内联参数副本
+        void* ptr;                                 // 原样传递的参数指针
+        uint64_t _align;
+    } arg;
+    uint8_t type;  // 事件参数类型
+    uint8_t size;  // 内联参数大小(0: 使用arg.ptr)
+#if SCH_CFG_DEBUG_REPORT
+    uint64_t trigger_time;  // 触发时间(Tick)
+#endif
+} scheduler_isr_event_t;
+
+// 单生产者单消费者无锁环形队列, 中断写入, event_runner读出
+static scheduler_isr_event_t isr_queue[SCH_CFG_EVENT_ISR_QUEUE];
+static mod_atomic_size_t isr_w = 0;  // 写索引(自由增长, 仅生产者修改)
+static mod_atomic_size_t isr_r = 0;  // 读索引(自由增长, 仅消费者修改)
+#define ISR_QUEUE_MASK (SCH_CFG_EVENT_ISR_QUEUE - 1)
+#endif  // SCH_CFG_EVENT_ISR_QUEUE
+
+#if SCH_CFG_DEBUG_REPORT
+// 事件删除计数, 回调前后不变说明回调中没有删除任何事件
+static uint32_t event_delete_gen = 0;
+#endif
+
+/**
+ * @brief 执行事件回调并统计
+ * @param  event            事件指针
+ * @param  arg              事件参数
+ * @param  trigger_time     触发时间(Tick)
+ * @note 回调中可能删除事件或触发新事件, 回调返回后不再访问触发记录
+ */
+_STATIC_INLINE void run_event(scheduler_event_t* event, sch_event_arg_t arg,
+                              uint64_t trigger_time) {
 #if !SCH_CFG_DEBUG_REPORT
-        triggered->task(triggered->arg);
+    (void)trigger_time;
+    event->task(arg);
 #else
-        scheduler_event_t* event = triggered->event;
-        uint64_t now = get_sys_tick();
-        uint64_t _late = now - triggered->trigger_time;
-        triggered->task(triggered->arg);
-        now = get_sys_tick() - now;
+    uint32_t gen = event_delete_gen;
+    uint64_t now = get_sys_tick();
+    uint64_t _late = now - trigger_time;
+    event->task(arg);
+    now = get_sys_tick() - now;
+    if (gen == event_delete_gen) {  // 事件仍然存在
         if (event->max_cost < now)
             event->max_cost = now;
         event->total_cost += now;
@@ -70,66 +109,168 @@ _INLINE void event_runner(void) {
             event->max_lat = _late;
         event->total_lat += _late;
         event->run_cnt++;
-#endif  // !SCH_CFG_DEBUG_REPORT
-        if (triggered->allocated)
-            m_free(triggered->arg.ptr);
-        cnt++;
     }
-    ulist_delete_multi(&triggered_eventlist, 0, cnt);
-    last_event_us = get_sys_us();
+#endif  // !SCH_CFG_DEBUG_REPORT
 }
 
-uint8_t sch_event_create(const char* name, sch_event_func_t callback,
-                         uint8_t enable) {
-    if (!name || !callback)
+#if SCH_CFG_EVENT_ISR_QUEUE
+/**
+ * @brief 批量处理中断触发队列
+ * @retval uint8_t          处理期间是否有新的触发入队
+ * @note 每次只处理进入时已入队的记录, 槽位在整批处理完后统一释放
+ */
+_STATIC_INLINE uint8_t isr_event_runner(void) {
+    mod_size_t r = MOD_ATOMIC_LOAD(isr_r, MOD_ATOMIC_ORDER_RELAXED);
+    mod_size_t w = MOD_ATOMIC_LOAD(isr_w, MOD_ATOMIC_ORDER_ACQUIRE);
+    if (r == w)
         return 0;
-    ulist_foreach(&eventlist, scheduler_event_t, event) {
-        if (fast_strcmp(event->name, name))
-            return 0;
+    for (; r != w; r++) {
+        scheduler_isr_event_t* triggered = &isr_queue[r & ISR_QUEUE_MASK];
+        if (triggered->event == NULL)  // 事件已删除时跳过
+            continue;
+        sch_event_arg_t arg = {
+            .type = triggered->type,
+            .ptr = triggered->size ? triggered->arg.data : triggered->arg.ptr,
+            .size = triggered->size};
+#if SCH_CFG_DEBUG_REPORT
+        triggered->event->trigger_cnt++;  // 在任务上下文中计数
+        run_event(triggered->event, arg, triggered->trigger_time);
+#else
+        run_event(triggered->event, arg, 0);
+#endif
     }
-    scheduler_event_t event = {
-        .task = callback,
-        .enable = enable,
-    };
-    ID_NAME_SET(event.name, name);
-    return ulist_append_copy(&eventlist, &event);
+    MOD_ATOMIC_STORE(isr_r, r, MOD_ATOMIC_ORDER_RELEASE);
+    return r != MOD_ATOMIC_LOAD(isr_w, MOD_ATOMIC_ORDER_RELAXED);
+}
+#endif  // SCH_CFG_EVENT_ISR_QUEUE
+
+_INLINE uint64_t event_runner(void) {
+    static uint64_t last_event_us = 0;
+    uint64_t sleep_us = UINT64_MAX;
+#if SCH_CFG_EVENT_ISR_QUEUE
+    if (isr_event_runner())
+        sleep_us = 0;  // 队列中仍有待处理的触发, 不进入空闲
+#endif
+    if (!triggered_eventlist.num) {
+        if (triggered_eventlist.cap &&
+            get_sys_us() - last_event_us >
+                10000000) {  // 10s无事件触发，释放内存
+            ulist_mem_shrink(&triggered_eventlist, 1);
+        }
+        return sleep_us;
+    }
+    // 回调中新触发的事件留到下一轮处理
+    mod_size_t cnt = triggered_eventlist.num;
+    for (mod_size_t i = 0; i < cnt; i++) {
+        // 回调中触发事件可能使列表重新分配, 每次按索引取出记录的副本
+        scheduler_triggered_event_t triggered = *ulist_get_ptr(
+            &triggered_eventlist, scheduler_triggered_event_t, i);
+        if (triggered.event != NULL) {  // 事件已删除时跳过
+#if SCH_CFG_DEBUG_REPORT
+            run_event(triggered.event, triggered.arg, triggered.trigger_time);
+#else
+            run_event(triggered.event, triggered.arg, 0);
+#endif
+        }
+        if (triggered.allocated)
+            sch_free(triggered.arg.ptr);
+    }
+    ulist_delete_multi(&triggered_eventlist, 0, cnt);
+    last_event_us = get_sys_us();
+    return sleep_us;
 }
 
 __STATIC_INLINE scheduler_event_t* find_event(const char* name) {
-    if (eventlist.num == 0)
+    scheduler_event_t* event = NULL;
+    if (name != NULL)
+        ID_INDEX_FIND(eventindex, name, event);
+    return event;
+}
+
+sch_event_handle_t sch_event_create(const char* name,
+                                    sch_event_func_t callback,
+                                    uint8_t enable) {
+    if (!name || !callback)
+        return NULL;
+    if (find_event(name) != NULL)
+        return NULL;
+    scheduler_event_t* event = sch_alloc(sizeof(scheduler_event_t));
+    if (event == NULL)
+        return NULL;
+    memset(event, 0, sizeof(scheduler_event_t));
+    event->task = callback;
+    event->enable = enable;
+    ID_NAME_SET(event->name, name);
+    ID_INDEX_ADD(eventindex, event);
+    if (!ID_INDEX_ADDED(event)) {
+        sch_free(event);
         return NULL;
-    ulist_foreach(&eventlist, scheduler_event_t, event) {
-        if (fast_strcmp(event->name, name)) {
-            return event;
-        }
     }
-    return NULL;
+    if (!ulist_append_copy(&eventlist, &event)) {
+        ID_INDEX_DEL(eventindex, event);
+        sch_free(event);
+        return NULL;
+    }
+    return event;
 }
 
-uint8_t sch_event_delete(const char* name) {
-    scheduler_event_t* event = find_event(name);
+sch_event_handle_t sch_event_find(const char* name) {
+    return find_event(name);
+}
+
+uint8_t sch_event_delete_h(sch_event_handle_t event) {
     if (event == NULL)
         return 0;
-    ulist_remove(&eventlist, event);
+    // 已触发但未执行的回调不再执行
+    ulist_foreach(&triggered_eventlist, scheduler_triggered_event_t,
+                  triggered) {
+        if (triggered->event == event)
+            triggered->event = NULL;
+    }
+#if SCH_CFG_EVENT_ISR_QUEUE
+    mod_size_t w = MOD_ATOMIC_LOAD(isr_w, MOD_ATOMIC_ORDER_ACQUIRE);
+    for (mod_size_t r = MOD_ATOMIC_LOAD(isr_r, MOD_ATOMIC_ORDER_RELAXED);
+         r != w; r++) {
+        if (isr_queue[r & ISR_QUEUE_MASK].event == event)
+            isr_queue[r & ISR_QUEUE_MASK].event = NULL;
+    }
+#endif
+    ulist_foreach(&eventlist, scheduler_event_t*, event_p) {
+        if (*event_p == event) {
+            ulist_remove(&eventlist, event_p);
+            break;
+        }
+    }
+    ID_INDEX_DEL(eventindex, event);
+    sch_free(event);
+#if SCH_CFG_DEBUG_REPORT
+    event_delete_gen++;
+#endif
     return 1;
 }
 
-uint8_t sch_event_set_enabled(const char* name, uint8_t enable) {
-    scheduler_event_t* event = find_event(name);
+uint8_t sch_event_delete(const char* name) {
+    return sch_event_delete_h(find_event(name));
+}
+
+uint8_t sch_event_set_enabled_h(sch_event_handle_t event, uint8_t enable) {
     if (event == NULL)
         return 0;
     event->enable = enable;
     return 1;
 }
 
-uint8_t sch_event_trigger(const char* name, uint8_t arg_type, void* arg_ptr,
-                          size_t arg_size) {
-    scheduler_event_t* event = find_event(name);
+uint8_t sch_event_set_enabled(const char* name, uint8_t enable) {
+    return sch_event_set_enabled_h(find_event(name), enable);
+}
+
+uint8_t sch_event_trigger_h(sch_event_handle_t event, uint8_t arg_type,
+                            void* arg_ptr, size_t arg_size) {
     if (event == NULL)
         return 0;
     if (!event->enable)
         return 0;
-    scheduler_triggered_event_t triggered = {.task = event->task,
+    scheduler_triggered_event_t triggered = {.event = event,
                                              .arg =
                                                  {
                                                      .type = arg_type,
@@ -139,50 +280,89 @@ uint8_t sch_event_trigger(const char* name, uint8_t arg_type, void* arg_ptr,
                                              .allocated = 0};
 #if SCH_CFG_DEBUG_REPORT
     triggered.trigger_time = get_sys_tick();
-    triggered.event = event;
     event->trigger_cnt++;
 #endif
     return ulist_append_copy(&triggered_eventlist, &triggered);
+}
+
+#if SCH_CFG_EVENT_ISR_QUEUE
+uint8_t sch_event_trigger_isr(sch_event_handle_t event, uint8_t arg_type,
+                              const void* arg_ptr, size_t arg_size) {
+    if (event == NULL)
+        return 0;
+    if (!event->enable)
+        return 0;
+    if (arg_size > SCH_CFG_EVENT_ISR_ARG_SIZE)
+        return 0;
+    mod_size_t w = MOD_ATOMIC_LOAD(isr_w, MOD_ATOMIC_ORDER_RELAXED);
+    mod_size_t r = MOD_ATOMIC_LOAD(isr_r, MOD_ATOMIC_ORDER_ACQUIRE);
+    if (w - r >= SCH_CFG_EVENT_ISR_QUEUE)  // 队列已满
+        return 0;
+    scheduler_isr_event_t* triggered = &isr_queue[w & ISR_QUEUE_MASK];
+    triggered->event = event;
+    triggered->type = arg_type;
+    triggered->size = arg_size;
+    if (arg_size)
+        memcpy(triggered->arg.data, arg_ptr, arg_size);
+    else
+        triggered->arg.ptr = (void*)arg_ptr;
+#if SCH_CFG_DEBUG_REPORT
+    triggered->trigger_time = get_sys_tick();
+#endif
+    MOD_ATOMIC_STORE(isr_w, w + 1, MOD_ATOMIC_ORDER_RELEASE);
     return 1;
 }
+#endif  // SCH_CFG_EVENT_ISR_QUEUE
 
-uint8_t sch_event_trigger_ex(const char* name, uint8_t arg_type,
-                             const void* arg_ptr, size_t arg_size) {
-    scheduler_event_t* event = find_event(name);
+uint8_t sch_event_trigger(const char* name, uint8_t arg_type, void* arg_ptr,
+                          size_t arg_size) {
+    return sch_event_trigger_h(find_event(name), arg_type, arg_ptr, arg_size);
+}
+
+uint8_t sch_event_trigger_ex_h(sch_event_handle_t event, uint8_t arg_type,
+                               const void* arg_ptr, size_t arg_size) {
     if (event == NULL)
         return 0;
     if (!event->enable)
         return 0;
-    void* args = m_alloc(arg_size);
+    void* args = sch_alloc(arg_size);
     if (args == NULL)
         return 0;
     memcpy(args, arg_ptr, arg_size);
     scheduler_triggered_event_t triggered = {
-        .task = event->task,
+        .event = event,
         .arg = {.type = arg_type, .ptr = args, .size = arg_size},
         .allocated = 1};
 #if SCH_CFG_DEBUG_REPORT
     triggered.trigger_time = get_sys_tick();
-    triggered.event = event;
     event->trigger_cnt++;
 #endif
     uint8_t ret = ulist_append_copy(&triggered_eventlist, &triggered);
     if (!ret)
-        m_free(args);
+        sch_free(args);
     return ret;
 }
 
+uint8_t sch_event_trigger_ex(const char* name, uint8_t arg_type,
+                             const void* arg_ptr, size_t arg_size) {
+    return sch_event_trigger_ex_h(find_event(name), arg_type, arg_ptr,
+                                  arg_size);
+}
+
 uint8_t sch_event_get_exist(const char* name) {
     return find_event(name) == NULL ? 0 : 1;
 }
 
-uint8_t sch_event_get_enabled(const char* name) {
-    scheduler_event_t* event = find_event(name);
+uint8_t sch_event_get_enabled_h(sch_event_handle_t event) {
     if (event == NULL)
         return 0;
     return event->enable;
 }
 
+uint8_t sch_event_get_enabled(const char* name) {
+    return sch_event_get_enabled_h(find_event(name));
+}
+
 uint16_t sch_event_get_num(void) {
     return eventlist.num;
 }
@@ -205,7 +385,8 @@ void sch_event_add_debug(TT tt, uint64_t period, uint64_t* other) {
         for (int i = 0; i < sizeof(head2) / sizeof(char*); i++)
             TT_GridLine_AddItem(line, TT_Str(al, f1, f2, head2[i]));
         int i = 0;
-        ulist_foreach(&eventlist, scheduler_event_t, event) {
+        ulist_foreach(&eventlist, scheduler_event_t*, event_p) {
+            scheduler_event_t* event = *event_p;
             if (i >= SCH_CFG_DEBUG_MAXLINE) {
                 TT_AddString(
                     tt,
@@ -278,7 +459,8 @@ void sch_event_add_debug(TT tt, uint64_t period, uint64_t* other) {
 }
 
 void sch_event_finish_debug(uint8_t first_print, uint64_t offset) {
-    ulist_foreach(&eventlist, scheduler_event_t, event) {
+    ulist_foreach(&eventlist, scheduler_event_t*, event_p) {
+        scheduler_event_t* event = *event_p;
         event->max_cost = 0;
         event->total_cost = 0;
         event->run_cnt = 0;
@@ -300,12 +482,14 @@ void event_cmd_func(EmbeddedCli* cli, char* args, void* context) {
         PRINTLN(T_FMT(T_BOLD, T_GREEN) "events list:" T_FMT(T_RESET, T_GREEN));
         uint16_t max_len = 0;
         uint16_t temp;
-        ulist_foreach(&eventlist, scheduler_event_t, event) {
+        ulist_foreach(&eventlist, scheduler_event_t*, event_p) {
+            scheduler_event_t* event = *event_p;
             temp = strlen(event->name);
             if (temp > max_len)
                 max_len = temp;
         }
-        ulist_foreach(&eventlist, scheduler_event_t, event) {
+        ulist_foreach(&eventlist, scheduler_event_t*, event_p) {
+            scheduler_event_t* event = *event_p;
             PRINTLN("  %-*s | entry:%p en:%d", max_len, event->name,
                     event->task, event->enable);
         }
@@ -317,13 +501,7 @@ void event_cmd_func(EmbeddedCli* cli, char* args, void* context) {
         return;
     }
     const char* name = embeddedCliGetToken(args, 2);
-    scheduler_event_t* p = NULL;
-    ulist_foreach(&eventlist, scheduler_event_t, event) {
-        if (fast_strcmp(event->name, name)) {
-            p = event;
-            break;
-        }
-    }
+    scheduler_event_t* p = find_event(name);
     if (p == NULL) {
         PRINTLN(T_FMT(T_BOLD, T_RED) "event: %s not found" T_RST, name);
         return;
@@ -15,16 +15,28 @@ typedef struct {
 // 事件回调函数指针类型
 typedef void (*sch_event_func_t)(sch_event_arg_t arg);
 
+// 事件句柄类型, 在事件删除前一直有效
+typedef struct scheduler_event* sch_event_handle_t;
+
 /**
  * @brief 创建一个事件
  * @param  name             事件名
  * @param  callback         事件回调函数指针
  * @param  enable           初始化时是否使能
- * @retval uint8_t          是否成功huidi
+ * @retval sch_event_handle_t 事件句柄(NULL: 失败或事件名已存在)
  * @warning 事件回调是异步执行的, 由调度器自动调用
  */
-extern uint8_t sch_event_create(const char* name, sch_event_func_t callback,
-                                uint8_t enable);
+extern sch_event_handle_t sch_event_create(const char* name,
+                                           sch_event_func_t callback,
+                                           uint8_t enable);
+
+/**
+ * @brief 根据事件名获取事件句柄
+ * @param  name             事件名
+ * @retval sch_event_handle_t 事件句柄(NULL: 事件不存在)
+ * @note 名称查找基于哈希索引, 频繁触发的场合仍建议缓存句柄
+ */
+extern sch_event_handle_t sch_event_find(const char* name);
 
 /**
  * @brief 删除一个事件
@@ -69,6 +81,24 @@ extern uint8_t sch_event_trigger(const char* name, uint8_t arg_type,
 extern uint8_t sch_event_trigger_ex(const char* name, uint8_t arg_type,
                                     const void* arg_ptr, size_t arg_size);
 
+#if SCH_CFG_EVENT_ISR_QUEUE
+/**
+ * @brief 在中断中触发一个事件, 参数拷贝至固定容量的无锁队列
+ * @param  event            事件句柄
+ * @param  arg_type         参数类型
+ * @param  arg_ptr          参数指针
+ * @param  arg_size         参数大小(0: 不拷贝, 直接传递arg_ptr)
+ * @retval uint8_t          是否成功(事件禁用, 参数超长或队列已满)
+ * @note 不分配内存, 队列容量由SCH_CFG_EVENT_ISR_QUEUE决定, 需要MOD_CFG_ENABLE_ATOMIC
+ * @note 回调中arg.ptr指向队列内的副本, 仅在回调执行期间有效
+ * @warning 队列为单生产者: 多个中断调用时须保证它们不会互相抢占(如同一优先级)
+ * @warning 中断触发的事件与sch_event_trigger触发的事件之间不保证先后顺序
+ */
+extern uint8_t sch_event_trigger_isr(sch_event_handle_t event,
+                                     uint8_t arg_type, const void* arg_ptr,
+                                     size_t arg_size);
+#endif  // SCH_CFG_EVENT_ISR_QUEUE
+
 /**
  * @brief 获取调度器内事件数量
  */
@@ -80,6 +110,21 @@ extern uint16_t sch_event_get_num(void);
  * @retval uint8_t             事件是否存在
  */
 extern uint8_t sch_event_get_exist(const char* name);
+
+/**
+ * 以下为基于句柄的接口, 与同名接口功能相同, 省去按名称查找的开销
+ * @warning 事件删除后句柄失效, 不可继续使用
+ */
+
+extern uint8_t sch_event_delete_h(sch_event_handle_t event);
+extern uint8_t sch_event_set_enabled_h(sch_event_handle_t event,
+                                       uint8_t enable);
+extern uint8_t sch_event_get_enabled_h(sch_event_handle_t event);
+extern uint8_t sch_event_trigger_h(sch_event_handle_t event, uint8_t arg_type,
+                                   void* arg_ptr, size_t arg_size);
+extern uint8_t sch_event_trigger_ex_h(sch_event_handle_t event,
+                                      uint8_t arg_type, const void* arg_ptr,
+                                      size_t arg_size);
 #endif  // SCH_CFG_ENABLE_EVENT
 #ifdef __cplusplus
 }
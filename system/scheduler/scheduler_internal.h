@@ -10,6 +10,10 @@ extern "C" {
 #include "scheduler.h"
 #include "ulist.h"
 
+// 名称索引申请内存失败时不终止程序, 由ID_INDEX_ADDED判断是否已加入索引
+#define HASH_NONFATAL_OOM 1
+#include "uthash.h"
+
 #define _INLINE __attribute__((always_inline)) inline
 #define _STATIC_INLINE static _INLINE
 
@@ -108,8 +112,29 @@ _STATIC_INLINE uint8_t fast_strcmp(const char* str1, const char* str2) {
 #define ID_NAME_SET(name, str) name = str
 #endif
 
+// 基于名称的哈希索引(uthash), 供按名称查找对象使用
+#define ID_INDEX_HANDLE UT_hash_handle hh
+#define ID_INDEX_ADD(head, item) \
+    HASH_ADD_KEYPTR(hh, head, (item)->name, strlen((item)->name), item)
+#define ID_INDEX_ADDED(item) ((item)->hh.tbl != NULL)
+#define ID_INDEX_DEL(head, item) HASH_DEL(head, item)
+#define ID_INDEX_FIND(head, str, out) HASH_FIND_STR(head, str, out)
+
+// 控制块与列表数据区的分配方式
+#if SCH_CFG_USE_MPOOL
+#include "mpool.h"
+extern mslab_t sch_slab;
+#define sch_alloc(size) mslab_alloc(&sch_slab, (size))
+#define sch_free(ptr) mslab_free(&sch_slab, (ptr))
+#define SCH_LIST_ALLOCATOR (&sch_slab.allocator)
+#else
+#define sch_alloc(size) m_alloc(size)
+#define sch_free(ptr) m_free(ptr)
+#define SCH_LIST_ALLOCATOR NULL
+#endif
+
 //////// 子模块的运行函数 ////////
-extern void event_runner(void);
+extern uint64_t event_runner(void);
 extern void soft_int_runner(void);
 extern uint64_t task_runner(void);
 extern uint64_t cortn_runner(void);
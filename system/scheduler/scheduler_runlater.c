@@ -15,15 +15,20 @@ typedef void (*cl_func_noarg_t)(void);
 typedef struct {         // 延时调用任务结构
     void* task;          // 任务函数指针
     uint64_t runTimeUs;  // 执行时间(us)
-    cl_arg_t* args;      // 参数区
+    uint8_t argc;        // 参数区已用个数(0: 无参数)
+    cl_arg_t args[SCH_CFG_CALLLATER_MAX_ARG];  // 参数区(随任务内联存储)
 } scheduler_runlater_t;
 
+// 按执行时间降序排列, 最早到期的任务位于列表尾部, 出队无需移动数据
 static ulist_t clist = {.data = NULL,
                         .cap = 0,
                         .num = 0,
                         .elfree = NULL,
                         .isize = sizeof(scheduler_runlater_t),
-                        .opt = ULIST_OPT_NO_SHRINK};
+                        .opt = ULIST_OPT_NO_SHRINK,
+                        .allocator = SCH_LIST_ALLOCATOR};
+
+#define CL_LAST() ulist_get_ptr(&clist, scheduler_runlater_t, -1)
 
 _INLINE uint64_t runlater_runner(void) {
     static uint64_t last_active_us = 0;
@@ -34,28 +39,44 @@ _INLINE uint64_t runlater_runner(void) {
         }
         return UINT64_MAX;
     }
-    uint64_t sleep_us = UINT64_MAX;
     uint64_t now = get_sys_us();
     last_active_us = now;
-    ulist_foreach(&clist, scheduler_runlater_t, callLater_p) {
-        if (now >= callLater_p->runTimeUs) {
-            if (callLater_p->args != NULL) {
-                ((cl_func_arg_t)callLater_p->task)(
+    if (now < CL_LAST()->runTimeUs)
+        return CL_LAST()->runTimeUs - now;
+    // 一次取出全部到期任务, 次数以进入时的任务数为上限,
+    // 避免回调中以0延时重新添加自身导致死循环
+    mod_size_t limit = clist.num;
+    while (limit-- && clist.num && now >= CL_LAST()->runTimeUs) {
+        // 先复制出队再执行, 回调中可安全地增删延时调用
+        scheduler_runlater_t callLater = *CL_LAST();
+        scheduler_runlater_t* callLater_p = &callLater;
+        ulist_delete(&clist, -1);
+        if (callLater_p->argc) {
+            ((cl_func_arg_t)callLater_p->task)(
 #define ARG_TYPE 2
 #include "scheduler_runlater_arg.h"
-                    EXPAND_ARGS_X(SCH_CFG_CALLLATER_MAX_ARG));
-                m_free((void*)callLater_p->args);
-            } else {
-                ((cl_func_noarg_t)callLater_p->task)();
-            }
-            ulist_remove(&clist, callLater_p);
-            return 0;  // 有任务被执行，不确定
-        }
-        if (callLater_p->runTimeUs - now < sleep_us) {
-            sleep_us = callLater_p->runTimeUs - now;
+                EXPAND_ARGS_X(SCH_CFG_CALLLATER_MAX_ARG));
+        } else {
+            ((cl_func_noarg_t)callLater_p->task)();
         }
     }
-    return sleep_us;
+    return 0;  // 有任务被执行，不确定
+}
+
+/**
+ * @brief 按执行时间插入延时调用任务, 同一时间的任务按添加顺序执行
+ */
+static uint8_t clist_insert(const scheduler_runlater_t* task) {
+    mod_size_t lo = 0, hi = clist.num;
+    while (lo < hi) {  // 找到第一个执行时间不晚于task的位置
+        mod_size_t mid = (lo + hi) / 2;
+        if (ulist_get_ptr(&clist, scheduler_runlater_t, mid)->runTimeUs >
+            task->runTimeUs)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return ulist_insert_copy(&clist, lo == clist.num ? SLICE_END : lo, task);
 }
 
 uint8_t __sch_runlater(void* func_addr, uint64_t delay_us, uint8_t argc,
@@ -65,7 +86,7 @@ uint8_t __sch_runlater(void* func_addr, uint64_t delay_us, uint8_t argc,
     uint32_t temp4;
     uint32_t temp4_2;
     scheduler_runlater_t task = {
-        .task = func_addr, .runTimeUs = get_sys_us() + delay_us, .args = NULL};
+        .task = func_addr, .runTimeUs = get_sys_us() + delay_us, .argc = 0};
     if (argc) {
         uint8_t arg_index = 0;
         size_t arg_size_sum = 0;
@@ -76,9 +97,6 @@ uint8_t __sch_runlater(void* func_addr, uint64_t delay_us, uint8_t argc,
             return 0;  // 参数过多
         if (arg_size_sum > SCH_CFG_CALLLATER_MAX_ARG * sizeof(cl_arg_t))
             return 0;  // 参数过大
-        task.args = (cl_arg_t*)m_alloc(arg_size_sum);
-        if (task.args == NULL)
-            return 0;  // 内存分配失败
         for (uint8_t i = 0; i < argc; i++) {
             switch (arg_size[i]) {
                 case 1:
@@ -103,12 +121,9 @@ uint8_t __sch_runlater(void* func_addr, uint64_t delay_us, uint8_t argc,
                     return 0;  // 不支持的参数长度
             }
         }
+        task.argc = arg_index;
     }
-    uint8_t ret = ulist_append_copy(&clist, &task);
-    if (!ret) {
-        m_free((void*)task.args);
-    }
-    return ret;
+    return clist_insert(&task);
 }
 
 void __sch_runlater_cancel(void* func_addr) {
@@ -2,7 +2,7 @@
 
 #include "scheduler_internal.h"
 #if SCH_CFG_ENABLE_TASK
-typedef struct {           // 用户任务结构
+struct scheduler_task {    // 用户任务结构
     ID_NAME_VAR(name);     // 任务名
     sch_task_func_t task;  // 任务函数指针
     uint64_t period;       // 任务调度周期(Tick)
@@ -10,6 +10,10 @@ typedef struct {           // 用户任务结构
     uint8_t enable;        // 是否使能
     uint8_t priority;      // 优先级
     void* args;            // 任务参数
+    mod_size_t order;      // 在tasklist中的位置(优先级顺序)
+    mod_size_t heapIdx;    // 在所属调度堆中的位置
+    uint8_t heapSel;       // 所属调度堆(TASK_HEAP_*)
+    ID_INDEX_HANDLE;       // 名称索引
 #if SCH_CFG_DEBUG_REPORT
     uint64_t max_cost;    // 任务最大执行时间(Tick)
     uint64_t total_cost;  // 任务总执行时间(Tick)
@@ -19,20 +23,54 @@ typedef struct {           // 用户任务结构
     float last_usage;     // 任务上次执行占用率
     uint8_t unsync;       // 丢失同步
 #endif
-} scheduler_task_t;
+};
 
+typedef struct scheduler_task scheduler_task_t;
+
+// 按优先级排序的任务指针列表, 任务结构体独立分配, 地址在生命周期内不变
 static ulist_t tasklist = {.data = NULL,
                            .cap = 0,
                            .num = 0,
                            .elfree = NULL,
-                           .isize = sizeof(scheduler_task_t),
-                           .opt = ULIST_OPT_CLEAR_DIRTY_REGION};
+                           .isize = sizeof(scheduler_task_t*),
+                           .opt = ULIST_OPT_CLEAR_DIRTY_REGION,
+                           .allocator = SCH_LIST_ALLOCATOR};
+
+static scheduler_task_t* taskindex = NULL;  // 任务名索引
+
+static scheduler_task_t* running_task = NULL;  // 正在执行的任务
+
+#define TASK_HEAP_NONE 0   // 未入堆(禁用)
+#define TASK_HEAP_TIME 1   // 等待堆, 按pendTime排序
+#define TASK_HEAP_READY 2  // 就绪堆, 按优先级排序
+
+#define TASK_HEAP_OPT \
+    (ULIST_OPT_NO_SHRINK | ULIST_OPT_NO_AUTO_FREE | ULIST_OPT_NO_MUTEX)
+
+static ulist_t taskheap[2] = {
+    {.data = NULL,
+     .cap = 0,
+     .num = 0,
+     .elfree = NULL,
+     .isize = sizeof(scheduler_task_t*),
+     .opt = TASK_HEAP_OPT,
+     .allocator = SCH_LIST_ALLOCATOR},
+    {.data = NULL,
+     .cap = 0,
+     .num = 0,
+     .elfree = NULL,
+     .isize = sizeof(scheduler_task_t*),
+     .opt = TASK_HEAP_OPT,
+     .allocator = SCH_LIST_ALLOCATOR},
+};
 
-static scheduler_task_t* pending_task = NULL;
+#define HEAP_LIST(sel) (&taskheap[(sel) - 1])
+#define HEAP_ARR(sel) ((scheduler_task_t**)HEAP_LIST(sel)->data)
+#define HEAP_TOP(sel) (HEAP_ARR(sel)[0])
 
-static int taskcmp(const void* a, const void* b) {
-    int priority1 = ((scheduler_task_t*)a)->priority;
-    int priority2 = ((scheduler_task_t*)b)->priority;
+static int taskcmp(const scheduler_task_t* a, const scheduler_task_t* b) {
+    int priority1 = a->priority;
+    int priority2 = b->priority;
 #if SCH_CFG_PRI_ORDER_ASC
     return priority2 - priority1;  // 高优先级在前
 #else
@@ -41,43 +79,193 @@ static int taskcmp(const void* a, const void* b) {
 }
 
 static scheduler_task_t* find_task(const char* name) {
-    ulist_foreach(&tasklist, scheduler_task_t, task) {
-        if (fast_strcmp(task->name, name))
-            return task;
+    scheduler_task_t* task = NULL;
+    if (name != NULL)
+        ID_INDEX_FIND(taskindex, name, task);
+    return task;
+}
+
+/**
+ * @brief 堆内比较, a是否应排在b之前
+ * @note 同一时间到期的任务按tasklist顺序(优先级)排列
+ */
+_STATIC_INLINE uint8_t heap_before(uint8_t sel, const scheduler_task_t* a,
+                                   const scheduler_task_t* b) {
+    if (sel == TASK_HEAP_TIME && a->pendTime != b->pendTime)
+        return a->pendTime < b->pendTime;
+    return a->order < b->order;
+}
+
+_STATIC_INLINE void heap_place(uint8_t sel, mod_size_t idx,
+                               scheduler_task_t* task) {
+    HEAP_ARR(sel)[idx] = task;
+    task->heapIdx = idx;
+    task->heapSel = sel;
+}
+
+static void heap_sift_up(uint8_t sel, mod_size_t idx) {
+    scheduler_task_t** arr = HEAP_ARR(sel);
+    scheduler_task_t* task = arr[idx];
+    while (idx) {
+        mod_size_t parent = (idx - 1) / 2;
+        if (!heap_before(sel, task, arr[parent]))
+            break;
+        heap_place(sel, idx, arr[parent]);
+        idx = parent;
+    }
+    heap_place(sel, idx, task);
+}
+
+static void heap_sift_down(uint8_t sel, mod_size_t idx) {
+    scheduler_task_t** arr = HEAP_ARR(sel);
+    mod_size_t num = HEAP_LIST(sel)->num;
+    scheduler_task_t* task = arr[idx];
+    while (1) {
+        mod_size_t child = idx * 2 + 1;
+        if (child >= num)
+            break;
+        if (child + 1 < num && heap_before(sel, arr[child + 1], arr[child]))
+            child++;
+        if (!heap_before(sel, arr[child], task))
+            break;
+        heap_place(sel, idx, arr[child]);
+        idx = child;
     }
-    return NULL;
+    heap_place(sel, idx, task);
 }
 
-static void resort_task(void) {
-    if (tasklist.num <= 1)
+static uint8_t heap_push(uint8_t sel, scheduler_task_t* task) {
+    scheduler_task_t** ptr = ulist_append(HEAP_LIST(sel));
+    if (ptr == NULL)
+        return 0;
+    *ptr = task;
+    heap_sift_up(sel, HEAP_LIST(sel)->num - 1);
+    return 1;
+}
+
+static void heap_remove(scheduler_task_t* task) {
+    uint8_t sel = task->heapSel;
+    if (sel == TASK_HEAP_NONE)
+        return;
+    mod_size_t idx = task->heapIdx;
+    scheduler_task_t* last = HEAP_ARR(sel)[HEAP_LIST(sel)->num - 1];
+    ulist_delete(HEAP_LIST(sel), -1);
+    task->heapSel = TASK_HEAP_NONE;
+    if (last == task)
         return;
-    ulist_sort(&tasklist, taskcmp, SLICE_START, SLICE_END);
+    heap_place(sel, idx, last);
+    heap_sift_up(sel, idx);
+    heap_sift_down(sel, last->heapIdx);
 }
 
-static inline scheduler_task_t* get_next_task(void) {
-    if (!tasklist.num)
-        return NULL;
-    uint64_t now = get_sys_tick();
-    scheduler_task_t* next = NULL;
-    ulist_foreach(&tasklist, scheduler_task_t, task) {
-        if (!task->enable)
-            continue;  // 跳过禁用任务
-        if (now >= task->pendTime)
-            return task;  // 高优先级在前
-        if (next == NULL || task->pendTime < next->pendTime)
-            next = task;
+/**
+ * @brief 确保调度堆容量足以容纳所有任务, 使运行时入堆不再申请内存
+ */
+static uint8_t heap_reserve(mod_size_t num) {
+    for (uint8_t sel = TASK_HEAP_TIME; sel <= TASK_HEAP_READY; sel++) {
+        ulist_t* heap = HEAP_LIST(sel);
+        if (heap->cap >= num)
+            continue;
+        mod_size_t old = heap->num;
+        if (ulist_append_multi(heap, num - old) == NULL)
+            return 0;
+        ulist_delete_multi(heap, old, num - old);
     }
-    return next;
+    return 1;
+}
+
+/**
+ * @brief 任务调度时间变动后重新放入等待堆, O(logN)
+ */
+static uint8_t task_requeue(scheduler_task_t* task) {
+    heap_remove(task);
+    if (!task->enable)
+        return 1;
+    return heap_push(TASK_HEAP_TIME, task);
+}
+
+/**
+ * @brief 从start开始刷新tasklist中任务的位置编号
+ */
+static void renumber_task(mod_size_t start) {
+    scheduler_task_t** arr = (scheduler_task_t**)tasklist.data;
+    for (mod_size_t i = start; i < tasklist.num; i++)
+        arr[i]->order = i;
+}
+
+/**
+ * @brief 按优先级将任务插入tasklist, 同优先级按插入顺序排列
+ * @note 其余任务的相对顺序不变, 因此调度堆无需重建
+ */
+static uint8_t tasklist_insert(scheduler_task_t* task) {
+    mod_size_t idx = 0;
+    ulist_foreach(&tasklist, scheduler_task_t*, p) {
+        if (taskcmp(*p, task) > 0)
+            break;
+        idx++;
+    }
+    scheduler_task_t** ptr =
+        ulist_insert(&tasklist, idx == tasklist.num ? SLICE_END : idx);
+    if (ptr == NULL)
+        return 0;
+    *ptr = task;
+    renumber_task(idx);
+    return 1;
+}
+
+static void tasklist_remove(scheduler_task_t* task) {
+    ulist_delete(&tasklist, task->order);
+    renumber_task(task->order);
+}
+
+/**
+ * @brief 优先级改变后在tasklist内移动任务, 只在原缓冲区内搬移, 不会失败
+ */
+static void tasklist_move(scheduler_task_t* task) {
+    scheduler_task_t** arr = (scheduler_task_t**)tasklist.data;
+    mod_size_t from = task->order;
+    mod_size_t to = 0;
+    for (mod_size_t i = 0; i < tasklist.num; i++) {
+        if (i == from)
+            continue;
+        if (taskcmp(arr[i], task) > 0)
+            break;
+        to++;
+    }
+    if (to < from)
+        memmove(&arr[to + 1], &arr[to], (from - to) * sizeof(*arr));
+    else if (to > from)
+        memmove(&arr[from], &arr[from + 1], (to - from) * sizeof(*arr));
+    arr[to] = task;
+    renumber_task(to < from ? to : from);
 }
 
+#if SCH_CFG_DEBUG_REPORT
+/**
+ * @brief 重建调度堆(所有任务的调度时间被统一修改时使用)
+ */
+static void rebuild_task_heap(void) {
+    ulist_foreach(&tasklist, scheduler_task_t*, task_p) {
+        task_requeue(*task_p);
+    }
+}
+#endif  // SCH_CFG_DEBUG_REPORT
+
 _INLINE uint64_t task_runner(void) {
-    if (!pending_task)
+    if (!HEAP_LIST(TASK_HEAP_TIME)->num && !HEAP_LIST(TASK_HEAP_READY)->num)
         return UINT64_MAX;
     uint64_t now = get_sys_tick();
-    if (now < pending_task->pendTime) {
-        return tick_to_us(pending_task->pendTime - now);
+    // 将所有到期任务移入就绪堆, 再按优先级取出
+    while (HEAP_LIST(TASK_HEAP_TIME)->num &&
+           now >= HEAP_TOP(TASK_HEAP_TIME)->pendTime) {
+        scheduler_task_t* task = HEAP_TOP(TASK_HEAP_TIME);
+        heap_remove(task);
+        heap_push(TASK_HEAP_READY, task);
     }
-    scheduler_task_t* task = pending_task;
+    if (!HEAP_LIST(TASK_HEAP_READY)->num) {
+        return tick_to_us(HEAP_TOP(TASK_HEAP_TIME)->pendTime - now);
+    }
+    scheduler_task_t* task = HEAP_TOP(TASK_HEAP_READY);
     uint64_t latency = now - task->pendTime;
     if (latency <= us_to_tick(SCH_CFG_COMP_RANGE_US)) {
         task->pendTime += task->period;
@@ -87,121 +275,175 @@ _INLINE uint64_t task_runner(void) {
         task->unsync = 1;
 #endif
     }
+    task_requeue(task);  // 执行前入堆, 任务函数内可安全修改自身
+    running_task = task;
 #if SCH_CFG_DEBUG_REPORT
     uint64_t _sch_debug_task_tick = get_sys_tick();
     task->task(task->args);
     _sch_debug_task_tick = get_sys_tick() - _sch_debug_task_tick;
-    if (task->max_cost < _sch_debug_task_tick)
-        task->max_cost = _sch_debug_task_tick;
-    if (latency > task->max_lat)
-        task->max_lat = latency;
-    task->total_cost += _sch_debug_task_tick;
-    task->total_lat += latency;
-    task->run_cnt++;
+    if (running_task != NULL) {  // 任务未在执行中删除自身
+        if (task->max_cost < _sch_debug_task_tick)
+            task->max_cost = _sch_debug_task_tick;
+        if (latency > task->max_lat)
+            task->max_lat = latency;
+        task->total_cost += _sch_debug_task_tick;
+        task->total_lat += latency;
+        task->run_cnt++;
+    }
 #else
     task->task(task->args);
 #endif  // SCH_CFG_DEBUG_REPORT
-    pending_task = get_next_task();
+    running_task = NULL;
     return 0;
 }
 
-uint8_t sch_task_create(const char* name, sch_task_func_t func, float freq_hz,
-                        uint8_t enable, uint8_t priority, void* args) {
-    scheduler_task_t task = {
-        .task = func,
-        .enable = enable,
-        .priority = priority,
-        .period = (double)get_sys_freq() / (double)freq_hz,
-        .pendTime = get_sys_tick(),
-        .args = args,
-    };
-    ID_NAME_SET(task.name, name);
-    if (!task.period)
-        task.period = 1;
-    if (!ulist_append_copy(&tasklist, &task))
+sch_task_handle_t sch_task_create(const char* name, sch_task_func_t func,
+                                  float freq_hz, uint8_t enable,
+                                  uint8_t priority, void* args) {
+    if (!name || !func || find_task(name) != NULL)
+        return NULL;
+    scheduler_task_t* task = sch_alloc(sizeof(scheduler_task_t));
+    if (task == NULL)
+        return NULL;
+    memset(task, 0, sizeof(scheduler_task_t));
+    task->task = func;
+    task->enable = enable;
+    task->priority = priority;
+    task->period = (double)get_sys_freq() / (double)freq_hz;
+    task->pendTime = get_sys_tick();
+    task->args = args;
+    task->heapSel = TASK_HEAP_NONE;
+    ID_NAME_SET(task->name, name);
+    if (!task->period)
+        task->period = 1;
+    ID_INDEX_ADD(taskindex, task);
+    if (!ID_INDEX_ADDED(task)) {
+        sch_free(task);
+        return NULL;
+    }
+    if (!tasklist_insert(task)) {
+        ID_INDEX_DEL(taskindex, task);
+        sch_free(task);
+        return NULL;
+    }
+    if (!heap_reserve(tasklist.num) || !task_requeue(task)) {
+        tasklist_remove(task);
+        ID_INDEX_DEL(taskindex, task);
+        sch_free(task);
+        return NULL;
+    }
+    return task;
+}
+
+sch_task_handle_t sch_task_find(const char* name) {
+    return find_task(name);
+}
+
+uint8_t sch_task_delete_h(sch_task_handle_t task) {
+    if (task == NULL)
         return 0;
-    resort_task();
-    pending_task = get_next_task();
+    heap_remove(task);
+    tasklist_remove(task);
+    ID_INDEX_DEL(taskindex, task);
+    if (task == running_task)
+        running_task = NULL;
+    sch_free(task);
     return 1;
 }
 
 uint8_t sch_task_delete(const char* name) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
-        return 0;
-    ulist_remove(&tasklist, p);
-    pending_task = get_next_task();
-    return 1;
+    return sch_task_delete_h(find_task(name));
 }
 
 uint8_t sch_task_get_exist(const char* name) {
     return find_task(name) != NULL;
 }
 
+uint8_t sch_task_get_enabled_h(sch_task_handle_t task) {
+    if (task == NULL)
+        return 0;
+    return task->enable;
+}
+
 uint8_t sch_task_get_enabled(const char* name) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
+    return sch_task_get_enabled_h(find_task(name));
+}
+
+uint8_t sch_task_set_priority_h(sch_task_handle_t task, uint8_t priority) {
+    if (task == NULL)
         return 0;
-    return p->enable;
+    if (task->priority == priority)
+        return 1;
+    task->priority = priority;
+    tasklist_move(task);
+    task_requeue(task);  // 堆容量已由heap_reserve保证, 不会失败
+    return 1;
 }
 
 uint8_t sch_task_set_priority(const char* name, uint8_t priority) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
+    return sch_task_set_priority_h(find_task(name), priority);
+}
+
+uint8_t sch_task_set_args_h(sch_task_handle_t task, void* args) {
+    if (task == NULL)
         return 0;
-    p->priority = priority;
-    resort_task();
-    pending_task = get_next_task();
+    task->args = args;
     return 1;
 }
 
 uint8_t sch_task_set_args(const char* name, void* args) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
-        return 0;
-    p->args = args;
-    return 1;
+    return sch_task_set_args_h(find_task(name), args);
 }
 
-uint8_t sch_task_delay(const char* name, uint64_t delay_us, uint8_t from_now) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
+uint8_t sch_task_delay_h(sch_task_handle_t task, uint64_t delay_us,
+                         uint8_t from_now) {
+    if (task == NULL)
         return 0;
     if (from_now)
-        p->pendTime = us_to_tick(delay_us) + get_sys_tick();
+        task->pendTime = us_to_tick(delay_us) + get_sys_tick();
     else
-        p->pendTime += us_to_tick(delay_us);
-    pending_task = get_next_task();
+        task->pendTime += us_to_tick(delay_us);
+    task_requeue(task);
     return 1;
 }
 
+uint8_t sch_task_delay(const char* name, uint64_t delay_us, uint8_t from_now) {
+    return sch_task_delay_h(find_task(name), delay_us, from_now);
+}
+
 uint16_t sch_task_get_num(void) {
     return tasklist.num;
 }
 
-uint8_t sch_task_set_enabled(const char* name, uint8_t enable) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
+uint8_t sch_task_set_enabled_h(sch_task_handle_t task, uint8_t enable) {
+    if (task == NULL)
         return 0;
-    p->enable = enable;
-    if (p->enable)
-        p->pendTime = get_sys_tick();
-    pending_task = get_next_task();
+    task->enable = enable;
+    if (task->enable)
+        task->pendTime = get_sys_tick();
+    task_requeue(task);
     return 1;
 }
 
-uint8_t sch_task_set_freq(const char* name, float freq_hz) {
-    scheduler_task_t* p = find_task(name);
-    if (p == NULL)
+uint8_t sch_task_set_enabled(const char* name, uint8_t enable) {
+    return sch_task_set_enabled_h(find_task(name), enable);
+}
+
+uint8_t sch_task_set_freq_h(sch_task_handle_t task, float freq_hz) {
+    if (task == NULL)
         return 0;
-    p->period = (double)get_sys_freq() / (double)freq_hz;
-    if (!p->period)
-        p->period = 1;
-    p->pendTime = get_sys_tick();
-    pending_task = get_next_task();
+    task->period = (double)get_sys_freq() / (double)freq_hz;
+    if (!task->period)
+        task->period = 1;
+    task->pendTime = get_sys_tick();
+    task_requeue(task);
     return 1;
 }
 
+uint8_t sch_task_set_freq(const char* name, float freq_hz) {
+    return sch_task_set_freq_h(find_task(name), freq_hz);
+}
+
 #if SCH_CFG_DEBUG_REPORT
 void sch_task_add_debug(TT tt, uint64_t period, uint64_t* other) {
     if (tasklist.num) {
@@ -220,7 +462,8 @@ void sch_task_add_debug(TT tt, uint64_t period, uint64_t* other) {
         for (int i = 0; i < sizeof(head1) / sizeof(char*); i++)
             TT_GridLine_AddItem(line, TT_Str(al, f1, f2, head1[i]));
         int i = 0;
-        ulist_foreach(&tasklist, scheduler_task_t, task) {
+        ulist_foreach(&tasklist, scheduler_task_t*, task_p) {
+            scheduler_task_t* task = *task_p;
             if (i >= SCH_CFG_DEBUG_MAXLINE) {
                 TT_AddString(
                     tt,
@@ -284,7 +527,8 @@ void sch_task_add_debug(TT tt, uint64_t period, uint64_t* other) {
 }
 
 void sch_task_finish_debug(uint8_t first_print, uint64_t offset) {
-    ulist_foreach(&tasklist, scheduler_task_t, task) {
+    ulist_foreach(&tasklist, scheduler_task_t*, task_p) {
+        scheduler_task_t* task = *task_p;
         if (first_print)
             task->pendTime = get_sys_tick();
         else
@@ -296,7 +540,7 @@ void sch_task_finish_debug(uint8_t first_print, uint64_t offset) {
         task->total_lat = 0;
         task->unsync = 0;
     }
-    pending_task = get_next_task();
+    rebuild_task_heap();
 }
 #endif  // SCH_CFG_DEBUG_REPORT
 
@@ -311,12 +555,14 @@ void task_cmd_func(EmbeddedCli* cli, char* args, void* context) {
         PRINTLN(T_FMT(T_BOLD, T_GREEN) "tasks list:" T_FMT(T_RESET, T_GREEN));
         uint16_t max_len = 0;
         uint16_t temp;
-        ulist_foreach(&tasklist, scheduler_task_t, task) {
+        ulist_foreach(&tasklist, scheduler_task_t*, task_p) {
+            scheduler_task_t* task = *task_p;
             temp = strlen(task->name);
             if (temp > max_len)
                 max_len = temp;
         }
-        ulist_foreach(&tasklist, scheduler_task_t, task) {
+        ulist_foreach(&tasklist, scheduler_task_t*, task_p) {
+            scheduler_task_t* task = *task_p;
             PRINTLN("  %-*s | entry:%p pri:%d en:%d freq:%.1f", max_len,
                     task->name, task->task, task->priority, task->enable,
                     (float)get_sys_freq() / task->period);
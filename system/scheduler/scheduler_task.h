@@ -10,6 +10,9 @@ typedef void (*sch_task_func_t)(void* args);  // 任务函数指针类型
 
 #if SCH_CFG_ENABLE_TASK
 
+// 任务句柄类型, 在任务删除前一直有效
+typedef struct scheduler_task* sch_task_handle_t;
+
 /**
  * @brief 创建一个调度任务
  * @param  name             任务名
@@ -18,11 +21,20 @@ typedef void (*sch_task_func_t)(void* args);  // 任务函数指针类型
  * @param  enable           初始化时是否使能
  * @param  priority         任务优先级
  * @param  args             任务参数
- * @retval uint8_t          是否成功
+ * @retval sch_task_handle_t 任务句柄(NULL: 失败或任务名已存在)
+ */
+extern sch_task_handle_t sch_task_create(const char* name,
+                                         sch_task_func_t func, float freq_hz,
+                                         uint8_t enable, uint8_t priority,
+                                         void* args);
+
+/**
+ * @brief 根据任务名获取任务句柄
+ * @param  name             任务名
+ * @retval sch_task_handle_t 任务句柄(NULL: 任务不存在)
+ * @note 名称查找基于哈希索引, 频繁调用的场合仍建议缓存句柄
  */
-extern uint8_t sch_task_create(const char* name, sch_task_func_t func,
-                               float freq_hz, uint8_t enable, uint8_t priority,
-                               void* args);
+extern sch_task_handle_t sch_task_find(const char* name);
 
 /**
  * @brief 切换任务使能状态
@@ -92,6 +104,21 @@ extern uint8_t sch_task_delay(const char* name, uint64_t delay_us,
  */
 extern uint16_t sch_task_get_num(void);
 
+/**
+ * 以下为基于句柄的接口, 与同名接口功能相同, 省去按名称查找的开销
+ * @warning 任务删除后句柄失效, 不可继续使用
+ */
+
+extern uint8_t sch_task_set_enabled_h(sch_task_handle_t task, uint8_t enable);
+extern uint8_t sch_task_delete_h(sch_task_handle_t task);
+extern uint8_t sch_task_set_freq_h(sch_task_handle_t task, float freq_hz);
+extern uint8_t sch_task_set_priority_h(sch_task_handle_t task,
+                                       uint8_t priority);
+extern uint8_t sch_task_set_args_h(sch_task_handle_t task, void* args);
+extern uint8_t sch_task_get_enabled_h(sch_task_handle_t task);
+extern uint8_t sch_task_delay_h(sch_task_handle_t task, uint64_t delay_us,
+                                uint8_t from_now);
+
 #endif  // SCH_CFG_ENABLE_TASK
 
 #ifdef __cplusplus
@@ -0,0 +1,22 @@
+// scheduler主机测试配置
+// 相当于在主机上由Kconfig生成的modules_config.h, 只开启任务调度
+#define MOD_CFG_COMPILER_GCC 1
+#define MOD_CFG_USE_OS_NONE 1
+#define MOD_CFG_PLATFORM_HEADER <stddef.h>
+#define MOD_CFG_TIME_MATHOD_CUSTOM 1
+#define MOD_CFG_CUSTOM_TIME_TYPE_U64 1
+#define MOD_CFG_CUSTOM_TIME_BASE 1000000
+#define MOD_CFG_DELAY_MATHOD_CUSTOM 1
+#define MOD_CFG_HEAP_MATHOD_STDLIB 1
+#define MOD_CFG_ENABLE_ATOMIC 1
+#define MOD_ENABLE_SCHEDULER 1
+#define SCH_CFG_ENABLE_TASK 1
+#define SCH_CFG_COMP_RANGE_US 1000
+#define SCH_CFG_PRI_ORDER_ASC 1
+#define SCH_CFG_STATIC_NAME 1
+#define SCH_CFG_STATIC_NAME_LEN 16
+#define LOG_CFG_ENABLE 0
+// 平台头文件中的编译器宏
+#define __weak __attribute__((weak))
+#define __IO volatile
+#define __STATIC_INLINE static inline
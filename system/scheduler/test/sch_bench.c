@@ -0,0 +1,82 @@
+// scheduler任务调度基准测试, 在主机上测量每次任务调度的耗时
+// 在工程根目录构建并运行:
+//   gcc -O2 -Isystem/scheduler/test -I. -Isystem/scheduler -Idebug/log
+//       -Iutility/macro -Idatastruct/ulist -Idatastruct/uthash
+//       -Iutility/term_table -Isystem/mpool -Iutility/embedded_cli
+//       system/scheduler/*.c datastruct/ulist/ulist.c
+//       system/scheduler/test/sch_bench.c -o sch_bench
+//   ./sch_bench [调度次数]
+// 时间基准由本文件模拟: 每个任务执行10us, 空闲时直接跳到下一个任务的时间点,
+// 因此结果只包含调度器自身的开销. 任务频率分布在10~1000Hz, 优先级0~4
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "scheduler.h"
+
+#define BENCH_DISPATCHES 200000
+#define BENCH_TASK_US 10
+
+static uint64_t m_clock;  // 模拟时钟(us)
+static uint64_t m_dispatched;
+
+m_time_t mod_custom_tick_get(void) {
+    return m_clock;
+}
+void mod_custom_tick_init(void) {}
+void mod_custom_delay_us(m_time_t us) {
+    m_clock += us;
+}
+void mod_custom_delay_ms(m_time_t ms) {
+    m_clock += ms * 1000;
+}
+void mod_custom_delay_s(m_time_t s) {
+    m_clock += s * 1000000;
+}
+
+static void task_func(void* args) {
+    (void)args;
+    m_clock += BENCH_TASK_US;
+    m_dispatched++;
+}
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void bench(int tasks, uint64_t dispatches) {
+    char name[SCH_CFG_STATIC_NAME_LEN];
+    for (int i = 0; i < tasks; i++) {
+        snprintf(name, sizeof(name), "t%d", i);
+        // 任务总负载不超过约50%, 避免任务持续超时
+        float freq = 10 + (i * 37) % 991;
+        if (freq * BENCH_TASK_US * tasks > 500000)
+            freq = 500000.0f / (BENCH_TASK_US * tasks);
+        sch_task_create(name, task_func, freq, 1, i % 5, NULL);
+    }
+    m_dispatched = 0;
+    uint64_t start = host_ns();
+    while (m_dispatched < dispatches) {
+        m_clock += scheduler_run(0);  // 跳过空闲时间
+    }
+    uint64_t ns = host_ns() - start;
+    printf("%5d tasks %10llu dispatches %10.1f ns/dispatch\n", tasks,
+           (unsigned long long)m_dispatched, (double)ns / m_dispatched);
+    for (int i = 0; i < tasks; i++) {
+        snprintf(name, sizeof(name), "t%d", i);
+        sch_task_delete(name);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t dispatches = BENCH_DISPATCHES;
+    if (argc > 1)
+        dispatches = strtoull(argv[1], NULL, 0);
+    static const int counts[] = {10, 50, 150, 500, 1000};
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        bench(counts[i], dispatches);
+    }
+    return 0;
+}
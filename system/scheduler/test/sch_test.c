@@ -0,0 +1,357 @@
+// scheduler回归测试, 建议配合AddressSanitizer运行
+// 在工程根目录构建并运行:
+//   gcc -O1 -g -fsanitize=address -DSCH_CFG_ENABLE_EVENT=1
+//       -DSCH_CFG_ENABLE_COROUTINE=1 -DSCH_CFG_ENABLE_CALLLATER=1
+//       -DSCH_CFG_CALLLATER_MAX_ARG=4 -Isystem/scheduler/test -I.
+//       -Isystem/scheduler -Idebug/log -Iutility/macro -Idatastruct/ulist
+//       -Idatastruct/uthash -Iutility/term_table -Isystem/mpool
+//       -Iutility/embedded_cli -Idebug/minctest system/scheduler/*.c
+//       datastruct/ulist/ulist.c system/scheduler/test/sch_test.c -o sch_test
+//   ./sch_test
+// 全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_check.h"
+#include "scheduler.h"
+
+static uint64_t m_clock;  // 模拟时钟(us)
+m_time_t mod_custom_tick_get(void) {
+    return m_clock;
+}
+void mod_custom_tick_init(void) {}
+void mod_custom_delay_us(m_time_t us) {
+    m_clock += us;
+}
+void mod_custom_delay_ms(m_time_t ms) {
+    m_clock += ms * 1000;
+}
+void mod_custom_delay_s(m_time_t s) {
+    m_clock += s * 1000000;
+}
+
+/* 修改优先级后按新顺序调度, 之后删除任务不影响其余任务 */
+
+static char m_task_log[16];
+static int m_task_len;
+
+static void task_log(void* args) {
+    if (m_task_len < (int)sizeof(m_task_log) - 1)
+        m_task_log[m_task_len++] = *(const char*)args;
+}
+
+static const char* run_tasks(int n) {
+    m_task_len = 0;
+    for (int i = 0; i < n; i++) scheduler_run(0);
+    m_task_log[m_task_len] = '\0';
+    return m_task_log;
+}
+
+static void test_task_priority(void) {
+    CHECK(sch_task_create("a", task_log, 1, 1, 1, "a") != NULL);
+    CHECK(sch_task_create("b", task_log, 1, 1, 2, "b") != NULL);
+    CHECK(sch_task_create("c", task_log, 1, 1, 3, "c") != NULL);
+    CHECK(sch_task_create("d", task_log, 1, 1, 2, "d") != NULL);
+    CHECK(sch_task_create("b", task_log, 1, 1, 2, "b") == NULL);  // 重名
+    CHECK(strcmp(run_tasks(5), "cbda") == 0);
+    m_clock += 1000000;
+    CHECK(sch_task_set_priority("a", 5));  // 移到最前
+    CHECK(sch_task_set_priority("c", 0));  // 移到最后
+    CHECK(sch_task_set_priority("d", 2));  // 不变
+    CHECK(strcmp(run_tasks(5), "abdc") == 0);
+    CHECK(sch_task_delete("b") && !sch_task_get_exist("b"));
+    CHECK(sch_task_set_priority("c", 2));  // 同优先级排在后面
+    m_clock += 1000000;
+    CHECK(strcmp(run_tasks(4), "adc") == 0);
+    CHECK(sch_task_delete("a") && sch_task_delete("c"));
+    CHECK(sch_task_delete("d") && sch_task_get_num() == 0);
+    CHECK(!sch_task_set_priority("a", 1));
+}
+
+#if SCH_CFG_ENABLE_EVENT
+/* 事件回调中触发事件(触发列表重新分配)以及删除事件 */
+
+#define RETRIGGER_NUM 64
+
+static sch_event_handle_t m_ev_main, m_ev_other;
+static int m_main_cnt, m_other_cnt;
+
+static void other_cb(sch_event_arg_t arg) {
+    (void)arg;
+    m_other_cnt++;
+}
+
+static void main_cb(sch_event_arg_t arg) {
+    m_main_cnt++;
+    if (arg.type == 1) {  // 触发足够多的事件, 使触发列表重新分配
+        for (int i = 0; i < RETRIGGER_NUM; i++)
+            sch_event_trigger_ex_h(m_ev_other, 0, &i, sizeof(i));
+    } else if (arg.type == 2) {  // 删除排在后面的事件和自身
+        sch_event_delete_h(m_ev_other);
+        sch_event_delete_h(m_ev_main);
+    }
+}
+
+static void test_event_callback(void) {
+    m_ev_main = sch_event_create("main", main_cb, 1);
+    m_ev_other = sch_event_create("other", other_cb, 1);
+    CHECK(m_ev_main != NULL && m_ev_other != NULL);
+    CHECK(sch_event_create("main", main_cb, 1) == NULL);  // 重名
+    sch_event_trigger_h(m_ev_main, 1, NULL, 0);
+    sch_event_trigger_h(m_ev_other, 0, NULL, 0);
+    scheduler_run(0);  // 本轮不执行回调中新触发的事件
+    CHECK(m_main_cnt == 1 && m_other_cnt == 1);
+    scheduler_run(0);
+    CHECK(m_other_cnt == 1 + RETRIGGER_NUM);
+    sch_event_trigger_h(m_ev_main, 2, NULL, 0);
+    sch_event_trigger_ex_h(m_ev_other, 0, &m_other_cnt, sizeof(m_other_cnt));
+    sch_event_trigger_h(m_ev_main, 0, NULL, 0);
+    scheduler_run(0);  // 删除后排队的触发不再执行
+    CHECK(m_main_cnt == 2 && m_other_cnt == 1 + RETRIGGER_NUM);
+    CHECK(sch_event_get_num() == 0);
+}
+#endif  // SCH_CFG_ENABLE_EVENT
+
+#if SCH_CFG_ENABLE_CALLLATER
+/* 延时调用按执行时间排序, 同一时间按添加顺序, 一次取出全部到期任务 */
+
+static uint32_t m_rl_log[16];
+static int m_rl_len;
+
+static void rl_log(uint32_t id) {
+    if (m_rl_len < 16)
+        m_rl_log[m_rl_len++] = id;
+}
+
+static void rl_args(uint8_t a, uint16_t b, uint32_t c, uint8_t d) {
+    rl_log(a);
+    rl_log(b);
+    rl_log(c);
+    rl_log(d);
+}
+
+static void rl_again(void) {
+    uint32_t id = 99;
+    rl_log(id);
+    sch_runlater(rl_log, 0, id);  // 本轮不再执行新添加的任务
+}
+
+static int rl_expect(const uint32_t* ids, int n) {
+    if (m_rl_len != n)
+        return 0;
+    for (int i = 0; i < n; i++)
+        if (m_rl_log[i] != ids[i])
+            return 0;
+    m_rl_len = 0;
+    return 1;
+}
+
+static void test_runlater(void) {
+    uint32_t id;
+    m_rl_len = 0;
+    for (id = 1; id <= 3; id++) {  // 执行时间: 300, 200, 100
+        uint64_t delay = 400 - id * 100;
+        CHECK(sch_runlater(rl_log, delay, id));
+    }
+    for (id = 4; id <= 6; id++)  // 同一时间, 排在id 2与id 1之间
+        CHECK(sch_runlater(rl_log, 250, id));
+    CHECK(scheduler_run(0) == 100 && m_rl_len == 0);
+    m_clock += 250;
+    scheduler_run(0);  // 一次执行全部到期任务
+    CHECK(rl_expect((uint32_t[]){3, 2, 4, 5, 6}, 5));
+    m_clock += 50;
+    scheduler_run(0);
+    CHECK(rl_expect((uint32_t[]){1}, 1));
+
+    // 参数在添加时复制
+    uint8_t a = 1;
+    uint16_t b = 0x1234;
+    uint32_t c = 0x89ABCDEF;
+    uint8_t d = 0xFE;
+    CHECK(sch_runlater(rl_args, 10, a, b, c, d));
+    a = b = c = d = 0;
+    uint64_t big = 1;
+    CHECK(!sch_runlater(rl_args, 10, a, b, c, d, a));  // 参数过多
+    CHECK(!sch_runlater(rl_args, 10, big, big, big));  // 参数过大
+    m_clock += 10;
+    scheduler_run(0);
+    CHECK(rl_expect((uint32_t[]){1, 0x1234, 0x89ABCDEF, 0xFE}, 4));
+
+    // 回调中以0延时添加的任务在下一轮执行; 取消全部同一函数的任务
+    CHECK(sch_runlater(rl_again, 0));
+    scheduler_run(0);
+    CHECK(rl_expect((uint32_t[]){99}, 1));
+    scheduler_run(0);
+    CHECK(rl_expect((uint32_t[]){99}, 1));
+    id = 7;
+    CHECK(sch_runlater(rl_log, 5, id) && sch_runlater(rl_log, 0, id));
+    sch_runlater_cancel(rl_log);
+    m_clock += 5;
+    scheduler_run(0);
+    CHECK(m_rl_len == 0);
+}
+#endif  // SCH_CFG_ENABLE_CALLLATER
+
+#if SCH_CFG_ENABLE_COROUTINE
+/* 同名协程在前一个结束前不能再次运行 */
+
+static int m_cr_steps;
+
+static void cr_step(__async__, void* args) {
+    CR_INIT_NOLOCAL
+    (void)args;
+    m_cr_steps++;
+    CR_YIELD();
+    m_cr_steps++;
+}
+
+static void test_cortn_name(void) {
+    sch_cortn_handle_t cr = sch_cortn_run("step", cr_step, NULL);
+    CHECK(cr != NULL);
+    CHECK(sch_cortn_run("step", cr_step, NULL) == NULL);  // 重名
+    CHECK(sch_cortn_find("step") == cr && sch_cortn_get_num() == 1);
+    scheduler_run(0);
+    scheduler_run(0);
+    CHECK(m_cr_steps == 2 && sch_cortn_get_num() == 0);
+    CHECK(sch_cortn_run("step", cr_step, NULL) != NULL);  // 结束后可以复用
+    scheduler_run(0);
+    scheduler_run(0);
+    CHECK(m_cr_steps == 4);
+}
+
+/* 睡眠协程按到期时间唤醒 */
+
+static char m_cr_log[16];
+static int m_cr_len;
+
+static void cr_log(char c) {
+    if (m_cr_len < (int)sizeof(m_cr_log) - 1)
+        m_cr_log[m_cr_len++] = c;
+}
+
+static const char* run_cortn(int n) {
+    m_cr_len = 0;
+    for (int i = 0; i < n; i++) scheduler_run(0);
+    m_cr_log[m_cr_len] = '\0';
+    return m_cr_log;
+}
+
+static void cr_sleep(__async__, void* args) {
+    CR_INIT_NOLOCAL
+    CR_DELAY((uintptr_t)args);
+    cr_log(CR_SELF_NAME()[0]);
+}
+
+static void test_cortn_sleep(void) {
+    CHECK(sch_cortn_run("a", cr_sleep, (void*)30) != NULL);
+    CHECK(sch_cortn_run("b", cr_sleep, (void*)10) != NULL);
+    CHECK(sch_cortn_run("c", cr_sleep, (void*)20) != NULL);
+    CHECK(sch_cortn_run("d", cr_sleep, (void*)15) != NULL);
+    CHECK(scheduler_run(0) == 10000);  // 全部进入睡眠
+    m_clock += 9999;
+    CHECK(*run_cortn(1) == '\0');
+    m_clock += 10001;
+    CHECK(strcmp(run_cortn(1), "bdc") == 0);  // 一轮唤醒全部到期协程
+    CHECK(scheduler_run(0) == 10000 && sch_cortn_get_num() == 1);
+    m_clock += 10000;
+    CHECK(strcmp(run_cortn(1), "a") == 0 && sch_cortn_get_num() == 0);
+}
+
+/* 等待消息和互斥锁的协程不被调度, 直到被唤醒 */
+
+static void cr_recv(__async__, void* args) {
+    CR_INIT_LOCAL_BEGIN
+    const char* msg;
+    CR_INIT_LOCAL_END
+    (void)args;
+    CR_RECV_MSG(CR_LOCAL(msg));
+    cr_log(CR_LOCAL(msg)[0]);
+}
+
+static void cr_lock(__async__, void* args) {
+    CR_INIT_NOLOCAL
+    (void)args;
+    CR_ACQUIRE_MUTEX("m");
+    cr_log(CR_SELF_NAME()[0]);
+    CR_YIELD();
+    CR_RELEASE_MUTEX("m");
+}
+
+static void test_cortn_await(void) {
+    CHECK(sch_cortn_run("r", cr_recv, NULL) != NULL);
+    CHECK(*run_cortn(3) == '\0');
+    CHECK(sch_cortn_get_waiting_msg("r"));
+    CHECK(sch_cortn_send_msg("r", "x"));
+    CHECK(strcmp(run_cortn(1), "x") == 0 && sch_cortn_get_num() == 0);
+    CHECK(!sch_cortn_send_msg("r", "x"));
+
+    CHECK(sch_cortn_run("p", cr_lock, NULL) != NULL);
+    CHECK(sch_cortn_run("q", cr_lock, NULL) != NULL);
+    CHECK(strcmp(run_cortn(1), "p") == 0);
+    CHECK(sch_cortn_get_waiting_msg("q"));
+    CHECK(*run_cortn(1) == '\0');  // p释放锁, q在下一轮执行
+    CHECK(strcmp(run_cortn(1), "q") == 0 && sch_cortn_get_num() == 1);
+    CHECK(*run_cortn(1) == '\0' && sch_cortn_get_num() == 0);
+}
+
+/* 删除就绪列表(包括正在执行的列表)和睡眠堆中的协程 */
+
+static void cr_loop(__async__, void* args) {
+    CR_INIT_NOLOCAL
+    (void)args;
+    while (1) {
+        cr_log(CR_SELF_NAME()[0]);
+        CR_YIELD();
+    }
+}
+
+static void cr_kill(__async__, void* args) {
+    CR_INIT_NOLOCAL
+    cr_log(CR_SELF_NAME()[0]);
+    CHECK(sch_cortn_stop((const char*)args));
+    CR_YIELD();
+}
+
+static void test_cortn_stop(void) {
+    CHECK(sch_cortn_run("v", cr_loop, NULL) != NULL);
+    CHECK(sch_cortn_run("w", cr_loop, NULL) != NULL);
+    CHECK(sch_cortn_run("s", cr_sleep, (void*)5) != NULL);
+    CHECK(strcmp(run_cortn(2), "vwvw") == 0);
+    CHECK(sch_cortn_stop("v") && sch_cortn_stop("s"));
+    CHECK(!sch_cortn_stop("s"));
+    m_clock += 5000;
+    CHECK(strcmp(run_cortn(2), "ww") == 0 && sch_cortn_get_num() == 1);
+    CHECK(sch_cortn_stop("w"));
+
+    // 同一轮中删除排在前面(已执行)的x, 排在后面的y仍在本轮执行
+    CHECK(sch_cortn_run("x", cr_loop, NULL) != NULL);
+    CHECK(sch_cortn_run("k", cr_kill, "x") != NULL);
+    CHECK(sch_cortn_run("y", cr_loop, NULL) != NULL);
+    CHECK(strcmp(run_cortn(2), "xkyy") == 0 && sch_cortn_get_num() == 1);
+
+    CHECK(sch_cortn_stop("y"));
+
+    // 同一轮中删除排在后面(未执行)的z
+    CHECK(sch_cortn_run("k", cr_kill, "z") != NULL);
+    CHECK(sch_cortn_run("z", cr_loop, NULL) != NULL);
+    CHECK(strcmp(run_cortn(2), "k") == 0 && sch_cortn_get_num() == 0);
+}
+#endif  // SCH_CFG_ENABLE_COROUTINE
+
+int main(void) {
+    test_task_priority();
+#if SCH_CFG_ENABLE_EVENT
+    test_event_callback();
+#endif
+#if SCH_CFG_ENABLE_CALLLATER
+    test_runlater();
+#endif
+#if SCH_CFG_ENABLE_COROUTINE
+    test_cortn_name();
+    test_cortn_sleep();
+    test_cortn_await();
+    test_cortn_stop();
+#endif
+    return CHECK_RESULT();
+}
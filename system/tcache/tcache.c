@@ -0,0 +1,244 @@
+/**
+ * @file tcache.c
+ * @brief m_alloc前端的分线程按大小分级缓存
+ * @author EmbeddedModules contributors
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#define __TCACHE_BACKEND__  // 本文件中的m_alloc/m_free/m_realloc指向后端堆
+#include "tcache.h"
+
+#include <string.h>
+
+#if MOD_CFG_USE_OS_FREERTOS
+#include "task.h"
+#endif
+
+// Private Defines --------------------------
+
+// 块头大小, 保持8字节对齐
+#define HDR_SIZE 8
+// 不经过缓存的块的分级标记
+#define CLASS_LARGE 0xFFFFFFFFu
+
+// 当前线程对应的槽编号, SMP主机上可定义为当前核心编号以实现分核缓存
+#ifndef TCACHE_CFG_SLOT_ID
+#if MOD_CFG_USE_OS_KLITE
+#define TCACHE_CFG_SLOT_ID() kl_thread_id(kl_thread_self())
+#elif MOD_CFG_USE_OS_FREERTOS
+#define TCACHE_CFG_SLOT_ID() ((uintptr_t)xTaskGetCurrentTaskHandle() >> 4)
+#elif MOD_CFG_USE_OS_RTT
+#define TCACHE_CFG_SLOT_ID() ((uintptr_t)rt_thread_self() >> 4)
+#else
+#define TCACHE_CFG_SLOT_ID() 0
+#endif
+#endif
+
+// Private Macros ---------------------------
+
+#define CLASS_OF(size) (((size) - 1) / TCACHE_CFG_GRAIN)
+#define CLASS_SIZE(cls) (((cls) + 1) * TCACHE_CFG_GRAIN)
+#define PTR_HDR(p) ((tcache_hdr_t*)((uint8_t*)(p) - HDR_SIZE))
+#define HDR_PTR(h) ((void*)((uint8_t*)(h) + HDR_SIZE))
+
+// Private Typedefs -------------------------
+
+typedef union {    // 块头, 位于用户区之前
+    uint32_t cls;  // 分级编号或CLASS_LARGE
+    uint8_t pad[HDR_SIZE];
+} tcache_hdr_t;
+
+typedef struct {       // 同一分级的空闲块
+    void* head;        // 链表头(链表指针存放在用户区)
+    mod_size_t count;  // 块数
+} tcache_bin_t;
+
+typedef struct {             // 缓存槽, 同一时刻只由一个线程访问
+    mod_atomic_size_t lock;  // 0:空闲 1:占用
+    mod_size_t hits;         // 命中次数
+    mod_size_t misses;       // 未命中次数
+    mod_size_t refills;      // 补充块数
+    mod_size_t flushes;      // 归还块数
+    tcache_bin_t bins[TCACHE_CLASS_COUNT];
+} tcache_slot_t;
+
+// Private Variables ------------------------
+
+static tcache_slot_t slots[TCACHE_CFG_SLOTS];
+static mod_atomic_size_t large_count;
+static mod_atomic_size_t busy_count;
+
+// Private Functions ------------------------
+
+/**
+ * @brief 尝试占用当前线程的槽, 被占用时返回NULL
+ * @note 不等待: 与同槽的其他线程冲突时直接走堆, 保证不引入新的阻塞点
+ */
+static tcache_slot_t* slot_acquire(void) {
+    tcache_slot_t* slot =
+        &slots[(size_t)TCACHE_CFG_SLOT_ID() % TCACHE_CFG_SLOTS];
+    mod_size_t expected = 0;
+    if (MOD_ATOMIC_CAS(slot->lock, expected, 1, MOD_ATOMIC_ORDER_ACQUIRE))
+        return slot;
+    MOD_ATOMIC_FETCH_ADD(busy_count, 1, MOD_ATOMIC_ORDER_RELAXED);
+    return NULL;
+}
+
+static inline void slot_release(tcache_slot_t* slot) {
+    MOD_ATOMIC_STORE(slot->lock, 0, MOD_ATOMIC_ORDER_RELEASE);
+}
+
+/**
+ * @brief 从堆分配一个分级块
+ */
+static void* heap_alloc(uint32_t cls, size_t size) {
+    tcache_hdr_t* hdr = m_alloc(HDR_SIZE + size);
+    if (hdr == NULL)
+        return NULL;
+    hdr->cls = cls;
+    return HDR_PTR(hdr);
+}
+
+/**
+ * @brief 从bin头部归还最多n个块给堆
+ */
+static void bin_flush(tcache_slot_t* slot, tcache_bin_t* bin, mod_size_t n) {
+    while (n-- && bin->head != NULL) {
+        void* ptr = bin->head;
+        bin->head = *(void**)ptr;
+        bin->count--;
+        slot->flushes++;
+        m_free(PTR_HDR(ptr));
+    }
+}
+
+/**
+ * @brief 分配一次, 不做失败重试
+ */
+static void* alloc_once(size_t size) {
+    if (size > TCACHE_CFG_MAX_SIZE) {
+        if (size > SIZE_MAX - HDR_SIZE)
+            return NULL;
+        MOD_ATOMIC_FETCH_ADD(large_count, 1, MOD_ATOMIC_ORDER_RELAXED);
+        return heap_alloc(CLASS_LARGE, size);
+    }
+    uint32_t cls = CLASS_OF(size);
+    tcache_slot_t* slot = slot_acquire();
+    if (slot == NULL)
+        return heap_alloc(cls, CLASS_SIZE(cls));
+    tcache_bin_t* bin = &slot->bins[cls];
+    if (bin->head != NULL) {
+        slot->hits++;
+    } else {  // 批量补充, 第一个块直接返回
+        slot->misses++;
+        for (mod_size_t i = 0; i < TCACHE_CFG_BATCH; i++) {
+            void* ptr = heap_alloc(cls, CLASS_SIZE(cls));
+            if (ptr == NULL)
+                break;
+            *(void**)ptr = bin->head;
+            bin->head = ptr;
+            bin->count++;
+            slot->refills++;
+        }
+        if (bin->head == NULL) {
+            slot_release(slot);
+            return NULL;
+        }
+    }
+    void* ptr = bin->head;
+    bin->head = *(void**)ptr;
+    bin->count--;
+    slot_release(slot);
+    return ptr;
+}
+
+// Public Functions -------------------------
+
+void* tcache_alloc(size_t size) {
+    if (size == 0)
+        return NULL;
+    void* ptr = alloc_once(size);
+    if (ptr == NULL) {  // 堆已耗尽时先归还缓存再重试
+        tcache_flush();
+        ptr = alloc_once(size);
+    }
+    return ptr;
+}
+
+void tcache_free(void* ptr) {
+    if (ptr == NULL)
+        return;
+    uint32_t cls = PTR_HDR(ptr)->cls;
+    if (cls == CLASS_LARGE) {
+        m_free(PTR_HDR(ptr));
+        return;
+    }
+    tcache_slot_t* slot = slot_acquire();
+    if (slot == NULL) {
+        m_free(PTR_HDR(ptr));
+        return;
+    }
+    tcache_bin_t* bin = &slot->bins[cls];
+    *(void**)ptr = bin->head;
+    bin->head = ptr;
+    if (++bin->count > TCACHE_CFG_DEPTH)  // 超出上限时批量归还
+        bin_flush(slot, bin, TCACHE_CFG_BATCH);
+    slot_release(slot);
+}
+
+void* tcache_realloc(void* ptr, size_t size) {
+    if (ptr == NULL)
+        return tcache_alloc(size);
+    if (size == 0) {
+        tcache_free(ptr);
+        return NULL;
+    }
+    uint32_t cls = PTR_HDR(ptr)->cls;
+    if (cls == CLASS_LARGE && size > TCACHE_CFG_MAX_SIZE) {
+        if (size > SIZE_MAX - HDR_SIZE)
+            return NULL;
+        tcache_hdr_t* hdr = m_realloc(PTR_HDR(ptr), HDR_SIZE + size);
+        return hdr != NULL ? HDR_PTR(hdr) : NULL;
+    }
+    if (cls != CLASS_LARGE && size <= CLASS_SIZE(cls))
+        return ptr;
+    // 分级改变, 搬移到新块; 大块缩小为小块时只需拷贝size字节
+    void* new_ptr = tcache_alloc(size);
+    if (new_ptr == NULL)
+        return NULL;
+    memcpy(new_ptr, ptr, cls == CLASS_LARGE ? size : CLASS_SIZE(cls));
+    tcache_free(ptr);
+    return new_ptr;
+}
+
+void tcache_flush(void) {
+    for (mod_size_t i = 0; i < TCACHE_CFG_SLOTS; i++) {
+        tcache_slot_t* slot = &slots[i];
+        mod_size_t expected = 0;
+        if (!MOD_ATOMIC_CAS(slot->lock, expected, 1, MOD_ATOMIC_ORDER_ACQUIRE))
+            continue;
+        for (mod_size_t c = 0; c < TCACHE_CLASS_COUNT; c++)
+            bin_flush(slot, &slot->bins[c], slot->bins[c].count);
+        slot_release(slot);
+    }
+}
+
+void tcache_get_stats(tcache_stats_t* stats) {
+    memset(stats, 0, sizeof(tcache_stats_t));
+    for (mod_size_t i = 0; i < TCACHE_CFG_SLOTS; i++) {
+        const tcache_slot_t* slot = &slots[i];
+        stats->hits += slot->hits;
+        stats->misses += slot->misses;
+        stats->refills += slot->refills;
+        stats->flushes += slot->flushes;
+        for (mod_size_t c = 0; c < TCACHE_CLASS_COUNT; c++) {
+            stats->cached += slot->bins[c].count;
+            stats->cached_bytes += slot->bins[c].count * CLASS_SIZE(c);
+        }
+    }
+    stats->large = MOD_ATOMIC_LOAD(large_count, MOD_ATOMIC_ORDER_RELAXED);
+    stats->busy = MOD_ATOMIC_LOAD(busy_count, MOD_ATOMIC_ORDER_RELAXED);
+}
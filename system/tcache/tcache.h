@@ -0,0 +1,104 @@
+/**
+ * @file tcache.h
+ * @brief m_alloc前端的分线程按大小分级缓存
+ * @author EmbeddedModules contributors
+ * @date 2026-10-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#ifndef __TCACHE_H__
+#define __TCACHE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "modules.h"
+
+// Public Defines ---------------------------
+
+#ifndef TCACHE_CFG_SLOTS
+#define TCACHE_CFG_SLOTS 4  // 缓存槽数, 线程按ID散列到各槽
+#endif
+
+#ifndef TCACHE_CFG_MAX_SIZE
+#define TCACHE_CFG_MAX_SIZE 256  // 可缓存的最大请求大小(字节)
+#endif
+
+#ifndef TCACHE_CFG_GRAIN
+#define TCACHE_CFG_GRAIN 16  // 大小分级的粒度(字节)
+#endif
+
+#ifndef TCACHE_CFG_BATCH
+#define TCACHE_CFG_BATCH 8  // 每次从堆补充/归还的块数
+#endif
+
+#ifndef TCACHE_CFG_DEPTH
+#define TCACHE_CFG_DEPTH 32  // 每槽每级最多缓存的块数
+#endif
+
+#define TCACHE_CLASS_COUNT (TCACHE_CFG_MAX_SIZE / TCACHE_CFG_GRAIN)
+
+#if TCACHE_CFG_GRAIN % 8 || TCACHE_CFG_MAX_SIZE % TCACHE_CFG_GRAIN
+#error "TCACHE_CFG_GRAIN must be a multiple of 8 and divide MAX_SIZE"
+#endif
+#if TCACHE_CFG_BATCH < 1 || TCACHE_CFG_DEPTH < TCACHE_CFG_BATCH
+#error "TCACHE_CFG_DEPTH must not be smaller than TCACHE_CFG_BATCH"
+#endif
+#if !MOD_CFG_USE_OS_NONE && !MOD_CFG_ENABLE_ATOMIC  // 槽锁依赖原子CAS
+#error "MOD_CFG_HEAP_TCACHE with an RTOS requires MOD_CFG_ENABLE_ATOMIC"
+#endif
+
+// Public Typedefs --------------------------
+
+typedef struct {          // 统计信息(所有槽之和)
+    size_t hits;          // 直接由缓存满足的分配次数
+    size_t misses;        // 需要从堆补充的分配次数
+    size_t refills;       // 从堆补充的块数
+    size_t flushes;       // 归还给堆的块数
+    size_t cached;        // 当前缓存中的块数
+    size_t cached_bytes;  // 当前缓存占用的字节数(不含块头)
+    size_t large;         // 超过TCACHE_CFG_MAX_SIZE直接走堆的次数
+    size_t busy;          // 槽被其他线程占用而直接走堆的次数
+} tcache_stats_t;
+
+// Exported Functions -----------------------
+
+/**
+ * @brief 分配内存, 不超过TCACHE_CFG_MAX_SIZE的请求优先从当前线程的缓存取
+ * @param  size             大小(字节)
+ * @retval void*            内存指针, 失败或size为0时返回NULL
+ */
+extern void* tcache_alloc(size_t size);
+
+/**
+ * @brief 释放由tcache_alloc/tcache_realloc分配的内存, ptr为NULL时无操作
+ * @note 可由任意线程释放, 块进入释放者所在的槽
+ */
+extern void tcache_free(void* ptr);
+
+/**
+ * @brief 重新分配内存
+ * @param  ptr              原指针(NULL时等同alloc)
+ * @param  size             新大小(为0时等同free并返回NULL)
+ * @retval void*            新指针, 失败时返回NULL且原内存保持不变
+ */
+extern void* tcache_realloc(void* ptr, size_t size);
+
+/**
+ * @brief 将所有空闲槽中缓存的块归还给堆
+ * @note 正被其他线程使用的槽会被跳过
+ */
+extern void tcache_flush(void);
+
+/**
+ * @brief 获取统计信息, 命中率为hits / (hits + misses)
+ */
+extern void tcache_get_stats(tcache_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TCACHE_H__ */
@@ -0,0 +1,233 @@
+// tcache回归测试: 按大小分级与批量补充, 超过上限时批量归还,
+// realloc的原地/搬移规则, 槽被占用时直接走堆, 跨槽释放,
+// 堆耗尽时归还缓存后重试, 以及多线程共用较少槽时的分配/释放
+// 在工程根目录构建并运行:
+//   gcc -O1 -g -fsanitize=address,undefined -pthread -Isystem/tcache/test
+//       -I. -Isystem/tcache -Idebug/minctest system/tcache/test/tcache_test.c
+//       -o tcache_test
+//   ./tcache_test
+// 全部通过时返回0
+// 后端堆替换为带计数和限额的malloc, 槽编号取自线程局部变量,
+// 因此本文件直接包含tcache.c
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "modules.h"
+
+static pthread_mutex_t m_check_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define CHECK_LOCK() pthread_mutex_lock(&m_check_mutex)
+#define CHECK_UNLOCK() pthread_mutex_unlock(&m_check_mutex)
+#include "host_check.h"
+
+static size_t m_live;              // 后端堆中的块数
+static size_t m_limit = SIZE_MAX;  // 后端堆的块数上限
+static __thread unsigned m_slot;   // 当前线程的槽编号
+
+static void* heap_malloc(size_t size) {
+    if (__atomic_load_n(&m_live, __ATOMIC_RELAXED) >= m_limit)
+        return NULL;
+    void* p = malloc(size);
+    if (p != NULL)
+        __atomic_fetch_add(&m_live, 1, __ATOMIC_RELAXED);
+    return p;
+}
+
+static void heap_free(void* p) {
+    if (p != NULL)
+        __atomic_fetch_sub(&m_live, 1, __ATOMIC_RELAXED);
+    free(p);
+}
+
+#undef m_alloc
+#undef m_free
+#undef m_realloc
+#define m_alloc(size) heap_malloc(size)
+#define m_free(ptr) heap_free(ptr)
+#define m_realloc(ptr, size) realloc(ptr, size)
+#define TCACHE_CFG_SLOT_ID() m_slot
+
+#include "tcache.c"
+
+#define NTHREADS 4
+#define ROUNDS 20000
+
+static tcache_stats_t stats(void) {
+    tcache_stats_t s;
+    tcache_get_stats(&s);
+    return s;
+}
+
+/* 分级: 每级第一次分配从堆补充一批, 之后由缓存满足; 可用大小为整级 */
+static void test_classes(void) {
+    CHECK(tcache_alloc(0) == NULL);
+    void* p[TCACHE_CFG_BATCH];
+    for (int i = 0; i < TCACHE_CFG_BATCH; i++) {
+        p[i] = tcache_alloc(i + 1);
+        CHECK(p[i] != NULL && (uintptr_t)p[i] % 8 == 0);
+        memset(p[i], 0x5A, TCACHE_CFG_GRAIN);  // 越界由ASan检查
+    }
+    tcache_stats_t s = stats();
+    CHECK(s.misses == 1 && s.hits == TCACHE_CFG_BATCH - 1);
+    CHECK(s.refills == TCACHE_CFG_BATCH && s.cached == 0);
+    CHECK(m_live == TCACHE_CFG_BATCH);
+
+    void* top = tcache_alloc(TCACHE_CFG_MAX_SIZE);
+    memset(top, 0, TCACHE_CFG_MAX_SIZE);
+    void* big = tcache_alloc(TCACHE_CFG_MAX_SIZE + 1);
+    memset(big, 0, TCACHE_CFG_MAX_SIZE + 1);
+    s = stats();
+    CHECK(s.misses == 2 && s.large == 1);
+    CHECK(s.cached == TCACHE_CFG_BATCH - 1);
+    CHECK(s.cached_bytes == (TCACHE_CFG_BATCH - 1) * TCACHE_CFG_MAX_SIZE);
+    tcache_free(big);
+    tcache_free(top);
+    for (int i = 0; i < TCACHE_CFG_BATCH; i++) tcache_free(p[i]);
+    tcache_free(NULL);
+    CHECK(stats().cached == 2 * TCACHE_CFG_BATCH);
+    tcache_flush();
+    CHECK(stats().cached == 0 && m_live == 0);
+}
+
+/* 一级中超过TCACHE_CFG_DEPTH个块时, 归还一批给堆 */
+static void test_depth(void) {
+    enum { N = TCACHE_CFG_DEPTH + 1 };
+    void* p[N];
+    for (int i = 0; i < N; i++) p[i] = tcache_alloc(40);
+    size_t flushes = stats().flushes;
+    for (int i = 0; i < N; i++) tcache_free(p[i]);
+    tcache_stats_t s = stats();
+    CHECK(s.flushes == flushes + TCACHE_CFG_BATCH);
+    CHECK(s.cached <= TCACHE_CFG_DEPTH);
+    CHECK(m_live == s.cached);
+    tcache_flush();
+    CHECK(m_live == 0);
+}
+
+/* realloc: 同级内原地返回, 跨级搬移并保留数据, 大块之间由堆realloc */
+static void test_realloc(void) {
+    uint8_t* p = tcache_realloc(NULL, 5);
+    for (int i = 0; i < 5; i++) p[i] = (uint8_t)i;
+    CHECK(tcache_realloc(p, TCACHE_CFG_GRAIN) == p);
+    uint8_t* q = tcache_realloc(p, 3 * TCACHE_CFG_GRAIN);
+    CHECK(q != p && PTR_HDR(q)->cls == 2);
+    for (int i = 0; i < 5; i++) CHECK(q[i] == i);
+    p = tcache_realloc(q, 1000);  // 小块变大块
+    CHECK(PTR_HDR(p)->cls == CLASS_LARGE);
+    for (int i = 0; i < 5; i++) CHECK(p[i] == i);
+    memset(p + 5, 0xCC, 995);
+    p = tcache_realloc(p, 4000);  // 大块之间
+    CHECK(PTR_HDR(p)->cls == CLASS_LARGE && p[999] == 0xCC);
+    q = tcache_realloc(p, 20);  // 大块变小块, 只拷贝20字节
+    CHECK(PTR_HDR(q)->cls == 1 && q[4] == 4 && q[19] == 0xCC);
+    CHECK(tcache_realloc(q, 0) == NULL);
+    CHECK(tcache_realloc(NULL, SIZE_MAX) == NULL);
+    tcache_flush();
+    CHECK(m_live == 0);
+}
+
+/* 槽被占用时分配和释放直接走堆; 释放进入释放者所在的槽 */
+static void test_busy_cross(void) {
+    tcache_stats_t s0 = stats();
+    slots[0].lock = 1;
+    void* p = tcache_alloc(24);
+    CHECK(p != NULL && m_live == 1);
+    tcache_free(p);
+    CHECK(m_live == 0);
+    tcache_stats_t s = stats();
+    CHECK(s.busy == s0.busy + 2 && s.cached == 0);
+    tcache_flush();  // 跳过被占用的槽
+    slots[0].lock = 0;
+
+    p = tcache_alloc(24);
+    m_slot = 1;
+    tcache_free(p);  // 由另一个槽的线程释放
+    m_slot = 0;
+    CHECK(slots[1].bins[1].count == 1);
+    CHECK(slots[0].bins[1].count == TCACHE_CFG_BATCH - 1);
+    tcache_flush();
+    CHECK(m_live == 0);
+}
+
+/* 堆耗尽: 归还所有缓存后重试 */
+static void test_exhausted(void) {
+    void* a = tcache_alloc(8);  // 缓存了BATCH - 1个块
+    m_limit = m_live;
+    void* b = tcache_alloc(200);
+    CHECK(b != NULL);
+    CHECK(slots[0].bins[0].count == 0);
+    CHECK(m_live == TCACHE_CFG_BATCH);
+    m_limit = 1;
+    void* c = tcache_alloc(200);  // 同级还有缓存
+    CHECK(c != NULL);
+    m_limit = 0;
+    CHECK(tcache_alloc(100) == NULL);  // 没有可用内存
+    m_limit = SIZE_MAX;
+    tcache_free(c);
+    tcache_free(b);
+    tcache_free(a);
+    tcache_flush();
+    CHECK(m_live == 0);
+}
+
+static void* worker(void* arg) {
+    unsigned id = (unsigned)(uintptr_t)arg;
+    uint8_t* held[16] = {0};
+    unsigned seed = id * 2654435761u + 1;
+    m_slot = id;
+    for (int r = 0; r < ROUNDS; r++) {
+        seed = seed * 1103515245u + 12345u;
+        int k = (seed >> 8) % 16;
+        if (held[k] != NULL) {
+            size_t n = held[k][0];
+            for (size_t i = 1; i < n; i++) {
+                if (held[k][i] != (uint8_t)(id + i)) {
+                    CHECK_FAIL("thread %u: block corrupted", id);
+                    break;
+                }
+            }
+            if (seed & 0x10000) {
+                tcache_free(held[k]);
+                held[k] = NULL;
+                continue;
+            }
+        }
+        size_t n = 2 + (seed >> 20) % 254;
+        uint8_t* p = tcache_realloc(held[k], n);
+        if (p == NULL) {
+            CHECK_FAIL("thread %u: alloc %zu failed", id, n);
+            break;
+        }
+        p[0] = (uint8_t)n;
+        for (size_t i = 1; i < n; i++) p[i] = (uint8_t)(id + i);
+        held[k] = p;
+    }
+    for (int k = 0; k < 16; k++) tcache_free(held[k]);
+    return NULL;
+}
+
+/* 多线程: 4个线程共用2个槽, 内容不被其他线程改写, 结束后没有泄漏 */
+static void test_threads(void) {
+    pthread_t t[NTHREADS];
+    size_t live = m_live;
+    for (uintptr_t i = 0; i < NTHREADS; i++)
+        pthread_create(&t[i], NULL, worker, (void*)i);
+    for (int i = 0; i < NTHREADS; i++) pthread_join(t[i], NULL);
+    tcache_stats_t s = stats();
+    printf("threads: hits %zu misses %zu busy %zu\n", s.hits, s.misses,
+           s.busy);
+    CHECK(s.hits > s.misses);
+    tcache_flush();
+    CHECK(m_live == live);
+}
+
+int main(void) {
+    test_classes();
+    test_depth();
+    test_realloc();
+    test_busy_cross();
+    test_exhausted();
+    test_threads();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,23 @@
+// tlsf主机测试配置
+// 相当于在主机上由Kconfig生成的modules_config.h, 模块堆使用tlsf.
+// 基准测试同时编译heap4/lwmem/klite堆, klite堆为Kconfig默认的最佳适配,
+// 主机上按8字节对齐
+#define MOD_CFG_COMPILER_GCC 1
+#define MOD_CFG_USE_OS_NONE 1
+#define MOD_CFG_PLATFORM_HEADER <stddef.h>
+#define MOD_CFG_TIME_MATHOD_CUSTOM 1
+#define MOD_CFG_CUSTOM_TIME_TYPE_U64 1
+#define MOD_CFG_CUSTOM_TIME_BASE 1000000
+#define MOD_CFG_DELAY_MATHOD_CUSTOM 1
+#define MOD_CFG_HEAP_MATHOD_TLSF 1
+#define KLITE_CFG_FREQ 1000
+#define KLITE_CFG_MAX_PRIO 7
+#define KLITE_CFG_HEAP_USE_BUILTIN 1
+#define KLITE_CFG_HEAP_USE_BESTFIT 1
+#define KLITE_CFG_HEAP_STORAGE_PREV_NODE 1
+#define KLITE_CFG_HEAP_ALIGN_BYTE 8
+#define LOG_CFG_ENABLE 0
+// 平台头文件中的编译器宏
+#define __weak __attribute__((weak))
+#define __IO volatile
+#define __STATIC_INLINE static inline
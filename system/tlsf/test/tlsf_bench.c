@@ -0,0 +1,208 @@
+// tlsf基准测试, 与heap4/lwmem/klite内置堆比较分配/释放延迟和碎片化程度
+// 在工程根目录构建并运行:
+//   gcc -O2 -Isystem/tlsf/test -I. -Isystem/tlsf -Isystem/heap4
+//       -Isystem/lwmem -Isystem/klite/include -Idebug/log -Iutility/macro
+//       system/tlsf/tlsf.c system/heap4/heap4.c system/lwmem/lwmem.c
+//       system/klite/heap/builtin.c system/tlsf/test/tlsf_bench.c
+//       -o tlsf_bench
+//   ./tlsf_bench [操作次数]
+// 256KB堆, 600个槽位随机分配或释放, 大小70%为8~127, 25%为128~1023,
+// 5%为1024~4095字节. 报告单次操作耗时的平均值/p99/p99.9, 分配失败次数,
+// 以及搅动后仍能申请到的最大块. klite内核在此为单线程桩函数
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "heap4.h"
+#include "kl_priv.h"
+#include "lwmem.h"
+#include "tlsf.h"
+
+#define BENCH_HEAP (256 * 1024)
+#define BENCH_SLOTS 600
+#define BENCH_OPS 400000
+
+typedef struct {
+    const char* name;
+    void (*init)(void);
+    void* (*alloc)(size_t size);
+    void (*free)(void* ptr);
+} impl_t;
+
+static _Alignas(16) uint8_t m_heap[BENCH_HEAP];
+static tlsf_t m_tlsf;
+static uint64_t* m_alloc_ns;
+static uint64_t* m_free_ns;
+static uint32_t m_seed;
+
+// klite堆互斥锁依赖的内核接口, 单线程下锁总是空闲
+kl_thread_t kl_sched_tcb_now;
+void kl_port_enter_critical(void) {}
+void kl_port_leave_critical(void) {}
+void kl_sched_switch(void) {}
+void kl_sched_preempt(const bool round_robin) {
+    (void)round_robin;
+}
+void kl_sched_tcb_wait(kl_thread_t tcb, struct kl_thread_list* list) {
+    (void)tcb, (void)list;
+}
+kl_thread_t kl_sched_tcb_wake_from(struct kl_thread_list* list) {
+    (void)list;
+    return NULL;
+}
+void* kl_heap_alloc_fault_hook(kl_size_t size) {
+    (void)size;
+    return NULL;
+}
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void heap4_init(void) {
+    prvHeapInit(m_heap, BENCH_HEAP);
+}
+
+static void lwmem_init(void) {
+    static lwmem_region_t regions[2];
+    regions[0].start_addr = m_heap;
+    regions[0].size = BENCH_HEAP;
+    lwmem_assignmem(regions);
+}
+
+static void* lwmem_alloc(size_t size) {
+    return lwmem_malloc(size);
+}
+
+static void lwmem_release(void* ptr) {
+    lwmem_free(ptr);
+}
+
+static void klite_init(void) {
+    kl_heap_init(m_heap, BENCH_HEAP);
+}
+
+static void* klite_alloc(size_t size) {
+    return kl_heap_alloc(size);
+}
+
+static void tlsf_init(void) {
+    memset(&m_tlsf, 0, sizeof(m_tlsf));
+    tlsf_add_region(&m_tlsf, m_heap, BENCH_HEAP);
+}
+
+static void* tlsf_alloc(size_t size) {
+    return tlsf_malloc_ex(&m_tlsf, size);
+}
+
+static void tlsf_release(void* ptr) {
+    tlsf_free_ex(&m_tlsf, ptr);
+}
+
+static const impl_t m_impls[] = {
+    {"heap4", heap4_init, pvPortMalloc, vPortFree},
+    {"lwmem", lwmem_init, lwmem_alloc, lwmem_release},
+    {"klite", klite_init, klite_alloc, kl_heap_free},
+    {"tlsf", tlsf_init, tlsf_alloc, tlsf_release},
+};
+
+static uint32_t rnd(void) {  // xorshift32, 各实现使用相同的操作序列
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+    return m_seed;
+}
+
+static size_t rnd_size(void) {
+    uint32_t r = rnd() % 100;
+    if (r < 70)
+        return 8 + rnd() % 120;
+    if (r < 95)
+        return 128 + rnd() % 896;
+    return 1024 + rnd() % 3072;
+}
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static double average(const uint64_t* v, size_t n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++)
+        sum += v[i];
+    return n ? sum / n : 0;
+}
+
+static void bench(const impl_t* m, int ops) {
+    void* slot[BENCH_SLOTS] = {0};
+    size_t na = 0, nf = 0, fails = 0, live = 0;
+    memset(m_heap, 0, BENCH_HEAP);
+    m->init();
+    m_seed = 12345;
+    for (int op = 0; op < ops; op++) {
+        int k = rnd() % BENCH_SLOTS;
+        if (slot[k] != NULL) {
+            uint64_t start = host_ns();
+            m->free(slot[k]);
+            m_free_ns[nf++] = host_ns() - start;
+            slot[k] = NULL;
+        } else {
+            size_t size = rnd_size();
+            uint64_t start = host_ns();
+            void* p = m->alloc(size);
+            m_alloc_ns[na++] = host_ns() - start;
+            if (p == NULL) {
+                fails++;
+            } else {
+                *(uint8_t*)p = 1;
+                slot[k] = p;
+            }
+        }
+    }
+    // 碎片化: 搅动后仍能申请到的最大块(二分查找)
+    size_t lo = 0, hi = BENCH_HEAP;
+    while (lo < hi) {
+        size_t mid = (lo + hi + 1) / 2;
+        void* p = m->alloc(mid);
+        if (p != NULL) {
+            m->free(p);
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    for (int k = 0; k < BENCH_SLOTS; k++)
+        live += slot[k] != NULL;
+    qsort(m_alloc_ns, na, sizeof(uint64_t), cmp_u64);
+    qsort(m_free_ns, nf, sizeof(uint64_t), cmp_u64);
+    printf("%-6s %5.0f %5lu %6lu | %5.0f %5lu %6lu | %6zu | %6zu %4zu\n",
+           m->name, average(m_alloc_ns, na),
+           (unsigned long)m_alloc_ns[na * 99 / 100],
+           (unsigned long)m_alloc_ns[na * 999 / 1000], average(m_free_ns, nf),
+           (unsigned long)m_free_ns[nf * 99 / 100],
+           (unsigned long)m_free_ns[nf * 999 / 1000], fails, lo, live);
+    for (int k = 0; k < BENCH_SLOTS; k++)
+        m->free(slot[k]);
+}
+
+int main(int argc, char* argv[]) {
+    int ops = argc > 1 ? atoi(argv[1]) : BENCH_OPS;
+    if (ops <= 0)
+        ops = BENCH_OPS;
+    m_alloc_ns = malloc(ops * sizeof(uint64_t));
+    m_free_ns = malloc(ops * sizeof(uint64_t));
+    if (m_alloc_ns == NULL || m_free_ns == NULL)
+        return EXIT_FAILURE;
+    printf("%-6s %5s %5s %6s | %5s %5s %6s | %6s | %6s %4s\n", "ns",
+           "alloc", "p99", "p99.9", "free", "p99", "p99.9", "fails",
+           "large", "live");
+    for (size_t i = 0; i < sizeof(m_impls) / sizeof(m_impls[0]); i++)
+        bench(&m_impls[i], ops);
+    free(m_alloc_ns);
+    free(m_free_ns);
+    return 0;
+}
@@ -0,0 +1,205 @@
+// tlsf白盒测试: 随机分配/释放/重分配, 定期检查空闲链表, 位图与物理块链
+// 在工程根目录构建并运行:
+//   gcc -O1 -g -fsanitize=address,undefined -Isystem/tlsf/test -I.
+//       -Isystem/tlsf -Idebug/minctest system/tlsf/test/tlsf_test.c
+//       -o tlsf_test
+//   ./tlsf_test [操作次数] [随机种子]
+// 全部通过时返回0. 直接包含tlsf.c以访问内部结构; 三个区域分别为未对齐的
+// 起始地址, 奇数长度, 以及超过单块上限而被拆分为多段的大区域
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host_check.h"
+#include "tlsf.c"
+
+#define TEST_OPS 400000
+#define TEST_SLOTS 500
+#define TEST_CHECK_EVERY 997
+
+typedef struct {
+    uint8_t* start;
+    size_t size;
+} region_t;
+
+static tlsf_t m_tlsf;
+static uint8_t m_r0[200000 + 3], m_r1[70001];
+static uint8_t m_r2[((size_t)1 << TLSF_CFG_FL_MAX_LOG2) + 300000];
+static const region_t m_regions[] = {
+    {m_r0 + 3, sizeof(m_r0) - 3},
+    {m_r1, sizeof(m_r1)},
+    {m_r2, sizeof(m_r2)},
+};
+#define NREGIONS (sizeof(m_regions) / sizeof(m_regions[0]))
+
+/* 空闲链表与位图一致, 块位于正确的链表中, 且计数与物理块链一致 */
+static void check_heap(tlsf_t* t) {
+    size_t nfree = 0, avail = 0, nfree_phys = 0;
+    for (int f = 0; f < TLSF_FL_COUNT; f++) {
+        CHECK(!!(t->fl_bitmap & (1u << f)) == !!t->sl_bitmap[f]);
+        for (int s = 0; s < TLSF_SL_COUNT; s++) {
+            CHECK(!!(t->sl_bitmap[f] & (1u << s)) == !!t->blocks[f][s]);
+            tlsf_block_t* prev = NULL;
+            for (tlsf_block_t* b = t->blocks[f][s]; b != NULL;
+                 prev = b, b = b->next_free) {
+                int ff, ss;
+                mapping_insert(BLOCK_SIZE(b), &ff, &ss);
+                CHECK(ff == f && ss == s);
+                CHECK(b->prev_free == prev);
+                CHECK(b->size & BLOCK_FREE);
+                nfree++;
+                avail += BLOCK_SIZE(b);
+            }
+        }
+    }
+    CHECK(nfree == t->free_blocks && avail == t->avail);
+    for (size_t r = 0; r < NREGIONS; r++) {
+        uintptr_t start = ALIGN_UP((uintptr_t)m_regions[r].start);
+        uintptr_t end =
+            ALIGN_DOWN((uintptr_t)m_regions[r].start + m_regions[r].size);
+        tlsf_block_t* b = (tlsf_block_t*)start;
+        tlsf_block_t* prev = NULL;
+        int prev_free = 0;
+        while ((uintptr_t)b < end) {
+            CHECK(!!(b->size & BLOCK_PREV_FREE) == prev_free);
+            if (prev_free)
+                CHECK(b->prev_phys == prev);
+            if (BLOCK_SIZE(b) == 0 && !(b->size & BLOCK_FREE)) {  // 段尾哨兵
+                b = (tlsf_block_t*)((uint8_t*)b + HDR_SIZE);
+                prev = NULL;
+                prev_free = 0;
+                continue;
+            }
+            int is_free = !!(b->size & BLOCK_FREE);
+            CHECK(!(is_free && prev_free));  // 相邻空闲块必须已合并
+            nfree_phys += is_free;
+            prev_free = is_free;
+            prev = b;
+            b = BLOCK_NEXT(b);
+        }
+    }
+    CHECK(nfree_phys == nfree);
+}
+
+static void test_random(long ops) {
+    static void* ptr[TEST_SLOTS];
+    static size_t len[TEST_SLOTS];
+    static uint8_t tag[TEST_SLOTS];
+    size_t total = 0;
+    for (size_t r = 0; r < NREGIONS; r++)
+        total += tlsf_add_region(&m_tlsf, m_regions[r].start,
+                                 m_regions[r].size);
+    CHECK(total == m_tlsf.total && m_tlsf.avail == total);
+    check_heap(&m_tlsf);
+    for (long it = 0; it < ops; it++) {
+        int i = rand() % TEST_SLOTS, op = rand() % 3;
+        for (size_t k = 0; ptr[i] != NULL && k < len[i]; k++) {
+            if (((uint8_t*)ptr[i])[k] != tag[i]) {
+                CHECK(((uint8_t*)ptr[i])[k] == tag[i]);
+                break;
+            }
+        }
+        if (op == 0) {
+            tlsf_free_ex(&m_tlsf, ptr[i]);
+            ptr[i] = NULL;
+        } else {
+            size_t size = rand() % 4 ? rand() % 200 + 1 : rand() % 20000 + 1;
+            void* p;
+            if (op == 2) {
+                p = tlsf_realloc_ex(&m_tlsf, ptr[i], size);
+            } else {
+                tlsf_free_ex(&m_tlsf, ptr[i]);
+                ptr[i] = NULL;
+                p = tlsf_malloc_ex(&m_tlsf, size);
+            }
+            if (p != NULL) {
+                CHECK(((uintptr_t)p & (TLSF_ALIGN - 1)) == 0);
+                CHECK(tlsf_get_size_ex(&m_tlsf, p) >= size);
+                if (ptr[i] != NULL) {  // 重分配保留原有内容
+                    size_t n = size < len[i] ? size : len[i];
+                    for (size_t k = 0; k < n; k++) {
+                        if (((uint8_t*)p)[k] != tag[i]) {
+                            CHECK(((uint8_t*)p)[k] == tag[i]);
+                            break;
+                        }
+                    }
+                }
+                ptr[i] = p;
+                len[i] = size;
+                tag[i] = (uint8_t)rand();
+                memset(p, tag[i], size);
+            }  // 重分配失败时原内存保持不变
+        }
+        if (it % TEST_CHECK_EVERY == 0)
+            check_heap(&m_tlsf);
+    }
+    for (int i = 0; i < TEST_SLOTS; i++)
+        tlsf_free_ex(&m_tlsf, ptr[i]);
+    check_heap(&m_tlsf);
+
+    tlsf_stats_t st;
+    tlsf_get_stats_ex(&m_tlsf, &st);
+    CHECK(st.total_size == total && st.avail_size == total);
+    CHECK(st.min_ever_avail < total);
+    CHECK(st.alloc_count > 0 && st.free_count == st.alloc_count);
+    CHECK(st.free_blocks == m_tlsf.free_blocks);
+    CHECK(st.smallest_free <= st.largest_free && st.largest_free <= MAX_BLOCK);
+    printf("total %zu min %zu blocks %zu largest %zu alloc %zu fail %zu\n",
+           st.total_size, st.min_ever_avail, st.free_blocks, st.largest_free,
+           st.alloc_count, st.fail_count);
+}
+
+static void test_edges(void) {
+    size_t fails = m_tlsf.fail_count;
+    CHECK(tlsf_malloc_ex(&m_tlsf, 0) == NULL);
+    CHECK(tlsf_malloc_ex(&m_tlsf, MAX_BLOCK + 1) == NULL);
+    CHECK(tlsf_malloc_ex(&m_tlsf, (size_t)-1) == NULL);
+    CHECK(tlsf_calloc_ex(&m_tlsf, (size_t)-1 / 2, 4) == NULL);
+    CHECK(m_tlsf.fail_count > fails);
+    void* p = tlsf_malloc_ex(&m_tlsf, MAX_BLOCK / 2);  // 只有大区域可容纳
+    CHECK(p != NULL);
+    tlsf_free_ex(&m_tlsf, p);
+    p = tlsf_realloc_ex(&m_tlsf, NULL, 10);
+    CHECK(p != NULL);
+    CHECK(tlsf_realloc_ex(&m_tlsf, p, 0) == NULL);
+    uint8_t* c = tlsf_calloc_ex(&m_tlsf, 10, 10);
+    CHECK(c != NULL);
+    for (int k = 0; c != NULL && k < 100; k++)
+        CHECK(c[k] == 0);
+    tlsf_free_ex(&m_tlsf, c);
+    tlsf_free_ex(&m_tlsf, NULL);
+    CHECK(m_tlsf.avail == m_tlsf.total);
+    check_heap(&m_tlsf);
+
+    tlsf_t tiny = {0};
+    uint8_t small[16];
+    CHECK(tlsf_add_region(&tiny, small, sizeof(small)) == 0);
+    CHECK(tlsf_malloc_ex(&tiny, 1) == NULL);
+}
+
+/* modules.h中的init_module_heap/m_alloc使用默认分配器 */
+static void test_module_heap(void) {
+    static uint8_t buf[4096];
+    init_module_heap(buf, sizeof(buf));
+    uint8_t* p = m_alloc(100);
+    CHECK(p != NULL);
+    if (p != NULL)
+        memset(p, 0x5a, 100);
+    p = m_realloc(p, 300);
+    CHECK(p != NULL && p[0] == 0x5a && p[99] == 0x5a);
+    tlsf_stats_t st;
+    tlsf_get_stats(&st);
+    CHECK(st.total_size > 0 && st.total_size < sizeof(buf));
+    CHECK(st.alloc_count >= 1 && st.avail_size < st.total_size);
+    m_free(p);
+    tlsf_get_stats(&st);
+    CHECK(st.avail_size == st.total_size && st.free_blocks == 1);
+}
+
+int main(int argc, char* argv[]) {
+    long ops = argc > 1 ? atol(argv[1]) : TEST_OPS;
+    srand(argc > 2 ? atoi(argv[2]) : 7);
+    test_random(ops);
+    test_edges();
+    test_module_heap();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,369 @@
+/**
+ * @file tlsf.c
+ * @brief 两级分离适配(TLSF)内存分配器, 分配/释放/重分配均为O(1)
+ * @author EmbeddedModules contributors
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#include "tlsf.h"
+
+#include <string.h>
+
+// Private Defines --------------------------
+
+#define BLOCK_FREE 0x01       // 本块空闲
+#define BLOCK_PREV_FREE 0x02  // 物理上的前一块空闲
+#define BLOCK_FLAGS (BLOCK_FREE | BLOCK_PREV_FREE)
+
+// 块头大小, 同时是用户区的偏移(保持TLSF_ALIGN对齐)
+#define HDR_SIZE ALIGN_UP(sizeof(struct tlsf_block_hdr))
+// 最小块大小, 空闲时需要在用户区存放链表指针
+#define MIN_BLOCK ALIGN_UP(2 * sizeof(void*))
+// 单个块的大小上限
+#define MAX_BLOCK (((size_t)1 << TLSF_CFG_FL_MAX_LOG2) - TLSF_ALIGN)
+// 小于该大小的块全部位于一级区间0, 按TLSF_ALIGN线性划分
+#define SMALL_BLOCK ((size_t)1 << TLSF_FL_SHIFT)
+
+// Private Macros ---------------------------
+
+#define ALIGN_UP(x) (((x) + TLSF_ALIGN - 1) & ~(size_t)(TLSF_ALIGN - 1))
+#define ALIGN_DOWN(x) ((x) & ~(size_t)(TLSF_ALIGN - 1))
+
+#define BLOCK_SIZE(b) ((b)->size & ~(size_t)BLOCK_FLAGS)
+#define BLOCK_PTR(b) ((void*)((uint8_t*)(b) + HDR_SIZE))
+#define PTR_BLOCK(p) ((tlsf_block_t*)((uint8_t*)(p) - HDR_SIZE))
+#define BLOCK_NEXT(b) \
+    ((tlsf_block_t*)((uint8_t*)(b) + HDR_SIZE + BLOCK_SIZE(b)))
+
+#define GET_TLSF(t) ((t) == NULL ? &tlsf_default : (t))
+
+// Private Typedefs -------------------------
+
+struct tlsf_block_hdr {
+    tlsf_block_t* prev_phys;  // 物理上的前一块(仅前一块空闲时有效)
+    size_t size;              // 用户区大小, 低位为BLOCK_*标志
+};
+
+struct tlsf_block {
+    tlsf_block_t* prev_phys;  // 同tlsf_block_hdr
+    size_t size;              // 同tlsf_block_hdr
+    // 以下位于用户区, 仅空闲时有效
+    tlsf_block_t* next_free;  // 同一链表中的下一空闲块
+    tlsf_block_t* prev_free;  // 同一链表中的上一空闲块
+};
+
+// Private Variables ------------------------
+
+static tlsf_t tlsf_default;
+
+// Private Functions ------------------------
+
+/**
+ * @brief 最高置位位的序号, x不为0
+ */
+static inline int tlsf_fls(size_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (int)(sizeof(unsigned long) * 8) - 1 - __builtin_clzl(x);
+#else
+    int n = 0;
+    for (int s = (int)(sizeof(size_t) * 4); s > 0; s >>= 1) {
+        if (x >> s) {
+            x >>= s;
+            n += s;
+        }
+    }
+    return n;
+#endif
+}
+
+/**
+ * @brief 最低置位位的序号, x不为0
+ */
+static inline int tlsf_ffs(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#else
+    return tlsf_fls(x & (~x + 1));
+#endif
+}
+
+/**
+ * @brief 计算块大小所属的一级/二级区间
+ */
+static inline void mapping_insert(size_t size, int* fl, int* sl) {
+    if (size < SMALL_BLOCK) {
+        *fl = 0;
+        *sl = (int)(size >> TLSF_ALIGN_LOG2);
+    } else {
+        int f = tlsf_fls(size);
+        *sl = (int)(size >> (f - TLSF_CFG_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = f - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+/**
+ * @brief 查找能容纳size的最小非空区间, 无需遍历链表
+ * @retval tlsf_block_t*    区间内的第一个空闲块, 不存在时返回NULL
+ */
+static tlsf_block_t* find_suitable(tlsf_t* t, size_t size, int* fl, int* sl) {
+    // 向上取整到下一区间的起点, 区间内的任意块都能满足需求
+    if (size >= SMALL_BLOCK)
+        size += ((size_t)1 << (tlsf_fls(size) - TLSF_CFG_SL_LOG2)) - 1;
+    mapping_insert(size, fl, sl);
+    if (*fl >= TLSF_FL_COUNT)
+        return NULL;
+    uint32_t sl_map = t->sl_bitmap[*fl] & (~(uint32_t)0 << *sl);
+    if (!sl_map) {
+        uint32_t fl_map = t->fl_bitmap & (~(uint32_t)0 << (*fl + 1));
+        if (!fl_map)
+            return NULL;
+        *fl = tlsf_ffs(fl_map);
+        sl_map = t->sl_bitmap[*fl];
+    }
+    *sl = tlsf_ffs(sl_map);
+    return t->blocks[*fl][*sl];
+}
+
+static void remove_free(tlsf_t* t, tlsf_block_t* b, int fl, int sl) {
+    if (b->prev_free) {
+        b->prev_free->next_free = b->next_free;
+    } else {
+        t->blocks[fl][sl] = b->next_free;
+        if (b->next_free == NULL) {
+            t->sl_bitmap[fl] &= ~((uint32_t)1 << sl);
+            if (!t->sl_bitmap[fl])
+                t->fl_bitmap &= ~((uint32_t)1 << fl);
+        }
+    }
+    if (b->next_free)
+        b->next_free->prev_free = b->prev_free;
+    t->avail -= BLOCK_SIZE(b);
+    t->free_blocks--;
+}
+
+static void remove_block(tlsf_t* t, tlsf_block_t* b) {
+    int fl, sl;
+    mapping_insert(BLOCK_SIZE(b), &fl, &sl);
+    remove_free(t, b, fl, sl);
+}
+
+static void insert_block(tlsf_t* t, tlsf_block_t* b) {
+    int fl, sl;
+    mapping_insert(BLOCK_SIZE(b), &fl, &sl);
+    b->prev_free = NULL;
+    b->next_free = t->blocks[fl][sl];
+    if (b->next_free)
+        b->next_free->prev_free = b;
+    t->blocks[fl][sl] = b;
+    t->sl_bitmap[fl] |= (uint32_t)1 << sl;
+    t->fl_bitmap |= (uint32_t)1 << fl;
+    t->avail += BLOCK_SIZE(b);
+    t->free_blocks++;
+}
+
+/**
+ * @brief 将块b标记为空闲并与物理上前后的空闲块合并, 然后放回空闲链表
+ */
+static void release_block(tlsf_t* t, tlsf_block_t* b) {
+    if (b->size & BLOCK_PREV_FREE) {
+        tlsf_block_t* prev = b->prev_phys;
+        remove_block(t, prev);
+        prev->size += HDR_SIZE + BLOCK_SIZE(b);
+        b = prev;
+    } else {
+        b->size |= BLOCK_FREE;
+    }
+    tlsf_block_t* next = BLOCK_NEXT(b);
+    if (next->size & BLOCK_FREE) {
+        remove_block(t, next);
+        b->size += HDR_SIZE + BLOCK_SIZE(next);
+        next = BLOCK_NEXT(b);
+    }
+    next->prev_phys = b;
+    next->size |= BLOCK_PREV_FREE;
+    insert_block(t, b);
+}
+
+/**
+ * @brief 把已分配块b截短到size, 多出的部分作为空闲块放回
+ */
+static void trim_used(tlsf_t* t, tlsf_block_t* b, size_t size) {
+    size_t bsize = BLOCK_SIZE(b);
+    if (bsize < size + HDR_SIZE + MIN_BLOCK)
+        return;
+    tlsf_block_t* rest = (tlsf_block_t*)((uint8_t*)BLOCK_PTR(b) + size);
+    rest->size = bsize - size - HDR_SIZE;  // 前一块(b)在使用中
+    b->size -= bsize - size;
+    release_block(t, rest);
+}
+
+/**
+ * @brief 计算实际分配的块大小, 超过上限时返回0
+ */
+static inline size_t adjust_size(size_t size) {
+    if (size == 0 || size > MAX_BLOCK)
+        return 0;
+    size = ALIGN_UP(size);
+    return size < MIN_BLOCK ? MIN_BLOCK : size;
+}
+
+// Public Functions -------------------------
+
+size_t tlsf_add_region(tlsf_t* tlsf, void* mem, size_t size) {
+    tlsf_t* t = GET_TLSF(tlsf);
+    uintptr_t start = ALIGN_UP((uintptr_t)mem);
+    uintptr_t end = ALIGN_DOWN((uintptr_t)mem + size);
+    size_t added = 0;
+    // 每段为一个空闲块加上结尾的哨兵块, 哨兵块阻止跨段合并
+    while (end > start && end - start >= 2 * HDR_SIZE + MIN_BLOCK) {
+        size_t bsize = end - start - 2 * HDR_SIZE;
+        if (bsize > MAX_BLOCK)
+            bsize = MAX_BLOCK;
+        tlsf_block_t* b = (tlsf_block_t*)start;
+        b->prev_phys = NULL;
+        b->size = bsize | BLOCK_FREE;
+        tlsf_block_t* sentinel = BLOCK_NEXT(b);
+        sentinel->prev_phys = b;
+        sentinel->size = BLOCK_PREV_FREE;  // 大小为0且在使用中
+        insert_block(t, b);
+        t->total += bsize;
+        added += bsize;
+        start = (uintptr_t)sentinel + HDR_SIZE;
+    }
+    t->min_avail += added;
+    return added;
+}
+
+size_t tlsf_assignmem_ex(tlsf_t* tlsf, const tlsf_region_t* regions) {
+    size_t added = 0;
+    for (; regions->start != NULL && regions->size != 0; regions++)
+        added += tlsf_add_region(tlsf, regions->start, regions->size);
+    return added;
+}
+
+void* tlsf_malloc_ex(tlsf_t* tlsf, size_t size) {
+    tlsf_t* t = GET_TLSF(tlsf);
+    int fl, sl;
+    size = adjust_size(size);
+    tlsf_block_t* b = size ? find_suitable(t, size, &fl, &sl) : NULL;
+    if (b == NULL) {
+        t->fail_count++;
+        return NULL;
+    }
+    remove_free(t, b, fl, sl);
+    b->size &= ~(size_t)BLOCK_FREE;
+    BLOCK_NEXT(b)->size &= ~(size_t)BLOCK_PREV_FREE;
+    trim_used(t, b, size);
+    if (t->avail < t->min_avail)
+        t->min_avail = t->avail;
+    t->alloc_count++;
+    return BLOCK_PTR(b);
+}
+
+void* tlsf_calloc_ex(tlsf_t* tlsf, size_t nitems, size_t size) {
+    if (size && nitems > MAX_BLOCK / size)
+        return NULL;
+    void* ptr = tlsf_malloc_ex(tlsf, nitems * size);
+    if (ptr != NULL)
+        memset(ptr, 0, nitems * size);
+    return ptr;
+}
+
+void* tlsf_realloc_ex(tlsf_t* tlsf, void* ptr, size_t size) {
+    if (ptr == NULL)
+        return tlsf_malloc_ex(tlsf, size);
+    if (size == 0) {
+        tlsf_free_ex(tlsf, ptr);
+        return NULL;
+    }
+    tlsf_t* t = GET_TLSF(tlsf);
+    tlsf_block_t* b = PTR_BLOCK(ptr);
+    size_t need = adjust_size(size);
+    size_t bsize = BLOCK_SIZE(b);
+    if (need == 0) {
+        t->fail_count++;
+        return NULL;
+    }
+    if (need > bsize) {
+        tlsf_block_t* next = BLOCK_NEXT(b);
+        if (!(next->size & BLOCK_FREE) ||
+            bsize + HDR_SIZE + BLOCK_SIZE(next) < need) {
+            void* new_ptr = tlsf_malloc_ex(t, size);
+            if (new_ptr != NULL) {
+                memcpy(new_ptr, ptr, bsize);
+                tlsf_free_ex(t, ptr);
+            }
+            return new_ptr;
+        }
+        // 并入后方的空闲块
+        remove_block(t, next);
+        b->size += HDR_SIZE + BLOCK_SIZE(next);
+        BLOCK_NEXT(b)->size &= ~(size_t)BLOCK_PREV_FREE;
+    }
+    trim_used(t, b, need);
+    if (t->avail < t->min_avail)
+        t->min_avail = t->avail;
+    return ptr;
+}
+
+void tlsf_free_ex(tlsf_t* tlsf, void* ptr) {
+    if (ptr == NULL)
+        return;
+    tlsf_t* t = GET_TLSF(tlsf);
+    tlsf_block_t* b = PTR_BLOCK(ptr);
+    if (b->size & BLOCK_FREE)  // 重复释放
+        return;
+    t->free_count++;
+    release_block(t, b);
+}
+
+size_t tlsf_get_size_ex(tlsf_t* tlsf, void* ptr) {
+    (void)tlsf;
+    if (ptr == NULL)
+        return 0;
+    return BLOCK_SIZE(PTR_BLOCK(ptr));
+}
+
+void tlsf_get_stats_ex(tlsf_t* tlsf, tlsf_stats_t* stats) {
+    tlsf_t* t = GET_TLSF(tlsf);
+    stats->total_size = t->total;
+    stats->avail_size = t->avail;
+    stats->min_ever_avail = t->min_avail;
+    stats->free_blocks = t->free_blocks;
+    stats->alloc_count = t->alloc_count;
+    stats->free_count = t->free_count;
+    stats->fail_count = t->fail_count;
+    stats->largest_free = 0;
+    stats->smallest_free = 0;
+    if (!t->fl_bitmap)
+        return;
+    // 最大/最小的空闲块分别位于最高/最低的非空区间
+    int fl = tlsf_fls(t->fl_bitmap);
+    int sl = tlsf_fls(t->sl_bitmap[fl]);
+    for (tlsf_block_t* b = t->blocks[fl][sl]; b; b = b->next_free) {
+        if (BLOCK_SIZE(b) > stats->largest_free)
+            stats->largest_free = BLOCK_SIZE(b);
+    }
+    fl = tlsf_ffs(t->fl_bitmap);
+    sl = tlsf_ffs(t->sl_bitmap[fl]);
+    stats->smallest_free = stats->largest_free;
+    for (tlsf_block_t* b = t->blocks[fl][sl]; b; b = b->next_free) {
+        if (BLOCK_SIZE(b) < stats->smallest_free)
+            stats->smallest_free = BLOCK_SIZE(b);
+    }
+}
+
+void* __tlsf_alloc(void* ctx, size_t size) {
+    return tlsf_malloc_ex((tlsf_t*)ctx, size);
+}
+
+void* __tlsf_realloc(void* ctx, void* ptr, size_t size) {
+    return tlsf_realloc_ex((tlsf_t*)ctx, ptr, size);
+}
+
+void __tlsf_free(void* ctx, void* ptr) {
+    tlsf_free_ex((tlsf_t*)ctx, ptr);
+}
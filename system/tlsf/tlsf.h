@@ -0,0 +1,162 @@
+/**
+ * @file tlsf.h
+ * @brief 两级分离适配(TLSF)内存分配器, 分配/释放/重分配均为O(1)
+ * @author EmbeddedModules contributors
+ * @date 2026-10-16
+ *
+ * THINK DIFFERENTLY
+ */
+
+#ifndef __TLSF_H__
+#define __TLSF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "modules.h"
+
+// Public Defines ---------------------------
+
+#ifndef TLSF_CFG_SL_LOG2
+#define TLSF_CFG_SL_LOG2 4  // 每个一级区间划分的二级区间数(log2)
+#endif
+
+#ifndef TLSF_CFG_FL_MAX_LOG2
+#define TLSF_CFG_FL_MAX_LOG2 20  // 单个块的最大大小(log2), 更大的区域被分段
+#endif
+
+#define TLSF_ALIGN 8  // 块对齐(字节), 保证可存放uint64_t/double
+
+#define TLSF_ALIGN_LOG2 3
+#define TLSF_SL_COUNT (1 << TLSF_CFG_SL_LOG2)
+#define TLSF_FL_SHIFT (TLSF_CFG_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_COUNT (TLSF_CFG_FL_MAX_LOG2 - TLSF_FL_SHIFT + 1)
+
+#if TLSF_CFG_SL_LOG2 < 1 || TLSF_CFG_SL_LOG2 > 5
+#error "TLSF_CFG_SL_LOG2 must be in 1..5"
+#endif
+#if TLSF_FL_COUNT < 2 || TLSF_FL_COUNT > 31
+#error "TLSF_CFG_FL_MAX_LOG2 out of range"
+#endif
+
+// Public Typedefs --------------------------
+
+typedef struct tlsf_block tlsf_block_t;
+
+typedef struct {  // TLSF分配器, 全零即为不含内存的有效分配器
+    uint32_t fl_bitmap;                                  // 一级位图
+    uint32_t sl_bitmap[TLSF_FL_COUNT];                   // 二级位图
+    tlsf_block_t* blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];  // 空闲链表头
+
+    size_t total;        // 可分配的总字节数
+    size_t avail;        // 空闲块的总字节数
+    size_t min_avail;    // 空闲字节数的历史最小值
+    size_t free_blocks;  // 空闲块个数
+    size_t alloc_count;  // 成功分配次数
+    size_t free_count;   // 释放次数
+    size_t fail_count;   // 分配失败次数
+} tlsf_t;
+
+typedef struct {  // 内存区域, 数组以{NULL, 0}结尾
+    void* start;  // 起始地址
+    size_t size;  // 大小(字节)
+} tlsf_region_t;
+
+typedef struct {            // 统计信息
+    size_t total_size;      // 可分配的总字节数
+    size_t avail_size;      // 当前空闲字节数
+    size_t min_ever_avail;  // 空闲字节数的历史最小值
+    size_t largest_free;    // 最大空闲块
+    size_t smallest_free;   // 最小空闲块
+    size_t free_blocks;     // 空闲块个数
+    size_t alloc_count;     // 成功分配次数
+    size_t free_count;      // 释放次数
+    size_t fail_count;      // 分配失败次数
+} tlsf_stats_t;
+
+// Public Macros ----------------------------
+
+/**
+ * @brief 通用分配器接口的初始化值, 使分配器从tlsf分配
+ * @param  tlsf_            分配器指针(NULL为默认分配器)
+ */
+#define TLSF_ALLOCATOR(tlsf_) \
+    {__tlsf_alloc, __tlsf_realloc, __tlsf_free, (tlsf_)}
+
+#define tlsf_assignmem(regions) tlsf_assignmem_ex(NULL, (regions))
+#define tlsf_malloc(size) tlsf_malloc_ex(NULL, (size))
+#define tlsf_calloc(nitems, size) tlsf_calloc_ex(NULL, (nitems), (size))
+#define tlsf_realloc(ptr, size) tlsf_realloc_ex(NULL, (ptr), (size))
+#define tlsf_free(ptr) tlsf_free_ex(NULL, (ptr))
+#define tlsf_get_size(ptr) tlsf_get_size_ex(NULL, (ptr))
+#define tlsf_get_stats(stats) tlsf_get_stats_ex(NULL, (stats))
+
+// Exported Functions -----------------------
+
+extern void* __tlsf_alloc(void* ctx, size_t size);
+extern void* __tlsf_realloc(void* ctx, void* ptr, size_t size);
+extern void __tlsf_free(void* ctx, void* ptr);
+
+/**
+ * @brief 向分配器添加一段内存区域
+ * @param  tlsf             分配器(NULL为默认分配器)
+ * @param  mem              区域起始地址
+ * @param  size             区域大小(字节)
+ * @retval size_t           实际可分配的字节数, 区域过小时为0
+ * @note 区域之间不必相邻, 可多次调用; 超过单块上限的区域被拆分为多段
+ */
+extern size_t tlsf_add_region(tlsf_t* tlsf, void* mem, size_t size);
+
+/**
+ * @brief 依次添加多个内存区域
+ * @param  tlsf             分配器(NULL为默认分配器)
+ * @param  regions          区域数组, 以{NULL, 0}结尾
+ * @retval size_t           实际可分配的总字节数
+ */
+extern size_t tlsf_assignmem_ex(tlsf_t* tlsf, const tlsf_region_t* regions);
+
+/**
+ * @brief 分配内存
+ * @param  tlsf             分配器(NULL为默认分配器)
+ * @param  size             大小(字节)
+ * @retval void*            内存指针(按TLSF_ALIGN对齐), 失败或size为0时返回NULL
+ */
+extern void* tlsf_malloc_ex(tlsf_t* tlsf, size_t size);
+
+/**
+ * @brief 分配nitems*size字节并清零
+ */
+extern void* tlsf_calloc_ex(tlsf_t* tlsf, size_t nitems, size_t size);
+
+/**
+ * @brief 重新分配内存
+ * @param  tlsf             分配器(NULL为默认分配器)
+ * @param  ptr              原指针(NULL时等同malloc)
+ * @param  size             新大小(为0时等同free并返回NULL)
+ * @retval void*            新指针, 失败时返回NULL且原内存保持不变
+ * @note 优先原地缩小或并入后方空闲块, 只有搬移时才拷贝数据
+ */
+extern void* tlsf_realloc_ex(tlsf_t* tlsf, void* ptr, size_t size);
+
+/**
+ * @brief 释放内存, ptr为NULL时无操作
+ */
+extern void tlsf_free_ex(tlsf_t* tlsf, void* ptr);
+
+/**
+ * @brief 获取已分配内存块的可用大小
+ */
+extern size_t tlsf_get_size_ex(tlsf_t* tlsf, void* ptr);
+
+/**
+ * @brief 获取统计信息
+ * @note 最大/最小空闲块需要遍历对应的空闲链表, 不是O(1)的
+ */
+extern void tlsf_get_stats_ex(tlsf_t* tlsf, tlsf_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TLSF_H__ */
@@ -616,6 +616,7 @@ SYNC_IGNORES = [
     "*.gitignore",
     ".git",
     ".*",
+    "test",  # 主机测试, 不同步到工程
     # "*.md",
     # "LICENSE",
 ]
@@ -6,6 +6,8 @@
 
 #define CLI_TOKEN_NPOS 0xffff
 
+#define CLI_BINDING_NPOS 0xffff
+
 // Terminal colors
 #define BLACK "30"
 #define RED "31"
@@ -53,7 +55,7 @@
 
 #define SET_FLAG(flags, flag) ((flags) |= (flag))
 
-#define UNSET_U8FLAG(flags, flag) ((flags) &= (uint8_t)~(flag))
+#define UNSET_U16FLAG(flags, flag) ((flags) &= (uint16_t)~(flag))
 
 const static char* CLI_INVITATION_COLOR = FMT2(BOLD, BLUE);
 
@@ -69,12 +71,6 @@ const static char* CLI_WARNING_COLOR = FMT2(BOLD, YELLOW);
 
 const static char* CLI_ERROR_COLOR = FMT2(BOLD, RED);
 
-/**
- * Marks binding as candidate for autocompletion
- * This flag is updated each time getAutocompletedCommand is called
- */
-#define BINDING_FLAG_AUTOCOMPLETE 1u
-
 /**
  * Indicates that rx buffer overflow happened. In such case last command
  * that wasn't finished (no \r or \n were received) will be discarded
@@ -119,6 +115,12 @@ const static char* CLI_ERROR_COLOR = FMT2(BOLD, RED);
  */
 #define CLI_FLAG_SUB_INTERPRETER_ENABLED 0x80u
 
+/**
+ * Indicates that batch mode is enabled. Received lines are executed as
+ * commands without echo, live autocompletion and history
+ */
+#define CLI_FLAG_BATCH_MODE 0x100u
+
 /**
  * Indicates that cursor direction should be forward
  */
@@ -208,9 +210,10 @@ struct EmbeddedCliImpl {
     CliCommandBinding* bindings;
 
     /**
-   * Flags for each binding. Sizes are the same as for bindings array
+   * Indexes of bindings sorted by command name. Sizes are the same as for
+   * bindings array. Used for lookup and autocompletion by binary search
    */
-    uint8_t* bindingsFlags;
+    uint16_t* bindingsOrder;
 
     uint16_t bindingsCount;
 
@@ -232,7 +235,7 @@ struct EmbeddedCliImpl {
     /**
    * Flags are defined as CLI_FLAG_*
    */
-    uint8_t flags;
+    uint16_t flags;
 
     /**
    * Cursor position for current command from right to left
@@ -283,6 +286,12 @@ struct AutocompletedCommand {
    */
     const char* firstCandidate;
 
+    /**
+   * Position of first candidate in bindingsOrder. All candidates are placed
+   * one after another starting from this position
+   */
+    uint16_t firstPos;
+
     /**
    * Number of characters that can be completed safely. For example, if there
    * are two possible commands "get-led" and "get-adc", then for prefix "g"
@@ -364,6 +373,14 @@ static void onCharInput(EmbeddedCli* cli, char c);
  */
 static void onControlInput(EmbeddedCli* cli, char c);
 
+/**
+ * Process all received chars in batch mode. Lines are split on \r or \n and
+ * executed as commands without echo, escape sequences, autocompletion and
+ * history. Processing stops early if batch mode is disabled by a command.
+ * @param cli
+ */
+static void processBatchInput(EmbeddedCli* cli);
+
 /**
  * Parse command in buffer and execute callback
  * @param cli
@@ -435,10 +452,31 @@ static void onReboot(EmbeddedCli* cli, char* tokens, void* context);
  */
 static void onUnknownCommand(EmbeddedCli* cli, const char* name);
 
+/**
+ * Return first position in bindingsOrder with command name that is not less
+ * than first len chars of provided name. All names that start with these
+ * chars are placed one after another starting from returned position
+ * @param impl
+ * @param name - name or prefix (doesn't need to be null-terminated)
+ * @param len - number of chars of name to compare
+ * @return position in bindingsOrder (bindingsCount if there is no such name)
+ */
+static uint16_t bindingsLowerBound(EmbeddedCliImpl* impl, const char* name,
+                                   size_t len);
+
+/**
+ * Find binding with specified name. If there are multiple bindings with the
+ * same name, binding that was added first is returned
+ * @param impl
+ * @param name
+ * @return index of binding or CLI_BINDING_NPOS if binding is not found
+ */
+static uint16_t findBinding(EmbeddedCliImpl* impl, const char* name);
+
 /**
  * Return autocompleted command for given prefix.
- * Prefix is compared to all known command bindings and autocompleted result
- * is returned
+ * Candidates are found by binary search over sorted bindings and
+ * autocompleted result is returned
  * @param cli
  * @param prefix
  * @return
@@ -533,6 +571,15 @@ static char fifoBufPop(FifoBuf* buffer);
  */
 static bool fifoBufPush(FifoBuf* buffer, char a);
 
+/**
+ * Push as many characters from provided buffer as fits into fifo buffer
+ * @param buffer
+ * @param data - characters to add
+ * @param len - number of characters
+ * @return number of characters added to buffer
+ */
+static size_t fifoBufPushBuffer(FifoBuf* buffer, const char* data, size_t len);
+
 /**
  * Copy provided string to the history buffer.
  * If it is already inside history, it will be removed from it and added again.
@@ -598,7 +645,7 @@ uint16_t embeddedCliRequiredSize(EmbeddedCliConfig* config) {
                                       sizeof(char)) +
                    BYTES_TO_CLI_UINTS(bindingCount *
                                       sizeof(CliCommandBinding)) +
-                   BYTES_TO_CLI_UINTS(bindingCount * sizeof(uint8_t))));
+                   BYTES_TO_CLI_UINTS(bindingCount * sizeof(uint16_t))));
 }
 
 EmbeddedCli* embeddedCliNew(EmbeddedCliConfig* config) {
@@ -639,8 +686,8 @@ EmbeddedCli* embeddedCliNew(EmbeddedCliConfig* config) {
     impl->bindings = (CliCommandBinding*)buf;
     buf += BYTES_TO_CLI_UINTS(bindingCount * sizeof(CliCommandBinding));
 
-    impl->bindingsFlags = (uint8_t*)buf;
-    buf += BYTES_TO_CLI_UINTS(bindingCount);
+    impl->bindingsOrder = (uint16_t*)buf;
+    buf += BYTES_TO_CLI_UINTS(bindingCount * sizeof(uint16_t));
 
     impl->history.buf = (char*)buf;
     impl->history.bufferSize = config->historyBufferSize;
@@ -709,11 +756,8 @@ void embeddedCliReceiveBuffer(EmbeddedCli* cli, const char* buffer,
         impl->rawBufferHandler(cli, buffer, len);
         return;
     }
-    for (size_t i = 0; i < len; ++i) {
-        if (!fifoBufPush(&impl->rxBuffer, buffer[i])) {
-            SET_FLAG(impl->flags, CLI_FLAG_OVERFLOW);
-            break;
-        }
+    if (fifoBufPushBuffer(&impl->rxBuffer, buffer, len) != len) {
+        SET_FLAG(impl->flags, CLI_FLAG_OVERFLOW);
     }
 }
 
@@ -726,7 +770,7 @@ void embeddedCliSetRawHandler(EmbeddedCli* cli,
                               char (*rawHandler)(EmbeddedCli* cli, char data)) {
     PREPARE_IMPL(cli);
     impl->rawHandler = rawHandler;
-    UNSET_U8FLAG(impl->flags, CLI_FLAG_INIT_COMPLETE);
+    UNSET_U16FLAG(impl->flags, CLI_FLAG_INIT_COMPLETE);
 }
 
 void embeddedCliResetRawHandler(EmbeddedCli* cli) {
@@ -740,7 +784,7 @@ void embeddedCliSetRawBufferHandler(EmbeddedCli* cli,
                                                              size_t len)) {
     PREPARE_IMPL(cli);
     impl->rawBufferHandler = rawBufferHandler;
-    UNSET_U8FLAG(impl->flags, CLI_FLAG_INIT_COMPLETE);
+    UNSET_U16FLAG(impl->flags, CLI_FLAG_INIT_COMPLETE);
 }
 
 void embeddedCliResetRawBufferHandler(EmbeddedCli* cli) {
@@ -798,7 +842,7 @@ void embeddedCliExitSubInterpreter(EmbeddedCli* cli) {
     impl->subInterpreterOnCmd = NULL;
     impl->subInterpreterInvitation = NULL;
     impl->subInterpreterOnExit = NULL;
-    UNSET_U8FLAG(impl->flags, CLI_FLAG_SUB_INTERPRETER_ENABLED);
+    UNSET_U16FLAG(impl->flags, CLI_FLAG_SUB_INTERPRETER_ENABLED);
     // clear history
     impl->history.current = 0;
     impl->history.itemsCount = 0;
@@ -831,12 +875,18 @@ void embeddedCliProcess(EmbeddedCli* cli) {
         return;
     }
 
+    // returns with unprocessed chars only if batch mode was disabled
+    if (IS_FLAG_SET(impl->flags, CLI_FLAG_BATCH_MODE))
+        processBatchInput(cli);
+
     if (!IS_FLAG_SET(impl->flags, CLI_FLAG_INIT_COMPLETE)) {
         SET_FLAG(impl->flags, CLI_FLAG_INIT_COMPLETE);
         printInvitation(cli);
     }
 
-    while (fifoBufAvailable(&impl->rxBuffer)) {
+    // batch mode can be enabled by command, rest is processed on next call
+    while (fifoBufAvailable(&impl->rxBuffer) &&
+           !IS_FLAG_SET(impl->flags, CLI_FLAG_BATCH_MODE)) {
         char c = fifoBufPop(&impl->rxBuffer);
 
         if (IS_FLAG_SET(impl->flags, CLI_FLAG_ESCAPE_MODE)) {
@@ -859,7 +909,7 @@ void embeddedCliProcess(EmbeddedCli* cli) {
     if (IS_FLAG_SET(impl->flags, CLI_FLAG_OVERFLOW)) {
         impl->cmdSize = 0;
         impl->cmdBuffer[impl->cmdSize] = '\0';
-        UNSET_U8FLAG(impl->flags, CLI_FLAG_OVERFLOW);
+        UNSET_U16FLAG(impl->flags, CLI_FLAG_OVERFLOW);
     }
 }
 
@@ -868,6 +918,22 @@ bool embeddedCliAddBinding(EmbeddedCli* cli, CliCommandBinding binding) {
     if (impl->bindingsCount == impl->maxBindingsCount)
         return false;
 
+    // new binding is placed after all bindings with the same name, so the
+    // first added one is still found by lookup
+    uint16_t lo = 0;
+    uint16_t hi = impl->bindingsCount;
+    while (lo < hi) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (strcmp(impl->bindings[impl->bindingsOrder[mid]].name,
+                   binding.name) <= 0)
+            lo = (uint16_t)(mid + 1);
+        else
+            hi = mid;
+    }
+    memmove(&impl->bindingsOrder[lo + 1], &impl->bindingsOrder[lo],
+            (impl->bindingsCount - lo) * sizeof(uint16_t));
+    impl->bindingsOrder[lo] = impl->bindingsCount;
+
     impl->bindings[impl->bindingsCount] = binding;
 
     ++impl->bindingsCount;
@@ -879,16 +945,49 @@ bool embeddedCliDelBinding(EmbeddedCli* cli, const char* name) {
     if (impl->bindingsCount == 0)
         return false;
 
-    for (int i = 0; i < impl->bindingsCount; ++i) {
-        if (strcmp(impl->bindings[i].name, name) == 0) {
-            --impl->bindingsCount;
-            if (impl->bindingsCount != 0 && i != impl->bindingsCount)
-                impl->bindings[i] = impl->bindings[impl->bindingsCount];
-            return true;
+    uint16_t pos = bindingsLowerBound(impl, name, strlen(name) + 1);
+    if (pos == impl->bindingsCount ||
+        strcmp(impl->bindings[impl->bindingsOrder[pos]].name, name) != 0)
+        return false;
+
+    uint16_t i = impl->bindingsOrder[pos];
+    --impl->bindingsCount;
+    memmove(&impl->bindingsOrder[pos], &impl->bindingsOrder[pos + 1],
+            (impl->bindingsCount - pos) * sizeof(uint16_t));
+    if (i != impl->bindingsCount) {
+        // last binding is moved to the free place, so update its index
+        impl->bindings[i] = impl->bindings[impl->bindingsCount];
+        for (uint16_t j = 0; j < impl->bindingsCount; ++j) {
+            if (impl->bindingsOrder[j] == impl->bindingsCount) {
+                impl->bindingsOrder[j] = i;
+                break;
+            }
         }
     }
 
-    return false;
+    return true;
+}
+
+void embeddedCliSetBatchMode(EmbeddedCli* cli, bool enable) {
+    PREPARE_IMPL(cli);
+    if (enable == IS_FLAG_SET(impl->flags, CLI_FLAG_BATCH_MODE))
+        return;
+
+    if (enable) {
+        SET_FLAG(impl->flags, CLI_FLAG_BATCH_MODE);
+        // no invitation is printed in batch mode
+        SET_FLAG(impl->flags, CLI_FLAG_INIT_COMPLETE);
+    } else {
+        UNSET_U16FLAG(impl->flags, CLI_FLAG_BATCH_MODE);
+        // print invitation on next call to process
+        UNSET_U16FLAG(impl->flags, CLI_FLAG_INIT_COMPLETE);
+    }
+    // discard unfinished command, it was entered in another mode
+    impl->cmdSize = 0;
+    impl->cmdBuffer[impl->cmdSize] = '\0';
+    impl->inputLineLength = 0;
+    impl->cursorPos = 0;
+    impl->history.current = 0;
 }
 
 void embeddedCliPrint(EmbeddedCli* cli, const char* string) {
@@ -897,10 +996,14 @@ void embeddedCliPrint(EmbeddedCli* cli, const char* string) {
 
     PREPARE_IMPL(cli);
 
+    // in batch mode current command is not printed, so print directly too
+    bool directPrint =
+        IS_FLAG_SET(impl->flags, CLI_FLAG_DIRECT_PRINT | CLI_FLAG_BATCH_MODE);
+
     // Save cursor position
     uint16_t cursorPosSave = impl->cursorPos;
     // remove chars for autocompletion and live command
-    if (!IS_FLAG_SET(impl->flags, CLI_FLAG_DIRECT_PRINT))
+    if (!directPrint)
         clearCurrentLine(cli);
     // Restore cursor position
     impl->cursorPos = cursorPosSave;
@@ -909,7 +1012,7 @@ void embeddedCliPrint(EmbeddedCli* cli, const char* string) {
     writeToOutput(cli, lineBreak);
 
     // print current command back to screen
-    if (!IS_FLAG_SET(impl->flags, CLI_FLAG_DIRECT_PRINT)) {
+    if (!directPrint) {
         printInvitation(cli);
         writeToOutput(cli, impl->cmdBuffer);
         impl->inputLineLength = impl->cmdSize;
@@ -1123,7 +1226,7 @@ static void onEscapedInput(EmbeddedCli* cli, char c) {
 
     if (c >= 64 && c <= 126) {
         // handle escape sequence
-        UNSET_U8FLAG(impl->flags, CLI_FLAG_ESCAPE_MODE);
+        UNSET_U16FLAG(impl->flags, CLI_FLAG_ESCAPE_MODE);
 
         if (c == 'A' || c == 'B') {
             // treat \e[..A as cursor up and \e[..B as cursor down
@@ -1199,10 +1302,45 @@ static void onControlInput(EmbeddedCli* cli, char c) {
         // Ctrl+D in sub interpreter mode exits sub interpreter
         writeToOutput(cli, lineBreak);  // print new line
         embeddedCliExitSubInterpreter(cli);
-        UNSET_U8FLAG(impl->flags, CLI_FLAG_INIT_COMPLETE);  // print invitation
+        UNSET_U16FLAG(impl->flags, CLI_FLAG_INIT_COMPLETE);  // print invitation
     }
 }
 
+static void processBatchInput(EmbeddedCli* cli) {
+    PREPARE_IMPL(cli);
+    FifoBuf* rx = &impl->rxBuffer;
+
+    while (rx->front != rx->back &&
+           IS_FLAG_SET(impl->flags, CLI_FLAG_BATCH_MODE)) {
+        // take chars from continuous part of buffer until end of line, so
+        // position is not wrapped on each char
+        uint16_t end = rx->back > rx->front ? rx->back : rx->size;
+        uint16_t i = rx->front;
+        char c = '\0';
+        while (i < end) {
+            c = rx->buf[i++];
+            if (c == '\r' || c == '\n')
+                break;
+            // have to reserve two extra chars for command ending
+            if (isDisplayableChar(c)) {
+                if (impl->cmdSize + 2 < impl->cmdMaxSize)
+                    impl->cmdBuffer[impl->cmdSize++] = c;
+            } else if ((c == '\b' || c == 0x7F) && impl->cmdSize > 0) {
+                --impl->cmdSize;
+            }
+        }
+        rx->front = i == rx->size ? 0 : i;
+        impl->lastChar = c;
+
+        if ((c == '\r' || c == '\n') && impl->cmdSize > 0) {
+            impl->cmdBuffer[impl->cmdSize] = '\0';
+            parseCommand(cli);
+            impl->cmdSize = 0;
+        }
+    }
+    impl->cmdBuffer[impl->cmdSize] = '\0';
+}
+
 static void parseCommand(EmbeddedCli* cli) {
     PREPARE_IMPL(cli);
 
@@ -1218,7 +1356,8 @@ static void parseCommand(EmbeddedCli* cli) {
     if (isEmpty)
         return;
     // push command to history before buffer is modified
-    historyPut(&impl->history, impl->cmdBuffer);
+    if (!IS_FLAG_SET(impl->flags, CLI_FLAG_BATCH_MODE))
+        historyPut(&impl->history, impl->cmdBuffer);
 
     char* cmdName = NULL;
     char* cmdArgs = NULL;
@@ -1261,39 +1400,35 @@ static void parseCommand(EmbeddedCli* cli) {
     }
 
     // try to find command in bindings
-    for (int i = 0; i < impl->bindingsCount; ++i) {
-        if (strcmp(cmdName, impl->bindings[i].name) == 0) {
-            if (impl->bindings[i].func == NULL)
-                break;
+    uint16_t i = findBinding(impl, cmdName);
+    if (i != CLI_BINDING_NPOS && impl->bindings[i].func != NULL) {
+        // currently, output is blank line, so we can just print directly
+        SET_FLAG(impl->flags, CLI_FLAG_DIRECT_PRINT);
+        // check if help was requested (help is printed when no other options
+        // are set)
+        if (cmdArgs != NULL && (strcmp(cmdArgs, "-h") == 0 ||
+                                strcmp(cmdArgs, "--help") == 0)) {
+            printBindingUsage(cli, &impl->bindings[i]);
+        } else {
+            if (impl->bindings[i].autoTokenizeArgs)
+                embeddedCliTokenizeArgs(cmdArgs);
 
-            // currently, output is blank line, so we can just print directly
-            SET_FLAG(impl->flags, CLI_FLAG_DIRECT_PRINT);
-            // check if help was requested (help is printed when no other options are
-            // set)
-            if (cmdArgs != NULL && (strcmp(cmdArgs, "-h") == 0 ||
-                                    strcmp(cmdArgs, "--help") == 0)) {
-                printBindingUsage(cli, &impl->bindings[i]);
-            } else {
-                if (impl->bindings[i].autoTokenizeArgs)
-                    embeddedCliTokenizeArgs(cmdArgs);
-
-                impl->currentBinding = i;
-                if (impl->onCommandExecution != NULL) {
-                    impl->onCommandExecution(
-                        cli, &(CliCommand){.name = cmdName, .args = cmdArgs},
-                        false);
-                }
-                impl->bindings[i].func(cli, cmdArgs, impl->bindings[i].context);
-                if (impl->onCommandExecution != NULL) {
-                    impl->onCommandExecution(
-                        cli, &(CliCommand){.name = cmdName, .args = cmdArgs},
-                        true);
-                }
-                impl->currentBinding = impl->bindingsCount + 1;
+            impl->currentBinding = i;
+            if (impl->onCommandExecution != NULL) {
+                impl->onCommandExecution(
+                    cli, &(CliCommand){.name = cmdName, .args = cmdArgs},
+                    false);
             }
-            UNSET_U8FLAG(impl->flags, CLI_FLAG_DIRECT_PRINT);
-            return;
+            impl->bindings[i].func(cli, cmdArgs, impl->bindings[i].context);
+            if (impl->onCommandExecution != NULL) {
+                impl->onCommandExecution(
+                    cli, &(CliCommand){.name = cmdName, .args = cmdArgs},
+                    true);
+            }
+            impl->currentBinding = impl->bindingsCount + 1;
         }
+        UNSET_U16FLAG(impl->flags, CLI_FLAG_DIRECT_PRINT);
+        return;
     }
 
     // command not found in bindings or binding was null
@@ -1306,7 +1441,7 @@ static void parseCommand(EmbeddedCli* cli) {
         // currently, output is blank line, so we can just print directly
         SET_FLAG(impl->flags, CLI_FLAG_DIRECT_PRINT);
         cli->onCommand(cli, &command);
-        UNSET_U8FLAG(impl->flags, CLI_FLAG_DIRECT_PRINT);
+        UNSET_U16FLAG(impl->flags, CLI_FLAG_DIRECT_PRINT);
     } else {
         onUnknownCommand(cli, cmdName);
     }
@@ -1401,16 +1536,10 @@ static void onHelp(EmbeddedCli* cli, char* tokens, void* context) {
         writeToOutput(cli, lineBreak);
     } else if (tokenCount == 1) {
         // try find command
-        CliCommandBinding* binding = NULL;
         const char* cmdName = embeddedCliGetToken(tokens, 1);
-        for (int i = 0; i < impl->bindingsCount; ++i) {
-            if (strcmp(impl->bindings[i].name, cmdName) == 0) {
-                binding = &impl->bindings[i];
-                break;
-            }
-        }
-        if (binding != NULL) {
-            printBindingUsage(cli, binding);
+        uint16_t i = findBinding(impl, cmdName);
+        if (i != CLI_BINDING_NPOS) {
+            printBindingUsage(cli, &impl->bindings[i]);
         } else {
             onUnknownCommand(cli, cmdName);
         }
@@ -1472,9 +1601,33 @@ static void onUnknownCommand(EmbeddedCli* cli, const char* name) {
     writeToOutput(cli, lineBreak);
 }
 
+static uint16_t bindingsLowerBound(EmbeddedCliImpl* impl, const char* name,
+                                   size_t len) {
+    uint16_t lo = 0;
+    uint16_t hi = impl->bindingsCount;
+    while (lo < hi) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (strncmp(impl->bindings[impl->bindingsOrder[mid]].name, name,
+                    len) < 0)
+            lo = (uint16_t)(mid + 1);
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static uint16_t findBinding(EmbeddedCliImpl* impl, const char* name) {
+    // terminating null-char is compared too, so only exact name is found
+    uint16_t pos = bindingsLowerBound(impl, name, strlen(name) + 1);
+    if (pos < impl->bindingsCount &&
+        strcmp(impl->bindings[impl->bindingsOrder[pos]].name, name) == 0)
+        return impl->bindingsOrder[pos];
+    return CLI_BINDING_NPOS;
+}
+
 static AutocompletedCommand getAutocompletedCommand(EmbeddedCli* cli,
                                                     const char* prefix) {
-    AutocompletedCommand cmd = {NULL, 0, 0};
+    AutocompletedCommand cmd = {NULL, 0, 0, 0};
 
     size_t prefixLen = strlen(prefix);
 
@@ -1482,28 +1635,14 @@ static AutocompletedCommand getAutocompletedCommand(EmbeddedCli* cli,
     if (impl->bindingsCount == 0 || prefixLen == 0)
         return cmd;
 
-    for (int i = 0; i < impl->bindingsCount; ++i) {
-        const char* name = impl->bindings[i].name;
-        size_t len = strlen(name);
-
-        // unset autocomplete flag
-        UNSET_U8FLAG(impl->bindingsFlags[i], BINDING_FLAG_AUTOCOMPLETE);
-
-        if (len < prefixLen)
-            continue;
-
-        // check if this command is candidate for autocomplete
-        bool isCandidate = true;
-        for (size_t j = 0; j < prefixLen; ++j) {
-            if (prefix[j] != name[j]) {
-                isCandidate = false;
-                break;
-            }
-        }
-        if (!isCandidate)
-            continue;
+    // all candidates are placed one after another in sorted order
+    cmd.firstPos = bindingsLowerBound(impl, prefix, prefixLen);
+    for (uint16_t i = cmd.firstPos; i < impl->bindingsCount; ++i) {
+        const char* name = impl->bindings[impl->bindingsOrder[i]].name;
+        if (strncmp(name, prefix, prefixLen) != 0)
+            break;
 
-        impl->bindingsFlags[i] |= BINDING_FLAG_AUTOCOMPLETE;
+        size_t len = strlen(name);
 
         if (cmd.candidateCount == 0 || len < cmd.autocompletedLen)
             cmd.autocompletedLen = (uint16_t)len;
@@ -1529,13 +1668,11 @@ static AutocompletedCommand getAutocompletedCommand(EmbeddedCli* cli,
 void (*embeddedCliSwitchToCommandEntry(EmbeddedCli* cli, const char* name))(
     EmbeddedCli* cli, char* args, void* context) {
     PREPARE_IMPL(cli);
-    for (int i = 0; i < impl->bindingsCount; ++i) {
-        if (strcmp(impl->bindings[i].name, name) == 0) {
-            impl->currentBinding = i;
-            return impl->bindings[i].func;
-        }
-    }
-    return NULL;
+    uint16_t i = findBinding(impl, name);
+    if (i == CLI_BINDING_NPOS)
+        return NULL;
+    impl->currentBinding = i;
+    return impl->bindings[i].func;
 }
 
 static void printLiveAutocompletion(EmbeddedCli* cli) {
@@ -1609,13 +1746,9 @@ static void onAutocompleteRequest(EmbeddedCli* cli, bool printCandidates) {
     // clearCurrentLine(cli);
     writeToOutput(cli, lineBreak);
 
-    for (int i = 0; i < impl->bindingsCount; ++i) {
-        // autocomplete flag is set for all candidates by last call to
-        // getAutocompletedCommand
-        if (!(impl->bindingsFlags[i] & BINDING_FLAG_AUTOCOMPLETE))
-            continue;
-
-        const char* name = impl->bindings[i].name;
+    for (uint16_t i = 0; i < cmd.candidateCount; ++i) {
+        const char* name =
+            impl->bindings[impl->bindingsOrder[cmd.firstPos + i]].name;
 
         writeToOutput(cli, name);
         writeToOutput(cli, lineBreak);
@@ -1713,6 +1846,23 @@ static bool fifoBufPush(FifoBuf* buffer, char a) {
     return false;
 }
 
+static size_t fifoBufPushBuffer(FifoBuf* buffer, const char* data,
+                                size_t len) {
+    size_t count =
+        (size_t)(buffer->size - 1 - fifoBufAvailable(buffer));  // free space
+    if (len < count)
+        count = len;
+
+    // copy up to the end of buffer and then from its beginning
+    size_t first = (size_t)(buffer->size - buffer->back);
+    if (first > count)
+        first = count;
+    memcpy(&buffer->buf[buffer->back], data, first);
+    memcpy(buffer->buf, &data[first], count - first);
+    buffer->back = (uint16_t)((buffer->back + count) % buffer->size);
+    return count;
+}
+
 static bool historyPut(CliHistory* history, const char* str) {
     size_t len = strlen(str);
     // each item is ended with \0 so, need to have that much space at least
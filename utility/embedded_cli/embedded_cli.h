@@ -267,6 +267,17 @@ bool embeddedCliAddBinding(EmbeddedCli* cli, CliCommandBinding binding);
  */
 bool embeddedCliDelBinding(EmbeddedCli* cli, const char* name);
 
+/**
+ * Enable or disable batch mode. In batch mode every received line is executed
+ * as command without echo, live autocompletion, invitation and history, so
+ * scripts with many commands can be passed via embeddedCliReceiveBuffer.
+ * Unfinished command is discarded when mode is changed. Can be called from
+ * command binding, remaining input is then processed in new mode.
+ * @param cli
+ * @param enable
+ */
+void embeddedCliSetBatchMode(EmbeddedCli* cli, bool enable);
+
 /**
  * Print specified string and account for currently entered but not
  * submitted command. Current command is deleted, provided string is printed
@@ -0,0 +1,250 @@
+// embedded_cli命令分发回归测试: 有序索引上的命令查找, 同名绑定先添加的优先,
+// 删除绑定后其余绑定仍能找到, help与-h, Tab补全候选按字母序列出,
+// 以及批处理模式逐行执行并可由命令切换回交互模式
+// 在工程根目录构建并运行:
+//   gcc -O1 -g -fsanitize=address,undefined -Iutility/embedded_cli/test -I.
+//       -Iutility/embedded_cli -Idebug/minctest
+//       utility/embedded_cli/embedded_cli.c
+//       utility/embedded_cli/test/embedded_cli_test.c -o embedded_cli_test
+//   ./embedded_cli_test
+// 全部通过时返回0
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "embedded_cli.h"
+#include "host_check.h"
+
+#define NCMDS 36
+#define OUT_SIZE 4096
+
+static char m_out[OUT_SIZE];
+static size_t m_out_len;
+static char m_names[NCMDS][8];
+static const char* m_called;  // 最后执行的绑定的context
+static char m_args[64];
+static int m_calls;
+static char m_unknown[16];  // onCommand收到的命令名
+
+static void write_char(EmbeddedCli* cli, char c) {
+    (void)cli;
+    if (m_out_len + 1 < OUT_SIZE) {
+        m_out[m_out_len++] = c;
+        m_out[m_out_len] = '\0';
+    }
+}
+
+static void out_reset(void) {
+    m_out_len = 0;
+    m_out[0] = '\0';
+    m_called = NULL;
+    m_args[0] = '\0';
+    m_calls = 0;
+    m_unknown[0] = '\0';
+}
+
+static void on_cmd(EmbeddedCli* cli, char* args, void* context) {
+    (void)cli;
+    m_called = context;
+    snprintf(m_args, sizeof(m_args), "%s", args);
+    m_calls++;
+}
+
+static void on_tokens(EmbeddedCli* cli, char* args, void* context) {
+    (void)cli;
+    m_called = context;
+    m_calls = embeddedCliGetTokenCount(args);
+    snprintf(m_args, sizeof(m_args), "%s", embeddedCliGetToken(args, 2));
+}
+
+static void on_unknown(EmbeddedCli* cli, CliCommand* command) {
+    (void)cli;
+    snprintf(m_unknown, sizeof(m_unknown), "%s", command->name);
+}
+
+static void on_batch_off(EmbeddedCli* cli, char* args, void* context) {
+    on_cmd(cli, args, context);
+    embeddedCliSetBatchMode(cli, false);
+}
+
+static bool add(EmbeddedCli* cli, const char* name, const char* ctx) {
+    CliCommandBinding b = {on_cmd, name, NULL, "test command", false,
+                           (void*)ctx};
+    return embeddedCliAddBinding(cli, b);
+}
+
+// 分块写入并处理, 使输入在接收缓冲区中回绕
+static void feed(EmbeddedCli* cli, const char* s) {
+    size_t len = strlen(s);
+    while (len) {
+        size_t n = len < 24 ? len : 24;
+        embeddedCliReceiveBuffer(cli, s, n);
+        embeddedCliProcess(cli);
+        s += n;
+        len -= n;
+    }
+}
+
+static EmbeddedCli* cli_new(void) {
+    EmbeddedCliConfig* config = embeddedCliDefaultConfig();
+    config->maxBindingCount = NCMDS + 8;
+    config->enableColorOutput = false;
+    EmbeddedCli* cli = embeddedCliNew(config);
+    CHECK(cli != NULL);
+    cli->writeChar = write_char;
+    return cli;
+}
+
+/* 乱序添加的绑定都能按名称找到, 找不到的交给onCommand */
+static EmbeddedCli* test_lookup(void) {
+    EmbeddedCli* cli = cli_new();
+    for (int i = 0; i < NCMDS; i++) {
+        int k = (i * 7) % NCMDS;  // 7与36互质, 覆盖全部名称
+        snprintf(m_names[k], sizeof(m_names[k]), "cmd%02d", k);
+        CHECK(add(cli, m_names[k], m_names[k]));
+    }
+    CHECK(add(cli, "set", "set"));
+    CHECK(add(cli, "settings", "settings"));
+    CHECK(add(cli, "setup", "setup"));
+    feed(cli, "");
+    for (int k = NCMDS - 1; k >= 0; k--) {
+        char line[32];
+        out_reset();
+        snprintf(line, sizeof(line), "%s  arg %d\r\n", m_names[k], k);
+        feed(cli, line);
+        CHECK(m_called == m_names[k] && m_calls == 1);
+        char args[16];
+        snprintf(args, sizeof(args), "arg %d", k);
+        CHECK(strcmp(m_args, args) == 0);
+    }
+    out_reset();
+    feed(cli, "cmd\n");  // 公共前缀不是命令
+    CHECK(m_called == NULL && strstr(m_out, "Command not found") != NULL);
+    cli->onCommand = on_unknown;
+    out_reset();
+    feed(cli, "cmd99 x\n");
+    CHECK(m_called == NULL && strcmp(m_unknown, "cmd99") == 0);
+    out_reset();
+    feed(cli, "setu\n");  // 唯一候选在回车时补全
+    CHECK(m_called != NULL && strcmp(m_called, "setup") == 0);
+    cli->onCommand = NULL;
+    return cli;
+}
+
+/* 同名绑定先添加的优先, 删除后由下一个接替; 删除后其余绑定不受影响 */
+static void test_duplicate_del(EmbeddedCli* cli) {
+    CHECK(add(cli, "dup", "first"));
+    CHECK(add(cli, "dup", "second"));
+    out_reset();
+    feed(cli, "dup\n");
+    CHECK(m_called != NULL && strcmp(m_called, "first") == 0);
+    CHECK(embeddedCliDelBinding(cli, "dup"));
+    out_reset();
+    feed(cli, "dup\n");
+    CHECK(m_called != NULL && strcmp(m_called, "second") == 0);
+    CHECK(embeddedCliDelBinding(cli, "dup"));
+    CHECK(!embeddedCliDelBinding(cli, "dup"));
+    CHECK(!embeddedCliDelBinding(cli, "cmd"));
+    CHECK(embeddedCliSwitchToCommandEntry(cli, "dup") == NULL);
+
+    // 删除的绑定位置由最后一个绑定填补
+    for (int k = 0; k < NCMDS; k += 5)
+        CHECK(embeddedCliDelBinding(cli, m_names[k]));
+    for (int k = 0; k < NCMDS; k++) {
+        char line[16];
+        out_reset();
+        snprintf(line, sizeof(line), "%s\n", m_names[k]);
+        feed(cli, line);
+        if (k % 5 == 0)
+            CHECK(m_called == NULL && strstr(m_out, "Command not found"));
+        else
+            CHECK(m_called == m_names[k]);
+        CHECK((embeddedCliSwitchToCommandEntry(cli, m_names[k]) != NULL) ==
+              (k % 5 != 0));
+    }
+    for (int k = 0; k < NCMDS; k += 5)
+        CHECK(add(cli, m_names[k], m_names[k]));
+}
+
+/* help <cmd>与<cmd> -h打印用法, 不执行命令 */
+static void test_help(EmbeddedCli* cli) {
+    out_reset();
+    feed(cli, "help cmd07\n");
+    CHECK(strstr(m_out, "CMD07 - test command") != NULL);
+    out_reset();
+    feed(cli, "cmd07 -h\n");
+    CHECK(m_called == NULL && strstr(m_out, "CMD07 - test command"));
+    out_reset();
+    feed(cli, "help nothing\n");
+    CHECK(strstr(m_out, "nothing: Command not found") != NULL);
+}
+
+/* Tab: 补全到公共前缀, 再按Tab按字母序列出候选 */
+static void test_autocomplete(EmbeddedCli* cli) {
+    out_reset();
+    feed(cli, "se\t");
+    CHECK(strstr(m_out, "set") != NULL);
+    out_reset();
+    feed(cli, "\t");
+    const char* a = strstr(m_out, "\r\nset\r\n");
+    const char* b = strstr(m_out, "\r\nsettings\r\n");
+    const char* c = strstr(m_out, "\r\nsetup\r\n");
+    CHECK(a && b && c && a < b && b < c);
+    out_reset();
+    feed(cli, "u\t\n");
+    CHECK(m_called != NULL && strcmp(m_called, "setup") == 0);
+    out_reset();
+    feed(cli, "cmd3\t\t");
+    for (int k = 30; k < NCMDS; k++) {
+        char name[16];
+        snprintf(name, sizeof(name), "\r\n%s\r\n", m_names[k]);
+        CHECK(strstr(m_out, name) != NULL);
+    }
+    feed(cli, "\b\b\b\b\n");
+}
+
+/* 批处理: 不回显, 逐行执行, 命令可切换回交互模式 */
+static void test_batch(EmbeddedCli* cli) {
+    CliCommandBinding tok = {on_tokens, "tok", NULL, NULL, true, "tok"};
+    CliCommandBinding off = {on_batch_off, "interactive", NULL, NULL, false,
+                             "interactive"};
+    CHECK(embeddedCliAddBinding(cli, tok));
+    CHECK(embeddedCliAddBinding(cli, off));
+    embeddedCliSetBatchMode(cli, true);
+    out_reset();
+    for (int round = 0; round < 10; round++) {  // 多次回绕接收缓冲区
+        for (int k = round; k < NCMDS; k += 9) {
+            char line[16];
+            snprintf(line, sizeof(line), "%s\r\n", m_names[k]);
+            m_called = NULL;
+            feed(cli, line);
+            CHECK(m_called == m_names[k]);
+        }
+    }
+    CHECK(m_out_len == 0);  // 没有回显和提示符
+    m_called = NULL;
+    feed(cli, "\n\r\n  \n");  // 空行被忽略
+    CHECK(m_called == NULL);
+    feed(cli, "tok a \"b c\" d\n");
+    CHECK(m_called != NULL && strcmp(m_called, "tok") == 0);
+    CHECK(m_calls == 3 && strcmp(m_args, "b c") == 0);
+    feed(cli, "cmdxx\n");
+    CHECK(strstr(m_out, "cmdxx: Command not found") != NULL);
+    CHECK(strstr(m_out, "CLI > ") == NULL);
+
+    // 切换命令之后的内容按交互模式处理
+    out_reset();
+    feed(cli, "interactive\ncmd01\n");
+    CHECK(m_called == m_names[1] && m_calls == 2);
+    CHECK(strstr(m_out, "CLI > c") != NULL);  // 提示符和回显
+}
+
+int main(void) {
+    EmbeddedCli* cli = test_lookup();
+    test_duplicate_del(cli);
+    test_help(cli);
+    test_autocomplete(cli);
+    test_batch(cli);
+    embeddedCliFree(cli);
+    return CHECK_RESULT();
+}
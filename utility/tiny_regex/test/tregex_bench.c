@@ -0,0 +1,173 @@
+// tiny_regex基准测试, 比较回溯匹配tregex_match_str与编译后的
+// tregex_exec/tregex_test
+// 在工程根目录构建并运行:
+//   gcc -O2 -Iutility/tiny_regex/test -I. -Iutility/tiny_regex
+//       utility/tiny_regex/tiny_regex.c utility/tiny_regex/test/tregex_bench.c
+//       -o tregex_bench
+//   ./tregex_bench [轮数]
+// 日志/AT指令行上的逐行匹配, 4KB文本的吞吐量, 以及回溯匹配在长数字串上
+// 的二次方耗时. tregex_match_str会打印调试信息, 计时期间输出重定向到
+// /dev/null
+// 两者的语义不同(编译后为最左最长匹配, 回溯匹配会在数字串等不匹配的行上
+// 报告命中), 命中行数不同的行只列出命中数, 不比较回溯匹配的耗时
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tiny_regex.h"
+
+#define BENCH_ROUNDS 20000
+#define BENCH_TEXT 4096
+
+static const char* const m_lines[] = {
+    "[   12.345] I/app: sensor temp=23.5 hum=41.2",
+    "[   12.351] W/net: retry 3 of 5, rssi=-87",
+    "[   12.400] E/drv: ERROR timeout on spi1 after 100 ms",
+    "2023-12-16 08:30:12.123 INFO boot complete in 532 ms",
+    "+CSQ: 23,99",
+    "+CREG: 0,1",
+    "OK",
+    "AT+CGATT?",
+    "+CME ERROR: 30",
+    "NO CARRIER",
+    "192.168.1.100 - - GET /status HTTP/1.1 200",
+    "[   13.002] D/ui: frame 1234 drawn in 16 ms, queue 2",
+};
+
+static const char* const m_patterns[] = {
+    "ERROR",
+    "ERROR|WARN",
+    "^\\+CSQ: \\d+,\\d+",
+    "\\d{4}-\\d{2}-\\d{2}",
+    "temp=\\d+\\.\\d",
+    "[A-Z]{3,5}\\d+",
+    "(\\d{1,3}\\.){3}\\d{1,3}",
+    "(\\+CME ERROR|\\+CMS ERROR|NO CARRIER|BUSY|NO ANSWER): ?\\d*",
+    "\\d{4}-\\d{2}-\\d{2} \\d{2}:\\d{2}:\\d{2}\\.\\d{3} (INFO|WARN|ERROR)",
+};
+
+#define NLINES (sizeof(m_lines) / sizeof(m_lines[0]))
+#define NPATTERNS (sizeof(m_patterns) / sizeof(m_patterns[0]))
+
+static char m_text[BENCH_TEXT + 1];
+static int m_stdout = -1;
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void mute(void) {
+    fflush(stdout);
+    m_stdout = dup(STDOUT_FILENO);
+    if (freopen("/dev/null", "w", stdout) == NULL)
+        exit(EXIT_FAILURE);
+}
+
+static void unmute(void) {
+    fflush(stdout);
+    dup2(m_stdout, STDOUT_FILENO);
+    close(m_stdout);
+}
+
+static void bench_lines(unsigned rounds) {
+    printf("%-58s %5s %8s %8s %8s\n", "pattern", "hits", "old ns", "exec ns",
+           "test ns");  // hits: 编译匹配/回溯匹配每轮命中的行数
+    for (size_t i = 0; i < NPATTERNS; i++) {
+        tr_prog_t* prog = tregex_compile(m_patterns[i], 0);
+        unsigned hits = 0, old_hits = 0, test_hits = 0;
+        mute();
+        uint64_t t0 = host_ns();
+        for (unsigned r = 0; r < rounds; r++) {
+            for (size_t k = 0; k < NLINES; k++) {
+                tr_res_t a = tregex_match_str(m_lines[k], 0, m_patterns[i], 0);
+                old_hits += a.Data != NULL;
+            }
+        }
+        uint64_t t1 = host_ns();
+        unmute();
+        for (unsigned r = 0; r < rounds; r++) {
+            for (size_t k = 0; k < NLINES; k++)
+                hits += tregex_exec(prog, m_lines[k], 0).Data != NULL;
+        }
+        uint64_t t2 = host_ns();
+        for (unsigned r = 0; r < rounds; r++) {
+            for (size_t k = 0; k < NLINES; k++)
+                test_hits += tregex_test(prog, m_lines[k], 0);
+        }
+        uint64_t t3 = host_ns();
+        double n = (double)rounds * NLINES;
+        printf("%-58s %2u/%-2u ", m_patterns[i], hits / rounds,
+               old_hits / rounds);
+        if (hits == old_hits)
+            printf("%8.0f", (t1 - t0) / n);
+        else
+            printf("%8s", "-");  // 结果不同, 耗时没有可比性
+        printf(" %8.0f %8.0f%s%s\n", (t2 - t1) / n, (t3 - t2) / n,
+               hits == old_hits ? "" : "  differ",
+               hits == test_hits ? "" : "  MISMATCH");
+        tregex_free(prog);
+    }
+}
+
+static void bench_text(void) {
+    const unsigned rounds = 200;
+    for (size_t k = 0; k < BENCH_TEXT; k++)
+        m_text[k] = "abcdefghij klmnop 0123456789 :.,=-"[(k * 7 + k / 13) % 34];
+    for (size_t i = 0; i < NPATTERNS; i++) {
+        if (m_patterns[i][0] == '^') {  // 只检查开头, 吞吐量没有意义
+            printf("%-58s 4KB test  anchored, n/a\n", m_patterns[i]);
+            continue;
+        }
+        tr_prog_t* prog = tregex_compile(m_patterns[i], 0);
+        unsigned hits = 0;
+        uint64_t start = host_ns();
+        for (unsigned r = 0; r < rounds; r++)
+            hits += tregex_test(prog, m_text, BENCH_TEXT);
+        uint64_t ns = host_ns() - start;
+        printf("%-58s 4KB test %7.1f MB/s (hit %u)\n", m_patterns[i],
+               rounds * 1000.0 * BENCH_TEXT / ns, hits / rounds);
+        tregex_free(prog);
+    }
+}
+
+/* 不匹配的长数字串: 回溯匹配逐个起点重试, 编译后的匹配为线性时间.
+   回溯匹配在这些串上会误报命中, 此时标记differ */
+static void bench_worst(void) {
+    static const char* const pats[] = {
+        "\\d+x",
+        "\\d{1,3}\\.\\d{1,3}\\.\\d{1,3}\\.\\d{1,3}x",
+    };
+    for (int n = 1024; n <= BENCH_TEXT; n *= 2) {
+        memset(m_text, '1', n);
+        m_text[n] = '\0';
+        for (size_t i = 0; i < 2; i++) {
+            tr_prog_t* prog = tregex_compile(pats[i], 0);
+            mute();
+            uint64_t t0 = host_ns();
+            tr_res_t a = tregex_match_str(m_text, n, pats[i], 0);
+            uint64_t t1 = host_ns();
+            unmute();
+            tr_res_t b = tregex_exec(prog, m_text, n);
+            uint64_t t2 = host_ns();
+            printf("%-40s n=%4d old %9.1f us (%s)  exec %6.1f us (%s)%s\n",
+                   pats[i], n, (t1 - t0) / 1000.0, a.Data ? "hit" : "miss",
+                   (t2 - t1) / 1000.0, b.Data ? "hit" : "miss",
+                   !a.Data == !b.Data ? "" : "  differ");
+            tregex_free(prog);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    unsigned rounds = argc > 1 ? (unsigned)atoi(argv[1]) : BENCH_ROUNDS;
+    if (rounds == 0)
+        rounds = BENCH_ROUNDS;
+    bench_lines(rounds);
+    bench_text();
+    bench_worst();
+    return 0;
+}
@@ -0,0 +1,214 @@
+// tiny_regex编译匹配器回归测试: 固定用例, 以及与glibc regex(POSIX ERE,
+// 最左最长匹配)的随机差分比较
+// 在工程根目录构建并运行(需要glibc的regex.h):
+//   gcc -O1 -g -fsanitize=address,undefined -Iutility/tiny_regex/test -I.
+//       -Iutility/tiny_regex -Idebug/minctest utility/tiny_regex/tiny_regex.c
+//       utility/tiny_regex/test/tregex_test.c -o tregex_test
+//   ./tregex_test [随机模式数量] [随机种子]
+// 全部通过时返回0. 随机模式含字符/类/转义/分组/量词/选择/锚点,
+// 同时生成等价的ERE交给regcomp, 每个模式匹配20个随机字符串,
+// 比较是否匹配, 匹配位置和长度, 以及tregex_test与tregex_exec是否一致
+#include <regex.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host_check.h"
+#include "tiny_regex.h"
+
+#define TEST_PATTERNS 100000
+#define TEST_SUBJECTS 20
+#define NO_MATCH -1
+#define BAD_PATTERN -2
+
+typedef struct {
+    const char* pattern;
+    const char* subject;
+    int so, eo;  // 期望的匹配区间, 或NO_MATCH/BAD_PATTERN
+} edge_t;
+
+static const edge_t m_edges[] = {
+    {"a$$", "xa", 1, 2},
+    {"^^a", "ab", 0, 1},
+    {"^$", "", 0, 0},
+    {"^$", "a", NO_MATCH, 0},
+    {"$", "abc", 3, 3},
+    {"\\+CSQ: \\d+,\\d+", "\r\n+CSQ: 23,99\r\n", 2, 13},
+    {"^\\+CSQ: \\d+,\\d+", "+CSQ: 23,99", 0, 11},
+    {"[]a]+", "x]a]y", 1, 4},
+    {"[^]]+", "]]ab]", 2, 4},
+    {"\\d{4}-\\d{1,2}-\\d{1,2}", "Today is the 2023-12-16", 13, 23},
+    {"ERROR|WARN", "[12] WARN: low battery", 5, 9},
+    {"a{0}", "aaa", 0, 0},
+    {"(ab){2,}", "xabababy", 1, 7},
+    {"\\s+", "a \t b", 1, 4},
+    {"[a-c\\d]+", "zz1b2x", 2, 5},
+    {"(a|b)*abb", "babaabbab", 0, 7},
+    {"((((((((a))))))))", "a", 0, 1},
+    {"(((((((((a)))))))))", "a", BAD_PATTERN, 0},  // 超过嵌套深度
+    {"a{200}", "a", BAD_PATTERN, 0},               // 超过位置数量
+    {"*a", "a", BAD_PATTERN, 0},
+    {"a{3,1}", "a", BAD_PATTERN, 0},
+    {"(a", "a", BAD_PATTERN, 0},
+    {"a)", "a", BAD_PATTERN, 0},
+    {"[a", "a", BAD_PATTERN, 0},
+    {"a{", "a", BAD_PATTERN, 0},
+    {"\\", "a", BAD_PATTERN, 0},
+};
+
+static void test_edges(void) {
+    for (size_t i = 0; i < sizeof(m_edges) / sizeof(m_edges[0]); i++) {
+        const edge_t* e = &m_edges[i];
+        tr_prog_t* prog = tregex_compile(e->pattern, 0);
+        int so = BAD_PATTERN, eo = 0;
+        if (prog != NULL) {
+            tr_res_t r = tregex_exec(prog, e->subject, 0);
+            so = r.Data ? (int)(r.Data - e->subject) : NO_MATCH;
+            eo = r.Data ? so + (int)r.Size : 0;
+            CHECK(tregex_test(prog, e->subject, 0) == (r.Data != NULL));
+            tregex_free(prog);
+        }
+        if (so != e->so || eo != e->eo)
+            CHECK_FAIL("/%s/ got %d,%d expect %d,%d", e->pattern, so, eo, e->so,
+                       e->eo);
+    }
+}
+
+static char m_pat[512], m_ere[2048];  // 生成的模式与等价的ERE
+static int m_plen, m_elen;
+
+static unsigned rnd(unsigned n) {
+    return (unsigned)rand() % n;
+}
+
+static void put(const char* pat, const char* ere) {
+    m_plen += sprintf(m_pat + m_plen, "%s", pat);
+    m_elen += sprintf(m_ere + m_elen, "%s", ere);
+}
+
+static int gen(int depth);
+
+/* 生成一个原子, 返回其占用位置数的上限 */
+static int gen_atom(int depth) {
+    static const char* const cls[] = {"[ab]", "[^a]", "[a-c1]", "[\\d-]"};
+    static const char* const cls_ere[] = {"[ab]", "[^a]", "[a-c1]", "[0-9-]"};
+    switch (rnd(depth > 2 ? 8 : 11)) {
+        case 0:
+        case 1:
+        case 2:
+        case 3: {
+            char c[2] = {"ab-1"[rnd(4)], '\0'};
+            put(c, c);
+            return 1;
+        }
+        case 4:
+            put("\\d", "[0-9]");
+            return 1;
+        case 5:
+            put(".", "[^\r\n]");
+            return 1;
+        case 6: {
+            int k = rnd(4);
+            put(cls[k], cls_ere[k]);
+            return 1;
+        }
+        case 7:
+            put("\\w", "[0-9A-Za-z_]");
+            return 1;
+        default: {
+            put("(", "(");
+            int n = gen(depth + 1);
+            put(")", ")");
+            return n;
+        }
+    }
+}
+
+/* 生成一个模式, 返回编译后位置数的上限({m,n}按展开n份另加一份计算) */
+static int gen(int depth) {
+    int n = 1 + rnd(3), pos = 0;
+    for (int i = 0; i < n; i++) {
+        if (depth == 0 && i == 0 && rnd(8) == 0)
+            put("^", "^");
+        int atom = gen_atom(depth);
+        switch (rnd(9)) {
+            case 0:
+                put("*", "*");
+                break;
+            case 1:
+                put("+", "+");
+                break;
+            case 2:
+                put("?", "?");
+                break;
+            case 3: {
+                char b[16];
+                int lo = rnd(3), hi = lo + rnd(3);
+                if (rnd(3) == 0)
+                    sprintf(b, "{%d,}", lo);
+                else if (rnd(2))
+                    sprintf(b, "{%d}", lo + 1);
+                else
+                    sprintf(b, "{%d,%d}", lo, hi);
+                put(b, b);
+                atom *= hi + 2;
+                break;
+            }
+        }
+        pos += atom;
+        if (depth == 0 && i == n - 1 && rnd(8) == 0)
+            put("$", "$");
+    }
+    if (rnd(5) == 0) {
+        put("|", "|");
+        pos += gen(depth ? depth + 1 : 0);
+    }
+    return pos;
+}
+
+static void test_glibc(long patterns) {
+    for (long it = 0; it < patterns; it++) {
+        regex_t re;
+        m_plen = m_elen = 0;
+        int positions = gen(0);
+        if (regcomp(&re, m_ere, REG_EXTENDED))
+            continue;
+        tr_prog_t* prog = tregex_compile(m_pat, 0);
+        if (prog == NULL) {  // 只有可能超出位置数量的模式允许编译失败
+            if (positions <= TINY_REGEX_CONFIG_MAX_POSITIONS)
+                CHECK_FAIL("compile failed: /%s/", m_pat);
+            regfree(&re);
+            continue;
+        }
+        for (int k = 0; k < TEST_SUBJECTS; k++) {
+            char s[40];
+            int n = rnd(sizeof(s) - 1);
+            for (int j = 0; j < n; j++)
+                s[j] = "ab1-c7\n"[rnd(7)];
+            s[n] = '\0';
+            regmatch_t m = {-1, -1};
+            bool expect = regexec(&re, s, 1, &m, 0) == 0;
+            tr_res_t r = tregex_exec(prog, s, n);
+            bool got = r.Data != NULL;
+            CHECK(tregex_test(prog, s, n) == got);
+            if (got != expect ||
+                (got && (r.Data - s != m.rm_so ||
+                         (int)r.Size != m.rm_eo - m.rm_so)))
+                CHECK_FAIL("/%s/ (ERE %s) on \"%s\": glibc %d [%d,%d) "
+                           "got %d [%d,%d)",
+                           m_pat, m_ere, s, expect, (int)m.rm_so, (int)m.rm_eo,
+                           got, got ? (int)(r.Data - s) : -1,
+                           got ? (int)(r.Data - s + r.Size) : -1);
+        }
+        tregex_free(prog);
+        regfree(&re);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    long patterns = argc > 1 ? atol(argv[1]) : TEST_PATTERNS;
+    srand(argc > 2 ? atoi(argv[2]) : 1);
+    test_edges();
+    test_glibc(patterns);
+    return CHECK_RESULT();
+}
@@ -663,3 +663,1037 @@ static inline pat_size_t __getItemEndPos(const char* _pattern,
 }
 
 #endif
+
+#if TINY_REGEX_CONFIG_COMPILE_ENABLE == 1
+/*--------------------------------------------------------------------
+ Compiled pattern
+
+ The pattern is compiled to a Glushkov NFA: every character or class of
+ the pattern is a position, and the NFA records which positions can start
+ or end a match and which positions can follow each position. '^' and '$'
+ are positions which only accept the virtual symbols before and after the
+ string, so the anchors need no special case while matching.
+
+ Patterns with few positions are matched by Shift-And, the state is one
+ word and a step is a few table lookups. Larger patterns are matched by a
+ DFA built lazily from the NFA with a bounded cache of states. Both are
+ linear in the length of the string, there is no backtracking.
+
+ The leftmost-longest match is found by three scans: a forward scan tells
+ whether the string matches and how far the matches can reach, a reverse
+ scan finds the leftmost start of the matches, and an anchored forward
+ scan from that start finds the longest end. Only the first scan runs on
+ every string, so the lazy DFA is kept for it, the other two simulate the
+ NFA directly.
+--------------------------------------------------------------------*/
+#include "modules.h"
+
+// DEFINE -------------------
+#define TR_SYM_BOL 0x01  // '^', accepts the symbol before string
+#define TR_SYM_EOL 0x02  // '$', accepts the symbol after string
+
+#define TR_DFA_INIT 0x01    // a match can start at the next symbol
+#define TR_DFA_STICKY 0x02  // keep TR_DFA_INIT on every step (unanchored)
+#define TR_DFA_KEY 0x03     // flags that identify a state with its set
+#define TR_DFA_ACCEPT 0x08  // a match ends at the symbol
+#define TR_DFA_DEAD 0x10    // no match can continue
+
+#define TR_REPEAT_INF 0xFFFF
+#define TR_NOT_FOUND 0xFFFFFFFF
+
+// TYPEDEF ------------------------------
+
+typedef struct {
+    const char* Pat;
+    uint8_t Build;  // 0:only count the positions, 1:build the NFA
+    uint8_t Err;
+    uint8_t Depth;
+    uint16_t Words;    // words of a position set
+    uint16_t NPos;     // positions created
+    uint32_t* Cls;     // byte set of each position, 8 words each
+    uint8_t* Sym;      // TR_SYM_* of each position
+    uint32_t* Follow;  // positions which can follow each position
+} tr_compiler_t;
+
+typedef struct {
+    uint8_t Nullable;
+    uint32_t* First;  // positions which can start the item, NULL if count
+    uint32_t* Last;   // positions which can end the item
+} tr_frag_t;
+
+struct tr_prog {
+    uint16_t NPos;
+    uint16_t NCls;  // byte classes + BOL + EOL
+    uint16_t Words;
+    uint8_t Nullable;
+    uint8_t Bol;  // every match starts with '^'
+    uint8_t ShiftAnd;
+    uint8_t CMap[256];  // class of each byte
+    uint32_t* First;
+    uint32_t* Last;
+    uint32_t* Match;  // positions which accept each class
+    uint32_t* Fwd;    // Shift-And:nibble tables of Follow, DFA:Follow
+    uint32_t* Rev;    // the same of the reversed NFA
+    /* lazy DFA */
+    uint16_t NState;
+    uint16_t Gen;     // increased when the cache is flushed
+    uint16_t Start;   // start state + 1, 0 if not built
+    uint8_t* DFlag;   // TR_DFA_* of each state
+    uint32_t* DSet;   // position set of each state
+    uint16_t* DNext;  // next state + 1 of each class, 0 if not built
+    uint32_t* Tmp;
+    uint32_t* Cur;  // state of the NFA simulation
+};
+
+// FUNCTION DECLARATION ---------------
+
+static void __parseAlt(tr_compiler_t* _c, pat_size_t* _i, pat_size_t _end,
+                       tr_frag_t* _f);
+static void __parseConcat(tr_compiler_t* _c, pat_size_t* _i,
+                          pat_size_t _end, tr_frag_t* _f);
+
+/*
+ *  position sets
+ */
+static inline void __setOr(uint32_t* _d, const uint32_t* _s, uint16_t _w) {
+    while (_w--) {
+        *_d++ |= *_s++;
+    }
+}
+
+static inline uint8_t __setAny(const uint32_t* _s, const uint32_t* _m,
+                               uint16_t _w) {
+    while (_w--) {
+        if (*_s++ & *_m++) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static inline uint8_t __setEmpty(const uint32_t* _s, uint16_t _w) {
+    while (_w--) {
+        if (*_s++) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* _d |= _tab[p] for every position p in _s */
+static void __setFollow(uint32_t* _d, const uint32_t* _tab,
+                        const uint32_t* _s, uint16_t _w) {
+    uint16_t i, b;
+    uint32_t v;
+    for (i = 0; i < _w; i++) {
+        for (v = _s[i], b = 0; v; v >>= 1, b++) {
+            if (v & 1) {
+                __setOr(_d, _tab + (uint32_t)(i * 32 + b) * _w, _w);
+            }
+        }
+    }
+}
+
+static inline void __clsAdd(uint32_t* _cls, uint8_t _lo, uint8_t _hi) {
+    uint16_t c;
+    for (c = _lo; c <= _hi; c++) {
+        _cls[c >> 5] |= 1UL << (c & 31);
+    }
+}
+
+/*
+ *  fragments of the NFA
+ */
+static void __fragInit(tr_compiler_t* _c, tr_frag_t* _f) {
+    _f->Nullable = 1;
+    _f->First = NULL;
+    _f->Last = NULL;
+    if (_c->Build && !_c->Err) {
+        _f->First = (uint32_t*)m_alloc(_c->Words * 2 * sizeof(uint32_t));
+        if (_f->First == NULL) {
+            _c->Err = 1;
+            return;
+        }
+        memset(_f->First, 0, _c->Words * 2 * sizeof(uint32_t));
+        _f->Last = _f->First + _c->Words;
+    }
+}
+
+static void __fragFree(tr_frag_t* _f) {
+    if (_f->First != NULL) {
+        m_free(_f->First);
+        _f->First = NULL;
+        _f->Last = NULL;
+    }
+}
+
+/* every position which ends _last can be followed by the ones in _first */
+static void __fragLink(tr_compiler_t* _c, const uint32_t* _last,
+                       const uint32_t* _first) {
+    uint16_t i, b, w = _c->Words;
+    uint32_t v;
+    for (i = 0; i < w; i++) {
+        for (v = _last[i], b = 0; v; v >>= 1, b++) {
+            if (v & 1) {
+                __setOr(_c->Follow + (uint32_t)(i * 32 + b) * w, _first, w);
+            }
+        }
+    }
+}
+
+/* _a = _a _b, _b is freed */
+static void __fragCat(tr_compiler_t* _c, tr_frag_t* _a, tr_frag_t* _b) {
+    if (_a->First != NULL && _b->First != NULL) {
+        __fragLink(_c, _a->Last, _b->First);
+        if (_a->Nullable) {
+            __setOr(_a->First, _b->First, _c->Words);
+        }
+        if (!_b->Nullable) {
+            memcpy(_a->Last, _b->Last, _c->Words * sizeof(uint32_t));
+        } else {
+            __setOr(_a->Last, _b->Last, _c->Words);
+        }
+    }
+    _a->Nullable &= _b->Nullable;
+    __fragFree(_b);
+}
+
+/* _a = _a|_b, _b is freed */
+static void __fragAlt(tr_compiler_t* _c, tr_frag_t* _a, tr_frag_t* _b) {
+    if (_a->First != NULL && _b->First != NULL) {
+        __setOr(_a->First, _b->First, _c->Words);
+        __setOr(_a->Last, _b->Last, _c->Words);
+    }
+    _a->Nullable |= _b->Nullable;
+    __fragFree(_b);
+}
+
+/* _f = _f+ */
+static void __fragPlus(tr_compiler_t* _c, tr_frag_t* _f) {
+    if (_f->First != NULL) {
+        __fragLink(_c, _f->Last, _f->First);
+    }
+}
+
+static void __fragPos(tr_compiler_t* _c, tr_frag_t* _f, const uint32_t* _cls,
+                      uint8_t _sym) {
+    __fragInit(_c, _f);
+    _f->Nullable = 0;
+    if (_c->Err) {
+        return;
+    }
+    if (_c->NPos >= TINY_REGEX_CONFIG_MAX_POSITIONS) {
+        _c->Err = 1;
+        return;
+    }
+    if (_f->First != NULL) {
+        memcpy(_c->Cls + _c->NPos * 8, _cls, 8 * sizeof(uint32_t));
+        _c->Sym[_c->NPos] = _sym;
+        _f->First[_c->NPos >> 5] |= 1UL << (_c->NPos & 31);
+        _f->Last[_c->NPos >> 5] |= 1UL << (_c->NPos & 31);
+    }
+    _c->NPos++;
+}
+
+/*
+ *  parser
+ */
+
+/* '\d' '\w' '\s' and their inverted class, or a escaped character */
+static void __parseEscape(char _e, uint32_t* _cls) {
+    uint32_t tmp[8] = {0};
+    uint8_t i, inv = 0;
+    switch (_e) {
+        case 'D':
+            inv = 1;
+            /* fall through */
+        case 'd':
+            __clsAdd(tmp, '0', '9');
+            break;
+        case 'W':
+            inv = 1;
+            /* fall through */
+        case 'w':
+            __clsAdd(tmp, '0', '9');
+            __clsAdd(tmp, 'A', 'Z');
+            __clsAdd(tmp, 'a', 'z');
+            __clsAdd(tmp, '_', '_');
+            break;
+        case 'S':
+            inv = 1;
+            /* fall through */
+        case 's':
+            __clsAdd(tmp, '\t', '\r');  // \t \n \v \f \r
+            __clsAdd(tmp, ' ', ' ');
+            break;
+        case 't':
+            __clsAdd(tmp, '\t', '\t');
+            break;
+        case 'n':
+            __clsAdd(tmp, '\n', '\n');
+            break;
+        case 'r':
+            __clsAdd(tmp, '\r', '\r');
+            break;
+        case 'f':
+            __clsAdd(tmp, '\f', '\f');
+            break;
+        case 'v':
+            __clsAdd(tmp, '\v', '\v');
+            break;
+        default:
+            __clsAdd(tmp, (uint8_t)_e, (uint8_t)_e);
+            break;
+    }
+    for (i = 0; i < 8; i++) {
+        _cls[i] |= inv ? ~tmp[i] : tmp[i];
+    }
+}
+
+/* '[...]' and '[^...]', _i is after '[' */
+static void __parseBracket(tr_compiler_t* _c, pat_size_t* _i,
+                           pat_size_t _end, uint32_t* _cls) {
+    const char* pat = _c->Pat;
+    uint32_t tmp[8] = {0};
+    uint8_t i, inv = 0, lo, hi;
+    pat_size_t start;
+    if (*_i < _end && pat[*_i] == '^') {
+        inv = 1;
+        (*_i)++;
+    }
+    start = *_i;
+    while (*_i < _end && (pat[*_i] != ']' || *_i == start)) {
+        if (pat[*_i] == '\\' && *_i + 1 < _end) {
+            uint32_t esc[8] = {0};
+            __parseEscape(pat[*_i + 1], esc);
+            *_i += 2;
+            for (i = 0; i < 8; i++) {
+                tmp[i] |= esc[i];
+            }
+            continue;
+        }
+        lo = (uint8_t)pat[(*_i)++];
+        hi = lo;
+        if (*_i + 1 < _end && pat[*_i] == '-' && pat[*_i + 1] != ']') {
+            hi = (uint8_t)pat[*_i + 1];
+            *_i += 2;
+            if (hi < lo) {
+                _c->Err = 1;
+                return;
+            }
+        }
+        __clsAdd(tmp, lo, hi);
+    }
+    if (*_i >= _end) {
+        _c->Err = 1;  // no ']'
+        return;
+    }
+    (*_i)++;
+    for (i = 0; i < 8; i++) {
+        _cls[i] = inv ? ~tmp[i] : tmp[i];
+    }
+}
+
+static void __parseAtom(tr_compiler_t* _c, pat_size_t* _i, pat_size_t _end,
+                        tr_frag_t* _f) {
+    const char* pat = _c->Pat;
+    uint32_t cls[8] = {0};
+    uint8_t sym = 0;
+    switch (pat[*_i]) {
+        case '(':
+            if (_c->Depth >= TINY_REGEX_CONFIG_DEPTH_LEVEL) {
+                _c->Err = 1;
+                __fragInit(_c, _f);
+                return;
+            }
+            (*_i)++;
+            _c->Depth++;
+            __parseAlt(_c, _i, _end, _f);
+            _c->Depth--;
+            if (*_i >= _end || pat[*_i] != ')') {
+                _c->Err = 1;
+                return;
+            }
+            (*_i)++;
+            return;
+        case '[':
+            (*_i)++;
+            __parseBracket(_c, _i, _end, cls);
+            break;
+        case '.':
+            (*_i)++;
+            __clsAdd(cls, 0x00, 0xFF);
+#if TINY_REGEX_CONFIG_DOT_IGNORE_NEWLINE == 1
+            cls[0] &= ~((1UL << '\r') | (1UL << '\n'));
+#endif
+            break;
+        case '\\':
+            if (*_i + 1 >= _end) {
+                _c->Err = 1;
+                break;
+            }
+            __parseEscape(pat[*_i + 1], cls);
+            *_i += 2;
+            break;
+        case '^':
+            (*_i)++;
+            sym = TR_SYM_BOL;
+            break;
+        case '$':
+            (*_i)++;
+            sym = TR_SYM_EOL;
+            break;
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+            _c->Err = 1;  // nothing to repeat
+            break;
+        default:
+            __clsAdd(cls, (uint8_t)pat[*_i], (uint8_t)pat[*_i]);
+            (*_i)++;
+            break;
+    }
+    __fragPos(_c, _f, cls, sym);
+}
+
+/* '{n}' '{n,}' '{,m}' '{n,m}', _i is at '{' */
+static uint8_t __parseBraces(const char* _pat, pat_size_t* _i,
+                             pat_size_t _end, uint16_t* _min,
+                             uint16_t* _max) {
+    uint32_t val = 0;
+    uint8_t digits = 0;
+    pat_size_t i = *_i + 1;
+    for (; i < _end && _pat[i] >= '0' && _pat[i] <= '9'; i++, digits++) {
+        val = val * 10 + (_pat[i] - '0');
+        if (val >= TR_REPEAT_INF) {
+            return 0;
+        }
+    }
+    *_min = (uint16_t)val;
+    *_max = (uint16_t)val;
+    if (i < _end && _pat[i] == ',') {
+        *_max = TR_REPEAT_INF;
+        for (i++, val = 0; i < _end && _pat[i] >= '0' && _pat[i] <= '9';
+             i++, digits++) {
+            val = val * 10 + (_pat[i] - '0');
+            if (val >= TR_REPEAT_INF) {
+                return 0;
+            }
+            *_max = (uint16_t)val;
+        }
+    }
+    if (i >= _end || _pat[i] != '}' || digits == 0 || *_max < *_min) {
+        return 0;
+    }
+    *_i = i + 1;
+    return 1;
+}
+
+/*
+ * _f is the first copy of the item in [_start, _q), the other copies are
+ * compiled by parsing the item again: x{2,4} is xxx?x?, x{2,} is xx+
+ */
+static void __repeatRange(tr_compiler_t* _c, pat_size_t _start,
+                          pat_size_t _q, uint16_t _min, uint16_t _max,
+                          tr_frag_t* _f) {
+    uint16_t k, total = _max;
+    if (_max == TR_REPEAT_INF) {
+        total = _min ? _min : 1;
+    }
+    if (total == 0) {
+        __fragFree(_f);
+        __fragInit(_c, _f);
+        return;
+    }
+    if (_min == 0) {
+        _f->Nullable = 1;
+    }
+    if (_max == TR_REPEAT_INF && total == 1) {
+        __fragPlus(_c, _f);
+    }
+    for (k = 1; k < total && !_c->Err; k++) {
+        tr_frag_t copy;
+        pat_size_t i = _start;
+        __parseConcat(_c, &i, _q, &copy);
+        if (k >= _min) {
+            copy.Nullable = 1;
+        }
+        if (_max == TR_REPEAT_INF && k + 1 == total) {
+            __fragPlus(_c, &copy);
+        }
+        __fragCat(_c, _f, &copy);
+    }
+}
+
+static void __parseRepeat(tr_compiler_t* _c, pat_size_t* _i,
+                          pat_size_t _end, tr_frag_t* _f) {
+    const char* pat = _c->Pat;
+    pat_size_t start = *_i, q;
+    uint16_t min, max;
+    __parseAtom(_c, _i, _end, _f);
+    while (!_c->Err && *_i < _end) {
+        switch (pat[*_i]) {
+            case '*':
+                __fragPlus(_c, _f);
+                _f->Nullable = 1;
+                break;
+            case '+':
+                __fragPlus(_c, _f);
+                break;
+            case '?':
+                _f->Nullable = 1;
+                break;
+            case '{':
+                q = *_i;
+                if (!__parseBraces(pat, _i, _end, &min, &max)) {
+                    _c->Err = 1;
+                    return;
+                }
+                __repeatRange(_c, start, q, min, max, _f);
+                continue;
+            default:
+                return;
+        }
+        (*_i)++;
+    }
+}
+
+static void __parseConcat(tr_compiler_t* _c, pat_size_t* _i,
+                          pat_size_t _end, tr_frag_t* _f) {
+    __fragInit(_c, _f);
+    while (!_c->Err && *_i < _end && _c->Pat[*_i] != '|' &&
+           _c->Pat[*_i] != ')') {
+        tr_frag_t item;
+        __parseRepeat(_c, _i, _end, &item);
+        __fragCat(_c, _f, &item);
+    }
+}
+
+static void __parseAlt(tr_compiler_t* _c, pat_size_t* _i, pat_size_t _end,
+                       tr_frag_t* _f) {
+    __parseConcat(_c, _i, _end, _f);
+    while (!_c->Err && *_i < _end && _c->Pat[*_i] == '|') {
+        tr_frag_t alt;
+        (*_i)++;
+        __parseConcat(_c, _i, _end, &alt);
+        __fragAlt(_c, _f, &alt);
+    }
+}
+
+/*
+ *  build the program from the NFA
+ */
+
+/*
+ * only one symbol is before or after the string, so a position followed by
+ * '$' is also followed by the '$' which can follow that '$', as in 'a$$',
+ * and the same for '^'
+ */
+static void __closeAnchors(tr_compiler_t* _c, uint32_t* _first) {
+    uint16_t p, e, q, w = _c->Words, npos = _c->NPos;
+    uint32_t* set;
+    const uint32_t* fol;
+    uint8_t changed = 1;
+    for (p = 0, q = 0; p < npos; p++) {
+        q += _c->Sym[p] != 0;
+    }
+    while (q > 1 && changed) {
+        changed = 0;
+        for (p = 0; p <= npos; p++) {
+            set = (p == npos) ? _first : _c->Follow + (uint32_t)p * w;
+            for (e = 0; e < npos; e++) {
+                if (!_c->Sym[e] || !((set[e >> 5] >> (e & 31)) & 1)) {
+                    continue;
+                }
+                fol = _c->Follow + (uint32_t)e * w;
+                for (q = 0; q < npos; q++) {
+                    if (_c->Sym[q] == _c->Sym[e] &&
+                        ((fol[q >> 5] >> (q & 31)) & 1) &&
+                        !((set[q >> 5] >> (q & 31)) & 1)) {
+                        set[q >> 5] |= 1UL << (q & 31);
+                        changed = 1;
+                    }
+                }
+            }
+        }
+        q = 2;
+    }
+}
+
+/* bytes accepted by the same positions share a class */
+static uint16_t __buildClasses(const tr_compiler_t* _c, uint8_t* _cmap) {
+    uint16_t remap[512];
+    uint16_t p, b, key, ncls = 1;
+    memset(_cmap, 0, 256);
+    for (p = 0; p < _c->NPos; p++) {
+        const uint32_t* cls = _c->Cls + p * 8;
+        memset(remap, 0xFF, sizeof(remap));
+        for (b = 0, ncls = 0; b < 256; b++) {
+            key = _cmap[b] * 2 + ((cls[b >> 5] >> (b & 31)) & 1);
+            if (remap[key] == 0xFFFF) {
+                remap[key] = ncls++;
+            }
+            _cmap[b] = (uint8_t)remap[key];
+        }
+    }
+    return ncls;
+}
+
+static tr_prog_t* __buildProg(const tr_compiler_t* _c, const tr_frag_t* _root) {
+    tr_prog_t* prog;
+    uint8_t cmap[256];
+    uint16_t ncls = __buildClasses(_c, cmap) + 2;
+    uint16_t w = _c->Words, npos = _c->NPos, p, q, k, b;
+    uint8_t shiftand = npos <= TINY_REGEX_CONFIG_SHIFT_AND_MAX;
+    uint32_t ntab = shiftand ? (uint32_t)(npos + 3) / 4 * 16
+                             : (uint32_t)npos * w;
+    uint32_t nstate = shiftand ? 0 : TINY_REGEX_CONFIG_DFA_STATES;
+    uint32_t words = w * 2 + (uint32_t)ncls * w + ntab * 2 +
+                     (shiftand ? 0 : nstate * w + w * 2);
+    size_t size = sizeof(tr_prog_t) + words * sizeof(uint32_t) +
+                  nstate * ncls * sizeof(uint16_t) + nstate;
+    uint32_t* mem;
+
+    prog = (tr_prog_t*)m_alloc(size);
+    if (prog == NULL) {
+        return NULL;
+    }
+    memset(prog, 0, size);
+    mem = (uint32_t*)(prog + 1);
+    prog->NPos = npos;
+    prog->NCls = ncls;
+    prog->Words = w;
+    prog->Nullable = _root->Nullable;
+    prog->ShiftAnd = shiftand;
+    memcpy(prog->CMap, cmap, sizeof(cmap));
+    prog->First = mem;
+    prog->Last = prog->First + w;
+    prog->Match = prog->Last + w;
+    prog->Fwd = prog->Match + (uint32_t)ncls * w;
+    prog->Rev = prog->Fwd + ntab;
+    memcpy(prog->First, _root->First, w * sizeof(uint32_t));
+    memcpy(prog->Last, _root->Last, w * sizeof(uint32_t));
+    prog->Bol = 1;
+    for (p = 0; p < npos; p++) {
+        if (((prog->First[p >> 5] >> (p & 31)) & 1) &&
+            _c->Sym[p] != TR_SYM_BOL) {
+            prog->Bol = 0;
+        }
+    }
+    for (p = 0; p < npos; p++) {
+        const uint32_t* cls = _c->Cls + p * 8;
+        uint32_t bit = 1UL << (p & 31);
+        for (b = 0; b < 256; b++) {
+            if ((cls[b >> 5] >> (b & 31)) & 1) {
+                prog->Match[(uint32_t)cmap[b] * w + (p >> 5)] |= bit;
+            }
+        }
+        if (_c->Sym[p] == TR_SYM_BOL) {
+            prog->Match[(uint32_t)(ncls - 2) * w + (p >> 5)] |= bit;
+        } else if (_c->Sym[p] == TR_SYM_EOL) {
+            prog->Match[(uint32_t)(ncls - 1) * w + (p >> 5)] |= bit;
+        }
+    }
+    if (shiftand) {
+        /* Fwd[k * 16 + v]: positions following the positions v << 4k */
+        for (p = 0; p < npos; p++) {
+            for (q = 0; q < npos; q++) {
+                if (!(_c->Follow[p] & (1UL << q))) {
+                    continue;
+                }
+                for (k = 0; k < 16; k++) {
+                    if (k & (1 << (p & 3))) {
+                        prog->Fwd[(p >> 2) * 16 + k] |= 1UL << q;
+                    }
+                    if (k & (1 << (q & 3))) {
+                        prog->Rev[(q >> 2) * 16 + k] |= 1UL << p;
+                    }
+                }
+            }
+        }
+    } else {
+        memcpy(prog->Fwd, _c->Follow, ntab * sizeof(uint32_t));
+        for (p = 0; p < npos; p++) {
+            for (q = 0; q < npos; q++) {
+                if ((_c->Follow[(uint32_t)p * w + (q >> 5)] >> (q & 31)) & 1) {
+                    prog->Rev[(uint32_t)q * w + (p >> 5)] |= 1UL << (p & 31);
+                }
+            }
+        }
+        prog->DSet = prog->Rev + ntab;
+        prog->Tmp = prog->DSet + nstate * w;
+        prog->Cur = prog->Tmp + w;
+        prog->DNext = (uint16_t*)(prog->Cur + w);
+        prog->DFlag = (uint8_t*)(prog->DNext + nstate * ncls);
+    }
+    return prog;
+}
+
+tr_prog_t* tregex_compile(const char* _pattern, pat_size_t _plen) {
+    tr_compiler_t c = {0};
+    tr_frag_t root;
+    tr_prog_t* prog = NULL;
+    pat_size_t i = 0;
+    uint16_t npos;
+    if (_pattern == NULL) {
+        return NULL;
+    }
+    if (_plen == 0) {
+        _plen = strlen(_pattern);
+    }
+    c.Pat = _pattern;
+
+    /* count the positions first */
+    __parseAlt(&c, &i, _plen, &root);
+    if (c.Err || i != _plen) {
+        return NULL;
+    }
+    npos = c.NPos ? c.NPos : 1;
+    c.Words = (npos + 31) / 32;
+    c.Cls = (uint32_t*)m_alloc(npos * 8 * sizeof(uint32_t));
+    c.Follow = (uint32_t*)m_alloc((uint32_t)npos * c.Words * sizeof(uint32_t));
+    c.Sym = (uint8_t*)m_alloc(npos);
+    if (c.Cls != NULL && c.Follow != NULL && c.Sym != NULL) {
+        memset(c.Follow, 0, (uint32_t)npos * c.Words * sizeof(uint32_t));
+        c.Build = 1;
+        c.NPos = 0;
+        i = 0;
+        __parseAlt(&c, &i, _plen, &root);
+        if (!c.Err) {
+            __closeAnchors(&c, root.First);
+            prog = __buildProg(&c, &root);
+        }
+        __fragFree(&root);
+    }
+    if (c.Cls != NULL) {
+        m_free(c.Cls);
+    }
+    if (c.Follow != NULL) {
+        m_free(c.Follow);
+    }
+    if (c.Sym != NULL) {
+        m_free(c.Sym);
+    }
+    return prog;
+}
+
+void tregex_free(tr_prog_t* _prog) {
+    if (_prog != NULL) {
+        m_free(_prog);
+    }
+}
+
+/*
+ *  Shift-And, bit p of the state is position p
+ */
+static inline uint32_t __saFollow(const uint32_t* _tab, uint32_t _d) {
+    uint32_t res = 0;
+    for (; _d; _d >>= 4, _tab += 16) {
+        res |= _tab[_d & 0x0F];
+    }
+    return res;
+}
+
+/*
+ * forward scan, returns the end of the last match which starts before the
+ * earliest end, or the earliest end if _test, or TR_NOT_FOUND
+ */
+static uint32_t __saSearch(const tr_prog_t* _p, const uint8_t* _s,
+                           uint32_t _len, uint8_t _test) {
+    const uint32_t last = _p->Last[0];
+    const uint32_t* match = _p->Match;
+    uint32_t init = _p->First[0], end = TR_NOT_FOUND, i;
+    uint32_t d = init & match[_p->NCls - 2];
+    if (_p->Nullable) {
+        return 0;
+    }
+    if (_p->Bol) {
+        init = 0;  // all matches start at '^'
+    }
+    if (d & last) {
+        if (_test) {
+            return 0;
+        }
+        end = 0;
+        init = 0;  // later matches can't start before this one
+    }
+    for (i = 0; i < _len; i++) {
+        d = (__saFollow(_p->Fwd, d) | init) & match[_p->CMap[_s[i]]];
+        if (d & last) {
+            if (_test) {
+                return i + 1;
+            }
+            end = i + 1;
+            init = 0;
+        } else if (d == 0 && init == 0) {
+            return end;
+        }
+    }
+    d = (__saFollow(_p->Fwd, d) | init) & match[_p->NCls - 1];
+    return (d & last) ? _len : end;
+}
+
+/* the leftmost start of the matches ending before _end, by reversed NFA */
+static uint32_t __saStart(const tr_prog_t* _p, const uint8_t* _s,
+                          uint32_t _end, uint32_t _len) {
+    const uint32_t first = _p->First[0], last = _p->Last[0];
+    const uint32_t* match = _p->Match;
+    uint32_t d = 0, start = _end, i = _end;
+    if (_end == _len) {
+        d = last & match[_p->NCls - 1];
+    }
+    while (i--) {
+        d = (__saFollow(_p->Rev, d) | last) & match[_p->CMap[_s[i]]];
+        if (d & first) {
+            start = i;
+        }
+    }
+    d = (__saFollow(_p->Rev, d) | last) & match[_p->NCls - 2];
+    return (d & first) ? 0 : start;
+}
+
+/* the end of the longest match at _start */
+static uint32_t __saEnd(const tr_prog_t* _p, const uint8_t* _s, uint32_t _len,
+                        uint32_t _start) {
+    const uint32_t first = _p->First[0], last = _p->Last[0];
+    const uint32_t* match = _p->Match;
+    uint32_t d = 0, init = first, end = _start, i;
+    if (_start == 0) {
+        d = first & match[_p->NCls - 2];  // '^' or not
+    }
+    for (i = _start; i < _len; i++) {
+        d = (__saFollow(_p->Fwd, d) | init) & match[_p->CMap[_s[i]]];
+        init = 0;
+        if (d == 0) {
+            return end;
+        }
+        if (d & last) {
+            end = i + 1;
+        }
+    }
+    d = (__saFollow(_p->Fwd, d) | init) & match[_p->NCls - 1];
+    return (d & last) ? _len : end;
+}
+
+/*
+ *  lazy DFA, a state is a position set with TR_DFA_* flags
+ */
+static uint16_t __dfaState(tr_prog_t* _p, const uint32_t* _set,
+                           uint8_t _key) {
+    uint16_t i, w = _p->Words;
+    uint8_t flag = _key;
+    for (i = 0; i < _p->NState; i++) {
+        if ((_p->DFlag[i] & TR_DFA_KEY) == _key &&
+            memcmp(_p->DSet + (uint32_t)i * w, _set, w * sizeof(uint32_t)) ==
+                0) {
+            return i;
+        }
+    }
+    if (_p->NState == TINY_REGEX_CONFIG_DFA_STATES) {
+        _p->NState = 0;  // cache is full, start over
+        _p->Start = 0;
+        _p->Gen++;
+    }
+    i = _p->NState++;
+    memcpy(_p->DSet + (uint32_t)i * w, _set, w * sizeof(uint32_t));
+    if (__setAny(_set, _p->Last, w)) {
+        flag |= TR_DFA_ACCEPT;
+    }
+    if (!(_key & TR_DFA_INIT) && __setEmpty(_set, w)) {
+        flag |= TR_DFA_DEAD;
+    }
+    _p->DFlag[i] = flag;
+    memset(_p->DNext + (uint32_t)i * _p->NCls, 0,
+           _p->NCls * sizeof(uint16_t));
+    return i;
+}
+
+static uint16_t __dfaBuild(tr_prog_t* _p, uint16_t _s, uint16_t _cls) {
+    uint16_t i, n, w = _p->Words, gen = _p->Gen;
+    uint8_t key = _p->DFlag[_s] & TR_DFA_KEY;
+    const uint32_t* m = _p->Match + (uint32_t)_cls * w;
+    memset(_p->Tmp, 0, w * sizeof(uint32_t));
+    __setFollow(_p->Tmp, _p->Fwd, _p->DSet + (uint32_t)_s * w, w);
+    if (key & TR_DFA_INIT) {
+        __setOr(_p->Tmp, _p->First, w);
+    }
+    for (i = 0; i < w; i++) {
+        _p->Tmp[i] &= m[i];
+    }
+    if (!(key & TR_DFA_STICKY)) {
+        key &= ~TR_DFA_INIT;
+    }
+    n = __dfaState(_p, _p->Tmp, key);
+    if (gen == _p->Gen) {
+        _p->DNext[(uint32_t)_s * _p->NCls + _cls] = n + 1;
+    }
+    return n;
+}
+
+static inline uint16_t __dfaStep(tr_prog_t* _p, uint16_t _s, uint16_t _cls) {
+    uint16_t n = _p->DNext[(uint32_t)_s * _p->NCls + _cls];
+    return n ? n - 1 : __dfaBuild(_p, _s, _cls);
+}
+
+/* the same as __saSearch() */
+static uint32_t __dfaSearch(tr_prog_t* _p, const uint8_t* _s, uint32_t _len,
+                            uint8_t _test) {
+    const uint8_t* cmap = _p->CMap;
+    const uint8_t* flag = _p->DFlag;
+    const uint16_t* next = _p->DNext;
+    const uint16_t ncls = _p->NCls;
+    uint32_t end = TR_NOT_FOUND, i = 0;
+    uint16_t s, n;
+    if (_p->Nullable) {
+        return 0;
+    }
+    if (_p->Start == 0) {
+        memset(_p->Tmp, 0, _p->Words * sizeof(uint32_t));
+        s = __dfaState(_p, _p->Tmp, TR_DFA_INIT | TR_DFA_STICKY);
+        s = __dfaStep(_p, s, ncls - 2);
+        if (_p->Bol) {
+            /* all matches start at '^' */
+            memcpy(_p->Tmp, _p->DSet + (uint32_t)s * _p->Words,
+                   _p->Words * sizeof(uint32_t));
+            s = __dfaState(_p, _p->Tmp, 0);
+        }
+        _p->Start = s + 1;
+    }
+    s = _p->Start - 1;
+    for (;;) {
+        if (flag[s] & TR_DFA_DEAD) {
+            return end;
+        }
+        if (flag[s] & TR_DFA_ACCEPT) {
+            end = i;
+            if (_test) {
+                return end;
+            }
+            if (flag[s] & TR_DFA_STICKY) {
+                /* later matches can't start before this one */
+                memcpy(_p->Tmp, _p->DSet + (uint32_t)s * _p->Words,
+                       _p->Words * sizeof(uint32_t));
+                s = __dfaState(_p, _p->Tmp, 0);
+            }
+        }
+        if (i == _len) {
+            break;
+        }
+        /* run on the built states until something happens */
+        while (i < _len) {
+            n = next[(uint32_t)s * ncls + cmap[_s[i]]];
+            if (n == 0) {
+                s = __dfaBuild(_p, s, cmap[_s[i]]);
+            } else {
+                s = n - 1;
+            }
+            i++;
+            if (flag[s] & (TR_DFA_ACCEPT | TR_DFA_DEAD)) {
+                break;
+            }
+        }
+    }
+    s = __dfaStep(_p, s, ncls - 1);
+    return (flag[s] & TR_DFA_ACCEPT) ? _len : end;
+}
+
+/*
+ *  NFA simulation on position sets, for the short scans of a match which
+ *  don't need the DFA
+ */
+static uint8_t __nfaStep(tr_prog_t* _p, uint8_t _rev, uint8_t _init,
+                         uint16_t _cls) {
+    uint16_t i, w = _p->Words;
+    const uint32_t* m = _p->Match + (uint32_t)_cls * w;
+    memset(_p->Tmp, 0, w * sizeof(uint32_t));
+    __setFollow(_p->Tmp, _rev ? _p->Rev : _p->Fwd, _p->Cur, w);
+    if (_init) {
+        __setOr(_p->Tmp, _rev ? _p->Last : _p->First, w);
+    }
+    for (i = 0; i < w; i++) {
+        _p->Cur[i] = _p->Tmp[i] & m[i];
+    }
+    return __setAny(_p->Cur, _rev ? _p->First : _p->Last, w);
+}
+
+static uint32_t __nfaStart(tr_prog_t* _p, const uint8_t* _s, uint32_t _end,
+                           uint32_t _len) {
+    uint32_t start = _end, i = _end;
+    memset(_p->Cur, 0, _p->Words * sizeof(uint32_t));
+    if (_end == _len) {
+        __nfaStep(_p, 1, 1, _p->NCls - 1);
+    }
+    while (i--) {
+        if (__nfaStep(_p, 1, 1, _p->CMap[_s[i]])) {
+            start = i;
+        }
+    }
+    return __nfaStep(_p, 1, 1, _p->NCls - 2) ? 0 : start;
+}
+
+static uint32_t __nfaEnd(tr_prog_t* _p, const uint8_t* _s, uint32_t _len,
+                         uint32_t _start) {
+    uint32_t end = _start, i;
+    memset(_p->Cur, 0, _p->Words * sizeof(uint32_t));
+    if (_start == 0) {
+        __nfaStep(_p, 0, 1, _p->NCls - 2);  // '^' or not
+    }
+    for (i = _start; i < _len; i++) {
+        if (__nfaStep(_p, 0, i == _start, _p->CMap[_s[i]])) {
+            end = i + 1;
+        } else if (__setEmpty(_p->Cur, _p->Words)) {
+            return end;
+        }
+    }
+    return __nfaStep(_p, 0, _start == _len, _p->NCls - 1) ? _len : end;
+}
+
+tr_res_t tregex_exec(tr_prog_t* _prog, const char* _srcstr, uint32_t _slen) {
+    tr_res_t res = {.Data = NULL, .Size = 0};
+    const uint8_t* s = (const uint8_t*)_srcstr;
+    uint32_t start = 0, end;
+    if (_prog == NULL || _srcstr == NULL) {
+        return res;
+    }
+    if (_slen == 0) {
+        _slen = strlen(_srcstr);
+    }
+    if (_prog->ShiftAnd) {
+        end = __saSearch(_prog, s, _slen, 0);
+        if (end == TR_NOT_FOUND) {
+            return res;
+        }
+        if (!_prog->Nullable && !_prog->Bol) {
+            start = __saStart(_prog, s, end, _slen);
+        }
+        end = __saEnd(_prog, s, _slen, start);
+    } else {
+        end = __dfaSearch(_prog, s, _slen, 0);
+        if (end == TR_NOT_FOUND) {
+            return res;
+        }
+        if (!_prog->Nullable && !_prog->Bol) {
+            start = __nfaStart(_prog, s, end, _slen);
+        }
+        end = __nfaEnd(_prog, s, _slen, start);
+    }
+    res.Data = _srcstr + start;
+    res.Size = end - start;
+    return res;
+}
+
+uint8_t tregex_test(tr_prog_t* _prog, const char* _srcstr, uint32_t _slen) {
+    const uint8_t* s = (const uint8_t*)_srcstr;
+    if (_prog == NULL || _srcstr == NULL) {
+        return 0;
+    }
+    if (_slen == 0) {
+        _slen = strlen(_srcstr);
+    }
+    if (_prog->ShiftAnd) {
+        return __saSearch(_prog, s, _slen, 1) != TR_NOT_FOUND;
+    }
+    return __dfaSearch(_prog, s, _slen, 1) != TR_NOT_FOUND;
+}
+#endif
@@ -83,6 +83,34 @@ extern "C" {
 #endif
 #endif
 
+/* Enable or not the compiled matcher, tregex_compile() and tregex_exec() */
+#ifndef TINY_REGEX_CONFIG_COMPILE_ENABLE
+#define TINY_REGEX_CONFIG_COMPILE_ENABLE 1
+#endif
+
+/* Maximum positions (characters and classes) of a compiled pattern */
+#ifndef TINY_REGEX_CONFIG_MAX_POSITIONS
+#define TINY_REGEX_CONFIG_MAX_POSITIONS 128
+#endif
+
+/* Patterns with no more positions than it are matched by Shift-And */
+#ifndef TINY_REGEX_CONFIG_SHIFT_AND_MAX
+#define TINY_REGEX_CONFIG_SHIFT_AND_MAX 32
+#if TINY_REGEX_CONFIG_SHIFT_AND_MAX > 32
+#error \
+    "[tiny_regex.h]Error : The value of TINY_REGEX_CONFIG_SHIFT_AND_MAX is more than 32."
+#endif
+#endif
+
+/* States cached by the lazy DFA of larger patterns */
+#ifndef TINY_REGEX_CONFIG_DFA_STATES
+#define TINY_REGEX_CONFIG_DFA_STATES 32
+#if TINY_REGEX_CONFIG_DFA_STATES < 2
+#error \
+    "[tiny_regex.h]Error : The value of TINY_REGEX_CONFIG_DFA_STATES is less than 2."
+#endif
+#endif
+
 /* Maximum pattern string size, 0:8 byte,1:16byte,>=2:32byte */
 #ifndef TINY_REGEX_CONFIG_PATTERN_SIZE
 #define TINY_REGEX_CONFIG_PATTERN_SIZE 2
@@ -105,6 +133,42 @@ typedef struct {
 tr_res_t tregex_match_str(const char* _srcstr, uint32_t _slen,
                           const char* _pattern, pat_size_t _plen);
 
+#if TINY_REGEX_CONFIG_COMPILE_ENABLE == 1
+typedef struct tr_prog tr_prog_t;
+
+/* fn   : tregex_compile
+ * des  : compile the pattern once, for matching many strings in linear time
+ * args : _pattern : string of regular expression
+ *        _plen    : length of _pattern;when it zero,it will calcualte by
+ *                   strlen()
+ * res  : the compiled pattern, NULL when the pattern is invalid, has more
+ *        than TINY_REGEX_CONFIG_MAX_POSITIONS positions or out of memory
+ */
+tr_prog_t* tregex_compile(const char* _pattern, pat_size_t _plen);
+
+/* fn   : tregex_exec
+ * des  : match the leftmost-longest string in string by compiled pattern
+ * args : _prog    : compiled pattern
+ *        _srcstr  : sources string
+ *        _slen    : length of sources string;when it zero,it will calcualte
+ *                   by strlen()
+ * res  : return the match string, .Data is NULL when not match
+ * note : the lazy DFA is kept in _prog, don't share _prog between threads
+ */
+tr_res_t tregex_exec(tr_prog_t* _prog, const char* _srcstr, uint32_t _slen);
+
+/* fn   : tregex_test
+ * des  : check whether the string matches, faster than tregex_exec()
+ * res  : 1 when match, 0 when not match
+ */
+uint8_t tregex_test(tr_prog_t* _prog, const char* _srcstr, uint32_t _slen);
+
+/* fn   : tregex_free
+ * des  : free the compiled pattern
+ */
+void tregex_free(tr_prog_t* _prog);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
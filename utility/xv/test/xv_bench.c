@@ -0,0 +1,129 @@
+// xv基准测试, 比较每次解析的xv_eval, 编译后的xv_run与xv_run_slots
+// 在工程根目录构建并运行:
+//   gcc -O2 -Iutility/xv/test -I. -Iutility/xv -Idatastruct/json
+//       -Iutility/ryu -Idebug/log -Iutility/macro utility/xv/xv.c
+//       datastruct/json/json.c utility/ryu/ryu.c utility/xv/test/xv_bench.c
+//       -lm -o xv_bench
+//   ./xv_bench [每个表达式的执行次数]
+// 表达式为典型的告警/阈值判断, 变量每次执行都会变化
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "xv.h"
+
+#define BENCH_RUNS 300000
+#define BENCH_MAX_SLOTS 8
+
+enum { VAR_TEMP, VAR_HUM, VAR_VOLT, VAR_CUR, VAR_SET, VAR_HYST, VAR_ABS };
+
+static const char* const m_names[] = {
+    "temp", "humidity", "volt", "cur", "setpoint", "hysteresis", "abs",
+};
+
+static const char* const m_exprs[] = {
+    "temp > 85.5 && (humidity < 20 || humidity > 80) ? 'alarm' : 'ok'",
+    "(volt - 3.3) * 100 / 3.3 > 5 || cur >= 2.5 * 1000 / 1000",
+    "abs(temp - setpoint) > hysteresis",
+    "temp * 9 / 5 + 32 >= 100 + 4 * 2",
+};
+
+static double m_vars[VAR_ABS];
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static struct xv fn_abs(struct xv this, struct xv args, void* udata) {
+    (void)this, (void)udata;
+    return xv_new_double(fabs(xv_double(xv_array_at(args, 0))));
+}
+
+static int var_index(const char* name) {
+    for (int i = 0; i <= VAR_ABS; i++) {
+        if (!strcmp(name, m_names[i]))
+            return i;
+    }
+    return -1;
+}
+
+static struct xv var_value(int i) {
+    if (i == VAR_ABS)
+        return xv_new_function(fn_abs);
+    return i < 0 ? xv_new_undefined() : xv_new_double(m_vars[i]);
+}
+
+static struct xv ref(struct xv this, struct xv ident, void* udata) {
+    (void)udata;
+    if (!xv_is_global(this))
+        return xv_new_undefined();
+    for (int i = 0; i <= VAR_ABS; i++) {
+        if (xv_string_equal(ident, m_names[i]))
+            return var_value(i);
+    }
+    return xv_new_undefined();
+}
+
+static void set_vars(int i) {
+    m_vars[VAR_TEMP] = 20 + i % 100;
+    m_vars[VAR_HUM] = i % 97;
+    m_vars[VAR_VOLT] = 3 + (i % 7) * 0.1;
+    m_vars[VAR_CUR] = i % 5;
+}
+
+int main(int argc, char* argv[]) {
+    int runs = argc > 1 ? atoi(argv[1]) : BENCH_RUNS;
+    if (runs <= 0)
+        runs = BENCH_RUNS;
+    struct xv_env env = {.ref = ref};
+    m_vars[VAR_SET] = 25;
+    m_vars[VAR_HYST] = 1.5;
+    for (size_t e = 0; e < sizeof(m_exprs) / sizeof(m_exprs[0]); e++) {
+        struct xv_program* prog = xv_compile(m_exprs[e]);
+        if (prog == NULL || xv_program_nslots(prog) > BENCH_MAX_SLOTS)
+            return EXIT_FAILURE;
+        size_t nslots = xv_program_nslots(prog);
+        int idx[BENCH_MAX_SLOTS];
+        struct xv slots[BENCH_MAX_SLOTS];
+        for (size_t k = 0; k < nslots; k++) {
+            char name[32];
+            xv_string_copy(xv_program_slot_name(prog, k), name, sizeof(name));
+            idx[k] = var_index(name);
+        }
+        uint64_t ns[3];
+        long sum[3] = {0};
+        for (int m = 0; m < 3; m++) {
+            uint64_t start = host_ns();
+            for (int i = 0; i < runs; i++) {
+                struct xv r;
+                set_vars(i);
+                if (m == 0) {
+                    r = xv_eval(m_exprs[e], &env);
+                } else if (m == 1) {
+                    r = xv_run(prog, &env);
+                } else {
+                    for (size_t k = 0; k < nslots; k++)
+                        slots[k] = var_value(idx[k]);
+                    r = xv_run_slots(prog, NULL, slots);
+                }
+                sum[m] += xv_bool(r);
+                if (xv_type(r) == XV_STRING)
+                    sum[m] += xv_string_length(r);
+                xv_cleanup();
+            }
+            ns[m] = host_ns() - start;
+        }
+        printf("%s\n  eval %6.0f ns  run %5.0f ns (x%.1f)  slots %5.0f ns "
+               "(x%.1f)  %s\n",
+               m_exprs[e], (double)ns[0] / runs, (double)ns[1] / runs,
+               (double)ns[0] / ns[1], (double)ns[2] / runs,
+               (double)ns[0] / ns[2],
+               sum[0] == sum[1] && sum[1] == sum[2] ? "ok" : "MISMATCH");
+        xv_program_free(prog);
+    }
+    return 0;
+}
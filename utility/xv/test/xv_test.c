@@ -0,0 +1,280 @@
+// xv差分测试: 同一表达式分别由xv_eval, xv_run和xv_run_slots执行,
+// 比较结果类型, 字符串形式以及ref/函数回调的调用顺序
+// 在工程根目录构建并运行:
+//   gcc -O1 -g -fsanitize=address,undefined -Iutility/xv/test -I. -Iutility/xv
+//       -Idatastruct/json -Iutility/ryu -Idebug/log -Iutility/macro
+//       -Idebug/minctest utility/xv/xv.c datastruct/json/json.c
+//       utility/ryu/ryu.c utility/xv/test/xv_test.c -lm -o xv_test
+//   ./xv_test [随机表达式数量]
+// 全部通过时返回0. 表达式来自固定用例, 深层嵌套, 随机拼接的记号以及
+// 按语法随机生成的表达式, 包含语法错误, 函数调用, 成员访问和可选链
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_check.h"
+#include "xv.h"
+
+#define TEST_EXPRS 200000
+#define TEST_MAX_SLOTS 64
+
+static char m_trace[4096];  // ref与函数回调的调用记录
+static size_t m_ntrace;
+
+static void trace(const char* s, size_t n) {
+    if (m_ntrace + n + 2 < sizeof(m_trace)) {
+        memcpy(m_trace + m_ntrace, s, n);
+        m_ntrace += n;
+        m_trace[m_ntrace++] = ';';
+    }
+}
+
+static const char m_json[] =
+    "{\"a\":1,\"b\":[1,2,{\"c\":\"x\"}],\"s\":\"str\",\"t\":true}";
+
+static struct xv fn_sum(struct xv this, struct xv args, void* udata) {
+    (void)this, (void)udata;
+    double d = 0;
+    for (size_t i = 0; i < xv_array_length(args); i++)
+        d += xv_double(xv_array_at(args, i));
+    trace("sum", 3);
+    if (xv_array_length(args) == 3)
+        return xv_new_error("three");
+    return xv_new_double(d);
+}
+
+static struct xv fn_this(struct xv this, struct xv args, void* udata) {
+    (void)udata;
+    char b[64];
+    size_t n = xv_string_copy(this, b, sizeof(b));
+    trace(b, n < sizeof(b) ? n : sizeof(b) - 1);
+    return xv_new_int64((int64_t)xv_array_length(args));
+}
+
+static struct xv ref(struct xv this, struct xv ident, void* udata) {
+    (void)udata;
+    char b[64];
+    size_t n = xv_string_copy(ident, b, sizeof(b));
+    if (n >= sizeof(b))
+        n = sizeof(b) - 1;
+    trace(b, n);
+    if (xv_is_global(this)) {
+        if (!strcmp(b, "a"))
+            return xv_new_double(3.5);
+        if (!strcmp(b, "b"))
+            return xv_new_int64(-7);
+        if (!strcmp(b, "c"))
+            return xv_new_uint64(12);
+        if (!strcmp(b, "s"))
+            return xv_new_string("Hello");
+        if (!strcmp(b, "t"))
+            return xv_new_boolean(true);
+        if (!strcmp(b, "n"))
+            return xv_new_null();
+        if (!strcmp(b, "j"))
+            return xv_new_json(m_json);
+        if (!strcmp(b, "f"))
+            return xv_new_function(fn_sum);
+        if (!strcmp(b, "g"))
+            return xv_new_function(fn_this);
+        if (!strcmp(b, "o"))
+            return xv_new_object(m_json, 5);
+        if (!strcmp(b, "e"))
+            return xv_new_error("boom");
+        return xv_new_undefined();
+    }
+    if (xv_object_tag(this) == 5) {
+        if (!strcmp(b, "x"))
+            return xv_new_int64(42);
+        if (!strcmp(b, "m"))
+            return xv_new_function(fn_this);
+        if (!strcmp(b, "self"))
+            return this;
+    }
+    return xv_new_undefined();
+}
+
+static void report(const char* what, const char* expr, size_t len,
+                   const char* a, const char* b) {
+    CHECK_FAIL("%s mismatch: %.*s\n    eval: %s\n    %s", what, (int)len, expr,
+               a, b);
+}
+
+static void check(const char* expr, size_t len, bool no_case) {
+    struct xv_env env = {.ref = ref, .no_case = no_case};
+    char b1[512], b2[512], b3[512], t1[sizeof(m_trace)];
+    m_ntrace = 0;
+    struct xv r1 = xv_evaln(expr, len, &env);
+    xv_string_copy(r1, b1, sizeof(b1));
+    size_t nt1 = m_ntrace;
+    memcpy(t1, m_trace, nt1);
+
+    struct xv_program* prog = xv_compilen(expr, len);
+    if (prog == NULL) {
+        report("compile", expr, len, b1, "NULL");
+        xv_cleanup();
+        return;
+    }
+    m_ntrace = 0;
+    struct xv r2 = xv_run(prog, &env);
+    xv_string_copy(r2, b2, sizeof(b2));
+    if (r1.priv[0] != r2.priv[0] || strcmp(b1, b2))
+        report("run", expr, len, b1, b2);
+    else if (nt1 != m_ntrace || memcmp(t1, m_trace, nt1))
+        report("run trace", expr, len, b1, b2);
+
+    // 槽位的值取自以全局环境求值该标识符的结果
+    struct xv slots[TEST_MAX_SLOTS];
+    size_t nslots = xv_program_nslots(prog);
+    for (size_t i = 0; i < nslots && i < TEST_MAX_SLOTS; i++) {
+        char name[64];
+        xv_string_copy(xv_program_slot_name(prog, i), name, sizeof(name));
+        if (xv_program_slot(prog, name) != (int)i)
+            report("slot", expr, len, b1, name);
+        struct xv_env global = {.ref = ref};
+        slots[i] = xv_eval(name, &global);
+        if (!strcmp(name, "e"))
+            slots[i] = xv_new_error("boom");
+        else if (xv_is_error(slots[i]))
+            slots[i] = xv_new_undefined();
+    }
+    if (nslots <= TEST_MAX_SLOTS) {
+        struct xv r3 = xv_run_slots(prog, &env, slots);
+        xv_string_copy(r3, b3, sizeof(b3));
+        if (r1.priv[0] != r3.priv[0] || strcmp(b1, b3))
+            report("run_slots", expr, len, b1, b3);
+    }
+    xv_program_free(prog);
+    xv_cleanup();
+}
+
+static const char* const m_fixed[] = {
+    "", "  ", "1+2*3", "(1 + 2 == 3 ? 'yes' : 'no') + ' this works'",
+    "[1, (2)]", "[1, (2, 3)]", "a > 3 && b < 0 ? 'alarm' : 'ok'", "-5i64",
+    "- 5i64", "1 - -2", "1 ? 2 : )", "true ? 1 : 2 ? 3 : 4", "f(1,2)",
+    "f(1,2,3)", "zz", "zz?.x", "o.m(1)", "o.self.self.m(1,2,3)", "(o).x",
+    "j.b[2].c", "j['b'][0]", "s + 1", "'a' < 'B'", "'a' == 'A'", "0x", "1..2",
+    "a.", "a?.", "f(", "f)", "{}", "[", "]", "a ? b", "a : b", "1 + (2",
+    "typeof a", "new X", "!a", "!!a", "!!!a", "a === 3.5", "c !== 12u64",
+    "5 % 0i64", "5i64 / 0i64", "1e+3 + 1", "1E-3-1", "a--b", "a++b",
+    "((((((1))))))", "f(1)(2)", "a(1)", "j.a.b(1)", "[1,2][0]", "e",
+    "e ? 1 : 2", "1 ? e : 2", "0 ? e : 2", "(1,2,3)", "[(1,2),3]", "f([1,2],3)",
+    "g(1,(2,3))", "'\\u{1F600}' + s", "\"\\uD83D\\uDE00\"", "'\\x4'", "'\\q'",
+    "'\\1'", "null ?? 5", "undefined ?? a", "0 ?? a", "a ?? zz", "zz ?? a",
+    "1 | 2 ^ 3 & 4", "7i64 & 3i64", "-a", "-s", "--1", "-(1)", "- -1", "+1",
+    "+-1", "3 - -(2)", "3 * -2", "a*-b", "1 < 2 < 3", "1 == 1 == true",
+    "NaN == NaN", "Infinity > 1e308", "o", "g", "j", "j.b", "j.zz", "o.zz",
+    "o.zz.q", "o?.zz.q", "t && n", "t || e", "a,", ",a", "a,,b", "[,]", "[1,]",
+    "f(,)", "s['length']", "o[1+1]", "o['x']", "j.b[1+1].c", "(a)+(b)",
+    "(a)(b)", "('a\\n').x", "(\"x\\t\")(\"y\\n\")",
+};
+
+// 随机拼接的记号: 前22个为标识符和数值, 其后为字符串/关键字/运算符,
+// 第60个之后为括号和成员访问/函数调用片段
+static const char* const m_tokens[] = {
+    "a", "b", "c", "s", "t", "n", "j", "o", "f", "g", "e", "zz", "1", "2.5",
+    "0", "-3", "1e3", "1e-2", "0x1F", "5i64", "7u64", "-2i64", "'x'",
+    "\"y\\n\"", "'\\u0041\\x42'", "''", "true", "false", "null", "undefined",
+    "NaN", "Infinity", "typeof", "+", "-", "*", "/", "%", "<", "<=", ">",
+    ">=", "==", "!=", "===", "!==", "&&", "||", "??", "&", "|", "^", "!",
+    "!!", "?", ":", ",", "(", ")", "[", "]", ".", "?.", "{", "}", " ",
+    "j.a", "j.b[2].c", "j.b[1]", "j['s']", "o.x", "o.m(1,2)", "o.self.m()",
+    "f(1,2)", "f(1,2,3)", "f()", "g(1,(2))", "[1,(2,3)]", "[]", "(a)",
+    "(a).b", "a.b.c", "o?.q?.r", "s.length", "zz?.x", "e.x",
+};
+
+#define NTOKENS (sizeof(m_tokens) / sizeof(m_tokens[0]))
+
+static void put(char* out, size_t* len, const char* s) {
+    size_t n = strlen(s);
+    memcpy(out + *len, s, n);
+    *len += n;
+}
+
+/* 按语法生成: 二元运算, 括号, 条件, 一元运算和数组 */
+static void gen(char* out, size_t* len, int depth) {
+    static const char* const ops[] = {
+        " + ", " - ", "*", "/", " % ", "<", "<=", ">", ">=", "==",
+        "!=", "===", "!==", "&&", "||", "??", "&", "|", "^", ", ",
+    };
+    int r = rand() % 10;
+    if (depth > 4 || r < 3) {
+        if (rand() % 5 == 0)
+            put(out, len, m_tokens[60 + rand() % (NTOKENS - 60)]);
+        else
+            put(out, len, m_tokens[rand() % 22 + (rand() % 2 ? 0 : 22)]);
+        return;
+    }
+    switch (r) {
+        case 3:
+        case 4:
+        case 5:
+            gen(out, len, depth + 1);
+            put(out, len, ops[rand() % 20]);
+            gen(out, len, depth + 1);
+            break;
+        case 6:
+            put(out, len, "(");
+            gen(out, len, depth + 1);
+            put(out, len, ")");
+            break;
+        case 7:
+            gen(out, len, depth + 1);
+            put(out, len, " ? ");
+            gen(out, len, depth + 1);
+            put(out, len, " : ");
+            gen(out, len, depth + 1);
+            break;
+        case 8:
+            put(out, len, rand() % 2 ? "!" : "-");
+            gen(out, len, depth + 1);
+            break;
+        default:
+            put(out, len, "[");
+            gen(out, len, depth + 1);
+            if (rand() % 2) {
+                put(out, len, ",");
+                gen(out, len, depth + 1);
+            }
+            put(out, len, "]");
+            break;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    char buf[4096];
+    for (size_t i = 0; i < sizeof(m_fixed) / sizeof(m_fixed[0]); i++) {
+        check(m_fixed[i], strlen(m_fixed[i]), false);
+        check(m_fixed[i], strlen(m_fixed[i]), true);
+    }
+    // 嵌套深度跨越解析器的上限
+    for (int depth = 95; depth < 106; depth++) {
+        for (int k = 0; k < 2; k++) {
+            size_t len = 0;
+            for (int i = 0; i < depth; i++)
+                buf[len++] = k ? '[' : '(';
+            buf[len++] = '1';
+            for (int i = 0; i < depth; i++)
+                buf[len++] = k ? ']' : ')';
+            check(buf, len, false);
+        }
+    }
+    long exprs = argc > 1 ? atol(argv[1]) : TEST_EXPRS;
+    srand(1);
+    for (long it = 0; it < exprs && m_fails < CHECK_MAX_REPORTS; it++) {
+        size_t len = 0;
+        if (it % 3 == 0) {
+            for (int k = rand() % 8; k >= 0; k--) {
+                put(buf, &len, m_tokens[rand() % NTOKENS]);
+                if (rand() % 3 == 0)
+                    put(buf, &len, " ");
+            }
+        } else {
+            gen(buf, &len, 0);
+        }
+        buf[len] = '\0';
+        check(buf, len, it & 1);
+    }
+    printf("%s (%ld exprs)\n", m_fails ? "FAIL" : "PASS", exprs);
+    return m_fails ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -131,8 +131,9 @@ struct value to_value(struct xv value) {
 }
 
 struct xv from_value(struct value value) {
-    void* v = &value;
-    return *(struct xv*)v;
+    struct xv xv = {0};  // struct value比struct xv小, 不能整体按xv读取
+    memcpy(&xv, &value, sizeof(value));
+    return xv;
 }
 
 struct array {
@@ -147,7 +148,8 @@ static bool array_push_back(struct array* arr, struct value value) {
         struct value* items = emalloc(cap * sizeof(struct value));
         if (!items)
             return false;
-        memcpy(items, arr->items, arr->len * sizeof(struct value));
+        if (arr->len)
+            memcpy(items, arr->items, arr->len * sizeof(struct value));
         arr->items = items;
         arr->cap = cap;
     }
@@ -1871,9 +1873,11 @@ static void write_codepoint(struct writer* wr, uint32_t r) {
     write_bytes(wr, p, n);
 }
 
+// unescape_string writes the unescaped string into dst, which must have room
+// for len+1 bytes, or into thread memory when dst is NULL.
 static const uint8_t* unescape_string(const uint8_t* expr, size_t len,
-                                      size_t* slen, bool* oom) {
-    void* mem = emalloc(len + 1);
+                                      uint8_t* dst, size_t* slen, bool* oom) {
+    void* mem = dst ? dst : emalloc(len + 1);
     if (!mem) {
         *oom = true;
         *slen = 0;
@@ -1952,7 +1956,8 @@ static const uint8_t* unescape_string(const uint8_t* expr, size_t len,
 
 // parse_string parses a Javascript encoded string.
 static const uint8_t* parse_string(const uint8_t* expr, size_t len,
-                                   size_t* slen, size_t* rlen, bool* oom) {
+                                   uint8_t* dst, size_t* slen, size_t* rlen,
+                                   bool* oom) {
     bool esc = false;
     if (len < 2)
         goto fail;
@@ -2011,7 +2016,7 @@ static const uint8_t* parse_string(const uint8_t* expr, size_t len,
             const uint8_t* s = expr + 1;
             *slen = i - 1;
             if (esc) {
-                s = unescape_string(s, *slen, slen, oom);
+                s = unescape_string(s, *slen, dst, slen, oom);
                 if (!s) {
                     *slen = 0;
                     *rlen = 0;
@@ -2030,6 +2035,10 @@ fail:
     return NULL;
 }
 
+static struct value check_ref_value(struct value val, bool chain,
+                                    struct value left, const uint8_t* ident,
+                                    size_t ilen, bool opt_chain);
+
 // get_ref_value takes the value from an external reference.
 // It's possible that the ref value is on the heap, and if so we need to
 // steal it and place it in the allocs list.
@@ -2074,6 +2083,14 @@ static struct value get_ref_value(bool chain, struct value left,
     struct value val = to_value(
         ctx->env->ref(from_value(chain ? left : make_global()),
                       xv_new_stringn((char*)ident, ilen), ctx->env->udata));
+    return check_ref_value(val, chain, left, ident, ilen, opt_chain);
+}
+
+// check_ref_value applies the undefined and optional chaining rules to a
+// value that was returned by the ref callback.
+static struct value check_ref_value(struct value val, bool chain,
+                                    struct value left, const uint8_t* ident,
+                                    size_t ilen, bool opt_chain) {
     if (is_err(val))
         return val;
     if (val.kind == UNDEF_KIND && left.kind == UNDEF_KIND) {
@@ -2190,7 +2207,7 @@ static struct value eval_atom(const uint8_t* expr, size_t len,
             return make_float(x);
         case '"':
         case '\'':
-            str = parse_string(expr, len, &slen, &rlen, &oom);
+            str = parse_string(expr, len, NULL, &slen, &rlen, &oom);
             if (!str) {
                 return oom ? err_oom() : err_syntax();
             }
@@ -2606,10 +2623,7 @@ struct xv xv_eval(const char* expr, struct xv_env* env) {
 }
 
 struct xv xv_evaln(const char* expr, size_t len, struct xv_env* env) {
-    struct value value = eval((uint8_t*)expr, len, env, 0);
-    struct xv fvalue;
-    memcpy(&fvalue, &value, sizeof(struct xv));
-    return fvalue;
+    return from_value(eval((uint8_t*)expr, len, env, 0));
 }
 
 static void write_error(struct writer* wr, struct value value) {
@@ -3080,3 +3094,1369 @@ char* xv_string(struct xv value) {
     }
     return str;
 }
+
+#if XV_CFG_ENABLE_COMPILE
+/////////////////////////////////
+// Compiled expressions
+/////////////////////////////////
+
+// The compiler walks the expression with the same scanners as eval_auto and
+// its children, but emits stack machine code instead of computing values.
+// Every place where the evaluator returns an error while scanning becomes an
+// OP_ERROR at the same position in the code, so a program returns exactly
+// what xv_eval would, including the order of ref and function callbacks.
+
+#ifndef XV_RUN_STACK_SIZE
+#define XV_RUN_STACK_SIZE 16
+#endif
+
+#ifndef XV_RUN_ARRAYS
+#define XV_RUN_ARRAYS 4
+#endif
+
+enum opcode {
+    OP_END,        // return the top of the stack
+    OP_CONST,      // u16 const: push a constant
+    OP_GLOBAL,     // u16 slot: push a global identifier
+    OP_ERROR,      // u16 const: return an error constant
+    OP_POP,        // discard the top of the stack
+    OP_ADD,        // binary operators, (a b) -> (a op b)
+    OP_SUB,        //
+    OP_MUL,        //
+    OP_DIV,        //
+    OP_MOD,        //
+    OP_LT,         //
+    OP_LTE,        //
+    OP_GT,         //
+    OP_GTE,        //
+    OP_EQ,         //
+    OP_NEQ,        //
+    OP_SEQ,        //
+    OP_SNEQ,       //
+    OP_BAND,       //
+    OP_BXOR,       //
+    OP_BOR,        //
+    OP_AND,        //
+    OP_OR,         //
+    OP_COALESCE,   //
+    OP_NEG,        // unary '-'
+    OP_BOOL,       // '!!'
+    OP_NOT,        // '!'
+    OP_JMPF,       // u16 addr: pop and jump when falsy
+    OP_JMP,        // u16 addr: jump
+    OP_ARRAY,      // u16 cap: begin an array literal or argument list
+    OP_APPEND,     // append the top of the stack to the current array
+    OP_ARRAY_END,  // replace the last element value with the array
+    OP_CHAIN,      // (a) -> (undefined a), start of a member chain
+    OP_MEMBER,     // u16 const, u8 opt: (l a) -> (a a.ident)
+    OP_INDEX,      // u8 opt: (l a key) -> (a a[key])
+    OP_CALLABLE,   // u16 const: check that the top is a function
+    OP_CALL,       // (l f args) -> (f f(args))
+    OP_NIP,        // (a b) -> (b), end of a member chain
+};
+
+struct xv_program {
+    const uint8_t* code;
+    const struct value* consts;
+    const struct value* slots;  // global identifiers as strings
+    uint16_t nslot;
+    uint16_t nstack;  // max depth of the value stack
+    uint16_t narray;  // max nesting of array literals
+};
+
+#define WINDOW 4
+
+struct compiler {
+    uint8_t* code;
+    size_t ncode;
+    size_t capcode;
+    struct value* consts;
+    size_t nconst;
+    size_t capconst;
+    struct value* slots;
+    size_t nslot;
+    size_t capslot;
+    uint8_t* src;        // copy of the expression, followed by the string pool
+    size_t srcsize;      //
+    size_t npool;        // bytes used in the string pool
+    int sp;              // current stack depth
+    int nstack;          // max stack depth
+    int ap;              // current array nesting
+    int narray;          // max array nesting
+    size_t win[WINDOW];  // starts of the last instructions, for folding
+    int nwin;            //
+    bool oom;
+};
+
+struct compile_context {
+    struct compiler* c;
+    int steps;      // all possible steps
+    bool iter;      // the evaluator would call an iterator
+    size_t nitems;  // number of OP_APPEND for the current array
+};
+
+static bool grow(void** ptr, size_t* cap, size_t need, size_t elsize) {
+    if (need <= *cap)
+        return true;
+    size_t cap2 = *cap ? *cap * 2 : 16;
+    if (cap2 > UINT16_MAX + 1)
+        cap2 = UINT16_MAX + 1;
+    if (need > cap2)
+        return false;
+    void* mem = m_realloc(*ptr, cap2 * elsize);
+    if (!mem)
+        return false;
+    *ptr = mem;
+    *cap = cap2;
+    return true;
+}
+
+static void emit_byte(struct compiler* c, uint8_t b) {
+    if (!grow((void**)&c->code, &c->capcode, c->ncode + 1, 1)) {
+        c->oom = true;
+        return;
+    }
+    c->code[c->ncode++] = b;
+}
+
+static void emit_u16(struct compiler* c, size_t x) {
+    emit_byte(c, (uint8_t)x);
+    emit_byte(c, (uint8_t)(x >> 8));
+}
+
+static uint16_t read_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void emit_op(struct compiler* c, uint8_t op, int push) {
+    if (c->nwin == WINDOW) {
+        memmove(c->win, c->win + 1, (WINDOW - 1) * sizeof(size_t));
+        c->nwin--;
+    }
+    c->win[c->nwin++] = c->ncode;
+    emit_byte(c, op);
+    c->sp += push;
+    if (c->sp > c->nstack)
+        c->nstack = c->sp;
+}
+
+static size_t add_const(struct compiler* c, struct value value) {
+    if (!grow((void**)&c->consts, &c->capconst, c->nconst + 1,
+              sizeof(struct value))) {
+        c->oom = true;
+        return 0;
+    }
+    c->consts[c->nconst] = value;
+    return c->nconst++;
+}
+
+static void emit_const(struct compiler* c, struct value value) {
+    size_t k = add_const(c, value);
+    emit_op(c, OP_CONST, 1);
+    emit_u16(c, k);
+}
+
+// emit_error emits an unconditional error. Always returns true, meaning that
+// the code emitted so far never falls through.
+static bool emit_error(struct compiler* c, struct value err) {
+    size_t k = add_const(c, err);
+    emit_op(c, OP_ERROR, 0);
+    emit_u16(c, k);
+    return true;
+}
+
+static size_t emit_jump(struct compiler* c, uint8_t op) {
+    emit_op(c, op, op == OP_JMPF ? -1 : 0);
+    size_t at = c->ncode;
+    emit_u16(c, 0);
+    return at;
+}
+
+// patch_jump points a jump at the current position. Instructions before a
+// jump target must not be folded with the ones after it.
+static void patch_jump(struct compiler* c, size_t at) {
+    if (c->oom)
+        return;
+    c->code[at] = (uint8_t)c->ncode;
+    c->code[at + 1] = (uint8_t)(c->ncode >> 8);
+    c->nwin = 0;
+}
+
+// peek_const returns the constant pushed by the nth last instruction.
+static bool peek_const(struct compiler* c, int n, struct value* value) {
+    if (c->oom || c->nwin <= n)
+        return false;
+    const uint8_t* ins = c->code + c->win[c->nwin - 1 - n];
+    if (ins[0] != OP_CONST)
+        return false;
+    *value = c->consts[read_u16(ins + 1)];
+    return true;
+}
+
+// drop_const removes the last instruction, which must be an OP_CONST.
+static void drop_const(struct compiler* c) {
+    size_t at = c->win[--c->nwin];
+    if (read_u16(c->code + at + 1) == c->nconst - 1)
+        c->nconst--;
+    c->ncode = at;
+    c->sp--;
+}
+
+static struct value binary_op(uint8_t op, struct value a, struct value b,
+                              struct eval_context* ctx) {
+    switch (op) {
+        case OP_ADD:
+            return vadd(a, b);
+        case OP_SUB:
+            return vsub(a, b);
+        case OP_MUL:
+            return vmul(a, b);
+        case OP_DIV:
+            return vdiv(a, b);
+        case OP_MOD:
+            return vmod(a, b);
+        case OP_LT:
+            return vlt(a, b, ctx);
+        case OP_LTE:
+            return vlte(a, b, ctx);
+        case OP_GT:
+            return vgt(a, b, ctx);
+        case OP_GTE:
+            return vgte(a, b, ctx);
+        case OP_EQ:
+            return veq(a, b, ctx);
+        case OP_NEQ:
+            return vneq(a, b, ctx);
+        case OP_SEQ:
+            return vseq(a, b, ctx);
+        case OP_SNEQ:
+            return vsneq(a, b, ctx);
+        case OP_BAND:
+            return vband(a, b);
+        case OP_BXOR:
+            return vbxor(a, b);
+        case OP_BOR:
+            return vbor(a, b);
+        case OP_AND:
+            return vand(a, b);
+        case OP_OR:
+            return vor(a, b);
+        default:
+            return vcoalesce(a, b);
+    }
+}
+
+static struct value unary_op(uint8_t op, struct value a) {
+    switch (op) {
+        case OP_NEG:
+            return vmul(a, make_float(-1));
+        case OP_BOOL:
+            return a.kind == BOOL_KIND ? a : make_bool(to_bool(a));
+        default:
+            return make_bool(!to_bool(a));
+    }
+}
+
+static void emit_binary(struct compiler* c, uint8_t op) {
+    struct value a, b;
+    // Fold numeric constants only, strings may need memory and the result
+    // of a string comparison depends on the env.
+    if (peek_const(c, 1, &a) && peek_const(c, 0, &b) && isnum(a) &&
+        isnum(b)) {
+        drop_const(c);
+        drop_const(c);
+        emit_const(c, binary_op(op, a, b, NULL));
+        return;
+    }
+    emit_op(c, op, -1);
+}
+
+static void emit_unary(struct compiler* c, uint8_t op) {
+    struct value a;
+    if (peek_const(c, 0, &a)) {
+        drop_const(c);
+        emit_const(c, unary_op(op, a));
+        return;
+    }
+    emit_op(c, op, 0);
+}
+
+static void emit_append(struct compile_context* cc) {
+    emit_op(cc->c, OP_APPEND, 0);
+    cc->nitems++;
+}
+
+static size_t add_slot(struct compiler* c, const uint8_t* ident, size_t ilen) {
+    for (size_t i = 0; i < c->nslot; i++) {
+        if (c->slots[i].len == ilen &&
+            memcmp(c->slots[i].str, ident, ilen) == 0)
+            return i;
+    }
+    if (!grow((void**)&c->slots, &c->capslot, c->nslot + 1,
+              sizeof(struct value))) {
+        c->oom = true;
+        return 0;
+    }
+    c->slots[c->nslot] = make_string(ident, ilen);
+    return c->nslot++;
+}
+
+static bool compile_auto(int step, const uint8_t* expr, size_t len,
+                         struct compile_context* cc, int depth);
+
+static bool compile_expr(const uint8_t* expr, size_t len,
+                         struct compile_context* cc, int depth) {
+    return compile_auto(STEP_COMMA, expr, len, cc, depth + 1);
+}
+
+static bool compile_array(const uint8_t* expr, size_t len,
+                          struct compile_context* cc, int depth);
+
+// compile_skip_group skips a group while scanning, or emits the syntax error
+// that the eval_* functions return for a broken group.
+#define compile_skip_group(expr, len, i, c)                \
+    {                                                      \
+        size_t glen;                                       \
+        if (!read_group((expr) + (i), (len) - (i), &glen)) \
+            return emit_error((c), err_syntax());          \
+        (i) = (i) + glen - 1;                              \
+    }
+
+static bool compile_comma(const uint8_t* expr, size_t len,
+                          struct compile_context* cc, int depth) {
+    size_t s = 0;
+    bool iter = cc->iter;
+    bool dead;
+    for (size_t i = 0; i < len; i++) {
+        switch (expr[i]) {
+            case ',':
+                cc->iter = false;  // disable the iter
+                dead =
+                    compile_auto(STEP_COMMA << 1, expr + s, i - s, cc, depth);
+                cc->iter = iter;  // enable the iter
+                if (dead)
+                    return true;
+                if (cc->iter)
+                    emit_append(cc);
+                emit_op(cc->c, OP_POP, -1);
+                s = i + 1;
+                break;
+            case '(':
+            case '[':
+            case '{':
+            case '"':
+            case '\'':
+                compile_skip_group(expr, len, i, cc->c);
+                break;
+        }
+    }
+    if (compile_auto(STEP_COMMA << 1, expr + s, len - s, cc, depth))
+        return true;
+    if (cc->iter)
+        emit_append(cc);
+    return false;
+}
+
+static bool compile_terns(const uint8_t* expr, size_t len,
+                          struct compile_context* cc, int depth) {
+    struct compiler* c = cc->c;
+    const uint8_t* cond = NULL;
+    size_t condlen = 0;
+    size_t s = 0;
+    size_t tdepth = 0;
+    for (size_t i = 0; i < len; i++) {
+        switch (expr[i]) {
+            case '?':
+                if (i + 1 < len && (expr[i + 1] == '?' || expr[i + 1] == '.')) {
+                    // '??' or '?.' operator
+                    i++;
+                    continue;
+                }
+                if (tdepth == 0) {
+                    cond = expr;
+                    condlen = i;
+                    s = i + 1;
+                }
+                tdepth++;
+                break;
+            case ':':
+                tdepth--;
+                if (tdepth == 0) {
+                    const uint8_t* left = expr + s;
+                    size_t leftlen = i - s;
+                    const uint8_t* right = expr + i + 1;
+                    size_t rightlen = len - (i + 1);
+                    if (compile_expr(cond, condlen, cc, depth))
+                        return true;
+                    struct value res;
+                    if (peek_const(c, 0, &res)) {
+                        // constant condition, only one branch is needed
+                        drop_const(c);
+                        if (to_bool(res))
+                            return compile_expr(left, leftlen, cc, depth);
+                        return compile_expr(right, rightlen, cc, depth);
+                    }
+                    int sp = c->sp - 1;
+                    size_t jf = emit_jump(c, OP_JMPF);
+                    bool dead1 = compile_expr(left, leftlen, cc, depth);
+                    size_t je = emit_jump(c, OP_JMP);
+                    patch_jump(c, jf);
+                    c->sp = sp;
+                    bool dead2 = compile_expr(right, rightlen, cc, depth);
+                    patch_jump(c, je);
+                    c->sp = sp + 1;
+                    return dead1 && dead2;
+                }
+                break;
+            case '(':
+            case '[':
+            case '{':
+            case '"':
+            case '\'':
+                compile_skip_group(expr, len, i, c);
+                break;
+        }
+    }
+    if (tdepth == 0) {
+        return compile_auto(STEP_TERNS << 1, expr, len, cc, depth);
+    }
+    return emit_error(c, err_syntax());
+}
+
+static bool compile_atom(const uint8_t* expr, size_t len,
+                         struct compile_context* cc, int depth);
+
+// compile_operand compiles one operand of a binary operator and then the
+// operator itself, see logical_or, bitwise_or, comp, fact and friends.
+static bool compile_operand(int step, uint8_t op, const uint8_t* expr,
+                            size_t len, struct compile_context* cc,
+                            int depth) {
+    expr = trim(expr, len, &len);
+    if (len == 0)
+        return emit_error(cc->c, err_syntax());
+    bool dead = step == STEP_FACTS
+                    ? compile_atom(expr, len, cc, depth)
+                    : compile_auto(step << 1, expr, len, cc, depth);
+    if (dead)
+        return true;
+    if (op)
+        emit_binary(cc->c, op);
+    return false;
+}
+
+static bool compile_logical_or(const uint8_t* expr, size_t len,
+                               struct compile_context* cc, int depth) {
+    size_t s = 0;
+    uint8_t op = 0;
+    for (size_t i = 0; i < len; i++) {
+        switch (expr[i]) {
+            case '?':
+                if (i + 1 < len && expr[i + 1] == '.') {
+                    // '?.' operator
+                    i++;
+                    continue;
+                }
+                // fall through
+            case '|':
+                if (i + 1 == len)
+                    return emit_error(cc->c, err_syntax());
+                if (expr[i + 1] != expr[i]) {
+                    // bitwise OR
+                    i++;
+                    continue;
+                }
+                if (compile_operand(STEP_LOGICAL_OR, op, expr + s, i - s, cc,
+                                    depth))
+                    return true;
+                op = expr[i] == '|' ? OP_OR : OP_COALESCE;
+                i++;
+                s = i + 1;
+                break;
+            case '(':
+            case '[':
+            case '{':
+            case '"':
+            case '\'':
+                compile_skip_group(expr, len, i, cc->c);
+                break;
+        }
+    }
+    return compile_operand(STEP_LOGICAL_OR, op, expr + s, len - s, cc, depth);
+}
+
+static bool compile_logical_and(const uint8_t* expr, size_t len,
+                                struct compile_context* cc, int depth) {
+    size_t s = 0;
+    uint8_t op = 0;
+    for (size_t i = 0; i < len; i++) {
+        switch (expr[i]) {
+            case '&':
+                if (i + 1 == len)
+                    return emit_error(cc->c, err_syntax());
+                if (expr[i + 1] != '&') {
+                    // bitwise AND
+                    i++;
+                    continue;
+                }
+                if (compile_operand(STEP_LOGICAL_AND, op, expr + s, i - s, cc,
+                                    depth))
+                    return true;
+                op = OP_AND;
+                i++;
+                s = i + 1;
+                break;
+            case '(':
+            case '[':
+            case '{':
+            case '"':
+            case '\'':
+                compile_skip_group(expr, len, i, cc->c);
+                break;
+        }
+    }
+    return compile_operand(STEP_LOGICAL_AND, op, expr + s, len - s, cc,
+                           depth);
+}
+
+// compile_bitwise handles the '|', '^' and '&' levels, which only differ by
+// the operator character.
+static bool compile_bitwise(int step, uint8_t opch, uint8_t opcode,
+                            const uint8_t* expr, size_t len,
+                            struct compile_context* cc, int depth) {
+    size_t s = 0;
+    uint8_t op = 0;
+    for (size_t i = 0; i < len; i++) {
+        switch (expr[i]) {
+            case '(':
+            case '[':
+            case '{':
+            case '"':
+            case '\'':
+                compile_skip_group(expr, len, i, cc->c);
+                break;
+            default:
+                if (expr[i] != opch)
+                    break;
+                if (compile_operand(step, op, expr + s, i - s, cc, depth))
+                    return true;
+                op = opcode;
+                s = i + 1;
+                break;
+        }
+    }
+    return compile_operand(step, op, expr + s, len - s, cc, depth);
+}
+
+static bool compile_equal(uint8_t op, const uint8_t* expr, size_t len,
+                          struct compile_context* cc, int depth) {
+    bool neg = false;
+    bool boolit = false;
+    expr = trim(expr, len, &len);
+    while (1) {
+        if (len == 0)
+            return emit_error(cc->c, err_syntax());
+        if (expr[0] != '!')
+            break;
+        neg = !neg;
+        boolit = true;
+        expr++;
+        len--;
+        expr = trim(expr, len, &len);
+    }
+    if (compile_auto(STEP_EQUALITY << 1, expr, len, cc, depth))
+        return true;
+    if (boolit)
+        emit_unary(cc->c, neg ? OP_NOT : OP_BOOL);
+    if (op)
+        emit_binary(cc->c, op);
+    return false;
+}
+
+static bool compile_equality(const uint8_t* expr, size_t len,
+                             struct compile_context* cc, int depth) {
+    size_t s = 0;
+    uint8_t op = 0;
+    uint8_t opch;
+    size_t opsz;
+    for (size_t i = 0; i < len; i++) {
+        switch (expr[i]) {
+            case '=':
+            case '!':
+                opch = expr[i];
+                opsz = 1;
+                switch (opch) {
+                    case '=':
+                        if (i > 0 &&
+                            (expr[i - 1] == '>' || expr[i - 1] == '<')) {
+                            continue;
+                        }
+                        if (i == len - 1 || expr[i + 1] != '=') {
+                            return emit_error(cc->c, err_syntax());
+                        }
+                        opsz++;
+                        break;
+                    case '!':
+                        if (i == len - 1 || expr[i + 1] != '=') {
+                            continue;
+                        }
+                        opsz++;
+                        break;
+                }
+                bool strict = i + 2 < len && expr[i + 2] == '=';
+                if (strict)
+                    opsz++;
+                if (compile_equal(op, expr + s, i - s, cc, depth))
+                    return true;
+                if (opch == '=')
+                    op = strict ? OP_SEQ : OP_EQ;
+                else
+                    op = strict ? OP_SNEQ : OP_NEQ;
+                i = i + opsz - 1;
+                s = i + 1;
+                break;
+            case '(':
+            case '[':
+            case '{':
+            case '"':
+            case '\'':
+                compile_skip_group(expr, len, i, cc->c);
+                break;
+        }
+    }
+    return compile_equal(op, expr + s, len - s, cc, depth);
+}
+
+static bool compile_comps(const uint8_t* expr, size_t len,
+                          struct compile_context* cc, int depth) {
+    size_t s = 0;
+    uint8_t op = 0;
+    uint8_t opcode;
+    size_t opsz;
+    for (size_t i = 0; i < len; i++) {
+        switch (expr[i]) {
+            case '<':
+            case '>':
+                opcode = expr[i] == '<' ? OP_LT : OP_GT;
+                opsz = 1;
+                if (i < len - 1 && expr[i + 1] == '=') {
+                    opcode = expr[i] == '<' ? OP_LTE : OP_GTE;
+                    opsz++;
+                }
+                if (compile_operand(STEP_COMPS, op, expr + s, i - s, cc,
+                                    depth))
+                    return true;
+                op = opcode;
+                i = i + opsz - 1;
+                s = i + 1;
+                break;
+            case '(':
+            case '[':
+            case '{':
+            case '"':
+            case '\'':
+                compile_skip_group(expr, len, i, cc->c);
+                break;
+        }
+    }
+    return compile_operand(STEP_COMPS, op, expr + s, len - s, cc, depth);
+}
+
+static bool compile_sum(uint8_t op, const uint8_t* expr, size_t len, bool neg,
+                        struct compile_context* cc, int depth) {
+    expr = trim(expr, len, &len);
+    if (len == 0)
+        return emit_error(cc->c, err_syntax());
+    if (compile_auto(STEP_SUMS << 1, expr, len, cc, depth))
+        return true;
+    if (neg)
+        emit_unary(cc->c, OP_NEG);
+    if (op)
+        emit_binary(cc->c, op);
+    return false;
+}
+
+static bool compile_sums(const uint8_t* expr, size_t len,
+                         struct compile_context* cc, int depth) {
+    size_t s = 0;
+    uint8_t op = 0;
+    bool fill = false;
+    bool neg = false;
+    for (size_t i = 0; i < len; i++) {
+        switch (expr[i]) {
+            case '-':
+            case '+':
+                if (!fill) {
+                    if (i > 0 && expr[i - 1] == expr[i]) {
+                        // -- not allowed
+                        return emit_error(cc->c, err_syntax());
+                    }
+                    if (expr[i] == '-') {
+                        neg = !neg;
+                    }
+                    s = i + 1;
+                    continue;
+                }
+                if (i > 0 && (expr[i - 1] == 'e' || expr[i - 1] == 'E')) {
+                    // scientific notation
+                    continue;
+                }
+                if (neg) {
+                    if (s > 0 && s < len && expr[s - 1] == '-' &&
+                        expr[s] >= '0' && expr[s] <= '9') {
+                        s--;
+                        neg = false;
+                    }
+                }
+                if (compile_sum(op, expr + s, i - s, neg, cc, depth))
+                    return true;
+                op = expr[i] == '+' ? OP_ADD : OP_SUB;
+                s = i + 1;
+                fill = false;
+                neg = false;
+                break;
+            case '(':
+            case '[':
+            case '{':
+            case '"':
+            case '\'':
+                compile_skip_group(expr, len, i, cc->c);
+                fill = true;
+                break;
+            default:
+                if (!fill && !isws(expr[i])) {
+                    fill = true;
+                }
+        }
+    }
+    if (neg) {
+        if (s > 0 && s < len && expr[s - 1] == '-' && expr[s] >= '0' &&
+            expr[s] <= '9') {
+            s--;
+            neg = false;
+        }
+    }
+    return compile_sum(op, expr + s, len - s, neg, cc, depth);
+}
+
+static bool compile_facts(const uint8_t* expr, size_t len,
+                          struct compile_context* cc, int depth) {
+    size_t s = 0;
+    uint8_t op = 0;
+    for (size_t i = 0; i < len; i++) {
+        switch (expr[i]) {
+            case '*':
+            case '/':
+            case '%':
+                if (compile_operand(STEP_FACTS, op, expr + s, i - s, cc,
+                                    depth))
+                    return true;
+                op = expr[i] == '*' ? OP_MUL : expr[i] == '/' ? OP_DIV : OP_MOD;
+                s = i + 1;
+                break;
+            case '(':
+            case '[':
+            case '{':
+            case '"':
+            case '\'':
+                compile_skip_group(expr, len, i, cc->c);
+                break;
+        }
+    }
+    return compile_operand(STEP_FACTS, op, expr + s, len - s, cc, depth);
+}
+
+// compile_number mirrors the non-chainable atoms of eval_atom.
+static bool compile_number(const uint8_t* expr, size_t len,
+                           struct compiler* c) {
+    bool ok = false;
+    if (expr[0] == '0' && len > 1 && (expr[1] == 'x' || expr[1] == 'X')) {
+        // hexadecimal
+        uint64_t x = parse_uint(expr + 2, len - 2, 16, &ok);
+        if (!ok)
+            return emit_error(c, err_syntax());
+        emit_const(c, make_float((double)x));
+        return false;
+    }
+    if (len > 3 && has_suffix(expr, len, "64")) {
+        if (expr[len - 3] == 'u') {
+            uint64_t x = parse_uint(expr, len - 3, 10, &ok);
+            if (!ok)
+                return emit_error(c, err_syntax());
+            emit_const(c, make_uint(x));
+            return false;
+        }
+        if (expr[len - 3] == 'i') {
+            int64_t x = parse_int(expr, len - 3, 10, &ok);
+            if (!ok)
+                return emit_error(c, err_syntax());
+            emit_const(c, make_int(x));
+            return false;
+        }
+    }
+    double x = parse_float(expr, len, &ok);
+    if (!ok)
+        return emit_error(c, err_syntax());
+    emit_const(c, make_float(x));
+    return false;
+}
+
+static bool compile_atom(const uint8_t* expr, size_t len,
+                         struct compile_context* cc, int depth) {
+    struct compiler* c = cc->c;
+    expr = trim(expr, len, &len);
+    if (len == 0)
+        return emit_error(c, err_syntax());
+    bool left_ready = false;
+    size_t glen;
+    const uint8_t* g;
+    size_t slen;
+    size_t rlen;
+    bool oom;
+    const uint8_t* str;
+
+    // first look for non-chainable atoms
+    switch (expr[0]) {
+        case '-':
+        case '.':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return compile_number(expr, len, c);
+        case '"':
+        case '\'':
+            // escaped strings are written to the pool after the expression,
+            // the unescaped string is never longer than the quoted one.
+            if (!read_group(expr, len, &glen))
+                glen = len + 1;
+            if (c->npool + glen > c->srcsize) {
+                c->oom = true;
+                return true;
+            }
+            str = parse_string(expr, len, c->src + c->npool, &slen, &rlen,
+                               &oom);
+            if (!str)
+                return emit_error(c, err_syntax());
+            if (str == c->src + c->npool)
+                c->npool += slen + 1;
+            emit_const(c, make_string(str, slen));
+            left_ready = true;
+            expr = expr + rlen;
+            len -= rlen;
+            break;
+        case '(':
+        case '{':
+        case '[':
+            g = read_group(expr, len, &glen);
+            if (!g)
+                return emit_error(c, err_syntax());
+            if (g[0] == '(') {
+                // same length as eval_atom, which uses the atom length
+                if (compile_expr(g + 1, len - 2, cc, depth))
+                    return true;
+            } else if (g[0] == '[') {
+                if (compile_array(g + 1, glen - 2, cc, depth))
+                    return true;
+            } else {
+                return emit_error(c, err_syntax());
+            }
+            left_ready = true;
+            expr += glen;
+            len -= glen;
+            break;
+    }
+    const uint8_t* left_ident = NULL;
+    size_t left_ident_len = 0;
+    if (!left_ready) {
+        // probably a chainable identifier
+        size_t ilen;
+        const uint8_t* ident = read_ident(expr, len, &ilen);
+        if (!ident)
+            return emit_error(c, err_syntax());
+        if (ilen == 4 && memcmp(ident, "true", 4) == 0) {
+            emit_const(c, make_bool(true));
+        } else if (ilen == 5 && memcmp(ident, "false", 5) == 0) {
+            emit_const(c, make_bool(false));
+        } else if (ilen == 4 && memcmp(ident, "null", 4) == 0) {
+            emit_const(c, make_null());
+        } else if (ilen == 9 && memcmp(ident, "undefined", 9) == 0) {
+            emit_const(c, make_undefined());
+        } else if (ilen == 3 && memcmp(ident, "NaN", 3) == 0) {
+            emit_const(c, make_float(NAN));
+        } else if (ilen == 8 && memcmp(ident, "Infinity", 8) == 0) {
+            emit_const(c, make_float(INFINITY));
+        } else if ((ilen == 2 && memcmp(ident, "in", 2) == 0) ||
+                   (ilen == 3 && memcmp(ident, "new", 3) == 0) ||
+                   (ilen == 4 && memcmp(ident, "void", 4) == 0) ||
+                   (ilen == 5 && memcmp(ident, "await", 5) == 0) ||
+                   (ilen == 5 && memcmp(ident, "yield", 5) == 0) ||
+                   (ilen == 6 && memcmp(ident, "typeof", 6) == 0) ||
+                   (ilen == 8 && memcmp(ident, "function", 8) == 0) ||
+                   (ilen == 10 && memcmp(ident, "instanceof", 10) == 0)) {
+            return emit_error(c, err_unsupported_keyword(ident, ilen));
+        } else {
+            size_t slot = add_slot(c, ident, ilen);
+            emit_op(c, OP_GLOBAL, 1);
+            emit_u16(c, slot);
+        }
+        expr = expr + ilen;
+        len -= ilen;
+        left_ident = ident;
+        left_ident_len = ilen;
+    }
+
+    // read each chained component
+    bool chain = false;
+    bool opt_chain = false;
+    const uint8_t* ident;
+    size_t ilen;
+    while (1) {
+        expr = trim(expr, len, &len);
+        if (len == 0)
+            break;
+        switch (expr[0]) {
+            case '?':
+                // Optional chaining
+                if (len == 1 || expr[1] != '.')
+                    return emit_error(c, err_syntax());
+                expr++;
+                len--;
+                opt_chain = true;
+                // fall through
+            case '.':
+                // Member Access
+                expr++;
+                len--;
+                expr = trim(expr, len, &len);
+                ident = read_ident(expr, len, &ilen);
+                if (!ident)
+                    return emit_error(c, err_syntax());
+                if (!chain)
+                    emit_op(c, OP_CHAIN, 1);
+                chain = true;
+                emit_op(c, OP_MEMBER, 0);
+                emit_u16(c, add_const(c, make_string(ident, ilen)));
+                emit_byte(c, opt_chain);
+                expr = expr + ilen;
+                len -= ilen;
+                left_ident = ident;
+                left_ident_len = ilen;
+                break;
+            case '(':
+                // Function call
+                g = read_group(expr, len, &glen);
+                if (!g)
+                    return emit_error(c, err_syntax());
+                if (!chain)
+                    emit_op(c, OP_CHAIN, 1);
+                chain = true;
+                emit_op(c, OP_CALLABLE, 0);
+                emit_u16(c,
+                         add_const(c, make_string(left_ident, left_ident_len)));
+                if (compile_array(g + 1, glen - 2, cc, depth))
+                    return true;
+                emit_op(c, OP_CALL, -1);
+                expr += glen;
+                len -= glen;
+                break;
+            case '[':
+                // Computed Member Access
+                g = read_group(expr, len, &glen);
+                if (!g)
+                    return emit_error(c, err_syntax());
+                if (!chain)
+                    emit_op(c, OP_CHAIN, 1);
+                chain = true;
+                if (compile_expr(g + 1, glen - 2, cc, depth))
+                    return true;
+                emit_op(c, OP_INDEX, -1);
+                emit_byte(c, opt_chain);
+                expr += glen;
+                len -= glen;
+                break;
+            default:
+                return emit_error(c, err_syntax());
+        }
+    }
+    if (chain)
+        emit_op(c, OP_NIP, -1);
+    return false;
+}
+
+static bool compile_auto(int step, const uint8_t* expr, size_t len,
+                         struct compile_context* cc, int depth) {
+    if (depth - 1 > XV_MAXDEPTH) {
+        // same as err_msg("MaxDepthError"), without the thread memory
+        static const char msg[] = "MaxDepthError";
+        struct value err = {.kind = ERR_KIND, .flag = FLAG_EMSG};
+        err.len = sizeof(msg) - 1;
+        err.str = (const uint8_t*)msg;
+        return emit_error(cc->c, err);
+    }
+    int steps = cc->steps;
+    switch (step) {
+        case STEP_COMMA:
+            if (steps & STEP_COMMA)
+                return compile_comma(expr, len, cc, depth);
+            // fall through
+        case STEP_TERNS:
+            if (steps & STEP_TERNS)
+                return compile_terns(expr, len, cc, depth);
+            // fall through
+        case STEP_LOGICAL_OR:
+            if (steps & STEP_LOGICAL_OR)
+                return compile_logical_or(expr, len, cc, depth);
+            // fall through
+        case STEP_LOGICAL_AND:
+            if (steps & STEP_LOGICAL_AND)
+                return compile_logical_and(expr, len, cc, depth);
+            // fall through
+        case STEP_BITWISE_OR:
+            if (steps & STEP_BITWISE_OR)
+                return compile_bitwise(STEP_BITWISE_OR, '|', OP_BOR, expr,
+                                       len, cc, depth);
+            // fall through
+        case STEP_BITWISE_XOR:
+            if (steps & STEP_BITWISE_XOR)
+                return compile_bitwise(STEP_BITWISE_XOR, '^', OP_BXOR, expr,
+                                       len, cc, depth);
+            // fall through
+        case STEP_BITWISE_AND:
+            if (steps & STEP_BITWISE_AND)
+                return compile_bitwise(STEP_BITWISE_AND, '&', OP_BAND, expr,
+                                       len, cc, depth);
+            // fall through
+        case STEP_EQUALITY:
+            if (steps & STEP_EQUALITY)
+                return compile_equality(expr, len, cc, depth);
+            // fall through
+        case STEP_COMPS:
+            if (steps & STEP_COMPS)
+                return compile_comps(expr, len, cc, depth);
+            // fall through
+        case STEP_SUMS:
+            if (steps & STEP_SUMS)
+                return compile_sums(expr, len, cc, depth);
+            // fall through
+        case STEP_FACTS:
+            if (steps & STEP_FACTS)
+                return compile_facts(expr, len, cc, depth);
+            // fall through
+        default:
+            return compile_atom(expr, len, cc, depth);
+    }
+}
+
+// compile_foreach mirrors eval_foreach, iter is set for array literals and
+// function arguments.
+static bool compile_foreach(const uint8_t* expr, size_t len,
+                            struct compile_context* cc, bool iter,
+                            int depth) {
+    expr = trim(expr, len, &len);
+    if (len == 0) {
+        emit_const(cc->c, undefined());
+        return false;
+    }
+    int steps = 0;
+    for (size_t i = 0; i < len; i++) {
+        steps |= (int)op_steps[expr[i]];
+    }
+    if (iter) {
+        steps |= STEP_COMMA;
+    }
+    cc->steps = steps;
+    cc->iter = iter;
+    return compile_expr(expr, len, cc, depth);
+}
+
+static bool compile_array(const uint8_t* expr, size_t len,
+                          struct compile_context* cc, int depth) {
+    struct compiler* c = cc->c;
+    struct compile_context sub = {.c = c};
+    emit_op(c, OP_ARRAY, 0);
+    size_t at = c->ncode;
+    emit_u16(c, 0);
+    if (++c->ap > c->narray)
+        c->narray = c->ap;
+    bool dead = compile_foreach(expr, len, &sub, true, depth);
+    c->ap--;
+    if (!c->oom) {
+        c->code[at] = (uint8_t)sub.nitems;
+        c->code[at + 1] = (uint8_t)(sub.nitems >> 8);
+    }
+    if (dead)
+        return true;
+    emit_op(c, OP_ARRAY_END, 0);
+    return false;
+}
+
+static void relocate(struct value* values, size_t n, const uint8_t* from,
+                     size_t size, const uint8_t* to) {
+    for (size_t i = 0; i < n; i++) {
+        struct value* v = &values[i];
+        if ((v->kind == STR_KIND || v->kind == ERR_KIND) && v->str >= from &&
+            v->str < from + size) {
+            v->str = to + (v->str - from);
+        }
+    }
+}
+
+struct xv_program* xv_compilen(const char* expr, size_t len) {
+    struct compiler c = {0};
+    struct xv_program* prog = NULL;
+    // the expression is copied into the program, so identifiers and strings
+    // can be referenced directly. Escaped strings never get longer than
+    // their source, the pool has the same size as the expression.
+    c.srcsize = (len + 1) * 2;
+    c.src = m_alloc(c.srcsize);
+    if (!c.src)
+        return NULL;
+    memcpy(c.src, expr, len);
+    c.src[len] = '\0';
+    c.npool = len + 1;
+    struct compile_context cc = {.c = &c};
+    compile_foreach(c.src, len, &cc, false, 0);
+    emit_op(&c, OP_END, 0);
+    if (c.oom || c.nstack > UINT16_MAX || c.narray > UINT16_MAX)
+        goto done;
+    size_t head = (sizeof(struct xv_program) + 7) & ~(size_t)7;
+    size_t nvalue = c.nconst + c.nslot;
+    prog = m_alloc(head + nvalue * sizeof(struct value) + c.ncode + c.npool);
+    if (!prog)
+        goto done;
+    struct value* consts = (struct value*)((uint8_t*)prog + head);
+    struct value* slots = consts + c.nconst;
+    uint8_t* code = (uint8_t*)(slots + c.nslot);
+    uint8_t* src = code + c.ncode;
+    if (c.nconst)
+        memcpy(consts, c.consts, c.nconst * sizeof(struct value));
+    if (c.nslot)
+        memcpy(slots, c.slots, c.nslot * sizeof(struct value));
+    memcpy(code, c.code, c.ncode);
+    memcpy(src, c.src, c.npool);
+    relocate(consts, nvalue, c.src, c.npool, src);
+    prog->code = code;
+    prog->consts = consts;
+    prog->slots = slots;
+    prog->nslot = (uint16_t)c.nslot;
+    prog->nstack = (uint16_t)c.nstack;
+    prog->narray = (uint16_t)c.narray;
+done:
+    m_free(c.src);
+    m_free(c.code);
+    m_free(c.consts);
+    m_free(c.slots);
+    return prog;
+}
+
+struct xv_program* xv_compile(const char* expr) {
+    return xv_compilen(expr, strlen(expr));
+}
+
+void xv_program_free(struct xv_program* prog) {
+    m_free(prog);
+}
+
+size_t xv_program_nslots(const struct xv_program* prog) {
+    return prog ? prog->nslot : 0;
+}
+
+struct xv xv_program_slot_name(const struct xv_program* prog, size_t index) {
+    if (!prog || index >= prog->nslot)
+        return from_value(make_undefined());
+    return from_value(prog->slots[index]);
+}
+
+int xv_program_slot(const struct xv_program* prog, const char* name) {
+    size_t len = strlen(name);
+    for (size_t i = 0; prog && i < prog->nslot; i++) {
+        if (prog->slots[i].len == len &&
+            memcmp(prog->slots[i].str, name, len) == 0)
+            return (int)i;
+    }
+    return -1;
+}
+
+static struct value run(const struct xv_program* prog, struct xv_env* env,
+                        const struct xv* vars) {
+    struct value sbuf[XV_RUN_STACK_SIZE];
+    struct array abuf[XV_RUN_ARRAYS];
+    struct value* stack = sbuf;
+    struct array* arrs = abuf;
+    if (!prog)
+        return err_oom();
+    if (prog->nstack > XV_RUN_STACK_SIZE) {
+        stack = emalloc(prog->nstack * sizeof(struct value));
+        if (!stack)
+            return err_oom();
+    }
+    if (prog->narray > XV_RUN_ARRAYS) {
+        arrs = emalloc(prog->narray * sizeof(struct array));
+        if (!arrs)
+            return err_oom();
+    }
+    struct eval_context ctx = {.env = env};
+    const struct value* consts = prog->consts;
+    const uint8_t* code = prog->code;
+    const uint8_t* pc = code;
+    struct value* sp = stack;  // next free entry
+    struct array* ap = arrs;   // next free array
+    struct value val;
+    const struct value* name;
+    const uint8_t* ident;
+    size_t ilen;
+    char nbuf[32];
+    while (1) {
+        uint8_t op = *pc++;
+        switch (op) {
+            case OP_END:
+                return sp[-1];
+            case OP_CONST:
+                *sp++ = consts[read_u16(pc)];
+                pc += 2;
+                break;
+            case OP_GLOBAL:
+                name = &prog->slots[read_u16(pc)];
+                pc += 2;
+                if (vars) {
+                    val = check_ref_value(to_value(vars[name - prog->slots]),
+                                          false, make_undefined(), name->str,
+                                          name->len, false);
+                } else {
+                    val = get_ref_value(false, make_undefined(), name->str,
+                                        name->len, false, &ctx);
+                }
+                if (is_err(val))
+                    return val;
+                *sp++ = val;
+                break;
+            case OP_ERROR:
+                return consts[read_u16(pc)];
+            case OP_POP:
+                sp--;
+                break;
+            case OP_ADD:
+                sp--;
+                sp[-1] = vadd(sp[-1], sp[0]);
+                if (is_err(sp[-1]))
+                    return sp[-1];
+                break;
+            case OP_SUB:
+            case OP_MUL:
+            case OP_DIV:
+            case OP_MOD:
+            case OP_LT:
+            case OP_LTE:
+            case OP_GT:
+            case OP_GTE:
+            case OP_EQ:
+            case OP_NEQ:
+            case OP_SEQ:
+            case OP_SNEQ:
+            case OP_BAND:
+            case OP_BXOR:
+            case OP_BOR:
+            case OP_AND:
+            case OP_OR:
+            case OP_COALESCE:
+                sp--;
+                sp[-1] = binary_op(op, sp[-1], sp[0], &ctx);
+                break;
+            case OP_NEG:
+            case OP_BOOL:
+            case OP_NOT:
+                sp[-1] = unary_op(op, sp[-1]);
+                break;
+            case OP_JMPF:
+                sp--;
+                if (to_bool(*sp)) {
+                    pc += 2;
+                    break;
+                }
+                // fall through
+            case OP_JMP:
+                pc = code + read_u16(pc);
+                break;
+            case OP_ARRAY:
+                ap->cap = read_u16(pc);
+                pc += 2;
+                ap->len = 0;
+                ap->items = NULL;
+                if (ap->cap) {
+                    ap->items = emalloc(ap->cap * sizeof(struct value));
+                    if (!ap->items)
+                        return err_oom();
+                }
+                ap++;
+                break;
+            case OP_APPEND:
+                ap[-1].items[ap[-1].len++] = sp[-1];
+                break;
+            case OP_ARRAY_END:
+                ap--;
+                sp[-1] = make_array(ap->items, ap->len);
+                break;
+            case OP_CHAIN:
+                sp[0] = sp[-1];
+                sp[-1] = make_undefined();
+                sp++;
+                break;
+            case OP_MEMBER:
+                name = &consts[read_u16(pc)];
+                val = get_ref_value(true, sp[-1], name->str, name->len, pc[2],
+                                    &ctx);
+                pc += 3;
+                if (is_err(val))
+                    return val;
+                sp[-2] = sp[-1];
+                sp[-1] = val;
+                break;
+            case OP_INDEX:
+                sp--;
+                ident = to_str(sp[0], &ilen, nbuf, sizeof(nbuf));
+                val = get_ref_value(true, sp[-1], ident, ilen, pc[0], &ctx);
+                pc += 1;
+                if (is_err(val))
+                    return val;
+                sp[-2] = sp[-1];
+                sp[-1] = val;
+                break;
+            case OP_CALLABLE:
+                name = &consts[read_u16(pc)];
+                pc += 2;
+                if (sp[-1].kind != FUNC_KIND)
+                    return err_notfunc(name->str, name->len);
+                break;
+            case OP_CALL:
+                sp--;
+                val = to_value(sp[-1].func(
+                    from_value(sp[-2]), from_value(sp[0]),
+                    sp[-1].data ? sp[-1].data : (env ? env->udata : NULL)));
+                if (is_err(val))
+                    return val;
+                sp[-2] = sp[-1];
+                sp[-1] = val;
+                break;
+            case OP_NIP:
+                sp--;
+                sp[-1] = sp[0];
+                break;
+        }
+    }
+}
+
+struct xv xv_run(const struct xv_program* prog, struct xv_env* env) {
+    return from_value(run(prog, env, NULL));
+}
+
+struct xv xv_run_slots(const struct xv_program* prog, struct xv_env* env,
+                       const struct xv* slots) {
+    return from_value(run(prog, env, slots));
+}
+#endif  // XV_CFG_ENABLE_COMPILE
@@ -7,6 +7,10 @@
 
 #include "modules.h"
 
+#ifndef XV_CFG_ENABLE_COMPILE
+#define XV_CFG_ENABLE_COMPILE 1  // 与Kconfig默认值相同
+#endif
+
 // 结构体 xv 是一个表达式值。
 // 这通常作为 xv_eval 函数的结果创建，但也可以使用 xv_new_*() 函数进行创建。
 struct xv {
@@ -44,6 +48,47 @@ struct xv_env {
 struct xv xv_eval(const char* expr, struct xv_env* env);
 struct xv xv_evaln(const char* expr, size_t len, struct xv_env* env);
 
+#if XV_CFG_ENABLE_COMPILE
+// struct xv_program 是 xv_compile 编译得到的程序。
+struct xv_program;
+
+// xv_compile 函数将表达式编译为可重复执行的字节码程序。
+//
+// 编译时完成分词和解析，折叠常量运算，并为全局标识符分配槽位。
+// 程序的执行结果与 xv_eval 完全相同，语法错误也在执行到相应位置时返回。
+// 程序占用一块 m_alloc 分配的内存，系统内存不足时返回 NULL。
+struct xv_program* xv_compile(const char* expr);
+struct xv_program* xv_compilen(const char* expr, size_t len);
+
+// xv_program_free 释放编译得到的程序。
+//
+// 执行结果中的字符串可能引用程序内部的内存，释放程序后不要再使用这些结果。
+void xv_program_free(struct xv_program* prog);
+
+// xv_run 函数执行编译得到的程序并返回结果值，不再重复解析表达式。
+//
+// 全局标识符仍然通过 env->ref 回调获取，与 xv_eval 相同，
+// 每一个 xv_run 调用也应该对应一个 xv_cleanup。
+struct xv xv_run(const struct xv_program* prog, struct xv_env* env);
+
+// xv_run_slots 函数与 xv_run 相同，但全局标识符直接从 slots 数组中获取，
+// 不再调用 env->ref 回调。
+//
+// slots 的长度为 xv_program_nslots()，slots[i] 相当于 ref 回调对第 i 个
+// 全局标识符返回的值。成员访问和函数调用仍然使用 env。
+struct xv xv_run_slots(const struct xv_program* prog, struct xv_env* env,
+                       const struct xv* slots);
+
+// xv_program_nslots 返回程序引用的全局标识符数量。
+size_t xv_program_nslots(const struct xv_program* prog);
+
+// xv_program_slot 返回全局标识符的槽位，程序没有引用该标识符时返回 -1。
+int xv_program_slot(const struct xv_program* prog, const char* name);
+
+// xv_program_slot_name 返回槽位对应的全局标识符，槽位无效时返回未定义。
+struct xv xv_program_slot_name(const struct xv_program* prog, size_t index);
+#endif
+
 // xv_cleanup 函数用于重置环境并释放可能在 xv_eval 过程中分配的任何内存。
 //
 // 当你完全完成了 xv_eval 调用的结果值使用后，应该调用此函数。